@@ -0,0 +1,134 @@
+/**
+ * @file BatchRechargeBenchmark.cpp
+ * @brief 学期初批量充值基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在临时数据目录中准备N张卡和一个为每张卡充值一次的CSV文件，分别用逐行调用
+ * CardService::recharge（每行写一次卡文件、发两个信号）和CardService::rechargeBatch
+ * （流式校验后一次写入）完成充值，输出每种方式的最优耗时、每行耗时和充值后的余额合计，
+ * 并校验两种方式的余额合计一致。
+ *
+ * 用法：batch_recharge_benchmark [--cards 2000] [--runs 3]
+ */
+
+#include "model/repositories/StorageManager.h"
+#include "model/services/CardService.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <functional>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 一次运行所需的服务（每次运行都从相同的数据文件重新加载）
+ */
+struct Fixture {
+    QTemporaryDir dir;
+    CardService cardService;
+    QByteArray csv;
+
+    explicit Fixture(int cardCount) {
+        StorageManager::instance().setDataPath(dir.path() + QStringLiteral("/data"));
+        StorageManager::instance().initializeDataDirectory();
+
+        // 每张卡充值 10.01 到 59.01 元不等
+        QList<Card> cards;
+        csv = "卡号,金额\n";
+        for (int c = 0; c < cardCount; ++c) {
+            const QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+            const QString studentId = QStringLiteral("B%1").arg(c, 8, 10, QLatin1Char('0'));
+            cards.append(Card(cardId, QStringLiteral("学生%1").arg(c), studentId,
+                              Money::fromYuan(20)));
+            csv += QStringLiteral("%1,%2.01\n").arg(cardId).arg(10 + c % 50).toUtf8();
+        }
+        StorageManager::instance().saveAllCards(cards);
+        cardService.initialize();
+    }
+
+    [[nodiscard]] Money totalBalance() const {
+        Money total;
+        for (const auto& card : cardService.getAllCards()) {
+            total += card.balance();
+        }
+        return total;
+    }
+};
+
+struct Strategy {
+    const char* name;
+    std::function<void(Fixture&)> run;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("批量充值基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量（每张卡一行充值）"),
+                      QStringLiteral("n"), QStringLiteral("2000")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每种方式的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("3")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+
+    const QList<Strategy> strategies = {
+        {"per-row recharge",
+         [](Fixture& f) {
+             QBuffer buffer(&f.csv);
+             buffer.open(QIODevice::ReadOnly);
+             RechargeCsvReader reader(&buffer);
+             RechargeRow row;
+             while (reader.readNext(row)) {
+                 f.cardService.recharge(row.cardId, row.amount);
+             }
+         }},
+        {"rechargeBatch",
+         [](Fixture& f) {
+             QBuffer buffer(&f.csv);
+             buffer.open(QIODevice::ReadOnly);
+             (void)f.cardService.rechargeBatch(&buffer);
+         }},
+    };
+
+    std::printf("recharging %d cards, best of %d runs\n\n", cardCount, runs);
+    std::printf("%-20s %12s %12s %14s\n", "strategy", "best(ms)", "per-row(us)", "balance");
+
+    QList<Money> balances;
+    for (const auto& strategy : strategies) {
+        double best = -1.0;
+        Money balance;
+        for (int run = 0; run < runs; ++run) {
+            Fixture fixture(cardCount);
+
+            QElapsedTimer timer;
+            timer.start();
+            strategy.run(fixture);
+            double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+            best = (best < 0.0) ? elapsed : qMin(best, elapsed);
+            balance = fixture.totalBalance();
+        }
+        balances.append(balance);
+        std::printf("%-20s %12.2f %12.1f %14s\n", strategy.name, best,
+                    best * 1000.0 / cardCount, qPrintable(balance.toString()));
+    }
+
+    const bool match = balances.first() == balances.last();
+    std::printf("\ncheck: %s\n", match ? "ok" : "MISMATCH");
+    return match ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file BatchSessionBenchmark.cpp
+ * @brief 整个机房同时下机的批量结算基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在临时数据目录中准备N张正在上机的卡，分别用逐卡下机、逐卡事务、
+ * 批量事务和批量直接写文件四种方式结束全部会话，输出每种方式的最优耗时，
+ * 以及结束后的余额合计（各方式应一致，便于核对扣款没有遗漏）。
+ *
+ * 用法：batch_session_benchmark [--cards 500] [--runs 5]
+ */
+
+#include "model/repositories/StorageManager.h"
+#include "model/services/TransactionManager.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <functional>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 一次运行所需的服务（每次运行都从相同的数据文件重新加载）
+ */
+struct Fixture {
+    QTemporaryDir dir;
+    CardService cardService;
+    RecordService recordService;
+    TransactionManager transactions{&cardService, &recordService};
+    QStringList cardIds;
+
+    explicit Fixture(int cardCount) {
+        StorageManager::instance().setDataPath(dir.path() + QStringLiteral("/data"));
+        StorageManager::instance().initializeDataDirectory();
+
+        // 所有会话在两小时前开始，保证每张卡都有正的费用
+        const QDateTime start = QDateTime::currentDateTime().addSecs(-2 * 3600);
+        QList<Card> cards;
+        for (int c = 0; c < cardCount; ++c) {
+            const QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+            const QString studentId = QStringLiteral("B%1").arg(c, 8, 10, QLatin1Char('0'));
+            cards.append(Card(cardId, QStringLiteral("学生%1").arg(c), studentId,
+                              Money::fromYuan(100)));
+            cardIds.append(cardId);
+
+            Record record;
+            record.setRecordId(cardId + QStringLiteral("-online"));
+            record.setCardId(cardId);
+            record.setLocation(QStringLiteral("机房A101"));
+            record.setStartTime(start);
+            record.setState(SessionState::Online);
+            StorageManager::instance().saveRecords(studentId, {record});
+        }
+        StorageManager::instance().saveAllCards(cards);
+
+        cardService.initialize();
+        recordService.initialize();
+    }
+
+    [[nodiscard]] Money totalBalance() const {
+        Money total;
+        for (const auto& card : cardService.getAllCards()) {
+            total += card.balance();
+        }
+        return total;
+    }
+};
+
+struct Strategy {
+    const char* name;
+    std::function<void(Fixture&)> run;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("批量下机结算基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("同时上机的卡数量"),
+                      QStringLiteral("n"), QStringLiteral("500")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每种方式的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("5")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+
+    const QList<Strategy> strategies = {
+        {"per-card endSession+deduct",
+         [](Fixture& f) {
+             for (const auto& cardId : f.cardIds) {
+                 Money cost = f.recordService.endSession(cardId);
+                 f.cardService.deduct(cardId, cost);
+             }
+         }},
+        {"per-card transaction",
+         [](Fixture& f) {
+             for (const auto& cardId : f.cardIds) {
+                 f.transactions.endSession(cardId);
+             }
+             f.transactions.checkpoint();
+         }},
+        {"batch transaction",
+         [](Fixture& f) {
+             f.transactions.endSessions(f.cardIds);
+             f.transactions.checkpoint();
+         }},
+        {"batch endSessions+deductBatch",
+         [](Fixture& f) {
+             QMap<QString, Money> amounts;
+             for (const auto& record : f.recordService.endSessions(f.cardIds)) {
+                 amounts.insert(record.cardId(), record.cost());
+             }
+             f.cardService.deductBatch(amounts);
+         }},
+    };
+
+    std::printf("ending %d concurrent sessions, best of %d runs\n\n", cardCount, runs);
+    std::printf("%-32s %12s %14s %14s\n", "strategy", "best(ms)", "per-card(us)", "balance");
+
+    for (const auto& strategy : strategies) {
+        double best = -1.0;
+        Money balance;
+        for (int run = 0; run < runs; ++run) {
+            Fixture fixture(cardCount);
+
+            QElapsedTimer timer;
+            timer.start();
+            strategy.run(fixture);
+            double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+            best = (best < 0.0) ? elapsed : qMin(best, elapsed);
+            balance = fixture.totalBalance();
+        }
+        std::printf("%-32s %12.2f %14.1f %14s\n", strategy.name, best,
+                    best * 1000.0 / cardCount, qPrintable(balance.toString()));
+    }
+
+    return 0;
+}
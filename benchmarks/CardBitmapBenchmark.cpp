@@ -0,0 +1,146 @@
+/**
+ * @file CardBitmapBenchmark.cpp
+ * @brief 活跃卡位图构建与同期群集合运算基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 为指定数量的卡生成一整年的每日活跃集合，测量位图构建、按周合并、
+ * 两周求交（留存）与求差的耗时和内存，并与QSet<quint32>的做法对比。
+ *
+ * 用法：card_bitmap_benchmark [--cards 100000] [--days 365] [--active 0.2]
+ */
+
+#include "model/services/CardBitmap.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QRandomGenerator>
+#include <QSet>
+
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 合并[first, first + count)天的集合
+ */
+CardBitmap unionDays(const QList<CardBitmap>& days, int first, int count) {
+    CardBitmap result;
+    for (int d = first; d < first + count && d < days.size(); ++d) {
+        result |= days.at(d);
+    }
+    return result;
+}
+
+QSet<quint32> unionDays(const QList<QSet<quint32>>& days, int first, int count) {
+    QSet<quint32> result;
+    for (int d = first; d < first + count && d < days.size(); ++d) {
+        result.unite(days.at(d));
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("活跃卡位图构建与同期群集合运算基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("100000")});
+    parser.addOption({QStringLiteral("days"), QStringLiteral("天数"), QStringLiteral("n"),
+                      QStringLiteral("365")});
+    parser.addOption({QStringLiteral("active"), QStringLiteral("每日活跃比例"),
+                      QStringLiteral("ratio"), QStringLiteral("0.2")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int dayCount = qMax(14, parser.value(QStringLiteral("days")).toInt());
+    const double activeRatio =
+        qBound(0.0, parser.value(QStringLiteral("active")).toDouble(), 1.0);
+    const int activePerDay = qMax(1, static_cast<int>(cardCount * activeRatio));
+
+    // 预先生成每日活跃的卡序号，避免计入生成开销
+    QRandomGenerator rng(20240901);
+    QList<QList<quint32>> activity(dayCount);
+    for (auto& day : activity) {
+        day.reserve(activePerDay);
+        for (int i = 0; i < activePerDay; ++i) {
+            day.append(rng.bounded(static_cast<quint32>(cardCount)));
+        }
+    }
+
+    // 构建
+    QElapsedTimer timer;
+    timer.start();
+    QList<CardBitmap> bitmaps(dayCount);
+    qsizetype bitmapBytes = 0;
+    for (int d = 0; d < dayCount; ++d) {
+        for (quint32 card : activity.at(d)) {
+            bitmaps[d].add(card);
+        }
+        bitmapBytes += bitmaps.at(d).memoryBytes();
+    }
+    const double bitmapBuildMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+    timer.restart();
+    QList<QSet<quint32>> sets(dayCount);
+    for (int d = 0; d < dayCount; ++d) {
+        sets[d].reserve(activePerDay);
+        for (quint32 card : activity.at(d)) {
+            sets[d].insert(card);
+        }
+    }
+    const double setBuildMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+    std::printf("build: %d cards x %d days, %d active/day\n", cardCount, dayCount, activePerDay);
+    std::printf("  bitmap: %.2f ms, %.1f MB\n", bitmapBuildMs, bitmapBytes / 1048576.0);
+    std::printf("  qset:   %.2f ms\n", setBuildMs);
+
+    // 留存：第1周与第10周（不足10周时取最后一周）都活跃
+    const int laterWeek = qMin(9 * 7, dayCount - 7);
+    const int runs = 20;
+    qint64 bitmapRetained = 0;
+    timer.restart();
+    for (int i = 0; i < runs; ++i) {
+        CardBitmap retained = unionDays(bitmaps, 0, 7) & unionDays(bitmaps, laterWeek, 7);
+        bitmapRetained = retained.cardinality();
+    }
+    const double bitmapRetainMs = static_cast<double>(timer.nsecsElapsed()) / 1e6 / runs;
+
+    qint64 setRetained = 0;
+    timer.restart();
+    for (int i = 0; i < runs; ++i) {
+        setRetained = unionDays(sets, 0, 7).intersect(unionDays(sets, laterWeek, 7)).size();
+    }
+    const double setRetainMs = static_cast<double>(timer.nsecsElapsed()) / 1e6 / runs;
+    std::printf("retention (week 1 AND week 10): bitmap %.3f ms, qset %.3f ms\n", bitmapRetainMs,
+                setRetainMs);
+
+    // 全年并集与求差：全年活跃但最后一周未出现
+    timer.restart();
+    CardBitmap year = unionDays(bitmaps, 0, dayCount);
+    const double yearMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    timer.restart();
+    qint64 churned = 0;
+    for (int i = 0; i < runs; ++i) {
+        churned = year.andNot(unionDays(bitmaps, dayCount - 7, 7)).cardinality();
+    }
+    const double andNotMs = static_cast<double>(timer.nsecsElapsed()) / 1e6 / runs;
+    std::printf("year union: %.3f ms (%lld cards); ANDNOT last week: %.3f ms (%lld cards)\n",
+                yearMs, static_cast<long long>(year.cardinality()), andNotMs,
+                static_cast<long long>(churned));
+
+    const bool match = bitmapRetained == setRetained;
+    std::printf("check: %s (retained=%lld)\n", match ? "ok" : "MISMATCH",
+                static_cast<long long>(bitmapRetained));
+
+    return match ? 0 : 1;
+}
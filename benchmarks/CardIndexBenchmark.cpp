@@ -0,0 +1,182 @@
+/**
+ * @file CardIndexBenchmark.cpp
+ * @brief 校园卡主索引与二级索引查询基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在临时数据目录中准备N张卡（约1%冻结、0.5%挂失，姓名有重复），
+ * 分别用按卡号排序的QMap逐卡扫描（原做法）和CardService的哈希表与二级索引
+ * 执行按卡号、按学号、按状态和按姓名的查询，输出每次查询的平均耗时，
+ * 并核对两种做法的结果一致。
+ *
+ * 用法：card_index_benchmark [--cards 100000] [--lookups 10000]
+ */
+
+#include "model/repositories/StorageManager.h"
+#include "model/services/CardService.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <functional>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 测量一个操作重复执行的平均耗时
+ * @param times 重复次数
+ * @param op 操作（参数为第几次）
+ * @return 每次的平均耗时（微秒）
+ */
+double measure(int times, const std::function<void(int)>& op) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < times; ++i) {
+        op(i);
+    }
+    return static_cast<double>(timer.nsecsElapsed()) / 1e3 / times;
+}
+
+void report(const char* name, double scanUs, double indexUs) {
+    std::printf("%-24s %14.2f %14.3f %10.0fx\n", name, scanUs, indexUs, scanUs / indexUs);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("校园卡索引查询基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("100000")});
+    parser.addOption({QStringLiteral("lookups"), QStringLiteral("索引查询次数"),
+                      QStringLiteral("n"), QStringLiteral("10000")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int lookups = qMax(1, parser.value(QStringLiteral("lookups")).toInt());
+    // 扫描太慢，只做少量次数
+    const int scans = qMax(1, qMin(lookups, 2000000 / cardCount));
+
+    QTemporaryDir dir;
+    StorageManager::instance().setDataPath(dir.path() + QStringLiteral("/data"));
+    StorageManager::instance().initializeDataDirectory();
+
+    QRandomGenerator rng(20240901);
+    QList<Card> cards;
+    QMap<QString, Card> ordered;
+    for (int c = 0; c < cardCount; ++c) {
+        const QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+        Card card(cardId, QStringLiteral("学生%1").arg(rng.bounded(cardCount / 2 + 1)),
+                  QStringLiteral("B%1").arg(c, 8, 10, QLatin1Char('0')), Money::fromYuan(100));
+        const quint32 roll = rng.bounded(1000);
+        if (roll < 10) {
+            card.setState(CardState::Frozen);
+        } else if (roll < 15) {
+            card.setState(CardState::Lost);
+        }
+        cards.append(card);
+        ordered.insert(cardId, card);
+    }
+    StorageManager::instance().saveAllCards(cards);
+
+    CardService cardService;
+    QElapsedTimer timer;
+    timer.start();
+    cardService.initialize();
+    const double loadMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+    // 预先生成查询目标
+    QStringList cardIds;
+    QStringList studentIds;
+    QStringList names;
+    for (int i = 0; i < lookups; ++i) {
+        const Card& card = cards.at(rng.bounded(cardCount));
+        cardIds.append(card.cardId());
+        studentIds.append(card.studentId());
+        names.append(card.name());
+    }
+
+    std::printf("%d cards loaded with indexes in %.1f ms\n\n", cardCount, loadMs);
+    std::printf("%-24s %14s %14s %11s\n", "query", "scan(us)", "index(us)", "speedup");
+
+    bool match = true;
+    qsizetype sink = 0;
+
+    // 按卡号：QMap的O(log n)查找与QHash的O(1)查找
+    const double mapFindUs = measure(lookups, [&](int i) {
+        sink += ordered.value(cardIds.at(i)).name().size();
+    });
+    const double hashFindUs = measure(lookups, [&](int i) {
+        sink += cardService.findCard(cardIds.at(i)).name().size();
+    });
+    report("findCard (map vs hash)", mapFindUs, hashFindUs);
+
+    // 按学号
+    const double studentScanUs = measure(scans, [&](int i) {
+        for (const auto& card : ordered) {
+            if (card.studentId() == studentIds.at(i)) {
+                sink += card.cardId().size();
+                break;
+            }
+        }
+    });
+    const double studentIndexUs = measure(lookups, [&](int i) {
+        const Card card = cardService.findCardByStudentId(studentIds.at(i));
+        match = match && card.studentId() == studentIds.at(i);
+    });
+    report("findCardByStudentId", studentScanUs, studentIndexUs);
+
+    // 按状态：全部冻结卡
+    qsizetype scannedFrozen = 0;
+    const double stateScanUs = measure(scans, [&](int) {
+        QList<Card> frozen;
+        for (const auto& card : ordered) {
+            if (card.state() == CardState::Frozen) {
+                frozen.append(card);
+            }
+        }
+        scannedFrozen = frozen.size();
+    });
+    qsizetype indexedFrozen = 0;
+    const double stateIndexUs = measure(lookups, [&](int) {
+        indexedFrozen = cardService.findCardsByState(CardState::Frozen).size();
+    });
+    match = match && scannedFrozen == indexedFrozen;
+    report("findCardsByState", stateScanUs, stateIndexUs);
+
+    const double countIndexUs = measure(lookups, [&](int) {
+        sink += cardService.countCardsByState(CardState::Lost);
+    });
+    report("countCardsByState", stateScanUs, countIndexUs);
+
+    // 按姓名
+    const double nameScanUs = measure(scans, [&](int i) {
+        const QString key = CardService::normalizeName(names.at(i));
+        for (const auto& card : ordered) {
+            if (CardService::normalizeName(card.name()) == key) {
+                ++sink;
+            }
+        }
+    });
+    const double nameIndexUs = measure(lookups, [&](int i) {
+        const QList<Card> found = cardService.findCardsByName(names.at(i));
+        match = match && !found.isEmpty();
+    });
+    report("findCardsByName", nameScanUs, nameIndexUs);
+
+    std::printf("\nfrozen cards: %lld; check: %s (sink=%lld)\n",
+                static_cast<long long>(indexedFrozen), match ? "ok" : "MISMATCH",
+                static_cast<long long>(sink));
+    return match ? 0 : 1;
+}
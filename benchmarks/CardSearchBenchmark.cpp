@@ -0,0 +1,141 @@
+/**
+ * @file CardSearchBenchmark.cpp
+ * @brief 管理员搜索框逐键搜索基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在临时数据目录中准备N张卡（中文及英文姓名），对一组逐步输入的关键词分别用
+ * 原来的逐卡toLower()+contains()扫描和n-gram/拼音索引搜索，输出每次搜索的平均耗时
+ * （索引分为返回全部结果和只取前50条两种）。全是字母的关键词还会按拼音匹配，
+ * 因此只核对索引的结果数不少于扫描的结果数。
+ *
+ * 用法：card_search_benchmark [--cards 200000] [--runs 20]
+ */
+
+#include "model/repositories/StorageManager.h"
+#include "model/services/CardService.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <functional>
+
+
+using namespace CampusCard;
+
+namespace {
+
+const QStringList SURNAMES = {QStringLiteral("张"), QStringLiteral("王"), QStringLiteral("李"),
+                              QStringLiteral("赵"), QStringLiteral("刘"), QStringLiteral("陈"),
+                              QStringLiteral("杨"), QStringLiteral("黄"), QStringLiteral("周"),
+                              QStringLiteral("吴"), QStringLiteral("欧阳"), QStringLiteral("Li ")};
+const QStringList GIVEN = {QStringLiteral("伟"), QStringLiteral("芳"), QStringLiteral("娜"),
+                           QStringLiteral("敏"), QStringLiteral("静"), QStringLiteral("丽"),
+                           QStringLiteral("强"), QStringLiteral("磊"), QStringLiteral("军"),
+                           QStringLiteral("洋"), QStringLiteral("勇"), QStringLiteral("艳"),
+                           QStringLiteral("杰"), QStringLiteral("三"), QStringLiteral("Lei")};
+
+/**
+ * @brief 原CardController::searchCards的做法
+ */
+QList<Card> scanSearch(const QList<Card>& cards, const QString& keyword) {
+    QList<Card> result;
+    QString lowerKeyword = keyword.toLower();
+    for (const auto& card : cards) {
+        if (card.cardId().toLower().contains(lowerKeyword) ||
+            card.name().toLower().contains(lowerKeyword) ||
+            card.studentId().toLower().contains(lowerKeyword)) {
+            result.append(card);
+        }
+    }
+    return result;
+}
+
+double measure(int runs, const std::function<void()>& op) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < runs; ++i) {
+        op();
+    }
+    return static_cast<double>(timer.nsecsElapsed()) / 1e3 / runs;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("管理员搜索框逐键搜索基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("200000")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每个关键词的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("20")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+
+    QTemporaryDir dir;
+    StorageManager::instance().setDataPath(dir.path() + QStringLiteral("/data"));
+    StorageManager::instance().initializeDataDirectory();
+
+    QRandomGenerator rng(20240901);
+    QList<Card> cards;
+    cards.reserve(cardCount);
+    for (int c = 0; c < cardCount; ++c) {
+        QString name = SURNAMES.at(rng.bounded(SURNAMES.size())) +
+                       GIVEN.at(rng.bounded(GIVEN.size()));
+        if (rng.bounded(2) == 0) {
+            name += GIVEN.at(rng.bounded(GIVEN.size()));
+        }
+        cards.append(Card(QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0')), name,
+                          QStringLiteral("B%1").arg(17000000 + c), Money::fromYuan(100)));
+    }
+    StorageManager::instance().saveAllCards(cards);
+
+    CardService cardService;
+    QElapsedTimer timer;
+    timer.start();
+    cardService.initialize();
+    const double loadMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    const QList<Card> allCards = cardService.getAllCards();
+
+    // 模拟逐键输入
+    const QStringList keywords = {
+        QStringLiteral("张"),     QStringLiteral("张伟"),     QStringLiteral("张伟杰"),
+        QStringLiteral("欧阳"),   QStringLiteral("li"),       QStringLiteral("li lei"),
+        QStringLiteral("c0"),     QStringLiteral("c01234"),   QStringLiteral("b1712"),
+        QStringLiteral("b17123"), QStringLiteral("b1712345"), QStringLiteral("没有这个人"),
+        QStringLiteral("z"),      QStringLiteral("zhang"),    QStringLiteral("zhangwei"),
+        QStringLiteral("zw"),     QStringLiteral("zwj"),      QStringLiteral("ouyang")};
+
+    std::printf("%d cards loaded with indexes in %.1f ms, %d runs per keyword\n\n", cardCount,
+                loadMs, runs);
+    std::printf("%-14s %9s %9s %12s %12s %12s\n", "keyword", "scanned", "matches", "scan(us)",
+                "index(us)", "top50(us)");
+
+    bool match = true;
+    for (const auto& keyword : keywords) {
+        qsizetype scanned = 0;
+        qsizetype indexed = 0;
+        const double scanUs =
+            measure(runs, [&]() { scanned = scanSearch(allCards, keyword).size(); });
+        const double indexUs =
+            measure(runs, [&]() { indexed = cardService.searchCards(keyword).size(); });
+        const double topUs = measure(runs, [&]() { cardService.searchCards(keyword, 50); });
+        match = match && indexed >= scanned;
+
+        std::printf("%-14s %9lld %9lld %12.1f %12.1f %12.1f\n", qPrintable(keyword),
+                    static_cast<long long>(scanned), static_cast<long long>(indexed), scanUs,
+                    indexUs, topUs);
+    }
+
+    std::printf("\ncheck: %s\n", match ? "ok" : "MISMATCH");
+    return match ? 0 : 1;
+}
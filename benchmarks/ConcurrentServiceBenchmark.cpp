@@ -0,0 +1,152 @@
+/**
+ * @file ConcurrentServiceBenchmark.cpp
+ * @brief 多终端并发访问卡服务和记录服务的吞吐量基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在临时数据目录中准备N张卡，用1、2、4、8个线程模拟多个终端同时操作：
+ * 每个操作以一定比例为写入（日志扣款，只改内存，不含写文件的耗时），其余为查余额、
+ * 验证扣款条件、查当前会话等读取。分别测量服务自身的分片读写锁和在外面再套一把
+ * 全局互斥锁（相当于改造前只能串行访问）两种情况的每秒操作数，最后核对余额。
+ *
+ * 用法：concurrent_service_benchmark [--cards 20000] [--ops 200000] [--writes 10]
+ */
+
+#include "model/repositories/StorageManager.h"
+#include "model/services/CardService.h"
+#include "model/services/RecordService.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <atomic>
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 用threads个线程共执行ops次操作
+ * @return 每秒操作数
+ */
+double runMix(CardService& cards, RecordService& records, const QStringList& cardIds,
+              int threads, int ops, int writePercent, QMutex* globalLock,
+              std::atomic<quint64>& sequence, std::atomic<qint64>& deducted) {
+    QList<QThread*> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.append(QThread::create([&, t]() {
+            QRandomGenerator rng(20240901 + t);
+            for (int i = 0; i < ops / threads; ++i) {
+                const QString& cardId = cardIds.at(rng.bounded(cardIds.size()));
+                if (globalLock) {
+                    globalLock->lock();
+                }
+                if (static_cast<int>(rng.bounded(100)) < writePercent) {
+                    if (cards.applyJournaledDeduct(cardId, Money::fromCents(1), ++sequence)) {
+                        ++deducted;
+                    }
+                } else {
+                    switch (rng.bounded(3)) {
+                    case 0:
+                        (void)cards.getBalance(cardId);
+                        break;
+                    case 1:
+                        (void)cards.canDeduct(cardId, Money::fromCents(1));
+                        break;
+                    default:
+                        (void)records.getCurrentSession(cardId);
+                        break;
+                    }
+                }
+                if (globalLock) {
+                    globalLock->unlock();
+                }
+            }
+        }));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (QThread* worker : workers) {
+        worker->start();
+    }
+    for (QThread* worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+    const double seconds = static_cast<double>(timer.nsecsElapsed()) / 1e9;
+    return (ops / threads) * threads / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("多终端并发访问卡服务和记录服务的吞吐量基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("20000")});
+    parser.addOption({QStringLiteral("ops"), QStringLiteral("每轮操作总数"), QStringLiteral("n"),
+                      QStringLiteral("200000")});
+    parser.addOption({QStringLiteral("writes"), QStringLiteral("写操作百分比"),
+                      QStringLiteral("n"), QStringLiteral("10")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int ops = qMax(1, parser.value(QStringLiteral("ops")).toInt());
+    const int writePercent = qBound(0, parser.value(QStringLiteral("writes")).toInt(), 100);
+
+    QTemporaryDir dir;
+    StorageManager::instance().setDataPath(dir.path() + QStringLiteral("/data"));
+    StorageManager::instance().initializeDataDirectory();
+
+    const Money initialBalance = Money::fromYuan(10000);
+    QList<Card> seed;
+    QStringList cardIds;
+    seed.reserve(cardCount);
+    for (int c = 0; c < cardCount; ++c) {
+        cardIds.append(QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0')));
+        seed.append(Card(cardIds.last(), QStringLiteral("学生%1").arg(c),
+                         QStringLiteral("B%1").arg(17000000 + c), initialBalance));
+    }
+    StorageManager::instance().saveAllCards(seed);
+
+    CardService cards;
+    cards.initialize();
+    RecordService records;
+    records.initialize();
+    records.startSessions(cardIds.mid(0, cardCount / 10), QStringLiteral("机房A101"));
+
+    std::printf("%d cards, %d ops per run, %d%% writes, %d cores\n\n", cardCount, ops,
+                writePercent, QThread::idealThreadCount());
+    std::printf("%8s %16s %16s %8s\n", "threads", "global(ops/s)", "sharded(ops/s)", "speedup");
+
+    std::atomic<quint64> sequence{0};
+    std::atomic<qint64> deducted{0};
+    QMutex globalLock;
+    for (int threads : {1, 2, 4, 8}) {
+        const double global = runMix(cards, records, cardIds, threads, ops, writePercent,
+                                     &globalLock, sequence, deducted);
+        const double sharded = runMix(cards, records, cardIds, threads, ops, writePercent,
+                                      nullptr, sequence, deducted);
+        std::printf("%8d %16.0f %16.0f %7.2fx\n", threads, global, sharded, sharded / global);
+    }
+
+    // 每次成功的日志扣款恰好扣1分
+    qint64 remaining = 0;
+    for (const auto& card : cards.getAllCards()) {
+        remaining += card.balance().cents();
+    }
+    const bool match = remaining == initialBalance.cents() * cardCount - deducted.load();
+    std::printf("\ncheck: %s\n", match ? "ok" : "MISMATCH");
+    return match ? 0 : 1;
+}
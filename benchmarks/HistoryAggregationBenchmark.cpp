@@ -0,0 +1,136 @@
+/**
+ * @file HistoryAggregationBenchmark.cpp
+ * @brief 全量历史汇总多核扩展性基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 生成内存中的模拟记录，分别以1到N个工作线程执行HistoryAggregator::summarizeAsync，
+ * 输出每种线程数的最优耗时与相对单线程的加速比，并校验结果与串行汇总一致。
+ *
+ * 用法：history_aggregation_benchmark [--cards 5000] [--records 200] [--runs 5]
+ */
+
+#include "model/services/HistoryAggregator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QThreadPool>
+
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 生成模拟记录（固定随机种子，保证每次运行数据一致）
+ */
+QMap<QString, QList<Record>> generateRecords(int cardCount, int recordsPerCard) {
+    static const QStringList locations = {
+        QStringLiteral("机房A101"), QStringLiteral("机房A102"), QStringLiteral("机房B201"),
+        QStringLiteral("机房B202"), QStringLiteral("图书馆电子阅览室")};
+
+    QRandomGenerator rng(20240901);
+    const QDateTime semesterStart(QDate(2024, 9, 1), QTime(8, 0));
+
+    QMap<QString, QList<Record>> records;
+    for (int c = 0; c < cardCount; ++c) {
+        QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+        QList<Record> list;
+        list.reserve(recordsPerCard);
+        for (int r = 0; r < recordsPerCard; ++r) {
+            int duration = rng.bounded(10, 240);
+            QDateTime start = semesterStart.addSecs(rng.bounded(120 * 24 * 3600));
+
+            Record record;
+            record.setRecordId(QStringLiteral("%1-%2").arg(cardId).arg(r));
+            record.setCardId(cardId);
+            record.setLocation(locations.at(rng.bounded(locations.size())));
+            record.setStartTime(start);
+            record.setEndTime(start.addSecs(duration * 60));
+            record.setDurationMinutes(duration);
+            record.setCost(COST_PER_HOUR.scaled(duration, 60));
+            record.setState(SessionState::Offline);
+            list.append(record);
+        }
+        records.insert(cardId, list);
+    }
+    return records;
+}
+
+bool sameSummary(const HistorySummary& a, const HistorySummary& b) {
+    if (a.sessionCount != b.sessionCount || a.totalDuration != b.totalDuration ||
+        a.totalIncome != b.totalIncome || a.byLocation.size() != b.byLocation.size() ||
+        a.topCards.size() != b.topCards.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < a.topCards.size(); ++i) {
+        if (a.topCards.at(i).key != b.topCards.at(i).key) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("全量历史汇总多核扩展性基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("5000")});
+    parser.addOption({QStringLiteral("records"), QStringLiteral("每张卡的记录数"),
+                      QStringLiteral("n"), QStringLiteral("200")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每种线程数的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("5")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int recordsPerCard = qMax(1, parser.value(QStringLiteral("records")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+    const int maxThreads = qMax(1, QThread::idealThreadCount());
+
+    std::printf("generating %d cards x %d records...\n", cardCount, recordsPerCard);
+    const QMap<QString, QList<Record>> records = generateRecords(cardCount, recordsPerCard);
+    const RecordQuery query;
+
+    QElapsedTimer timer;
+    timer.start();
+    const HistorySummary expected = HistoryAggregator::summarize(records, query, 10);
+    std::printf("sequential: %lld ms\n\n", static_cast<long long>(timer.elapsed()));
+
+    std::printf("%8s %12s %10s %8s\n", "threads", "best(ms)", "speedup", "match");
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        double best = -1.0;
+        bool match = true;
+        for (int run = 0; run < runs; ++run) {
+            timer.restart();
+            QFuture<HistorySummary> future =
+                HistoryAggregator::summarizeAsync(records, query, 10, &pool);
+            HistorySummary summary = future.result();
+            double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+            best = (best < 0.0) ? elapsed : qMin(best, elapsed);
+            match = match && sameSummary(summary, expected);
+        }
+
+        if (threads == 1) {
+            baseline = best;
+        }
+        std::printf("%8d %12.2f %9.2fx %8s\n", threads, best, baseline / best,
+                    match ? "yes" : "NO");
+    }
+
+    return 0;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file LabSimulation.cpp
+ * @brief 机房上下机负载模拟
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 用模拟时钟驱动完整的Model层（CardService、RecordService、TransactionManager、
+ * SessionSupervisor），按离散事件方式生成一个学期的到达和离开：
+ * 开放时段（08:00-22:00）内按泊松过程到达，上机时长服从可配置的分布，
+ * 余额不足时先充值，余额用完时由SessionSupervisor自动下机，闭馆时整批下机。
+ * 输出各类事件数、收入以及模拟时间相对真实时间的倍率。
+ *
+ * 用法：lab_simulation [--cards 2000] [--days 120] [--arrivals 60] [--mean-minutes 90]
+ *                      [--distribution exponential|lognormal|uniform] [--seed 20240901]
+ */
+
+#include "model/Clock.h"
+#include "model/repositories/StorageManager.h"
+#include "model/services/SessionSupervisor.h"
+#include "model/services/TransactionManager.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMultiMap>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+
+using namespace CampusCard;
+
+namespace {
+
+const QStringList LOCATIONS = {QStringLiteral("机房A101"), QStringLiteral("机房A102"),
+                               QStringLiteral("机房B201"), QStringLiteral("机房B202"),
+                               QStringLiteral("图书馆电子阅览室")};
+
+constexpr int OPEN_HOUR = 8;    ///< 开放时间
+constexpr int CLOSE_HOUR = 22;  ///< 闭馆时间
+
+/**
+ * @brief 模拟事件
+ */
+struct Event {
+    enum class Type { Arrival, Departure, Closing };
+    Type type = Type::Arrival;
+    QString cardId;  ///< 离开事件的卡号
+};
+
+/**
+ * @brief 模拟统计
+ */
+struct Stats {
+    qint64 arrivals = 0;       ///< 到达次数
+    qint64 busy = 0;           ///< 到达时该卡已在上机（被忽略）
+    qint64 started = 0;        ///< 上机次数
+    qint64 departures = 0;     ///< 按计划离开的下机次数
+    qint64 autoEnded = 0;      ///< 余额用完自动下机次数
+    qint64 closingEnded = 0;   ///< 闭馆时整批下机的会话数
+    qint64 recharges = 0;      ///< 充值次数
+    qint64 maxOnline = 0;      ///< 最大同时在线人数
+    Money income;              ///< 收入
+};
+
+/**
+ * @brief 上机时长分布（分钟），各分布的均值均为mean
+ */
+class DurationDistribution {
+public:
+    DurationDistribution(const QString& name, double mean) : m_name(name), m_mean(mean) {}
+
+    [[nodiscard]] bool isValid() const {
+        return m_name == QLatin1String("exponential") || m_name == QLatin1String("lognormal") ||
+               m_name == QLatin1String("uniform");
+    }
+
+    double operator()(QRandomGenerator& rng) const {
+        if (m_name == QLatin1String("lognormal")) {
+            constexpr double sigma = 0.5;
+            std::lognormal_distribution<double> dist(std::log(m_mean) - sigma * sigma / 2, sigma);
+            return dist(rng);
+        }
+        if (m_name == QLatin1String("uniform")) {
+            std::uniform_real_distribution<double> dist(0.0, 2.0 * m_mean);
+            return dist(rng);
+        }
+        std::exponential_distribution<double> dist(1.0 / m_mean);
+        return dist(rng);
+    }
+
+private:
+    QString m_name;  ///< 分布名
+    double m_mean;   ///< 均值（分钟）
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("机房上下机负载模拟"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("2000")});
+    parser.addOption({QStringLiteral("days"), QStringLiteral("模拟天数"), QStringLiteral("n"),
+                      QStringLiteral("120")});
+    parser.addOption({QStringLiteral("arrivals"), QStringLiteral("开放时段每小时平均到达人数"),
+                      QStringLiteral("n"), QStringLiteral("60")});
+    parser.addOption({QStringLiteral("mean-minutes"), QStringLiteral("平均上机时长（分钟）"),
+                      QStringLiteral("n"), QStringLiteral("90")});
+    parser.addOption({QStringLiteral("distribution"),
+                      QStringLiteral("上机时长分布：exponential、lognormal或uniform"),
+                      QStringLiteral("name"), QStringLiteral("exponential")});
+    parser.addOption({QStringLiteral("seed"), QStringLiteral("随机种子"), QStringLiteral("n"),
+                      QStringLiteral("20240901")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int days = qMax(1, parser.value(QStringLiteral("days")).toInt());
+    const double arrivalsPerHour = qMax(0.1, parser.value(QStringLiteral("arrivals")).toDouble());
+    const double meanMinutes = qMax(1.0, parser.value(QStringLiteral("mean-minutes")).toDouble());
+    const DurationDistribution duration(parser.value(QStringLiteral("distribution")),
+                                        meanMinutes);
+    if (!duration.isValid()) {
+        std::fprintf(stderr, "unknown distribution: %s\n",
+                     qPrintable(parser.value(QStringLiteral("distribution"))));
+        return 1;
+    }
+    QRandomGenerator rng(parser.value(QStringLiteral("seed")).toUInt());
+
+    // 模拟时钟必须比使用它的服务活得久
+    const QDateTime semesterStart(QDate(2024, 9, 2), QTime(0, 0));
+    SimulatedClock clock(semesterStart);
+
+    QTemporaryDir dir;
+    StorageManager& storage = StorageManager::instance();
+    storage.setDataPath(dir.path() + QStringLiteral("/data"));
+    storage.setClock(&clock);
+    storage.initializeDataDirectory();
+
+    QList<Card> cards;
+    QStringList cardIds;
+    for (int c = 0; c < cardCount; ++c) {
+        const QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+        cards.append(Card(cardId, QStringLiteral("学生%1").arg(c),
+                          QStringLiteral("B%1").arg(c, 8, 10, QLatin1Char('0')),
+                          Money::fromYuan(rng.bounded(20, 200))));
+        cardIds.append(cardId);
+    }
+    storage.saveAllCards(cards);
+
+    CardService cardService;
+    RecordService recordService;
+    cardService.setClock(&clock);
+    recordService.setClock(&clock);
+    cardService.initialize();
+    recordService.initialize();
+    TransactionManager transactions(&cardService, &recordService);
+    SessionSupervisor supervisor(&cardService, &recordService);
+
+    Stats stats;
+    QObject::connect(&supervisor, &SessionSupervisor::sessionExpired, [&](const QString& cardId) {
+        const Money cost = transactions.endSession(cardId).cost();
+        if (!cost.isNegative()) {
+            ++stats.autoEnded;
+            stats.income += cost;
+        }
+    });
+
+    // 预先生成每天的到达和闭馆事件，离开事件在上机时加入
+    QMultiMap<qint64, Event> events;
+    std::exponential_distribution<double> gap(arrivalsPerHour / 60.0);
+    for (int day = 0; day < days; ++day) {
+        const QDateTime open = semesterStart.addDays(day).addSecs(OPEN_HOUR * 3600);
+        const QDateTime close = semesterStart.addDays(day).addSecs(CLOSE_HOUR * 3600);
+        for (double minute = gap(rng); minute < (CLOSE_HOUR - OPEN_HOUR) * 60.0;
+             minute += gap(rng)) {
+            events.insert(open.toMSecsSinceEpoch() + static_cast<qint64>(minute * 60000.0),
+                          Event{Event::Type::Arrival, QString()});
+        }
+        events.insert(close.toMSecsSinceEpoch(), Event{Event::Type::Closing, QString()});
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 processed = 0;
+
+    while (!events.isEmpty()) {
+        auto next = events.begin();
+        const qint64 at = next.key();
+        const Event event = next.value();
+        events.erase(next);
+        ++processed;
+
+        // 先让监督器处理到达此刻之前到期的会话
+        clock.setTime(QDateTime::fromMSecsSinceEpoch(at));
+        supervisor.advance();
+
+        switch (event.type) {
+        case Event::Type::Arrival: {
+            ++stats.arrivals;
+            const QString& cardId = cardIds.at(rng.bounded(cardCount));
+            if (recordService.isOnline(cardId)) {
+                ++stats.busy;
+                break;
+            }
+            if (cardService.getBalance(cardId) < Money::fromYuan(2)) {
+                cardService.recharge(cardId, Money::fromYuan(50));
+                ++stats.recharges;
+            }
+            const QString& location = LOCATIONS.at(rng.bounded(LOCATIONS.size()));
+            if (!recordService.startSession(cardId, location).isValid()) {
+                break;
+            }
+            ++stats.started;
+            stats.maxOnline = qMax<qint64>(stats.maxOnline, recordService.getOnlineCount());
+
+            const qint64 stay = qMax<qint64>(60000, static_cast<qint64>(duration(rng) * 60000.0));
+            events.insert(at + stay, Event{Event::Type::Departure, cardId});
+            break;
+        }
+        case Event::Type::Departure: {
+            // 可能已被自动下机或闭馆下机
+            if (!recordService.isOnline(event.cardId)) {
+                break;
+            }
+            const Money cost = transactions.endSession(event.cardId).cost();
+            if (!cost.isNegative()) {
+                ++stats.departures;
+                stats.income += cost;
+            }
+            break;
+        }
+        case Event::Type::Closing: {
+            for (const auto& record : transactions.endSessions(recordService.getOnlineCards())) {
+                ++stats.closingEnded;
+                stats.income += record.cost();
+            }
+            break;
+        }
+        }
+    }
+    transactions.checkpoint();
+
+    const double wallSecs = static_cast<double>(timer.nsecsElapsed()) / 1e9;
+    const double simSecs =
+        static_cast<double>(clock.nowMSecs() - semesterStart.toMSecsSinceEpoch()) / 1000.0;
+
+    std::printf("simulated %d days, %d cards, %.1f arrivals/h, %s durations (mean %.0f min)\n\n",
+                days, cardCount, arrivalsPerHour,
+                qPrintable(parser.value(QStringLiteral("distribution"))), meanMinutes);
+    std::printf("%-24s %12lld\n", "arrivals", static_cast<long long>(stats.arrivals));
+    std::printf("%-24s %12lld\n", "ignored (already online)", static_cast<long long>(stats.busy));
+    std::printf("%-24s %12lld\n", "sessions started", static_cast<long long>(stats.started));
+    std::printf("%-24s %12lld\n", "planned departures", static_cast<long long>(stats.departures));
+    std::printf("%-24s %12lld\n", "balance auto-ends", static_cast<long long>(stats.autoEnded));
+    std::printf("%-24s %12lld\n", "closing check-outs",
+                static_cast<long long>(stats.closingEnded));
+    std::printf("%-24s %12lld\n", "recharges", static_cast<long long>(stats.recharges));
+    std::printf("%-24s %12lld\n", "max concurrent", static_cast<long long>(stats.maxOnline));
+    std::printf("%-24s %12s\n", "income", qPrintable(stats.income.toString()));
+    std::printf("\n%-24s %12.2f\n", "wall time (s)", wallSecs);
+    std::printf("%-24s %12.0f\n", "events/s", static_cast<double>(processed) / wallSecs);
+    std::printf("%-24s %11.0fx\n", "simulated/real time", simSecs / wallSecs);
+
+    storage.setClock(nullptr);
+    return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file LedgerReconcileBenchmark.cpp
+ * @brief 余额流水对账多核扩展性基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在内存中为每张卡生成开户、充值和消费流水，分别以1到N个工作线程执行
+ * BalanceLedger::reconcileAsync，输出每种线程数的最优耗时与相对单线程的加速比，
+ * 并校验差异列表与串行对账一致。同时给出单张卡对账单查询的平均耗时。
+ *
+ * 用法：ledger_reconcile_benchmark [--cards 5000] [--entries 200] [--runs 5]
+ */
+
+#include "model/services/BalanceLedger.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QThreadPool>
+
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+bool sameReport(const ReconciliationReport& a, const ReconciliationReport& b) {
+    if (a.cardsChecked != b.cardsChecked || a.entriesChecked != b.entriesChecked ||
+        a.mismatches.size() != b.mismatches.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < a.mismatches.size(); ++i) {
+        if (a.mismatches.at(i).cardId != b.mismatches.at(i).cardId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("余额流水对账多核扩展性基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("5000")});
+    parser.addOption({QStringLiteral("entries"), QStringLiteral("每张卡的流水数"),
+                      QStringLiteral("n"), QStringLiteral("200")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每种线程数的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("5")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int entriesPerCard = qMax(1, parser.value(QStringLiteral("entries")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+    const int maxThreads = qMax(1, QThread::idealThreadCount());
+
+    // 固定随机种子，每百张卡中有一张物化余额被改动
+    std::printf("generating %d cards x %d entries...\n", cardCount, entriesPerCard);
+    QRandomGenerator rng(20240901);
+    BalanceLedger ledger;
+    QList<Card> cards;
+    cards.reserve(cardCount);
+    for (int c = 0; c < cardCount; ++c) {
+        const QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+        Money balance = Money::fromYuan(100);
+        ledger.append(cardId, LedgerEntryType::Opening, balance);
+        for (int e = 1; e < entriesPerCard; ++e) {
+            const Money amount = (rng.bounded(5) == 0) ? Money::fromYuan(rng.bounded(10, 100))
+                                                       : -Money::fromCents(rng.bounded(50, 500));
+            ledger.append(cardId, amount.isPositive() ? LedgerEntryType::Recharge
+                                                      : LedgerEntryType::Charge,
+                          amount);
+            balance += amount;
+        }
+        if (c % 100 == 0) {
+            balance += Money::fromCents(1);
+        }
+        cards.append(Card(cardId, QStringLiteral("张三"), QStringLiteral("B17010101"), balance));
+    }
+    (void)ledger.takePending();
+    const QHash<QString, QList<LedgerEntry>> accounts = ledger.accounts();
+
+    QElapsedTimer timer;
+    timer.start();
+    const ReconciliationReport expected = BalanceLedger::reconcile(cards, accounts);
+    std::printf("sequential: %lld ms, %lld entries, %lld mismatches\n\n",
+                static_cast<long long>(timer.elapsed()),
+                static_cast<long long>(expected.entriesChecked),
+                static_cast<long long>(expected.mismatches.size()));
+
+    std::printf("%8s %12s %10s %8s\n", "threads", "best(ms)", "speedup", "match");
+    double baseline = 0.0;
+    bool allMatch = true;
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        double best = -1.0;
+        bool match = true;
+        for (int run = 0; run < runs; ++run) {
+            timer.restart();
+            const ReconciliationReport report =
+                BalanceLedger::reconcileAsync(cards, accounts, &pool).result();
+            double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+            best = (best < 0.0) ? elapsed : qMin(best, elapsed);
+            match = match && sameReport(report, expected);
+        }
+        allMatch = allMatch && match;
+
+        if (threads == 1) {
+            baseline = best;
+        }
+        std::printf("%8d %12.2f %9.2fx %8s\n", threads, best, baseline / best,
+                    match ? "yes" : "NO");
+    }
+
+    // 对账单只读取该卡的流水列表，耗时与总流水数无关
+    constexpr int QUERIES = 10000;
+    qsizetype rows = 0;
+    timer.restart();
+    for (int q = 0; q < QUERIES; ++q) {
+        const QString cardId =
+            QStringLiteral("C%1").arg(rng.bounded(cardCount), 6, 10, QLatin1Char('0'));
+        rows += ledger.statement(cardId).size();
+    }
+    std::printf("\nstatement: %.2f us/query (%lld rows)\n",
+                static_cast<double>(timer.nsecsElapsed()) / 1e3 / QUERIES,
+                static_cast<long long>(rows));
+
+    std::printf("check: %s\n", allMatch ? "ok" : "MISMATCH");
+    return allMatch ? 0 : 1;
+}
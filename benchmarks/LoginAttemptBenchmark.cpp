@@ -0,0 +1,145 @@
+/**
+ * @file LoginAttemptBenchmark.cpp
+ * @brief 登录失败计数基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在临时数据目录中准备N张卡，对每张卡依次执行"失败、失败、成功"的登录序列，
+ * 分别用每次尝试后都写回卡文件（相当于旧实现）和只在内存中计数、最后写回一次的方式，
+ * 输出每种方式的最优耗时和每次尝试的耗时，并校验写回后卡文件中的计数一致。
+ *
+ * 用法：login_attempt_benchmark [--cards 500] [--rounds 3] [--runs 3]
+ */
+
+#include "model/repositories/StorageManager.h"
+#include "model/services/CardService.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 一次运行所需的服务（每次运行都从相同的数据文件重新加载）
+ */
+struct Fixture {
+    QTemporaryDir dir;
+    CardService cardService;
+    QStringList cardIds;
+
+    explicit Fixture(int cardCount) {
+        StorageManager::instance().setDataPath(dir.path() + QStringLiteral("/data"));
+        StorageManager::instance().initializeDataDirectory();
+
+        QList<Card> cards;
+        for (int c = 0; c < cardCount; ++c) {
+            const QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+            const QString studentId = QStringLiteral("B%1").arg(c, 8, 10, QLatin1Char('0'));
+            cards.append(Card(cardId, QStringLiteral("学生%1").arg(c), studentId,
+                              Money::fromYuan(20)));
+            cardIds.append(cardId);
+        }
+        StorageManager::instance().saveAllCards(cards);
+        cardService.initialize();
+    }
+
+    /**
+     * @brief 卡文件中保存的失败次数合计
+     */
+    [[nodiscard]] static int savedAttempts() {
+        int total = 0;
+        for (const auto& card : StorageManager::instance().loadAllCards()) {
+            total += card.loginAttempts();
+        }
+        return total;
+    }
+};
+
+struct Strategy {
+    const char* name;
+    bool writeThrough;  ///< 每次尝试后都写卡文件
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("登录失败计数基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("500")});
+    parser.addOption({QStringLiteral("rounds"),
+                      QStringLiteral("每张卡的\"失败、失败、成功\"序列数"), QStringLiteral("n"),
+                      QStringLiteral("3")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每种方式的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("3")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int rounds = qMax(1, parser.value(QStringLiteral("rounds")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+    const int attempts = cardCount * rounds * 3;
+
+    const QList<Strategy> strategies = {
+        {"write-through", true},
+        {"in-memory", false},
+    };
+
+    std::printf("%d cards x %d rounds = %d login attempts, best of %d runs\n\n", cardCount,
+                rounds, attempts, runs);
+    std::printf("%-16s %12s %14s %10s\n", "strategy", "best(ms)", "per-attempt(us)", "saved");
+
+    QList<int> saved;
+    for (const auto& strategy : strategies) {
+        double best = -1.0;
+        int savedTotal = 0;
+        for (int run = 0; run < runs; ++run) {
+            Fixture fixture(cardCount);
+            CardService& service = fixture.cardService;
+            const auto persist = [&] {
+                if (strategy.writeThrough) {
+                    service.flushLoginAttempts();
+                }
+            };
+
+            QElapsedTimer timer;
+            timer.start();
+            for (int round = 0; round < rounds; ++round) {
+                for (const auto& cardId : std::as_const(fixture.cardIds)) {
+                    service.incrementLoginAttempts(cardId);
+                    persist();
+                    service.incrementLoginAttempts(cardId);
+                    persist();
+                    service.resetLoginAttempts(cardId);
+                    persist();
+                }
+            }
+            // 最后一轮只失败不成功，使写回的计数不为0
+            for (const auto& cardId : std::as_const(fixture.cardIds)) {
+                service.incrementLoginAttempts(cardId);
+                persist();
+            }
+            service.flushLoginAttempts();
+            double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+            best = (best < 0.0) ? elapsed : qMin(best, elapsed);
+            savedTotal = Fixture::savedAttempts();
+        }
+        saved.append(savedTotal);
+        std::printf("%-16s %12.2f %14.1f %10d\n", strategy.name, best,
+                    best * 1000.0 / (attempts + cardCount), savedTotal);
+    }
+
+    const bool match = saved.first() == saved.last() && saved.first() == cardCount;
+    std::printf("\ncheck: %s\n", match ? "ok" : "MISMATCH");
+    return match ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file SessionSupervisorBenchmark.cpp
+ * @brief 会话监督时间轮的每刻度开销基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 为N个会话各设置一个在8小时内随机到期的定时器，按秒推进直到全部到期，
+ * 比较TimerWheel与"每秒扫描所有会话的到期时间"两种做法的每刻度耗时，
+ * 并测量定时器加入和取消（余额变化时重新计算）的开销。
+ *
+ * 用法：session_supervisor_benchmark [--hours 8]
+ */
+
+#include "model/services/TimerWheel.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+/**
+ * @brief 每秒扫描全部到期时间的对照实现
+ */
+qint64 scanAll(const QList<qint64>& expiries, qint64 ticks) {
+    QList<qint64> remaining = expiries;
+    qint64 fired = 0;
+    for (qint64 tick = 1; tick <= ticks; ++tick) {
+        for (auto& expiry : remaining) {
+            if (expiry >= 0 && expiry <= tick) {
+                expiry = -1;
+                ++fired;
+            }
+        }
+    }
+    return fired;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("会话监督时间轮基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("hours"), QStringLiteral("模拟的时长（小时）"),
+                      QStringLiteral("n"), QStringLiteral("8")});
+    parser.process(app);
+
+    const qint64 ticks = qMax(1, parser.value(QStringLiteral("hours")).toInt()) * qint64(3600);
+
+    std::printf("advancing %lld one-second ticks\n\n", static_cast<long long>(ticks));
+    std::printf("%10s %14s %14s %16s %10s\n", "sessions", "wheel(ns/tk)", "scan(ns/tk)",
+                "resched(ns/op)", "fired");
+
+    for (int sessions : {10, 100, 1000, 10000}) {
+        QRandomGenerator rng(20240901);
+        QList<qint64> expiries;
+        expiries.reserve(sessions);
+        for (int i = 0; i < sessions; ++i) {
+            expiries.append(1 + rng.bounded(ticks));
+        }
+
+        TimerWheel wheel(0);
+        QList<quint64> ids;
+        ids.reserve(sessions);
+        for (int i = 0; i < sessions; ++i) {
+            ids.append(wheel.schedule(QString::number(i), expiries.at(i)));
+        }
+
+        // 重新计算到期时间：取消后按同一时刻重新加入
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < sessions; ++i) {
+            wheel.cancel(ids.at(i));
+            ids[i] = wheel.schedule(QString::number(i), expiries.at(i));
+        }
+        const double reschedNs = static_cast<double>(timer.nsecsElapsed()) / sessions;
+
+        timer.restart();
+        qint64 fired = 0;
+        for (qint64 tick = 1; tick <= ticks; ++tick) {
+            fired += wheel.advance(tick).size();
+        }
+        const double wheelNs = static_cast<double>(timer.nsecsElapsed()) / ticks;
+
+        timer.restart();
+        const qint64 scanned = scanAll(expiries, ticks);
+        const double scanNs = static_cast<double>(timer.nsecsElapsed()) / ticks;
+
+        std::printf("%10d %14.1f %14.1f %16.1f %10s\n", sessions, wheelNs, scanNs, reschedNs,
+                    fired == sessions && scanned == sessions ? "all" : "MISMATCH");
+    }
+
+    return 0;
+}
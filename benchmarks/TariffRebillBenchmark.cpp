@@ -0,0 +1,175 @@
+/**
+ * @file TariffRebillBenchmark.cpp
+ * @brief 编译后计费规则的计费与批量重新计费基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 生成内存中的模拟记录和一套包含分时段、分地点费率与学号折扣的规则，
+ * 先测量单次计费的吞吐，再分别以1到N个工作线程执行TariffEngine::rebillAsync，
+ * 输出每种线程数的最优耗时与相对单线程的加速比，并校验结果与串行重算一致。
+ *
+ * 用法：tariff_rebill_benchmark [--cards 10000] [--records 200] [--runs 5]
+ */
+
+#include "model/services/TariffEngine.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QThreadPool>
+
+#include <cstdio>
+
+
+using namespace CampusCard;
+
+namespace {
+
+const QStringList LOCATIONS = {QStringLiteral("机房A101"), QStringLiteral("机房A102"),
+                               QStringLiteral("机房B201"), QStringLiteral("机房B202"),
+                               QStringLiteral("图书馆电子阅览室")};
+
+/**
+ * @brief 生成模拟记录与学号（固定随机种子，保证每次运行数据一致）
+ */
+QMap<QString, QList<Record>> generateRecords(int cardCount, int recordsPerCard,
+                                             QMap<QString, QString>& studentIds) {
+    QRandomGenerator rng(20240901);
+    const QDateTime semesterStart(QDate(2024, 9, 1), QTime(0, 0));
+
+    QMap<QString, QList<Record>> records;
+    for (int c = 0; c < cardCount; ++c) {
+        QString cardId = QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0'));
+        studentIds.insert(cardId, QStringLiteral("%1%2")
+                                      .arg(c % 4 == 0 ? QLatin1Char('S') : QLatin1Char('B'))
+                                      .arg(c, 8, 10, QLatin1Char('0')));
+        QList<Record> list;
+        list.reserve(recordsPerCard);
+        for (int r = 0; r < recordsPerCard; ++r) {
+            int duration = rng.bounded(10, 600);
+            QDateTime start = semesterStart.addSecs(rng.bounded(120 * 24 * 3600));
+
+            Record record;
+            record.setRecordId(QStringLiteral("%1-%2").arg(cardId).arg(r));
+            record.setCardId(cardId);
+            record.setLocation(LOCATIONS.at(rng.bounded(LOCATIONS.size())));
+            record.setStartTime(start);
+            record.setEndTime(start.addSecs(duration * 60));
+            record.setDurationMinutes(duration);
+            record.setCost(COST_PER_HOUR.scaled(duration, 60));
+            record.setState(SessionState::Offline);
+            list.append(record);
+        }
+        records.insert(cardId, list);
+    }
+    return records;
+}
+
+/**
+ * @brief 基准使用的规则：夜间半价、午间高峰、图书馆单独定价、研究生八折、最低收费
+ */
+Tariff benchmarkTariff() {
+    Tariff tariff;
+    tariff.minimumCharge = Money::fromCents(20);
+    tariff.rules.append({QString(), 22 * 60, 7 * 60, Money::fromCents(50)});
+    tariff.rules.append({QString(), 11 * 60, 13 * 60, Money::fromCents(150)});
+    tariff.rules.append({LOCATIONS.last(), 0, 24 * 60, Money::fromCents(80)});
+    tariff.discounts.append({QStringLiteral("S"), 80});
+    return tariff;
+}
+
+bool sameReport(const RebillReport& a, const RebillReport& b) {
+    if (a.examined != b.examined || a.oldTotal != b.oldTotal || a.newTotal != b.newTotal ||
+        a.diffs.size() != b.diffs.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < a.diffs.size(); ++i) {
+        if (a.diffs.at(i).recordId != b.diffs.at(i).recordId ||
+            a.diffs.at(i).newCost != b.diffs.at(i).newCost) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("计费规则与批量重新计费基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("10000")});
+    parser.addOption({QStringLiteral("records"), QStringLiteral("每张卡的记录数"),
+                      QStringLiteral("n"), QStringLiteral("200")});
+    parser.addOption({QStringLiteral("runs"), QStringLiteral("每种线程数的重复次数"),
+                      QStringLiteral("n"), QStringLiteral("5")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int recordsPerCard = qMax(1, parser.value(QStringLiteral("records")).toInt());
+    const int runs = qMax(1, parser.value(QStringLiteral("runs")).toInt());
+    const int maxThreads = qMax(1, QThread::idealThreadCount());
+
+    std::printf("generating %d cards x %d records...\n", cardCount, recordsPerCard);
+    QMap<QString, QString> studentIds;
+    const QMap<QString, QList<Record>> records =
+        generateRecords(cardCount, recordsPerCard, studentIds);
+    const TariffEngine engine(benchmarkTariff());
+    const RecordQuery query;
+
+    // 单次计费吞吐
+    QElapsedTimer timer;
+    timer.start();
+    qint64 calls = 0;
+    Money checksum;
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
+        const QString studentId = studentIds.value(it.key());
+        for (const auto& record : it.value()) {
+            checksum += engine.cost(record.location(), record.startTime(),
+                                    record.durationMinutes(), studentId);
+            ++calls;
+        }
+    }
+    const double costNs = static_cast<double>(timer.nsecsElapsed()) / static_cast<double>(calls);
+    std::printf("cost(): %lld calls, %.1f ns/call (checksum %s)\n",
+                static_cast<long long>(calls), costNs, qPrintable(checksum.toString()));
+
+    timer.restart();
+    const RebillReport expected = engine.rebill(records, studentIds, query);
+    std::printf("sequential rebill: %lld ms, %lld changed, delta %s\n\n",
+                static_cast<long long>(timer.elapsed()),
+                static_cast<long long>(expected.diffs.size()),
+                qPrintable(expected.delta().toString()));
+
+    std::printf("%8s %12s %10s %8s\n", "threads", "best(ms)", "speedup", "match");
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        double best = -1.0;
+        bool match = true;
+        for (int run = 0; run < runs; ++run) {
+            timer.restart();
+            QFuture<RebillReport> future = engine.rebillAsync(records, studentIds, query, &pool);
+            RebillReport report = future.result();
+            double elapsed = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+            best = (best < 0.0) ? elapsed : qMin(best, elapsed);
+            match = match && sameReport(report, expected);
+        }
+
+        if (threads == 1) {
+            baseline = best;
+        }
+        std::printf("%8d %12.2f %9.2fx %8s\n", threads, best, baseline / best,
+                    match ? "yes" : "NO");
+    }
+
+    return 0;
+}
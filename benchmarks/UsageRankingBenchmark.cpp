@@ -0,0 +1,114 @@
+/**
+ * @file UsageRankingBenchmark.cpp
+ * @brief 使用排行增量更新与前K名查询基准
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * 在指定数量的卡上随机累加会话，测量增量更新吞吐量与前K名查询耗时，
+ * 并与"累计后全量排序"的朴素做法对比。
+ *
+ * 用法：usage_ranking_benchmark [--cards 100000] [--sessions 1000000] [--k 50]
+ */
+
+#include "model/services/UsageRanking.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+using namespace CampusCard;
+
+namespace {
+
+struct Session {
+    int card;
+    int dayOffset;
+    int minutes;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("使用排行增量更新与前K名查询基准"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("cards"), QStringLiteral("卡数量"), QStringLiteral("n"),
+                      QStringLiteral("100000")});
+    parser.addOption({QStringLiteral("sessions"), QStringLiteral("会话数量"), QStringLiteral("n"),
+                      QStringLiteral("1000000")});
+    parser.addOption({QStringLiteral("k"), QStringLiteral("排行数量"), QStringLiteral("n"),
+                      QStringLiteral("50")});
+    parser.process(app);
+
+    const int cardCount = qMax(1, parser.value(QStringLiteral("cards")).toInt());
+    const int sessionCount = qMax(1, parser.value(QStringLiteral("sessions")).toInt());
+    const int k = qMax(1, parser.value(QStringLiteral("k")).toInt());
+
+    // 预先生成卡号与会话，避免计入生成开销
+    QStringList cardIds;
+    cardIds.reserve(cardCount);
+    for (int c = 0; c < cardCount; ++c) {
+        cardIds.append(QStringLiteral("C%1").arg(c, 6, 10, QLatin1Char('0')));
+    }
+    QRandomGenerator rng(20240901);
+    std::vector<Session> sessions;
+    sessions.reserve(sessionCount);
+    for (int i = 0; i < sessionCount; ++i) {
+        sessions.push_back({rng.bounded(cardCount), rng.bounded(120), rng.bounded(10, 240)});
+    }
+    const QDate semesterStart(2024, 9, 2);
+
+    // 增量更新
+    UsageRanking ranking;
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto& session : sessions) {
+        ranking.addSession(cardIds.at(session.card), semesterStart.addDays(session.dayOffset),
+                           session.minutes, COST_PER_HOUR.scaled(session.minutes, 60));
+    }
+    const double updateMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    std::printf("updates: %d sessions on %d cards in %.2f ms (%.0f ns/update)\n", sessionCount,
+                cardCount, updateMs, updateMs * 1e6 / sessionCount);
+
+    // 前K名查询
+    const int queryRuns = 1000;
+    timer.restart();
+    qsizetype sink = 0;
+    for (int i = 0; i < queryRuns; ++i) {
+        sink += ranking.top(i % 2 ? RankMetric::Minutes : RankMetric::Spend, k).size();
+        sink += ranking.topForWeek(RankMetric::Minutes, semesterStart.addDays(i % 120), k).size();
+    }
+    const double queryUs = static_cast<double>(timer.nsecsElapsed()) / 1e3 / (2 * queryRuns);
+    std::printf("top-%d query: %.2f us/query\n", k, queryUs);
+
+    // 朴素做法：累计后对全部卡排序
+    timer.restart();
+    std::vector<qint64> minutes(cardCount, 0);
+    for (const auto& session : sessions) {
+        minutes[session.card] += session.minutes;
+    }
+    std::vector<int> order(cardCount);
+    for (int c = 0; c < cardCount; ++c) {
+        order[c] = c;
+    }
+    std::partial_sort(order.begin(), order.begin() + qMin(k, cardCount), order.end(),
+                      [&minutes](int a, int b) { return minutes[a] > minutes[b]; });
+    const double naiveMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    std::printf("naive recompute (sum + partial sort): %.2f ms/query\n", naiveMs);
+
+    // 校验第一名一致
+    QList<RecordGroup> top = ranking.top(RankMetric::Minutes, 1);
+    bool match = !top.isEmpty() && top.first().totalDuration == minutes[order.front()];
+    std::printf("check: %s (sink=%lld)\n", match ? "ok" : "MISMATCH",
+                static_cast<long long>(sink));
+
+    return match ? 0 : 1;
+}
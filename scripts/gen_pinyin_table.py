@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+生成 src/model/services/PinyinTable.cpp 中的拼音对照表
+对 GB2312 的全部 6763 个汉字调用 ICU 的 Han-Latin 转写（uconv 命令，离线运行），
+去掉声调（ü 写作 v），按音节分组后输出 C++ 源文件
+"""
+
+import subprocess
+import sys
+import unicodedata
+from pathlib import Path
+
+OUTPUT = Path(__file__).resolve().parent.parent / 'src/model/services/PinyinTable.cpp'
+
+# 作为姓氏时与 Han-Latin 给出的常用读音不同的字
+SURNAMES = {
+    '单': 'shan', '曾': 'zeng', '仇': 'qiu', '解': 'xie', '查': 'zha', '区': 'ou',
+    '朴': 'piao', '盖': 'ge', '乐': 'yue', '覃': 'qin', '尉': 'yu', '缪': 'miao',
+    '翟': 'zhai', '种': 'chong', '召': 'shao', '员': 'yun', '繁': 'po', '隗': 'wei',
+    '秘': 'bi', '万': 'mo', '薄': 'bo', '折': 'she', '长': 'chang',
+}
+
+# 每行最多的汉字数（每个汉字占两列，保证不超过100列）
+CHARS_PER_LINE = 36
+
+HEADER = '''/**
+ * @file PinyinTable.cpp
+ * @brief 汉字拼音对照表实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ * 对照表由 scripts/gen_pinyin_table.py 生成，请勿手工修改
+ */
+
+#include "PinyinTable.h"
+
+#include <QHash>
+
+#include <iterator>
+
+
+namespace CampusCard {
+
+namespace {
+
+/**
+ * @struct Syllable
+ * @brief 一个音节及读这个音节的汉字
+ */
+struct Syllable {
+    const char* pinyin;      ///< 不带声调的拼音（ü写作v）
+    const char16_t* chars;   ///< 汉字
+};
+
+/**
+ * @brief GB2312全部汉字的常用读音（ICU Han-Latin转写）
+ */
+constexpr Syllable SYLLABLES[] = {
+'''
+
+MIDDLE = '''};
+
+/**
+ * @brief 作为姓氏时的读音（只列出与常用读音不同的字）
+ */
+constexpr Syllable SURNAMES[] = {
+'''
+
+FOOTER = '''};
+
+/**
+ * @brief 由对照表构建的汉字到拼音的映射
+ */
+QHash<QChar, QString> buildIndex(const Syllable* table, qsizetype count) {
+    QHash<QChar, QString> index;
+    for (qsizetype i = 0; i < count; ++i) {
+        const QString pinyin = QString::fromLatin1(table[i].pinyin);
+        for (const char16_t* c = table[i].chars; *c; ++c) {
+            index.insert(QChar(*c), pinyin);
+        }
+    }
+    return index;
+}
+
+}  // namespace
+
+QString PinyinTable::syllable(QChar ch) {
+    static const QHash<QChar, QString> index = buildIndex(SYLLABLES, std::size(SYLLABLES));
+    return index.value(ch);
+}
+
+QString PinyinTable::surnameSyllable(QChar ch) {
+    static const QHash<QChar, QString> index = buildIndex(SURNAMES, std::size(SURNAMES));
+    return index.value(ch);
+}
+
+QStringList PinyinTable::searchKeys(const QString& name) {
+    const QString folded = name.toCaseFolded();
+    QString full;
+    QString initials;
+    QString surnameFull;
+    QString surnameInitials;
+    bool hasHan = false;
+    bool first = true;
+
+    for (QChar ch : folded) {
+        if (ch.isSpace()) {
+            continue;
+        }
+        const QString pinyin = syllable(ch);
+        if (pinyin.isEmpty()) {
+            // 非汉字的字母数字原样保留在全拼中，表外的字被跳过
+            if (ch.isLetterOrNumber() && ch.script() != QChar::Script_Han) {
+                full += ch;
+                surnameFull += ch;
+            }
+            first = false;
+            continue;
+        }
+
+        hasHan = true;
+        const QString surname = first ? surnameSyllable(ch) : QString();
+        const QString& reading = surname.isEmpty() ? pinyin : surname;
+        full += pinyin;
+        initials += pinyin.front();
+        surnameFull += reading;
+        surnameInitials += reading.front();
+        first = false;
+    }
+
+    if (!hasHan) {
+        return {};
+    }
+    QStringList keys = {full, initials};
+    if (surnameFull != full) {
+        keys << surnameFull << surnameInitials;
+    }
+    keys.removeDuplicates();
+    return keys;
+}
+
+}  // namespace CampusCard
+'''
+
+
+def gb2312_chars():
+    """GB2312 一级和二级汉字"""
+    chars = []
+    for hi in range(0xB0, 0xF8):
+        for lo in range(0xA1, 0xFF):
+            try:
+                chars.append(bytes([hi, lo]).decode('gb2312'))
+            except UnicodeDecodeError:
+                pass
+    return chars
+
+
+def strip_tone(pinyin: str) -> str:
+    """去掉声调，ü 写作 v"""
+    out = []
+    for ch in pinyin:
+        if ch in 'üǖǘǚǜ':
+            out.append('v')
+        else:
+            out.append(unicodedata.normalize('NFD', ch)[0])
+    return ''.join(out).lower()
+
+
+def entries(table):
+    """输出按音节排序的表项"""
+    lines = []
+    for pinyin in sorted(table):
+        chars = table[pinyin]
+        chunks = [chars[i:i + CHARS_PER_LINE] for i in range(0, len(chars), CHARS_PER_LINE)]
+        prefix = '    {"%s", ' % pinyin
+        indent = ' ' * len(prefix)
+        for n, chunk in enumerate(chunks):
+            head = prefix if n == 0 else indent
+            tail = '},' if n == len(chunks) - 1 else ''
+            lines.append('%su"%s"%s' % (head, chunk, tail))
+    return '\n'.join(lines) + '\n'
+
+
+def main() -> int:
+    chars = gb2312_chars()
+    result = subprocess.run(['uconv', '-f', 'utf-8', '-t', 'utf-8', '-x', 'Han-Latin'],
+                            input='\n'.join(chars) + '\n', capture_output=True, text=True,
+                            check=True)
+    readings = result.stdout.split('\n')[:len(chars)]
+
+    table = {}
+    for ch, reading in zip(chars, readings):
+        pinyin = strip_tone(reading.strip())
+        if not pinyin.isascii() or not pinyin.isalpha():
+            print('无法转写: %s -> %s' % (ch, reading), file=sys.stderr)
+            return 1
+        table[pinyin] = table.get(pinyin, '') + ch
+
+    surnames = {}
+    for ch, pinyin in SURNAMES.items():
+        surnames[pinyin] = surnames.get(pinyin, '') + ch
+
+    OUTPUT.write_text(HEADER + entries(table) + MIDDLE + entries(surnames) + FOOTER,
+                      encoding='utf-8')
+    print('%d 个汉字，%d 个音节 -> %s' % (len(chars), len(table), OUTPUT))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
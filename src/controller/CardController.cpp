@@ -9,6 +9,8 @@
 
 #include "CardController.h"
 
+#include <QFile>
+
 namespace CampusCard {
 
 CardController::CardController(CardService* cardService, QObject* parent)
@@ -17,6 +19,15 @@ CardController::CardController(CardService* cardService, QObject* parent)
     // 连接CardService的信号，转发给View
     connect(m_cardService, &CardService::cardsChanged, this, &CardController::cardsUpdated);
     connect(m_cardService, &CardService::cardUpdated, this, &CardController::cardUpdated);
+
+    // 对账结果
+    connect(&m_reconcileWatcher, &QFutureWatcher<ReconciliationReport>::finished, this,
+            [this]() { emit reconciliationFinished(m_reconcileWatcher.result()); });
+}
+
+CardController::~CardController() {
+    // 工作线程持有的是卡与流水的副本，等待结束即可安全析构
+    m_reconcileWatcher.waitForFinished();
 }
 
 // ========== 查询操作 ==========
@@ -38,26 +49,20 @@ int CardController::getCardCount() const {
 }
 
 QList<Card> CardController::searchCards(const QString& keyword) const {
-    QList<Card> result;
-    if (keyword.isEmpty()) {
-        return m_cardService->getAllCards();
-    }
+    return m_cardService->searchCards(keyword);
+}
 
-    QString lowerKeyword = keyword.toLower();
-    for (const auto& card : m_cardService->getAllCards()) {
-        if (card.cardId().toLower().contains(lowerKeyword) ||
-            card.name().toLower().contains(lowerKeyword) ||
-            card.studentId().toLower().contains(lowerKeyword)) {
-            result.append(card);
-        }
-    }
-    return result;
+QList<Card> CardController::searchCards(const QString& keyword, CardSortField field,
+                                        bool descending) const {
+    QList<Card> cards = m_cardService->searchCards(keyword);
+    m_cardService->sortCards(cards, field, descending);
+    return cards;
 }
 
 // ========== 创建操作 ==========
 
 void CardController::handleCreateCard(const QString& cardId, const QString& name,
-                                        const QString& studentId, double initialBalance) {
+                                        const QString& studentId, Money initialBalance) {
     // 验证输入
     if (cardId.isEmpty()) {
         emit cardCreateFailed(QStringLiteral("卡号不能为空"));
@@ -113,7 +118,7 @@ void CardController::handleRegisterCard(const QString& cardId, const QString& na
     }
 
     // 创建卡
-    Card newCard(cardId, name, studentId, 0.0);
+    Card newCard(cardId, name, studentId, Money());
     newCard.setPassword(password);
 
     if (m_cardService->createCard(newCard)) {
@@ -125,44 +130,76 @@ void CardController::handleRegisterCard(const QString& cardId, const QString& na
 
 // ========== 充值扣款操作 ==========
 
-void CardController::handleRecharge(const QString& cardId, double amount) {
-    if (amount <= 0) {
+void CardController::handleRecharge(const QString& cardId, Money amount) {
+    if (!amount.isPositive()) {
         emit rechargeFailed(QStringLiteral("充值金额必须大于0"));
         return;
     }
 
     if (m_cardService->recharge(cardId, amount)) {
-        double newBalance = m_cardService->getBalance(cardId);
+        Money newBalance = m_cardService->getBalance(cardId);
         emit rechargeSuccess(cardId, newBalance);
     } else {
         emit rechargeFailed(QStringLiteral("充值失败"));
     }
 }
 
-void CardController::handleDeduct(const QString& cardId, double amount) {
-    if (amount <= 0) {
+void CardController::handleDeduct(const QString& cardId, Money amount) {
+    if (!amount.isPositive()) {
         emit deductFailed(QStringLiteral("扣款金额必须大于0"));
         return;
     }
 
-    double currentBalance = m_cardService->getBalance(cardId);
+    Money currentBalance = m_cardService->getBalance(cardId);
     if (currentBalance < amount) {
         emit deductFailed(QStringLiteral("余额不足"));
         return;
     }
 
     if (m_cardService->deduct(cardId, amount)) {
-        double newBalance = m_cardService->getBalance(cardId);
+        Money newBalance = m_cardService->getBalance(cardId);
         emit deductSuccess(cardId, newBalance);
     } else {
         emit deductFailed(QStringLiteral("扣款失败"));
     }
 }
 
-double CardController::getBalance(const QString& cardId) const {
+RechargeBatchReport CardController::handleBatchRecharge(const QString& filePath,
+                                                        bool validateOnly) {
+    RechargeBatchReport report;
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        report = m_cardService->rechargeBatch(&file, validateOnly);
+    } else {
+        report.errors.append({0, QString(), QStringLiteral("无法打开文件：%1").arg(filePath)});
+    }
+    emit batchRechargeFinished(report);
+    return report;
+}
+
+Money CardController::getBalance(const QString& cardId) const {
     return m_cardService->getBalance(cardId);
 }
 
+// ========== 余额流水 ==========
+
+QList<LedgerEntry> CardController::getStatement(const QString& cardId, const QDate& from,
+                                                const QDate& to) const {
+    return m_cardService->getStatement(cardId, from, to);
+}
+
+bool CardController::startReconciliation() {
+    if (isReconciliationRunning()) {
+        return false;
+    }
+    m_reconcileWatcher.setFuture(m_cardService->reconcileLedgerAsync());
+    return true;
+}
+
+bool CardController::isReconciliationRunning() const {
+    return m_reconcileWatcher.isRunning();
+}
+
 // ========== 状态管理操作 ==========
 
 void CardController::handleReportLost(const QString& cardId) {
@@ -197,6 +234,46 @@ void CardController::handleUnfreeze(const QString& cardId) {
     }
 }
 
+// ========== 批量操作 ==========
+
+QStringList CardController::findCardIds(const CardQuery& query) const {
+    return m_cardService->findCardIds(query);
+}
+
+CardBatchResult CardController::handleBulkAction(CardBulkAction action, const CardQuery& query,
+                                                 const QString& newPassword) {
+    CardBatchResult result;
+    switch (action) {
+    case CardBulkAction::ReportLost:
+        result = m_cardService->reportLostBatch(query);
+        break;
+    case CardBulkAction::CancelLost:
+        result = m_cardService->cancelLostBatch(query);
+        break;
+    case CardBulkAction::Freeze:
+        result = m_cardService->freezeBatch(query);
+        break;
+    case CardBulkAction::Unfreeze:
+        result = m_cardService->unfreezeBatch(query);
+        break;
+    case CardBulkAction::ResetPassword:
+        if (newPassword.isEmpty()) {
+            emit passwordChangeFailed(QStringLiteral("密码不能为空"));
+            return result;
+        }
+        result = m_cardService->resetPasswordBatch(query, newPassword);
+        break;
+    }
+    emit bulkActionFinished(action, result.changed, result.saved);
+    return result;
+}
+
+CardBatchResult CardController::handleBulkAction(CardBulkAction action,
+                                                 const QStringList& cardIds,
+                                                 const QString& newPassword) {
+    return handleBulkAction(action, CardQuery().cards(cardIds), newPassword);
+}
+
 // ========== 密码管理 ==========
 
 void CardController::handleChangePassword(const QString& cardId, const QString& oldPassword,
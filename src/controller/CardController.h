@@ -13,11 +13,24 @@
 
 #include "model/services/CardService.h"
 
+#include <QFutureWatcher>
 #include <QObject>
 
 
 namespace CampusCard {
 
+/**
+ * @enum CardBulkAction
+ * @brief 管理员批量卡操作
+ */
+enum class CardBulkAction {
+    ReportLost = 0,  ///< 挂失
+    CancelLost,      ///< 解挂
+    Freeze,          ///< 冻结
+    Unfreeze,        ///< 解冻
+    ResetPassword    ///< 重置密码
+};
+
 /**
  * @class CardController
  * @brief 校园卡控制器，处理卡管理相关的用户交互
@@ -41,7 +54,7 @@ public:
     /**
      * @brief 析构函数
      */
-    ~CardController() override = default;
+    ~CardController() override;
 
     // ========== 查询操作 ==========
 
@@ -74,10 +87,20 @@ public:
     /**
      * @brief 搜索卡（按卡号、姓名、学号）
      * @param keyword 搜索关键词
-     * @return 匹配的卡列表
+     * @return 匹配的卡列表（完全匹配在前，其次是前缀匹配）
      */
     [[nodiscard]] QList<Card> searchCards(const QString& keyword) const;
 
+    /**
+     * @brief 搜索卡并按列排序
+     * @param keyword 搜索关键词（为空时为所有卡）
+     * @param field 排序列
+     * @param descending 是否降序
+     * @return 排好序的匹配卡列表
+     */
+    [[nodiscard]] QList<Card> searchCards(const QString& keyword, CardSortField field,
+                                          bool descending) const;
+
     // ========== 创建操作 ==========
 
     /**
@@ -88,7 +111,7 @@ public:
      * @param initialBalance 初始余额
      */
     void handleCreateCard(const QString& cardId, const QString& name, const QString& studentId,
-                          double initialBalance = 0.0);
+                          Money initialBalance = Money());
 
     /**
      * @brief 处理注册新卡请求（包含密码）
@@ -107,21 +130,57 @@ public:
      * @param cardId 卡号
      * @param amount 充值金额
      */
-    void handleRecharge(const QString& cardId, double amount);
+    void handleRecharge(const QString& cardId, Money amount);
 
     /**
      * @brief 处理扣款请求
      * @param cardId 卡号
      * @param amount 扣款金额
      */
-    void handleDeduct(const QString& cardId, double amount);
+    void handleDeduct(const QString& cardId, Money amount);
+
+    /**
+     * @brief 处理批量充值请求（从财务下发的CSV充值文件）
+     *
+     * 完成后发出batchRechargeFinished；无法打开文件时结果中只有一条行号为0的错误
+     * @param filePath 充值文件路径
+     * @param validateOnly 是否只校验不充值
+     * @return 批量充值结果
+     */
+    RechargeBatchReport handleBatchRecharge(const QString& filePath, bool validateOnly = false);
 
     /**
      * @brief 获取卡余额
      * @param cardId 卡号
      * @return 余额
      */
-    [[nodiscard]] double getBalance(const QString& cardId) const;
+    [[nodiscard]] Money getBalance(const QString& cardId) const;
+
+    // ========== 余额流水 ==========
+
+    /**
+     * @brief 获取卡的对账单
+     * @param cardId 卡号
+     * @param from 起始日期（含，无效表示不限）
+     * @param to 结束日期（含，无效表示不限）
+     * @return 流水（按序号递增）
+     */
+    [[nodiscard]] QList<LedgerEntry> getStatement(const QString& cardId,
+                                                  const QDate& from = QDate(),
+                                                  const QDate& to = QDate()) const;
+
+    /**
+     * @brief 在后台开始核对全部卡余额与流水
+     *
+     * 完成后发出reconciliationFinished；已有对账在进行中时返回false
+     * @return 是否已开始
+     */
+    bool startReconciliation();
+
+    /**
+     * @brief 对账是否正在进行
+     */
+    [[nodiscard]] bool isReconciliationRunning() const;
 
     // ========== 状态管理操作 ==========
 
@@ -149,6 +208,37 @@ public:
      */
     void handleUnfreeze(const QString& cardId);
 
+    // ========== 批量操作 ==========
+
+    /**
+     * @brief 按组合条件查找卡号（用于批量操作前预览）
+     * @param query 查询条件
+     * @return 卡号列表（按卡号排序）
+     */
+    [[nodiscard]] QStringList findCardIds(const CardQuery& query) const;
+
+    /**
+     * @brief 处理批量操作请求（一次保存，只刷新一次卡列表）
+     *
+     * 完成后发出bulkActionFinished；重置密码而新密码为空时发出passwordChangeFailed
+     * @param action 操作
+     * @param query 目标卡
+     * @param newPassword 新密码（仅重置密码时使用）
+     * @return 实际修改的卡号和保存结果
+     */
+    CardBatchResult handleBulkAction(CardBulkAction action, const CardQuery& query,
+                                     const QString& newPassword = QString());
+
+    /**
+     * @brief 处理对一组选中卡的批量操作请求
+     * @param action 操作
+     * @param cardIds 卡号列表
+     * @param newPassword 新密码（仅重置密码时使用）
+     * @return 实际修改的卡号和保存结果
+     */
+    CardBatchResult handleBulkAction(CardBulkAction action, const QStringList& cardIds,
+                                     const QString& newPassword = QString());
+
     // ========== 密码管理 ==========
 
     /**
@@ -187,7 +277,7 @@ signals:
      * @param cardId 卡号
      * @param newBalance 新余额
      */
-    void rechargeSuccess(const QString& cardId, double newBalance);
+    void rechargeSuccess(const QString& cardId, Money newBalance);
 
     /**
      * @brief 充值失败信号
@@ -200,7 +290,7 @@ signals:
      * @param cardId 卡号
      * @param newBalance 新余额
      */
-    void deductSuccess(const QString& cardId, double newBalance);
+    void deductSuccess(const QString& cardId, Money newBalance);
 
     /**
      * @brief 扣款失败信号
@@ -208,6 +298,12 @@ signals:
      */
     void deductFailed(const QString& message);
 
+    /**
+     * @brief 批量充值完成信号（含只校验）
+     * @param report 批量充值结果
+     */
+    void batchRechargeFinished(const RechargeBatchReport& report);
+
     /**
      * @brief 挂失成功信号
      * @param cardId 卡号
@@ -267,8 +363,23 @@ signals:
      */
     void cardUpdated(const QString& cardId);
 
+    /**
+     * @brief 批量操作完成信号
+     * @param action 操作
+     * @param cardIds 实际修改的卡号（不满足条件或无需修改的卡不在其中）
+     * @param saved 修改后是否已保存（失败时修改只在内存中，下次保存时写入）
+     */
+    void bulkActionFinished(CardBulkAction action, const QStringList& cardIds, bool saved);
+
+    /**
+     * @brief 对账完成信号
+     * @param report 对账报告
+     */
+    void reconciliationFinished(const ReconciliationReport& report);
+
 private:
-    CardService* m_cardService;  ///< 卡服务
+    CardService* m_cardService;                               ///< 卡服务
+    QFutureWatcher<ReconciliationReport> m_reconcileWatcher;  ///< 对账任务监视器
 };
 
 }  // namespace CampusCard
@@ -13,6 +13,15 @@ namespace CampusCard {
 
 MainController::MainController(QObject* parent) : QObject(parent) {}
 
+MainController::~MainController() {
+    if (m_cardService) {
+        m_cardService->flushLoginAttempts();
+    }
+    if (m_transactionManager) {
+        m_transactionManager->checkpoint();
+    }
+}
+
 bool MainController::initialize(const QString& dataPath) {
     // 初始化存储管理器
     StorageManager::instance().setDataPath(dataPath);
@@ -24,15 +33,30 @@ bool MainController::initialize(const QString& dataPath) {
     m_cardService = new CardService(this);
     m_recordService = new RecordService(this);
     m_authService = new AuthService(m_cardService, this);
+    m_transactionManager = new TransactionManager(m_cardService, m_recordService, this);
+    m_sessionSupervisor = new SessionSupervisor(m_cardService, m_recordService, nullptr, this);
 
-    // 初始化服务
+    // 初始化服务，并重放上次退出前未检查点的事务
     m_cardService->initialize();
     m_recordService->initialize();
+    m_transactionManager->recover();
 
     // 创建控制器层
     m_authController = new AuthController(m_authService, m_cardService, this);
     m_cardController = new CardController(m_cardService, this);
-    m_recordController = new RecordController(m_recordService, m_cardService, this);
+    m_recordController =
+        new RecordController(m_recordService, m_cardService, m_transactionManager, this);
+
+    // 余额即将用完或长时间无操作的会话按正常下机流程结算
+    connect(m_sessionSupervisor, &SessionSupervisor::sessionExpired, this,
+            [this](const QString& cardId) { m_recordController->handleEndSession(cardId); });
+    m_sessionSupervisor->start();
+
+    // 登录失败计数只在内存中累加，定期写回卡文件
+    m_attemptFlushTimer.setInterval(CardService::LOGIN_ATTEMPT_FLUSH_MSECS);
+    connect(&m_attemptFlushTimer, &QTimer::timeout, m_cardService,
+            &CardService::flushLoginAttempts);
+    m_attemptFlushTimer.start();
 
     // 连接信号：创建新卡时更新 RecordService 的卡号到学号映射
     connect(m_cardService, &CardService::cardCreated, this, [this](const QString& cardId) {
@@ -49,6 +73,8 @@ bool MainController::initialize(const QString& dataPath) {
 // ========== 数据管理 ==========
 
 void MainController::generateMockData(int cardCount, int recordsPerCard) {
+    // 先将已提交的事务写入数据文件，再整体替换
+    m_transactionManager->checkpoint();
     StorageManager::instance().generateMockData(cardCount, recordsPerCard);
 
     // 重新加载数据
@@ -58,7 +84,8 @@ void MainController::generateMockData(int cardCount, int recordsPerCard) {
 }
 
 bool MainController::exportData(const QString& filePath) {
-    if (StorageManager::instance().exportAllData(filePath)) {
+    // 导出一致性快照：不必先检查点，导出期间上下机照常进行
+    if (StorageManager::instance().exportAllData(filePath, m_transactionManager->snapshot())) {
         emit exportSuccess();
         return true;
     } else {
@@ -68,6 +95,9 @@ bool MainController::exportData(const QString& filePath) {
 }
 
 bool MainController::importData(const QString& filePath, bool merge) {
+    // 合并导入后重新加载，先写回内存中的计数
+    m_cardService->flushLoginAttempts();
+    m_transactionManager->checkpoint();
     if (StorageManager::instance().importData(filePath, merge)) {
         // 重新加载数据
         reloadData();
@@ -82,6 +112,8 @@ bool MainController::importData(const QString& filePath, bool merge) {
 void MainController::reloadData() {
     m_cardService->initialize();
     m_recordService->initialize();
+    m_transactionManager->recover();
+    m_sessionSupervisor->start();
     emit dataReloaded();
 }
 
@@ -18,8 +18,11 @@
 #include "model/services/AuthService.h"
 #include "model/services/CardService.h"
 #include "model/services/RecordService.h"
+#include "model/services/SessionSupervisor.h"
+#include "model/services/TransactionManager.h"
 
 #include <QObject>
+#include <QTimer>
 
 
 namespace CampusCard {
@@ -45,9 +48,9 @@ public:
     explicit MainController(QObject* parent = nullptr);
 
     /**
-     * @brief 析构函数
+     * @brief 析构函数（写回登录失败计数并执行事务检查点，正常退出后不留下待重放的日志）
      */
-    ~MainController() override = default;
+    ~MainController() override;
 
     /**
      * @brief 初始化控制器和服务
@@ -90,6 +93,18 @@ public:
      */
     [[nodiscard]] RecordService* recordService() const { return m_recordService; }
 
+    /**
+     * @brief 获取事务管理器
+     * @return 事务管理器指针
+     */
+    [[nodiscard]] TransactionManager* transactionManager() const { return m_transactionManager; }
+
+    /**
+     * @brief 获取会话监督器
+     * @return 会话监督器指针
+     */
+    [[nodiscard]] SessionSupervisor* sessionSupervisor() const { return m_sessionSupervisor; }
+
     /**
      * @brief 获取认证服务
      * @return 认证服务指针
@@ -169,6 +184,9 @@ private:
     CardService* m_cardService = nullptr;      ///< 卡服务
     RecordService* m_recordService = nullptr;  ///< 记录服务
     AuthService* m_authService = nullptr;      ///< 认证服务
+    TransactionManager* m_transactionManager = nullptr;  ///< 事务管理器
+    SessionSupervisor* m_sessionSupervisor = nullptr;    ///< 会话监督器
+    QTimer m_attemptFlushTimer;                          ///< 定期写回登录失败计数
 
     // ========== 控制器层 ==========
     AuthController* m_authController = nullptr;      ///< 认证控制器
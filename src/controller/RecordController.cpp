@@ -9,17 +9,41 @@
 
 #include "RecordController.h"
 
-#include <QDate>
+#include <QSet>
 
 namespace CampusCard {
 
 RecordController::RecordController(RecordService* recordService, CardService* cardService,
-                                   QObject* parent)
-    : QObject(parent), m_recordService(recordService), m_cardService(cardService) {
+                                   TransactionManager* transactions, QObject* parent)
+    : QObject(parent),
+      m_recordService(recordService),
+      m_cardService(cardService),
+      m_transactions(transactions) {
 
     // 连接RecordService的信号，转发给View
     connect(m_recordService, &RecordService::recordsChanged, this,
             &RecordController::recordsUpdated);
+    connect(m_recordService, &RecordService::recordsBatchChanged, this,
+            &RecordController::recordsBatchUpdated);
+
+    // 历史报表进度与结果
+    connect(&m_reportWatcher, &QFutureWatcher<HistorySummary>::progressValueChanged, this,
+            [this](int value) {
+                emit historyReportProgress(value, m_reportWatcher.progressMaximum());
+            });
+    connect(&m_reportWatcher, &QFutureWatcher<HistorySummary>::finished, this, [this]() {
+        if (m_reportWatcher.isCanceled()) {
+            emit historyReportCanceled();
+        } else {
+            emit historyReportFinished(m_reportWatcher.result());
+        }
+    });
+}
+
+RecordController::~RecordController() {
+    // 工作线程持有的是记录快照，取消后等待结束即可安全析构
+    m_reportWatcher.cancel();
+    m_reportWatcher.waitForFinished();
 }
 
 // ========== 上下机操作 ==========
@@ -39,7 +63,7 @@ void RecordController::handleStartSession(const QString& cardId, const QString&
     }
 
     // 检查余额
-    if (card.balance() <= 0) {
+    if (!card.balance().isPositive()) {
         emit sessionStartFailed(QStringLiteral("余额不足，请先充值"));
         return;
     }
@@ -66,32 +90,104 @@ void RecordController::handleEndSession(const QString& cardId) {
         return;
     }
 
-    // 结束上机
-    double cost = m_recordService->endSession(cardId);
-    if (cost < 0) {
+    // 结束上机并扣款（记录结束与扣款作为一条事务提交）
+    const Record closed = m_transactions->endSession(cardId);
+    if (!closed.isValid()) {
         emit sessionEndFailed(QStringLiteral("结束上机失败"));
         return;
     }
 
-    // 获取时长
-    int duration = 0;
-    QList<Record> records = m_recordService->getRecords(cardId);
-    if (!records.isEmpty()) {
-        // 最后一条记录就是刚结束的
-        for (int i = records.size() - 1; i >= 0; --i) {
-            if (records[i].isOffline()) {
-                duration = records[i].durationMinutes();
-                break;
+    emit sessionEnded(cardId, closed.cost(), closed.durationMinutes());
+}
+
+BatchSessionResult RecordController::handleStartSessions(const QStringList& cardIds,
+                                                        const QString& location) {
+    BatchSessionResult result;
+    QStringList accepted;
+    QSet<QString> seen;
+
+    // 一次性校验所有卡，规则与handleStartSession()相同
+    for (const auto& cardId : cardIds) {
+        if (seen.contains(cardId)) {
+            result.failed.insert(cardId, QStringLiteral("卡号重复"));
+            continue;
+        }
+        seen.insert(cardId);
+
+        Card card = m_cardService->findCard(cardId);
+        if (card.cardId().isEmpty()) {
+            result.failed.insert(cardId, QStringLiteral("卡不存在"));
+        } else if (!card.isUsable()) {
+            result.failed.insert(cardId, QStringLiteral("卡片状态异常，无法上机"));
+        } else if (!card.balance().isPositive()) {
+            result.failed.insert(cardId, QStringLiteral("余额不足，请先充值"));
+        } else if (m_recordService->isOnline(cardId)) {
+            result.failed.insert(cardId, QStringLiteral("当前已在上机中"));
+        } else {
+            accepted.append(cardId);
+        }
+    }
+
+    if (accepted.isEmpty()) {
+        return result;
+    }
+
+    const QList<Record> started = m_recordService->startSessions(accepted, location);
+    for (const auto& record : started) {
+        result.succeeded.append(record.cardId());
+    }
+    if (result.succeeded.size() != accepted.size()) {
+        for (const auto& cardId : accepted) {
+            if (!result.succeeded.contains(cardId)) {
+                result.failed.insert(cardId, QStringLiteral("开始上机失败"));
             }
         }
     }
 
-    // 扣款
-    if (cost > 0) {
-        m_cardService->deduct(cardId, cost);
+    if (!result.succeeded.isEmpty()) {
+        emit sessionsStarted(result.succeeded, location);
+    }
+    return result;
+}
+
+BatchSessionResult RecordController::handleEndSessions(const QStringList& cardIds) {
+    BatchSessionResult result;
+    QStringList accepted;
+    QSet<QString> seen;
+
+    for (const auto& cardId : cardIds) {
+        if (seen.contains(cardId)) {
+            result.failed.insert(cardId, QStringLiteral("卡号重复"));
+            continue;
+        }
+        seen.insert(cardId);
+
+        if (m_recordService->isOnline(cardId)) {
+            accepted.append(cardId);
+        } else {
+            result.failed.insert(cardId, QStringLiteral("当前未在上机中"));
+        }
     }
 
-    emit sessionEnded(cardId, cost, duration);
+    if (accepted.isEmpty()) {
+        return result;
+    }
+
+    // 整批记录结束与扣款作为一条事务提交
+    const QList<Record> closed = m_transactions->endSessions(accepted);
+    if (closed.isEmpty()) {
+        for (const auto& cardId : accepted) {
+            result.failed.insert(cardId, QStringLiteral("结束上机失败"));
+        }
+        return result;
+    }
+
+    for (const auto& record : closed) {
+        result.succeeded.append(record.cardId());
+        result.totalCost += record.cost();
+    }
+    emit sessionsEnded(result.succeeded, result.totalCost);
+    return result;
 }
 
 bool RecordController::isOnline(const QString& cardId) const {
@@ -102,7 +198,7 @@ Record RecordController::getCurrentSession(const QString& cardId) const {
     return m_recordService->getCurrentSession(cardId);
 }
 
-double RecordController::getCurrentCost(const QString& cardId) const {
+Money RecordController::getCurrentCost(const QString& cardId) const {
     return m_recordService->calculateCurrentCost(cardId);
 }
 
@@ -126,36 +222,131 @@ QList<Record> RecordController::getRecordsByLocation(const QString& cardId,
 QList<Record> RecordController::getFilteredRecords(const QString& cardId, const QString& startDate,
                                                     const QString& endDate,
                                                     const QString& location) const {
-    QList<Record> records = m_recordService->getRecords(cardId);
-    QList<Record> result;
+    return getFilteredRecordsView(cardId, startDate, endDate, location).toList();
+}
+
+QStringList RecordController::getLocations(const QString& cardId) const {
+    return m_recordService->getLocations(cardId);
+}
 
-    QDate start = QDate::fromString(startDate, QStringLiteral("yyyy-MM-dd"));
-    QDate end = QDate::fromString(endDate, QStringLiteral("yyyy-MM-dd"));
+QList<Record> RecordController::getAllRecordsByDate(const QString& date) const {
+    return m_recordService->getAllRecordsByDate(date);
+}
 
-    for (const auto& record : records) {
-        // 日期筛选
-        QDate recordDate = QDate::fromString(record.date(), QStringLiteral("yyyy-MM-dd"));
-        if (recordDate < start || recordDate > end) {
-            continue;
-        }
+// ========== 视图查询 ==========
 
-        // 地点筛选
-        if (!location.isEmpty() && record.location() != location) {
-            continue;
-        }
+RecordView RecordController::getRecordsView(const QString& cardId) const {
+    return m_recordService->recordsView(cardId);
+}
+
+RecordView RecordController::getFilteredRecordsView(const QString& cardId,
+                                                    const QString& startDate,
+                                                    const QString& endDate,
+                                                    const QString& location) const {
+    return m_recordService->filteredRecordsView(cardId, startDate, endDate, location);
+}
+
+RecordView RecordController::getAllRecordsViewByDate(const QString& date) const {
+    return m_recordService->allRecordsViewByDate(date);
+}
+
+// ========== 组合查询 ==========
+
+RecordView RecordController::queryRecords(const RecordQuery& query) const {
+    return m_recordService->executeQuery(query);
+}
+
+QList<RecordGroup> RecordController::aggregateRecords(const RecordQuery& query,
+                                                      RecordQuery::GroupField groupBy) const {
+    return m_recordService->aggregate(query, groupBy);
+}
+
+// ========== 区间台账 ==========
+
+LedgerTotals RecordController::getRangeTotals(const QString& startDate, const QString& endDate,
+                                              const QString& location) const {
+    return m_recordService->rangeTotals(startDate, endDate, location);
+}
+
+// ========== 去重人数 ==========
+
+qint64 RecordController::getDistinctUsers(const QString& startDate, const QString& endDate,
+                                          const QStringList& locations, DistinctMode mode) const {
+    return m_recordService->distinctUsers(startDate, endDate, locations, mode);
+}
+
+// ========== 同期群查询 ==========
+
+CardBitmap RecordController::getActiveCards(const QString& startDate,
+                                            const QString& endDate) const {
+    return m_recordService->activeCards(startDate, endDate);
+}
+
+CardBitmap RecordController::getLocationCards(const QString& location) const {
+    return m_recordService->locationCards(location);
+}
+
+QStringList RecordController::getCohortCards(const CardBitmap& cohort) const {
+    return m_recordService->cohortCards(cohort);
+}
+
+// ========== 使用热力图 ==========
 
-        result.append(record);
+HeatmapGrid RecordController::getUsageHeatmap(const QString& location, const QString& startDate,
+                                              const QString& endDate) const {
+    return m_recordService->usageHeatmap(location, startDate, endDate);
+}
+
+QStringList RecordController::getHeatmapLocations() const {
+    return m_recordService->heatmapLocations();
+}
+
+// ========== 使用排行 ==========
+
+QList<RecordGroup> RecordController::getTopUsers(RankMetric metric, RankPeriod period,
+                                                 int k) const {
+    return m_recordService->topUsers(metric, period, k);
+}
+
+// ========== 全量历史报表 ==========
+
+bool RecordController::startHistoryReport(const RecordQuery& query, int topN) {
+    if (isHistoryReportRunning()) {
+        return false;
     }
+    // 在一致性快照上汇总，不会看到只应用了一半的下机结算
+    m_reportWatcher.setFuture(
+        HistoryAggregator::summarizeAsync(m_transactions->snapshot().records(), query, topN));
+    return true;
+}
 
-    return result;
+void RecordController::cancelHistoryReport() {
+    if (isHistoryReportRunning()) {
+        m_reportWatcher.cancel();
+    }
 }
 
-QStringList RecordController::getLocations(const QString& cardId) const {
-    return m_recordService->getLocations(cardId);
+bool RecordController::isHistoryReportRunning() const {
+    return m_reportWatcher.isRunning();
 }
 
-QList<Record> RecordController::getAllRecordsByDate(const QString& date) const {
-    return m_recordService->getAllRecordsByDate(date);
+// ========== 计费规则 ==========
+
+Tariff RecordController::getTariff() const {
+    return m_recordService->tariff();
+}
+
+bool RecordController::setTariff(const Tariff& tariff) {
+    return m_recordService->setTariff(tariff);
+}
+
+RebillReport RecordController::previewRebill(const RecordQuery& query,
+                                             const Tariff& tariff) const {
+    return m_recordService->rebill(query, tariff);
+}
+
+int RecordController::applyRebill(const RebillReport& report) {
+    return m_recordService->applyRebill(report);
 }
 
 // ========== 统计查询 ==========
@@ -168,11 +359,11 @@ int RecordController::getTotalDuration(const QString& cardId) const {
     return m_recordService->getTotalDuration(cardId);
 }
 
-double RecordController::getTotalCost(const QString& cardId) const {
+Money RecordController::getTotalCost(const QString& cardId) const {
     return m_recordService->getTotalCost(cardId);
 }
 
-double RecordController::getDailyIncome(const QString& date) const {
+Money RecordController::getDailyIncome(const QString& date) const {
     return m_recordService->getDailyIncome(date);
 }
 
@@ -13,12 +13,26 @@
 
 #include "model/services/CardService.h"
 #include "model/services/RecordService.h"
+#include "model/services/TransactionManager.h"
 
+#include <QFutureWatcher>
+#include <QMap>
 #include <QObject>
+#include <QStringList>
 
 
 namespace CampusCard {
 
+/**
+ * @struct BatchSessionResult
+ * @brief 批量上下机结果
+ */
+struct BatchSessionResult {
+    QStringList succeeded;         ///< 成功的卡号
+    QMap<QString, QString> failed;  ///< 失败的卡号及原因
+    Money totalCost;               ///< 批量下机的费用合计（上机时为0）
+};
+
 /**
  * @class RecordController
  * @brief 上机记录控制器，处理上下机和记录查询相关的用户交互
@@ -37,15 +51,16 @@ public:
      * @brief 构造函数
      * @param recordService 记录服务
      * @param cardService 卡服务
+     * @param transactions 事务管理器（下机结算以单条事务日志提交）
      * @param parent 父对象
      */
-    explicit RecordController(RecordService* recordService, CardService* cardService,
-                              QObject* parent = nullptr);
+    RecordController(RecordService* recordService, CardService* cardService,
+                     TransactionManager* transactions, QObject* parent = nullptr);
 
     /**
      * @brief 析构函数
      */
-    ~RecordController() override = default;
+    ~RecordController() override;
 
     // ========== 上下机操作 ==========
 
@@ -62,6 +77,26 @@ public:
      */
     void handleEndSession(const QString& cardId);
 
+    /**
+     * @brief 处理批量上机请求（如整个机房同时上课）
+     *
+     * 所有卡先一次性校验，校验规则与handleStartSession()相同；
+     * 通过校验的卡一次性上机，成功时只发出一次sessionsStarted信号
+     * @param cardIds 卡号列表
+     * @param location 上机地点
+     * @return 批量结果
+     */
+    BatchSessionResult handleStartSessions(const QStringList& cardIds, const QString& location);
+
+    /**
+     * @brief 处理批量下机请求
+     *
+     * 整批记录结束与扣款作为一条事务提交，成功时只发出一次sessionsEnded信号
+     * @param cardIds 卡号列表
+     * @return 批量结果
+     */
+    BatchSessionResult handleEndSessions(const QStringList& cardIds);
+
     /**
      * @brief 检查是否正在上机
      * @param cardId 卡号
@@ -81,7 +116,7 @@ public:
      * @param cardId 卡号
      * @return 当前费用
      */
-    [[nodiscard]] double getCurrentCost(const QString& cardId) const;
+    [[nodiscard]] Money getCurrentCost(const QString& cardId) const;
 
     // ========== 记录查询 ==========
 
@@ -138,6 +173,191 @@ public:
      */
     [[nodiscard]] QList<Record> getAllRecordsByDate(const QString& date) const;
 
+    // ========== 视图查询（隐式共享） ==========
+    // 返回的RecordView持有记录，不受RecordService后续修改影响
+
+    /**
+     * @brief 获取指定卡所有记录的视图
+     * @param cardId 卡号
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView getRecordsView(const QString& cardId) const;
+
+    /**
+     * @brief 获取筛选后的记录视图
+     * @param cardId 卡号
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @param location 地点（空表示不筛选）
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView getFilteredRecordsView(const QString& cardId,
+                                                    const QString& startDate,
+                                                    const QString& endDate,
+                                                    const QString& location) const;
+
+    /**
+     * @brief 获取所有卡的指定日期记录视图
+     * @param date 日期
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView getAllRecordsViewByDate(const QString& date) const;
+
+    // ========== 组合查询 ==========
+
+    /**
+     * @brief 执行组合查询
+     * @param query 查询条件
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView queryRecords(const RecordQuery& query) const;
+
+    /**
+     * @brief 执行分组聚合查询
+     * @param query 查询条件
+     * @param groupBy 分组字段
+     * @return 聚合结果
+     */
+    [[nodiscard]] QList<RecordGroup> aggregateRecords(const RecordQuery& query,
+                                                      RecordQuery::GroupField groupBy) const;
+
+    // ========== 区间台账 ==========
+
+    /**
+     * @brief 统计日期闭区间的收入、上机次数和时长
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @param location 地点（空字符串表示所有地点）
+     * @return 合计
+     */
+    [[nodiscard]] LedgerTotals getRangeTotals(const QString& startDate, const QString& endDate,
+                                              const QString& location = QString()) const;
+
+    // ========== 去重人数 ==========
+
+    /**
+     * @brief 统计日期闭区间、地点集合内上机的去重人数
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @param locations 地点集合（空表示所有地点）
+     * @param mode 计数方式（精确方式用于审计）
+     * @return 去重人数
+     */
+    [[nodiscard]] qint64 getDistinctUsers(const QString& startDate, const QString& endDate,
+                                          const QStringList& locations = QStringList(),
+                                          DistinctMode mode = DistinctMode::Approximate) const;
+
+    // ========== 同期群查询 ==========
+    // 例如"第1周和第10周都上机的学生"为 getActiveCards(第1周) & getActiveCards(第10周)，
+    // "用过A101但从未用过B202"为 getLocationCards(A101).andNot(getLocationCards(B202))
+
+    /**
+     * @brief 获取日期闭区间内有上机记录的卡集合
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @return 卡集合
+     */
+    [[nodiscard]] CardBitmap getActiveCards(const QString& startDate,
+                                            const QString& endDate) const;
+
+    /**
+     * @brief 获取在某地点有过上机记录的卡集合
+     * @param location 地点
+     * @return 卡集合
+     */
+    [[nodiscard]] CardBitmap getLocationCards(const QString& location) const;
+
+    /**
+     * @brief 将卡集合转换为卡号
+     * @param cohort 卡集合
+     * @return 卡号列表（已排序）
+     */
+    [[nodiscard]] QStringList getCohortCards(const CardBitmap& cohort) const;
+
+    // ========== 使用热力图 ==========
+
+    /**
+     * @brief 获取日期范围内的使用热力图
+     * @param location 地点（空字符串表示所有地点）
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @return 星期×小时使用时长网格
+     */
+    [[nodiscard]] HeatmapGrid getUsageHeatmap(const QString& location, const QString& startDate,
+                                              const QString& endDate) const;
+
+    /**
+     * @brief 获取热力图中有数据的地点
+     * @return 地点列表
+     */
+    [[nodiscard]] QStringList getHeatmapLocations() const;
+
+    // ========== 使用排行 ==========
+
+    /**
+     * @brief 获取时长或消费前K名的卡
+     * @param metric 排行指标
+     * @param period 排行周期
+     * @param k 数量
+     * @return 排行（key为卡号）
+     */
+    [[nodiscard]] QList<RecordGroup> getTopUsers(RankMetric metric, RankPeriod period,
+                                                 int k = 50) const;
+
+    // ========== 全量历史报表 ==========
+
+    /**
+     * @brief 在后台开始生成历史汇总报表
+     *
+     * 进度通过historyReportProgress报告，完成后发出historyReportFinished；
+     * 已有报表在生成中时返回false
+     * @param query 过滤条件（如学期日期范围）
+     * @param topN 卡排行数量
+     * @return 是否已开始
+     */
+    bool startHistoryReport(const RecordQuery& query, int topN = 10);
+
+    /**
+     * @brief 取消正在生成的历史报表
+     */
+    void cancelHistoryReport();
+
+    /**
+     * @brief 是否有历史报表正在生成
+     * @return 是否生成中
+     */
+    [[nodiscard]] bool isHistoryReportRunning() const;
+
+    // ========== 计费规则 ==========
+
+    /**
+     * @brief 获取当前计费规则
+     * @return 规则集
+     */
+    [[nodiscard]] Tariff getTariff() const;
+
+    /**
+     * @brief 设置计费规则（只影响之后结束的会话）
+     * @param tariff 规则集
+     * @return 是否保存成功
+     */
+    bool setTariff(const Tariff& tariff);
+
+    /**
+     * @brief 预览按新规则重新计费的结果（不修改记录）
+     * @param query 过滤条件
+     * @param tariff 新规则集
+     * @return 差异报告
+     */
+    [[nodiscard]] RebillReport previewRebill(const RecordQuery& query, const Tariff& tariff) const;
+
+    /**
+     * @brief 将重新计费报告写回记录
+     * @param report 差异报告
+     * @return 实际更新的记录数
+     */
+    int applyRebill(const RebillReport& report);
+
     // ========== 统计查询 ==========
 
     /**
@@ -159,14 +379,14 @@ public:
      * @param cardId 卡号
      * @return 费用
      */
-    [[nodiscard]] double getTotalCost(const QString& cardId) const;
+    [[nodiscard]] Money getTotalCost(const QString& cardId) const;
 
     /**
      * @brief 获取当日收入
      * @param date 日期
      * @return 收入
      */
-    [[nodiscard]] double getDailyIncome(const QString& date) const;
+    [[nodiscard]] Money getDailyIncome(const QString& date) const;
 
     /**
      * @brief 获取当日上机次数
@@ -217,7 +437,7 @@ signals:
      * @param cost 费用
      * @param duration 时长（分钟）
      */
-    void sessionEnded(const QString& cardId, double cost, int duration);
+    void sessionEnded(const QString& cardId, Money cost, int duration);
 
     /**
      * @brief 下机失败信号
@@ -225,15 +445,57 @@ signals:
      */
     void sessionEndFailed(const QString& message);
 
+    /**
+     * @brief 批量上机成功信号
+     * @param cardIds 成功上机的卡号
+     * @param location 地点
+     */
+    void sessionsStarted(const QStringList& cardIds, const QString& location);
+
+    /**
+     * @brief 批量下机成功信号
+     * @param cardIds 成功下机的卡号
+     * @param totalCost 费用合计
+     */
+    void sessionsEnded(const QStringList& cardIds, Money totalCost);
+
     /**
      * @brief 记录更新信号
      * @param cardId 卡号
      */
     void recordsUpdated(const QString& cardId);
 
+    /**
+     * @brief 批量记录更新信号
+     * @param cardIds 卡号列表
+     */
+    void recordsBatchUpdated(const QStringList& cardIds);
+
+    // ========== 历史报表信号 ==========
+
+    /**
+     * @brief 历史报表进度信号
+     * @param done 已完成的分块数
+     * @param total 分块总数
+     */
+    void historyReportProgress(int done, int total);
+
+    /**
+     * @brief 历史报表完成信号
+     * @param summary 汇总结果
+     */
+    void historyReportFinished(const HistorySummary& summary);
+
+    /**
+     * @brief 历史报表已取消信号
+     */
+    void historyReportCanceled();
+
 private:
     RecordService* m_recordService;  ///< 记录服务
     CardService* m_cardService;      ///< 卡服务
+    TransactionManager* m_transactions;  ///< 事务管理器
+    QFutureWatcher<HistorySummary> m_reportWatcher;  ///< 历史报表任务监视器
 };
 
 }  // namespace CampusCard
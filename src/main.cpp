@@ -6,12 +6,81 @@
  *
  * 校园卡消费记录查询系统主入口
  * 基于 Qt6 + ElaWidgetTools 开发
+ *
+ * 带 --batch-recharge 参数时不启动界面，只执行批量充值：
+ * CampusCardSystem --batch-recharge <file.csv> [--data <dir>] [--dry-run]
  */
 
 #include "ElaApplication.h"
+#include "controller/MainController.h"
 #include "view/MainWindow.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 是否为命令行批量充值模式（需在创建应用对象之前判断）
+ */
+bool isBatchRecharge(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch-recharge") == 0 ||
+            std::strncmp(argv[i], "--batch-recharge=", 17) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 命令行批量充值
+ * @return 退出码（0成功，1文件有误或保存失败，2数据目录无法初始化）
+ */
+int runBatchRecharge(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("CampusCardSystem"));
+    app.setApplicationVersion(QStringLiteral("1.0.0"));
+    app.setOrganizationName(QStringLiteral("CampusCard"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("校园卡批量充值"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("batch-recharge"),
+                      QStringLiteral("充值文件（CSV：卡号,金额）"), QStringLiteral("file")});
+    parser.addOption({QStringLiteral("data"), QStringLiteral("数据目录"), QStringLiteral("dir"),
+                      QCoreApplication::applicationDirPath() + QStringLiteral("/data")});
+    parser.addOption({QStringLiteral("dry-run"), QStringLiteral("只校验不充值")});
+    parser.process(app);
+
+    const bool dryRun = parser.isSet(QStringLiteral("dry-run"));
+    const QString dataPath = parser.value(QStringLiteral("data"));
+
+    // 与界面共用同一套初始化流程（含事务日志重放），析构时执行检查点
+    CampusCard::MainController controller;
+    if (!controller.initialize(dataPath)) {
+        std::fprintf(stderr, "cannot initialize data directory: %s\n", qPrintable(dataPath));
+        return 2;
+    }
+
+    const QString filePath = parser.value(QStringLiteral("batch-recharge"));
+    const CampusCard::RechargeBatchReport report =
+        controller.cardController()->handleBatchRecharge(filePath, dryRun);
+    for (const auto& error : report.errors) {
+        std::fprintf(stderr, "line %d %s: %s\n", error.line, qPrintable(error.cardId),
+                     qPrintable(error.message));
+    }
+    std::printf("%s\n", qPrintable(report.summary()));
+
+    const bool ok = report.isClean() && (dryRun || report.applied == 0 || report.saved);
+    return ok ? 0 : 1;
+}
+
+}  // namespace
 
 /**
  * @brief 主函数，应用程序入口点
@@ -20,6 +89,10 @@
  * @return 应用程序退出码
  */
 int main(int argc, char* argv[]) {
+    if (isBatchRecharge(argc, argv)) {
+        return runBatchRecharge(argc, argv);
+    }
+
     // 使用ElaApplication替代QApplication以获得更好的主题支持
     QApplication app(argc, argv);
 
@@ -0,0 +1,129 @@
+/**
+ * @file Clock.h
+ * @brief 可替换的时钟接口
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层公共类型定义
+ * Model层中依赖当前时间的组件都通过Clock取时间：正常运行时使用系统时钟，
+ * 负载模拟时使用可任意拨动、可加速的模拟时钟
+ */
+
+#ifndef MODEL_CLOCK_H
+#define MODEL_CLOCK_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+
+
+namespace CampusCard {
+
+/**
+ * @class Clock
+ * @brief 时钟接口
+ */
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    /**
+     * @brief 当前时间
+     * @return 自1970-01-01 UTC起的毫秒数
+     */
+    [[nodiscard]] virtual qint64 nowMSecs() const = 0;
+
+    /**
+     * @brief 当前时间（本地时间）
+     * @return 时间
+     */
+    [[nodiscard]] QDateTime now() const { return QDateTime::fromMSecsSinceEpoch(nowMSecs()); }
+
+    /**
+     * @brief 系统时钟
+     * @return 进程内共享的系统时钟
+     */
+    [[nodiscard]] static Clock* system();
+};
+
+/**
+ * @class SystemClock
+ * @brief 读取系统当前时间的时钟
+ */
+class SystemClock : public Clock {
+public:
+    [[nodiscard]] qint64 nowMSecs() const override {
+        return QDateTime::currentMSecsSinceEpoch();
+    }
+};
+
+/**
+ * @class SimulatedClock
+ * @brief 模拟时钟
+ *
+ * 时间只在调用advance()或setTime()时前进，离散事件模拟可以直接跳到下一个事件；
+ * 设置了加速倍率时，另外按真实流逝时间乘以倍率前进（如3600表示真实1秒为模拟1小时）
+ */
+class SimulatedClock : public Clock {
+public:
+    /**
+     * @brief 构造函数
+     * @param start 起始时间
+     * @param speed 加速倍率（0表示只手动前进）
+     */
+    explicit SimulatedClock(const QDateTime& start, double speed = 0.0)
+        : m_base(start.toMSecsSinceEpoch()), m_speed(speed) {
+        m_wall.start();
+    }
+
+    [[nodiscard]] qint64 nowMSecs() const override {
+        if (m_speed <= 0.0) {
+            return m_base;
+        }
+        return m_base + static_cast<qint64>(static_cast<double>(m_wall.elapsed()) * m_speed);
+    }
+
+    /**
+     * @brief 前进
+     * @param msecs 毫秒（负值被忽略，模拟时间不倒退）
+     */
+    void advance(qint64 msecs) { m_base += qMax(qint64(0), msecs); }
+
+    /**
+     * @brief 拨到指定时间
+     * @param time 时间
+     */
+    void setTime(const QDateTime& time) {
+        m_base = time.toMSecsSinceEpoch();
+        m_wall.restart();
+    }
+
+    /**
+     * @brief 设置加速倍率（从当前模拟时间起生效）
+     * @param speed 加速倍率（0表示只手动前进）
+     */
+    void setSpeed(double speed) {
+        m_base = nowMSecs();
+        m_wall.restart();
+        m_speed = speed;
+    }
+
+    /**
+     * @brief 获取加速倍率
+     * @return 倍率
+     */
+    [[nodiscard]] double speed() const { return m_speed; }
+
+private:
+    qint64 m_base;          ///< 上次拨动时的模拟时间（毫秒）
+    double m_speed;         ///< 加速倍率
+    QElapsedTimer m_wall;   ///< 上次拨动后的真实流逝时间
+};
+
+inline Clock* Clock::system() {
+    static SystemClock clock;
+    return &clock;
+}
+
+}  // namespace CampusCard
+
+#endif  // MODEL_CLOCK_H
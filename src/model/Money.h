@@ -0,0 +1,190 @@
+/**
+ * @file Money.h
+ * @brief 定点金额类型
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层公共类型定义
+ * 金额以64位整数"分"存储，余额、费用和各类汇总均为精确的整数运算，
+ * 仅在显示和读写文件时与文本或旧格式的浮点数相互转换
+ */
+
+#ifndef MODEL_MONEY_H
+#define MODEL_MONEY_H
+
+#include <QJsonObject>
+#include <QString>
+
+#include <cmath>
+#include <compare>
+
+
+namespace CampusCard {
+
+/**
+ * @class Money
+ * @brief 以分为单位的定点金额
+ */
+class Money {
+public:
+    /**
+     * @brief 构造零金额
+     */
+    constexpr Money() = default;
+
+    /**
+     * @brief 由分构造
+     * @param cents 分
+     * @return 金额
+     */
+    [[nodiscard]] static constexpr Money fromCents(qint64 cents) {
+        Money money;
+        money.m_cents = cents;
+        return money;
+    }
+
+    /**
+     * @brief 由元（浮点数）构造，四舍五入到分（用于读取旧数据和界面输入）
+     * @param yuan 元
+     * @return 金额
+     */
+    [[nodiscard]] static Money fromYuan(double yuan) {
+        return fromCents(std::llround(yuan * 100.0));
+    }
+
+    /**
+     * @brief 从文本解析（如 "12.5"、"-3.05"），最多两位小数
+     * @param text 文本
+     * @param ok 输出是否成功（可为nullptr）
+     * @return 金额（失败返回零）
+     */
+    [[nodiscard]] static Money fromString(const QString& text, bool* ok = nullptr) {
+        const QString trimmed = text.trimmed();
+        qsizetype pos = 0;
+        bool negative = false;
+        if (pos < trimmed.size() && (trimmed.at(pos) == QLatin1Char('-') ||
+                                     trimmed.at(pos) == QLatin1Char('+'))) {
+            negative = trimmed.at(pos) == QLatin1Char('-');
+            ++pos;
+        }
+
+        qint64 cents = 0;
+        int integerDigits = 0;
+        int fractionDigits = -1;  // -1 表示尚未遇到小数点
+        bool valid = pos < trimmed.size();
+        for (; valid && pos < trimmed.size(); ++pos) {
+            const QChar ch = trimmed.at(pos);
+            if (ch == QLatin1Char('.') && fractionDigits < 0) {
+                fractionDigits = 0;
+            } else if (ch.isDigit() && fractionDigits < 2 && integerDigits < 15) {
+                cents = cents * 10 + ch.digitValue();
+                if (fractionDigits >= 0) {
+                    ++fractionDigits;
+                } else {
+                    ++integerDigits;
+                }
+            } else {
+                valid = false;
+            }
+        }
+        valid = valid && (integerDigits > 0 || fractionDigits > 0);
+        for (int i = qMax(fractionDigits, 0); i < 2; ++i) {
+            cents *= 10;
+        }
+
+        if (ok) {
+            *ok = valid;
+        }
+        return valid ? fromCents(negative ? -cents : cents) : Money();
+    }
+
+    /**
+     * @brief 从JSON读取金额
+     *
+     * 优先读取"<key>Cents"整数字段；旧版本数据文件只有以元为单位的
+     * 浮点数字段"<key>"，此时四舍五入到分
+     * @param json JSON对象
+     * @param key 字段名（如 "balance"）
+     * @return 金额
+     */
+    [[nodiscard]] static Money fromJson(const QJsonObject& json, const QString& key) {
+        const QJsonValue cents = json[key + QStringLiteral("Cents")];
+        if (cents.isDouble()) {
+            return fromCents(cents.toInteger());
+        }
+        return fromYuan(json[key].toDouble());
+    }
+
+    /**
+     * @brief 写入JSON（"<key>Cents"为权威值，同时保留旧的"<key>"元字段供旧版本读取）
+     * @param json JSON对象
+     * @param key 字段名
+     */
+    void writeJson(QJsonObject& json, const QString& key) const {
+        json[key + QStringLiteral("Cents")] = m_cents;
+        json[key] = toYuan();
+    }
+
+    /**
+     * @brief 分
+     */
+    [[nodiscard]] constexpr qint64 cents() const { return m_cents; }
+
+    /**
+     * @brief 元（浮点数，仅用于图表等无需精确的场合）
+     */
+    [[nodiscard]] constexpr double toYuan() const { return static_cast<double>(m_cents) / 100.0; }
+
+    /**
+     * @brief 格式化为两位小数的文本（如 "12.50"）
+     */
+    [[nodiscard]] QString toString() const {
+        const qint64 magnitude = m_cents < 0 ? -m_cents : m_cents;
+        return QStringLiteral("%1%2.%3")
+            .arg(m_cents < 0 ? QStringLiteral("-") : QString())
+            .arg(magnitude / 100)
+            .arg(magnitude % 100, 2, 10, QLatin1Char('0'));
+    }
+
+    [[nodiscard]] constexpr bool isZero() const { return m_cents == 0; }
+    [[nodiscard]] constexpr bool isNegative() const { return m_cents < 0; }
+    [[nodiscard]] constexpr bool isPositive() const { return m_cents > 0; }
+
+    /**
+     * @brief 按比例缩放并四舍五入到分（如按分钟折算小时费率）
+     * @param numerator 分子
+     * @param denominator 分母（必须为正）
+     * @return 缩放后的金额
+     */
+    [[nodiscard]] constexpr Money scaled(qint64 numerator, qint64 denominator) const {
+        const qint64 product = m_cents * numerator;
+        const qint64 half = denominator / 2;
+        return fromCents(product >= 0 ? (product + half) / denominator
+                                      : -((-product + half) / denominator));
+    }
+
+    constexpr Money& operator+=(Money other) {
+        m_cents += other.m_cents;
+        return *this;
+    }
+    constexpr Money& operator-=(Money other) {
+        m_cents -= other.m_cents;
+        return *this;
+    }
+    [[nodiscard]] friend constexpr Money operator+(Money a, Money b) { return a += b; }
+    [[nodiscard]] friend constexpr Money operator-(Money a, Money b) { return a -= b; }
+    [[nodiscard]] friend constexpr Money operator-(Money a) { return fromCents(-a.m_cents); }
+    [[nodiscard]] friend constexpr Money operator*(Money a, qint64 factor) {
+        return fromCents(a.m_cents * factor);
+    }
+
+    friend constexpr bool operator==(Money a, Money b) = default;
+    friend constexpr auto operator<=>(Money a, Money b) = default;
+
+private:
+    qint64 m_cents = 0;  ///< 分
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_MONEY_H
@@ -10,6 +10,8 @@
 #ifndef MODEL_TYPES_H
 #define MODEL_TYPES_H
 
+#include "model/Money.h"
+
 #include <QDateTime>
 #include <QString>
 
@@ -112,9 +114,9 @@ inline QString loginResultToString(LoginResult result) {
 }
 
 /**
- * @brief 每小时上机费用（元）
+ * @brief 每小时上机费用（1元）
  */
-constexpr double COST_PER_HOUR = 1.0;
+constexpr Money COST_PER_HOUR = Money::fromCents(100);
 
 /**
  * @brief 默认管理员密码
@@ -14,7 +14,7 @@
 
 namespace CampusCard {
 
-Card::Card(const QString& cardId, const QString& name, const QString& studentId, double balance)
+Card::Card(const QString& cardId, const QString& name, const QString& studentId, Money balance)
     : m_cardId(cardId), m_name(name), m_studentId(studentId), m_balance(balance),
       m_totalRecharge(balance),  // 初始余额视为首次充值
       m_state(CardState::Normal), m_loginAttempts(0),
@@ -27,11 +27,15 @@ Card Card::fromJson(const QJsonObject& json) {
     card.m_cardId = json[QStringLiteral("cardId")].toString();
     card.m_name = json[QStringLiteral("name")].toString();
     card.m_studentId = json[QStringLiteral("studentId")].toString();
-    card.m_totalRecharge = json[QStringLiteral("totalRecharge")].toDouble();
-    card.m_balance = json[QStringLiteral("balance")].toDouble();
+    card.m_totalRecharge = Money::fromJson(json, QStringLiteral("totalRecharge"));
+    card.m_balance = Money::fromJson(json, QStringLiteral("balance"));
     card.m_state = static_cast<CardState>(json[QStringLiteral("state")].toInt());
+    card.m_stateChangedAt =
+        QDateTime::fromString(json[QStringLiteral("stateChangedAt")].toString(), Qt::ISODate);
     card.m_loginAttempts = json[QStringLiteral("loginAttempts")].toInt();
     card.m_password = json[QStringLiteral("password")].toString(DEFAULT_STUDENT_PASSWORD);
+    card.m_journalSequence =
+        static_cast<quint64>(json[QStringLiteral("journalSeq")].toInteger());
     return card;
 }
 
@@ -41,11 +45,15 @@ QJsonObject Card::toJson() const {
     json[QStringLiteral("cardId")] = m_cardId;
     json[QStringLiteral("name")] = m_name;
     json[QStringLiteral("studentId")] = m_studentId;
-    json[QStringLiteral("totalRecharge")] = m_totalRecharge;
-    json[QStringLiteral("balance")] = m_balance;
+    m_totalRecharge.writeJson(json, QStringLiteral("totalRecharge"));
+    m_balance.writeJson(json, QStringLiteral("balance"));
     json[QStringLiteral("state")] = static_cast<int>(m_state);
+    if (m_stateChangedAt.isValid()) {
+        json[QStringLiteral("stateChangedAt")] = m_stateChangedAt.toString(Qt::ISODate);
+    }
     json[QStringLiteral("loginAttempts")] = m_loginAttempts;
     json[QStringLiteral("password")] = m_password;
+    json[QStringLiteral("journalSeq")] = static_cast<qint64>(m_journalSequence);
     return json;
 }
 
@@ -13,6 +13,7 @@
 
 #include "model/Types.h"
 
+#include <QDateTime>
 #include <QJsonObject>
 #include <QString>
 
@@ -46,7 +47,7 @@ public:
      * @param balance 初始余额，默认为0
      */
     Card(const QString& cardId, const QString& name, const QString& studentId,
-         double balance = 0.0);
+         Money balance = Money());
 
     /**
      * @brief 拷贝构造函数
@@ -112,13 +113,13 @@ public:
      * @brief 获取累计充值金额
      * @return 充值总额
      */
-    [[nodiscard]] double totalRecharge() const { return m_totalRecharge; }
+    [[nodiscard]] Money totalRecharge() const { return m_totalRecharge; }
 
     /**
      * @brief 获取当前余额
      * @return 余额
      */
-    [[nodiscard]] double balance() const { return m_balance; }
+    [[nodiscard]] Money balance() const { return m_balance; }
 
     /**
      * @brief 获取卡状态
@@ -126,6 +127,12 @@ public:
      */
     [[nodiscard]] CardState state() const { return m_state; }
 
+    /**
+     * @brief 获取最近一次状态变更的时间
+     * @return 变更时间（无效表示未知）
+     */
+    [[nodiscard]] QDateTime stateChangedAt() const { return m_stateChangedAt; }
+
     /**
      * @brief 获取密码错误次数
      * @return 错误次数
@@ -138,6 +145,12 @@ public:
      */
     [[nodiscard]] QString password() const { return m_password; }
 
+    /**
+     * @brief 获取已写入余额的最后一条事务日志序号
+     * @return 日志序号（0表示尚无）
+     */
+    [[nodiscard]] quint64 journalSequence() const { return m_journalSequence; }
+
     // ========== Setters ==========
 
     /**
@@ -162,13 +175,13 @@ public:
      * @brief 设置累计充值金额
      * @param totalRecharge 充值总额
      */
-    void setTotalRecharge(double totalRecharge) { m_totalRecharge = totalRecharge; }
+    void setTotalRecharge(Money totalRecharge) { m_totalRecharge = totalRecharge; }
 
     /**
      * @brief 设置余额
      * @param balance 余额
      */
-    void setBalance(double balance) { m_balance = balance; }
+    void setBalance(Money balance) { m_balance = balance; }
 
     /**
      * @brief 设置密码
@@ -182,12 +195,24 @@ public:
      */
     void setState(CardState state) { m_state = state; }
 
+    /**
+     * @brief 设置最近一次状态变更的时间
+     * @param time 变更时间
+     */
+    void setStateChangedAt(const QDateTime& time) { m_stateChangedAt = time; }
+
     /**
      * @brief 设置登录失败次数
      * @param attempts 失败次数
      */
     void setLoginAttempts(int attempts) { m_loginAttempts = attempts; }
 
+    /**
+     * @brief 设置已写入余额的最后一条事务日志序号
+     * @param sequence 日志序号
+     */
+    void setJournalSequence(quint64 sequence) { m_journalSequence = sequence; }
+
     // ========== 状态检查方法 ==========
 
     /**
@@ -226,11 +251,13 @@ private:
     QString m_cardId;                       ///< 卡号（唯一标识）
     QString m_name;                         ///< 持卡人姓名
     QString m_studentId;                    ///< 学号
-    double m_totalRecharge = 0.0;           ///< 累计充值金额
-    double m_balance = 0.0;                 ///< 当前余额
+    Money m_totalRecharge;                  ///< 累计充值金额
+    Money m_balance;                        ///< 当前余额
     CardState m_state = CardState::Normal;  ///< 卡状态
+    QDateTime m_stateChangedAt;             ///< 最近一次状态变更时间（无效表示未知）
     int m_loginAttempts = 0;                ///< 密码错误次数
     QString m_password = DEFAULT_STUDENT_PASSWORD;  ///< 登录密码（默认123456）
+    quint64 m_journalSequence = 0;          ///< 最后一条已生效的事务日志序号（用于幂等恢复）
 };
 
 }  // namespace CampusCard
@@ -14,7 +14,7 @@ namespace CampusCard {
 
 Record Record::fromJson(const QJsonObject& json) {
     Record record;
-    record.m_recordId = json[QStringLiteral("recordId")].toString();
+    record.m_id = RecordId::fromString(json[QStringLiteral("recordId")].toString());
     record.m_cardId = json[QStringLiteral("cardId")].toString();
     record.m_date = json[QStringLiteral("date")].toString();
     record.m_startTime =
@@ -22,7 +22,7 @@ Record Record::fromJson(const QJsonObject& json) {
     record.m_endTime =
         QDateTime::fromString(json[QStringLiteral("endTime")].toString(), Qt::ISODate);
     record.m_durationMinutes = json[QStringLiteral("durationMinutes")].toInt();
-    record.m_cost = json[QStringLiteral("cost")].toDouble();
+    record.m_cost = Money::fromJson(json, QStringLiteral("cost"));
     record.m_state = static_cast<SessionState>(json[QStringLiteral("state")].toInt());
     record.m_location = json[QStringLiteral("location")].toString();
     return record;
@@ -30,13 +30,13 @@ Record Record::fromJson(const QJsonObject& json) {
 
 QJsonObject Record::toJson() const {
     QJsonObject json;
-    json[QStringLiteral("recordId")] = m_recordId;
+    json[QStringLiteral("recordId")] = m_id.toString();
     json[QStringLiteral("cardId")] = m_cardId;
     json[QStringLiteral("date")] = m_date;
     json[QStringLiteral("startTime")] = m_startTime.toString(Qt::ISODate);
     json[QStringLiteral("endTime")] = m_endTime.toString(Qt::ISODate);
     json[QStringLiteral("durationMinutes")] = m_durationMinutes;
-    json[QStringLiteral("cost")] = m_cost;
+    m_cost.writeJson(json, QStringLiteral("cost"));
     json[QStringLiteral("state")] = static_cast<int>(m_state);
     json[QStringLiteral("location")] = m_location;
     return json;
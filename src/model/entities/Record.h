@@ -12,6 +12,7 @@
 #define MODEL_ENTITIES_RECORD_H
 
 #include "model/Types.h"
+#include "model/entities/RecordId.h"
 
 #include <QDateTime>
 #include <QJsonObject>
@@ -81,10 +82,16 @@ public:
     // ========== Getters ==========
 
     /**
-     * @brief 获取记录唯一ID
+     * @brief 获取记录唯一ID的文本形式（用于显示和持久化）
+     * @return 记录ID文本
+     */
+    [[nodiscard]] QString recordId() const { return m_id.toString(); }
+
+    /**
+     * @brief 获取记录唯一ID（用于比较和排序，不产生文本）
      * @return 记录ID
      */
-    [[nodiscard]] QString recordId() const { return m_recordId; }
+    [[nodiscard]] const RecordId& id() const { return m_id; }
 
     /**
      * @brief 获取关联的卡号
@@ -120,7 +127,7 @@ public:
      * @brief 获取上机费用
      * @return 费用金额
      */
-    [[nodiscard]] double cost() const { return m_cost; }
+    [[nodiscard]] Money cost() const { return m_cost; }
 
     /**
      * @brief 获取上机状态
@@ -138,9 +145,15 @@ public:
 
     /**
      * @brief 设置记录ID
-     * @param recordId 记录ID
+     * @param recordId 记录ID文本（数字ID或旧格式UUID）
+     */
+    void setRecordId(const QString& recordId) { m_id = RecordId::fromString(recordId); }
+
+    /**
+     * @brief 设置记录ID
+     * @param id 记录ID
      */
-    void setRecordId(const QString& recordId) { m_recordId = recordId; }
+    void setId(const RecordId& id) { m_id = id; }
 
     /**
      * @brief 设置卡号
@@ -179,7 +192,7 @@ public:
      * @brief 设置费用
      * @param cost 费用
      */
-    void setCost(double cost) { m_cost = cost; }
+    void setCost(Money cost) { m_cost = cost; }
 
     /**
      * @brief 设置状态
@@ -211,16 +224,16 @@ public:
      * @brief 判断记录是否有效（有记录ID）
      * @return 是否有效
      */
-    [[nodiscard]] bool isValid() const { return !m_recordId.isEmpty(); }
+    [[nodiscard]] bool isValid() const { return !m_id.isNull(); }
 
 private:
-    QString m_recordId;                            ///< 记录唯一ID（UUID）
+    RecordId m_id;                                 ///< 记录唯一ID
     QString m_cardId;                              ///< 关联卡号
     QString m_date;                                ///< 上机日期（yyyy-MM-dd）
     QDateTime m_startTime;                         ///< 开始时间
     QDateTime m_endTime;                           ///< 结束时间
     int m_durationMinutes = 0;                     ///< 上机时长（分钟）
-    double m_cost = 0.0;                           ///< 上机费用
+    Money m_cost;                                  ///< 上机费用
     SessionState m_state = SessionState::Offline;  ///< 上机状态
     QString m_location;                            ///< 上机地点
 };
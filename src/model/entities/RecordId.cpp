@@ -0,0 +1,112 @@
+/**
+ * @file RecordId.cpp
+ * @brief 上机记录ID及其生成器实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层实体类实现
+ */
+
+#include "RecordId.h"
+
+
+namespace CampusCard {
+
+namespace {
+
+constexpr quint64 SEQUENCE_MASK = (quint64(1) << RecordId::SEQUENCE_BITS) - 1;
+constexpr quint64 NODE_MASK = (quint64(1) << RecordId::NODE_BITS) - 1;
+constexpr quint64 TIMESTAMP_MASK = (quint64(1) << RecordId::TIMESTAMP_BITS) - 1;
+constexpr int TIMESTAMP_SHIFT = RecordId::NODE_BITS + RecordId::SEQUENCE_BITS;
+
+}  // namespace
+
+// ========== RecordId ==========
+
+RecordId RecordId::compose(quint64 msecsSinceEpoch, int node, int sequence) {
+    return RecordId(((msecsSinceEpoch & TIMESTAMP_MASK) << TIMESTAMP_SHIFT) |
+                    ((quint64(node) & NODE_MASK) << SEQUENCE_BITS) |
+                    (quint64(sequence) & SEQUENCE_MASK));
+}
+
+RecordId RecordId::minimumAt(const QDateTime& time) {
+    qint64 msecs = time.toMSecsSinceEpoch() - EPOCH_MSECS;
+    return compose(static_cast<quint64>(qMax<qint64>(0, msecs)), 0, 0);
+}
+
+RecordId RecordId::fromString(const QString& text) {
+    RecordId id;
+    if (text.isEmpty()) {
+        return id;
+    }
+
+    bool ok = false;
+    quint64 value = text.toULongLong(&ok);
+    // 仅接受规范写法，保证toString()能还原原文
+    if (ok && value != 0 && QString::number(value) == text) {
+        id.m_value = value;
+    } else {
+        id.m_legacy = text;
+    }
+    return id;
+}
+
+QString RecordId::toString() const {
+    return m_value != 0 ? QString::number(m_value) : m_legacy;
+}
+
+QDateTime RecordId::timestamp() const {
+    if (m_value == 0) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(
+        static_cast<qint64>(m_value >> TIMESTAMP_SHIFT) + EPOCH_MSECS);
+}
+
+int RecordId::node() const {
+    return static_cast<int>((m_value >> SEQUENCE_BITS) & NODE_MASK);
+}
+
+int RecordId::sequence() const {
+    return static_cast<int>(m_value & SEQUENCE_MASK);
+}
+
+bool RecordId::operator<(const RecordId& other) const {
+    if (isNumeric() != other.isNumeric()) {
+        return !isNumeric();  // 旧格式ID排在前面
+    }
+    if (isNumeric()) {
+        return m_value < other.m_value;
+    }
+    return m_legacy < other.m_legacy;
+}
+
+// ========== RecordIdGenerator ==========
+
+RecordIdGenerator::RecordIdGenerator(int node) : m_node(static_cast<int>(node & NODE_MASK)) {}
+
+RecordIdGenerator& RecordIdGenerator::instance() {
+    static RecordIdGenerator instance;
+    return instance;
+}
+
+RecordId RecordIdGenerator::next() {
+    const qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - RecordId::EPOCH_MSECS;
+    const quint64 now = static_cast<quint64>(qMax<qint64>(1, elapsed));
+
+    quint64 last = m_state.load(std::memory_order_relaxed);
+    quint64 state = 0;
+    do {
+        if (now > (last >> RecordId::SEQUENCE_BITS)) {
+            state = now << RecordId::SEQUENCE_BITS;
+        } else {
+            // 同一毫秒或时钟回拨：在上一个值上递增，序列号溢出时进位到时间戳
+            state = last + 1;
+        }
+    } while (!m_state.compare_exchange_weak(last, state, std::memory_order_relaxed));
+
+    return RecordId::compose(state >> RecordId::SEQUENCE_BITS, m_node,
+                             static_cast<int>(state & SEQUENCE_MASK));
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,169 @@
+/**
+ * @file RecordId.h
+ * @brief 上机记录ID及其生成器
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层实体类
+ * 记录ID为按时间递增的64位整数（时间戳 + 节点号 + 序列号），
+ * 仅在界面显示和文件读写时转换为文本
+ */
+
+#ifndef MODEL_ENTITIES_RECORDID_H
+#define MODEL_ENTITIES_RECORDID_H
+
+#include <QDateTime>
+#include <QHashFunctions>
+#include <QString>
+
+#include <atomic>
+
+
+namespace CampusCard {
+
+/**
+ * @class RecordId
+ * @brief 上机记录ID
+ *
+ * 64位布局（最高位恒为0）：
+ * - 41位：自2024-01-01 00:00:00 UTC起的毫秒数
+ * - 10位：节点号
+ * - 12位：同一毫秒内的序列号
+ *
+ * 旧数据中的UUID等非数字ID原样保留为文本（legacy），
+ * 排序时位于所有数字ID之前，彼此按文本比较。
+ */
+class RecordId {
+public:
+    static constexpr int SEQUENCE_BITS = 12;  ///< 序列号位数
+    static constexpr int NODE_BITS = 10;      ///< 节点号位数
+    static constexpr int TIMESTAMP_BITS = 41; ///< 时间戳位数
+    static constexpr qint64 EPOCH_MSECS = 1704067200000LL;  ///< 2024-01-01 00:00:00 UTC
+
+    /**
+     * @brief 构造空ID
+     */
+    RecordId() = default;
+
+    /**
+     * @brief 由64位整数构造
+     * @param value 整数值（0表示空ID）
+     */
+    explicit RecordId(quint64 value) : m_value(value) {}
+
+    /**
+     * @brief 由各字段组合
+     * @param msecsSinceEpoch 自EPOCH_MSECS起的毫秒数
+     * @param node 节点号
+     * @param sequence 序列号
+     * @return 记录ID
+     */
+    [[nodiscard]] static RecordId compose(quint64 msecsSinceEpoch, int node, int sequence);
+
+    /**
+     * @brief 某一时刻可能出现的最小ID（用于按时间做ID范围查找）
+     * @param time 时间
+     * @return 记录ID
+     */
+    [[nodiscard]] static RecordId minimumAt(const QDateTime& time);
+
+    /**
+     * @brief 从文本解析
+     *
+     * 规范的十进制数字（无前导零）解析为数字ID，其余非空文本保留为旧格式ID
+     * @param text 文本
+     * @return 记录ID（空文本返回空ID）
+     */
+    [[nodiscard]] static RecordId fromString(const QString& text);
+
+    /**
+     * @brief 转换为文本（数字ID为十进制）
+     */
+    [[nodiscard]] QString toString() const;
+
+    /**
+     * @brief 是否为空ID
+     */
+    [[nodiscard]] bool isNull() const { return m_value == 0 && m_legacy.isEmpty(); }
+
+    /**
+     * @brief 是否为数字ID
+     */
+    [[nodiscard]] bool isNumeric() const { return m_value != 0; }
+
+    /**
+     * @brief 整数值（旧格式ID为0）
+     */
+    [[nodiscard]] quint64 value() const { return m_value; }
+
+    /**
+     * @brief 生成时间（旧格式ID返回无效时间）
+     */
+    [[nodiscard]] QDateTime timestamp() const;
+
+    /**
+     * @brief 节点号
+     */
+    [[nodiscard]] int node() const;
+
+    /**
+     * @brief 序列号
+     */
+    [[nodiscard]] int sequence() const;
+
+    bool operator==(const RecordId& other) const {
+        return m_value == other.m_value && m_legacy == other.m_legacy;
+    }
+    bool operator!=(const RecordId& other) const { return !(*this == other); }
+    bool operator<(const RecordId& other) const;
+
+    friend size_t qHash(const RecordId& id, size_t seed = 0) {
+        return id.m_value != 0 ? qHash(id.m_value, seed) : qHash(id.m_legacy, seed);
+    }
+
+private:
+    quint64 m_value = 0;  ///< 数字ID
+    QString m_legacy;     ///< 旧格式ID文本（仅m_value为0时使用）
+};
+
+/**
+ * @class RecordIdGenerator
+ * @brief 无锁的按时间递增记录ID生成器
+ *
+ * 以一个原子64位状态（时间戳 << 12 | 序列号）做比较交换：
+ * 时钟前进时序列号归零，同一毫秒内或时钟回拨时在上一个值基础上加1，
+ * 序列号用尽时自然进位到下一毫秒。因此同一生成器产生的ID严格递增，
+ * 多线程并发调用无需加锁。
+ */
+class RecordIdGenerator {
+public:
+    /**
+     * @brief 构造函数
+     * @param node 节点号（多个进程同时写入时用于区分，取低10位）
+     */
+    explicit RecordIdGenerator(int node = 0);
+
+    /**
+     * @brief 获取进程内共享的生成器（节点号0）
+     */
+    static RecordIdGenerator& instance();
+
+    /**
+     * @brief 生成下一个ID
+     * @return 记录ID
+     */
+    [[nodiscard]] RecordId next();
+
+    /**
+     * @brief 节点号
+     */
+    [[nodiscard]] int node() const { return m_node; }
+
+private:
+    int m_node = 0;                   ///< 节点号
+    std::atomic<quint64> m_state{0};  ///< 最近一次的（时间戳 << 12 | 序列号）
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_ENTITIES_RECORDID_H
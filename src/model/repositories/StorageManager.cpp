@@ -9,6 +9,8 @@
 
 #include "StorageManager.h"
 
+#include "model/services/DataSnapshot.h"
+
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QDir>
@@ -17,8 +19,14 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QRandomGenerator>
+#include <QSaveFile>
 #include <QStandardPaths>
-#include <QUuid>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 
 namespace CampusCard {
@@ -49,6 +57,10 @@ bool StorageManager::initializeDataDirectory() {
     if (!ensureDirectory(m_dataPath + QStringLiteral("/records"))) {
         return false;
     }
+    // 确保汇总子目录存在
+    if (!ensureDirectory(m_dataPath + QStringLiteral("/rollups"))) {
+        return false;
+    }
 
     // 检查是否需要创建示例数据
     QString cardsFile = m_dataPath + QStringLiteral("/cards.txt");
@@ -86,13 +98,14 @@ void StorageManager::createSampleData() {
     // 创建示例上机记录
     // 根据文档要求，记录文件以学号命名（如 B17010101.txt）
     Record record1;
-    record1.setRecordId(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    record1.setId(RecordIdGenerator::instance().next());
     record1.setCardId(QStringLiteral("C001"));
     record1.setLocation(QStringLiteral("机房A101"));
-    record1.setStartTime(QDateTime::currentDateTime().addSecs(-3600));  // 1小时前开始
-    record1.setEndTime(QDateTime::currentDateTime());
+    const QDateTime now = m_clock->now();
+    record1.setStartTime(now.addSecs(-3600));  // 1小时前开始
+    record1.setEndTime(now);
     record1.setDurationMinutes(60);
-    record1.setCost(1.0);
+    record1.setCost(COST_PER_HOUR);
     record1.setState(SessionState::Offline);
     appendRecord(QStringLiteral("B17010101"), record1);  // 使用学号作为文件名
 }
@@ -133,16 +146,15 @@ bool StorageManager::saveAllCards(const QList<Card>& cards) {
         array.append(card.toJson());
     }
 
-    QFile file(filePath);
+    // 先写临时文件再原子替换，崩溃时不会留下写了一半的卡数据
+    QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
 
     QJsonDocument doc(array);
     file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-
-    return true;
+    return file.commit();
 }
 
 Card StorageManager::loadCard(const QString& cardId) {
@@ -192,16 +204,14 @@ bool StorageManager::saveRecords(const QString& studentId, const QList<Record>&
         array.append(record.toJson());
     }
 
-    QFile file(filePath);
+    QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
 
     QJsonDocument doc(array);
     file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-
-    return true;
+    return file.commit();
 }
 
 bool StorageManager::appendRecord(const QString& studentId, const Record& record) {
@@ -214,7 +224,7 @@ bool StorageManager::updateRecord(const QString& studentId, const Record& record
     QList<Record> records = loadRecords(studentId);
 
     for (int i = 0; i < records.size(); ++i) {
-        if (records[i].recordId() == record.recordId()) {
+        if (records[i].id() == record.id()) {
             records[i] = record;
             return saveRecords(studentId, records);
         }
@@ -239,6 +249,55 @@ QMap<QString, QList<Record>> StorageManager::loadAllRecords() {
     return allRecords;
 }
 
+// ========== 每日汇总数据 ==========
+
+bool StorageManager::saveRollup(const QString& date, const QJsonObject& rollup) {
+    QString rollupsDir = m_dataPath + QStringLiteral("/rollups");
+    if (!ensureDirectory(rollupsDir)) {
+        return false;
+    }
+
+    QFile file(rollupsDir + QStringLiteral("/") + date + QStringLiteral(".txt"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QJsonDocument doc(rollup);
+    file.write(doc.toJson(QJsonDocument::Indented));
+    file.close();
+
+    return true;
+}
+
+QMap<QString, QJsonObject> StorageManager::loadAllRollups() {
+    QMap<QString, QJsonObject> rollups;
+
+    QDir dir(m_dataPath + QStringLiteral("/rollups"));
+    QStringList files = dir.entryList(QStringList() << QStringLiteral("*.txt"), QDir::Files);
+    for (const auto& fileName : files) {
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        file.close();
+
+        if (doc.isObject()) {
+            rollups[fileName.left(fileName.length() - 4)] = doc.object();  // 去掉 .txt 后缀
+        }
+    }
+
+    return rollups;
+}
+
+bool StorageManager::clearRollups() {
+    QDir dir(m_dataPath + QStringLiteral("/rollups"));
+    if (!dir.exists()) {
+        return true;
+    }
+    return dir.removeRecursively();
+}
+
 // ========== 管理员数据 ==========
 
 QString StorageManager::loadAdminPassword() {
@@ -277,6 +336,128 @@ bool StorageManager::saveAdminPassword(const QString& password) {
     return true;
 }
 
+// ========== 事务日志 ==========
+
+bool StorageManager::appendJournal(const QJsonObject& entry) {
+    QFile file(m_dataPath + QStringLiteral("/journal.txt"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    QByteArray line = QJsonDocument(entry).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    if (file.write(line) != line.size() || !file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+QList<QJsonObject> StorageManager::loadJournal() {
+    QList<QJsonObject> entries;
+
+    QFile file(m_dataPath + QStringLiteral("/journal.txt"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entries;
+    }
+
+    while (!file.atEnd()) {
+        QJsonDocument doc = QJsonDocument::fromJson(file.readLine());
+        if (doc.isObject()) {
+            entries.append(doc.object());
+        }
+    }
+    file.close();
+
+    return entries;
+}
+
+bool StorageManager::clearJournal() {
+    QString filePath = m_dataPath + QStringLiteral("/journal.txt");
+    return !QFile::exists(filePath) || QFile::remove(filePath);
+}
+
+// ========== 余额流水 ==========
+
+bool StorageManager::appendLedger(const QList<QJsonObject>& entries) {
+    if (entries.isEmpty()) {
+        return true;
+    }
+
+    QFile file(m_dataPath + QStringLiteral("/ledger.txt"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    QByteArray lines;
+    for (const auto& entry : entries) {
+        lines.append(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+        lines.append('\n');
+    }
+    if (file.write(lines) != lines.size() || !file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+QList<QJsonObject> StorageManager::loadLedger() {
+    QList<QJsonObject> entries;
+
+    QFile file(m_dataPath + QStringLiteral("/ledger.txt"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entries;
+    }
+
+    while (!file.atEnd()) {
+        QJsonDocument doc = QJsonDocument::fromJson(file.readLine());
+        if (doc.isObject()) {
+            entries.append(doc.object());
+        }
+    }
+    file.close();
+
+    return entries;
+}
+
+bool StorageManager::clearLedger() {
+    QString filePath = m_dataPath + QStringLiteral("/ledger.txt");
+    return !QFile::exists(filePath) || QFile::remove(filePath);
+}
+
+// ========== 计费规则 ==========
+
+QJsonObject StorageManager::loadTariff() {
+    QFile file(m_dataPath + QStringLiteral("/tariff.txt"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    return doc.isObject() ? doc.object() : QJsonObject();
+}
+
+bool StorageManager::saveTariff(const QJsonObject& tariff) {
+    QFile file(m_dataPath + QStringLiteral("/tariff.txt"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QJsonDocument doc(tariff);
+    file.write(doc.toJson(QJsonDocument::Indented));
+    file.close();
+
+    return true;
+}
+
 // ========== 模拟数据生成 ==========
 
 void StorageManager::generateMockData(int cardCount, int recordsPerCard) {
@@ -325,7 +506,7 @@ void StorageManager::generateMockData(int cardCount, int recordsPerCard) {
                                 .arg(QRandomGenerator::global()->bounded(10000, 99999));
 
         // 生成初始余额
-        double balance = QRandomGenerator::global()->bounded(50, 500);
+        Money balance = Money::fromCents(QRandomGenerator::global()->bounded(50, 500) * 100);
 
         // 创建卡
         Card card(cardId, fullName, studentId, balance);
@@ -334,7 +515,7 @@ void StorageManager::generateMockData(int cardCount, int recordsPerCard) {
 
         // 生成上机记录
         QList<Record> records;
-        QDateTime baseTime = QDateTime::currentDateTime().addDays(-30);
+        QDateTime baseTime = m_clock->now().addDays(-30);
 
         for (int j = 0; j < recordsPerCard; ++j) {
             // 随机日期（过去30天内）
@@ -350,13 +531,13 @@ void StorageManager::generateMockData(int cardCount, int recordsPerCard) {
 
             // 创建记录
             Record record;
-            record.setRecordId(QUuid::createUuid().toString(QUuid::WithoutBraces));
+            record.setId(RecordIdGenerator::instance().next());
             record.setCardId(cardId);
             record.setLocation(location);
             record.setStartTime(startTime);
             record.setEndTime(endTime);
             record.setDurationMinutes(duration);
-            record.setCost(duration * COST_PER_HOUR / 60.0);
+            record.setCost(COST_PER_HOUR.scaled(duration, 60));
             record.setState(SessionState::Offline);
 
             records.append(record);
@@ -375,10 +556,23 @@ void StorageManager::generateMockData(int cardCount, int recordsPerCard) {
 // ========== 导入导出 ==========
 
 bool StorageManager::exportAllData(const QString& filePath) {
+    return writeExport(filePath, loadAllCards(), loadTariff(), loadAllRecords());
+}
+
+bool StorageManager::exportAllData(const QString& filePath, const DataSnapshot& snapshot) {
+    if (!snapshot.isValid()) {
+        return false;
+    }
+    return writeExport(filePath, snapshot.cards(), snapshot.tariff().toJson(),
+                       snapshot.recordsByStudentId());
+}
+
+bool StorageManager::writeExport(const QString& filePath, const QList<Card>& cards,
+                                 const QJsonObject& tariff,
+                                 const QMap<QString, QList<Record>>& records) {
     QJsonObject root;
 
     // 导出卡数据
-    QList<Card> cards = loadAllCards();
     QJsonArray cardsArray;
     for (const auto& card : cards) {
         cardsArray.append(card.toJson());
@@ -388,10 +582,12 @@ bool StorageManager::exportAllData(const QString& filePath) {
     // 导出管理员密码
     root[QStringLiteral("adminPassword")] = loadAdminPassword();
 
+    // 导出计费规则
+    root[QStringLiteral("tariff")] = tariff;
+
     // 导出所有记录
     QJsonObject recordsObj;
-    QMap<QString, QList<Record>> allRecords = loadAllRecords();
-    for (auto it = allRecords.constBegin(); it != allRecords.constEnd(); ++it) {
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
         QJsonArray recordsArray;
         for (const auto& record : it.value()) {
             recordsArray.append(record.toJson());
@@ -401,7 +597,7 @@ bool StorageManager::exportAllData(const QString& filePath) {
     root[QStringLiteral("records")] = recordsObj;
 
     // 添加导出信息
-    root[QStringLiteral("exportTime")] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root[QStringLiteral("exportTime")] = m_clock->now().toString(Qt::ISODate);
     root[QStringLiteral("version")] = QStringLiteral("1.0");
 
     // 写入文件
@@ -459,8 +655,9 @@ bool StorageManager::importData(const QString& filePath, bool merge) {
             }
             saveAllCards(existingCards);
         } else {
-            // 覆盖模式
+            // 覆盖模式：旧卡的流水不再有效
             saveAllCards(importedCards);
+            clearLedger();
         }
     }
 
@@ -469,8 +666,17 @@ bool StorageManager::importData(const QString& filePath, bool merge) {
         saveAdminPassword(root[QStringLiteral("adminPassword")].toString());
     }
 
+    // 导入计费规则（仅覆盖模式）
+    if (!merge && root[QStringLiteral("tariff")].isObject()) {
+        saveTariff(root[QStringLiteral("tariff")].toObject());
+    }
+
     // 导入记录（记录文件以学号命名，符合文档要求）
     if (root.contains(QStringLiteral("records"))) {
+        if (!merge) {
+            // 覆盖模式下旧记录的汇总不再有效，由下次初始化按记录重建
+            clearRollups();
+        }
         QJsonObject recordsObj = root[QStringLiteral("records")].toObject();
         for (auto it = recordsObj.begin(); it != recordsObj.end(); ++it) {
             QString studentId = it.key();  // key 为学号
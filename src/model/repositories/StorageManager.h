@@ -11,9 +11,11 @@
 #ifndef MODEL_REPOSITORIES_STORAGEMANAGER_H
 #define MODEL_REPOSITORIES_STORAGEMANAGER_H
 
+#include "model/Clock.h"
 #include "model/entities/Card.h"
 #include "model/entities/Record.h"
 
+#include <QJsonObject>
 #include <QList>
 #include <QMap>
 #include <QString>
@@ -23,6 +25,8 @@
 
 namespace CampusCard {
 
+class DataSnapshot;
+
 /**
  * @class StorageManager
  * @brief 单例存储管理器，负责所有数据的文件读写
@@ -30,7 +34,11 @@ namespace CampusCard {
  * 数据存储结构：
  * - data/cards.txt: 所有校园卡信息
  * - data/admin.txt: 管理员密码
+ * - data/tariff.txt: 计费规则
+ * - data/journal.txt: 事务日志（每行一条JSON，检查点后清空）
+ * - data/ledger.txt: 余额流水（每行一条JSON，只追加）
  * - data/records/<studentId>.txt: 每个学生的上机记录
+ * - data/rollups/<yyyy-MM-dd>.txt: 每日统计汇总（如去重人数草图）
  *
  * 作为Repository层，只负责：
  * - 数据的持久化存储
@@ -67,6 +75,18 @@ public:
      */
     [[nodiscard]] QString dataPath() const { return m_dataPath; }
 
+    /**
+     * @brief 设置时钟（示例数据、模拟数据和导出时间取自该时钟）
+     * @param clock 时钟（为空时使用系统时钟；调用方保证其生命周期）
+     */
+    void setClock(Clock* clock) { m_clock = clock ? clock : Clock::system(); }
+
+    /**
+     * @brief 获取时钟
+     * @return 时钟
+     */
+    [[nodiscard]] Clock* clock() const { return m_clock; }
+
     // ========== 初始化 ==========
 
     /**
@@ -147,6 +167,28 @@ public:
      */
     QMap<QString, QList<Record>> loadAllRecords();
 
+    // ========== 每日汇总数据 ==========
+
+    /**
+     * @brief 保存某日的统计汇总
+     * @param date 日期字符串（yyyy-MM-dd）
+     * @param rollup 汇总内容（由业务层定义各字段）
+     * @return 是否成功
+     */
+    bool saveRollup(const QString& date, const QJsonObject& rollup);
+
+    /**
+     * @brief 加载所有日期的统计汇总
+     * @return 日期到汇总内容的映射（损坏的文件被跳过）
+     */
+    QMap<QString, QJsonObject> loadAllRollups();
+
+    /**
+     * @brief 删除所有统计汇总（汇总可由记录重建）
+     * @return 是否成功
+     */
+    bool clearRollups();
+
     // ========== 管理员数据 ==========
 
     /**
@@ -162,6 +204,65 @@ public:
      */
     bool saveAdminPassword(const QString& password);
 
+    // ========== 事务日志 ==========
+
+    /**
+     * @brief 追加一条事务日志并同步到磁盘
+     *
+     * 日志以单行JSON追加写入，返回前调用fsync，返回true即表示该事务已持久化
+     * @param entry 日志内容（由业务层定义各字段）
+     * @return 是否成功
+     */
+    bool appendJournal(const QJsonObject& entry);
+
+    /**
+     * @brief 按写入顺序加载全部事务日志
+     * @return 日志列表（崩溃时写了一半的末行被跳过）
+     */
+    QList<QJsonObject> loadJournal();
+
+    /**
+     * @brief 清空事务日志（检查点完成后调用）
+     * @return 是否成功
+     */
+    bool clearJournal();
+
+    // ========== 余额流水 ==========
+
+    /**
+     * @brief 追加一批余额流水并同步到磁盘（一次fsync）
+     * @param entries 流水（由业务层定义各字段）
+     * @return 是否成功
+     */
+    bool appendLedger(const QList<QJsonObject>& entries);
+
+    /**
+     * @brief 按写入顺序加载全部余额流水
+     * @return 流水列表（崩溃时写了一半的末行被跳过）
+     */
+    QList<QJsonObject> loadLedger();
+
+    /**
+     * @brief 删除余额流水（覆盖导入卡数据后调用，流水由下次初始化按卡余额重新开户）
+     * @return 是否成功
+     */
+    bool clearLedger();
+
+    // ========== 计费规则 ==========
+
+    /**
+     * @brief 加载计费规则
+     * @return 规则JSON（文件不存在或损坏时为空对象，表示使用默认费率）
+     */
+    QJsonObject loadTariff();
+
+    /**
+     * @brief 保存计费规则
+     * @param tariff 规则JSON（由业务层定义各字段）
+     * @return 是否成功
+     */
+    bool saveTariff(const QJsonObject& tariff);
+
     // ========== 模拟数据生成 ==========
 
     /**
@@ -180,6 +281,17 @@ public:
      */
     bool exportAllData(const QString& filePath);
 
+    /**
+     * @brief 将一致性快照导出到JSON文件（格式与exportAllData(filePath)相同）
+     *
+     * 卡、记录和计费规则取自快照而不是数据文件，导出期间不阻塞上下机，
+     * 也无需先执行检查点；管理员密码仍从数据文件读取
+     * @param filePath 导出文件路径
+     * @param snapshot 快照
+     * @return 是否成功（快照无效时返回false）
+     */
+    bool exportAllData(const QString& filePath, const DataSnapshot& snapshot);
+
     /**
      * @brief 从JSON文件导入数据
      * @param filePath 导入文件路径
@@ -201,7 +313,19 @@ private:
      */
     bool ensureDirectory(const QString& dirPath);
 
-    QString m_dataPath;  ///< 数据目录路径
+    /**
+     * @brief 写出导出文件
+     * @param filePath 导出文件路径
+     * @param cards 卡列表
+     * @param tariff 计费规则JSON
+     * @param records 学号到记录列表的映射
+     * @return 是否成功
+     */
+    bool writeExport(const QString& filePath, const QList<Card>& cards, const QJsonObject& tariff,
+                     const QMap<QString, QList<Record>>& records);
+
+    QString m_dataPath;                ///< 数据目录路径
+    Clock* m_clock = Clock::system();  ///< 时钟
 };
 
 }  // namespace CampusCard
@@ -0,0 +1,258 @@
+/**
+ * @file BalanceLedger.cpp
+ * @brief 只追加的余额流水账实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "BalanceLedger.h"
+
+#include <QMap>
+#include <QReadLocker>
+#include <QThreadPool>
+#include <QWriteLocker>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <utility>
+
+
+namespace CampusCard {
+
+// ========== LedgerEntry ==========
+
+QJsonObject LedgerEntry::toJson() const {
+    QJsonObject json;
+    json[QStringLiteral("seq")] = static_cast<qint64>(sequence);
+    json[QStringLiteral("cardId")] = cardId;
+    json[QStringLiteral("type")] = static_cast<int>(type);
+    amount.writeJson(json, QStringLiteral("amount"));
+    balance.writeJson(json, QStringLiteral("balance"));
+    json[QStringLiteral("time")] = time.toString(Qt::ISODate);
+    if (journalSequence > 0) {
+        json[QStringLiteral("journalSeq")] = static_cast<qint64>(journalSequence);
+    }
+    return json;
+}
+
+LedgerEntry LedgerEntry::fromJson(const QJsonObject& json) {
+    LedgerEntry entry;
+    entry.sequence = static_cast<quint64>(json[QStringLiteral("seq")].toInteger());
+    entry.cardId = json[QStringLiteral("cardId")].toString();
+    entry.type = static_cast<LedgerEntryType>(json[QStringLiteral("type")].toInt());
+    entry.amount = Money::fromJson(json, QStringLiteral("amount"));
+    entry.balance = Money::fromJson(json, QStringLiteral("balance"));
+    entry.time = QDateTime::fromString(json[QStringLiteral("time")].toString(), Qt::ISODate);
+    entry.journalSequence = static_cast<quint64>(json[QStringLiteral("journalSeq")].toInteger());
+    return entry;
+}
+
+// ========== 记账 ==========
+
+void BalanceLedger::setClock(Clock* clock) {
+    QWriteLocker locker(&m_lock);
+    m_clock = clock ? clock : Clock::system();
+}
+
+void BalanceLedger::load(const QList<LedgerEntry>& entries) {
+    QList<LedgerEntry> sorted = entries;
+    std::sort(sorted.begin(), sorted.end(), [](const LedgerEntry& a, const LedgerEntry& b) {
+        return a.sequence < b.sequence;
+    });
+
+    QWriteLocker locker(&m_lock);
+    m_accounts.clear();
+    m_journalSequences.clear();
+    m_pending.clear();
+    m_nextSequence = 1;
+    m_entryCount = sorted.size();
+    for (const auto& entry : sorted) {
+        m_accounts[entry.cardId].append(entry);
+        if (entry.journalSequence > 0) {
+            quint64& last = m_journalSequences[entry.cardId];
+            last = qMax(last, entry.journalSequence);
+        }
+        m_nextSequence = qMax(m_nextSequence, entry.sequence + 1);
+    }
+}
+
+bool BalanceLedger::append(const QString& cardId, LedgerEntryType type, Money amount,
+                           quint64 journalSequence) {
+    QWriteLocker locker(&m_lock);
+    if (journalSequence > 0) {
+        quint64& last = m_journalSequences[cardId];
+        if (journalSequence <= last) {
+            return false;
+        }
+        last = journalSequence;
+    }
+
+    QList<LedgerEntry>& entries = m_accounts[cardId];
+    LedgerEntry entry;
+    entry.sequence = m_nextSequence++;
+    entry.cardId = cardId;
+    entry.type = type;
+    entry.amount = amount;
+    entry.balance = (entries.isEmpty() ? Money() : entries.last().balance) + amount;
+    entry.time = m_clock->now();
+    entry.journalSequence = journalSequence;
+
+    entries.append(entry);
+    m_pending.append(entry);
+    ++m_entryCount;
+    return true;
+}
+
+QList<LedgerEntry> BalanceLedger::takePending() {
+    QWriteLocker locker(&m_lock);
+    return std::exchange(m_pending, QList<LedgerEntry>());
+}
+
+void BalanceLedger::restorePending(const QList<LedgerEntry>& entries) {
+    QWriteLocker locker(&m_lock);
+    m_pending = entries + m_pending;
+}
+
+// ========== 查询 ==========
+
+bool BalanceLedger::contains(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    return m_accounts.contains(cardId);
+}
+
+Money BalanceLedger::balance(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    auto it = m_accounts.constFind(cardId);
+    return it == m_accounts.constEnd() ? Money() : it.value().last().balance;
+}
+
+QList<LedgerEntry> BalanceLedger::statement(const QString& cardId, const QDate& from,
+                                            const QDate& to) const {
+    QList<LedgerEntry> entries;
+    {
+        // 隐式共享，加锁期间只复制引用
+        QReadLocker locker(&m_lock);
+        entries = m_accounts.value(cardId);
+    }
+    if (!from.isValid() && !to.isValid()) {
+        return entries;
+    }
+
+    QList<LedgerEntry> result;
+    for (const auto& entry : entries) {
+        const QDate date = entry.time.date();
+        if ((from.isValid() && date < from) || (to.isValid() && date > to)) {
+            continue;
+        }
+        result.append(entry);
+    }
+    return result;
+}
+
+qint64 BalanceLedger::entryCount() const {
+    QReadLocker locker(&m_lock);
+    return m_entryCount;
+}
+
+QHash<QString, QList<LedgerEntry>> BalanceLedger::accounts() const {
+    QReadLocker locker(&m_lock);
+    return m_accounts;
+}
+
+// ========== 对账 ==========
+
+QList<BalanceLedger::Chunk> BalanceLedger::partition(
+    const QList<Card>& cards, const QHash<QString, QList<LedgerEntry>>& accounts) {
+    // 卡与流水按卡号合并，没有卡的流水也参与核对
+    QMap<QString, Account> merged;
+    for (const auto& card : cards) {
+        Account& account = merged[card.cardId()];
+        account.cardId = card.cardId();
+        account.cardExists = true;
+        account.materialized = card.balance();
+    }
+    for (auto it = accounts.constBegin(); it != accounts.constEnd(); ++it) {
+        Account& account = merged[it.key()];
+        account.cardId = it.key();
+        account.entries = it.value();
+    }
+
+    QList<Chunk> chunks;
+    Chunk current;
+    for (const auto& account : std::as_const(merged)) {
+        current.append(account);
+        if (current.size() == CARDS_PER_CHUNK) {
+            chunks.append(current);
+            current.clear();
+        }
+    }
+    if (!current.isEmpty()) {
+        chunks.append(current);
+    }
+    return chunks;
+}
+
+ReconciliationReport BalanceLedger::reconcileChunk(const Chunk& chunk) {
+    ReconciliationReport report;
+    for (const auto& account : chunk) {
+        // 逐条累加金额，同时核对每条流水记录的余额
+        Money total;
+        quint64 broken = 0;
+        for (const auto& entry : account.entries) {
+            total += entry.amount;
+            if (broken == 0 && entry.balance != total) {
+                broken = entry.sequence;
+            }
+        }
+        if (account.cardExists) {
+            ++report.cardsChecked;
+        }
+        report.entriesChecked += account.entries.size();
+
+        if (!account.cardExists || total != account.materialized || broken != 0) {
+            LedgerMismatch mismatch;
+            mismatch.cardId = account.cardId;
+            mismatch.cardExists = account.cardExists;
+            mismatch.materialized = account.materialized;
+            mismatch.ledger = total;
+            mismatch.brokenSequence = broken;
+            report.mismatches.append(mismatch);
+        }
+    }
+    return report;
+}
+
+void BalanceLedger::merge(ReconciliationReport& total, const ReconciliationReport& part) {
+    // 分块按卡号顺序合并，差异列表保持按卡号排序
+    total.cardsChecked += part.cardsChecked;
+    total.entriesChecked += part.entriesChecked;
+    total.mismatches.append(part.mismatches);
+}
+
+ReconciliationReport BalanceLedger::reconcile(
+    const QList<Card>& cards, const QHash<QString, QList<LedgerEntry>>& accounts) {
+    ReconciliationReport total;
+    for (const auto& chunk : partition(cards, accounts)) {
+        merge(total, reconcileChunk(chunk));
+    }
+    return total;
+}
+
+QFuture<ReconciliationReport> BalanceLedger::reconcileAsync(
+    const QList<Card>& cards, const QHash<QString, QList<LedgerEntry>>& accounts,
+    QThreadPool* pool) {
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+
+    // 分块在调用线程完成，工作线程只读取隐式共享的流水列表
+    QList<Chunk> chunks = partition(cards, accounts);
+
+    return QtConcurrent::mappedReduced<ReconciliationReport>(
+        pool, std::move(chunks), &BalanceLedger::reconcileChunk, &BalanceLedger::merge,
+        QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce);
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,246 @@
+/**
+ * @file BalanceLedger.h
+ * @brief 只追加的余额流水账
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 记录每一笔资金变动（开户、充值、消费、调整），按卡索引以支持快速对账单查询；
+ * 卡上的余额是流水的物化结果，可并行核对二者是否一致
+ */
+
+#ifndef MODEL_SERVICES_BALANCELEDGER_H
+#define MODEL_SERVICES_BALANCELEDGER_H
+
+#include "model/Clock.h"
+#include "model/Money.h"
+#include "model/entities/Card.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+
+class QThreadPool;
+
+namespace CampusCard {
+
+/**
+ * @enum LedgerEntryType
+ * @brief 流水类型
+ */
+enum class LedgerEntryType {
+    Opening = 0,  ///< 开户余额（含启用流水前已有的余额）
+    Recharge,     ///< 充值
+    Charge,       ///< 消费扣款（上机费用等）
+    Adjustment    ///< 管理员调整
+};
+
+/**
+ * @struct LedgerEntry
+ * @brief 一笔资金变动
+ */
+struct LedgerEntry {
+    quint64 sequence = 0;                                ///< 流水序号（全局递增）
+    QString cardId;                                      ///< 卡号
+    LedgerEntryType type = LedgerEntryType::Adjustment;  ///< 流水类型
+    Money amount;                                        ///< 变动金额（入账为正，出账为负）
+    Money balance;                                       ///< 变动后的流水余额
+    QDateTime time;                                      ///< 记账时间
+    quint64 journalSequence = 0;                         ///< 事务日志序号（0表示不经日志）
+
+    /**
+     * @brief 转换为JSON
+     */
+    [[nodiscard]] QJsonObject toJson() const;
+
+    /**
+     * @brief 从JSON读取
+     */
+    [[nodiscard]] static LedgerEntry fromJson(const QJsonObject& json);
+};
+
+/**
+ * @struct LedgerMismatch
+ * @brief 一张卡的对账差异
+ */
+struct LedgerMismatch {
+    QString cardId;              ///< 卡号
+    bool cardExists = true;      ///< 卡是否存在（流水指向不存在的卡时为false）
+    Money materialized;          ///< 卡上的余额
+    Money ledger;                ///< 流水金额合计
+    quint64 brokenSequence = 0;  ///< 第一条余额与累计不符的流水序号（0表示流水连续）
+};
+
+/**
+ * @struct ReconciliationReport
+ * @brief 对账报告
+ */
+struct ReconciliationReport {
+    int cardsChecked = 0;              ///< 核对的卡数
+    qint64 entriesChecked = 0;         ///< 核对的流水条数
+    QList<LedgerMismatch> mismatches;  ///< 差异（按卡号排序）
+
+    /**
+     * @brief 是否全部一致
+     */
+    [[nodiscard]] bool isClean() const { return mismatches.isEmpty(); }
+};
+
+/**
+ * @class BalanceLedger
+ * @brief 余额流水账
+ *
+ * 流水按卡号分组保存，每组按序号递增；每条流水记录变动后的流水余额，
+ * 因此对账单无需从头累加，篡改或丢失的行也能通过余额链断裂发现。
+ * 新流水先进入待持久化队列，由调用方在写卡文件前取出并追加写入。
+ *
+ * 经事务日志提交的消费带有日志序号；同一张卡上不大于已记录序号的消费不再记账，
+ * 因此事务日志重放不会重复记账。
+ *
+ * 所有方法都可被多线程同时调用。
+ */
+class BalanceLedger {
+public:
+    /// 对账时每个分块包含的卡数
+    static constexpr int CARDS_PER_CHUNK = 64;
+
+    /**
+     * @brief 设置时钟（流水的记账时间取自该时钟）
+     * @param clock 时钟（为空时使用系统时钟；调用方保证其生命周期）
+     */
+    void setClock(Clock* clock);
+
+    /**
+     * @brief 用已持久化的流水替换全部内容，并清空待持久化队列
+     * @param entries 流水（任意顺序）
+     */
+    void load(const QList<LedgerEntry>& entries);
+
+    /**
+     * @brief 记一笔流水
+     * @param cardId 卡号
+     * @param type 流水类型
+     * @param amount 变动金额（入账为正，出账为负）
+     * @param journalSequence 事务日志序号（0表示不经事务日志）
+     * @return 是否记账（该卡已记录不小于journalSequence的日志序号时返回false）
+     */
+    bool append(const QString& cardId, LedgerEntryType type, Money amount,
+                quint64 journalSequence = 0);
+
+    /**
+     * @brief 取出待持久化的流水
+     * @return 流水（按序号递增）
+     */
+    [[nodiscard]] QList<LedgerEntry> takePending();
+
+    /**
+     * @brief 将写入失败的流水放回待持久化队列
+     * @param entries takePending()返回的流水
+     */
+    void restorePending(const QList<LedgerEntry>& entries);
+
+    /**
+     * @brief 卡是否有流水
+     * @param cardId 卡号
+     */
+    [[nodiscard]] bool contains(const QString& cardId) const;
+
+    /**
+     * @brief 卡的流水余额
+     * @param cardId 卡号
+     * @return 最后一条流水之后的余额（没有流水时为0）
+     */
+    [[nodiscard]] Money balance(const QString& cardId) const;
+
+    /**
+     * @brief 卡的对账单
+     *
+     * 第一条流水之前的余额为first.balance - first.amount
+     * @param cardId 卡号
+     * @param from 起始日期（含，无效表示不限）
+     * @param to 结束日期（含，无效表示不限）
+     * @return 流水（按序号递增）
+     */
+    [[nodiscard]] QList<LedgerEntry> statement(const QString& cardId, const QDate& from = QDate(),
+                                               const QDate& to = QDate()) const;
+
+    /**
+     * @brief 流水总条数
+     */
+    [[nodiscard]] qint64 entryCount() const;
+
+    /**
+     * @brief 复制全部流水（隐式共享，只复制各卡流水列表的引用）
+     * @return 卡号到流水列表的映射
+     */
+    [[nodiscard]] QHash<QString, QList<LedgerEntry>> accounts() const;
+
+    // ========== 对账 ==========
+
+    /**
+     * @brief 串行对账
+     * @param cards 卡（物化余额）
+     * @param accounts 卡号到流水列表的映射
+     * @return 对账报告
+     */
+    [[nodiscard]] static ReconciliationReport reconcile(
+        const QList<Card>& cards, const QHash<QString, QList<LedgerEntry>>& accounts);
+
+    /**
+     * @brief 在线程池中并行对账，结果与reconcile()完全一致
+     * @param cards 卡（物化余额）
+     * @param accounts 卡号到流水列表的映射
+     * @param pool 线程池（nullptr表示全局线程池）
+     * @return 对账报告的QFuture
+     */
+    [[nodiscard]] static QFuture<ReconciliationReport> reconcileAsync(
+        const QList<Card>& cards, const QHash<QString, QList<LedgerEntry>>& accounts,
+        QThreadPool* pool = nullptr);
+
+private:
+    /**
+     * @struct Account
+     * @brief 待核对的一张卡
+     */
+    struct Account {
+        QString cardId;              ///< 卡号
+        bool cardExists = false;     ///< 卡是否存在
+        Money materialized;          ///< 卡上的余额
+        QList<LedgerEntry> entries;  ///< 流水
+    };
+
+    using Chunk = QList<Account>;
+
+    /**
+     * @brief 按卡号顺序切分分块
+     */
+    static QList<Chunk> partition(const QList<Card>& cards,
+                                  const QHash<QString, QList<LedgerEntry>>& accounts);
+
+    /**
+     * @brief 核对单个分块
+     */
+    static ReconciliationReport reconcileChunk(const Chunk& chunk);
+
+    /**
+     * @brief 将分块结果合并到总结果
+     */
+    static void merge(ReconciliationReport& total, const ReconciliationReport& part);
+
+    mutable QReadWriteLock m_lock;                  ///< 保护以下成员
+    QHash<QString, QList<LedgerEntry>> m_accounts;  ///< 卡号到流水列表的映射
+    QHash<QString, quint64> m_journalSequences;     ///< 卡号到已记账的最大日志序号
+    QList<LedgerEntry> m_pending;                   ///< 待持久化的流水
+    quint64 m_nextSequence = 1;                     ///< 下一条流水序号
+    qint64 m_entryCount = 0;                        ///< 流水总条数
+    Clock* m_clock = Clock::system();               ///< 时钟
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_BALANCELEDGER_H
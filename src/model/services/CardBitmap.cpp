@@ -0,0 +1,265 @@
+/**
+ * @file CardBitmap.cpp
+ * @brief 按卡序号压缩存储的卡集合位图实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "CardBitmap.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+
+namespace CampusCard {
+
+namespace {
+
+/// 位图块的64位字数量（65536位）
+constexpr int BITMAP_WORDS = 1024;
+
+}  // namespace
+
+// ========== 分块 ==========
+
+bool CardBitmap::Container::test(quint16 low) const {
+    if (isBitmap()) {
+        return (words.at(low >> 6) >> (low & 63)) & 1;
+    }
+    return std::binary_search(array.cbegin(), array.cend(), low);
+}
+
+void CardBitmap::normalize(Container& container) {
+    if (container.isBitmap() && container.cardinality <= ARRAY_MAX) {
+        QList<quint16> array;
+        array.reserve(container.cardinality);
+        for (int w = 0; w < BITMAP_WORDS; ++w) {
+            for (quint64 bits = container.words.at(w); bits != 0; bits &= bits - 1) {
+                array.append(static_cast<quint16>((w << 6) | std::countr_zero(bits)));
+            }
+        }
+        container.array = array;
+        container.words.clear();
+    } else if (!container.isBitmap() && container.cardinality > ARRAY_MAX) {
+        container.words = toWords(container);
+        container.array.clear();
+    }
+}
+
+QList<quint64> CardBitmap::toWords(const Container& container) {
+    if (container.isBitmap()) {
+        return container.words;
+    }
+    QList<quint64> words(BITMAP_WORDS, 0);
+    for (quint16 low : container.array) {
+        words[low >> 6] |= quint64(1) << (low & 63);
+    }
+    return words;
+}
+
+CardBitmap::Container CardBitmap::combine(const Container& a, const Container& b, SetOp op) {
+    Container result;
+    result.key = a.key;
+
+    if (!a.isBitmap() && !b.isBitmap()) {
+        // 两个有序数组：归并
+        auto out = std::back_inserter(result.array);
+        if (op == SetOp::And) {
+            std::set_intersection(a.array.cbegin(), a.array.cend(), b.array.cbegin(),
+                                  b.array.cend(), out);
+        } else if (op == SetOp::Or) {
+            std::set_union(a.array.cbegin(), a.array.cend(), b.array.cbegin(), b.array.cend(),
+                           out);
+        } else {
+            std::set_difference(a.array.cbegin(), a.array.cend(), b.array.cbegin(),
+                                b.array.cend(), out);
+        }
+        result.cardinality = static_cast<int>(result.array.size());
+    } else if ((op == SetOp::And || op == SetOp::AndNot) && !a.isBitmap()) {
+        // 数组与位图求交或差：按位图逐个过滤数组元素
+        const bool keep = (op == SetOp::And);
+        for (quint16 low : a.array) {
+            if (b.test(low) == keep) {
+                result.array.append(low);
+            }
+        }
+        result.cardinality = static_cast<int>(result.array.size());
+    } else if (op == SetOp::And && !b.isBitmap()) {
+        for (quint16 low : b.array) {
+            if (a.test(low)) {
+                result.array.append(low);
+            }
+        }
+        result.cardinality = static_cast<int>(result.array.size());
+    } else {
+        // 至少一侧为位图：逐字运算
+        result.words = toWords(a);
+        const QList<quint64> other = toWords(b);
+        quint64* words = result.words.data();
+        for (int w = 0; w < BITMAP_WORDS; ++w) {
+            if (op == SetOp::And) {
+                words[w] &= other.at(w);
+            } else if (op == SetOp::Or) {
+                words[w] |= other.at(w);
+            } else {
+                words[w] &= ~other.at(w);
+            }
+            result.cardinality += std::popcount(words[w]);
+        }
+    }
+
+    normalize(result);
+    return result;
+}
+
+CardBitmap CardBitmap::combine(const CardBitmap& a, const CardBitmap& b, SetOp op) {
+    CardBitmap result;
+    qsizetype i = 0;
+    qsizetype j = 0;
+    const qsizetype na = a.m_containers.size();
+    const qsizetype nb = b.m_containers.size();
+
+    while (i < na || j < nb) {
+        const Container* left = i < na ? &a.m_containers.at(i) : nullptr;
+        const Container* right = j < nb ? &b.m_containers.at(j) : nullptr;
+
+        if (left && (!right || left->key < right->key)) {
+            // 只在左侧存在的块：并集和差集原样保留
+            if (op != SetOp::And) {
+                result.m_containers.append(*left);
+            }
+            ++i;
+        } else if (right && (!left || right->key < left->key)) {
+            if (op == SetOp::Or) {
+                result.m_containers.append(*right);
+            }
+            ++j;
+        } else {
+            Container merged = combine(*left, *right, op);
+            if (merged.cardinality > 0) {
+                result.m_containers.append(merged);
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+// ========== CardBitmap ==========
+
+void CardBitmap::add(quint32 value) {
+    const auto key = static_cast<quint16>(value >> 16);
+    const auto low = static_cast<quint16>(value & 0xffff);
+
+    auto it = std::lower_bound(m_containers.begin(), m_containers.end(), key,
+                               [](const Container& c, quint16 k) { return c.key < k; });
+    if (it == m_containers.end() || it->key != key) {
+        Container container;
+        container.key = key;
+        it = m_containers.insert(it, container);
+    }
+
+    Container& container = *it;
+    if (container.isBitmap()) {
+        quint64& word = container.words[low >> 6];
+        const quint64 bit = quint64(1) << (low & 63);
+        if (!(word & bit)) {
+            word |= bit;
+            ++container.cardinality;
+        }
+        return;
+    }
+
+    auto pos = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (pos != container.array.end() && *pos == low) {
+        return;
+    }
+    container.array.insert(pos, low);
+    ++container.cardinality;
+    normalize(container);
+}
+
+bool CardBitmap::contains(quint32 value) const {
+    const auto key = static_cast<quint16>(value >> 16);
+    auto it = std::lower_bound(m_containers.cbegin(), m_containers.cend(), key,
+                               [](const Container& c, quint16 k) { return c.key < k; });
+    return it != m_containers.cend() && it->key == key &&
+           it->test(static_cast<quint16>(value & 0xffff));
+}
+
+qint64 CardBitmap::cardinality() const {
+    qint64 total = 0;
+    for (const auto& container : m_containers) {
+        total += container.cardinality;
+    }
+    return total;
+}
+
+QList<quint32> CardBitmap::values() const {
+    QList<quint32> result;
+    result.reserve(cardinality());
+    for (const auto& container : m_containers) {
+        const quint32 high = quint32(container.key) << 16;
+        if (container.isBitmap()) {
+            for (int w = 0; w < BITMAP_WORDS; ++w) {
+                for (quint64 bits = container.words.at(w); bits != 0; bits &= bits - 1) {
+                    result.append(high | quint32((w << 6) | std::countr_zero(bits)));
+                }
+            }
+        } else {
+            for (quint16 low : container.array) {
+                result.append(high | low);
+            }
+        }
+    }
+    return result;
+}
+
+qsizetype CardBitmap::memoryBytes() const {
+    qsizetype bytes = 0;
+    for (const auto& container : m_containers) {
+        bytes += sizeof(Container);
+        bytes += container.isBitmap() ? BITMAP_WORDS * qsizetype(sizeof(quint64))
+                                      : container.array.size() * qsizetype(sizeof(quint16));
+    }
+    return bytes;
+}
+
+CardBitmap CardBitmap::operator&(const CardBitmap& other) const {
+    return combine(*this, other, SetOp::And);
+}
+
+CardBitmap CardBitmap::operator|(const CardBitmap& other) const {
+    return combine(*this, other, SetOp::Or);
+}
+
+CardBitmap CardBitmap::andNot(const CardBitmap& other) const {
+    return combine(*this, other, SetOp::AndNot);
+}
+
+CardBitmap& CardBitmap::operator|=(const CardBitmap& other) {
+    *this = combine(*this, other, SetOp::Or);
+    return *this;
+}
+
+bool CardBitmap::operator==(const CardBitmap& other) const {
+    if (m_containers.size() != other.m_containers.size()) {
+        return false;
+    }
+    // 表示形式由基数唯一确定，因此逐块比较即可
+    for (qsizetype i = 0; i < m_containers.size(); ++i) {
+        const Container& a = m_containers.at(i);
+        const Container& b = other.m_containers.at(i);
+        if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array ||
+            a.words != b.words) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,133 @@
+/**
+ * @file CardBitmap.h
+ * @brief 按卡序号压缩存储的卡集合位图
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 采用Roaring位图的分块思路：按序号高16位分块，
+ * 稀疏块存有序数组，稠密块存65536位的位图，
+ * 用于按日、按地点的活跃卡集合及其交、并、差运算
+ */
+
+#ifndef MODEL_SERVICES_CARDBITMAP_H
+#define MODEL_SERVICES_CARDBITMAP_H
+
+#include <QList>
+#include <QtGlobal>
+
+
+namespace CampusCard {
+
+/**
+ * @class CardBitmap
+ * @brief 卡序号集合（Roaring风格压缩位图）
+ *
+ * 块内元素不超过ARRAY_MAX时使用有序数组（每个元素2字节），
+ * 超过时转为定长位图（8KB），两种表示在运算后按基数自动切换。
+ * 集合运算逐块进行，只有两侧都存在的块才需要实际计算。
+ */
+class CardBitmap {
+public:
+    static constexpr int ARRAY_MAX = 4096;  ///< 数组块的最大元素数
+
+    /**
+     * @brief 加入一个序号
+     * @param value 卡序号
+     */
+    void add(quint32 value);
+
+    /**
+     * @brief 是否包含序号
+     * @param value 卡序号
+     */
+    [[nodiscard]] bool contains(quint32 value) const;
+
+    /**
+     * @brief 元素数量
+     */
+    [[nodiscard]] qint64 cardinality() const;
+
+    /**
+     * @brief 是否为空集
+     */
+    [[nodiscard]] bool isEmpty() const { return m_containers.isEmpty(); }
+
+    /**
+     * @brief 清空
+     */
+    void clear() { m_containers.clear(); }
+
+    /**
+     * @brief 全部序号
+     * @return 升序排列的序号
+     */
+    [[nodiscard]] QList<quint32> values() const;
+
+    /**
+     * @brief 估算占用的字节数（仅统计块数据）
+     */
+    [[nodiscard]] qsizetype memoryBytes() const;
+
+    /**
+     * @brief 交集
+     */
+    [[nodiscard]] CardBitmap operator&(const CardBitmap& other) const;
+
+    /**
+     * @brief 并集
+     */
+    [[nodiscard]] CardBitmap operator|(const CardBitmap& other) const;
+
+    /**
+     * @brief 差集（属于本集合但不属于other）
+     */
+    [[nodiscard]] CardBitmap andNot(const CardBitmap& other) const;
+
+    CardBitmap& operator|=(const CardBitmap& other);
+
+    bool operator==(const CardBitmap& other) const;
+
+private:
+    /// 集合运算类型
+    enum class SetOp { And, Or, AndNot };
+
+    /**
+     * @brief 一个分块（序号高16位相同的元素）
+     */
+    struct Container {
+        quint16 key = 0;        ///< 序号高16位
+        int cardinality = 0;    ///< 元素数量
+        QList<quint16> array;   ///< 有序数组（稀疏块）
+        QList<quint64> words;   ///< 1024个64位字（稠密块，非空即表示位图形式）
+
+        [[nodiscard]] bool isBitmap() const { return !words.isEmpty(); }
+        [[nodiscard]] bool test(quint16 low) const;
+    };
+
+    /**
+     * @brief 按基数选择数组或位图表示
+     */
+    static void normalize(Container& container);
+
+    /**
+     * @brief 将块展开为位图字
+     */
+    static QList<quint64> toWords(const Container& container);
+
+    /**
+     * @brief 计算两个同键块的运算结果
+     */
+    static Container combine(const Container& a, const Container& b, SetOp op);
+
+    /**
+     * @brief 计算两个位图的运算结果
+     */
+    static CardBitmap combine(const CardBitmap& a, const CardBitmap& b, SetOp op);
+
+    QList<Container> m_containers;  ///< 按key升序排列的分块
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_CARDBITMAP_H
@@ -0,0 +1,58 @@
+/**
+ * @file CardQuery.cpp
+ * @brief 校园卡组合查询实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "CardQuery.h"
+
+namespace CampusCard {
+
+// ========== 过滤条件 ==========
+
+CardQuery& CardQuery::cards(const QStringList& cardIds) {
+    m_cardIds = QSet<QString>(cardIds.begin(), cardIds.end());
+    return *this;
+}
+
+CardQuery& CardQuery::studentIdPrefix(const QString& prefix) {
+    m_studentIdPrefix = prefix.trimmed();
+    return *this;
+}
+
+CardQuery& CardQuery::state(CardState state) {
+    m_state = state;
+    return *this;
+}
+
+CardQuery& CardQuery::inStateForDays(int days) {
+    m_minDaysInState = qMax(0, days);
+    return *this;
+}
+
+// ========== 条件检查 ==========
+
+bool CardQuery::matches(const Card& card, const QDateTime& now) const {
+    if (m_cardIds && !m_cardIds->contains(card.cardId())) {
+        return false;
+    }
+    if (!m_studentIdPrefix.isEmpty() &&
+        !card.studentId().startsWith(m_studentIdPrefix, Qt::CaseInsensitive)) {
+        return false;
+    }
+    if (m_state && card.state() != *m_state) {
+        return false;
+    }
+    if (m_minDaysInState > 0) {
+        const QDateTime since = card.stateChangedAt();
+        if (!since.isValid() || since.addDays(m_minDaysInState) > now) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,95 @@
+/**
+ * @file CardQuery.h
+ * @brief 校园卡组合查询
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 描述批量状态操作的目标卡集合（指定卡号、班级、状态及其持续时间），
+ * 由CardService根据可用索引选择候选卡并在加锁后逐张复核
+ */
+
+#ifndef MODEL_SERVICES_CARDQUERY_H
+#define MODEL_SERVICES_CARDQUERY_H
+
+#include "model/entities/Card.h"
+
+#include <QDateTime>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+
+namespace CampusCard {
+
+/**
+ * @class CardQuery
+ * @brief 卡查询构建器
+ *
+ * 所有条件之间为"与"关系，未设置的条件不参与过滤；不设置任何条件时匹配所有卡。示例：
+ * @code
+ * // 班级B2301的所有卡
+ * CardQuery().studentIdPrefix("B2301");
+ * // 冻结超过30天的卡
+ * CardQuery().state(CardState::Frozen).inStateForDays(30);
+ * @endcode
+ */
+class CardQuery {
+public:
+    // ========== 过滤条件 ==========
+
+    /**
+     * @brief 限定卡号集合
+     * @param cardIds 卡号列表
+     * @return 自身引用
+     */
+    CardQuery& cards(const QStringList& cardIds);
+
+    /**
+     * @brief 限定学号前缀（班级号即学号前缀，忽略大小写；空字符串表示不筛选）
+     * @param prefix 学号前缀
+     * @return 自身引用
+     */
+    CardQuery& studentIdPrefix(const QString& prefix);
+
+    /**
+     * @brief 限定卡状态
+     * @param state 状态
+     * @return 自身引用
+     */
+    CardQuery& state(CardState state);
+
+    /**
+     * @brief 限定处于当前状态的最少天数（状态变更时间未知的卡不匹配）
+     * @param days 天数（不大于0表示不筛选）
+     * @return 自身引用
+     */
+    CardQuery& inStateForDays(int days);
+
+    // ========== 条件检查 ==========
+
+    /**
+     * @brief 检查卡是否满足全部过滤条件
+     * @param card 卡
+     * @param now 当前时间（用于计算状态持续天数）
+     * @return 是否满足
+     */
+    [[nodiscard]] bool matches(const Card& card, const QDateTime& now) const;
+
+    // ========== 条件访问（供执行计划使用） ==========
+
+    [[nodiscard]] const std::optional<QSet<QString>>& cardsFilter() const { return m_cardIds; }
+    [[nodiscard]] const std::optional<CardState>& stateFilter() const { return m_state; }
+
+private:
+    std::optional<QSet<QString>> m_cardIds;  ///< 卡号集合
+    QString m_studentIdPrefix;               ///< 学号前缀
+    std::optional<CardState> m_state;        ///< 状态
+    int m_minDaysInState = 0;                ///< 处于当前状态的最少天数
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_CARDQUERY_H
@@ -0,0 +1,211 @@
+/**
+ * @file CardSearchIndex.cpp
+ * @brief 校园卡子串搜索索引实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "CardSearchIndex.h"
+
+#include "model/services/PinyinTable.h"
+
+#include <QSet>
+
+#include <algorithm>
+
+
+namespace CampusCard {
+
+void CardSearchIndex::clear() {
+    m_entries.clear();
+    m_freeSlots.clear();
+    m_slotOf.clear();
+    m_postings.clear();
+    m_pinyin.clear();
+}
+
+void CardSearchIndex::reserve(qsizetype cardCount) {
+    m_entries.reserve(cardCount);
+    m_slotOf.reserve(cardCount);
+}
+
+void CardSearchIndex::insert(const Card& card) {
+    const std::array<QString, 3> fields = {card.cardId().toCaseFolded(),
+                                           card.studentId().toCaseFolded(),
+                                           card.name().toCaseFolded()};
+
+    auto existing = m_slotOf.constFind(card.cardId());
+    if (existing != m_slotOf.constEnd()) {
+        if (m_entries.at(existing.value()).fields == fields) {
+            return;
+        }
+        remove(card.cardId());
+    }
+
+    Entry entry{card.cardId(), fields, PinyinTable::searchKeys(card.name())};
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+        m_entries[slot] = entry;
+    } else {
+        slot = static_cast<int>(m_entries.size());
+        m_entries.append(entry);
+    }
+    m_slotOf.insert(card.cardId(), slot);
+
+    for (const auto& gram : gramsOf(fields)) {
+        m_postings[gram].append(slot);
+    }
+    for (const auto& key : entry.pinyinKeys) {
+        m_pinyin.insert(key, slot);
+    }
+}
+
+void CardSearchIndex::remove(const QString& cardId) {
+    auto it = m_slotOf.find(cardId);
+    if (it == m_slotOf.end()) {
+        return;
+    }
+    const int slot = it.value();
+    m_slotOf.erase(it);
+
+    for (const auto& gram : gramsOf(m_entries.at(slot).fields)) {
+        auto posting = m_postings.find(gram);
+        if (posting == m_postings.end()) {
+            continue;
+        }
+        posting.value().removeOne(slot);
+        if (posting.value().isEmpty()) {
+            m_postings.erase(posting);
+        }
+    }
+    for (const auto& key : m_entries.at(slot).pinyinKeys) {
+        m_pinyin.remove(key, slot);
+    }
+
+    m_entries[slot] = Entry();
+    m_freeSlots.append(slot);
+}
+
+QStringList CardSearchIndex::search(const QString& keyword, int limit) const {
+    const QString folded = keyword.toCaseFolded();
+    if (folded.isEmpty() || limit == 0) {
+        return {};
+    }
+
+    QList<Hit> hits;
+    if (const QList<int>* candidates = gramCandidates(folded)) {
+        hits.reserve(candidates->size());
+        for (int slot : *candidates) {
+            const int rank = rankOf(m_entries.at(slot), folded);
+            if (rank >= 0) {
+                hits.append(Hit{rank, slot});
+            }
+        }
+    }
+
+    // 拼音前缀匹配，与子串匹配到的同一张卡取较好的档次
+    const QString prefix = pinyinPrefixOf(folded);
+    if (!prefix.isEmpty()) {
+        QHash<int, qsizetype> indexOf;
+        indexOf.reserve(hits.size());
+        for (qsizetype i = 0; i < hits.size(); ++i) {
+            indexOf.insert(hits.at(i).slot, i);
+        }
+        for (int slot : m_pinyin.valuesWithPrefix(prefix)) {
+            const int rank = m_entries.at(slot).pinyinKeys.contains(prefix) ? 0 : 1;
+            auto it = indexOf.constFind(slot);
+            if (it == indexOf.constEnd()) {
+                indexOf.insert(slot, hits.size());
+                hits.append(Hit{rank, slot});
+            } else {
+                hits[it.value()].rank = qMin(hits.at(it.value()).rank, rank);
+            }
+        }
+    }
+
+    auto before = [this](const Hit& a, const Hit& b) {
+        if (a.rank != b.rank) {
+            return a.rank < b.rank;
+        }
+        return m_entries.at(a.slot).cardId < m_entries.at(b.slot).cardId;
+    };
+    if (limit > 0 && limit < hits.size()) {
+        std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), before);
+        hits.resize(limit);
+    } else {
+        std::sort(hits.begin(), hits.end(), before);
+    }
+
+    QStringList cardIds;
+    cardIds.reserve(hits.size());
+    for (const auto& hit : hits) {
+        cardIds.append(m_entries.at(hit.slot).cardId);
+    }
+    return cardIds;
+}
+
+const QList<int>* CardSearchIndex::gramCandidates(const QString& folded) const {
+    // 关键词不长于MAX_GRAM时直接取其倒排表，否则取各子串中最短的倒排表
+    if (folded.size() <= MAX_GRAM) {
+        auto it = m_postings.constFind(folded);
+        return it != m_postings.constEnd() ? &it.value() : nullptr;
+    }
+
+    const QList<int>* candidates = nullptr;
+    for (qsizetype i = 0; i + MAX_GRAM <= folded.size(); ++i) {
+        auto it = m_postings.constFind(folded.mid(i, MAX_GRAM));
+        if (it == m_postings.constEnd()) {
+            return nullptr;
+        }
+        if (!candidates || it.value().size() < candidates->size()) {
+            candidates = &it.value();
+        }
+    }
+    return candidates;
+}
+
+QString CardSearchIndex::pinyinPrefixOf(const QString& folded) {
+    QString prefix;
+    for (QChar ch : folded) {
+        if (ch.isSpace()) {
+            continue;
+        }
+        if (ch < QLatin1Char('a') || ch > QLatin1Char('z')) {
+            return QString();
+        }
+        prefix += ch;
+    }
+    return prefix;
+}
+
+QStringList CardSearchIndex::gramsOf(const std::array<QString, 3>& fields) {
+    QSet<QString> grams;
+    for (const auto& field : fields) {
+        for (qsizetype i = 0; i < field.size(); ++i) {
+            for (qsizetype n = 1; n <= MAX_GRAM && i + n <= field.size(); ++n) {
+                grams.insert(field.mid(i, n));
+            }
+        }
+    }
+    return QStringList(grams.begin(), grams.end());
+}
+
+int CardSearchIndex::rankOf(const Entry& entry, const QString& folded) {
+    int rank = -1;
+    for (const auto& field : entry.fields) {
+        if (field == folded) {
+            return 0;
+        }
+        if (field.startsWith(folded)) {
+            rank = 1;
+        } else if (rank < 0 && field.contains(folded)) {
+            rank = 2;
+        }
+    }
+    return rank;
+}
+
+}  // namespace CampusCard
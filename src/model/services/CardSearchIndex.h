@@ -0,0 +1,142 @@
+/**
+ * @file CardSearchIndex.h
+ * @brief 校园卡子串搜索索引
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 对卡号、学号和姓名建立1到3字符的n-gram倒排索引，
+ * 输入框每次按键的搜索只需检查最短倒排表中的候选卡；
+ * 另把姓名的拼音全拼和首字母放在前缀树中，支持按拼音前缀搜索
+ */
+
+#ifndef MODEL_SERVICES_CARDSEARCHINDEX_H
+#define MODEL_SERVICES_CARDSEARCHINDEX_H
+
+#include "model/entities/Card.h"
+#include "model/services/PrefixTrie.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+
+
+namespace CampusCard {
+
+/**
+ * @class CardSearchIndex
+ * @brief 卡号、学号、姓名的n-gram子串索引
+ *
+ * 各字段先折叠大小写，再把其中所有长度为1到MAX_GRAM的子串（按QChar计，
+ * 中文姓名每个汉字是一个字符）映射到卡的槽位。关键词不超过MAX_GRAM个字符时
+ * 它本身的倒排表就是结果；更长时取其各个MAX_GRAM子串中最短的倒排表作为候选，
+ * 再逐个核对是否包含整个关键词。n-gram不跨字段，因此不会出现跨字段的误匹配。
+ *
+ * 关键词去掉空白后全是英文字母时，还按拼音前缀匹配姓名（"zhangsan"、"zhangs"
+ * 和"zs"都能找到张三）。拼音键在卡加入或姓名变化时由PinyinTable生成一次。
+ *
+ * 结果按匹配程度排序：某字段或拼音键与关键词完全相同 > 以关键词开头 > 仅包含，
+ * 同一档内按卡号排序。
+ */
+class CardSearchIndex {
+public:
+    static constexpr int MAX_GRAM = 3;  ///< 最长的n-gram
+
+    /**
+     * @brief 清空索引
+     */
+    void clear();
+
+    /**
+     * @brief 预留容量
+     * @param cardCount 卡数量
+     */
+    void reserve(qsizetype cardCount);
+
+    /**
+     * @brief 加入或更新一张卡（卡号、学号、姓名都未变化时什么也不做）
+     * @param card 卡对象
+     */
+    void insert(const Card& card);
+
+    /**
+     * @brief 移除一张卡
+     * @param cardId 卡号
+     */
+    void remove(const QString& cardId);
+
+    /**
+     * @brief 子串及拼音前缀搜索（忽略大小写）
+     * @param keyword 关键词（为空时返回空列表）
+     * @param limit 最多返回的结果数（负数表示不限）
+     * @return 按匹配程度排序的卡号
+     */
+    [[nodiscard]] QStringList search(const QString& keyword, int limit = -1) const;
+
+    /**
+     * @brief 已索引的卡数
+     */
+    [[nodiscard]] qsizetype size() const { return m_slotOf.size(); }
+
+private:
+    /**
+     * @struct Entry
+     * @brief 一张卡的已折叠字段
+     */
+    struct Entry {
+        QString cardId;                 ///< 原始卡号（用于返回和排序）
+        std::array<QString, 3> fields;  ///< 折叠后的卡号、学号、姓名
+        QStringList pinyinKeys;         ///< 姓名的拼音搜索键
+    };
+
+    /**
+     * @struct Hit
+     * @brief 一个匹配结果
+     */
+    struct Hit {
+        int rank;  ///< 匹配档次
+        int slot;  ///< 槽位
+    };
+
+    /**
+     * @brief n-gram索引中的候选槽位
+     * @param folded 折叠后的关键词
+     * @return 倒排表（没有候选时为nullptr）
+     */
+    [[nodiscard]] const QList<int>* gramCandidates(const QString& folded) const;
+
+    /**
+     * @brief 关键词对应的拼音前缀
+     * @param folded 折叠后的关键词
+     * @return 去掉空白后的关键词（含非英文字母时为空）
+     */
+    [[nodiscard]] static QString pinyinPrefixOf(const QString& folded);
+
+    /**
+     * @brief 字段中所有不重复的n-gram
+     * @param fields 折叠后的字段
+     * @return n-gram列表
+     */
+    [[nodiscard]] static QStringList gramsOf(const std::array<QString, 3>& fields);
+
+    /**
+     * @brief 关键词与一张卡的匹配档次
+     * @param entry 卡
+     * @param folded 折叠后的关键词
+     * @return 0完全相同，1前缀，2包含，-1不匹配
+     */
+    [[nodiscard]] static int rankOf(const Entry& entry, const QString& folded);
+
+    QList<Entry> m_entries;                 ///< 槽位到卡的映射（空闲槽位的卡号为空）
+    QList<int> m_freeSlots;                 ///< 可复用的槽位
+    QHash<QString, int> m_slotOf;           ///< 卡号到槽位
+    QHash<QString, QList<int>> m_postings;  ///< n-gram到槽位的倒排表
+    PrefixTrie m_pinyin;                    ///< 拼音搜索键到槽位的前缀树
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_CARDSEARCHINDEX_H
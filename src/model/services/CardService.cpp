@@ -9,90 +9,329 @@
 
 #include "CardService.h"
 
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
+#include <utility>
+
+
 namespace CampusCard {
 
-CardService::CardService(QObject* parent) : QObject(parent) {}
+CardService::CardService(QObject* parent)
+    : QObject(parent), m_collator(QLocale(QLocale::Chinese, QLocale::China)) {}
 
 void CardService::initialize() {
     // 从存储加载所有卡数据
     QList<Card> cards = StorageManager::instance().loadAllCards();
-    m_cards.clear();
+    // 没有状态变更时间的旧数据从本次加载起计时
+    const QDateTime loadedAt = m_clock->now();
+    for (auto& card : cards) {
+        if (!card.stateChangedAt().isValid()) {
+            card.setStateChangedAt(loadedAt);
+        }
+    }
+    QList<LedgerEntry> ledger;
+    for (const auto& json : StorageManager::instance().loadLedger()) {
+        ledger.append(LedgerEntry::fromJson(json));
+    }
+
+    // 按固定顺序锁住所有分片，再锁索引
+    for (auto& shard : m_shards) {
+        shard.lock.lockForWrite();
+    }
+    m_indexLock.lockForWrite();
+
+    for (auto& shard : m_shards) {
+        shard.cards.clear();
+    }
+    m_byStudentId.clear();
+    m_byState.clear();
+    m_byName.clear();
+    m_searchIndex.clear();
+    m_nameKeys.clear();
+    m_searchIndex.reserve(cards.size());
     for (const auto& card : cards) {
-        m_cards[card.cardId()] = card;
+        // 文件中卡号重复时以后出现的为准
+        QHash<QString, Card>& shardCards = shardOf(card.cardId()).cards;
+        auto it = shardCards.find(card.cardId());
+        if (it != shardCards.end()) {
+            removeFromIndexes(it.value());
+        }
+        shardCards.insert(card.cardId(), card);
+        addToIndexes(card);
+    }
+    invalidateOrderings();
+
+    // 启用流水之前已有余额的卡以当前余额开户
+    m_ledger.load(ledger);
+    for (const auto& shard : m_shards) {
+        for (const auto& card : shard.cards) {
+            if (!card.balance().isZero() && !m_ledger.contains(card.cardId())) {
+                m_ledger.append(card.cardId(), LedgerEntryType::Opening, card.balance());
+            }
+        }
+    }
+
+    m_indexLock.unlock();
+    for (auto& shard : m_shards) {
+        shard.lock.unlock();
+    }
+
+    // 未冻结的卡载入已保存的失败计数，从本次加载起计算时间窗口
+    m_loginAttempts.clear();
+    const qint64 loadedAtMSecs = loadedAt.toMSecsSinceEpoch();
+    for (const auto& card : std::as_const(cards)) {
+        if (!card.isFrozen() && card.loginAttempts() > 0) {
+            m_loginAttempts.restore(card.cardId(), card.loginAttempts(), loadedAtMSecs);
+        }
     }
 }
 
 bool CardService::saveAll() {
-    QList<Card> cards = m_cards.values();
+    // 在保存锁内取快照，保证后写入文件的快照不早于先写入的
+    QMutexLocker locker(&m_saveMutex);
+
+    // 记账总在卡所在分片的写锁内进行：锁住全部分片后一起取出卡和待写流水，
+    // 写入文件的每个余额都有对应的流水一同落盘
+    QList<Card> cards;
+    for (const auto& shard : m_shards) {
+        shard.lock.lockForRead();
+    }
+    for (const auto& shard : m_shards) {
+        for (const auto& card : shard.cards) {
+            cards.append(card);
+        }
+    }
+    const QList<LedgerEntry> pending = m_ledger.takePending();
+    for (const auto& shard : m_shards) {
+        shard.lock.unlock();
+    }
+    std::sort(cards.begin(), cards.end(),
+              [](const Card& a, const Card& b) { return a.cardId() < b.cardId(); });
+
+    // 先追加流水再写卡文件：两步之间崩溃时，重放事务日志不会重复记账；
+    // 流水写入失败时不写卡文件，文件中的余额不会领先于流水
+    QList<QJsonObject> lines;
+    lines.reserve(pending.size());
+    for (const auto& entry : pending) {
+        lines.append(entry.toJson());
+    }
+    if (!StorageManager::instance().appendLedger(lines)) {
+        m_ledger.restorePending(pending);
+        return false;
+    }
     return StorageManager::instance().saveAllCards(cards);
 }
 
+template <typename Mutator>
+bool CardService::modifyCard(const QString& cardId, Mutator&& mutate) {
+    Shard& shard = shardOf(cardId);
+    QWriteLocker locker(&shard.lock);
+    auto it = shard.cards.find(cardId);
+    if (it == shard.cards.end()) {
+        return false;
+    }
+    return mutate(it.value());
+}
+
+template <typename Mutator>
+CardBatchResult CardService::modifyMatching(const CardQuery& query, Mutator&& mutate) {
+    const QDateTime now = m_clock->now();
+    CardBatchResult result;
+    {
+        QWriteLocker batch(&m_batchLock);
+        for (const auto& cardId : findCardIds(query)) {
+            // 查询与修改之间卡可能已变化，加写锁后复核条件
+            bool ok = modifyCard(cardId, [&](Card& card) {
+                return query.matches(card, now) && mutate(card);
+            });
+            if (ok) {
+                result.changed.append(cardId);
+            }
+        }
+    }
+
+    if (!result.changed.isEmpty()) {
+        result.saved = saveAll();
+        emit cardsChanged();
+    }
+    return result;
+}
+
 // ========== 查询操作 ==========
 
 QList<Card> CardService::getAllCards() const {
-    return m_cards.values();
+    QList<Card> cards;
+    for (int i = 0; i < SHARD_COUNT; ++i) {
+        const QHash<QString, Card> snapshot = shardSnapshot(i);
+        for (const auto& card : snapshot) {
+            cards.append(card);
+        }
+    }
+    std::sort(cards.begin(), cards.end(),
+              [](const Card& a, const Card& b) { return a.cardId() < b.cardId(); });
+    return cards;
+}
+
+QList<QHash<QString, Card>> CardService::cardShards() const {
+    // 排除进行中的批量修改，再按固定顺序锁住所有分片
+    QReadLocker batch(&m_batchLock);
+    for (const auto& shard : m_shards) {
+        shard.lock.lockForRead();
+    }
+    QList<QHash<QString, Card>> shards;
+    shards.reserve(SHARD_COUNT);
+    for (const auto& shard : m_shards) {
+        shards.append(shard.cards);
+    }
+    for (const auto& shard : m_shards) {
+        shard.lock.unlock();
+    }
+    return shards;
 }
 
 Card CardService::findCard(const QString& cardId) const {
-    auto it = m_cards.find(cardId);
-    if (it != m_cards.end()) {
-        return it.value();
+    const Shard& shard = shardOf(cardId);
+    QReadLocker locker(&shard.lock);
+    return shard.cards.value(cardId);
+}
+
+Card CardService::findCardByStudentId(const QString& studentId) const {
+    QStringList cardIds;
+    {
+        QReadLocker locker(&m_indexLock);
+        cardIds = m_byStudentId.values(studentId);
     }
-    return Card();
+    if (cardIds.isEmpty()) {
+        return Card();
+    }
+    return findCard(*std::min_element(cardIds.begin(), cardIds.end()));
 }
 
-Card* CardService::getCardPtr(const QString& cardId) {
-    auto it = m_cards.find(cardId);
-    if (it != m_cards.end()) {
-        return &it.value();
+QList<Card> CardService::findCardsByState(CardState state) const {
+    QSet<QString> cardIds;
+    {
+        QReadLocker locker(&m_indexLock);
+        cardIds = m_byState.value(state);
     }
-    return nullptr;
+    return cardsSortedById(QStringList(cardIds.begin(), cardIds.end()));
 }
 
-Card CardService::findCardByStudentId(const QString& studentId) const {
-    for (const auto& card : m_cards) {
-        if (card.studentId() == studentId) {
-            return card;
+QStringList CardService::findCardIds(const CardQuery& query) const {
+    // 优先用卡号或状态索引缩小候选范围
+    QStringList candidates;
+    if (query.cardsFilter()) {
+        candidates = QStringList(query.cardsFilter()->begin(), query.cardsFilter()->end());
+    } else if (query.stateFilter()) {
+        QReadLocker locker(&m_indexLock);
+        const QSet<QString> cardIds = m_byState.value(*query.stateFilter());
+        candidates = QStringList(cardIds.begin(), cardIds.end());
+    } else {
+        for (int i = 0; i < SHARD_COUNT; ++i) {
+            candidates.append(shardSnapshot(i).keys());
+        }
+    }
+
+    const QDateTime now = m_clock->now();
+    QStringList matched;
+    for (const auto& cardId : std::as_const(candidates)) {
+        const Shard& shard = shardOf(cardId);
+        QReadLocker locker(&shard.lock);
+        auto it = shard.cards.find(cardId);
+        if (it != shard.cards.end() && query.matches(it.value(), now)) {
+            matched.append(cardId);
+        }
+    }
+    std::sort(matched.begin(), matched.end());
+    return matched;
+}
+
+int CardService::countCardsByState(CardState state) const {
+    QReadLocker locker(&m_indexLock);
+    auto it = m_byState.find(state);
+    return it != m_byState.end() ? static_cast<int>(it.value().size()) : 0;
+}
+
+QList<Card> CardService::findCardsByName(const QString& name) const {
+    QStringList cardIds;
+    {
+        QReadLocker locker(&m_indexLock);
+        cardIds = m_byName.values(normalizeName(name));
+    }
+    return cardsSortedById(cardIds);
+}
+
+QList<Card> CardService::searchCards(const QString& keyword, int limit) const {
+    if (keyword.isEmpty()) {
+        QList<Card> cards = getAllCards();
+        if (limit >= 0 && limit < cards.size()) {
+            cards.resize(limit);
         }
+        return cards;
     }
-    return Card();
+
+    QStringList cardIds;
+    {
+        QReadLocker locker(&m_indexLock);
+        cardIds = m_searchIndex.search(keyword, limit);
+    }
+    QList<Card> cards;
+    cards.reserve(cardIds.size());
+    for (const auto& cardId : cardIds) {
+        cards.append(findCard(cardId));
+    }
+    return cards;
+}
+
+QString CardService::normalizeName(const QString& name) {
+    return name.simplified().toCaseFolded();
 }
 
 bool CardService::cardExists(const QString& cardId) const {
-    return m_cards.contains(cardId);
+    const Shard& shard = shardOf(cardId);
+    QReadLocker locker(&shard.lock);
+    return shard.cards.contains(cardId);
 }
 
 int CardService::cardCount() const {
-    return m_cards.size();
+    int count = 0;
+    for (const auto& shard : m_shards) {
+        QReadLocker locker(&shard.lock);
+        count += static_cast<int>(shard.cards.size());
+    }
+    return count;
 }
 
 // ========== 创建操作 ==========
 
 bool CardService::createCard(const QString& cardId, const QString& name, const QString& studentId,
-                             double initialBalance) {
-    // 检查卡号是否已存在
-    if (cardExists(cardId)) {
-        return false;
-    }
-
-    // 创建新卡并添加到映射
-    Card newCard(cardId, name, studentId, initialBalance);
-    m_cards[cardId] = newCard;
-
-    // 保存并发出信号
-    saveAll();
-    emit cardCreated(cardId);
-    emit cardsChanged();
-    return true;
+                             Money initialBalance) {
+    return createCard(Card(cardId, name, studentId, initialBalance));
 }
 
 bool CardService::createCard(const Card& card) {
-    // 检查卡号是否已存在
-    if (cardExists(card.cardId())) {
-        return false;
-    }
+    {
+        Shard& shard = shardOf(card.cardId());
+        QWriteLocker locker(&shard.lock);
+        // 检查卡号是否已存在
+        if (shard.cards.contains(card.cardId())) {
+            return false;
+        }
 
-    m_cards[card.cardId()] = card;
+        Card created = card;
+        if (!created.stateChangedAt().isValid()) {
+            created.setStateChangedAt(m_clock->now());
+        }
+        shard.cards.insert(card.cardId(), created);
+        if (!card.balance().isZero()) {
+            m_ledger.append(card.cardId(), LedgerEntryType::Opening, card.balance());
+        }
+        QWriteLocker indexLocker(&m_indexLock);
+        addToIndexes(created);
+        invalidateOrderings();
+    }
 
     // 保存并发出信号
     saveAll();
@@ -103,22 +342,26 @@ bool CardService::createCard(const Card& card) {
 
 // ========== 充值扣款操作 ==========
 
-bool CardService::recharge(const QString& cardId, double amount) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
-        return false;
-    }
-
+bool CardService::recharge(const QString& cardId, Money amount) {
     // 充值金额必须为正数
-    if (amount <= 0) {
+    if (!amount.isPositive()) {
         return false;
     }
 
     // 执行充值
-    double newBalance = card->balance() + amount;
-    double newTotalRecharge = card->totalRecharge() + amount;
-    card->setBalance(newBalance);
-    card->setTotalRecharge(newTotalRecharge);
+    Money newBalance;
+    bool found = modifyCard(cardId, [&](Card& card) {
+        newBalance = card.balance() + amount;
+        card.setBalance(newBalance);
+        card.setTotalRecharge(card.totalRecharge() + amount);
+        m_ledger.append(cardId, LedgerEntryType::Recharge, amount);
+        invalidateOrdering(CardSortField::Balance);
+        invalidateOrdering(CardSortField::TotalRecharge);
+        return true;
+    });
+    if (!found) {
+        return false;
+    }
 
     // 保存并发出信号
     saveAll();
@@ -127,51 +370,264 @@ bool CardService::recharge(const QString& cardId, double amount) {
     return true;
 }
 
-bool CardService::deduct(const QString& cardId, double amount) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+bool CardService::deduct(const QString& cardId, Money amount) {
+    // 检查和扣款在同一次加锁内完成，并发扣款不会透支
+    Money newBalance;
+    bool deducted = modifyCard(cardId, [&](Card& card) {
+        if (!canDeductFrom(card, amount)) {
+            return false;
+        }
+        newBalance = card.balance() - amount;
+        card.setBalance(newBalance);
+        m_ledger.append(cardId, LedgerEntryType::Charge, -amount);
+        invalidateOrdering(CardSortField::Balance);
+        return true;
+    });
+    if (!deducted) {
         return false;
     }
 
+    // 保存并发出信号
+    saveAll();
+    emit cardUpdated(cardId);
+    emit balanceChanged(cardId, newBalance);
+    return true;
+}
+
+bool CardService::canDeduct(const QString& cardId, Money amount) const {
+    const Shard& shard = shardOf(cardId);
+    QReadLocker locker(&shard.lock);
+    auto it = shard.cards.find(cardId);
+    return it != shard.cards.end() && canDeductFrom(it.value(), amount);
+}
+
+bool CardService::canDeductFrom(const Card& card, Money amount) {
     // 检查卡是否可用
-    if (!card->isUsable()) {
+    if (!card.isUsable()) {
         return false;
     }
 
     // 检查金额有效性和余额充足性
-    if (amount <= 0 || card->balance() < amount) {
+    return amount.isPositive() && card.balance() >= amount;
+}
+
+bool CardService::commitDeducts(const QMap<QString, Money>& costs, quint64 sequence,
+                                const std::function<bool(const QMap<QString, Money>&)>& commit) {
+    // 按分片序号加写锁，与ledgerSnapshot()等锁住多个分片的操作顺序一致
+    QList<Shard*> locked;
+    for (auto& shard : m_shards) {
+        for (auto it = costs.keyBegin(); it != costs.keyEnd(); ++it) {
+            if (&shardOf(*it) == &shard) {
+                shard.lock.lockForWrite();
+                locked.append(&shard);
+                break;
+            }
+        }
+    }
+
+    QMap<QString, Money> debits;
+    for (auto it = costs.constBegin(); it != costs.constEnd(); ++it) {
+        const Shard& shard = shardOf(it.key());
+        auto card = shard.cards.constFind(it.key());
+        const bool ok = card != shard.cards.constEnd() && canDeductFrom(card.value(), it.value());
+        debits.insert(it.key(), ok ? it.value() : Money());
+    }
+
+    const bool committed = commit(debits);
+    if (committed) {
+        bool debited = false;
+        for (auto it = debits.constBegin(); it != debits.constEnd(); ++it) {
+            if (!it.value().isPositive()) {
+                continue;
+            }
+            Card& card = shardOf(it.key()).cards[it.key()];
+            card.setBalance(card.balance() - it.value());
+            card.setJournalSequence(sequence);
+            m_ledger.append(it.key(), LedgerEntryType::Charge, -it.value(), sequence);
+            debited = true;
+        }
+        if (debited) {
+            invalidateOrdering(CardSortField::Balance);
+        }
+    }
+
+    for (Shard* shard : locked) {
+        shard->lock.unlock();
+    }
+    return committed;
+}
+
+bool CardService::applyJournaledDeduct(const QString& cardId, Money amount, quint64 sequence,
+                                       bool notify) {
+    Money newBalance;
+    bool applied = modifyCard(cardId, [&](Card& card) {
+        if (sequence <= card.journalSequence()) {
+            return false;
+        }
+        newBalance = card.balance() - amount;
+        card.setBalance(newBalance);
+        card.setJournalSequence(sequence);
+        m_ledger.append(cardId, LedgerEntryType::Charge, -amount, sequence);
+        invalidateOrdering(CardSortField::Balance);
+        return true;
+    });
+    if (!applied) {
         return false;
     }
 
-    // 执行扣款
-    double newBalance = card->balance() - amount;
-    card->setBalance(newBalance);
+    if (notify) {
+        emit cardUpdated(cardId);
+        emit balanceChanged(cardId, newBalance);
+    }
+    return true;
+}
 
-    // 保存并发出信号
-    saveAll();
+void CardService::notifyBalanceChanged(const QString& cardId) {
     emit cardUpdated(cardId);
-    emit balanceChanged(cardId, newBalance);
-    return true;
+    emit balanceChanged(cardId, getBalance(cardId));
+}
+
+void CardService::notifyCardsChanged() {
+    emit cardsChanged();
 }
 
-double CardService::getBalance(const QString& cardId) const {
-    auto it = m_cards.find(cardId);
-    if (it != m_cards.end()) {
+QStringList CardService::deductBatch(const QMap<QString, Money>& amounts) {
+    QStringList deducted;
+    QWriteLocker batch(&m_batchLock);
+    for (auto it = amounts.constBegin(); it != amounts.constEnd(); ++it) {
+        bool ok = modifyCard(it.key(), [&](Card& card) {
+            if (!canDeductFrom(card, it.value())) {
+                return false;
+            }
+            card.setBalance(card.balance() - it.value());
+            m_ledger.append(it.key(), LedgerEntryType::Charge, -it.value());
+            return true;
+        });
+        if (ok) {
+            deducted.append(it.key());
+        }
+    }
+    batch.unlock();
+
+    if (!deducted.isEmpty()) {
+        invalidateOrdering(CardSortField::Balance);
+        saveAll();
+        emit cardsChanged();
+    }
+    return deducted;
+}
+
+int CardService::applyJournaledDeducts(const QMap<QString, Money>& amounts, quint64 sequence,
+                                      bool notify) {
+    int applied = 0;
+    QWriteLocker batch(&m_batchLock);
+    for (auto it = amounts.constBegin(); it != amounts.constEnd(); ++it) {
+        bool ok = modifyCard(it.key(), [&](Card& card) {
+            if (sequence <= card.journalSequence()) {
+                return false;
+            }
+            card.setBalance(card.balance() - it.value());
+            card.setJournalSequence(sequence);
+            m_ledger.append(it.key(), LedgerEntryType::Charge, -it.value(), sequence);
+            return true;
+        });
+        if (ok) {
+            ++applied;
+        }
+    }
+    batch.unlock();
+
+    if (applied > 0) {
+        invalidateOrdering(CardSortField::Balance);
+        if (notify) {
+            emit cardsChanged();
+        }
+    }
+    return applied;
+}
+
+RechargeBatchReport CardService::rechargeBatch(QIODevice* device, bool validateOnly) {
+    RechargeBatchReport report;
+
+    // 第一遍：流式校验，只保留有效行的卡号和金额
+    QList<RechargeRow> rows;
+    RechargeCsvReader reader(device);
+    RechargeRow row;
+    while (reader.readNext(row)) {
+        ++report.rows;
+        if (row.isValid() && !cardExists(row.cardId)) {
+            row.error = QStringLiteral("卡不存在");
+        }
+        if (!row.isValid()) {
+            report.errors.append({row.line, row.cardId, row.error});
+            continue;
+        }
+        report.total += row.amount;
+        rows.append(row);
+    }
+    report.validRows = static_cast<int>(rows.size());
+    if (validateOnly || !report.isClean() || rows.isEmpty()) {
+        return report;
+    }
+
+    // 第二遍：逐行充值，不逐行保存和通知
+    QWriteLocker batch(&m_batchLock);
+    for (const auto& valid : std::as_const(rows)) {
+        bool ok = modifyCard(valid.cardId, [&](Card& card) {
+            card.setBalance(card.balance() + valid.amount);
+            card.setTotalRecharge(card.totalRecharge() + valid.amount);
+            m_ledger.append(valid.cardId, LedgerEntryType::Recharge, valid.amount);
+            return true;
+        });
+        if (ok) {
+            ++report.applied;
+        } else {
+            report.errors.append({valid.line, valid.cardId, QStringLiteral("卡不存在")});
+        }
+    }
+    batch.unlock();
+
+    if (report.applied > 0) {
+        invalidateOrdering(CardSortField::Balance);
+        invalidateOrdering(CardSortField::TotalRecharge);
+        report.saved = saveAll();
+        emit cardsChanged();
+    }
+    return report;
+}
+
+quint64 CardService::maxJournalSequence() const {
+    quint64 sequence = 0;
+    for (const auto& shard : m_shards) {
+        QReadLocker locker(&shard.lock);
+        for (const auto& card : shard.cards) {
+            sequence = qMax(sequence, card.journalSequence());
+        }
+    }
+    return sequence;
+}
+
+Money CardService::getBalance(const QString& cardId) const {
+    const Shard& shard = shardOf(cardId);
+    QReadLocker locker(&shard.lock);
+    auto it = shard.cards.find(cardId);
+    if (it != shard.cards.end()) {
         return it.value().balance();
     }
-    return -1.0;
+    return Money::fromCents(-1);
 }
 
 // ========== 状态管理操作 ==========
 
 bool CardService::reportLost(const QString& cardId) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+    bool found = modifyCard(cardId, [&](Card& card) {
+        changeState(card, CardState::Lost);
+        return true;
+    });
+    if (!found) {
         return false;
     }
 
-    card->setState(CardState::Lost);
-
     // 保存并发出信号
     saveAll();
     emit cardUpdated(cardId);
@@ -180,18 +636,18 @@ bool CardService::reportLost(const QString& cardId) {
 }
 
 bool CardService::cancelLost(const QString& cardId) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
-        return false;
-    }
-
-    // 只有挂失状态才能解除
-    if (card->state() != CardState::Lost) {
+    bool changed = modifyCard(cardId, [&](Card& card) {
+        // 只有挂失状态才能解除
+        if (card.state() != CardState::Lost) {
+            return false;
+        }
+        changeState(card, CardState::Normal);
+        return true;
+    });
+    if (!changed) {
         return false;
     }
 
-    card->setState(CardState::Normal);
-
     // 保存并发出信号
     saveAll();
     emit cardUpdated(cardId);
@@ -200,13 +656,14 @@ bool CardService::cancelLost(const QString& cardId) {
 }
 
 bool CardService::freeze(const QString& cardId) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+    bool found = modifyCard(cardId, [&](Card& card) {
+        changeState(card, CardState::Frozen);
+        return true;
+    });
+    if (!found) {
         return false;
     }
 
-    card->setState(CardState::Frozen);
-
     // 保存并发出信号
     saveAll();
     emit cardUpdated(cardId);
@@ -215,14 +672,15 @@ bool CardService::freeze(const QString& cardId) {
 }
 
 bool CardService::unfreeze(const QString& cardId) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+    bool found = modifyCard(cardId, [&](Card& card) {
+        changeState(card, CardState::Normal);
+        clearLoginAttempts(card);  // 同时重置错误计数
+        return true;
+    });
+    if (!found) {
         return false;
     }
 
-    card->setState(CardState::Normal);
-    card->setLoginAttempts(0);  // 同时重置错误计数
-
     // 保存并发出信号
     saveAll();
     emit cardUpdated(cardId);
@@ -230,11 +688,72 @@ bool CardService::unfreeze(const QString& cardId) {
     return true;
 }
 
+// ========== 批量状态操作 ==========
+
+CardBatchResult CardService::reportLostBatch(const CardQuery& query) {
+    return modifyMatching(query, [&](Card& card) {
+        if (card.state() == CardState::Lost) {
+            return false;
+        }
+        changeState(card, CardState::Lost);
+        return true;
+    });
+}
+
+CardBatchResult CardService::reportLostBatch(const QStringList& cardIds) {
+    return reportLostBatch(CardQuery().cards(cardIds));
+}
+
+CardBatchResult CardService::cancelLostBatch(const CardQuery& query) {
+    return modifyMatching(query, [&](Card& card) {
+        if (card.state() != CardState::Lost) {
+            return false;
+        }
+        changeState(card, CardState::Normal);
+        return true;
+    });
+}
+
+CardBatchResult CardService::cancelLostBatch(const QStringList& cardIds) {
+    return cancelLostBatch(CardQuery().cards(cardIds));
+}
+
+CardBatchResult CardService::freezeBatch(const CardQuery& query) {
+    return modifyMatching(query, [&](Card& card) {
+        if (card.state() == CardState::Frozen) {
+            return false;
+        }
+        changeState(card, CardState::Frozen);
+        return true;
+    });
+}
+
+CardBatchResult CardService::freezeBatch(const QStringList& cardIds) {
+    return freezeBatch(CardQuery().cards(cardIds));
+}
+
+CardBatchResult CardService::unfreezeBatch(const CardQuery& query) {
+    return modifyMatching(query, [&](Card& card) {
+        if (card.state() != CardState::Frozen) {
+            return false;
+        }
+        changeState(card, CardState::Normal);
+        clearLoginAttempts(card);
+        return true;
+    });
+}
+
+CardBatchResult CardService::unfreezeBatch(const QStringList& cardIds) {
+    return unfreezeBatch(CardQuery().cards(cardIds));
+}
+
 // ========== 密码管理 ==========
 
 bool CardService::verifyPassword(const QString& cardId, const QString& password) const {
-    auto it = m_cards.find(cardId);
-    if (it != m_cards.end()) {
+    const Shard& shard = shardOf(cardId);
+    QReadLocker locker(&shard.lock);
+    auto it = shard.cards.find(cardId);
+    if (it != shard.cards.end()) {
         return it.value().password() == password;
     }
     return false;
@@ -242,19 +761,20 @@ bool CardService::verifyPassword(const QString& cardId, const QString& password)
 
 bool CardService::changePassword(const QString& cardId, const QString& oldPassword,
                                   const QString& newPassword) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
-        return false;
-    }
+    bool changed = modifyCard(cardId, [&](Card& card) {
+        // 验证旧密码
+        if (card.password() != oldPassword) {
+            return false;
+        }
 
-    // 验证旧密码
-    if (card->password() != oldPassword) {
+        // 设置新密码
+        card.setPassword(newPassword);
+        return true;
+    });
+    if (!changed) {
         return false;
     }
 
-    // 设置新密码
-    card->setPassword(newPassword);
-
     // 保存
     saveAll();
     emit cardUpdated(cardId);
@@ -262,18 +782,23 @@ bool CardService::changePassword(const QString& cardId, const QString& oldPasswo
 }
 
 bool CardService::resetPassword(const QString& cardId, const QString& newPassword) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+    bool unfrozen = false;
+    bool found = modifyCard(cardId, [&](Card& card) {
+        // 设置新密码并重置登录失败计数
+        card.setPassword(newPassword);
+        clearLoginAttempts(card);
+
+        // 如果卡被冻结，自动解冻
+        if (card.state() == CardState::Frozen) {
+            changeState(card, CardState::Normal);
+            unfrozen = true;
+        }
+        return true;
+    });
+    if (!found) {
         return false;
     }
-
-    // 设置新密码并重置登录失败计数
-    card->setPassword(newPassword);
-    card->setLoginAttempts(0);
-
-    // 如果卡被冻结，自动解冻
-    if (card->state() == CardState::Frozen) {
-        card->setState(CardState::Normal);
+    if (unfrozen) {
         emit cardStateChanged(cardId, CardState::Normal);
     }
 
@@ -283,20 +808,54 @@ bool CardService::resetPassword(const QString& cardId, const QString& newPasswor
     return true;
 }
 
+CardBatchResult CardService::resetPasswordBatch(const CardQuery& query,
+                                                const QString& newPassword) {
+    if (newPassword.isEmpty()) {
+        return CardBatchResult();
+    }
+    return modifyMatching(query, [&](Card& card) {
+        card.setPassword(newPassword);
+        clearLoginAttempts(card);
+        if (card.state() == CardState::Frozen) {
+            changeState(card, CardState::Normal);
+        }
+        return true;
+    });
+}
+
+CardBatchResult CardService::resetPasswordBatch(const QStringList& cardIds,
+                                                const QString& newPassword) {
+    return resetPasswordBatch(CardQuery().cards(cardIds), newPassword);
+}
+
 // ========== 登录尝试管理 ==========
 
 int CardService::incrementLoginAttempts(const QString& cardId) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+    if (!cardExists(cardId)) {
         return -1;
     }
 
-    int attempts = card->loginAttempts() + 1;
-    card->setLoginAttempts(attempts);
+    // 只在内存中计数，未达到最大次数时不写文件
+    const int attempts = m_loginAttempts.recordFailure(cardId, m_clock->nowMSecs());
+    if (attempts < MAX_LOGIN_ATTEMPTS) {
+        return attempts;
+    }
 
-    // 达到最大次数自动冻结
-    if (attempts >= MAX_LOGIN_ATTEMPTS) {
-        card->setState(CardState::Frozen);
+    // 达到最大次数自动冻结，状态变化立即保存
+    bool frozen = false;
+    bool found = modifyCard(cardId, [&](Card& card) {
+        card.setLoginAttempts(attempts);
+        m_loginAttempts.discard(cardId);
+        if (!card.isFrozen()) {
+            changeState(card, CardState::Frozen);
+            frozen = true;
+        }
+        return true;
+    });
+    if (!found) {
+        return -1;
+    }
+    if (frozen) {
         emit cardStateChanged(cardId, CardState::Frozen);
     }
 
@@ -306,35 +865,314 @@ int CardService::incrementLoginAttempts(const QString& cardId) {
 }
 
 bool CardService::resetLoginAttempts(const QString& cardId) {
-    Card* card = getCardPtr(cardId);
-    if (!card) {
+    if (!cardExists(cardId)) {
         return false;
     }
 
-    card->setLoginAttempts(0);
-    saveAll();
+    m_loginAttempts.reset(cardId);
     return true;
 }
 
 int CardService::getLoginAttempts(const QString& cardId) const {
-    auto it = m_cards.find(cardId);
-    if (it != m_cards.end()) {
-        return it.value().loginAttempts();
+    int saved = -1;
+    {
+        const Shard& shard = shardOf(cardId);
+        QReadLocker locker(&shard.lock);
+        auto it = shard.cards.find(cardId);
+        if (it == shard.cards.end()) {
+            return -1;
+        }
+        saved = it.value().loginAttempts();
+    }
+
+    // 内存中的计数比卡上保存的新
+    return m_loginAttempts.attempts(cardId, m_clock->nowMSecs()).value_or(saved);
+}
+
+void CardService::setLoginAttemptWindow(qint64 msecs) {
+    m_loginAttempts.setWindow(msecs);
+}
+
+int CardService::flushLoginAttempts() {
+    const QHash<QString, int> dirty = m_loginAttempts.takeDirty(m_clock->nowMSecs());
+    int changed = 0;
+    for (auto it = dirty.constBegin(); it != dirty.constEnd(); ++it) {
+        bool updated = modifyCard(it.key(), [&](Card& card) {
+            if (card.isFrozen() || card.loginAttempts() == it.value()) {
+                return false;
+            }
+            card.setLoginAttempts(it.value());
+            return true;
+        });
+        if (updated) {
+            ++changed;
+        }
+    }
+
+    // 计数不在界面上显示，只保存不发信号
+    if (changed > 0) {
+        saveAll();
     }
-    return -1;
+    return changed;
 }
 
 // ========== 卡信息更新 ==========
 
 bool CardService::updateCard(const Card& card) {
-    if (!cardExists(card.cardId())) {
+    bool found = modifyCard(card.cardId(), [&](Card& current) {
+        // 直接修改余额视为管理员调整
+        const Money delta = card.balance() - current.balance();
+        if (!delta.isZero()) {
+            m_ledger.append(card.cardId(), LedgerEntryType::Adjustment, delta);
+        }
+        // 改了状态却沿用旧的变更时间时，以当前时间为准
+        const bool restamp =
+            card.state() != current.state() && card.stateChangedAt() == current.stateChangedAt();
+        QWriteLocker indexLocker(&m_indexLock);
+        removeFromIndexes(current);
+        current = card;
+        if (restamp) {
+            current.setStateChangedAt(m_clock->now());
+        }
+        addToIndexes(card);
+        invalidateOrderings();
+        return true;
+    });
+    if (!found) {
         return false;
     }
 
-    m_cards[card.cardId()] = card;
     saveAll();
     emit cardUpdated(card.cardId());
     return true;
 }
 
+// ========== 余额流水 ==========
+
+void CardService::setClock(Clock* clock) {
+    m_clock = clock ? clock : Clock::system();
+    m_ledger.setClock(clock);
+}
+
+QList<LedgerEntry> CardService::getStatement(const QString& cardId, const QDate& from,
+                                             const QDate& to) const {
+    return m_ledger.statement(cardId, from, to);
+}
+
+ReconciliationReport CardService::reconcileLedger() const {
+    QList<Card> cards;
+    QHash<QString, QList<LedgerEntry>> accounts;
+    ledgerSnapshot(cards, accounts);
+    return BalanceLedger::reconcile(cards, accounts);
+}
+
+QFuture<ReconciliationReport> CardService::reconcileLedgerAsync(QThreadPool* pool) const {
+    QList<Card> cards;
+    QHash<QString, QList<LedgerEntry>> accounts;
+    ledgerSnapshot(cards, accounts);
+    return BalanceLedger::reconcileAsync(cards, accounts, pool);
+}
+
+void CardService::ledgerSnapshot(QList<Card>& cards,
+                                 QHash<QString, QList<LedgerEntry>>& accounts) const {
+    // 按固定顺序锁住所有分片，期间没有进行中的记账
+    for (const auto& shard : m_shards) {
+        shard.lock.lockForRead();
+    }
+    cards.clear();
+    for (const auto& shard : m_shards) {
+        for (const auto& card : shard.cards) {
+            cards.append(card);
+        }
+    }
+    accounts = m_ledger.accounts();
+    for (const auto& shard : m_shards) {
+        shard.lock.unlock();
+    }
+}
+
+// ========== 排序 ==========
+
+QStringList CardService::sortedCardIds(CardSortField field) const {
+    return ordering(field).cardIds;
+}
+
+void CardService::sortCards(QList<Card>& cards, CardSortField field, bool descending) const {
+    const QHash<QString, int> rank = ordering(field).rank;
+    QList<std::pair<int, Card>> ranked;
+    ranked.reserve(cards.size());
+    for (const auto& card : cards) {
+        ranked.append({rank.value(card.cardId(), -1), card});
+    }
+    std::sort(ranked.begin(), ranked.end(), [descending](const auto& a, const auto& b) {
+        return descending ? a.first > b.first : a.first < b.first;
+    });
+
+    cards.clear();
+    for (const auto& entry : ranked) {
+        cards.append(entry.second);
+    }
+}
+
+CardService::Ordering CardService::ordering(CardSortField field) const {
+    const int column = static_cast<int>(field);
+    {
+        QMutexLocker locker(&m_orderingMutex);
+        const Ordering& cached = m_orderings[column];
+        if (cached.valid && cached.version == m_orderingVersions[column].load()) {
+            return cached;
+        }
+    }
+
+    // 先记下列版本再取快照：取快照期间的修改会使版本增加，建立的结果不会被当作最新
+    const quint64 version = m_orderingVersions[column].load();
+    const QList<Card> cards = getAllCards();
+    QHash<QString, NameKey> nameKeys;
+    if (field == CardSortField::Name) {
+        // 快照中的卡在加入分片时已计算排序键，因此之后复制的排序键表一定包含它们
+        QReadLocker locker(&m_indexLock);
+        nameKeys = m_nameKeys;
+    }
+
+    QList<const Card*> sorted;
+    sorted.reserve(cards.size());
+    for (const auto& card : cards) {
+        sorted.append(&card);
+    }
+
+    // 各列的值相同时都按卡号排序，使结果稳定
+    auto byField = [&nameKeys, field](const Card* a, const Card* b) {
+        switch (field) {
+        case CardSortField::Name: {
+            const QCollatorSortKey& keyA = nameKeys.constFind(a->cardId()).value().key;
+            const QCollatorSortKey& keyB = nameKeys.constFind(b->cardId()).value().key;
+            const int order = keyA.compare(keyB);
+            if (order != 0) {
+                return order < 0;
+            }
+            break;
+        }
+        case CardSortField::StudentId:
+            if (a->studentId() != b->studentId()) {
+                return a->studentId() < b->studentId();
+            }
+            break;
+        case CardSortField::Balance:
+            if (a->balance() != b->balance()) {
+                return a->balance() < b->balance();
+            }
+            break;
+        case CardSortField::State:
+            if (a->state() != b->state()) {
+                return a->state() < b->state();
+            }
+            break;
+        case CardSortField::TotalRecharge:
+            if (a->totalRecharge() != b->totalRecharge()) {
+                return a->totalRecharge() < b->totalRecharge();
+            }
+            break;
+        default:
+            break;
+        }
+        return a->cardId() < b->cardId();
+    };
+    std::sort(sorted.begin(), sorted.end(), byField);
+
+    Ordering built;
+    built.version = version;
+    built.valid = true;
+    built.cardIds.reserve(sorted.size());
+    built.rank.reserve(sorted.size());
+    for (const Card* card : sorted) {
+        built.rank.insert(card->cardId(), static_cast<int>(built.cardIds.size()));
+        built.cardIds.append(card->cardId());
+    }
+
+    QMutexLocker locker(&m_orderingMutex);
+    Ordering& cached = m_orderings[column];
+    if (!cached.valid || cached.version <= version) {
+        cached = built;
+    }
+    return built;
+}
+
+void CardService::invalidateOrdering(CardSortField field) {
+    m_orderingVersions[static_cast<int>(field)].fetch_add(1);
+}
+
+void CardService::invalidateOrderings() {
+    for (auto& version : m_orderingVersions) {
+        version.fetch_add(1);
+    }
+}
+
+// ========== 分片 ==========
+
+CardService::Shard& CardService::shardOf(const QString& cardId) {
+    return m_shards[qHash(cardId) % SHARD_COUNT];
+}
+
+const CardService::Shard& CardService::shardOf(const QString& cardId) const {
+    return m_shards[qHash(cardId) % SHARD_COUNT];
+}
+
+QHash<QString, Card> CardService::shardSnapshot(int index) const {
+    // 隐式共享，加锁期间只复制引用；之后该分片的写入者负责分离
+    QReadLocker locker(&m_shards[index].lock);
+    return m_shards[index].cards;
+}
+
+// ========== 二级索引 ==========
+
+void CardService::addToIndexes(const Card& card) {
+    m_byStudentId.insert(card.studentId(), card.cardId());
+    m_byState[card.state()].insert(card.cardId());
+    m_byName.insert(normalizeName(card.name()), card.cardId());
+    m_searchIndex.insert(card);
+
+    // 只在新卡或改名时计算排序键
+    auto key = m_nameKeys.find(card.cardId());
+    if (key == m_nameKeys.end()) {
+        m_nameKeys.insert(card.cardId(),
+                          NameKey{card.name(), m_collator.sortKey(card.name())});
+    } else if (key.value().name != card.name()) {
+        key.value() = NameKey{card.name(), m_collator.sortKey(card.name())};
+    }
+}
+
+void CardService::removeFromIndexes(const Card& card) {
+    m_byStudentId.remove(card.studentId(), card.cardId());
+    m_byState[card.state()].remove(card.cardId());
+    m_byName.remove(normalizeName(card.name()), card.cardId());
+}
+
+void CardService::clearLoginAttempts(Card& card) {
+    card.setLoginAttempts(0);
+    m_loginAttempts.discard(card.cardId());
+}
+
+void CardService::changeState(Card& card, CardState state) {
+    if (card.state() != state) {
+        card.setStateChangedAt(m_clock->now());
+    }
+    QWriteLocker locker(&m_indexLock);
+    m_byState[card.state()].remove(card.cardId());
+    card.setState(state);
+    m_byState[state].insert(card.cardId());
+    invalidateOrdering(CardSortField::State);
+}
+
+QList<Card> CardService::cardsSortedById(const QStringList& cardIds) const {
+    QStringList sorted = cardIds;
+    std::sort(sorted.begin(), sorted.end());
+
+    QList<Card> cards;
+    cards.reserve(sorted.size());
+    for (const auto& cardId : sorted) {
+        cards.append(findCard(cardId));
+    }
+    return cards;
+}
+
 }  // namespace CampusCard
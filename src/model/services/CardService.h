@@ -5,7 +5,12 @@
  * @date 2024
  *
  * MVC架构 - Model层业务服务
- * 负责校园卡相关的业务逻辑处理
+ * 负责校园卡相关的业务逻辑处理；卡按卡号存放在哈希表中，
+ * 另有学号、状态和姓名三个二级索引以及卡号、学号、姓名的子串搜索索引，
+ * 并缓存姓名的排序键和按各列排好序的卡号顺序；卡按卡号哈希分片加读写锁，可被多线程同时使用。
+ * 每笔余额变动都记入只追加的流水账，卡上的余额是流水的物化结果；
+ * 挂失、冻结等状态操作和重置密码另有按卡号列表或组合查询批量执行的版本；
+ * 登录失败计数保存在内存中并定期写回，登录不再等待磁盘
  */
 
 #ifndef MODEL_SERVICES_CARDSERVICE_H
@@ -13,14 +18,55 @@
 
 #include "model/entities/Card.h"
 #include "model/repositories/StorageManager.h"
-
+#include "model/services/BalanceLedger.h"
+#include "model/services/CardQuery.h"
+#include "model/services/CardSearchIndex.h"
+#include "model/services/LoginAttemptTracker.h"
+#include "model/services/RechargeBatch.h"
+
+#include <QCollator>
+#include <QDate>
+#include <QFuture>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QMultiHash>
+#include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
+
+#include <array>
+#include <atomic>
+#include <functional>
 
 
 namespace CampusCard {
 
+/**
+ * @enum CardSortField
+ * @brief 卡列表的排序列（顺序与管理员卡表格的列一致）
+ */
+enum class CardSortField {
+    CardId = 0,     ///< 卡号
+    Name,           ///< 姓名（按中文排序规则）
+    StudentId,      ///< 学号
+    Balance,        ///< 余额
+    State,          ///< 状态
+    TotalRecharge,  ///< 累计充值
+    Count           ///< 排序列数
+};
+
+/**
+ * @struct CardBatchResult
+ * @brief 批量卡操作结果
+ */
+struct CardBatchResult {
+    QStringList changed;  ///< 实际修改的卡号（按卡号排序）
+    bool saved = false;   ///< 修改后是否已保存（没有修改时为false）
+};
+
 /**
  * @class CardService
  * @brief 校园卡业务服务类，处理卡相关的业务逻辑
@@ -31,6 +77,23 @@ namespace CampusCard {
  * - 挂失、解挂、冻结、解冻业务逻辑
  * - 密码管理
  * - 通过信号通知状态变更
+ *
+ * 学号、状态和姓名索引在每个修改这些字段的操作中同步更新，
+ * 因此按学号查找为O(1)，按状态或姓名查找为O(结果数)。
+ *
+ * 姓名的QCollator排序键在卡加入或改名时计算一次；各列的排序结果在第一次使用时
+ * 建立并缓存，只有修改该列的操作才使其失效，因此切换排序列不会重新计算排序规则。
+ *
+ * 线程安全：卡按卡号哈希分布在SHARD_COUNT个分片中，每个分片有自己的读写锁，
+ * 不同分片上的读写互不阻塞；单卡操作的检查和修改在同一次加锁内完成。
+ * 二级索引、搜索索引和排序键由一把索引锁保护，只在建卡、改卡和状态变化时加写锁。
+ * 查询返回卡的副本，整体查询先在锁内复制各分片（隐式共享，只复制引用）再在锁外遍历。
+ * 批量修改在批量锁的写锁内逐卡修改，cardShards()持批量锁的读锁复制，看不到改了一半的批次。
+ * 加锁顺序固定为 保存锁 → 批量锁 → 分片锁（按下标）→ 索引锁；信号在释放锁之后发出。
+ *
+ * 登录失败计数由LoginAttemptTracker在内存中维护，输错密码不再重写卡文件；
+ * 只有达到最大次数而冻结时立即保存，其余计数由flushLoginAttempts()定期批量写回。
+ * 计数表有自己的锁，排在加锁顺序的最后。
  */
 class CardService : public QObject {
     Q_OBJECT
@@ -62,31 +125,93 @@ public:
 
     /**
      * @brief 获取所有校园卡
-     * @return 卡列表
+     * @return 卡列表（按卡号排序）
      */
     [[nodiscard]] QList<Card> getAllCards() const;
 
     /**
-     * @brief 根据卡号查找卡
-     * @param cardId 卡号
-     * @return 卡对象（不存在返回空Card）
+     * @brief 一致地复制全部分片的卡（隐式共享，只复制引用）
+     *
+     * 持批量锁的读锁并按下标锁住全部分片后再复制，
+     * 批量充值、扣款和批量状态操作要么全部可见、要么全部不可见
+     * @return 各分片的卡
      */
-    [[nodiscard]] Card findCard(const QString& cardId) const;
+    [[nodiscard]] QList<QHash<QString, Card>> cardShards() const;
 
     /**
-     * @brief 根据卡号获取卡指针（用于修改）
+     * @brief 根据卡号查找卡
      * @param cardId 卡号
-     * @return 卡指针（不存在返回nullptr）
+     * @return 卡对象（不存在返回空Card）
      */
-    Card* getCardPtr(const QString& cardId);
+    [[nodiscard]] Card findCard(const QString& cardId) const;
 
     /**
      * @brief 根据学号查找卡
      * @param studentId 学号
-     * @return 卡对象
+     * @return 卡对象（同一学号有多张卡时返回卡号最小的一张，不存在返回空Card）
      */
     [[nodiscard]] Card findCardByStudentId(const QString& studentId) const;
 
+    /**
+     * @brief 获取指定状态的所有卡
+     * @param state 卡状态
+     * @return 卡列表（按卡号排序）
+     */
+    [[nodiscard]] QList<Card> findCardsByState(CardState state) const;
+
+    /**
+     * @brief 获取指定状态的卡数量
+     * @param state 卡状态
+     * @return 卡数量
+     */
+    [[nodiscard]] int countCardsByState(CardState state) const;
+
+    /**
+     * @brief 根据姓名查找卡（忽略大小写和多余空白）
+     * @param name 姓名
+     * @return 卡列表（按卡号排序）
+     */
+    [[nodiscard]] QList<Card> findCardsByName(const QString& name) const;
+
+    /**
+     * @brief 按组合条件查找卡号
+     *
+     * 限定了卡号或状态时只检查对应的卡，否则检查所有卡；状态持续天数按本服务的时钟计算
+     * @param query 查询条件
+     * @return 卡号列表（按卡号排序）
+     */
+    [[nodiscard]] QStringList findCardIds(const CardQuery& query) const;
+
+    /**
+     * @brief 按卡号、学号或姓名的子串搜索（忽略大小写）
+     * @param keyword 关键词（为空时返回所有卡）
+     * @param limit 最多返回的结果数（负数表示不限）
+     * @return 卡列表（完全匹配在前，其次是前缀匹配，同档按卡号排序）
+     */
+    [[nodiscard]] QList<Card> searchCards(const QString& keyword, int limit = -1) const;
+
+    /**
+     * @brief 按列排好序的所有卡号（升序，值相同时按卡号）
+     * @param field 排序列
+     * @return 卡号列表
+     */
+    [[nodiscard]] QStringList sortedCardIds(CardSortField field) const;
+
+    /**
+     * @brief 按列对一组卡排序（使用缓存的排序结果，不比较字段本身）
+     * @param cards 卡列表（就地排序，应为本服务中的卡）
+     * @param field 排序列
+     * @param descending 是否降序
+     */
+    void sortCards(QList<Card>& cards, CardSortField field, bool descending = false) const;
+
+    /**
+     * @brief 姓名的索引键：去掉首尾空白、合并连续空白并折叠大小写
+     * @param name 姓名
+     * @return 索引键
+     */
+    [[nodiscard]] static QString normalizeName(const QString& name);
+
     /**
      * @brief 检查卡号是否存在
      * @param cardId 卡号
@@ -111,7 +236,7 @@ public:
      * @return 是否成功
      */
     bool createCard(const QString& cardId, const QString& name, const QString& studentId,
-                    double initialBalance = 0.0);
+                    Money initialBalance = Money());
 
     /**
      * @brief 创建新卡（使用Card对象）
@@ -128,7 +253,7 @@ public:
      * @param amount 充值金额
      * @return 是否成功
      */
-    bool recharge(const QString& cardId, double amount);
+    bool recharge(const QString& cardId, Money amount);
 
     /**
      * @brief 扣款
@@ -136,14 +261,134 @@ public:
      * @param amount 扣款金额
      * @return 是否成功
      */
-    bool deduct(const QString& cardId, double amount);
+    bool deduct(const QString& cardId, Money amount);
+
+    /**
+     * @brief 检查扣款是否可以执行（卡存在、可用、金额为正且余额充足）
+     * @param cardId 卡号
+     * @param amount 扣款金额
+     * @return 是否可以扣款
+     */
+    [[nodiscard]] bool canDeduct(const QString& cardId, Money amount) const;
+
+    /**
+     * @brief 在卡所在分片的写锁内决定扣款、提交并扣款（只更新内存，由事务管理器负责持久化）
+     *
+     * 按分片序号锁住涉及的全部分片，逐卡按canDeduct()的规则决定实际扣款金额，
+     * 交给commit写入事务日志；commit成功后在同一次加锁内扣款并记录序号。
+     * 从决定到扣款之间其他扣款、冻结、挂失或updateCard()都无法插入，
+     * 因此日志中的决定就是实际生效的扣款，不会透支或扣到不可用的卡。
+     * commit在分片写锁内执行，不应再调用本对象的方法
+     * @param costs 卡号到应扣金额的映射
+     * @param sequence 事务日志序号（同一批次共用）
+     * @param commit 提交回调，参数为卡号到实际扣款金额的映射（不扣款的卡为0），返回是否已提交
+     * @return commit是否成功（失败时没有任何修改）
+     */
+    bool commitDeducts(const QMap<QString, Money>& costs, quint64 sequence,
+                       const std::function<bool(const QMap<QString, Money>&)>& commit);
+
+    /**
+     * @brief 重放一条事务日志中的扣款（只更新内存，由事务管理器负责持久化）
+     *
+     * 扣款决定已随日志提交，这里不再校验；
+     * 序号不大于卡上已记录的序号时说明该扣款已生效，直接忽略，因此重放是幂等的
+     * @param cardId 卡号
+     * @param amount 扣款金额
+     * @param sequence 事务日志序号
+     * @param notify 是否发出信号（为false时由调用方在释放自己的锁后调用notifyBalanceChanged()）
+     * @return 是否实际扣款
+     */
+    bool applyJournaledDeduct(const QString& cardId, Money amount, quint64 sequence,
+                              bool notify = true);
+
+    /**
+     * @brief 批量扣款（一次写入卡文件，只发出一次cardsChanged信号）
+     * @param amounts 卡号到扣款金额的映射（不满足扣款条件的卡被跳过）
+     * @return 实际扣款的卡号
+     */
+    QStringList deductBatch(const QMap<QString, Money>& amounts);
+
+    /**
+     * @brief 重放一条批量事务日志中的扣款（只更新内存，只发出一次cardsChanged信号）
+     * @param amounts 卡号到扣款金额的映射
+     * @param sequence 事务日志序号（同一批次共用）
+     * @param notify 是否发出信号（为false时由调用方在释放自己的锁后调用notifyCardsChanged()）
+     * @return 实际扣款的卡数
+     */
+    int applyJournaledDeducts(const QMap<QString, Money>& amounts, quint64 sequence,
+                              bool notify = true);
+
+    /**
+     * @brief 为单张卡的余额变化发出cardUpdated和balanceChanged信号（余额取当前值）
+     * @param cardId 卡号
+     */
+    void notifyBalanceChanged(const QString& cardId);
+
+    /**
+     * @brief 发出cardsChanged信号
+     */
+    void notifyCardsChanged();
+
+    /**
+     * @brief 从充值文件批量充值（一次写入卡文件，只发出一次cardsChanged信号）
+     *
+     * 先流式读取并校验每一行（格式、金额、卡是否存在），任一行无效时不充值任何一行，
+     * 修正文件后可整体重新提交而不会重复充值；全部有效时逐行充值并记入流水，最后保存一次。
+     * 同一张卡出现在多行时每行各充值一次。
+     * @param device 已打开的充值文件（格式见RechargeCsvReader）
+     * @param validateOnly 是否只校验不充值
+     * @return 批量充值结果
+     */
+    RechargeBatchReport rechargeBatch(QIODevice* device, bool validateOnly = false);
+
+    /**
+     * @brief 所有卡中最大的事务日志序号
+     * @return 序号（没有时为0）
+     */
+    [[nodiscard]] quint64 maxJournalSequence() const;
 
     /**
      * @brief 获取卡余额
      * @param cardId 卡号
-     * @return 余额（卡不存在返回-1）
+     * @return 余额（卡不存在返回负值）
+     */
+    [[nodiscard]] Money getBalance(const QString& cardId) const;
+
+    // ========== 余额流水 ==========
+
+    /**
+     * @brief 设置时钟（流水的记账时间和卡状态的变更时间取自该时钟，应在并发使用前设置）
+     * @param clock 时钟（为空时使用系统时钟；调用方保证其生命周期）
+     */
+    void setClock(Clock* clock);
+
+    /**
+     * @brief 卡的对账单
+     * @param cardId 卡号
+     * @param from 起始日期（含，无效表示不限）
+     * @param to 结束日期（含，无效表示不限）
+     * @return 流水（按序号递增）
      */
-    [[nodiscard]] double getBalance(const QString& cardId) const;
+    [[nodiscard]] QList<LedgerEntry> getStatement(const QString& cardId,
+                                                  const QDate& from = QDate(),
+                                                  const QDate& to = QDate()) const;
+
+    /**
+     * @brief 核对每张卡的余额与其流水合计（串行）
+     * @return 对账报告
+     */
+    [[nodiscard]] ReconciliationReport reconcileLedger() const;
+
+    /**
+     * @brief 在线程池中并行对账
+     *
+     * 卡与流水在调用时刻一次性复制（持有全部分片的读锁，只复制引用），
+     * 之后的充值扣款不影响本次对账
+     * @param pool 线程池（nullptr表示全局线程池）
+     * @return 对账报告的QFuture
+     */
+    [[nodiscard]] QFuture<ReconciliationReport> reconcileLedgerAsync(
+        QThreadPool* pool = nullptr) const;
 
     // ========== 状态管理操作 ==========
 
@@ -175,6 +420,44 @@ public:
      */
     bool unfreeze(const QString& cardId);
 
+    // ========== 批量状态操作 ==========
+    //
+    // 按卡号列表或组合查询批量执行，只在内存中逐张修改，最后保存一次、只发出一次cardsChanged。
+    // 候选卡在各自分片的写锁内复核查询条件，不满足条件或无需修改的卡被跳过；
+    // 返回实际修改的卡号（按卡号排序）以及保存是否成功，保存失败时修改仍保留在内存中。
+
+    /**
+     * @brief 批量挂失（已挂失的卡被跳过）
+     * @param query 目标卡
+     * @return 实际挂失的卡号和保存结果
+     */
+    CardBatchResult reportLostBatch(const CardQuery& query);
+    CardBatchResult reportLostBatch(const QStringList& cardIds);
+
+    /**
+     * @brief 批量解除挂失（只处理挂失状态的卡）
+     * @param query 目标卡
+     * @return 实际解挂的卡号和保存结果
+     */
+    CardBatchResult cancelLostBatch(const CardQuery& query);
+    CardBatchResult cancelLostBatch(const QStringList& cardIds);
+
+    /**
+     * @brief 批量冻结（已冻结的卡被跳过）
+     * @param query 目标卡
+     * @return 实际冻结的卡号和保存结果
+     */
+    CardBatchResult freezeBatch(const CardQuery& query);
+    CardBatchResult freezeBatch(const QStringList& cardIds);
+
+    /**
+     * @brief 批量解冻并重置错误计数（只处理冻结状态的卡，挂失的卡不会被解除）
+     * @param query 目标卡
+     * @return 实际解冻的卡号和保存结果
+     */
+    CardBatchResult unfreezeBatch(const CardQuery& query);
+    CardBatchResult unfreezeBatch(const QStringList& cardIds);
+
     // ========== 密码管理 ==========
 
     /**
@@ -203,17 +486,30 @@ public:
      */
     bool resetPassword(const QString& cardId, const QString& newPassword);
 
+    /**
+     * @brief 批量重置密码（同时重置错误计数，冻结的卡自动解冻；一次保存）
+     * @param query 目标卡
+     * @param newPassword 新密码（为空时不做任何修改）
+     * @return 实际重置的卡号和保存结果
+     */
+    CardBatchResult resetPasswordBatch(const CardQuery& query, const QString& newPassword);
+    CardBatchResult resetPasswordBatch(const QStringList& cardIds,
+                                       const QString& newPassword);
+
     // ========== 登录尝试管理 ==========
 
+    /// 登录失败计数的建议写回间隔（毫秒）
+    static constexpr int LOGIN_ATTEMPT_FLUSH_MSECS = 30 * 1000;
+
     /**
-     * @brief 增加登录失败次数
+     * @brief 增加登录失败次数（只在内存中计数，达到最大次数时冻结并立即保存）
      * @param cardId 卡号
-     * @return 当前失败次数（-1表示卡不存在）
+     * @return 时间窗口内的失败次数（-1表示卡不存在）
      */
     int incrementLoginAttempts(const QString& cardId);
 
     /**
-     * @brief 重置登录失败次数
+     * @brief 重置登录失败次数（只在内存中清零，随下次写回持久化）
      * @param cardId 卡号
      * @return 是否成功
      */
@@ -222,10 +518,24 @@ public:
     /**
      * @brief 获取登录失败次数
      * @param cardId 卡号
-     * @return 失败次数（-1表示卡不存在）
+     * @return 时间窗口内的失败次数（-1表示卡不存在）
      */
     [[nodiscard]] int getLoginAttempts(const QString& cardId) const;
 
+    /**
+     * @brief 设置登录失败计数的时间窗口
+     * @param msecs 距最近一次失败超过该毫秒数后计数归零（不大于0表示不衰减）
+     */
+    void setLoginAttemptWindow(qint64 msecs);
+
+    /**
+     * @brief 将变化过的登录失败计数写回卡上，有变化时保存一次
+     *
+     * 冻结的卡的计数由冻结和解冻操作维护，不被写回的计数覆盖
+     * @return 计数有变化的卡数
+     */
+    int flushLoginAttempts();
+
     // ========== 卡信息更新 ==========
 
     /**
@@ -258,7 +568,7 @@ signals:
      * @param cardId 卡号
      * @param newBalance 新余额
      */
-    void balanceChanged(const QString& cardId, double newBalance);
+    void balanceChanged(const QString& cardId, Money newBalance);
 
     /**
      * @brief 卡状态变更信号
@@ -267,8 +577,158 @@ signals:
      */
     void cardStateChanged(const QString& cardId, CardState newState);
 
+    /// 卡分片数
+    static constexpr int SHARD_COUNT = 16;
+
 private:
-    QMap<QString, Card> m_cards;  ///< 卡号到卡对象的映射
+    /**
+     * @struct Shard
+     * @brief 卡分片
+     */
+    struct Shard {
+        mutable QReadWriteLock lock;  ///< 分片读写锁
+        QHash<QString, Card> cards;   ///< 卡号到卡对象的映射
+    };
+
+    /**
+     * @struct NameKey
+     * @brief 姓名及其排序键
+     */
+    struct NameKey {
+        QString name;          ///< 计算排序键时的姓名
+        QCollatorSortKey key;  ///< 排序键
+    };
+
+    /**
+     * @struct Ordering
+     * @brief 一列的排序结果
+     */
+    struct Ordering {
+        bool valid = false;        ///< 是否已建立
+        quint64 version = 0;       ///< 建立时的列版本
+        QStringList cardIds;       ///< 升序排列的卡号
+        QHash<QString, int> rank;  ///< 卡号到名次
+    };
+
+    /**
+     * @brief 取得某列的排序结果，列版本变化后重新建立
+     * @param field 排序列
+     * @return 排序结果（副本，隐式共享）
+     */
+    Ordering ordering(CardSortField field) const;
+
+    /**
+     * @brief 使某列的排序结果失效
+     * @param field 排序列
+     */
+    void invalidateOrdering(CardSortField field);
+
+    /**
+     * @brief 使所有列的排序结果失效
+     */
+    void invalidateOrderings();
+
+    /**
+     * @brief 卡号所在的分片
+     * @param cardId 卡号
+     * @return 分片
+     */
+    Shard& shardOf(const QString& cardId);
+    const Shard& shardOf(const QString& cardId) const;
+
+    /**
+     * @brief 在读锁内复制一个分片
+     * @param index 分片下标
+     * @return 分片中的卡
+     */
+    [[nodiscard]] QHash<QString, Card> shardSnapshot(int index) const;
+
+    /**
+     * @brief 在卡所在分片的写锁内修改卡
+     * @param cardId 卡号
+     * @param mutate 修改函数，参数为Card&，返回是否修改
+     * @return 卡存在且mutate返回true
+     */
+    template <typename Mutator>
+    bool modifyCard(const QString& cardId, Mutator&& mutate);
+
+    /**
+     * @brief 逐张修改满足查询条件的卡，有修改时保存一次并发出cardsChanged
+     * @param query 查询条件（在卡所在分片的写锁内复核）
+     * @param mutate 修改函数，参数为Card&，返回是否修改
+     * @return 实际修改的卡号（按卡号排序）和保存结果
+     */
+    template <typename Mutator>
+    CardBatchResult modifyMatching(const CardQuery& query, Mutator&& mutate);
+
+    /**
+     * @brief 检查卡能否扣款（可用、金额为正且余额充足）
+     * @param card 卡对象
+     * @param amount 扣款金额
+     * @return 是否可以扣款
+     */
+    [[nodiscard]] static bool canDeductFrom(const Card& card, Money amount);
+
+    /**
+     * @brief 将卡加入二级索引（调用方持有索引写锁）
+     * @param card 卡对象
+     */
+    void addToIndexes(const Card& card);
+
+    /**
+     * @brief 将卡从二级索引中移除（调用方持有索引写锁）
+     * @param card 卡对象（使用其当前的学号、状态和姓名）
+     */
+    void removeFromIndexes(const Card& card);
+
+    /**
+     * @brief 清零卡上和内存中的登录失败计数（调用方持有卡所在分片的写锁）
+     * @param card 卡对象
+     */
+    void clearLoginAttempts(Card& card);
+
+    /**
+     * @brief 修改卡状态、记录变更时间并更新状态索引（调用方持有卡所在分片的写锁）
+     * @param card 卡对象
+     * @param state 新状态
+     */
+    void changeState(Card& card, CardState state);
+
+    /**
+     * @brief 按卡号取出卡并排序
+     * @param cardIds 卡号集合
+     * @return 卡列表（按卡号排序）
+     */
+    [[nodiscard]] QList<Card> cardsSortedById(const QStringList& cardIds) const;
+
+    /**
+     * @brief 一致地复制全部卡和流水
+     *
+     * 记账总在卡所在分片的写锁内进行，因此锁住全部分片后两者互相匹配
+     * @param cards 输出：全部卡
+     * @param accounts 输出：卡号到流水列表的映射
+     */
+    void ledgerSnapshot(QList<Card>& cards,
+                        QHash<QString, QList<LedgerEntry>>& accounts) const;
+
+    std::array<Shard, SHARD_COUNT> m_shards;     ///< 按卡号哈希分布的卡
+    mutable QReadWriteLock m_batchLock;          ///< 批量修改持写锁，cardShards()持读锁
+    mutable QReadWriteLock m_indexLock;          ///< 保护以下索引和排序键
+    QMultiHash<QString, QString> m_byStudentId;  ///< 学号到卡号的索引
+    QMap<CardState, QSet<QString>> m_byState;    ///< 状态到卡号集合的索引
+    QMultiHash<QString, QString> m_byName;       ///< 规范化姓名到卡号的索引
+    CardSearchIndex m_searchIndex;               ///< 子串搜索索引
+    QCollator m_collator;                        ///< 姓名排序规则（中文）
+    QHash<QString, NameKey> m_nameKeys;          ///< 卡号到姓名排序键
+    BalanceLedger m_ledger;                      ///< 余额流水（在卡所在分片的写锁内记账）
+    LoginAttemptTracker m_loginAttempts;         ///< 登录失败计数（定期写回卡上）
+    QMutex m_saveMutex;                          ///< 串行化卡文件和流水写入
+    Clock* m_clock = Clock::system();            ///< 时钟（卡状态变更时间）
+    mutable QMutex m_orderingMutex;              ///< 保护排序结果缓存
+    mutable std::array<Ordering, static_cast<int>(CardSortField::Count)>
+        m_orderings;  ///< 各列的排序结果缓存
+    std::array<std::atomic<quint64>, static_cast<int>(CardSortField::Count)>
+        m_orderingVersions{};  ///< 各列的版本（修改该列时增加）
 };
 
 }  // namespace CampusCard
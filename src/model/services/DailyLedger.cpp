@@ -0,0 +1,157 @@
+/**
+ * @file DailyLedger.cpp
+ * @brief 按日累计的收入台账实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "DailyLedger.h"
+
+
+namespace CampusCard {
+
+namespace {
+
+/// 扩容时在所需范围两侧额外预留的天数
+constexpr qint64 LEDGER_SLACK_DAYS = 366;
+
+}  // namespace
+
+// ========== FenwickLedger ==========
+
+void FenwickLedger::clear() {
+    m_origin = QDate();
+    m_daily.clear();
+    m_tree.clear();
+}
+
+void FenwickLedger::cover(const QDate& date) {
+    QDate origin = m_origin;
+    qint64 size = m_daily.size();
+
+    if (!origin.isValid()) {
+        origin = date.addDays(-LEDGER_SLACK_DAYS);
+        size = 2 * LEDGER_SLACK_DAYS;
+    } else if (date < origin) {
+        qint64 shift = date.daysTo(origin) + LEDGER_SLACK_DAYS;
+        origin = origin.addDays(-shift);
+        size += shift;
+    }
+    qint64 needed = origin.daysTo(date) + 1;
+    if (needed > size) {
+        size = needed + LEDGER_SLACK_DAYS;
+    }
+
+    // 将原始日值平移到新的下标，再按 O(n) 建树
+    QList<LedgerTotals> daily(size);
+    qint64 offset = m_origin.isValid() ? origin.daysTo(m_origin) : 0;
+    for (qint64 i = 0; i < m_daily.size(); ++i) {
+        daily[offset + i] = m_daily.at(i);
+    }
+
+    QList<LedgerTotals> tree(size + 1);
+    for (qint64 i = 1; i <= size; ++i) {
+        tree[i] += daily.at(i - 1);
+        qint64 parent = i + (i & -i);
+        if (parent <= size) {
+            tree[parent] += tree.at(i);
+        }
+    }
+
+    m_origin = origin;
+    m_daily = daily;
+    m_tree = tree;
+}
+
+void FenwickLedger::add(const QDate& date, const LedgerTotals& delta) {
+    if (!date.isValid()) {
+        return;
+    }
+    if (!m_origin.isValid() || date < m_origin || m_origin.daysTo(date) >= m_daily.size()) {
+        cover(date);
+    }
+
+    qint64 index = m_origin.daysTo(date);
+    m_daily[index] += delta;
+    for (qint64 i = index + 1; i < m_tree.size(); i += i & -i) {
+        m_tree[i] += delta;
+    }
+}
+
+LedgerTotals FenwickLedger::prefix(qint64 index) const {
+    LedgerTotals sum;
+    for (qint64 i = qMin(index + 1, m_tree.size() - 1); i > 0; i -= i & -i) {
+        sum += m_tree.at(i);
+    }
+    return sum;
+}
+
+LedgerTotals FenwickLedger::range(const QDate& startDate, const QDate& endDate) const {
+    if (!m_origin.isValid() || !startDate.isValid() || !endDate.isValid() ||
+        startDate > endDate) {
+        return LedgerTotals();
+    }
+
+    qint64 first = m_origin.daysTo(startDate);
+    qint64 last = m_origin.daysTo(endDate);
+    if (last < 0 || first >= m_daily.size()) {
+        return LedgerTotals();
+    }
+
+    LedgerTotals total = prefix(last);
+    if (first > 0) {
+        total -= prefix(first - 1);
+    }
+    return total;
+}
+
+// ========== DailyLedger ==========
+
+void DailyLedger::clear() {
+    m_total.clear();
+    m_locations.clear();
+}
+
+void DailyLedger::addRecord(const Record& record) {
+    if (!record.isOffline()) {
+        return;
+    }
+
+    QDate date = QDate::fromString(record.date(), QStringLiteral("yyyy-MM-dd"));
+    LedgerTotals delta;
+    delta.income = record.cost();
+    delta.sessions = 1;
+    delta.minutes = record.durationMinutes();
+
+    m_total.add(date, delta);
+    m_locations[record.location()].add(date, delta);
+}
+
+void DailyLedger::adjustCost(const Record& record, Money delta) {
+    if (!record.isOffline() || delta.isZero()) {
+        return;
+    }
+
+    QDate date = QDate::fromString(record.date(), QStringLiteral("yyyy-MM-dd"));
+    LedgerTotals change;
+    change.income = delta;
+
+    m_total.add(date, change);
+    m_locations[record.location()].add(date, change);
+}
+
+LedgerTotals DailyLedger::range(const QDate& startDate, const QDate& endDate,
+                                const QString& location) const {
+    if (location.isEmpty()) {
+        return m_total.range(startDate, endDate);
+    }
+    auto it = m_locations.constFind(location);
+    if (it == m_locations.constEnd()) {
+        return LedgerTotals();
+    }
+    return it.value().range(startDate, endDate);
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,139 @@
+/**
+ * @file DailyLedger.h
+ * @brief 按日累计的收入台账
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 以树状数组（Fenwick树）按日维护收入、上机次数和时长，
+ * 任意日期区间的合计为两次前缀和之差
+ */
+
+#ifndef MODEL_SERVICES_DAILYLEDGER_H
+#define MODEL_SERVICES_DAILYLEDGER_H
+
+#include "model/entities/Record.h"
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+
+namespace CampusCard {
+
+/**
+ * @struct LedgerTotals
+ * @brief 台账合计
+ */
+struct LedgerTotals {
+    Money income;         ///< 收入
+    int sessions = 0;     ///< 已结束的上机次数
+    int minutes = 0;      ///< 时长（分钟）
+
+    LedgerTotals& operator+=(const LedgerTotals& other) {
+        income += other.income;
+        sessions += other.sessions;
+        minutes += other.minutes;
+        return *this;
+    }
+
+    LedgerTotals& operator-=(const LedgerTotals& other) {
+        income -= other.income;
+        sessions -= other.sessions;
+        minutes -= other.minutes;
+        return *this;
+    }
+};
+
+/**
+ * @class FenwickLedger
+ * @brief 单一序列的按日树状数组
+ *
+ * 下标为相对起始日期的天数。写入早于起始日期或超出容量的日期时，
+ * 按原始日值重建树（O(n)）；其余写入与区间查询均为 O(log n)，
+ * 因此补录历史记录与按时间顺序追加一样廉价。
+ */
+class FenwickLedger {
+public:
+    /**
+     * @brief 累加某日数据
+     * @param date 日期
+     * @param delta 增量
+     */
+    void add(const QDate& date, const LedgerTotals& delta);
+
+    /**
+     * @brief 查询日期闭区间合计
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @return 合计
+     */
+    [[nodiscard]] LedgerTotals range(const QDate& startDate, const QDate& endDate) const;
+
+    /**
+     * @brief 清空
+     */
+    void clear();
+
+private:
+    /**
+     * @brief 前缀和 [0, index]
+     */
+    [[nodiscard]] LedgerTotals prefix(qint64 index) const;
+
+    /**
+     * @brief 调整覆盖范围以包含指定日期，并重建树
+     */
+    void cover(const QDate& date);
+
+    QDate m_origin;               ///< 下标0对应的日期
+    QList<LedgerTotals> m_daily;  ///< 原始日值（用于重建）
+    QList<LedgerTotals> m_tree;   ///< 树状数组（1-based，m_tree[0]不用）
+};
+
+/**
+ * @class DailyLedger
+ * @brief 全局及按地点的按日台账
+ *
+ * 记录按开始日期计入，只统计已结束的记录。
+ */
+class DailyLedger {
+public:
+    /**
+     * @brief 清空所有数据
+     */
+    void clear();
+
+    /**
+     * @brief 累加一条已结束的记录（上机中的记录被忽略）
+     * @param record 记录
+     */
+    void addRecord(const Record& record);
+
+    /**
+     * @brief 调整一条已计入的记录的费用（上机次数和时长不变）
+     * @param record 记录（日期和地点决定调整哪一天的台账）
+     * @param delta 费用变化量
+     */
+    void adjustCost(const Record& record, Money delta);
+
+    /**
+     * @brief 查询日期闭区间合计
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @param location 地点（空字符串表示所有地点）
+     * @return 合计
+     */
+    [[nodiscard]] LedgerTotals range(const QDate& startDate, const QDate& endDate,
+                                     const QString& location = QString()) const;
+
+private:
+    FenwickLedger m_total;                        ///< 全局台账
+    QHash<QString, FenwickLedger> m_locations;    ///< 按地点台账
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_DAILYLEDGER_H
@@ -0,0 +1,96 @@
+/**
+ * @file DataSnapshot.cpp
+ * @brief 卡与记录的一致性只读快照实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "DataSnapshot.h"
+
+#include <algorithm>
+
+
+namespace CampusCard {
+
+DataSnapshot::DataSnapshot(quint64 epoch, const QList<QHash<QString, Card>>& cardShards,
+                           const QMap<QString, QList<Record>>& records, const Tariff& tariff)
+    : m_data(std::make_shared<const Data>(Data{epoch, cardShards, records, tariff})) {}
+
+quint64 DataSnapshot::epoch() const {
+    return m_data ? m_data->epoch : 0;
+}
+
+// ========== 卡 ==========
+
+int DataSnapshot::cardCount() const {
+    if (!m_data) {
+        return 0;
+    }
+    qsizetype count = 0;
+    for (const auto& shard : m_data->cardShards) {
+        count += shard.size();
+    }
+    return static_cast<int>(count);
+}
+
+QList<Card> DataSnapshot::cards() const {
+    QList<Card> cards;
+    if (!m_data) {
+        return cards;
+    }
+    cards.reserve(cardCount());
+    for (const auto& shard : m_data->cardShards) {
+        for (const auto& card : shard) {
+            cards.append(card);
+        }
+    }
+    std::sort(cards.begin(), cards.end(),
+              [](const Card& a, const Card& b) { return a.cardId() < b.cardId(); });
+    return cards;
+}
+
+Card DataSnapshot::findCard(const QString& cardId) const {
+    if (!m_data) {
+        return Card();
+    }
+    for (const auto& shard : m_data->cardShards) {
+        auto it = shard.constFind(cardId);
+        if (it != shard.constEnd()) {
+            return it.value();
+        }
+    }
+    return Card();
+}
+
+// ========== 记录 ==========
+
+QMap<QString, QList<Record>> DataSnapshot::records() const {
+    return m_data ? m_data->records : QMap<QString, QList<Record>>();
+}
+
+QList<Record> DataSnapshot::records(const QString& cardId) const {
+    return m_data ? m_data->records.value(cardId) : QList<Record>();
+}
+
+QMap<QString, QList<Record>> DataSnapshot::recordsByStudentId() const {
+    QMap<QString, QList<Record>> result;
+    if (!m_data) {
+        return result;
+    }
+    for (auto it = m_data->records.constBegin(); it != m_data->records.constEnd(); ++it) {
+        const Card card = findCard(it.key());
+        if (card.cardId().isEmpty()) {
+            continue;
+        }
+        result[card.studentId()].append(it.value());
+    }
+    return result;
+}
+
+Tariff DataSnapshot::tariff() const {
+    return m_data ? m_data->tariff : Tariff();
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,131 @@
+/**
+ * @file DataSnapshot.h
+ * @brief 卡与记录的一致性只读快照
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 报表生成和数据导出在快照上进行，不阻塞并发的上机/下机操作，
+ * 也不会看到只应用了一半的下机结算事务
+ */
+
+#ifndef MODEL_SERVICES_DATASNAPSHOT_H
+#define MODEL_SERVICES_DATASNAPSHOT_H
+
+#include "model/entities/Card.h"
+#include "model/entities/Record.h"
+#include "model/services/TariffEngine.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include <memory>
+
+
+namespace CampusCard {
+
+/**
+ * @class DataSnapshot
+ * @brief 某一提交纪元（epoch）上的卡、记录与计费规则
+ *
+ * 快照由TransactionManager::snapshot()创建，纪元为创建时已提交的下机结算事务数。
+ * 数据以Qt隐式共享持有：创建快照只复制引用，写入方在之后第一次修改某个容器时
+ * 才复制（写时复制），快照中的旧版本在最后一个持有它的句柄析构时释放。
+ *
+ * 句柄可以廉价复制并在线程间传递，内容不可修改，因此无需加锁。
+ */
+class DataSnapshot {
+public:
+    /**
+     * @brief 默认构造函数（无效快照）
+     */
+    DataSnapshot() = default;
+
+    /**
+     * @brief 构造函数
+     * @param epoch 提交纪元
+     * @param cardShards 卡分片（各分片卡号互不重复）
+     * @param records 卡号到记录列表的映射
+     * @param tariff 计费规则
+     */
+    DataSnapshot(quint64 epoch, const QList<QHash<QString, Card>>& cardShards,
+                 const QMap<QString, QList<Record>>& records, const Tariff& tariff);
+
+    /**
+     * @brief 是否为有效快照
+     */
+    [[nodiscard]] bool isValid() const { return m_data != nullptr; }
+
+    /**
+     * @brief 提交纪元
+     */
+    [[nodiscard]] quint64 epoch() const;
+
+    // ========== 卡 ==========
+
+    /**
+     * @brief 卡数量
+     */
+    [[nodiscard]] int cardCount() const;
+
+    /**
+     * @brief 全部卡
+     * @return 卡列表（按卡号排序）
+     */
+    [[nodiscard]] QList<Card> cards() const;
+
+    /**
+     * @brief 根据卡号查找卡
+     * @param cardId 卡号
+     * @return 卡对象（不存在返回空Card）
+     */
+    [[nodiscard]] Card findCard(const QString& cardId) const;
+
+    // ========== 记录 ==========
+
+    /**
+     * @brief 全部记录，可直接交给HistoryAggregator等报表生成器
+     * @return 卡号到记录列表的映射
+     */
+    [[nodiscard]] QMap<QString, QList<Record>> records() const;
+
+    /**
+     * @brief 某张卡的记录
+     * @param cardId 卡号
+     * @return 记录列表
+     */
+    [[nodiscard]] QList<Record> records(const QString& cardId) const;
+
+    /**
+     * @brief 按学号分组的记录（与记录文件的组织方式一致）
+     *
+     * 快照中找不到对应卡的记录被忽略
+     * @return 学号到记录列表的映射
+     */
+    [[nodiscard]] QMap<QString, QList<Record>> recordsByStudentId() const;
+
+    /**
+     * @brief 计费规则
+     */
+    [[nodiscard]] Tariff tariff() const;
+
+private:
+    /**
+     * @struct Data
+     * @brief 快照内容（创建后不再修改）
+     */
+    struct Data {
+        quint64 epoch = 0;                       ///< 提交纪元
+        QList<QHash<QString, Card>> cardShards;  ///< 卡分片
+        QMap<QString, QList<Record>> records;    ///< 卡号到记录列表的映射
+        Tariff tariff;                           ///< 计费规则
+    };
+
+    std::shared_ptr<const Data> m_data;  ///< 快照内容（无效快照为空）
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_DATASNAPSHOT_H
@@ -0,0 +1,267 @@
+/**
+ * @file DistinctCounter.cpp
+ * @brief 基于HyperLogLog的去重人数统计实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "DistinctCounter.h"
+
+#include <QSet>
+
+#include <bit>
+#include <cmath>
+
+
+namespace CampusCard {
+
+namespace {
+
+constexpr quint64 FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr quint64 FNV_PRIME = 0x100000001b3ULL;
+
+/// 序列化格式标记
+constexpr char FORMAT_DENSE = 'D';
+constexpr char FORMAT_SPARSE = 'S';
+
+/// 稀疏编码中每个非零寄存器占用的字节数（2字节下标 + 1字节值）
+constexpr int SPARSE_ENTRY_BYTES = 3;
+
+/**
+ * @brief MurmurHash3的64位终结函数，使FNV-1a的输出各位充分混合
+ */
+quint64 fmix64(quint64 k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+}  // namespace
+
+// ========== HyperLogLog ==========
+
+quint64 HyperLogLog::hash(const QString& value) {
+    quint64 h = FNV_OFFSET_BASIS;
+    for (QChar ch : value) {
+        const char16_t unit = ch.unicode();
+        h = (h ^ (unit & 0xff)) * FNV_PRIME;
+        h = (h ^ (unit >> 8)) * FNV_PRIME;
+    }
+    return fmix64(h);
+}
+
+void HyperLogLog::add(const QString& value) {
+    addHash(hash(value));
+}
+
+void HyperLogLog::addHash(quint64 hashValue) {
+    if (m_registers.isEmpty()) {
+        m_registers = QByteArray(REGISTER_COUNT, '\0');
+    }
+    const int index = static_cast<int>(hashValue >> (64 - PRECISION));
+    const quint64 rest = hashValue << PRECISION;
+    const int rank = rest == 0 ? (64 - PRECISION + 1) : (std::countl_zero(rest) + 1);
+    if (rank > m_registers.at(index)) {
+        m_registers[index] = static_cast<char>(rank);
+    }
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.m_registers.isEmpty()) {
+        return;
+    }
+    if (m_registers.isEmpty()) {
+        m_registers = other.m_registers;
+        return;
+    }
+    char* mine = m_registers.data();
+    const char* theirs = other.m_registers.constData();
+    for (int i = 0; i < REGISTER_COUNT; ++i) {
+        if (theirs[i] > mine[i]) {
+            mine[i] = theirs[i];
+        }
+    }
+}
+
+qint64 HyperLogLog::estimate() const {
+    if (m_registers.isEmpty()) {
+        return 0;
+    }
+
+    const double m = REGISTER_COUNT;
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double sum = 0.0;
+    int zeros = 0;
+    for (char reg : m_registers) {
+        sum += std::ldexp(1.0, -reg);
+        if (reg == 0) {
+            ++zeros;
+        }
+    }
+
+    double estimate = alpha * m * m / sum;
+    // 小基数时改用线性计数，误差明显更小
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+    return std::llround(estimate);
+}
+
+bool HyperLogLog::isEmpty() const {
+    return m_registers.isEmpty();
+}
+
+void HyperLogLog::clear() {
+    m_registers.clear();
+}
+
+QByteArray HyperLogLog::toByteArray() const {
+    QByteArray sparse;
+    sparse.append(FORMAT_SPARSE);
+    for (int i = 0; i < m_registers.size(); ++i) {
+        const char reg = m_registers.at(i);
+        if (reg == 0) {
+            continue;
+        }
+        if (sparse.size() + SPARSE_ENTRY_BYTES > REGISTER_COUNT) {
+            // 稀疏编码不再更短，改用稠密编码
+            return QByteArray(1, FORMAT_DENSE) + m_registers;
+        }
+        sparse.append(static_cast<char>(i >> 8));
+        sparse.append(static_cast<char>(i & 0xff));
+        sparse.append(reg);
+    }
+    return sparse;
+}
+
+HyperLogLog HyperLogLog::fromByteArray(const QByteArray& data, bool* ok) {
+    HyperLogLog sketch;
+    bool valid = false;
+    const int maxRank = 64 - PRECISION + 1;
+
+    if (!data.isEmpty() && data.at(0) == FORMAT_DENSE && data.size() == REGISTER_COUNT + 1) {
+        valid = true;
+        sketch.m_registers = data.mid(1);
+        for (char reg : sketch.m_registers) {
+            if (reg < 0 || reg > maxRank) {
+                valid = false;
+                break;
+            }
+        }
+    } else if (!data.isEmpty() && data.at(0) == FORMAT_SPARSE &&
+               (data.size() - 1) % SPARSE_ENTRY_BYTES == 0) {
+        valid = true;
+        for (qsizetype pos = 1; pos < data.size(); pos += SPARSE_ENTRY_BYTES) {
+            const int index = (static_cast<quint8>(data.at(pos)) << 8) |
+                              static_cast<quint8>(data.at(pos + 1));
+            const char reg = data.at(pos + 2);
+            if (index >= REGISTER_COUNT || reg <= 0 || reg > maxRank) {
+                valid = false;
+                break;
+            }
+            if (sketch.m_registers.isEmpty()) {
+                sketch.m_registers = QByteArray(REGISTER_COUNT, '\0');
+            }
+            sketch.m_registers[index] = reg;
+        }
+    }
+
+    if (!valid) {
+        sketch.clear();
+    }
+    if (ok) {
+        *ok = valid;
+    }
+    return sketch;
+}
+
+// ========== DistinctUserSketches ==========
+
+void DistinctUserSketches::clear() {
+    m_days.clear();
+}
+
+void DistinctUserSketches::addRecord(const Record& record) {
+    if (!record.isOffline()) {
+        return;
+    }
+    QDate date = QDate::fromString(record.date(), QStringLiteral("yyyy-MM-dd"));
+    if (!date.isValid()) {
+        return;
+    }
+    m_days[date][record.location()].add(record.cardId());
+}
+
+void DistinctUserSketches::merge(const DistinctUserSketches& other) {
+    for (auto day = other.m_days.constBegin(); day != other.m_days.constEnd(); ++day) {
+        QHash<QString, HyperLogLog>& target = m_days[day.key()];
+        for (auto it = day.value().constBegin(); it != day.value().constEnd(); ++it) {
+            target[it.key()].merge(it.value());
+        }
+    }
+}
+
+HyperLogLog DistinctUserSketches::sketch(const QDate& startDate, const QDate& endDate,
+                                         const QStringList& locations) const {
+    HyperLogLog result;
+    if (!startDate.isValid() || !endDate.isValid() || startDate > endDate) {
+        return result;
+    }
+
+    const QSet<QString> wanted(locations.cbegin(), locations.cend());
+    for (auto day = m_days.lowerBound(startDate);
+         day != m_days.constEnd() && day.key() <= endDate; ++day) {
+        for (auto it = day.value().constBegin(); it != day.value().constEnd(); ++it) {
+            if (wanted.isEmpty() || wanted.contains(it.key())) {
+                result.merge(it.value());
+            }
+        }
+    }
+    return result;
+}
+
+qint64 DistinctUserSketches::count(const QDate& startDate, const QDate& endDate,
+                                   const QStringList& locations) const {
+    return sketch(startDate, endDate, locations).estimate();
+}
+
+QList<QDate> DistinctUserSketches::days() const {
+    return m_days.keys();
+}
+
+QJsonObject DistinctUserSketches::dayToJson(const QDate& date) const {
+    QJsonObject json;
+    auto day = m_days.constFind(date);
+    if (day == m_days.constEnd()) {
+        return json;
+    }
+    for (auto it = day.value().constBegin(); it != day.value().constEnd(); ++it) {
+        json[it.key()] = QString::fromLatin1(it.value().toByteArray().toBase64());
+    }
+    return json;
+}
+
+bool DistinctUserSketches::mergeDayJson(const QDate& date, const QJsonObject& json) {
+    if (!date.isValid()) {
+        return false;
+    }
+    bool allValid = true;
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+        bool ok = false;
+        QByteArray bytes = QByteArray::fromBase64(it.value().toString().toLatin1());
+        HyperLogLog sketch = HyperLogLog::fromByteArray(bytes, &ok);
+        if (!ok) {
+            allValid = false;
+            continue;
+        }
+        m_days[date][it.key()].merge(sketch);
+    }
+    return allValid;
+}
+
+}  // namespace CampusCard
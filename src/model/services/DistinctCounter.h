@@ -0,0 +1,184 @@
+/**
+ * @file DistinctCounter.h
+ * @brief 基于HyperLogLog的去重人数统计
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 按(日期, 地点)维护可合并的HyperLogLog草图，
+ * 任意日期区间与地点集合的去重人数由草图合并得到，不扫描记录
+ */
+
+#ifndef MODEL_SERVICES_DISTINCTCOUNTER_H
+#define MODEL_SERVICES_DISTINCTCOUNTER_H
+
+#include "model/entities/Record.h"
+
+#include <QByteArray>
+#include <QDate>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+
+namespace CampusCard {
+
+/**
+ * @brief 去重计数方式
+ */
+enum class DistinctMode {
+    Approximate,  ///< 合并HyperLogLog草图（快速，误差约1.6%）
+    Exact         ///< 扫描记录精确计数（用于审计核对）
+};
+
+/**
+ * @class HyperLogLog
+ * @brief 定长HyperLogLog基数估计草图
+ *
+ * 精度p=12（4096个寄存器），标准误差约1.6%。
+ * 使用固定的64位哈希（FNV-1a + fmix64终结），与进程的qHash种子无关，
+ * 因此持久化后的草图在下次启动时仍可与新草图合并。
+ * 合并为逐寄存器取最大值，满足交换律、结合律和幂等性。
+ */
+class HyperLogLog {
+public:
+    static constexpr int PRECISION = 12;                  ///< 下标位数
+    static constexpr int REGISTER_COUNT = 1 << PRECISION; ///< 寄存器数量
+
+    /**
+     * @brief 计算字符串的64位哈希（跨进程稳定）
+     * @param value 字符串
+     * @return 哈希值
+     */
+    [[nodiscard]] static quint64 hash(const QString& value);
+
+    /**
+     * @brief 加入一个元素
+     * @param value 元素（如卡号）
+     */
+    void add(const QString& value);
+
+    /**
+     * @brief 加入一个已哈希的元素
+     * @param hashValue 64位哈希值
+     */
+    void addHash(quint64 hashValue);
+
+    /**
+     * @brief 合并另一个草图（并集）
+     * @param other 另一个草图
+     */
+    void merge(const HyperLogLog& other);
+
+    /**
+     * @brief 估计去重元素数量
+     * @return 基数估计值（四舍五入）
+     */
+    [[nodiscard]] qint64 estimate() const;
+
+    /**
+     * @brief 是否未加入任何元素
+     */
+    [[nodiscard]] bool isEmpty() const;
+
+    /**
+     * @brief 清空
+     */
+    void clear();
+
+    /**
+     * @brief 序列化为字节串
+     *
+     * 非零寄存器较少时采用稀疏编码（下标+值），否则采用稠密编码
+     * @return 字节串
+     */
+    [[nodiscard]] QByteArray toByteArray() const;
+
+    /**
+     * @brief 从字节串反序列化
+     * @param data 字节串
+     * @param ok 输出是否成功（可为nullptr）
+     * @return 草图（失败时为空草图）
+     */
+    [[nodiscard]] static HyperLogLog fromByteArray(const QByteArray& data, bool* ok = nullptr);
+
+private:
+    QByteArray m_registers;  ///< 寄存器（每个存放前导零数+1；为空表示全零，按需分配）
+};
+
+/**
+ * @class DistinctUserSketches
+ * @brief 按(日期, 地点)维护的去重用户草图集合
+ *
+ * 记录按开始日期计入，只统计已结束的记录，元素为卡号。
+ */
+class DistinctUserSketches {
+public:
+    /**
+     * @brief 清空所有草图
+     */
+    void clear();
+
+    /**
+     * @brief 计入一条已结束的记录（上机中的记录被忽略）
+     * @param record 记录
+     */
+    void addRecord(const Record& record);
+
+    /**
+     * @brief 合并另一组草图
+     * @param other 另一组草图
+     */
+    void merge(const DistinctUserSketches& other);
+
+    /**
+     * @brief 估计日期闭区间、地点集合内的去重用户数
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @param locations 地点集合（空表示所有地点）
+     * @return 去重用户数估计值
+     */
+    [[nodiscard]] qint64 count(const QDate& startDate, const QDate& endDate,
+                               const QStringList& locations = QStringList()) const;
+
+    /**
+     * @brief 合并日期闭区间、地点集合内的草图
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @param locations 地点集合（空表示所有地点）
+     * @return 合并后的草图
+     */
+    [[nodiscard]] HyperLogLog sketch(const QDate& startDate, const QDate& endDate,
+                                     const QStringList& locations = QStringList()) const;
+
+    /**
+     * @brief 有草图的日期
+     * @return 日期列表（升序）
+     */
+    [[nodiscard]] QList<QDate> days() const;
+
+    /**
+     * @brief 导出某日草图（用于持久化）
+     * @param date 日期
+     * @return 地点到Base64编码草图的JSON对象
+     */
+    [[nodiscard]] QJsonObject dayToJson(const QDate& date) const;
+
+    /**
+     * @brief 合并持久化的某日草图
+     * @param date 日期
+     * @param json dayToJson()导出的JSON对象
+     * @return 是否全部解析成功（解析失败的地点被跳过）
+     */
+    bool mergeDayJson(const QDate& date, const QJsonObject& json);
+
+private:
+    QMap<QDate, QHash<QString, HyperLogLog>> m_days;  ///< 日期 -> 地点 -> 草图
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_DISTINCTCOUNTER_H
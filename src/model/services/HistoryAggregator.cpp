@@ -0,0 +1,143 @@
+/**
+ * @file HistoryAggregator.cpp
+ * @brief 全量历史记录并行汇总实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "HistoryAggregator.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <iterator>
+
+
+namespace CampusCard {
+
+namespace {
+
+/**
+ * @brief 卡排行顺序：时长降序，时长相同按卡号升序
+ */
+bool busierThan(const RecordGroup& a, const RecordGroup& b) {
+    if (a.totalDuration != b.totalDuration) {
+        return a.totalDuration > b.totalDuration;
+    }
+    return a.key < b.key;
+}
+
+}  // namespace
+
+QList<HistoryAggregator::Chunk> HistoryAggregator::partition(
+    const QMap<QString, QList<Record>>& records, const RecordQuery& query) {
+    QList<Chunk> chunks;
+    Chunk current;
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
+        if (query.cardFilter() && it.key() != *query.cardFilter()) {
+            continue;
+        }
+        current.append(it.value());
+        if (current.size() == CARDS_PER_CHUNK) {
+            chunks.append(current);
+            current.clear();
+        }
+    }
+    if (!current.isEmpty()) {
+        chunks.append(current);
+    }
+    return chunks;
+}
+
+HistorySummary HistoryAggregator::summarizeChunk(const Chunk& chunk, const RecordQuery& query,
+                                                 int topN) {
+    HistorySummary summary;
+    for (const auto& cardRecords : chunk) {
+        RecordGroup card;
+        for (const auto& record : cardRecords) {
+            if (!record.isOffline() || !query.matches(record)) {
+                continue;
+            }
+            card.key = record.cardId();
+            card.count++;
+            card.totalDuration += record.durationMinutes();
+            card.totalCost += record.cost();
+
+            RecordGroup& location = summary.byLocation[record.location()];
+            location.key = record.location();
+            location.count++;
+            location.totalDuration += record.durationMinutes();
+            location.totalCost += record.cost();
+        }
+        if (card.count == 0) {
+            continue;
+        }
+        summary.sessionCount += card.count;
+        summary.totalDuration += card.totalDuration;
+        summary.totalIncome += card.totalCost;
+        summary.topCards.append(card);
+    }
+
+    std::sort(summary.topCards.begin(), summary.topCards.end(), busierThan);
+    if (summary.topCards.size() > topN) {
+        summary.topCards.resize(topN);
+    }
+    return summary;
+}
+
+void HistoryAggregator::merge(HistorySummary& total, const HistorySummary& part, int topN) {
+    total.sessionCount += part.sessionCount;
+    total.totalDuration += part.totalDuration;
+    total.totalIncome += part.totalIncome;
+
+    for (auto it = part.byLocation.constBegin(); it != part.byLocation.constEnd(); ++it) {
+        RecordGroup& location = total.byLocation[it.key()];
+        location.key = it.key();
+        location.count += it.value().count;
+        location.totalDuration += it.value().totalDuration;
+        location.totalCost += it.value().totalCost;
+    }
+
+    // 各分块的卡互不重叠，全局前N名必然在各分块前N名的并集中
+    QList<RecordGroup> merged;
+    merged.reserve(total.topCards.size() + part.topCards.size());
+    std::merge(total.topCards.cbegin(), total.topCards.cend(), part.topCards.cbegin(),
+               part.topCards.cend(), std::back_inserter(merged), busierThan);
+    if (merged.size() > topN) {
+        merged.resize(topN);
+    }
+    total.topCards = merged;
+}
+
+HistorySummary HistoryAggregator::summarize(const QMap<QString, QList<Record>>& records,
+                                            const RecordQuery& query, int topN) {
+    topN = qMax(0, topN);
+    HistorySummary total;
+    for (const auto& chunk : partition(records, query)) {
+        merge(total, summarizeChunk(chunk, query, topN), topN);
+    }
+    return total;
+}
+
+QFuture<HistorySummary> HistoryAggregator::summarizeAsync(
+    const QMap<QString, QList<Record>>& records, const RecordQuery& query, int topN,
+    QThreadPool* pool) {
+    topN = qMax(0, topN);
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+
+    // 分块在调用线程完成，工作线程只读取隐式共享的记录列表
+    QList<Chunk> chunks = partition(records, query);
+
+    return QtConcurrent::mappedReduced<HistorySummary>(
+        pool, std::move(chunks),
+        [query, topN](const Chunk& chunk) { return summarizeChunk(chunk, query, topN); },
+        [topN](HistorySummary& total, const HistorySummary& part) { merge(total, part, topN); },
+        QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce);
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,101 @@
+/**
+ * @file HistoryAggregator.h
+ * @brief 全量历史记录并行汇总
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 以卡为单位对全部上机记录分块，使用QtConcurrent进行map-reduce汇总，
+ * 支持进度报告与取消
+ */
+
+#ifndef MODEL_SERVICES_HISTORYAGGREGATOR_H
+#define MODEL_SERVICES_HISTORYAGGREGATOR_H
+
+#include "model/entities/Record.h"
+#include "model/services/RecordQuery.h"
+
+#include <QFuture>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class QThreadPool;
+
+namespace CampusCard {
+
+/**
+ * @struct HistorySummary
+ * @brief 全量历史汇总结果
+ */
+struct HistorySummary {
+    int sessionCount = 0;                    ///< 已结束的上机次数
+    int totalDuration = 0;                   ///< 总时长（分钟）
+    Money totalIncome;                       ///< 总收入
+    QMap<QString, RecordGroup> byLocation;   ///< 按地点汇总（按地点名有序）
+    QList<RecordGroup> topCards;             ///< 时长最多的卡（key为卡号，按时长降序）
+};
+
+/**
+ * @class HistoryAggregator
+ * @brief 全量历史汇总器
+ *
+ * 记录按卡号顺序切分为固定大小的分块，每个分块独立汇总后按分块顺序合并。
+ * 分块边界和合并顺序与线程数无关，费用按整数分累加，因此串行与并行结果完全一致。
+ *
+ * 只统计已结束（Offline）且满足查询条件的记录；查询的排序与分页设置不参与汇总。
+ */
+class HistoryAggregator {
+public:
+    /// 每个分块包含的卡数
+    static constexpr int CARDS_PER_CHUNK = 32;
+
+    /**
+     * @brief 串行汇总
+     * @param records 卡号到记录列表的映射
+     * @param query 过滤条件
+     * @param topN 保留的卡排行数量
+     * @return 汇总结果
+     */
+    [[nodiscard]] static HistorySummary summarize(const QMap<QString, QList<Record>>& records,
+                                                  const RecordQuery& query, int topN);
+
+    /**
+     * @brief 在线程池中并行汇总
+     *
+     * 分块在调用线程中完成并持有记录列表的隐式共享副本，
+     * 调用方之后对原始数据的修改不会影响本次汇总。
+     * 返回的QFuture进度范围为分块数，可通过cancel()取消。
+     * @param records 卡号到记录列表的映射
+     * @param query 过滤条件
+     * @param topN 保留的卡排行数量
+     * @param pool 线程池（nullptr表示全局线程池）
+     * @return 汇总结果的QFuture
+     */
+    [[nodiscard]] static QFuture<HistorySummary> summarizeAsync(
+        const QMap<QString, QList<Record>>& records, const RecordQuery& query, int topN,
+        QThreadPool* pool = nullptr);
+
+private:
+    using Chunk = QList<QList<Record>>;
+
+    /**
+     * @brief 按卡号顺序切分分块
+     */
+    static QList<Chunk> partition(const QMap<QString, QList<Record>>& records,
+                                  const RecordQuery& query);
+
+    /**
+     * @brief 汇总单个分块
+     */
+    static HistorySummary summarizeChunk(const Chunk& chunk, const RecordQuery& query, int topN);
+
+    /**
+     * @brief 将分块结果合并到累计结果
+     */
+    static void merge(HistorySummary& total, const HistorySummary& part, int topN);
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_HISTORYAGGREGATOR_H
@@ -0,0 +1,109 @@
+/**
+ * @file LoginAttemptTracker.cpp
+ * @brief 内存中的登录失败计数实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "LoginAttemptTracker.h"
+
+#include <utility>
+
+namespace CampusCard {
+
+void LoginAttemptTracker::setWindow(qint64 msecs) {
+    QMutexLocker locker(&m_mutex);
+    m_windowMSecs = qMax(qint64(0), msecs);
+}
+
+qint64 LoginAttemptTracker::window() const {
+    QMutexLocker locker(&m_mutex);
+    return m_windowMSecs;
+}
+
+// ========== 计数 ==========
+
+int LoginAttemptTracker::recordFailure(const QString& cardId, qint64 now) {
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[cardId];
+    if (expired(entry, now)) {
+        entry.count = 0;
+    }
+    ++entry.count;
+    entry.lastFailure = now;
+    m_dirty.insert(cardId);
+    return entry.count;
+}
+
+void LoginAttemptTracker::reset(const QString& cardId) {
+    QMutexLocker locker(&m_mutex);
+    // 卡上可能还保存着旧计数，即使表中没有也要写回0
+    m_entries.remove(cardId);
+    m_dirty.insert(cardId);
+}
+
+void LoginAttemptTracker::restore(const QString& cardId, int attempts, qint64 now) {
+    QMutexLocker locker(&m_mutex);
+    m_dirty.remove(cardId);
+    if (attempts <= 0) {
+        m_entries.remove(cardId);
+    } else {
+        m_entries.insert(cardId, Entry{attempts, now});
+    }
+}
+
+void LoginAttemptTracker::discard(const QString& cardId) {
+    QMutexLocker locker(&m_mutex);
+    m_entries.remove(cardId);
+    m_dirty.remove(cardId);
+}
+
+std::optional<int> LoginAttemptTracker::attempts(const QString& cardId, qint64 now) const {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(cardId);
+    if (it == m_entries.constEnd()) {
+        return m_dirty.contains(cardId) ? std::optional<int>(0) : std::nullopt;
+    }
+    return expired(it.value(), now) ? 0 : it.value().count;
+}
+
+// ========== 写回 ==========
+
+QHash<QString, int> LoginAttemptTracker::takeDirty(qint64 now) {
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, int> result;
+    result.reserve(m_dirty.size());
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (expired(it.value(), now)) {
+            result.insert(it.key(), 0);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& cardId : std::as_const(m_dirty)) {
+        auto it = m_entries.constFind(cardId);
+        result.insert(cardId, it == m_entries.constEnd() ? 0 : it.value().count);
+    }
+    m_dirty.clear();
+    return result;
+}
+
+void LoginAttemptTracker::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_dirty.clear();
+}
+
+int LoginAttemptTracker::size() const {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_entries.size());
+}
+
+bool LoginAttemptTracker::expired(const Entry& entry, qint64 now) const {
+    return m_windowMSecs > 0 && now - entry.lastFailure >= m_windowMSecs;
+}
+
+}  // namespace CampusCard
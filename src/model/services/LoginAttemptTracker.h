@@ -0,0 +1,131 @@
+/**
+ * @file LoginAttemptTracker.h
+ * @brief 内存中的登录失败计数
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 登录失败计数只在内存中累加并随时间衰减，不再每次失败都重写卡文件；
+ * 变化过的计数由CardService定期批量写回卡上
+ */
+
+#ifndef MODEL_SERVICES_LOGINATTEMPTTRACKER_H
+#define MODEL_SERVICES_LOGINATTEMPTTRACKER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include <optional>
+
+
+namespace CampusCard {
+
+/**
+ * @class LoginAttemptTracker
+ * @brief 带时间窗口的登录失败计数表
+ *
+ * 每张卡记录失败次数和最近一次失败的时间；距最近一次失败超过时间窗口后计数归零，
+ * 因此偶尔输错密码的学生不会因数周前的失败被冻结，而连续暴力尝试仍会在窗口内累计。
+ *
+ * 计数变化时卡号被标记为待写回，takeDirty()取出这些卡的当前计数（过期的计数报告为0
+ * 并从表中移除）。调用方已经自行把计数写入卡时（如冻结、解冻）用discard()移除，
+ * 以免之后写回的旧计数覆盖卡上的值。
+ *
+ * 所有方法都可被多线程同时调用。
+ */
+class LoginAttemptTracker {
+public:
+    /// 默认时间窗口：距最近一次失败15分钟后计数归零
+    static constexpr qint64 DEFAULT_WINDOW_MSECS = 15 * 60 * 1000;
+
+    /**
+     * @brief 设置时间窗口
+     * @param msecs 毫秒（不大于0表示计数永不衰减）
+     */
+    void setWindow(qint64 msecs);
+
+    /**
+     * @brief 获取时间窗口
+     * @return 毫秒（0表示计数永不衰减）
+     */
+    [[nodiscard]] qint64 window() const;
+
+    /**
+     * @brief 记录一次登录失败
+     * @param cardId 卡号
+     * @param now 当前时间（毫秒）
+     * @return 窗口内的失败次数（含本次）
+     */
+    int recordFailure(const QString& cardId, qint64 now);
+
+    /**
+     * @brief 登录成功后清零计数（标记为待写回）
+     * @param cardId 卡号
+     */
+    void reset(const QString& cardId);
+
+    /**
+     * @brief 载入已持久化的计数（不标记为待写回）
+     * @param cardId 卡号
+     * @param attempts 失败次数（不大于0时移除）
+     * @param now 当前时间（毫秒），作为最近一次失败的时间
+     */
+    void restore(const QString& cardId, int attempts, qint64 now);
+
+    /**
+     * @brief 移除计数且不写回（调用方已将计数写入卡）
+     * @param cardId 卡号
+     */
+    void discard(const QString& cardId);
+
+    /**
+     * @brief 获取窗口内的失败次数
+     * @param cardId 卡号
+     * @param now 当前时间（毫秒）
+     * @return 失败次数（未跟踪该卡时为空，以卡上保存的计数为准）
+     */
+    [[nodiscard]] std::optional<int> attempts(const QString& cardId, qint64 now) const;
+
+    /**
+     * @brief 取出自上次调用以来变化过的计数，并移除已过期的计数
+     * @param now 当前时间（毫秒）
+     * @return 卡号到当前失败次数的映射（过期的为0）
+     */
+    [[nodiscard]] QHash<QString, int> takeDirty(qint64 now);
+
+    /**
+     * @brief 清空全部计数
+     */
+    void clear();
+
+    /**
+     * @brief 正在跟踪的卡数
+     */
+    [[nodiscard]] int size() const;
+
+private:
+    /**
+     * @struct Entry
+     * @brief 一张卡的失败计数
+     */
+    struct Entry {
+        int count = 0;           ///< 失败次数
+        qint64 lastFailure = 0;  ///< 最近一次失败时间（毫秒）
+    };
+
+    /**
+     * @brief 计数在now时是否已过期（调用方持有锁）
+     */
+    [[nodiscard]] bool expired(const Entry& entry, qint64 now) const;
+
+    mutable QMutex m_mutex;                       ///< 保护以下成员
+    QHash<QString, Entry> m_entries;              ///< 卡号到失败计数的映射
+    QSet<QString> m_dirty;                        ///< 待写回的卡号
+    qint64 m_windowMSecs = DEFAULT_WINDOW_MSECS;  ///< 时间窗口（毫秒，0表示不衰减）
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_LOGINATTEMPTTRACKER_H
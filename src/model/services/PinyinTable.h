@@ -0,0 +1,58 @@
+/**
+ * @file PinyinTable.h
+ * @brief 汉字拼音对照表
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 内置GB2312全部汉字的不带声调拼音，不依赖网络或系统库，
+ * 用于按拼音全拼或首字母搜索持卡人姓名
+ */
+
+#ifndef MODEL_SERVICES_PINYINTABLE_H
+#define MODEL_SERVICES_PINYINTABLE_H
+
+#include <QChar>
+#include <QString>
+#include <QStringList>
+
+
+namespace CampusCard {
+
+/**
+ * @class PinyinTable
+ * @brief 汉字到拼音的查询
+ *
+ * 每个汉字只取最常用的读音；姓名第一个字是多音姓氏（如曾、单、仇）时，
+ * 另外生成按姓氏读音拼出的搜索键。
+ */
+class PinyinTable {
+public:
+    /**
+     * @brief 汉字的拼音
+     * @param ch 汉字
+     * @return 小写、不带声调的拼音（ü写作v；不在表中时为空）
+     */
+    [[nodiscard]] static QString syllable(QChar ch);
+
+    /**
+     * @brief 汉字作为姓氏时的读音
+     * @param ch 汉字
+     * @return 与常用读音不同时返回姓氏读音，否则为空
+     */
+    [[nodiscard]] static QString surnameSyllable(QChar ch);
+
+    /**
+     * @brief 姓名的拼音搜索键
+     *
+     * 包括全拼（如"zhangsan"）和首字母（如"zs"），空白被忽略，
+     * 姓名中的非汉字字母数字保留在全拼中
+     * @param name 姓名
+     * @return 不重复的搜索键（姓名中没有可转写的汉字时为空）
+     */
+    [[nodiscard]] static QStringList searchKeys(const QString& name);
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_PINYINTABLE_H
@@ -0,0 +1,110 @@
+/**
+ * @file PrefixTrie.cpp
+ * @brief 前缀树实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "PrefixTrie.h"
+
+
+namespace CampusCard {
+
+PrefixTrie::PrefixTrie() {
+    m_nodes.append(Node());
+}
+
+void PrefixTrie::clear() {
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_values.clear();
+}
+
+void PrefixTrie::insert(const QString& key, int value) {
+    if (key.isEmpty()) {
+        return;
+    }
+
+    int node = 0;
+    for (QChar ch : key) {
+        int child = childOf(node, ch);
+        if (child < 0) {
+            // 新节点插在兄弟链表头部
+            child = static_cast<int>(m_nodes.size());
+            Node created;
+            created.ch = ch;
+            created.nextSibling = m_nodes.at(node).firstChild;
+            m_nodes.append(created);
+            m_nodes[node].firstChild = child;
+        }
+        node = child;
+    }
+    m_values[node].append(value);
+}
+
+bool PrefixTrie::remove(const QString& key, int value) {
+    const int node = find(key);
+    if (node <= 0) {
+        return false;
+    }
+
+    auto it = m_values.find(node);
+    if (it == m_values.end() || !it.value().removeOne(value)) {
+        return false;
+    }
+    if (it.value().isEmpty()) {
+        m_values.erase(it);
+    }
+    return true;
+}
+
+QList<int> PrefixTrie::valuesWithPrefix(const QString& prefix) const {
+    const int start = find(prefix);
+    if (start <= 0) {
+        return {};
+    }
+
+    QList<int> values;
+    QList<int> stack = {start};
+    while (!stack.isEmpty()) {
+        const int node = stack.takeLast();
+        auto it = m_values.constFind(node);
+        if (it != m_values.constEnd()) {
+            values.append(it.value());
+        }
+        for (int child = m_nodes.at(node).firstChild; child >= 0;
+             child = m_nodes.at(child).nextSibling) {
+            stack.append(child);
+        }
+    }
+    return values;
+}
+
+int PrefixTrie::childOf(int node, QChar ch) const {
+    for (int child = m_nodes.at(node).firstChild; child >= 0;
+         child = m_nodes.at(child).nextSibling) {
+        if (m_nodes.at(child).ch == ch) {
+            return child;
+        }
+    }
+    return -1;
+}
+
+int PrefixTrie::find(const QString& key) const {
+    if (key.isEmpty()) {
+        return -1;
+    }
+
+    int node = 0;
+    for (QChar ch : key) {
+        node = childOf(node, ch);
+        if (node < 0) {
+            return -1;
+        }
+    }
+    return node;
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,100 @@
+/**
+ * @file PrefixTrie.h
+ * @brief 前缀树
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 字符串键到整数值的前缀树，用于拼音前缀搜索
+ */
+
+#ifndef MODEL_SERVICES_PREFIXTRIE_H
+#define MODEL_SERVICES_PREFIXTRIE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+
+namespace CampusCard {
+
+/**
+ * @class PrefixTrie
+ * @brief 字符串前缀树，一个键可以对应多个值
+ *
+ * 节点以"第一个子节点/下一个兄弟节点"的形式存放在连续数组中，每个节点只占
+ * 十几个字节；值单独存放在以节点为键的哈希表里。查找前缀的开销是前缀长度
+ * 加上子树大小，与键的总数无关。删除只移除值，不回收节点。
+ */
+class PrefixTrie {
+public:
+    /**
+     * @brief 构造函数（只有根节点）
+     */
+    PrefixTrie();
+
+    /**
+     * @brief 清空
+     */
+    void clear();
+
+    /**
+     * @brief 加入键值对
+     * @param key 键（为空时忽略）
+     * @param value 值
+     */
+    void insert(const QString& key, int value);
+
+    /**
+     * @brief 移除键值对
+     * @param key 键
+     * @param value 值
+     * @return 是否存在并已移除
+     */
+    bool remove(const QString& key, int value);
+
+    /**
+     * @brief 以prefix开头的所有键的值
+     * @param prefix 前缀（为空时返回空列表）
+     * @return 值列表（同一个值挂在多个匹配的键下时会重复出现）
+     */
+    [[nodiscard]] QList<int> valuesWithPrefix(const QString& prefix) const;
+
+    /**
+     * @brief 节点数（含根节点）
+     */
+    [[nodiscard]] qsizetype nodeCount() const { return m_nodes.size(); }
+
+private:
+    /**
+     * @struct Node
+     * @brief 前缀树节点
+     */
+    struct Node {
+        QChar ch;                 ///< 从父节点到本节点的字符
+        qint32 firstChild = -1;   ///< 第一个子节点（-1表示无）
+        qint32 nextSibling = -1;  ///< 下一个兄弟节点（-1表示无）
+    };
+
+    /**
+     * @brief 查找子节点
+     * @param node 父节点
+     * @param ch 字符
+     * @return 子节点（不存在返回-1）
+     */
+    [[nodiscard]] int childOf(int node, QChar ch) const;
+
+    /**
+     * @brief 键对应的节点
+     * @param key 键
+     * @return 节点（不存在返回-1）
+     */
+    [[nodiscard]] int find(const QString& key) const;
+
+    QList<Node> m_nodes;              ///< 节点（0为根节点）
+    QHash<int, QList<int>> m_values;  ///< 节点到值的映射
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_PREFIXTRIE_H
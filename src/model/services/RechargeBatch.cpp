@@ -0,0 +1,91 @@
+/**
+ * @file RechargeBatch.cpp
+ * @brief 批量充值文件的读取与结果报告实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "RechargeBatch.h"
+
+#include <QIODevice>
+#include <QStringList>
+
+
+namespace CampusCard {
+
+// ========== RechargeBatchReport ==========
+
+QString RechargeBatchReport::summary() const {
+    QString text = QStringLiteral("读取 %1 行，有效 %2 行，合计 %3 元")
+                       .arg(rows)
+                       .arg(validRows)
+                       .arg(total.toString());
+    if (!errors.isEmpty()) {
+        text += QStringLiteral("，错误 %1 行").arg(errors.size());
+    }
+    if (applied > 0) {
+        text += saved ? QStringLiteral("，已为 %1 行充值").arg(applied)
+                      : QStringLiteral("，已为 %1 行充值但保存失败").arg(applied);
+    } else if (!errors.isEmpty()) {
+        text += QStringLiteral("，未充值");
+    }
+    return text;
+}
+
+// ========== RechargeCsvReader ==========
+
+RechargeCsvReader::RechargeCsvReader(QIODevice* device) : m_stream(device) {}
+
+bool RechargeCsvReader::readNext(RechargeRow& row) {
+    QString line;
+    while (m_stream.readLineInto(&line)) {
+        ++m_lineNumber;
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+
+        const QStringList fields = line.split(QLatin1Char(','));
+        row = RechargeRow();
+        row.line = m_lineNumber;
+        row.cardId = unquote(fields.first());
+
+        if (!m_headerChecked) {
+            m_headerChecked = true;
+            if (row.cardId == QStringLiteral("卡号") ||
+                row.cardId.compare(QStringLiteral("cardId"), Qt::CaseInsensitive) == 0) {
+                continue;
+            }
+        }
+
+        if (row.cardId.isEmpty()) {
+            row.error = QStringLiteral("卡号为空");
+        } else if (fields.size() < 2) {
+            row.error = QStringLiteral("缺少金额列");
+        } else {
+            bool ok = false;
+            const QString amountText = unquote(fields.at(1));
+            row.amount = Money::fromString(amountText, &ok);
+            if (!ok) {
+                row.error = QStringLiteral("金额格式无效：%1").arg(amountText);
+            } else if (!row.amount.isPositive()) {
+                row.error = QStringLiteral("充值金额必须大于0");
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+QString RechargeCsvReader::unquote(const QString& field) {
+    QString text = field.trimmed();
+    if (text.size() >= 2 && text.startsWith(QLatin1Char('"')) &&
+        text.endsWith(QLatin1Char('"'))) {
+        text = text.mid(1, text.size() - 2).trimmed();
+    }
+    return text;
+}
+
+}  // namespace CampusCard
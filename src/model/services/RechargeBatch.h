@@ -0,0 +1,110 @@
+/**
+ * @file RechargeBatch.h
+ * @brief 批量充值文件的读取与结果报告
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 财务下发的充值文件为CSV，每行一笔充值（卡号,金额[,备注]），按行流式读取，
+ * 每行单独校验，错误按行号报告
+ */
+
+#ifndef MODEL_SERVICES_RECHARGEBATCH_H
+#define MODEL_SERVICES_RECHARGEBATCH_H
+
+#include "model/Money.h"
+
+#include <QList>
+#include <QString>
+#include <QTextStream>
+
+class QIODevice;
+
+namespace CampusCard {
+
+/**
+ * @struct RechargeRow
+ * @brief 充值文件中的一行
+ */
+struct RechargeRow {
+    int line = 0;    ///< 行号（从1开始）
+    QString cardId;  ///< 卡号
+    Money amount;    ///< 充值金额
+    QString error;   ///< 校验错误（为空表示有效）
+
+    /**
+     * @brief 是否通过校验
+     */
+    [[nodiscard]] bool isValid() const { return error.isEmpty(); }
+};
+
+/**
+ * @struct RechargeRowError
+ * @brief 一行的校验错误
+ */
+struct RechargeRowError {
+    int line = 0;     ///< 行号（0表示整个文件的错误，如无法打开）
+    QString cardId;   ///< 卡号（可能为空）
+    QString message;  ///< 错误说明
+};
+
+/**
+ * @struct RechargeBatchReport
+ * @brief 批量充值结果
+ */
+struct RechargeBatchReport {
+    int rows = 0;                    ///< 读取的数据行数
+    int validRows = 0;               ///< 通过校验的行数
+    Money total;                     ///< 通过校验的充值金额合计
+    int applied = 0;                 ///< 实际充值的行数（仅校验或有错误时为0）
+    bool saved = false;              ///< 充值后是否已保存
+    QList<RechargeRowError> errors;  ///< 错误（按行号递增）
+
+    /**
+     * @brief 是否没有任何错误
+     */
+    [[nodiscard]] bool isClean() const { return errors.isEmpty(); }
+
+    /**
+     * @brief 一行文字摘要（界面提示和命令行输出共用）
+     */
+    [[nodiscard]] QString summary() const;
+};
+
+/**
+ * @class RechargeCsvReader
+ * @brief 充值文件的流式读取器
+ *
+ * 每次读取一行，不把整个文件读入内存。空行和以#开头的行被跳过；
+ * 第一个数据行的首列为"卡号"或"cardId"时视为表头。字段两侧的空白和引号被去除，
+ * 金额按元书写，最多两位小数，必须大于0；第三列及之后的内容被忽略。
+ */
+class RechargeCsvReader {
+public:
+    /**
+     * @brief 构造函数
+     * @param device 已打开的输入设备（调用方保证其生命周期）
+     */
+    explicit RechargeCsvReader(QIODevice* device);
+
+    /**
+     * @brief 读取下一个数据行
+     * @param row 输出的行（格式或金额无效时error非空，卡是否存在由调用方检查）
+     * @return 是否读到一行（到达文件末尾时返回false）
+     */
+    bool readNext(RechargeRow& row);
+
+private:
+    /**
+     * @brief 去除字段两侧的空白和引号
+     */
+    static QString unquote(const QString& field);
+
+    QTextStream m_stream;          ///< 文本流
+    int m_lineNumber = 0;          ///< 已读取的行数
+    bool m_headerChecked = false;  ///< 是否已检查过表头
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_RECHARGEBATCH_H
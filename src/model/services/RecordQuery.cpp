@@ -0,0 +1,128 @@
+/**
+ * @file RecordQuery.cpp
+ * @brief 上机记录组合查询实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "RecordQuery.h"
+
+namespace CampusCard {
+
+// ========== 过滤条件 ==========
+
+RecordQuery& RecordQuery::card(const QString& cardId) {
+    m_cardId = cardId;
+    return *this;
+}
+
+RecordQuery& RecordQuery::dateRange(const QString& startDate, const QString& endDate) {
+    m_startDate = startDate;
+    m_endDate = endDate;
+    return *this;
+}
+
+RecordQuery& RecordQuery::location(const QString& location) {
+    if (location.isEmpty()) {
+        m_location.reset();
+    } else {
+        m_location = location;
+    }
+    return *this;
+}
+
+RecordQuery& RecordQuery::state(SessionState state) {
+    m_state = state;
+    return *this;
+}
+
+RecordQuery& RecordQuery::durationBetween(int minMinutes, int maxMinutes) {
+    m_minDuration = minMinutes;
+    m_maxDuration = maxMinutes;
+    return *this;
+}
+
+RecordQuery& RecordQuery::costBetween(Money minCost, Money maxCost) {
+    m_minCost = minCost;
+    m_maxCost = maxCost;
+    return *this;
+}
+
+// ========== 排序与分页 ==========
+
+RecordQuery& RecordQuery::orderBy(SortField field, bool descending) {
+    m_sortField = field;
+    m_sortDescending = descending;
+    return *this;
+}
+
+RecordQuery& RecordQuery::limit(int count) {
+    m_limit = count;
+    return *this;
+}
+
+RecordQuery& RecordQuery::offset(int count) {
+    m_offset = qMax(0, count);
+    return *this;
+}
+
+// ========== 条件检查 ==========
+
+bool RecordQuery::matches(const Record& record) const {
+    if (m_cardId && record.cardId() != *m_cardId) {
+        return false;
+    }
+    // 日期为yyyy-MM-dd格式，字典序即日期顺序
+    if (m_startDate && record.date() < *m_startDate) {
+        return false;
+    }
+    if (m_endDate && record.date() > *m_endDate) {
+        return false;
+    }
+    if (m_location && record.location() != *m_location) {
+        return false;
+    }
+    if (m_state && record.state() != *m_state) {
+        return false;
+    }
+    if (m_minDuration && record.durationMinutes() < *m_minDuration) {
+        return false;
+    }
+    if (m_maxDuration && record.durationMinutes() > *m_maxDuration) {
+        return false;
+    }
+    if (m_minCost && record.cost() < *m_minCost) {
+        return false;
+    }
+    if (m_maxCost && record.cost() > *m_maxCost) {
+        return false;
+    }
+    return true;
+}
+
+bool RecordQuery::lessThan(const Record& a, const Record& b) const {
+    const Record& lhs = m_sortDescending ? b : a;
+    const Record& rhs = m_sortDescending ? a : b;
+
+    switch (m_sortField) {
+    case SortField::StartTime:
+        return lhs.startTime() < rhs.startTime();
+    case SortField::Duration:
+        return lhs.durationMinutes() < rhs.durationMinutes();
+    case SortField::Cost:
+        return lhs.cost() < rhs.cost();
+    case SortField::Location:
+        return lhs.location() < rhs.location();
+    case SortField::CardId:
+        return lhs.cardId() < rhs.cardId();
+    case SortField::RecordId:
+        return lhs.id() < rhs.id();
+    case SortField::None:
+    default:
+        return false;
+    }
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,212 @@
+/**
+ * @file RecordQuery.h
+ * @brief 上机记录组合查询
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 提供可组合的记录查询条件、排序、分页和分组聚合描述，
+ * 由RecordService根据可用索引选择执行计划
+ */
+
+#ifndef MODEL_SERVICES_RECORDQUERY_H
+#define MODEL_SERVICES_RECORDQUERY_H
+
+#include "model/entities/Record.h"
+
+#include <QList>
+#include <QString>
+
+#include <optional>
+
+
+namespace CampusCard {
+
+/**
+ * @class RecordQuery
+ * @brief 记录查询构建器
+ *
+ * 所有条件之间为"与"关系，未设置的条件不参与过滤。示例：
+ * @code
+ * RecordQuery query;
+ * query.card("C001").dateRange("2024-09-01", "2024-09-30").location("机房A101")
+ *      .orderBy(RecordQuery::SortField::StartTime, true).limit(20);
+ * @endcode
+ */
+class RecordQuery {
+public:
+    /**
+     * @brief 排序字段
+     */
+    enum class SortField {
+        None,       ///< 保持索引顺序
+        StartTime,  ///< 开始时间
+        Duration,   ///< 时长
+        Cost,       ///< 费用
+        Location,   ///< 地点
+        CardId,     ///< 卡号
+        RecordId    ///< 记录ID（即创建顺序）
+    };
+
+    /**
+     * @brief 分组字段
+     */
+    enum class GroupField {
+        Card,     ///< 按卡号分组
+        Date,     ///< 按日期分组
+        Location  ///< 按地点分组
+    };
+
+    // ========== 过滤条件 ==========
+
+    /**
+     * @brief 限定卡号
+     * @param cardId 卡号
+     * @return 自身引用
+     */
+    RecordQuery& card(const QString& cardId);
+
+    /**
+     * @brief 限定日期闭区间
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @return 自身引用
+     */
+    RecordQuery& dateRange(const QString& startDate, const QString& endDate);
+
+    /**
+     * @brief 限定单日
+     * @param date 日期（yyyy-MM-dd）
+     * @return 自身引用
+     */
+    RecordQuery& date(const QString& date) { return dateRange(date, date); }
+
+    /**
+     * @brief 限定地点（空字符串表示不筛选）
+     * @param location 地点
+     * @return 自身引用
+     */
+    RecordQuery& location(const QString& location);
+
+    /**
+     * @brief 限定上机状态
+     * @param state 状态
+     * @return 自身引用
+     */
+    RecordQuery& state(SessionState state);
+
+    /**
+     * @brief 限定时长区间（分钟，闭区间）
+     * @param minMinutes 最小时长
+     * @param maxMinutes 最大时长
+     * @return 自身引用
+     */
+    RecordQuery& durationBetween(int minMinutes, int maxMinutes);
+
+    /**
+     * @brief 限定费用区间（闭区间）
+     * @param minCost 最小费用
+     * @param maxCost 最大费用
+     * @return 自身引用
+     */
+    RecordQuery& costBetween(Money minCost, Money maxCost);
+
+    // ========== 排序与分页 ==========
+
+    /**
+     * @brief 设置排序
+     * @param field 排序字段
+     * @param descending 是否降序
+     * @return 自身引用
+     */
+    RecordQuery& orderBy(SortField field, bool descending = false);
+
+    /**
+     * @brief 设置最大返回行数（负数表示不限制）
+     * @param count 行数
+     * @return 自身引用
+     */
+    RecordQuery& limit(int count);
+
+    /**
+     * @brief 设置跳过的行数
+     * @param count 行数
+     * @return 自身引用
+     */
+    RecordQuery& offset(int count);
+
+    // ========== 条件检查 ==========
+
+    /**
+     * @brief 检查记录是否满足全部过滤条件
+     * @param record 记录
+     * @return 是否满足
+     */
+    [[nodiscard]] bool matches(const Record& record) const;
+
+    // ========== 条件访问（供执行计划使用） ==========
+
+    [[nodiscard]] const std::optional<QString>& cardFilter() const { return m_cardId; }
+    [[nodiscard]] const std::optional<QString>& startDateFilter() const { return m_startDate; }
+    [[nodiscard]] const std::optional<QString>& endDateFilter() const { return m_endDate; }
+    [[nodiscard]] const std::optional<QString>& locationFilter() const { return m_location; }
+    [[nodiscard]] SortField sortField() const { return m_sortField; }
+    [[nodiscard]] bool sortDescending() const { return m_sortDescending; }
+    [[nodiscard]] int limitCount() const { return m_limit; }
+    [[nodiscard]] int offsetCount() const { return m_offset; }
+
+    /**
+     * @brief 按排序设置比较两条记录
+     * @return a是否应排在b之前
+     */
+    [[nodiscard]] bool lessThan(const Record& a, const Record& b) const;
+
+private:
+    std::optional<QString> m_cardId;        ///< 卡号
+    std::optional<QString> m_startDate;     ///< 开始日期
+    std::optional<QString> m_endDate;       ///< 结束日期
+    std::optional<QString> m_location;      ///< 地点
+    std::optional<SessionState> m_state;    ///< 状态
+    std::optional<int> m_minDuration;       ///< 最小时长
+    std::optional<int> m_maxDuration;       ///< 最大时长
+    std::optional<Money> m_minCost;         ///< 最小费用
+    std::optional<Money> m_maxCost;         ///< 最大费用
+    SortField m_sortField = SortField::None;  ///< 排序字段
+    bool m_sortDescending = false;          ///< 是否降序
+    int m_limit = -1;                       ///< 最大行数
+    int m_offset = 0;                       ///< 跳过行数
+};
+
+/**
+ * @struct RecordQueryPlan
+ * @brief 查询执行计划
+ */
+struct RecordQueryPlan {
+    /**
+     * @brief 访问路径
+     */
+    enum class Access {
+        FullScan,       ///< 扫描所有记录
+        CardIndex,      ///< 按卡号索引
+        DayIndex,       ///< 按日期索引
+        LocationIndex   ///< 按地点索引
+    };
+
+    Access access = Access::FullScan;  ///< 选中的访问路径
+    qsizetype candidateRows = 0;       ///< 访问路径产生的候选行数（下推过滤前）
+};
+
+/**
+ * @struct RecordGroup
+ * @brief 分组聚合结果
+ */
+struct RecordGroup {
+    QString key;            ///< 分组键
+    int count = 0;          ///< 记录数
+    int totalDuration = 0;  ///< 总时长（分钟）
+    Money totalCost;        ///< 总费用
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_RECORDQUERY_H
@@ -10,8 +10,13 @@
 #include "RecordService.h"
 
 #include <QDateTime>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QReadLocker>
 #include <QSet>
-#include <QUuid>
+#include <QWriteLocker>
+
+#include <algorithm>
 
 
 namespace CampusCard {
@@ -21,13 +26,18 @@ RecordService::RecordService(QObject* parent) : QObject(parent) {}
 void RecordService::initialize() {
     // 加载所有卡数据，建立卡号到学号的映射
     QList<Card> cards = StorageManager::instance().loadAllCards();
+    TariffEngine tariff(Tariff::fromJson(StorageManager::instance().loadTariff()));
+
+    // 加载所有记录（文件以学号命名，但内存中以卡号索引）
+    QMap<QString, QList<Record>> allRecords = StorageManager::instance().loadAllRecords();
+    QMap<QString, QJsonObject> rollups = StorageManager::instance().loadAllRollups();
+
+    QWriteLocker locker(&m_lock);
     m_cardToStudentId.clear();
     for (const auto& card : cards) {
         m_cardToStudentId[card.cardId()] = card.studentId();
     }
-
-    // 加载所有记录（文件以学号命名，但内存中以卡号索引）
-    QMap<QString, QList<Record>> allRecords = StorageManager::instance().loadAllRecords();
+    m_tariff = tariff;
     m_records.clear();
     m_activeSessions.clear();
 
@@ -40,28 +50,116 @@ void RecordService::initialize() {
             // 检查是否有未结束的会话
             for (const auto& record : m_records[cardId]) {
                 if (record.isOnline()) {
-                    m_activeSessions[cardId] = record.recordId();
+                    m_activeSessions[cardId] = record.id();
                 }
             }
         }
     }
+
+    rebuildIndexes();
+
+    // 合并持久化的草图，保留已不在记录文件中的历史日期；
+    // 草图合并是幂等的，因此同一记录不会被重复计数
+    for (auto it = rollups.constBegin(); it != rollups.constEnd(); ++it) {
+        m_distinctUsers.mergeDayJson(QDate::fromString(it.key(), QStringLiteral("yyyy-MM-dd")),
+                                     it.value()[QStringLiteral("distinctUsers")].toObject());
+    }
 }
 
-void RecordService::loadRecordsForCard(const QString& cardId) {
-    QString studentId = getStudentIdByCardId(cardId);
-    if (!studentId.isEmpty()) {
-        m_records[cardId] = StorageManager::instance().loadRecords(studentId);
+// ========== 查询索引 ==========
+
+int RecordService::cardOrdinal(const QString& cardId) {
+    auto it = m_cardOrdinals.constFind(cardId);
+    if (it != m_cardOrdinals.constEnd()) {
+        return it.value();
     }
+    int ordinal = static_cast<int>(m_ordinalCards.size());
+    m_ordinalCards.append(cardId);
+    m_cardOrdinals.insert(cardId, ordinal);
+    return ordinal;
 }
 
-void RecordService::saveRecordsForCard(const QString& cardId) {
-    if (m_records.contains(cardId)) {
+void RecordService::indexRecord(const QString& cardId, const Record& record, int row) {
+    RecordLocator locator{cardOrdinal(cardId), row};
+    m_dayIndex[record.date()].append(locator);
+    m_locationIndex[record.location()].append(locator);
+    m_dayCards[record.date()].add(static_cast<quint32>(locator.card));
+    m_locationCards[record.location()].add(static_cast<quint32>(locator.card));
+    ++m_recordCount;
+}
+
+void RecordService::accumulateFinished(const Record& record) {
+    if (!record.isOffline()) {
+        return;
+    }
+    m_heatmap.addRecord(record);
+    m_ranking.addRecord(record);
+    m_ledger.addRecord(record);
+    m_distinctUsers.addRecord(record);
+}
+
+void RecordService::rebuildIndexes() {
+    m_cardOrdinals.clear();
+    m_ordinalCards.clear();
+    m_dayIndex.clear();
+    m_locationIndex.clear();
+    m_recordCount = 0;
+    m_dayCards.clear();
+    m_locationCards.clear();
+    m_heatmap.clear();
+    m_ranking.clear();
+    m_ledger.clear();
+    m_distinctUsers.clear();
+
+    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+        for (int row = 0; row < it.value().size(); ++row) {
+            indexRecord(it.key(), it.value().at(row), row);
+            accumulateFinished(it.value().at(row));
+        }
+    }
+}
+
+RecordService::PendingWrites RecordService::collectWrites(const QStringList& cardIds,
+                                                          const QStringList& dates) const {
+    PendingWrites writes;
+    for (const auto& cardId : cardIds) {
+        auto it = m_records.constFind(cardId);
+        if (it == m_records.constEnd()) {
+            continue;
+        }
         QString studentId = getStudentIdByCardId(cardId);
         if (!studentId.isEmpty()) {
             // 根据文档要求，记录文件以学号命名（如 B17010101.txt）
-            StorageManager::instance().saveRecords(studentId, m_records[cardId]);
+            writes.records.append({studentId, it.value()});
         }
     }
+    for (const auto& date : dates) {
+        QJsonObject rollup;
+        rollup[QStringLiteral("distinctUsers")] = m_distinctUsers.dayToJson(
+            QDate::fromString(date, QStringLiteral("yyyy-MM-dd")));
+        writes.rollups.append({date, rollup});
+    }
+    return writes;
+}
+
+bool RecordService::writeFiles(const PendingWrites& writes) {
+    bool ok = true;
+    for (const auto& [studentId, records] : writes.records) {
+        ok = StorageManager::instance().saveRecords(studentId, records) && ok;
+    }
+    for (const auto& [date, rollup] : writes.rollups) {
+        ok = StorageManager::instance().saveRollup(date, rollup) && ok;
+    }
+    return ok;
+}
+
+bool RecordService::flush(const QStringList& cardIds, const QStringList& dates) {
+    // 在保存锁内取快照，保证后写入文件的快照不早于先写入的
+    QMutexLocker saveLocker(&m_saveMutex);
+    QReadLocker locker(&m_lock);
+    const PendingWrites writes = collectWrites(cardIds, dates);
+    locker.unlock();
+    return writeFiles(writes);
 }
 
 QString RecordService::getStudentIdByCardId(const QString& cardId) const {
@@ -77,198 +175,428 @@ QString RecordService::getStudentIdByCardId(const QString& cardId) const {
 }
 
 void RecordService::registerCardStudentMapping(const QString& cardId, const QString& studentId) {
+    QWriteLocker locker(&m_lock);
     m_cardToStudentId[cardId] = studentId;
 }
 
-double RecordService::calculateCost(int durationMinutes) const {
-    return (durationMinutes / 60.0) * COST_PER_HOUR;
+Money RecordService::calculateCost(const QString& cardId, const QString& location,
+                                   const QDateTime& start, int durationMinutes) const {
+    return m_tariff.cost(location, start, durationMinutes, getStudentIdByCardId(cardId));
 }
 
 // ========== 上下机操作 ==========
 
 Record RecordService::startSession(const QString& cardId, const QString& location) {
-    // 检查是否已在上机
-    if (isOnline(cardId)) {
-        return Record();  // 返回无效记录表示失败
-    }
-
-    // 创建新记录
     Record newRecord;
-    newRecord.setRecordId(QUuid::createUuid().toString(QUuid::WithoutBraces));
-    newRecord.setCardId(cardId);
-    newRecord.setLocation(location);
-    newRecord.setStartTime(QDateTime::currentDateTime());
-    newRecord.setState(SessionState::Online);
-    newRecord.setDurationMinutes(0);
-    newRecord.setCost(0.0);
-
-    // 添加到记录列表
-    if (!m_records.contains(cardId)) {
-        m_records[cardId] = QList<Record>();
-    }
-    m_records[cardId].append(newRecord);
+    {
+        QMutexLocker saveLocker(&m_saveMutex);
+        QWriteLocker locker(&m_lock);
+        // 检查是否已在上机
+        if (hasActiveSession(cardId)) {
+            return Record();  // 返回无效记录表示失败
+        }
 
-    // 设置活动会话记录ID
-    m_activeSessions[cardId] = newRecord.recordId();
+        // 创建新记录
+        newRecord.setId(RecordIdGenerator::instance().next());
+        newRecord.setCardId(cardId);
+        newRecord.setLocation(location);
+        newRecord.setStartTime(m_clock->now());
+        newRecord.setState(SessionState::Online);
+        newRecord.setDurationMinutes(0);
+        newRecord.setCost(Money());
+
+        // 添加到记录列表
+        QList<Record>& list = m_records[cardId];
+        list.append(newRecord);
+        indexRecord(cardId, newRecord, static_cast<int>(list.size()) - 1);
+
+        // 设置活动会话记录ID
+        m_activeSessions[cardId] = newRecord.id();
+
+        // 释放写锁后写文件
+        const PendingWrites writes = collectWrites({cardId}, QStringList());
+        locker.unlock();
+        writeFiles(writes);
+    }
 
-    // 保存并发出信号
-    saveRecordsForCard(cardId);
+    // 释放锁后发出信号
     emit sessionStarted(cardId, location);
     emit recordsChanged(cardId);
 
     return newRecord;
 }
 
-double RecordService::endSession(const QString& cardId) {
-    // 检查是否在上机
-    if (!isOnline(cardId)) {
-        return -1.0;
+Money RecordService::endSession(const QString& cardId) {
+    // 计算和结束在同一次加锁内完成，并发下机同一张卡只有一次生效
+    Record closed;
+    {
+        QMutexLocker saveLocker(&m_saveMutex);
+        QWriteLocker locker(&m_lock);
+        closed = closedSession(cardId);
+        if (!closed.isValid() || !closeSession(cardId, closed)) {
+            return Money::fromCents(-1);
+        }
+        const PendingWrites writes = collectWrites({cardId}, {closed.date()});
+        locker.unlock();
+        writeFiles(writes);
     }
 
-    // 获取当前会话记录ID
-    QString recordId = m_activeSessions[cardId];
-    if (recordId.isEmpty()) {
-        return -1.0;
+    emit sessionEnded(cardId, closed.cost(), closed.durationMinutes());
+    emit recordsChanged(cardId);
+    return closed.cost();
+}
+
+Record RecordService::prepareEndSession(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    return closedSession(cardId);
+}
+
+Record RecordService::closedSession(const QString& cardId) const {
+    Record record = activeSession(cardId);
+    if (!record.isValid() || !record.isOnline()) {
+        return Record();
     }
 
-    // 查找并结束会话
-    double cost = -1.0;
-    int duration = 0;
-    for (auto& record : m_records[cardId]) {
-        if (record.recordId() == recordId) {
-            // 计算时长和费用
-            QDateTime endTime = QDateTime::currentDateTime();
-            qint64 secs = record.startTime().secsTo(endTime);
-            duration = static_cast<int>((secs + 59) / 60);  // 向上取整到分钟
-            cost = calculateCost(duration);
+    // 计算时长和费用
+    QDateTime endTime = m_clock->now();
+    qint64 secs = record.startTime().secsTo(endTime);
+    int duration = static_cast<int>((secs + 59) / 60);  // 向上取整到分钟
+
+    record.setCardId(cardId);
+    record.setEndTime(endTime);
+    record.setDurationMinutes(duration);
+    record.setCost(calculateCost(cardId, record.location(), record.startTime(), duration));
+    record.setState(SessionState::Offline);
+    return record;
+}
+
+bool RecordService::closeSession(const QString& cardId, const Record& closed) {
+    auto it = m_records.find(cardId);
+    if (it == m_records.end()) {
+        return false;
+    }
 
-            // 更新记录
-            record.setEndTime(endTime);
-            record.setDurationMinutes(duration);
-            record.setCost(cost);
+    // 查找并结束会话（已结束的记录不再重复处理）
+    for (auto& record : it.value()) {
+        if (record.id() == closed.id()) {
+            if (!record.isOnline()) {
+                return false;
+            }
+            record.setEndTime(closed.endTime());
+            record.setDurationMinutes(closed.durationMinutes());
+            record.setCost(closed.cost());
             record.setState(SessionState::Offline);
-            break;
+            accumulateFinished(record);
+
+            // 清除活动会话
+            if (m_activeSessions.value(cardId) == closed.id()) {
+                m_activeSessions.remove(cardId);
+            }
+            return true;
         }
     }
+    return false;
+}
+
+bool RecordService::applyEndSession(const QString& cardId, const Record& closed, bool persist,
+                                    bool notify) {
+    {
+        QMutexLocker saveLocker(persist ? &m_saveMutex : nullptr);
+        QWriteLocker locker(&m_lock);
+        if (!closeSession(cardId, closed)) {
+            return false;
+        }
 
-    if (cost < 0) {
-        return -1.0;
+        // 保存
+        if (persist) {
+            const PendingWrites writes = collectWrites({cardId}, {closed.date()});
+            locker.unlock();
+            writeFiles(writes);
+        }
     }
 
-    // 清除活动会话
-    m_activeSessions.remove(cardId);
+    if (notify) {
+        notifySessionEnded(cardId, closed);
+    }
+    return true;
+}
 
-    // 保存并发出信号
-    saveRecordsForCard(cardId);
-    emit sessionEnded(cardId, cost, duration);
+void RecordService::notifySessionEnded(const QString& cardId, const Record& closed) {
+    emit sessionEnded(cardId, closed.cost(), closed.durationMinutes());
     emit recordsChanged(cardId);
+}
 
-    return cost;
+// ========== 批量上下机 ==========
+
+QList<Record> RecordService::startSessions(const QStringList& cardIds, const QString& location) {
+    QList<Record> started;
+    QStringList touched;
+    {
+        QMutexLocker saveLocker(&m_saveMutex);
+        QWriteLocker locker(&m_lock);
+        const QDateTime now = m_clock->now();
+        for (const auto& cardId : cardIds) {
+            if (hasActiveSession(cardId)) {
+                continue;  // 已在上机，或在本批中重复出现
+            }
+
+            Record newRecord;
+            newRecord.setId(RecordIdGenerator::instance().next());
+            newRecord.setCardId(cardId);
+            newRecord.setLocation(location);
+            newRecord.setStartTime(now);
+            newRecord.setState(SessionState::Online);
+
+            QList<Record>& list = m_records[cardId];
+            list.append(newRecord);
+            indexRecord(cardId, newRecord, static_cast<int>(list.size()) - 1);
+            m_activeSessions[cardId] = newRecord.id();
+            started.append(newRecord);
+            touched.append(cardId);
+        }
+        if (started.isEmpty()) {
+            return started;
+        }
+
+        const PendingWrites writes = collectWrites(touched, QStringList());
+        locker.unlock();
+        writeFiles(writes);
+    }
+
+    emit recordsBatchChanged(touched);
+    return started;
 }
 
-bool RecordService::isOnline(const QString& cardId) const {
-    return m_activeSessions.contains(cardId) && !m_activeSessions[cardId].isEmpty();
+QList<Record> RecordService::endSessions(const QStringList& cardIds) {
+    QList<Record> applied;
+    {
+        QMutexLocker saveLocker(&m_saveMutex);
+        QWriteLocker locker(&m_lock);
+        QList<Record> closed;
+        QSet<QString> seen;
+        for (const auto& cardId : cardIds) {
+            Record record = closedSession(cardId);
+            if (record.isValid() && !seen.contains(cardId)) {
+                seen.insert(cardId);
+                closed.append(record);
+            }
+        }
+        applied = closeSessions(closed);
+        if (applied.isEmpty()) {
+            return applied;
+        }
+        const PendingWrites writes = collectWrites(cardIdsOf(applied), datesOf(applied));
+        locker.unlock();
+        writeFiles(writes);
+    }
+
+    emit recordsBatchChanged(cardIdsOf(applied));
+    return applied;
 }
 
-Record RecordService::getCurrentSession(const QString& cardId) const {
-    if (!m_activeSessions.contains(cardId)) {
-        return Record();
+QList<Record> RecordService::applyEndSessions(const QList<Record>& closed, bool persist,
+                                              bool notify) {
+    QList<Record> applied;
+    {
+        QMutexLocker saveLocker(persist ? &m_saveMutex : nullptr);
+        QWriteLocker locker(&m_lock);
+        applied = closeSessions(closed);
+        if (persist && !applied.isEmpty()) {
+            const PendingWrites writes = collectWrites(cardIdsOf(applied), datesOf(applied));
+            locker.unlock();
+            writeFiles(writes);
+        }
     }
 
-    QString recordId = m_activeSessions[cardId];
-    if (recordId.isEmpty()) {
-        return Record();
+    if (notify) {
+        notifySessionsEnded(applied);
     }
+    return applied;
+}
 
-    // 查找记录
-    if (m_records.contains(cardId)) {
-        for (const auto& record : m_records[cardId]) {
-            if (record.recordId() == recordId) {
-                return record;
-            }
+void RecordService::notifySessionsEnded(const QList<Record>& applied) {
+    if (!applied.isEmpty()) {
+        emit recordsBatchChanged(cardIdsOf(applied));
+    }
+}
+
+QList<Record> RecordService::closeSessions(const QList<Record>& closed) {
+    QList<Record> applied;
+    for (const auto& record : closed) {
+        if (closeSession(record.cardId(), record)) {
+            applied.append(record);
         }
     }
-    return Record();
+    return applied;
+}
+
+QStringList RecordService::cardIdsOf(const QList<Record>& records) {
+    QStringList cardIds;
+    cardIds.reserve(records.size());
+    for (const auto& record : records) {
+        cardIds.append(record.cardId());
+    }
+    return cardIds;
 }
 
-Record* RecordService::getCurrentSessionPtr(const QString& cardId) {
-    if (!m_activeSessions.contains(cardId)) {
-        return nullptr;
+QStringList RecordService::datesOf(const QList<Record>& records) {
+    QSet<QString> dates;
+    for (const auto& record : records) {
+        dates.insert(record.date());
     }
+    return QStringList(dates.cbegin(), dates.cend());
+}
+
+bool RecordService::isOnline(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    return hasActiveSession(cardId);
+}
+
+bool RecordService::hasActiveSession(const QString& cardId) const {
+    auto it = m_activeSessions.constFind(cardId);
+    return it != m_activeSessions.constEnd() && !it.value().isNull();
+}
 
-    QString recordId = m_activeSessions[cardId];
-    if (recordId.isEmpty()) {
-        return nullptr;
+Record RecordService::getCurrentSession(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    return activeSession(cardId);
+}
+
+Record RecordService::activeSession(const QString& cardId) const {
+    if (!hasActiveSession(cardId)) {
+        return Record();
     }
+    const RecordId recordId = m_activeSessions.value(cardId);
 
     // 查找记录
-    if (m_records.contains(cardId)) {
-        for (auto& record : m_records[cardId]) {
-            if (record.recordId() == recordId) {
-                return &record;
+    auto it = m_records.constFind(cardId);
+    if (it != m_records.constEnd()) {
+        for (const auto& record : it.value()) {
+            if (record.id() == recordId) {
+                return record;
             }
         }
     }
-    return nullptr;
+    return Record();
 }
 
-double RecordService::calculateCurrentCost(const QString& cardId) const {
-    Record session = getCurrentSession(cardId);
+Money RecordService::calculateCurrentCost(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    Record session = activeSession(cardId);
     if (!session.isValid() || !session.isOnline()) {
-        return -1.0;
+        return Money::fromCents(-1);
     }
 
     // 计算截至当前的时长和费用
-    QDateTime now = QDateTime::currentDateTime();
+    QDateTime now = m_clock->now();
     qint64 secs = session.startTime().secsTo(now);
     int minutes = static_cast<int>((secs + 59) / 60);
-    return calculateCost(minutes);
+    return calculateCost(cardId, session.location(), session.startTime(), minutes);
 }
 
-// ========== 记录查询 ==========
+int RecordService::affordableMinutes(const QString& cardId, Money budget) const {
+    QReadLocker locker(&m_lock);
+    Record session = activeSession(cardId);
+    if (!session.isValid() || !session.isOnline()) {
+        return -1;
+    }
 
-QList<Record> RecordService::getRecords(const QString& cardId) const {
-    if (m_records.contains(cardId)) {
-        return m_records[cardId];
+    auto costOf = [&](int minutes) {
+        return calculateCost(cardId, session.location(), session.startTime(), minutes);
+    };
+
+    // 不变式：costOf(low) <= budget < costOf(high)
+    constexpr int MAX_PROJECTED_MINUTES = 366 * 24 * 60;
+    if (costOf(MAX_PROJECTED_MINUTES) <= budget) {
+        return -1;
     }
-    return QList<Record>();
+    if (costOf(0) > budget) {
+        return 0;
+    }
+    int low = 0;
+    int high = MAX_PROJECTED_MINUTES;
+    while (high - low > 1) {
+        const int mid = low + (high - low) / 2;
+        if (costOf(mid) <= budget) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
 }
 
-QList<Record> RecordService::getRecordsByDate(const QString& cardId, const QString& date) const {
-    QList<Record> result;
-    if (!m_records.contains(cardId)) {
-        return result;
+// ========== 记录补录 ==========
+
+int RecordService::importRecords(const QString& cardId, const QList<Record>& records) {
+    QMutexLocker saveLocker(&m_saveMutex);
+    QWriteLocker locker(&m_lock);
+    QSet<RecordId> existingIds;
+    auto existing = m_records.constFind(cardId);
+    if (existing != m_records.constEnd()) {
+        for (const auto& record : existing.value()) {
+            existingIds.insert(record.id());
+        }
     }
 
-    for (const auto& record : m_records[cardId]) {
-        if (record.date() == date) {
-            result.append(record);
+    QList<Record> accepted;
+    for (Record record : records) {
+        if (!record.isOffline() || record.id().isNull() || existingIds.contains(record.id())) {
+            continue;
         }
+        record.setCardId(cardId);
+        existingIds.insert(record.id());
+        accepted.append(record);
+    }
+    if (accepted.isEmpty()) {
+        return 0;
     }
-    return result;
-}
 
-QList<Record> RecordService::getRecordsByDateRange(const QString& cardId, const QString& startDate,
-                                                    const QString& endDate) const {
-    QList<Record> result;
-    if (!m_records.contains(cardId)) {
-        return result;
+    QList<Record>& target = m_records[cardId];
+    QSet<QString> touchedDates;
+    for (const auto& record : accepted) {
+        target.append(record);
+        indexRecord(cardId, record, static_cast<int>(target.size()) - 1);
+        accumulateFinished(record);
+        touchedDates.insert(record.date());
     }
 
-    QDate start = QDate::fromString(startDate, QStringLiteral("yyyy-MM-dd"));
-    QDate end = QDate::fromString(endDate, QStringLiteral("yyyy-MM-dd"));
+    const PendingWrites writes =
+        collectWrites({cardId}, QStringList(touchedDates.cbegin(), touchedDates.cend()));
+    locker.unlock();
+    writeFiles(writes);
+    saveLocker.unlock();
 
-    for (const auto& record : m_records[cardId]) {
-        QDate recordDate = QDate::fromString(record.date(), QStringLiteral("yyyy-MM-dd"));
-        if (recordDate >= start && recordDate <= end) {
-            result.append(record);
-        }
+    emit recordsChanged(cardId);
+    return static_cast<int>(accepted.size());
+}
+
+// ========== 记录查询 ==========
+
+QList<Record> RecordService::getRecords(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    auto it = m_records.constFind(cardId);
+    if (it != m_records.constEnd()) {
+        return it.value();
     }
-    return result;
+    return QList<Record>();
+}
+
+QList<Record> RecordService::getRecordsByDate(const QString& cardId, const QString& date) const {
+    // 在锁内把视图复制为列表
+    QReadLocker locker(&m_lock);
+    return runQuery(RecordQuery().card(cardId).date(date)).toList();
+}
+
+QList<Record> RecordService::getRecordsByDateRange(const QString& cardId, const QString& startDate,
+                                                    const QString& endDate) const {
+    QReadLocker locker(&m_lock);
+    return runQuery(RecordQuery().card(cardId).dateRange(startDate, endDate)).toList();
 }
 
 QList<Record> RecordService::getRecordsByLocation(const QString& cardId,
                                                    const QString& location) const {
+    QReadLocker locker(&m_lock);
     QList<Record> result;
     if (!m_records.contains(cardId)) {
         return result;
@@ -283,19 +611,12 @@ QList<Record> RecordService::getRecordsByLocation(const QString& cardId,
 }
 
 QList<Record> RecordService::getAllRecordsByDate(const QString& date) const {
-    QList<Record> result;
-
-    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
-        for (const auto& record : it.value()) {
-            if (record.date() == date) {
-                result.append(record);
-            }
-        }
-    }
-    return result;
+    QReadLocker locker(&m_lock);
+    return runQuery(RecordQuery().date(date)).toList();
 }
 
 QStringList RecordService::getLocations(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
     QSet<QString> locations;
     if (m_records.contains(cardId)) {
         for (const auto& record : m_records[cardId]) {
@@ -307,9 +628,420 @@ QStringList RecordService::getLocations(const QString& cardId) const {
     return locations.values();
 }
 
+// ========== 视图查询 ==========
+
+RecordView RecordService::recordsView(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    return RecordView(m_records.value(cardId));
+}
+
+RecordView RecordService::recordsViewByDate(const QString& cardId, const QString& date) const {
+    QReadLocker locker(&m_lock);
+    return runQuery(RecordQuery().card(cardId).date(date));
+}
+
+RecordView RecordService::filteredRecordsView(const QString& cardId, const QString& startDate,
+                                              const QString& endDate,
+                                              const QString& location) const {
+    QReadLocker locker(&m_lock);
+    return runQuery(
+        RecordQuery().card(cardId).dateRange(startDate, endDate).location(location));
+}
+
+RecordView RecordService::allRecordsViewByDate(const QString& date) const {
+    QReadLocker locker(&m_lock);
+    return runQuery(RecordQuery().date(date));
+}
+
+// ========== 组合查询 ==========
+
+RecordQueryPlan RecordService::planQuery(const RecordQuery& query) const {
+    QReadLocker locker(&m_lock);
+    return choosePlan(query);
+}
+
+RecordQueryPlan RecordService::choosePlan(const RecordQuery& query) const {
+    RecordQueryPlan plan;
+    plan.access = RecordQueryPlan::Access::FullScan;
+    plan.candidateRows = m_recordCount;
+
+    // 卡号索引：候选行数即该卡的记录数
+    if (query.cardFilter()) {
+        auto it = m_records.constFind(*query.cardFilter());
+        qsizetype rows = (it != m_records.constEnd()) ? it.value().size() : 0;
+        if (rows <= plan.candidateRows) {
+            plan.access = RecordQueryPlan::Access::CardIndex;
+            plan.candidateRows = rows;
+        }
+    }
+
+    // 日期索引：累加区间内每天的记录数
+    if (query.startDateFilter() || query.endDateFilter()) {
+        auto first = query.startDateFilter() ? m_dayIndex.lowerBound(*query.startDateFilter())
+                                             : m_dayIndex.constBegin();
+        auto last = query.endDateFilter() ? m_dayIndex.upperBound(*query.endDateFilter())
+                                          : m_dayIndex.constEnd();
+        qsizetype rows = 0;
+        for (auto it = first; it != last && rows < plan.candidateRows; ++it) {
+            rows += it.value().size();
+        }
+        if (rows < plan.candidateRows) {
+            plan.access = RecordQueryPlan::Access::DayIndex;
+            plan.candidateRows = rows;
+        }
+    }
+
+    // 地点索引
+    if (query.locationFilter()) {
+        auto it = m_locationIndex.constFind(*query.locationFilter());
+        qsizetype rows = (it != m_locationIndex.constEnd()) ? it.value().size() : 0;
+        if (rows < plan.candidateRows) {
+            plan.access = RecordQueryPlan::Access::LocationIndex;
+            plan.candidateRows = rows;
+        }
+    }
+
+    return plan;
+}
+
+template <typename Visitor>
+void RecordService::forEachCandidate(const RecordQuery& query, const RecordQueryPlan& plan,
+                                     Visitor&& visit) const {
+    // 按定位信息访问记录，缓存上一次解析到的卡以减少映射查找
+    int cachedCard = -1;
+    const QList<Record>* cachedList = nullptr;
+    auto visitLocators = [&](const QList<RecordLocator>& locators) {
+        for (const auto& locator : locators) {
+            if (locator.card != cachedCard) {
+                cachedCard = locator.card;
+                cachedList = &m_records.constFind(m_ordinalCards.at(locator.card)).value();
+            }
+            if (!visit(cachedList->at(locator.row))) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    switch (plan.access) {
+    case RecordQueryPlan::Access::CardIndex: {
+        auto it = m_records.constFind(*query.cardFilter());
+        if (it != m_records.constEnd()) {
+            for (const auto& record : it.value()) {
+                if (!visit(record)) {
+                    return;
+                }
+            }
+        }
+        break;
+    }
+    case RecordQueryPlan::Access::DayIndex: {
+        auto first = query.startDateFilter() ? m_dayIndex.lowerBound(*query.startDateFilter())
+                                             : m_dayIndex.constBegin();
+        auto last = query.endDateFilter() ? m_dayIndex.upperBound(*query.endDateFilter())
+                                          : m_dayIndex.constEnd();
+        for (auto it = first; it != last; ++it) {
+            if (!visitLocators(it.value())) {
+                return;
+            }
+        }
+        break;
+    }
+    case RecordQueryPlan::Access::LocationIndex: {
+        auto it = m_locationIndex.constFind(*query.locationFilter());
+        if (it != m_locationIndex.constEnd()) {
+            visitLocators(it.value());
+        }
+        break;
+    }
+    case RecordQueryPlan::Access::FullScan:
+    default:
+        for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+            for (const auto& record : it.value()) {
+                if (!visit(record)) {
+                    return;
+                }
+            }
+        }
+        break;
+    }
+}
+
+RecordView RecordService::executeQuery(const RecordQuery& query) const {
+    QReadLocker locker(&m_lock);
+    return runQuery(query);
+}
+
+RecordView RecordService::runQuery(const RecordQuery& query) const {
+    const RecordQueryPlan plan = choosePlan(query);
+    const bool sorted = query.sortField() != RecordQuery::SortField::None;
+
+    // 无排序时可在取够 offset + limit 行后提前结束扫描
+    qsizetype wanted = -1;
+    if (!sorted && query.limitCount() >= 0) {
+        wanted = static_cast<qsizetype>(query.offsetCount()) + query.limitCount();
+    }
+
+    QList<const Record*> refs;
+    forEachCandidate(query, plan, [&](const Record& record) {
+        if (query.matches(record)) {
+            refs.append(&record);
+        }
+        return wanted < 0 || refs.size() < wanted;
+    });
+
+    if (sorted) {
+        std::stable_sort(refs.begin(), refs.end(), [&query](const Record* a, const Record* b) {
+            return query.lessThan(*a, *b);
+        });
+    }
+
+    // 分页
+    qsizetype skip = qMin<qsizetype>(query.offsetCount(), refs.size());
+    refs.remove(0, skip);
+    if (query.limitCount() >= 0 && refs.size() > query.limitCount()) {
+        refs.resize(query.limitCount());
+    }
+
+    // 在读锁内拷贝命中的记录，视图不再引用内部存储
+    QList<Record> records;
+    records.reserve(refs.size());
+    for (const Record* record : std::as_const(refs)) {
+        records.append(*record);
+    }
+    return RecordView(std::move(records));
+}
+
+QList<RecordGroup> RecordService::aggregate(const RecordQuery& query,
+                                            RecordQuery::GroupField groupBy) const {
+    QReadLocker locker(&m_lock);
+    QMap<QString, RecordGroup> groups;
+    forEachCandidate(query, choosePlan(query), [&](const Record& record) {
+        if (!query.matches(record)) {
+            return true;
+        }
+
+        QString key;
+        switch (groupBy) {
+        case RecordQuery::GroupField::Card:
+            key = record.cardId();
+            break;
+        case RecordQuery::GroupField::Date:
+            key = record.date();
+            break;
+        case RecordQuery::GroupField::Location:
+            key = record.location();
+            break;
+        }
+
+        RecordGroup& group = groups[key];
+        group.key = key;
+        group.count++;
+        group.totalDuration += record.durationMinutes();
+        group.totalCost += record.cost();
+        return true;
+    });
+    return groups.values();
+}
+
+// ========== 区间台账 ==========
+
+LedgerTotals RecordService::rangeTotals(const QString& startDate, const QString& endDate,
+                                        const QString& location) const {
+    QReadLocker locker(&m_lock);
+    return m_ledger.range(QDate::fromString(startDate, QStringLiteral("yyyy-MM-dd")),
+                          QDate::fromString(endDate, QStringLiteral("yyyy-MM-dd")), location);
+}
+
+// ========== 去重人数 ==========
+
+qint64 RecordService::distinctUsers(const QString& startDate, const QString& endDate,
+                                    const QStringList& locations, DistinctMode mode) const {
+    QReadLocker locker(&m_lock);
+    if (mode == DistinctMode::Approximate) {
+        return m_distinctUsers.count(QDate::fromString(startDate, QStringLiteral("yyyy-MM-dd")),
+                                     QDate::fromString(endDate, QStringLiteral("yyyy-MM-dd")),
+                                     locations);
+    }
+
+    const QSet<QString> wanted(locations.cbegin(), locations.cend());
+    QSet<QString> cards;
+    RecordView records =
+        runQuery(RecordQuery().dateRange(startDate, endDate).state(SessionState::Offline));
+    for (const auto& record : records) {
+        if (wanted.isEmpty() || wanted.contains(record.location())) {
+            cards.insert(record.cardId());
+        }
+    }
+    return cards.size();
+}
+
+// ========== 活跃卡集合 ==========
+
+CardBitmap RecordService::activeCards(const QString& startDate, const QString& endDate) const {
+    QReadLocker locker(&m_lock);
+    CardBitmap cards;
+    if (startDate > endDate) {
+        return cards;
+    }
+    for (auto it = m_dayCards.lowerBound(startDate);
+         it != m_dayCards.constEnd() && it.key() <= endDate; ++it) {
+        cards |= it.value();
+    }
+    return cards;
+}
+
+CardBitmap RecordService::locationCards(const QString& location) const {
+    QReadLocker locker(&m_lock);
+    return m_locationCards.value(location);
+}
+
+QStringList RecordService::cohortCards(const CardBitmap& cohort) const {
+    QReadLocker locker(&m_lock);
+    QStringList cards;
+    for (quint32 ordinal : cohort.values()) {
+        if (ordinal < static_cast<quint32>(m_ordinalCards.size())) {
+            cards.append(m_ordinalCards.at(ordinal));
+        }
+    }
+    cards.sort();
+    return cards;
+}
+
+// ========== 使用热力图 ==========
+
+HeatmapGrid RecordService::usageHeatmap(const QString& location, const QString& startDate,
+                                        const QString& endDate) const {
+    QReadLocker locker(&m_lock);
+    return m_heatmap.query(location, QDate::fromString(startDate, QStringLiteral("yyyy-MM-dd")),
+                           QDate::fromString(endDate, QStringLiteral("yyyy-MM-dd")));
+}
+
+HeatmapGrid RecordService::recomputeUsageHeatmap(const QString& location,
+                                                 const QString& startDate,
+                                                 const QString& endDate) const {
+    // 会话可能跨越多日，不按开始日期预筛选，由compute按小时段判断是否落在范围内
+    QDate start = QDate::fromString(startDate, QStringLiteral("yyyy-MM-dd"));
+    QDate end = QDate::fromString(endDate, QStringLiteral("yyyy-MM-dd"));
+    QReadLocker locker(&m_lock);
+    RecordView records = runQuery(RecordQuery().location(location).state(SessionState::Offline));
+    return UsageHeatmap::compute(records, location, start, end);
+}
+
+QStringList RecordService::heatmapLocations() const {
+    QReadLocker locker(&m_lock);
+    return m_heatmap.locations();
+}
+
+// ========== 使用排行 ==========
+
+QList<RecordGroup> RecordService::topUsers(RankMetric metric, RankPeriod period, int k) const {
+    QReadLocker locker(&m_lock);
+    if (period == RankPeriod::ThisWeek) {
+        return m_ranking.topForWeek(metric, m_clock->now().date(), k);
+    }
+    return m_ranking.top(metric, k);
+}
+
+// ========== 全量历史汇总 ==========
+
+HistorySummary RecordService::summarizeHistory(const RecordQuery& query, int topN) const {
+    return HistoryAggregator::summarize(recordsSnapshot(), query, topN);
+}
+
+QFuture<HistorySummary> RecordService::summarizeHistoryAsync(const RecordQuery& query, int topN,
+                                                             QThreadPool* pool) const {
+    return HistoryAggregator::summarizeAsync(recordsSnapshot(), query, topN, pool);
+}
+
+QMap<QString, QList<Record>> RecordService::recordsSnapshot() const {
+    // 隐式共享，加锁期间只复制引用
+    QReadLocker locker(&m_lock);
+    return m_records;
+}
+
+// ========== 计费规则 ==========
+
+Tariff RecordService::tariff() const {
+    QReadLocker locker(&m_lock);
+    return m_tariff.tariff();
+}
+
+bool RecordService::setTariff(const Tariff& tariff) {
+    QWriteLocker locker(&m_lock);
+    if (!StorageManager::instance().saveTariff(tariff.toJson())) {
+        return false;
+    }
+    m_tariff = TariffEngine(tariff);
+    return true;
+}
+
+RebillReport RecordService::rebill(const RecordQuery& query, const Tariff& tariff) const {
+    QMap<QString, QString> studentIds;
+    {
+        QReadLocker locker(&m_lock);
+        studentIds = m_cardToStudentId;
+    }
+    return TariffEngine(tariff).rebill(recordsSnapshot(), studentIds, query);
+}
+
+QFuture<RebillReport> RecordService::rebillAsync(const RecordQuery& query, const Tariff& tariff,
+                                                 QThreadPool* pool) const {
+    QMap<QString, QString> studentIds;
+    {
+        QReadLocker locker(&m_lock);
+        studentIds = m_cardToStudentId;
+    }
+    return TariffEngine(tariff).rebillAsync(recordsSnapshot(), studentIds, query, pool);
+}
+
+int RecordService::applyRebill(const RebillReport& report) {
+    QMutexLocker saveLocker(&m_saveMutex);
+    QWriteLocker locker(&m_lock);
+    QHash<RecordId, const RebillDiff*> pending;
+    for (const auto& diff : report.diffs) {
+        pending.insert(diff.recordId, &diff);
+    }
+
+    int updated = 0;
+    QStringList touchedCards;
+    for (auto it = m_records.begin(); it != m_records.end() && !pending.isEmpty(); ++it) {
+        bool touched = false;
+        for (auto& record : it.value()) {
+            const RebillDiff* diff = pending.take(record.id());
+            if (diff && record.isOffline() && record.cost() == diff->oldCost) {
+                // 时长不变，热力图和去重人数不受影响；台账和排行按差额调整
+                const Money delta = diff->newCost - diff->oldCost;
+                m_ledger.adjustCost(record, delta);
+                m_ranking.adjustCost(record, delta);
+                record.setCost(diff->newCost);
+                touched = true;
+                ++updated;
+            }
+        }
+        if (touched) {
+            touchedCards.append(it.key());
+        }
+    }
+    if (updated == 0) {
+        return 0;
+    }
+
+    const PendingWrites writes = collectWrites(touchedCards, QStringList());
+    locker.unlock();
+    writeFiles(writes);
+    saveLocker.unlock();
+
+    for (const auto& cardId : touchedCards) {
+        emit recordsChanged(cardId);
+    }
+    return updated;
+}
+
 // ========== 统计功能 ==========
 
 int RecordService::getTotalSessionCount(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
     int count = 0;
     if (m_records.contains(cardId)) {
         for (const auto& record : m_records[cardId]) {
@@ -322,6 +1054,7 @@ int RecordService::getTotalSessionCount(const QString& cardId) const {
 }
 
 int RecordService::getTotalDuration(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
     int total = 0;
     if (!m_records.contains(cardId)) {
         return total;
@@ -333,8 +1066,9 @@ int RecordService::getTotalDuration(const QString& cardId) const {
     return total;
 }
 
-double RecordService::getTotalCost(const QString& cardId) const {
-    double total = 0.0;
+Money RecordService::getTotalCost(const QString& cardId) const {
+    QReadLocker locker(&m_lock);
+    Money total;
     if (!m_records.contains(cardId)) {
         return total;
     }
@@ -345,53 +1079,37 @@ double RecordService::getTotalCost(const QString& cardId) const {
     return total;
 }
 
-double RecordService::getDailyIncome(const QString& date) const {
-    double total = 0.0;
-
-    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
-        for (const auto& record : it.value()) {
-            if (record.date() == date && !record.isOnline()) {
-                total += record.cost();
-            }
-        }
-    }
-    return total;
+Money RecordService::getDailyIncome(const QString& date) const {
+    return rangeTotals(date, date).income;
 }
 
 int RecordService::getDailySessionCount(const QString& date) const {
-    int count = 0;
-
-    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
-        for (const auto& record : it.value()) {
-            if (record.date() == date) {
-                count++;
-            }
-        }
-    }
-    return count;
+    return static_cast<int>(executeQuery(RecordQuery().date(date)).size());
 }
 
 int RecordService::getDailyTotalDuration(const QString& date) const {
-    int total = 0;
-
-    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
-        for (const auto& record : it.value()) {
-            if (record.date() == date && !record.isOnline()) {
-                total += record.durationMinutes();
-            }
-        }
-    }
-    return total;
+    return rangeTotals(date, date).minutes;
 }
 
 QString RecordService::getStatisticsSummary(const QString& cardId) const {
-    if (!m_records.contains(cardId)) {
+    QReadLocker locker(&m_lock);
+    auto it = m_records.constFind(cardId);
+    if (it == m_records.constEnd()) {
         return QStringLiteral("暂无上机记录");
     }
 
-    int totalDuration = getTotalDuration(cardId);
-    double totalCost = getTotalCost(cardId);
-    int sessionCount = getTotalSessionCount(cardId);
+    // 读锁不可重入，在同一次加锁内累计，不调用getTotal*()
+    int totalDuration = 0;
+    Money totalCost;
+    int sessionCount = 0;
+    for (const auto& record : it.value()) {
+        totalDuration += record.durationMinutes();
+        totalCost += record.cost();
+        if (record.isOffline()) {
+            sessionCount++;
+        }
+    }
+    locker.unlock();
 
     int hours = totalDuration / 60;
     int minutes = totalDuration % 60;
@@ -400,11 +1118,17 @@ QString RecordService::getStatisticsSummary(const QString& cardId) const {
         .arg(sessionCount)
         .arg(hours)
         .arg(minutes)
-        .arg(totalCost, 0, 'f', 2);
+        .arg(totalCost.toString());
 }
 
 int RecordService::getOnlineCount() const {
+    QReadLocker locker(&m_lock);
     return m_activeSessions.size();
 }
 
+QStringList RecordService::getOnlineCards() const {
+    QReadLocker locker(&m_lock);
+    return m_activeSessions.keys();
+}
+
 }  // namespace CampusCard
@@ -5,19 +5,36 @@
  * @date 2024
  *
  * MVC架构 - Model层业务服务
- * 负责上机记录相关的业务逻辑处理
+ * 负责上机记录相关的业务逻辑处理；所有公有接口由一把读写锁保护，可被多线程同时使用
  */
 
 #ifndef MODEL_SERVICES_RECORDSERVICE_H
 #define MODEL_SERVICES_RECORDSERVICE_H
 
+#include "model/Clock.h"
 #include "model/entities/Card.h"
 #include "model/entities/Record.h"
 #include "model/repositories/StorageManager.h"
-
+#include "model/services/CardBitmap.h"
+#include "model/services/DailyLedger.h"
+#include "model/services/DistinctCounter.h"
+#include "model/services/HistoryAggregator.h"
+#include "model/services/RecordQuery.h"
+#include "model/services/RecordView.h"
+#include "model/services/TariffEngine.h"
+#include "model/services/UsageHeatmap.h"
+#include "model/services/UsageRanking.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
+
+#include <utility>
 
 
 namespace CampusCard {
@@ -31,6 +48,12 @@ namespace CampusCard {
  * - 费用计算
  * - 记录查询和统计
  * - 通过信号通知状态变更
+ *
+ * 线程安全：查询加读锁并返回副本，上下机等修改加写锁，检查和修改在同一次加锁内完成，
+ * 信号在释放锁之后发出。记录的日期、地点索引和各项统计在每次上下机时都要更新，
+ * 因此不按卡分片，整个服务共用一把锁。全量汇总和重新计费先在锁内复制记录（隐式共享）
+ * 再在锁外计算。视图查询同样在读锁内取得隐式共享的记录列表，可跨线程使用。
+ * 需要写文件的修改先取保存锁，在写锁内复制要写的数据，释放写锁后再写文件。
  */
 class RecordService : public QObject {
     Q_OBJECT
@@ -59,6 +82,18 @@ public:
      */
     void registerCardStudentMapping(const QString& cardId, const QString& studentId);
 
+    /**
+     * @brief 设置时钟（上下机时间、当前费用和本周排行都取自该时钟）
+     * @param clock 时钟（为空时使用系统时钟；调用方保证其生命周期）
+     */
+    void setClock(Clock* clock) { m_clock = clock ? clock : Clock::system(); }
+
+    /**
+     * @brief 获取时钟
+     * @return 时钟
+     */
+    [[nodiscard]] Clock* clock() const { return m_clock; }
+
     // ========== 上下机操作 ==========
 
     /**
@@ -72,9 +107,83 @@ public:
     /**
      * @brief 结束上机
      * @param cardId 卡号
-     * @return 本次上机费用（失败返回-1）
+     * @return 本次上机费用（失败返回负值）
+     */
+    Money endSession(const QString& cardId);
+
+    /**
+     * @brief 计算结束上机后的记录（不修改任何状态）
+     * @param cardId 卡号
+     * @return 已填入结束时间、时长和费用的记录（未上机返回无效Record）
      */
-    double endSession(const QString& cardId);
+    [[nodiscard]] Record prepareEndSession(const QString& cardId) const;
+
+    /**
+     * @brief 应用结束上机后的记录
+     *
+     * 只有同ID的记录仍处于上机状态时才生效，因此对同一记录重复应用是幂等的
+     * @param cardId 卡号
+     * @param closed prepareEndSession()返回的记录
+     * @param persist 是否立即写入记录文件和每日汇总（由事务日志保证持久化时为false）
+     * @param notify 是否发出信号（为false时由调用方在释放自己的锁后调用notifySessionEnded()）
+     * @return 是否生效
+     */
+    bool applyEndSession(const QString& cardId, const Record& closed, bool persist = true,
+                         bool notify = true);
+
+    /**
+     * @brief 发出一次下机的sessionEnded和recordsChanged信号
+     * @param cardId 卡号
+     * @param closed 已生效的记录
+     */
+    void notifySessionEnded(const QString& cardId, const Record& closed);
+
+    // ========== 批量上下机 ==========
+
+    /**
+     * @brief 批量开始上机（如整班同时上机）
+     *
+     * 已在上机和重复的卡号被跳过；每个受影响的记录文件只写一次，
+     * 只发出一次recordsBatchChanged信号
+     * @param cardIds 卡号列表
+     * @param location 上机地点
+     * @return 新创建的记录（顺序与卡号列表一致）
+     */
+    QList<Record> startSessions(const QStringList& cardIds, const QString& location);
+
+    /**
+     * @brief 批量结束上机
+     * @param cardIds 卡号列表（未上机的卡号被跳过）
+     * @return 已结束的记录（含时长和费用）
+     */
+    QList<Record> endSessions(const QStringList& cardIds);
+
+    /**
+     * @brief 批量应用结束上机后的记录
+     *
+     * 与applyEndSession()相同，只对仍处于上机状态的记录生效；
+     * 所有记录处理完后统一写文件并只发出一次recordsBatchChanged信号
+     * @param closed prepareEndSession()返回的记录
+     * @param persist 是否立即写入记录文件和每日汇总
+     * @param notify 是否发出信号（为false时由调用方在释放自己的锁后调用notifySessionsEnded()）
+     * @return 实际生效的记录
+     */
+    QList<Record> applyEndSessions(const QList<Record>& closed, bool persist = true,
+                                   bool notify = true);
+
+    /**
+     * @brief 为批量下机发出一次recordsBatchChanged信号
+     * @param applied 已生效的记录（为空时不发出）
+     */
+    void notifySessionsEnded(const QList<Record>& applied);
+
+    /**
+     * @brief 将指定卡的记录和指定日期的汇总写入文件
+     * @param cardIds 卡号列表
+     * @param dates 日期列表（yyyy-MM-dd）
+     * @return 是否全部成功
+     */
+    bool flush(const QStringList& cardIds, const QStringList& dates);
 
     /**
      * @brief 检查是否正在上机
@@ -91,18 +200,34 @@ public:
     [[nodiscard]] Record getCurrentSession(const QString& cardId) const;
 
     /**
-     * @brief 获取当前上机记录指针（用于修改）
+     * @brief 计算当前会话费用（不结束会话）
      * @param cardId 卡号
-     * @return 记录指针（未上机返回nullptr）
+     * @return 截至当前的费用（负值表示未上机）
      */
-    Record* getCurrentSessionPtr(const QString& cardId);
+    [[nodiscard]] Money calculateCurrentCost(const QString& cardId) const;
 
     /**
-     * @brief 计算当前会话费用（不结束会话）
+     * @brief 当前会话在给定预算内最多可持续的分钟数
+     *
+     * 按当前计费规则（含分时段费率和学号折扣）二分查找，费用随时长单调不减
+     * @param cardId 卡号
+     * @param budget 预算（通常为卡余额）
+     * @return 分钟数（未上机，或一年内费用都不超过预算时返回-1）
+     */
+    [[nodiscard]] int affordableMinutes(const QString& cardId, Money budget) const;
+
+    // ========== 记录补录 ==========
+
+    /**
+     * @brief 补录历史记录（如从其他系统导入的迟到记录）
+     *
+     * 仅接受已结束且记录ID不重复的记录，记录日期可早于已有记录；
+     * 各统计索引按记录增量更新，无需全量重建
      * @param cardId 卡号
-     * @return 截至当前的费用（-1表示未上机）
+     * @param records 待补录的记录
+     * @return 实际补录的条数
      */
-    [[nodiscard]] double calculateCurrentCost(const QString& cardId) const;
+    int importRecords(const QString& cardId, const QList<Record>& records);
 
     // ========== 记录查询 ==========
 
@@ -155,6 +280,243 @@ public:
      */
     [[nodiscard]] QStringList getLocations(const QString& cardId) const;
 
+    // ========== 视图查询（隐式共享） ==========
+    // 返回的RecordView在读锁内取得并持有记录，不受本服务后续修改影响
+
+    /**
+     * @brief 获取指定卡所有记录的视图
+     * @param cardId 卡号
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView recordsView(const QString& cardId) const;
+
+    /**
+     * @brief 获取指定卡某日记录的视图
+     * @param cardId 卡号
+     * @param date 日期字符串（yyyy-MM-dd）
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView recordsViewByDate(const QString& cardId, const QString& date) const;
+
+    /**
+     * @brief 获取指定卡在日期范围和地点内的记录视图
+     * @param cardId 卡号
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @param location 地点（空表示不筛选）
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView filteredRecordsView(const QString& cardId, const QString& startDate,
+                                                 const QString& endDate,
+                                                 const QString& location = QString()) const;
+
+    /**
+     * @brief 获取所有卡某日记录的视图
+     * @param date 日期字符串（yyyy-MM-dd）
+     * @return 记录视图
+     */
+    [[nodiscard]] RecordView allRecordsViewByDate(const QString& date) const;
+
+    // ========== 组合查询 ==========
+
+    /**
+     * @brief 为查询选择执行计划
+     *
+     * 在卡号索引、日期索引、地点索引中选择候选行数最少的访问路径，
+     * 其余条件在物化前作为下推过滤执行
+     * @param query 查询条件
+     * @return 执行计划
+     */
+    [[nodiscard]] RecordQueryPlan planQuery(const RecordQuery& query) const;
+
+    /**
+     * @brief 执行查询
+     * @param query 查询条件（含排序与分页）
+     * @return 结果视图（持有命中的记录）
+     */
+    [[nodiscard]] RecordView executeQuery(const RecordQuery& query) const;
+
+    /**
+     * @brief 执行分组聚合查询
+     * @param query 查询条件（排序与分页不参与聚合）
+     * @param groupBy 分组字段
+     * @return 按分组键升序排列的聚合结果
+     */
+    [[nodiscard]] QList<RecordGroup> aggregate(const RecordQuery& query,
+                                               RecordQuery::GroupField groupBy) const;
+
+    // ========== 区间台账 ==========
+
+    /**
+     * @brief 统计日期闭区间的收入、上机次数和时长（O(log n)，不扫描记录）
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @param location 地点（空字符串表示所有地点）
+     * @return 合计（仅统计已结束的记录）
+     */
+    [[nodiscard]] LedgerTotals rangeTotals(const QString& startDate, const QString& endDate,
+                                           const QString& location = QString()) const;
+
+    // ========== 去重人数 ==========
+
+    /**
+     * @brief 统计日期闭区间、地点集合内上机的去重人数（按卡号去重）
+     *
+     * 近似方式合并按(日期, 地点)维护的HyperLogLog草图，不扫描记录；
+     * 精确方式扫描记录，用于审计核对近似结果
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @param locations 地点集合（空表示所有地点）
+     * @param mode 计数方式
+     * @return 去重人数（仅统计已结束的记录）
+     */
+    [[nodiscard]] qint64 distinctUsers(const QString& startDate, const QString& endDate,
+                                       const QStringList& locations = QStringList(),
+                                       DistinctMode mode = DistinctMode::Approximate) const;
+
+    // ========== 活跃卡集合 ==========
+    // 返回的位图以卡序号表示，在下一次initialize前有效（卡序号此后可能重新分配）
+
+    /**
+     * @brief 获取日期闭区间内有上机记录的卡集合
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @return 卡集合（含上机中的记录）
+     */
+    [[nodiscard]] CardBitmap activeCards(const QString& startDate, const QString& endDate) const;
+
+    /**
+     * @brief 获取在某地点有过上机记录的卡集合
+     * @param location 地点
+     * @return 卡集合（含上机中的记录）
+     */
+    [[nodiscard]] CardBitmap locationCards(const QString& location) const;
+
+    /**
+     * @brief 将卡集合转换为卡号
+     * @param cohort 卡集合（activeCards/locationCards及其运算结果）
+     * @return 卡号列表（已排序）
+     */
+    [[nodiscard]] QStringList cohortCards(const CardBitmap& cohort) const;
+
+    // ========== 使用热力图 ==========
+
+    /**
+     * @brief 获取日期范围内的使用热力图（增量维护，不扫描记录）
+     * @param location 地点（空字符串表示所有地点）
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @return 星期×小时使用时长网格
+     */
+    [[nodiscard]] HeatmapGrid usageHeatmap(const QString& location, const QString& startDate,
+                                           const QString& endDate) const;
+
+    /**
+     * @brief 从原始记录重新计算热力图（仅用于校验增量结果）
+     * @param location 地点（空字符串表示所有地点）
+     * @param startDate 开始日期（yyyy-MM-dd）
+     * @param endDate 结束日期（yyyy-MM-dd）
+     * @return 星期×小时使用时长网格
+     */
+    [[nodiscard]] HeatmapGrid recomputeUsageHeatmap(const QString& location,
+                                                    const QString& startDate,
+                                                    const QString& endDate) const;
+
+    /**
+     * @brief 获取热力图中有数据的地点
+     * @return 地点列表（已排序）
+     */
+    [[nodiscard]] QStringList heatmapLocations() const;
+
+    // ========== 使用排行 ==========
+
+    /**
+     * @brief 获取时长或消费前K名的卡（增量维护，不扫描记录）
+     * @param metric 排行指标
+     * @param period 排行周期（本周按当前日期计算）
+     * @param k 数量
+     * @return 排行（key为卡号，count/totalDuration/totalCost为该周期内累计值）
+     */
+    [[nodiscard]] QList<RecordGroup> topUsers(RankMetric metric, RankPeriod period,
+                                              int k) const;
+
+    // ========== 全量历史汇总 ==========
+
+    /**
+     * @brief 串行汇总全部历史记录
+     * @param query 过滤条件（如学期日期范围）
+     * @param topN 卡排行数量
+     * @return 汇总结果
+     */
+    [[nodiscard]] HistorySummary summarizeHistory(const RecordQuery& query = RecordQuery(),
+                                                  int topN = 10) const;
+
+    /**
+     * @brief 在线程池中并行汇总全部历史记录
+     *
+     * 基于调用时刻的记录快照执行，之后的上下机操作不影响结果；
+     * 结果与summarizeHistory()完全一致
+     * @param query 过滤条件
+     * @param topN 卡排行数量
+     * @param pool 线程池（nullptr表示全局线程池）
+     * @return 可报告进度、可取消的QFuture
+     */
+    [[nodiscard]] QFuture<HistorySummary> summarizeHistoryAsync(
+        const RecordQuery& query = RecordQuery(), int topN = 10,
+        QThreadPool* pool = nullptr) const;
+
+    /**
+     * @brief 在读锁内复制全部记录（隐式共享，只复制引用；调用方不持有锁）
+     * @return 卡号到记录列表的映射
+     */
+    [[nodiscard]] QMap<QString, QList<Record>> recordsSnapshot() const;
+
+    // ========== 计费规则 ==========
+
+    /**
+     * @brief 当前计费规则
+     * @return 规则集（副本）
+     */
+    [[nodiscard]] Tariff tariff() const;
+
+    /**
+     * @brief 设置并保存计费规则（只影响之后结束的会话）
+     * @param tariff 规则集
+     * @return 是否保存成功
+     */
+    bool setTariff(const Tariff& tariff);
+
+    /**
+     * @brief 按给定规则串行重新计费（只生成报告，不修改记录）
+     * @param query 过滤条件（如日期范围、地点）
+     * @param tariff 新规则集
+     * @return 差异报告
+     */
+    [[nodiscard]] RebillReport rebill(const RecordQuery& query, const Tariff& tariff) const;
+
+    /**
+     * @brief 在线程池中并行重新计费
+     *
+     * 基于调用时刻的记录快照执行，结果与rebill()完全一致
+     * @param query 过滤条件
+     * @param tariff 新规则集
+     * @param pool 线程池（nullptr表示全局线程池）
+     * @return 差异报告的QFuture
+     */
+    [[nodiscard]] QFuture<RebillReport> rebillAsync(const RecordQuery& query, const Tariff& tariff,
+                                                    QThreadPool* pool = nullptr) const;
+
+    /**
+     * @brief 将重新计费报告写回记录
+     *
+     * 只更新ID存在且当前费用仍等于报告中原费用的记录，
+     * 报告生成后已被修改的记录会被跳过；卡余额不做追溯调整。
+     * 台账和排行按每条记录的费用差额增量调整，不重建索引
+     * @param report 差异报告
+     * @return 实际更新的记录数
+     */
+    int applyRebill(const RebillReport& report);
+
     // ========== 统计功能 ==========
 
     /**
@@ -176,14 +538,14 @@ public:
      * @param cardId 卡号
      * @return 总费用
      */
-    [[nodiscard]] double getTotalCost(const QString& cardId) const;
+    [[nodiscard]] Money getTotalCost(const QString& cardId) const;
 
     /**
      * @brief 统计某日期的总收入（管理员功能）
      * @param date 日期字符串（yyyy-MM-dd）
      * @return 当日总收入
      */
-    [[nodiscard]] double getDailyIncome(const QString& date) const;
+    [[nodiscard]] Money getDailyIncome(const QString& date) const;
 
     /**
      * @brief 统计某日期的上机次数
@@ -212,6 +574,12 @@ public:
      */
     [[nodiscard]] int getOnlineCount() const;
 
+    /**
+     * @brief 获取当前在线的卡号
+     * @return 卡号列表
+     */
+    [[nodiscard]] QStringList getOnlineCards() const;
+
 signals:
     /**
      * @brief 记录变更信号
@@ -219,6 +587,12 @@ signals:
      */
     void recordsChanged(const QString& cardId);
 
+    /**
+     * @brief 批量记录变更信号（批量上下机时代替逐卡的recordsChanged）
+     * @param cardIds 变更的卡号列表
+     */
+    void recordsBatchChanged(const QStringList& cardIds);
+
     /**
      * @brief 上机开始信号
      * @param cardId 卡号
@@ -232,27 +606,158 @@ signals:
      * @param cost 费用
      * @param duration 时长（分钟）
      */
-    void sessionEnded(const QString& cardId, double cost, int duration);
+    void sessionEnded(const QString& cardId, Money cost, int duration);
 
 private:
+    // 以下私有函数均假定调用方已持有m_lock（修改状态的函数需持有写锁）
+
+    /**
+     * @brief 记录定位信息（卡序号 + 卡内行号）
+     *
+     * 每张卡的记录只追加不删除，因此行号在下一次initialize前保持稳定
+     */
+    struct RecordLocator {
+        int card = 0;  ///< 卡序号（m_ordinalCards下标）
+        int row = 0;   ///< 在该卡记录列表中的行号
+    };
+
     /**
-     * @brief 加载指定卡的记录到缓存
+     * @brief 获取卡序号（不存在时分配）
      * @param cardId 卡号
+     * @return 卡序号
      */
-    void loadRecordsForCard(const QString& cardId);
+    int cardOrdinal(const QString& cardId);
 
     /**
-     * @brief 保存指定卡的记录
+     * @brief 将一条记录加入日期和地点索引及活跃卡位图
      * @param cardId 卡号
+     * @param record 记录
+     * @param row 记录行号
+     */
+    void indexRecord(const QString& cardId, const Record& record, int row);
+
+    /**
+     * @brief 将一条已结束的记录计入热力图、排行和台账
+     * @param record 记录（上机中的记录被忽略）
      */
-    void saveRecordsForCard(const QString& cardId);
+    void accumulateFinished(const Record& record);
 
     /**
-     * @brief 计算费用
+     * @brief 检查是否有活动会话
+     * @param cardId 卡号
+     * @return 是否上机中
+     */
+    [[nodiscard]] bool hasActiveSession(const QString& cardId) const;
+
+    /**
+     * @brief 获取活动会话记录
+     * @param cardId 卡号
+     * @return 当前记录（未上机返回无效Record）
+     */
+    [[nodiscard]] Record activeSession(const QString& cardId) const;
+
+    /**
+     * @brief 计算结束上机后的记录（prepareEndSession()的实现）
+     * @param cardId 卡号
+     * @return 已填入结束时间、时长和费用的记录（未上机返回无效Record）
+     */
+    [[nodiscard]] Record closedSession(const QString& cardId) const;
+
+    /**
+     * @brief 在内存中结束一条上机记录（不写文件、不发信号）
+     * @param cardId 卡号
+     * @param closed 结束后的记录
+     * @return 记录存在且仍在上机时返回true
+     */
+    bool closeSession(const QString& cardId, const Record& closed);
+
+    /**
+     * @struct PendingWrites
+     * @brief 在写锁内复制、释放锁后写入文件的数据
+     */
+    struct PendingWrites {
+        QList<std::pair<QString, QList<Record>>> records;  ///< 学号与该卡的记录列表
+        QList<std::pair<QString, QJsonObject>> rollups;    ///< 日期与当日汇总
+    };
+
+    /**
+     * @brief 批量结束上机记录（不写文件、不发信号）
+     * @param closed 结束后的记录
+     * @return 实际生效的记录
+     */
+    QList<Record> closeSessions(const QList<Record>& closed);
+
+    /**
+     * @brief 记录所属的卡号
+     * @param records 记录列表
+     * @return 卡号列表（顺序与记录一致）
+     */
+    [[nodiscard]] static QStringList cardIdsOf(const QList<Record>& records);
+
+    /**
+     * @brief 复制指定卡的记录和指定日期的汇总（调用方需持有m_lock和m_saveMutex）
+     * @param cardIds 卡号列表
+     * @param dates 日期列表（yyyy-MM-dd）
+     * @return 待写入的数据（记录列表隐式共享）
+     */
+    [[nodiscard]] PendingWrites collectWrites(const QStringList& cardIds,
+                                              const QStringList& dates) const;
+
+    /**
+     * @brief 写入collectWrites()复制的数据（调用方需持有m_saveMutex，不得持有m_lock）
+     * @param writes 待写入的数据
+     * @return 是否全部成功
+     */
+    static bool writeFiles(const PendingWrites& writes);
+
+    /**
+     * @brief 记录所属的日期（去重）
+     * @param records 记录列表
+     * @return 日期列表（yyyy-MM-dd）
+     */
+    [[nodiscard]] static QStringList datesOf(const QList<Record>& records);
+
+    /**
+     * @brief 为查询选择执行计划（planQuery()的实现）
+     * @param query 查询条件
+     * @return 执行计划
+     */
+    [[nodiscard]] RecordQueryPlan choosePlan(const RecordQuery& query) const;
+
+    /**
+     * @brief 执行查询（executeQuery()的实现，调用方需持有m_lock）
+     * @param query 查询条件
+     * @return 结果视图
+     */
+    [[nodiscard]] RecordView runQuery(const RecordQuery& query) const;
+
+    /**
+     * @brief 根据当前记录重建全部索引（只使用内存中的记录，不读文件）
+     *
+     * 已持久化的去重人数草图由initialize()在重建后合并
+     */
+    void rebuildIndexes();
+
+    /**
+     * @brief 按执行计划遍历候选记录
+     * @param query 查询条件
+     * @param plan 执行计划
+     * @param visit 访问函数，返回false时提前结束
+     */
+    template <typename Visitor>
+    void forEachCandidate(const RecordQuery& query, const RecordQueryPlan& plan,
+                          Visitor&& visit) const;
+
+    /**
+     * @brief 按当前计费规则计算费用
+     * @param cardId 卡号（用于查找学号折扣）
+     * @param location 地点
+     * @param start 开始时间
      * @param durationMinutes 时长（分钟）
      * @return 费用
      */
-    [[nodiscard]] double calculateCost(int durationMinutes) const;
+    [[nodiscard]] Money calculateCost(const QString& cardId, const QString& location,
+                                      const QDateTime& start, int durationMinutes) const;
 
     /**
      * @brief 根据卡号获取学号
@@ -261,9 +766,26 @@ private:
      */
     [[nodiscard]] QString getStudentIdByCardId(const QString& cardId) const;
 
-    QMap<QString, QList<Record>> m_records;   ///< 卡号到记录列表的映射（内存缓存仍用卡号索引）
-    QMap<QString, QString> m_activeSessions;  ///< 卡号到当前活动会话记录ID的映射
-    QMap<QString, QString> m_cardToStudentId; ///< 卡号到学号的映射（用于文件命名）
+    QMutex m_saveMutex;                        ///< 串行化记录文件和汇总写入（先于m_lock获取）
+    mutable QReadWriteLock m_lock;             ///< 保护以下所有成员（m_clock除外）
+    QMap<QString, QList<Record>> m_records;    ///< 卡号到记录列表的映射（内存缓存仍用卡号索引）
+    QMap<QString, RecordId> m_activeSessions;  ///< 卡号到当前活动会话记录ID的映射
+    QMap<QString, QString> m_cardToStudentId;  ///< 卡号到学号的映射（用于文件命名）
+
+    // ========== 查询索引 ==========
+    QHash<QString, int> m_cardOrdinals;                    ///< 卡号到卡序号的映射
+    QStringList m_ordinalCards;                            ///< 卡序号到卡号的映射
+    QMap<QString, QList<RecordLocator>> m_dayIndex;        ///< 日期索引（有序，支持范围扫描）
+    QHash<QString, QList<RecordLocator>> m_locationIndex;  ///< 地点索引
+    qsizetype m_recordCount = 0;                           ///< 记录总数
+    QMap<QString, CardBitmap> m_dayCards;                  ///< 每日活跃卡位图（有序）
+    QHash<QString, CardBitmap> m_locationCards;            ///< 每地点活跃卡位图
+    UsageHeatmap m_heatmap;                                ///< 使用热力图（下机时更新）
+    UsageRanking m_ranking;                                ///< 使用排行（下机时更新）
+    DailyLedger m_ledger;                                  ///< 按日台账（下机时更新）
+    DistinctUserSketches m_distinctUsers;                  ///< 去重人数草图（下机时更新）
+    TariffEngine m_tariff;                                 ///< 编译后的计费规则
+    Clock* m_clock = Clock::system();                      ///< 上下机和计费使用的时钟
 };
 
 }  // namespace CampusCard
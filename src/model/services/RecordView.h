@@ -0,0 +1,89 @@
+/**
+ * @file RecordView.h
+ * @brief 上机记录只读视图
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 以隐式共享列表的形式返回查询结果，视图自身持有记录，不依赖RecordService的锁
+ */
+
+#ifndef MODEL_SERVICES_RECORDVIEW_H
+#define MODEL_SERVICES_RECORDVIEW_H
+
+#include "model/entities/Record.h"
+
+#include <QList>
+
+#include <algorithm>
+#include <utility>
+
+
+namespace CampusCard {
+
+/**
+ * @class RecordView
+ * @brief 记录查询结果的只读视图
+ *
+ * 视图持有一份隐式共享的QList<Record>，在RecordService的读锁内取得。
+ * 整卡视图直接共享服务内部的列表（仅增加引用计数），服务之后的修改会
+ * 触发写时复制，不影响已返回的视图；条件查询只拷贝命中的记录。
+ *
+ * 因此视图可以跨线程传递、长期保存，不会因服务的后续修改而悬空。
+ */
+class RecordView {
+public:
+    using const_iterator = QList<Record>::const_iterator;
+
+    /**
+     * @brief 默认构造函数（空视图）
+     */
+    RecordView() = default;
+
+    /**
+     * @brief 构造函数
+     * @param records 记录列表（隐式共享，不深拷贝）
+     */
+    explicit RecordView(QList<Record> records) : m_records(std::move(records)) {}
+
+    /**
+     * @brief 构造覆盖整个列表的视图
+     * @param records 源列表（隐式共享，源列表之后的修改不影响视图）
+     * @return 视图
+     */
+    static RecordView over(const QList<Record>& records) { return RecordView(records); }
+
+    // ========== 容器接口 ==========
+
+    [[nodiscard]] qsizetype size() const { return m_records.size(); }
+    [[nodiscard]] bool isEmpty() const { return m_records.isEmpty(); }
+    [[nodiscard]] const Record& at(qsizetype i) const { return m_records.at(i); }
+    [[nodiscard]] const Record& operator[](qsizetype i) const { return m_records.at(i); }
+
+    [[nodiscard]] const_iterator begin() const { return m_records.cbegin(); }
+    [[nodiscard]] const_iterator end() const { return m_records.cend(); }
+
+    // ========== 辅助操作 ==========
+
+    /**
+     * @brief 对视图中的记录排序（共享时先脱离，不影响其他持有者）
+     * @param less 比较函数，参数为const Record&
+     */
+    template <typename Compare>
+    void sort(Compare less) {
+        std::sort(m_records.begin(), m_records.end(), less);
+    }
+
+    /**
+     * @brief 转为记录列表（隐式共享，不深拷贝）
+     * @return 记录列表
+     */
+    [[nodiscard]] QList<Record> toList() const { return m_records; }
+
+private:
+    QList<Record> m_records;  ///< 视图持有的记录（隐式共享）
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_RECORDVIEW_H
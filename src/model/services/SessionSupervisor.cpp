@@ -0,0 +1,176 @@
+/**
+ * @file SessionSupervisor.cpp
+ * @brief 上机会话监督实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "SessionSupervisor.h"
+
+
+namespace CampusCard {
+
+SessionSupervisor::SessionSupervisor(CardService* cardService, RecordService* recordService,
+                                     Clock* clock, QObject* parent)
+    : QObject(parent),
+      m_cardService(cardService),
+      m_recordService(recordService),
+      m_clock(clock ? clock : recordService->clock()),
+      m_wheel(m_clock->nowMSecs() / TICK_MSECS) {
+
+    // 会话开始、结束
+    connect(m_recordService, &RecordService::sessionStarted, this,
+            [this](const QString& cardId) { sync(cardId); });
+    connect(m_recordService, &RecordService::sessionEnded, this,
+            [this](const QString& cardId) { untrack(cardId); });
+    connect(m_recordService, &RecordService::recordsBatchChanged, this,
+            [this](const QStringList& cardIds) {
+                for (const auto& cardId : cardIds) {
+                    sync(cardId);
+                }
+            });
+
+    // 余额变化（充值、批量扣款）后重新计算余额耗尽时刻
+    connect(m_cardService, &CardService::balanceChanged, this, [this](const QString& cardId) {
+        auto it = m_sessions.find(cardId);
+        if (it != m_sessions.end()) {
+            scheduleBalance(cardId, it.value());
+        }
+    });
+    connect(m_cardService, &CardService::cardsChanged, this, [this]() {
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            scheduleBalance(it.key(), it.value());
+        }
+    });
+
+    m_ticker.setInterval(static_cast<int>(TICK_MSECS));
+    connect(&m_ticker, &QTimer::timeout, this, &SessionSupervisor::advance);
+}
+
+// ========== 启停 ==========
+
+void SessionSupervisor::start() {
+    m_sessions.clear();
+    m_wheel = TimerWheel(m_clock->nowMSecs() / TICK_MSECS);
+    for (const auto& cardId : m_recordService->getOnlineCards()) {
+        sync(cardId);
+    }
+    m_ticker.start();
+}
+
+void SessionSupervisor::stop() {
+    m_ticker.stop();
+}
+
+// ========== 配置与活动 ==========
+
+void SessionSupervisor::setIdleTimeout(int minutes) {
+    m_idleTimeoutMinutes = qMax(0, minutes);
+    for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+        scheduleIdle(it.key(), it.value());
+    }
+}
+
+void SessionSupervisor::touch(const QString& cardId) {
+    auto it = m_sessions.find(cardId);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    it->lastActivity = m_clock->nowMSecs();
+    scheduleIdle(cardId, it.value());
+}
+
+QDateTime SessionSupervisor::deadline(const QString& cardId, AutoEndReason reason) const {
+    auto it = m_sessions.constFind(cardId);
+    if (it == m_sessions.constEnd()) {
+        return QDateTime();
+    }
+
+    const quint64 id =
+        (reason == AutoEndReason::BalanceExhausted) ? it->balanceTimer : it->idleTimer;
+    const qint64 tick = id ? m_wheel.expiryOf(id) : -1;
+    return tick < 0 ? QDateTime() : QDateTime::fromMSecsSinceEpoch(tick * TICK_MSECS);
+}
+
+// ========== 推进 ==========
+
+int SessionSupervisor::advance() {
+    const QList<TimerWheel::Timer> expired = m_wheel.advance(m_clock->nowMSecs() / TICK_MSECS);
+
+    int count = 0;
+    for (const auto& timer : expired) {
+        auto it = m_sessions.find(timer.key);
+        if (it == m_sessions.end()) {
+            continue;  // 同一会话的另一个定时器已在本次到期
+        }
+
+        const AutoEndReason reason = (timer.id == it->balanceTimer)
+                                         ? AutoEndReason::BalanceExhausted
+                                         : AutoEndReason::IdleTimeout;
+        untrack(timer.key);
+        ++count;
+        emit sessionExpired(timer.key, reason);
+    }
+    return count;
+}
+
+// ========== 跟踪 ==========
+
+void SessionSupervisor::sync(const QString& cardId) {
+    if (!m_recordService->isOnline(cardId)) {
+        untrack(cardId);
+        return;
+    }
+    if (m_sessions.contains(cardId)) {
+        return;
+    }
+
+    Tracked& tracked = m_sessions[cardId];
+    tracked.lastActivity = m_clock->nowMSecs();
+    scheduleBalance(cardId, tracked);
+    scheduleIdle(cardId, tracked);
+}
+
+void SessionSupervisor::untrack(const QString& cardId) {
+    auto it = m_sessions.find(cardId);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    m_wheel.cancel(it->balanceTimer);
+    m_wheel.cancel(it->idleTimer);
+    m_sessions.erase(it);
+}
+
+void SessionSupervisor::scheduleBalance(const QString& cardId, Tracked& tracked) {
+    m_wheel.cancel(tracked.balanceTimer);
+    tracked.balanceTimer = 0;
+
+    const int minutes =
+        m_recordService->affordableMinutes(cardId, m_cardService->getBalance(cardId));
+    if (minutes < 0) {
+        return;  // 按当前规则一年内都不会用完
+    }
+
+    // 在最后一个付得起的计费分钟开始时到期：此时下机按向上取整计费，恰好不超出余额
+    const qint64 start = m_recordService->getCurrentSession(cardId).startTime().toMSecsSinceEpoch();
+    const qint64 expiry = start + qMax(0, minutes - 1) * qint64(60000);
+    tracked.balanceTimer = m_wheel.schedule(cardId, tickAt(expiry));
+}
+
+void SessionSupervisor::scheduleIdle(const QString& cardId, Tracked& tracked) {
+    m_wheel.cancel(tracked.idleTimer);
+    tracked.idleTimer = 0;
+
+    if (m_idleTimeoutMinutes > 0) {
+        const qint64 expiry = tracked.lastActivity + m_idleTimeoutMinutes * qint64(60000);
+        tracked.idleTimer = m_wheel.schedule(cardId, tickAt(expiry));
+    }
+}
+
+qint64 SessionSupervisor::tickAt(qint64 msecs) {
+    return (msecs + TICK_MSECS - 1) / TICK_MSECS;
+}
+
+}  // namespace CampusCard
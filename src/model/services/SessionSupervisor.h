@@ -0,0 +1,182 @@
+/**
+ * @file SessionSupervisor.h
+ * @brief 上机会话监督
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 为每个上机中的会话维护余额耗尽时刻和空闲超时两个定时器，
+ * 到期时发出自动下机通知；定时器保存在分层时间轮中，
+ * 每个刻度的开销与在线会话数无关
+ */
+
+#ifndef MODEL_SERVICES_SESSIONSUPERVISOR_H
+#define MODEL_SERVICES_SESSIONSUPERVISOR_H
+
+#include "model/Clock.h"
+#include "model/services/CardService.h"
+#include "model/services/RecordService.h"
+#include "model/services/TimerWheel.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+
+namespace CampusCard {
+
+/**
+ * @enum AutoEndReason
+ * @brief 自动下机原因
+ */
+enum class AutoEndReason {
+    BalanceExhausted,  ///< 余额即将用完
+    IdleTimeout        ///< 长时间无操作
+};
+
+/**
+ * @class SessionSupervisor
+ * @brief 上机会话监督器
+ *
+ * 跟踪RecordService和CardService的信号：上机时加入定时器，下机时取消，
+ * 余额变化时按当前计费规则重新计算余额耗尽时刻。余额定时器设在最后一个
+ * 付得起的计费分钟开始时，使自动下机的扣款不会超出余额。
+ *
+ * 时间取自可替换的Clock；start()后由QTimer每个刻度调用一次advance()，
+ * 测试时可不启动QTimer，直接推进受控时钟后调用advance()。
+ */
+class SessionSupervisor : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qint64 TICK_MSECS = 1000;  ///< 时间轮刻度（毫秒）
+
+    /**
+     * @brief 构造函数
+     * @param cardService 卡服务
+     * @param recordService 记录服务
+     * @param clock 时钟（为空时使用记录服务的时钟）
+     * @param parent 父对象
+     */
+    SessionSupervisor(CardService* cardService, RecordService* recordService,
+                      Clock* clock = nullptr, QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~SessionSupervisor() override = default;
+
+    /**
+     * @brief 重新跟踪所有在线会话并开始定时推进
+     *
+     * 服务重新加载数据后也应调用
+     */
+    void start();
+
+    /**
+     * @brief 停止定时推进（定时器保留）
+     */
+    void stop();
+
+    /**
+     * @brief 设置空闲超时
+     * @param minutes 分钟数（0表示不检查空闲）
+     */
+    void setIdleTimeout(int minutes);
+
+    /**
+     * @brief 获取空闲超时
+     * @return 分钟数（0表示不检查空闲）
+     */
+    [[nodiscard]] int idleTimeout() const { return m_idleTimeoutMinutes; }
+
+    /**
+     * @brief 记录一次活动，重新开始空闲计时
+     * @param cardId 卡号
+     */
+    void touch(const QString& cardId);
+
+    /**
+     * @brief 推进时间轮到时钟的当前时间，发出到期会话的通知
+     * @return 本次到期的会话数
+     */
+    int advance();
+
+    /**
+     * @brief 获取会话的自动下机时刻
+     * @param cardId 卡号
+     * @param reason 原因
+     * @return 到期时刻（未跟踪或没有该定时器时返回无效时间）
+     */
+    [[nodiscard]] QDateTime deadline(const QString& cardId, AutoEndReason reason) const;
+
+    /**
+     * @brief 正在跟踪的会话数
+     */
+    [[nodiscard]] int trackedCount() const { return static_cast<int>(m_sessions.size()); }
+
+signals:
+    /**
+     * @brief 会话到期信号（每个会话只发出一次，由接收方结束上机）
+     * @param cardId 卡号
+     * @param reason 原因
+     */
+    void sessionExpired(const QString& cardId, AutoEndReason reason);
+
+private:
+    /**
+     * @struct Tracked
+     * @brief 一个会话的定时器
+     */
+    struct Tracked {
+        quint64 balanceTimer = 0;  ///< 余额耗尽定时器ID（0表示无）
+        quint64 idleTimer = 0;     ///< 空闲超时定时器ID（0表示无）
+        qint64 lastActivity = 0;   ///< 最近一次活动时间（毫秒）
+    };
+
+    /**
+     * @brief 根据会话当前状态开始或停止跟踪
+     * @param cardId 卡号
+     */
+    void sync(const QString& cardId);
+
+    /**
+     * @brief 停止跟踪并取消定时器
+     * @param cardId 卡号
+     */
+    void untrack(const QString& cardId);
+
+    /**
+     * @brief 重新计算余额耗尽时刻
+     * @param cardId 卡号
+     * @param tracked 会话的定时器
+     */
+    void scheduleBalance(const QString& cardId, Tracked& tracked);
+
+    /**
+     * @brief 重新计算空闲超时时刻
+     * @param cardId 卡号
+     * @param tracked 会话的定时器
+     */
+    void scheduleIdle(const QString& cardId, Tracked& tracked);
+
+    /**
+     * @brief 毫秒时间对应的刻度（向上取整，保证不早于该时间到期）
+     * @param msecs 毫秒
+     * @return 刻度
+     */
+    [[nodiscard]] static qint64 tickAt(qint64 msecs);
+
+    CardService* m_cardService;       ///< 卡服务
+    RecordService* m_recordService;   ///< 记录服务
+    Clock* m_clock;                   ///< 时钟
+    TimerWheel m_wheel;               ///< 时间轮
+    QHash<QString, Tracked> m_sessions;  ///< 卡号到会话定时器的映射
+    QTimer m_ticker;                  ///< 定时推进
+    int m_idleTimeoutMinutes = 0;     ///< 空闲超时（分钟）
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_SESSIONSUPERVISOR_H
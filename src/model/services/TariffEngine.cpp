@@ -0,0 +1,267 @@
+/**
+ * @file TariffEngine.cpp
+ * @brief 计费规则与批量重新计费实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "TariffEngine.h"
+
+#include <QJsonArray>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+
+namespace CampusCard {
+
+// ========== Tariff ==========
+
+QJsonObject Tariff::toJson() const {
+    QJsonObject json;
+    hourlyRate.writeJson(json, QStringLiteral("hourlyRate"));
+    minimumCharge.writeJson(json, QStringLiteral("minimumCharge"));
+
+    QJsonArray rulesArray;
+    for (const auto& rule : rules) {
+        QJsonObject item;
+        item[QStringLiteral("location")] = rule.location;
+        item[QStringLiteral("startMinute")] = rule.startMinute;
+        item[QStringLiteral("endMinute")] = rule.endMinute;
+        rule.hourlyRate.writeJson(item, QStringLiteral("hourlyRate"));
+        rulesArray.append(item);
+    }
+    json[QStringLiteral("rules")] = rulesArray;
+
+    QJsonArray discountsArray;
+    for (const auto& discount : discounts) {
+        QJsonObject item;
+        item[QStringLiteral("studentIdPrefix")] = discount.studentIdPrefix;
+        item[QStringLiteral("percent")] = discount.percent;
+        discountsArray.append(item);
+    }
+    json[QStringLiteral("discounts")] = discountsArray;
+    return json;
+}
+
+Tariff Tariff::fromJson(const QJsonObject& json) {
+    Tariff tariff;
+    if (json.contains(QStringLiteral("hourlyRateCents")) ||
+        json.contains(QStringLiteral("hourlyRate"))) {
+        tariff.hourlyRate = Money::fromJson(json, QStringLiteral("hourlyRate"));
+    }
+    tariff.minimumCharge = Money::fromJson(json, QStringLiteral("minimumCharge"));
+
+    for (const auto& value : json[QStringLiteral("rules")].toArray()) {
+        QJsonObject item = value.toObject();
+        TariffRule rule;
+        rule.location = item[QStringLiteral("location")].toString();
+        rule.startMinute = item[QStringLiteral("startMinute")].toInt(-1);
+        rule.endMinute = item[QStringLiteral("endMinute")].toInt(-1);
+        rule.hourlyRate = Money::fromJson(item, QStringLiteral("hourlyRate"));
+        if (rule.startMinute >= 0 && rule.startMinute < TariffEngine::MINUTES_PER_DAY &&
+            rule.endMinute > 0 && rule.endMinute <= TariffEngine::MINUTES_PER_DAY &&
+            rule.startMinute != rule.endMinute && !rule.hourlyRate.isNegative()) {
+            tariff.rules.append(rule);
+        }
+    }
+
+    for (const auto& value : json[QStringLiteral("discounts")].toArray()) {
+        QJsonObject item = value.toObject();
+        TariffDiscount discount;
+        discount.studentIdPrefix = item[QStringLiteral("studentIdPrefix")].toString();
+        discount.percent = item[QStringLiteral("percent")].toInt(100);
+        if (discount.percent >= 0) {
+            tariff.discounts.append(discount);
+        }
+    }
+    return tariff;
+}
+
+// ========== RebillReport ==========
+
+QString RebillReport::toCsv() const {
+    QString csv = QStringLiteral("recordId,cardId,date,oldCost,newCost,delta\n");
+    for (const auto& diff : diffs) {
+        csv += QStringLiteral("%1,%2,%3,%4,%5,%6\n")
+                   .arg(diff.recordId.toString(), diff.cardId, diff.date,
+                        diff.oldCost.toString(), diff.newCost.toString(),
+                        (diff.newCost - diff.oldCost).toString());
+    }
+    return csv;
+}
+
+// ========== 编译 ==========
+
+TariffEngine::TariffEngine() : TariffEngine(Tariff()) {}
+
+TariffEngine::TariffEngine(const Tariff& tariff) : m_tariff(tariff) {
+    // 默认地点只应用不限地点的规则，其余地点各自在此基础上叠加
+    QStringList locations;
+    locations.append(QString());
+    for (const auto& rule : tariff.rules) {
+        if (!rule.location.isEmpty() && !locations.contains(rule.location)) {
+            m_locationTables[rule.location] = static_cast<int>(locations.size());
+            locations.append(rule.location);
+        }
+    }
+
+    m_tables.reserve(locations.size());
+    std::array<qint64, MINUTES_PER_DAY> rates;
+    for (const auto& location : locations) {
+        rates.fill(tariff.hourlyRate.cents());
+        for (const auto& rule : tariff.rules) {
+            if (!rule.location.isEmpty() && rule.location != location) {
+                continue;
+            }
+            // 按顺序覆盖，跨午夜的时段拆成两段
+            const int end = rule.startMinute < rule.endMinute ? rule.endMinute : MINUTES_PER_DAY;
+            std::fill(rates.begin() + rule.startMinute, rates.begin() + end,
+                      rule.hourlyRate.cents());
+            if (rule.startMinute > rule.endMinute) {
+                std::fill(rates.begin(), rates.begin() + rule.endMinute, rule.hourlyRate.cents());
+            }
+        }
+
+        PrefixTable prefix;
+        prefix[0] = 0;
+        for (int m = 0; m < MINUTES_PER_DAY; ++m) {
+            prefix[m + 1] = prefix[m] + rates[m];
+        }
+        m_tables.append(prefix);
+    }
+
+    m_discounts = tariff.discounts;
+    std::stable_sort(m_discounts.begin(), m_discounts.end(),
+                     [](const TariffDiscount& a, const TariffDiscount& b) {
+                         return a.studentIdPrefix.size() > b.studentIdPrefix.size();
+                     });
+}
+
+// ========== 计费 ==========
+
+qint64 TariffEngine::rateMinutes(const PrefixTable& table, int startMinute, int durationMinutes) {
+    const qint64 fullDays = durationMinutes / MINUTES_PER_DAY;
+    const int rest = durationMinutes % MINUTES_PER_DAY;
+    qint64 total = fullDays * table[MINUTES_PER_DAY];
+
+    const int end = startMinute + rest;
+    if (end <= MINUTES_PER_DAY) {
+        total += table[end] - table[startMinute];
+    } else {
+        total += table[MINUTES_PER_DAY] - table[startMinute] + table[end - MINUTES_PER_DAY];
+    }
+    return total;
+}
+
+int TariffEngine::discountPercent(const QString& studentId) const {
+    for (const auto& discount : m_discounts) {
+        if (studentId.startsWith(discount.studentIdPrefix)) {
+            return discount.percent;
+        }
+    }
+    return 100;
+}
+
+Money TariffEngine::cost(const QString& location, const QDateTime& start, int durationMinutes,
+                         const QString& studentId) const {
+    if (durationMinutes <= 0) {
+        return Money();
+    }
+
+    const PrefixTable& table = m_tables.at(m_locationTables.value(location, 0));
+    const QTime time = start.isValid() ? start.time() : QTime(0, 0);
+    const int startMinute = time.hour() * 60 + time.minute();
+
+    // 费率之和单位为"分/小时 × 分钟"，除以60并乘以折扣比例后一次性舍入
+    const Money raw = Money::fromCents(rateMinutes(table, startMinute, durationMinutes));
+    const Money charged = raw.scaled(discountPercent(studentId), 60 * 100);
+    return std::max(charged, m_tariff.minimumCharge);
+}
+
+// ========== 批量重新计费 ==========
+
+QList<TariffEngine::Chunk> TariffEngine::partition(const QMap<QString, QList<Record>>& records,
+                                                   const QMap<QString, QString>& studentIds,
+                                                   const RecordQuery& query) {
+    QList<Chunk> chunks;
+    Chunk current;
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
+        if (query.cardFilter() && it.key() != *query.cardFilter()) {
+            continue;
+        }
+        current.records.append(it.value());
+        current.studentIds.append(studentIds.value(it.key()));
+        if (current.records.size() == CARDS_PER_CHUNK) {
+            chunks.append(current);
+            current = Chunk();
+        }
+    }
+    if (!current.records.isEmpty()) {
+        chunks.append(current);
+    }
+    return chunks;
+}
+
+RebillReport TariffEngine::rebillChunk(const Chunk& chunk, const RecordQuery& query) const {
+    RebillReport report;
+    for (qsizetype i = 0; i < chunk.records.size(); ++i) {
+        const QString& studentId = chunk.studentIds.at(i);
+        for (const auto& record : chunk.records.at(i)) {
+            if (!record.isOffline() || !query.matches(record)) {
+                continue;
+            }
+            const Money newCost =
+                cost(record.location(), record.startTime(), record.durationMinutes(), studentId);
+            report.examined++;
+            report.oldTotal += record.cost();
+            report.newTotal += newCost;
+            if (newCost != record.cost()) {
+                report.diffs.append(
+                    {record.id(), record.cardId(), record.date(), record.cost(), newCost});
+            }
+        }
+    }
+    return report;
+}
+
+void TariffEngine::merge(RebillReport& total, const RebillReport& part) {
+    total.examined += part.examined;
+    total.oldTotal += part.oldTotal;
+    total.newTotal += part.newTotal;
+    total.diffs.append(part.diffs);
+}
+
+RebillReport TariffEngine::rebill(const QMap<QString, QList<Record>>& records,
+                                  const QMap<QString, QString>& studentIds,
+                                  const RecordQuery& query) const {
+    RebillReport total;
+    for (const auto& chunk : partition(records, studentIds, query)) {
+        merge(total, rebillChunk(chunk, query));
+    }
+    return total;
+}
+
+QFuture<RebillReport> TariffEngine::rebillAsync(const QMap<QString, QList<Record>>& records,
+                                                const QMap<QString, QString>& studentIds,
+                                                const RecordQuery& query,
+                                                QThreadPool* pool) const {
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+
+    // 分块在调用线程完成；引擎按值捕获，工作线程只读取隐式共享的数据
+    QList<Chunk> chunks = partition(records, studentIds, query);
+    const TariffEngine engine = *this;
+
+    return QtConcurrent::mappedReduced<RebillReport>(
+        pool, std::move(chunks),
+        [engine, query](const Chunk& chunk) { return engine.rebillChunk(chunk, query); },
+        [](RebillReport& total, const RebillReport& part) { merge(total, part); },
+        QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce);
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,223 @@
+/**
+ * @file TariffEngine.h
+ * @brief 计费规则与批量重新计费
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 计费规则（分时段/分地点费率、学生类别折扣、最低收费）编译为按分钟的
+ * 前缀和查找表，单次计费为O(1)；规则变更后可按查询条件并行重算历史记录，
+ * 并输出费用差异报告
+ */
+
+#ifndef MODEL_SERVICES_TARIFFENGINE_H
+#define MODEL_SERVICES_TARIFFENGINE_H
+
+#include "model/entities/Record.h"
+#include "model/services/RecordQuery.h"
+
+#include <QDateTime>
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+
+class QThreadPool;
+
+
+namespace CampusCard {
+
+/**
+ * @struct TariffRule
+ * @brief 分时段费率规则
+ *
+ * 时段为一天内的分钟区间[startMinute, endMinute)，startMinute大于endMinute时
+ * 表示跨越午夜（如 22:00-06:00）
+ */
+struct TariffRule {
+    QString location;           ///< 适用地点（空表示所有地点）
+    int startMinute = 0;        ///< 开始时刻（当天第几分钟，0-1439）
+    int endMinute = 24 * 60;    ///< 结束时刻（不含，1-1440）
+    Money hourlyRate;           ///< 每小时费率
+};
+
+/**
+ * @struct TariffDiscount
+ * @brief 学生类别折扣（类别按学号前缀识别）
+ */
+struct TariffDiscount {
+    QString studentIdPrefix;  ///< 学号前缀（如 "S" 表示研究生）
+    int percent = 100;        ///< 应付比例（百分比，80表示八折）
+};
+
+/**
+ * @struct Tariff
+ * @brief 计费规则集
+ *
+ * 规则按列表顺序叠加，后面的规则覆盖前面的规则；
+ * 折扣取学号前缀最长的一条匹配
+ */
+struct Tariff {
+    Money hourlyRate = COST_PER_HOUR;  ///< 基础每小时费率
+    QList<TariffRule> rules;           ///< 分时段/分地点费率
+    QList<TariffDiscount> discounts;   ///< 学生类别折扣
+    Money minimumCharge;               ///< 单次最低收费（时长大于0时生效）
+
+    /**
+     * @brief 转换为JSON
+     */
+    [[nodiscard]] QJsonObject toJson() const;
+
+    /**
+     * @brief 从JSON读取（缺失字段取默认值，非法时段被忽略）
+     */
+    [[nodiscard]] static Tariff fromJson(const QJsonObject& json);
+};
+
+/**
+ * @struct RebillDiff
+ * @brief 单条记录的重新计费差异
+ */
+struct RebillDiff {
+    RecordId recordId;  ///< 记录ID
+    QString cardId;     ///< 卡号
+    QString date;       ///< 上机日期
+    Money oldCost;      ///< 原费用
+    Money newCost;      ///< 新费用
+};
+
+/**
+ * @struct RebillReport
+ * @brief 重新计费报告
+ */
+struct RebillReport {
+    qint64 examined = 0;      ///< 参与计算的记录数
+    Money oldTotal;           ///< 原费用合计
+    Money newTotal;           ///< 新费用合计
+    QList<RebillDiff> diffs;  ///< 费用有变化的记录（按卡号、记录顺序）
+
+    /**
+     * @brief 费用变化合计（新 - 旧）
+     */
+    [[nodiscard]] Money delta() const { return newTotal - oldTotal; }
+
+    /**
+     * @brief 导出为CSV（表头 + 每条差异一行）
+     */
+    [[nodiscard]] QString toCsv() const;
+};
+
+/**
+ * @class TariffEngine
+ * @brief 编译后的计费规则
+ *
+ * 每个出现在规则中的地点（以及默认地点）对应一张长度为1441的前缀和表，
+ * prefix[m]为当天[0, m)分钟内每分钟费率（分/小时）之和。
+ * 一次上机的费用为覆盖分钟的费率之和 / 60，再乘以折扣比例，最后四舍五入到分，
+ * 跨天的会话按整天数乘以全天合计加上余下的区间计算。
+ */
+class TariffEngine {
+public:
+    static constexpr int MINUTES_PER_DAY = 24 * 60;  ///< 每天分钟数
+    static constexpr int CARDS_PER_CHUNK = 32;       ///< 批量重算时每个分块的卡数
+
+    /**
+     * @brief 使用默认规则（COST_PER_HOUR）构造
+     */
+    TariffEngine();
+
+    /**
+     * @brief 编译计费规则
+     * @param tariff 规则集
+     */
+    explicit TariffEngine(const Tariff& tariff);
+
+    /**
+     * @brief 编译前的规则集
+     */
+    [[nodiscard]] const Tariff& tariff() const { return m_tariff; }
+
+    /**
+     * @brief 计算一次上机的费用
+     * @param location 地点
+     * @param start 开始时间
+     * @param durationMinutes 时长（分钟）
+     * @param studentId 学号（用于类别折扣，可为空）
+     * @return 费用
+     */
+    [[nodiscard]] Money cost(const QString& location, const QDateTime& start, int durationMinutes,
+                             const QString& studentId = QString()) const;
+
+    /**
+     * @brief 学号对应的应付比例
+     * @param studentId 学号
+     * @return 百分比（无匹配折扣时为100）
+     */
+    [[nodiscard]] int discountPercent(const QString& studentId) const;
+
+    /**
+     * @brief 串行重新计费
+     *
+     * 只计算已结束（Offline）且满足查询条件的记录，不修改记录本身
+     * @param records 卡号到记录列表的映射
+     * @param studentIds 卡号到学号的映射（用于类别折扣）
+     * @param query 过滤条件
+     * @return 差异报告
+     */
+    [[nodiscard]] RebillReport rebill(const QMap<QString, QList<Record>>& records,
+                                      const QMap<QString, QString>& studentIds,
+                                      const RecordQuery& query) const;
+
+    /**
+     * @brief 在线程池中并行重新计费
+     *
+     * 与HistoryAggregator相同，按卡号顺序切分分块并有序归并，
+     * 结果与rebill()完全一致；QFuture进度范围为分块数，可取消
+     * @param records 卡号到记录列表的映射
+     * @param studentIds 卡号到学号的映射
+     * @param query 过滤条件
+     * @param pool 线程池（nullptr表示全局线程池）
+     * @return 差异报告的QFuture
+     */
+    [[nodiscard]] QFuture<RebillReport> rebillAsync(const QMap<QString, QList<Record>>& records,
+                                                    const QMap<QString, QString>& studentIds,
+                                                    const RecordQuery& query,
+                                                    QThreadPool* pool = nullptr) const;
+
+private:
+    using PrefixTable = std::array<qint64, MINUTES_PER_DAY + 1>;
+
+    /**
+     * @brief 重算单个分块（分块内为若干张卡的记录及其学号）
+     */
+    struct Chunk {
+        QList<QList<Record>> records;
+        QStringList studentIds;
+    };
+
+    static QList<Chunk> partition(const QMap<QString, QList<Record>>& records,
+                                  const QMap<QString, QString>& studentIds,
+                                  const RecordQuery& query);
+    RebillReport rebillChunk(const Chunk& chunk, const RecordQuery& query) const;
+    static void merge(RebillReport& total, const RebillReport& part);
+
+    /**
+     * @brief 费率之和（分/小时 × 分钟）
+     */
+    [[nodiscard]] static qint64 rateMinutes(const PrefixTable& table, int startMinute,
+                                            int durationMinutes);
+
+    Tariff m_tariff;                       ///< 规则集
+    QList<PrefixTable> m_tables;           ///< 前缀和表（下标0为默认地点）
+    QHash<QString, int> m_locationTables;  ///< 地点到前缀和表下标
+    QList<TariffDiscount> m_discounts;     ///< 按前缀长度降序的折扣
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_TARIFFENGINE_H
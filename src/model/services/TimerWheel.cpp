@@ -0,0 +1,96 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief 分层时间轮实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "TimerWheel.h"
+
+
+namespace CampusCard {
+
+TimerWheel::TimerWheel(qint64 currentTick) : m_currentTick(currentTick) {}
+
+// ========== 定时器 ==========
+
+quint64 TimerWheel::schedule(const QString& key, qint64 expiryTick) {
+    Timer timer;
+    timer.id = m_nextId++;
+    timer.key = key;
+    timer.expiryTick = qMax(expiryTick, m_currentTick + 1);
+
+    m_live.insert(timer.id, timer.expiryTick);
+    place(timer);
+    return timer.id;
+}
+
+bool TimerWheel::cancel(quint64 id) {
+    return m_live.remove(id) > 0;
+}
+
+void TimerWheel::place(const Timer& timer) {
+    // 超出跨度的定时器暂放最高层，级联时按真实到期刻度重新放置
+    const qint64 placed = qMin(timer.expiryTick, m_currentTick + SPAN - 1);
+    const qint64 delta = placed - m_currentTick;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (qint64(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    const qint64 slot = (placed >> (SLOT_BITS * level)) & (SLOTS - 1);
+    m_slots[level][slot].append(timer);
+}
+
+// ========== 推进 ==========
+
+QList<TimerWheel::Timer> TimerWheel::advance(qint64 tick) {
+    QList<Timer> expired;
+    while (m_currentTick < tick) {
+        // 槽中只剩已取消的条目，它们的ID不会再被使用，可以直接跳过
+        if (m_live.isEmpty()) {
+            m_currentTick = tick;
+            break;
+        }
+
+        ++m_currentTick;
+        cascade();
+
+        QList<Timer> due;
+        due.swap(m_slots[0][m_currentTick & (SLOTS - 1)]);
+        for (auto& timer : due) {
+            if (!m_live.contains(timer.id)) {
+                continue;
+            }
+            if (timer.expiryTick > m_currentTick) {
+                place(timer);
+                continue;
+            }
+            m_live.remove(timer.id);
+            expired.append(std::move(timer));
+        }
+    }
+    return expired;
+}
+
+void TimerWheel::cascade() {
+    // 从高层到低层：高层级联下来的定时器可能正好落在本刻度要级联的低层槽中
+    for (int level = LEVELS - 1; level > 0; --level) {
+        const int shift = SLOT_BITS * level;
+        if ((m_currentTick & ((qint64(1) << shift) - 1)) != 0) {
+            continue;
+        }
+
+        QList<Timer> timers;
+        timers.swap(m_slots[level][(m_currentTick >> shift) & (SLOTS - 1)]);
+        for (const auto& timer : timers) {
+            if (m_live.contains(timer.id)) {
+                place(timer);
+            }
+        }
+    }
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,130 @@
+/**
+ * @file TimerWheel.h
+ * @brief 分层时间轮
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 4层、每层64个槽的时间轮，定时器的加入与取消为O(1)，
+ * 每推进一个刻度只处理一个槽，与定时器总数无关
+ */
+
+#ifndef MODEL_SERVICES_TIMERWHEEL_H
+#define MODEL_SERVICES_TIMERWHEEL_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <array>
+
+
+namespace CampusCard {
+
+/**
+ * @class TimerWheel
+ * @brief 以整数刻度计时的分层时间轮
+ *
+ * 第L层的一个槽覆盖64^L个刻度。定时器按距到期的刻度数放入对应层，
+ * 当低层转完一圈时把高一层当前槽中的定时器重新分配到低层（级联），
+ * 因此每个定时器最多被移动LEVELS-1次。超出整个时间轮跨度的定时器
+ * 先放在最高层，级联时再按真实到期刻度重新放置。
+ *
+ * 取消只从存活表中删除，槽中的旧条目在该槽被处理时丢弃。
+ */
+class TimerWheel {
+public:
+    static constexpr int SLOT_BITS = 6;                       ///< 每层槽数的位数
+    static constexpr int SLOTS = 1 << SLOT_BITS;              ///< 每层槽数
+    static constexpr int LEVELS = 4;                          ///< 层数
+    static constexpr qint64 SPAN = qint64(1) << (SLOT_BITS * LEVELS);  ///< 时间轮跨度（刻度）
+
+    /**
+     * @struct Timer
+     * @brief 定时器
+     */
+    struct Timer {
+        quint64 id = 0;          ///< 定时器ID
+        QString key;             ///< 调用方的标识（如卡号）
+        qint64 expiryTick = 0;   ///< 到期刻度
+    };
+
+    /**
+     * @brief 构造函数
+     * @param currentTick 起始刻度（视为已处理）
+     */
+    explicit TimerWheel(qint64 currentTick = 0);
+
+    /**
+     * @brief 加入定时器
+     * @param key 调用方的标识
+     * @param expiryTick 到期刻度（不晚于当前刻度时在下一个刻度到期）
+     * @return 定时器ID（用于取消）
+     */
+    quint64 schedule(const QString& key, qint64 expiryTick);
+
+    /**
+     * @brief 取消定时器
+     * @param id 定时器ID
+     * @return 定时器存在且尚未到期时返回true
+     */
+    bool cancel(quint64 id);
+
+    /**
+     * @brief 定时器是否仍在等待
+     * @param id 定时器ID
+     */
+    [[nodiscard]] bool isPending(quint64 id) const { return m_live.contains(id); }
+
+    /**
+     * @brief 定时器的到期刻度
+     * @param id 定时器ID
+     * @return 到期刻度（定时器不存在时返回-1）
+     */
+    [[nodiscard]] qint64 expiryOf(quint64 id) const { return m_live.value(id, -1); }
+
+    /**
+     * @brief 推进到指定刻度
+     *
+     * 没有等待中的定时器时直接跳到目标刻度
+     * @param tick 目标刻度（不大于当前刻度时什么也不做）
+     * @return 期间到期的定时器（按到期刻度排序）
+     */
+    QList<Timer> advance(qint64 tick);
+
+    /**
+     * @brief 已处理到的刻度
+     */
+    [[nodiscard]] qint64 currentTick() const { return m_currentTick; }
+
+    /**
+     * @brief 等待中的定时器数
+     */
+    [[nodiscard]] qsizetype size() const { return m_live.size(); }
+
+    /**
+     * @brief 是否没有等待中的定时器
+     */
+    [[nodiscard]] bool isEmpty() const { return m_live.isEmpty(); }
+
+private:
+    /**
+     * @brief 按距到期的刻度数放入对应层的槽
+     * @param timer 定时器
+     */
+    void place(const Timer& timer);
+
+    /**
+     * @brief 当前刻度对齐到高层边界时，将高层当前槽重新分配到低层
+     */
+    void cascade();
+
+    std::array<std::array<QList<Timer>, SLOTS>, LEVELS> m_slots;  ///< 各层的槽
+    QHash<quint64, qint64> m_live;                                 ///< 等待中的定时器ID到到期刻度
+    qint64 m_currentTick;                                          ///< 已处理到的刻度
+    quint64 m_nextId = 1;                                          ///< 下一个定时器ID
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_TIMERWHEEL_H
@@ -0,0 +1,310 @@
+/**
+ * @file TransactionManager.cpp
+ * @brief 跨服务事务管理实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "TransactionManager.h"
+
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <utility>
+
+
+namespace CampusCard {
+
+namespace {
+
+const QString ENTRY_END_SESSION = QStringLiteral("endSession");
+const QString ENTRY_END_SESSIONS = QStringLiteral("endSessions");
+
+}  // namespace
+
+TransactionManager::TransactionManager(CardService* cardService, RecordService* recordService,
+                                       QObject* parent)
+    : QObject(parent), m_cardService(cardService), m_recordService(recordService) {}
+
+// ========== 恢复 ==========
+
+int TransactionManager::recover() {
+    Notifications notifications;
+    QMutexLocker commit(&m_commitMutex);
+    QList<QJsonObject> entries = StorageManager::instance().loadJournal();
+
+    // 序号必须大于卡文件和日志中出现过的所有序号
+    quint64 lastSequence = m_cardService->maxJournalSequence();
+    for (const auto& entry : entries) {
+        lastSequence = qMax(lastSequence,
+                            static_cast<quint64>(entry[QStringLiteral("seq")].toInteger()));
+    }
+    m_nextSequence = lastSequence + 1;
+
+    int replayed = 0;
+    for (const auto& entry : entries) {
+        if (apply(entry, notifications)) {
+            ++replayed;
+        }
+    }
+
+    if (!entries.isEmpty()) {
+        m_pending += static_cast<int>(entries.size());
+        checkpointLocked(notifications);
+    }
+    commit.unlock();
+
+    notify(notifications);
+    return replayed;
+}
+
+bool TransactionManager::apply(const QJsonObject& entry, Notifications& notifications) {
+    const QString type = entry[QStringLiteral("type")].toString();
+    if (type == ENTRY_END_SESSIONS) {
+        return applyBatch(entry, notifications);
+    }
+    if (type != ENTRY_END_SESSION) {
+        return false;
+    }
+
+    const QString cardId = entry[QStringLiteral("cardId")].toString();
+    const quint64 sequence = static_cast<quint64>(entry[QStringLiteral("seq")].toInteger());
+    Record closed = Record::fromJson(entry[QStringLiteral("record")].toObject());
+    closed.setCardId(cardId);
+    const Money debit = Money::fromJson(entry, QStringLiteral("debit"));
+
+    QWriteLocker locker(&m_snapshotLock);
+    ++m_epoch;
+    bool changed = false;
+    if (m_recordService->applyEndSession(cardId, closed, false, false)) {
+        notifications.ended.append(closed);
+        changed = true;
+    }
+    if (debit.isPositive() &&
+        m_cardService->applyJournaledDeduct(cardId, debit, sequence, false)) {
+        notifications.debited.append(cardId);
+        changed = true;
+    }
+
+    m_dirtyCards.insert(cardId);
+    m_dirtyDates.insert(closed.date());
+    return changed;
+}
+
+bool TransactionManager::applyBatch(const QJsonObject& entry, Notifications& notifications) {
+    const quint64 sequence = static_cast<quint64>(entry[QStringLiteral("seq")].toInteger());
+
+    QList<Record> closed;
+    QMap<QString, Money> debits;
+    for (const auto& value : entry[QStringLiteral("items")].toArray()) {
+        const QJsonObject item = value.toObject();
+        Record record = Record::fromJson(item[QStringLiteral("record")].toObject());
+        record.setCardId(item[QStringLiteral("cardId")].toString());
+        const Money debit = Money::fromJson(item, QStringLiteral("debit"));
+        if (debit.isPositive()) {
+            debits.insert(record.cardId(), debit);
+        }
+        m_dirtyCards.insert(record.cardId());
+        m_dirtyDates.insert(record.date());
+        closed.append(record);
+    }
+
+    QWriteLocker locker(&m_snapshotLock);
+    ++m_epoch;
+    const QList<Record> applied = m_recordService->applyEndSessions(closed, false, false);
+    const bool debited = m_cardService->applyJournaledDeducts(debits, sequence, false) > 0;
+    notifications.batchEnded.append(applied);
+    notifications.batchDebited = notifications.batchDebited || debited;
+    return !applied.isEmpty() || debited;
+}
+
+// ========== 下机结算 ==========
+
+Record TransactionManager::endSession(const QString& cardId) {
+    Notifications notifications;
+    QMutexLocker commit(&m_commitMutex);
+    const Record closed = m_recordService->prepareEndSession(cardId);
+    if (!closed.isValid() || !commitLocked({closed}, false, notifications)) {
+        return Record();
+    }
+
+    if (m_pending >= CHECKPOINT_INTERVAL) {
+        checkpointLocked(notifications);
+    }
+    commit.unlock();
+
+    notify(notifications);
+    return closed;
+}
+
+QList<Record> TransactionManager::endSessions(const QStringList& cardIds) {
+    Notifications notifications;
+    QMutexLocker commit(&m_commitMutex);
+    QList<Record> prepared;
+    QSet<QString> seen;
+    for (const auto& cardId : cardIds) {
+        const Record closed = m_recordService->prepareEndSession(cardId);
+        if (!closed.isValid() || seen.contains(cardId)) {
+            continue;
+        }
+        seen.insert(cardId);
+        prepared.append(closed);
+    }
+    if (prepared.isEmpty() || !commitLocked(prepared, true, notifications)) {
+        return QList<Record>();
+    }
+
+    if (m_pending >= CHECKPOINT_INTERVAL) {
+        checkpointLocked(notifications);
+    }
+    commit.unlock();
+
+    notify(notifications);
+    return prepared;
+}
+
+bool TransactionManager::commitLocked(const QList<Record>& closed, bool batch,
+                                      Notifications& notifications) {
+    QMap<QString, Money> costs;
+    for (const auto& record : closed) {
+        costs.insert(record.cardId(), record.cost());
+    }
+    const quint64 sequence = m_nextSequence;
+
+    // 扣款决定在卡分片写锁内做出并写入日志，到扣款生效前余额和卡状态不会再变；
+    // 快照锁先于分片锁获取，与snapshot()的顺序一致
+    QWriteLocker locker(&m_snapshotLock);
+    QMap<QString, Money> debits;
+    const bool committed = m_cardService->commitDeducts(
+        costs, sequence, [&](const QMap<QString, Money>& decided) {
+            QJsonObject entry;
+            entry[QStringLiteral("seq")] = static_cast<qint64>(sequence);
+            if (batch) {
+                QJsonArray items;
+                for (const auto& record : closed) {
+                    QJsonObject item;
+                    item[QStringLiteral("cardId")] = record.cardId();
+                    item[QStringLiteral("record")] = record.toJson();
+                    decided.value(record.cardId()).writeJson(item, QStringLiteral("debit"));
+                    items.append(item);
+                }
+                entry[QStringLiteral("type")] = ENTRY_END_SESSIONS;
+                entry[QStringLiteral("items")] = items;
+            } else {
+                const Record& record = closed.first();
+                entry[QStringLiteral("type")] = ENTRY_END_SESSION;
+                entry[QStringLiteral("cardId")] = record.cardId();
+                entry[QStringLiteral("record")] = record.toJson();
+                decided.value(record.cardId()).writeJson(entry, QStringLiteral("debit"));
+            }
+
+            // 日志落盘即提交；失败时内存状态未改动
+            if (!StorageManager::instance().appendJournal(entry)) {
+                return false;
+            }
+            debits = decided;
+            return true;
+        });
+    if (!committed) {
+        return false;
+    }
+    ++m_nextSequence;
+    ++m_pending;
+    ++m_epoch;
+
+    // 记录一侧在释放分片锁之后、释放快照锁之前应用
+    for (const auto& record : closed) {
+        m_dirtyCards.insert(record.cardId());
+        m_dirtyDates.insert(record.date());
+    }
+    if (batch) {
+        notifications.batchEnded.append(m_recordService->applyEndSessions(closed, false, false));
+        for (const auto& debit : std::as_const(debits)) {
+            notifications.batchDebited = notifications.batchDebited || debit.isPositive();
+        }
+    } else {
+        const Record& record = closed.first();
+        if (m_recordService->applyEndSession(record.cardId(), record, false, false)) {
+            notifications.ended.append(record);
+        }
+        if (debits.value(record.cardId()).isPositive()) {
+            notifications.debited.append(record.cardId());
+        }
+    }
+    return true;
+}
+
+// ========== 检查点 ==========
+
+bool TransactionManager::checkpoint() {
+    Notifications notifications;
+    QMutexLocker commit(&m_commitMutex);
+    const bool ok = checkpointLocked(notifications);
+    commit.unlock();
+
+    notify(notifications);
+    return ok;
+}
+
+bool TransactionManager::checkpointLocked(Notifications& notifications) {
+    if (m_pending == 0) {
+        return true;
+    }
+
+    bool ok = m_cardService->saveAll();
+    ok = m_recordService->flush(QStringList(m_dirtyCards.cbegin(), m_dirtyCards.cend()),
+                                QStringList(m_dirtyDates.cbegin(), m_dirtyDates.cend())) &&
+         ok;
+    if (!ok || !StorageManager::instance().clearJournal()) {
+        return false;
+    }
+
+    notifications.checkpointed += m_pending;
+    m_pending = 0;
+    m_dirtyCards.clear();
+    m_dirtyDates.clear();
+    return true;
+}
+
+// ========== 通知 ==========
+
+void TransactionManager::notify(const Notifications& notifications) {
+    for (const auto& record : notifications.ended) {
+        m_recordService->notifySessionEnded(record.cardId(), record);
+    }
+    m_recordService->notifySessionsEnded(notifications.batchEnded);
+    for (const auto& cardId : notifications.debited) {
+        m_cardService->notifyBalanceChanged(cardId);
+    }
+    if (notifications.batchDebited) {
+        m_cardService->notifyCardsChanged();
+    }
+    if (notifications.checkpointed > 0) {
+        emit checkpointed(notifications.checkpointed);
+    }
+}
+
+int TransactionManager::pendingCount() const {
+    QMutexLocker commit(&m_commitMutex);
+    return m_pending;
+}
+
+// ========== 快照 ==========
+
+DataSnapshot TransactionManager::snapshot() const {
+    // 读锁排除正在应用的事务；两个服务各自在自己的锁内复制引用
+    QReadLocker locker(&m_snapshotLock);
+    return DataSnapshot(m_epoch, m_cardService->cardShards(), m_recordService->recordsSnapshot(),
+                        m_recordService->tariff());
+}
+
+quint64 TransactionManager::epoch() const {
+    QReadLocker locker(&m_snapshotLock);
+    return m_epoch;
+}
+
+}  // namespace CampusCard
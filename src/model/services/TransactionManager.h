@@ -0,0 +1,195 @@
+/**
+ * @file TransactionManager.h
+ * @brief 跨服务事务管理
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 将下机时的记录结束与余额扣款合并为一条事务日志，一次追加写入、一次fsync
+ * 即完成提交；卡文件和记录文件按检查点批量重写，启动时重放未检查点的日志
+ */
+
+#ifndef MODEL_SERVICES_TRANSACTIONMANAGER_H
+#define MODEL_SERVICES_TRANSACTIONMANAGER_H
+
+#include "model/services/CardService.h"
+#include "model/services/DataSnapshot.h"
+#include "model/services/RecordService.h"
+
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+
+namespace CampusCard {
+
+/**
+ * @class TransactionManager
+ * @brief 下机结算事务管理器
+ *
+ * 提交顺序：先追加并同步日志，再更新两个服务的内存状态。
+ * 是否扣款在涉及的卡分片写锁内决定，写日志和扣款都在这次加锁内完成，
+ * 期间直接扣款、冻结等修改无法改变决定所依据的余额和卡状态。
+ * 日志之外的文件在检查点时才写入，检查点成功后清空日志。
+ *
+ * 重放是幂等的：记录只在仍处于上机状态时结束，扣款只在日志序号大于卡上
+ * 已记录的序号时生效；两项判断所依据的状态与被修改的数据保存在同一个文件中，
+ * 因此无论崩溃发生在检查点的哪一步，重放后都恰好生效一次。
+ *
+ * 提交、重放和检查点相互串行；事务应用到两个服务的内存状态期间持有快照写锁，
+ * snapshot()持读锁复制引用，因此快照总是落在两条事务之间。
+ *
+ * 两个服务的变更信号和checkpointed信号都在释放提交锁和快照写锁之后发出，
+ * 槽函数可以安全地再次调用本对象的任何方法。
+ */
+class TransactionManager : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int CHECKPOINT_INTERVAL = 64;  ///< 累计多少条事务后自动检查点
+
+    /**
+     * @brief 构造函数
+     * @param cardService 卡服务
+     * @param recordService 记录服务
+     * @param parent 父对象
+     */
+    TransactionManager(CardService* cardService, RecordService* recordService,
+                       QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~TransactionManager() override = default;
+
+    /**
+     * @brief 重放未检查点的事务日志并执行检查点
+     *
+     * 应在两个服务initialize()之后调用
+     * @return 实际产生修改的日志条数
+     */
+    int recover();
+
+    /**
+     * @brief 结束上机并扣款（单次持久化提交）
+     *
+     * 余额不足或卡不可用时与原流程一致：记录正常结束，但不扣款
+     * @param cardId 卡号
+     * @return 已结束的记录（含费用和时长；失败时为无效记录，此时没有任何修改）
+     */
+    Record endSession(const QString& cardId);
+
+    /**
+     * @brief 批量结束上机并扣款（整批写一条日志，一次fsync）
+     *
+     * 未上机的卡号被跳过；扣款条件逐卡判断，规则与endSession()相同
+     * @param cardIds 卡号列表
+     * @return 已结束的记录（写日志失败时为空，此时没有任何修改）
+     */
+    QList<Record> endSessions(const QStringList& cardIds);
+
+    /**
+     * @brief 检查点：重写受影响的卡文件、记录文件和每日汇总，然后清空日志
+     * @return 是否成功（失败时保留日志，下次检查点或启动时重试）
+     */
+    bool checkpoint();
+
+    /**
+     * @brief 尚未检查点的事务数
+     * @return 事务数
+     */
+    [[nodiscard]] int pendingCount() const;
+
+    // ========== 快照 ==========
+
+    /**
+     * @brief 创建卡、记录与计费规则的一致性快照
+     *
+     * 只复制隐式共享的引用，持锁时间与数据量无关；
+     * 快照不包含只应用了一半的下机结算，之后的修改也不影响快照内容
+     * @return 快照句柄
+     */
+    [[nodiscard]] DataSnapshot snapshot() const;
+
+    /**
+     * @brief 当前提交纪元（已应用到内存的事务数，含启动时重放的日志）
+     * @return 纪元
+     */
+    [[nodiscard]] quint64 epoch() const;
+
+signals:
+    /**
+     * @brief 检查点完成信号（在提交锁外发出）
+     * @param transactions 本次检查点覆盖的事务数
+     */
+    void checkpointed(int transactions);
+
+private:
+    /**
+     * @struct Notifications
+     * @brief 持锁期间收集、释放锁后再发出的信号
+     */
+    struct Notifications {
+        QList<Record> ended;        ///< 单条下机已生效的记录（含卡号）
+        QStringList debited;        ///< 单条下机已扣款的卡号
+        QList<Record> batchEnded;   ///< 批量下机已生效的记录
+        bool batchDebited = false;  ///< 批量下机是否有卡被扣款
+        int checkpointed = 0;       ///< 检查点覆盖的事务数（0表示未完成检查点）
+    };
+
+    /**
+     * @brief 重放一条日志到内存状态
+     * @param entry 日志
+     * @param notifications 收集待发出的信号
+     * @return 是否产生修改
+     */
+    bool apply(const QJsonObject& entry, Notifications& notifications);
+
+    /**
+     * @brief 重放一条批量下机日志到内存状态
+     * @param entry 日志
+     * @param notifications 收集待发出的信号
+     * @return 是否产生修改
+     */
+    bool applyBatch(const QJsonObject& entry, Notifications& notifications);
+
+    /**
+     * @brief 决定扣款、写日志并应用到内存状态（调用方持有提交锁）
+     * @param closed 待结束的记录（含卡号，卡号互不相同）
+     * @param batch 是否写为批量下机日志
+     * @param notifications 收集待发出的信号
+     * @return 是否已提交（写日志失败时没有任何修改）
+     */
+    bool commitLocked(const QList<Record>& closed, bool batch, Notifications& notifications);
+
+    /**
+     * @brief 检查点（checkpoint()的实现，调用方持有提交锁）
+     * @param notifications 收集待发出的信号
+     * @return 是否成功
+     */
+    bool checkpointLocked(Notifications& notifications);
+
+    /**
+     * @brief 发出收集到的信号（调用方不持有提交锁和快照锁）
+     * @param notifications 待发出的信号
+     */
+    void notify(const Notifications& notifications);
+
+    CardService* m_cardService;             ///< 卡服务
+    RecordService* m_recordService;         ///< 记录服务
+    mutable QMutex m_commitMutex;           ///< 串行化提交、重放与检查点
+    mutable QReadWriteLock m_snapshotLock;  ///< 应用事务持写锁，创建快照持读锁
+    quint64 m_epoch = 0;                    ///< 已应用的事务数（受快照锁保护）
+    quint64 m_nextSequence = 1;             ///< 下一条日志序号
+    int m_pending = 0;                      ///< 尚未检查点的事务数
+    QSet<QString> m_dirtyCards;             ///< 记录文件待重写的卡号
+    QSet<QString> m_dirtyDates;             ///< 每日汇总待重写的日期
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_TRANSACTIONMANAGER_H
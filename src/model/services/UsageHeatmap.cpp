@@ -0,0 +1,130 @@
+/**
+ * @file UsageHeatmap.cpp
+ * @brief 机房使用热力图实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "UsageHeatmap.h"
+
+#include <algorithm>
+
+
+namespace CampusCard {
+
+// ========== HeatmapGrid ==========
+
+void HeatmapGrid::addDay(int dayOfWeek, const std::array<qint64, HOURS>& hours) {
+    for (int hour = 0; hour < HOURS; ++hour) {
+        m_cells[index(dayOfWeek, hour)] += hours[hour];
+    }
+}
+
+HeatmapGrid& HeatmapGrid::operator+=(const HeatmapGrid& other) {
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        m_cells[i] += other.m_cells[i];
+    }
+    return *this;
+}
+
+qint64 HeatmapGrid::totalSeconds() const {
+    qint64 total = 0;
+    for (qint64 cell : m_cells) {
+        total += cell;
+    }
+    return total;
+}
+
+qint64 HeatmapGrid::maxSeconds() const {
+    return *std::max_element(m_cells.cbegin(), m_cells.cend());
+}
+
+// ========== UsageHeatmap ==========
+
+void UsageHeatmap::clear() {
+    m_series.clear();
+}
+
+void UsageHeatmap::addSession(const QString& location, const QDateTime& start,
+                              const QDateTime& end) {
+    if (!start.isValid() || !end.isValid() || end <= start) {
+        return;
+    }
+
+    Series& series = m_series[location];
+    forEachHourSlice(start, end, [&series](const QDate& date, int hour, qint64 secs) {
+        series.days[date][hour] += secs;
+        const QDate monday = date.addDays(1 - date.dayOfWeek());
+        series.weeks[monday].add(date.dayOfWeek(), hour, secs);
+    });
+}
+
+void UsageHeatmap::addRecord(const Record& record) {
+    if (record.isOffline()) {
+        addSession(record.location(), record.startTime(), record.endTime());
+    }
+}
+
+void UsageHeatmap::accumulateDays(const Series& series, const QDate& startDate,
+                                  const QDate& endDate, HeatmapGrid& grid) {
+    if (startDate > endDate) {
+        return;
+    }
+    auto last = series.days.upperBound(endDate);
+    for (auto it = series.days.lowerBound(startDate); it != last; ++it) {
+        grid.addDay(it.key().dayOfWeek(), it.value());
+    }
+}
+
+void UsageHeatmap::accumulate(const Series& series, const QDate& startDate, const QDate& endDate,
+                              HeatmapGrid& grid) {
+    // 区间内第一个完整周的周一，以及最后一个完整周的周一
+    const QDate firstMonday =
+        startDate.dayOfWeek() == 1 ? startDate : startDate.addDays(8 - startDate.dayOfWeek());
+    const QDate endWeekMonday = endDate.addDays(1 - endDate.dayOfWeek());
+    const QDate lastMonday = endDate.dayOfWeek() == 7 ? endWeekMonday : endWeekMonday.addDays(-7);
+
+    if (firstMonday > lastMonday) {
+        // 不含完整周，逐日合并
+        accumulateDays(series, startDate, endDate, grid);
+        return;
+    }
+
+    accumulateDays(series, startDate, firstMonday.addDays(-1), grid);
+    auto last = series.weeks.upperBound(lastMonday);
+    for (auto it = series.weeks.lowerBound(firstMonday); it != last; ++it) {
+        grid += it.value();
+    }
+    accumulateDays(series, lastMonday.addDays(7), endDate, grid);
+}
+
+HeatmapGrid UsageHeatmap::query(const QString& location, const QDate& startDate,
+                                const QDate& endDate) const {
+    HeatmapGrid grid;
+    if (!startDate.isValid() || !endDate.isValid() || startDate > endDate) {
+        return grid;
+    }
+
+    if (!location.isEmpty()) {
+        auto it = m_series.constFind(location);
+        if (it != m_series.constEnd()) {
+            accumulate(it.value(), startDate, endDate, grid);
+        }
+        return grid;
+    }
+
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it) {
+        accumulate(it.value(), startDate, endDate, grid);
+    }
+    return grid;
+}
+
+QStringList UsageHeatmap::locations() const {
+    QStringList result = m_series.keys();
+    result.sort();
+    return result;
+}
+
+}  // namespace CampusCard
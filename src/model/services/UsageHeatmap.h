@@ -0,0 +1,225 @@
+/**
+ * @file UsageHeatmap.h
+ * @brief 机房使用热力图（星期 × 小时）
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 在下机时将会话时长按小时拆分累加，按地点维护每日与每周的部分直方图，
+ * 任意日期范围的热力图由整周直方图与首尾零散日期合并得到
+ */
+
+#ifndef MODEL_SERVICES_USAGEHEATMAP_H
+#define MODEL_SERVICES_USAGEHEATMAP_H
+
+#include "model/entities/Record.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+
+
+namespace CampusCard {
+
+/**
+ * @class HeatmapGrid
+ * @brief 7×24 使用时长网格（单位：秒）
+ *
+ * 行为星期（1=周一 … 7=周日，与QDate::dayOfWeek一致），列为小时（0-23）
+ */
+class HeatmapGrid {
+public:
+    static constexpr int DAYS = 7;    ///< 行数
+    static constexpr int HOURS = 24;  ///< 列数
+
+    /**
+     * @brief 获取单元格累计时长
+     * @param dayOfWeek 星期（1-7）
+     * @param hour 小时（0-23）
+     * @return 秒数
+     */
+    [[nodiscard]] qint64 seconds(int dayOfWeek, int hour) const {
+        return m_cells[index(dayOfWeek, hour)];
+    }
+
+    /**
+     * @brief 获取单元格累计时长（分钟）
+     * @param dayOfWeek 星期（1-7）
+     * @param hour 小时（0-23）
+     * @return 分钟数
+     */
+    [[nodiscard]] double minutes(int dayOfWeek, int hour) const {
+        return seconds(dayOfWeek, hour) / 60.0;
+    }
+
+    /**
+     * @brief 累加单元格时长
+     * @param dayOfWeek 星期（1-7）
+     * @param hour 小时（0-23）
+     * @param secs 秒数
+     */
+    void add(int dayOfWeek, int hour, qint64 secs) { m_cells[index(dayOfWeek, hour)] += secs; }
+
+    /**
+     * @brief 累加一整天的24小时数据
+     * @param dayOfWeek 星期（1-7）
+     * @param hours 每小时秒数
+     */
+    void addDay(int dayOfWeek, const std::array<qint64, HOURS>& hours);
+
+    /**
+     * @brief 合并另一个网格
+     */
+    HeatmapGrid& operator+=(const HeatmapGrid& other);
+
+    bool operator==(const HeatmapGrid& other) const = default;
+
+    /**
+     * @brief 所有单元格总时长（秒）
+     */
+    [[nodiscard]] qint64 totalSeconds() const;
+
+    /**
+     * @brief 单元格最大时长（秒），用于着色归一化
+     */
+    [[nodiscard]] qint64 maxSeconds() const;
+
+private:
+    static int index(int dayOfWeek, int hour) { return (dayOfWeek - 1) * HOURS + hour; }
+
+    std::array<qint64, DAYS * HOURS> m_cells{};  ///< 按行优先存储的单元格
+};
+
+/**
+ * @class UsageHeatmap
+ * @brief 增量维护的按地点使用热力图
+ *
+ * 每个地点保存两级部分直方图：
+ * - 每日24小时直方图，用于范围首尾不足一周的日期
+ * - 每周（以周一为键）7×24直方图，用于范围中间的整周
+ *
+ * 查询代价与范围内的周数和首尾零散天数成正比，与记录数无关。
+ * 跨小时、跨午夜的会话按实际所在的小时段拆分。
+ */
+class UsageHeatmap {
+public:
+    /**
+     * @brief 清空所有数据
+     */
+    void clear();
+
+    /**
+     * @brief 累加一次会话
+     * @param location 地点
+     * @param start 开始时间
+     * @param end 结束时间（不晚于开始时间时忽略）
+     */
+    void addSession(const QString& location, const QDateTime& start, const QDateTime& end);
+
+    /**
+     * @brief 累加一条已结束的记录（上机中的记录被忽略）
+     * @param record 记录
+     */
+    void addRecord(const Record& record);
+
+    /**
+     * @brief 查询日期闭区间内的热力图
+     * @param location 地点（空字符串表示所有地点）
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @return 合并后的网格
+     */
+    [[nodiscard]] HeatmapGrid query(const QString& location, const QDate& startDate,
+                                    const QDate& endDate) const;
+
+    /**
+     * @brief 获取有数据的地点列表（已排序）
+     * @return 地点列表
+     */
+    [[nodiscard]] QStringList locations() const;
+
+    /**
+     * @brief 直接从原始记录计算热力图（仅用于校验增量结果）
+     * @param records 记录序列（元素为const Record&）
+     * @param location 地点（空字符串表示所有地点）
+     * @param startDate 开始日期
+     * @param endDate 结束日期
+     * @return 网格
+     */
+    template <typename Records>
+    [[nodiscard]] static HeatmapGrid compute(const Records& records, const QString& location,
+                                             const QDate& startDate, const QDate& endDate) {
+        HeatmapGrid grid;
+        for (const Record& record : records) {
+            if (!record.isOffline() || (!location.isEmpty() && record.location() != location)) {
+                continue;
+            }
+            forEachHourSlice(record.startTime(), record.endTime(),
+                             [&](const QDate& date, int hour, qint64 secs) {
+                                 if (date >= startDate && date <= endDate) {
+                                     grid.add(date.dayOfWeek(), hour, secs);
+                                 }
+                             });
+        }
+        return grid;
+    }
+
+private:
+    using DayHours = std::array<qint64, HeatmapGrid::HOURS>;
+
+    /**
+     * @struct Series
+     * @brief 单个地点的部分直方图
+     */
+    struct Series {
+        QMap<QDate, DayHours> days;      ///< 每日直方图
+        QMap<QDate, HeatmapGrid> weeks;  ///< 每周直方图（键为周一）
+    };
+
+    /**
+     * @brief 将[start, end)按整点拆分并逐段回调
+     *
+     * 下一个整点由游标向后推算，而不是由日期和小时重新构造：夏令时结束当天重复的
+     * 那个小时会被访问两次，夏令时开始当天跳过的小时不会出现
+     * @param visit 回调(date, hour, secs)
+     */
+    template <typename Visitor>
+    static void forEachHourSlice(const QDateTime& start, const QDateTime& end, Visitor&& visit) {
+        if (!start.isValid() || !end.isValid()) {
+            return;
+        }
+        QDateTime cursor = start;
+        while (cursor < end) {
+            const QTime time = cursor.time();
+            QDateTime sliceEnd = cursor.addSecs(3600 - time.minute() * 60 - time.second());
+            if (sliceEnd > end) {
+                sliceEnd = end;
+            }
+            visit(cursor.date(), time.hour(), cursor.secsTo(sliceEnd));
+            cursor = sliceEnd;
+        }
+    }
+
+    /**
+     * @brief 合并单个地点在日期区间内的数据
+     */
+    static void accumulate(const Series& series, const QDate& startDate, const QDate& endDate,
+                           HeatmapGrid& grid);
+
+    /**
+     * @brief 合并单个地点在日期区间内的每日数据
+     */
+    static void accumulateDays(const Series& series, const QDate& startDate, const QDate& endDate,
+                               HeatmapGrid& grid);
+
+    QHash<QString, Series> m_series;  ///< 地点到部分直方图的映射
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_USAGEHEATMAP_H
@@ -0,0 +1,93 @@
+/**
+ * @file UsageRanking.cpp
+ * @brief 上机时长与消费排行实现
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务实现
+ */
+
+#include "UsageRanking.h"
+
+
+namespace CampusCard {
+
+// ========== 排行表 ==========
+
+void UsageRanking::Table::add(const QString& cardId, int minutes, Money cost, int sessions) {
+    RecordGroup& total = totals[cardId];
+    if (total.count > 0) {
+        // 先移除旧位置，再以新累计值插入
+        byMinutes.erase(RankKey{total.totalDuration, cardId});
+        bySpend.erase(RankKey{total.totalCost.cents(), cardId});
+    }
+
+    total.key = cardId;
+    total.count += sessions;
+    total.totalDuration += minutes;
+    total.totalCost += cost;
+
+    byMinutes.insert(RankKey{total.totalDuration, cardId});
+    bySpend.insert(RankKey{total.totalCost.cents(), cardId});
+}
+
+QList<RecordGroup> UsageRanking::Table::top(RankMetric metric, int k) const {
+    const std::set<RankKey>& ordered = (metric == RankMetric::Minutes) ? byMinutes : bySpend;
+
+    QList<RecordGroup> result;
+    result.reserve(qMin<qsizetype>(qMax(0, k), static_cast<qsizetype>(ordered.size())));
+    for (auto it = ordered.cbegin(); it != ordered.cend() && result.size() < k; ++it) {
+        result.append(totals.value(it->cardId));
+    }
+    return result;
+}
+
+// ========== UsageRanking ==========
+
+void UsageRanking::clear() {
+    m_allTime = Table();
+    m_weeks.clear();
+}
+
+void UsageRanking::addSession(const QString& cardId, const QDate& date, int minutes,
+                              Money cost) {
+    m_allTime.add(cardId, minutes, cost);
+    if (date.isValid()) {
+        m_weeks[date.addDays(1 - date.dayOfWeek())].add(cardId, minutes, cost);
+    }
+}
+
+void UsageRanking::addRecord(const Record& record) {
+    if (record.isOffline()) {
+        addSession(record.cardId(), record.startTime().date(), record.durationMinutes(),
+                   record.cost());
+    }
+}
+
+void UsageRanking::adjustCost(const Record& record, Money delta) {
+    if (!record.isOffline() || delta.isZero()) {
+        return;
+    }
+    const QDate date = record.startTime().date();
+    m_allTime.add(record.cardId(), 0, delta, 0);
+    if (date.isValid()) {
+        m_weeks[date.addDays(1 - date.dayOfWeek())].add(record.cardId(), 0, delta, 0);
+    }
+}
+
+QList<RecordGroup> UsageRanking::top(RankMetric metric, int k) const {
+    return m_allTime.top(metric, k);
+}
+
+QList<RecordGroup> UsageRanking::topForWeek(RankMetric metric, const QDate& date, int k) const {
+    if (!date.isValid()) {
+        return QList<RecordGroup>();
+    }
+    auto it = m_weeks.constFind(date.addDays(1 - date.dayOfWeek()));
+    if (it == m_weeks.constEnd()) {
+        return QList<RecordGroup>();
+    }
+    return it.value().top(metric, k);
+}
+
+}  // namespace CampusCard
@@ -0,0 +1,144 @@
+/**
+ * @file UsageRanking.h
+ * @brief 上机时长与消费排行
+ * @author CampusCardSystem
+ * @date 2024
+ *
+ * MVC架构 - Model层业务服务
+ * 在下机时增量更新每张卡的累计值，并用有序集合维护排行，
+ * 查询前K名无需遍历全部卡
+ */
+
+#ifndef MODEL_SERVICES_USAGERANKING_H
+#define MODEL_SERVICES_USAGERANKING_H
+
+#include "model/entities/Record.h"
+#include "model/services/RecordQuery.h"
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include <set>
+
+
+namespace CampusCard {
+
+/**
+ * @brief 排行指标
+ */
+enum class RankMetric {
+    Minutes,  ///< 上机时长
+    Spend     ///< 消费金额
+};
+
+/**
+ * @brief 排行周期
+ */
+enum class RankPeriod {
+    AllTime,  ///< 全部时间
+    ThisWeek  ///< 本周（周一至周日）
+};
+
+/**
+ * @class UsageRanking
+ * @brief 增量维护的卡排行
+ *
+ * 全部时间与每一周各维护一份排行表。每份排行表包含：
+ * - 卡号到累计值的哈希表
+ * - 按时长、按消费排序的两个有序集合（降序，值相同时按卡号升序）
+ *
+ * 每次下机更新为 O(log n)，查询前K名为 O(K)。
+ * 会话按开始日期所在的周计入周排行。
+ */
+class UsageRanking {
+public:
+    /**
+     * @brief 清空所有数据
+     */
+    void clear();
+
+    /**
+     * @brief 累加一次已结束的会话
+     * @param cardId 卡号
+     * @param date 会话日期
+     * @param minutes 时长（分钟）
+     * @param cost 费用
+     */
+    void addSession(const QString& cardId, const QDate& date, int minutes, Money cost);
+
+    /**
+     * @brief 累加一条已结束的记录（上机中的记录被忽略）
+     * @param record 记录
+     */
+    void addRecord(const Record& record);
+
+    /**
+     * @brief 调整一条已计入的记录的费用（次数和时长不变）
+     * @param record 记录
+     * @param delta 费用变化量
+     */
+    void adjustCost(const Record& record, Money delta);
+
+    /**
+     * @brief 获取全部时间的前K名
+     * @param metric 排行指标
+     * @param k 数量
+     * @return 排行（key为卡号）
+     */
+    [[nodiscard]] QList<RecordGroup> top(RankMetric metric, int k) const;
+
+    /**
+     * @brief 获取指定日期所在周的前K名
+     * @param metric 排行指标
+     * @param date 周内任意日期
+     * @param k 数量
+     * @return 排行（key为卡号）
+     */
+    [[nodiscard]] QList<RecordGroup> topForWeek(RankMetric metric, const QDate& date, int k) const;
+
+    /**
+     * @brief 获取参与全部时间排行的卡数
+     * @return 卡数
+     */
+    [[nodiscard]] qsizetype cardCount() const { return m_allTime.totals.size(); }
+
+private:
+    /**
+     * @struct RankKey
+     * @brief 有序集合的键（值降序，卡号升序；值为分钟数或分）
+     */
+    struct RankKey {
+        qint64 value = 0;
+        QString cardId;
+
+        bool operator<(const RankKey& other) const {
+            if (value != other.value) {
+                return value > other.value;
+            }
+            return cardId < other.cardId;
+        }
+    };
+
+    /**
+     * @struct Table
+     * @brief 单个周期的排行表
+     */
+    struct Table {
+        QHash<QString, RecordGroup> totals;  ///< 卡号到累计值
+        std::set<RankKey> byMinutes;         ///< 按时长排序
+        std::set<RankKey> bySpend;           ///< 按消费排序
+
+        void add(const QString& cardId, int minutes, Money cost, int sessions = 1);
+        [[nodiscard]] QList<RecordGroup> top(RankMetric metric, int k) const;
+    };
+
+    Table m_allTime;               ///< 全部时间排行
+    QMap<QDate, Table> m_weeks;    ///< 每周排行（键为周一）
+};
+
+}  // namespace CampusCard
+
+#endif  // MODEL_SERVICES_USAGERANKING_H
@@ -58,7 +58,7 @@ void RechargeDialog::initUI() {
 
         // 当前余额
         m_balanceLabel =
-            new ElaText(QStringLiteral("当前余额：") + QString::number(card.balance(), 'f', 2) +
+            new ElaText(QStringLiteral("当前余额：") + card.balance().toString() +
                             QStringLiteral(" 元"),
                         centralWidget);
         layout->addWidget(m_balanceLabel);
@@ -107,9 +107,9 @@ void RechargeDialog::onRechargeClicked() {
     }
 
     bool ok;
-    double amount = amountStr.toDouble(&ok);
+    Money amount = Money::fromString(amountStr, &ok);  // 最多两位小数
 
-    if (!ok || amount <= 0) {
+    if (!ok || !amount.isPositive()) {
         ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
                                QStringLiteral("请输入有效的金额"), 2000, this);
         return;
@@ -119,13 +119,13 @@ void RechargeDialog::onRechargeClicked() {
     m_cardController->handleRecharge(m_cardId, amount);
 }
 
-void RechargeDialog::onRechargeSuccess(const QString& cardId, double newBalance) {
+void RechargeDialog::onRechargeSuccess(const QString& cardId, Money newBalance) {
     if (cardId != m_cardId) {
         return;  // 不是当前卡的充值结果
     }
 
     // 更新余额显示
-    m_balanceLabel->setText(QStringLiteral("当前余额：") + QString::number(newBalance, 'f', 2) +
+    m_balanceLabel->setText(QStringLiteral("当前余额：") + newBalance.toString() +
                             QStringLiteral(" 元"));
 
     ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
@@ -59,7 +59,7 @@ private slots:
      * @param cardId 卡号
      * @param newBalance 新余额
      */
-    void onRechargeSuccess(const QString& cardId, double newBalance);
+    void onRechargeSuccess(const QString& cardId, Money newBalance);
 
     /**
      * @brief 处理充值失败
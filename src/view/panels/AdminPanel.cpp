@@ -9,6 +9,7 @@
 
 #include "AdminPanel.h"
 
+#include "ElaComboBox.h"
 #include "ElaLineEdit.h"
 #include "ElaMessageBar.h"
 #include "ElaPushButton.h"
@@ -28,12 +29,36 @@
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QSpinBox>
 #include <QStandardItemModel>
 #include <QVBoxLayout>
 
 
 namespace CampusCard {
 
+namespace {
+
+/**
+ * @brief 批量操作的名称（用于提示）
+ */
+QString bulkActionName(CardBulkAction action) {
+    switch (action) {
+    case CardBulkAction::ReportLost:
+        return QStringLiteral("挂失");
+    case CardBulkAction::CancelLost:
+        return QStringLiteral("解挂");
+    case CardBulkAction::Freeze:
+        return QStringLiteral("冻结");
+    case CardBulkAction::Unfreeze:
+        return QStringLiteral("解冻");
+    case CardBulkAction::ResetPassword:
+        return QStringLiteral("重置密码");
+    }
+    return QString();
+}
+
+}  // namespace
+
 AdminPanel::AdminPanel(MainController* mainController, QWidget* parent)
     : QWidget(parent), m_mainController(mainController),
       m_cardController(mainController->cardController()),
@@ -91,10 +116,15 @@ void AdminPanel::initUI() {
                                             QStringLiteral("状态"), QStringLiteral("累计充值")});
     m_cardTable->setModel(m_cardModel);
     m_cardTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_cardTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    // 可按Ctrl/Shift多选，挂失、冻结等操作对所有选中的卡一次执行
+    m_cardTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_cardTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_cardTable->horizontalHeader()->setStretchLastSection(true);
     m_cardTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // 点击表头排序，由服务层缓存的排序结果完成，不使用视图自带的逐项比较排序
+    m_cardTable->horizontalHeader()->setSectionsClickable(true);
+    m_cardTable->horizontalHeader()->setSortIndicatorShown(true);
+    m_cardTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
     cardLayout->addWidget(m_cardTable, 1);
 
     // 卡操作按钮
@@ -102,16 +132,20 @@ void AdminPanel::initUI() {
     m_rechargeBtn = new ElaPushButton(QStringLiteral("💰 充值"), cardGroup);
     m_reportLostBtn = new ElaPushButton(QStringLiteral("🔒 挂失"), cardGroup);
     m_cancelLostBtn = new ElaPushButton(QStringLiteral("🔓 解挂"), cardGroup);
+    m_freezeBtn = new ElaPushButton(QStringLiteral("🧊 冻结"), cardGroup);
     m_unfreezeBtn = new ElaPushButton(QStringLiteral("❄️ 解冻"), cardGroup);
     m_resetPasswordBtn = new ElaPushButton(QStringLiteral("🔑 重置密码"), cardGroup);
     m_addCardBtn = new ElaPushButton(QStringLiteral("➕ 添加卡"), cardGroup);
+    m_bulkActionBtn = new ElaPushButton(QStringLiteral("🗂️ 按条件批量操作"), cardGroup);
 
     cardBtnLayout->addWidget(m_rechargeBtn);
     cardBtnLayout->addWidget(m_reportLostBtn);
     cardBtnLayout->addWidget(m_cancelLostBtn);
+    cardBtnLayout->addWidget(m_freezeBtn);
     cardBtnLayout->addWidget(m_unfreezeBtn);
     cardBtnLayout->addWidget(m_resetPasswordBtn);
     cardBtnLayout->addWidget(m_addCardBtn);
+    cardBtnLayout->addWidget(m_bulkActionBtn);
     cardBtnLayout->addStretch();
     cardLayout->addLayout(cardBtnLayout);
 
@@ -124,12 +158,14 @@ void AdminPanel::initUI() {
     m_statisticsBtn = new ElaPushButton(QStringLiteral("📈 统计报表"), sysGroup);
     m_exportBtn = new ElaPushButton(QStringLiteral("📤 导出数据"), sysGroup);
     m_importBtn = new ElaPushButton(QStringLiteral("📥 导入数据"), sysGroup);
+    m_batchRechargeBtn = new ElaPushButton(QStringLiteral("💳 批量充值"), sysGroup);
     m_mockDataBtn = new ElaPushButton(QStringLiteral("🎲 生成测试数据"), sysGroup);
     m_changeAdminPwdBtn = new ElaPushButton(QStringLiteral("🔐 修改管理员密码"), sysGroup);
 
     sysLayout->addWidget(m_statisticsBtn);
     sysLayout->addWidget(m_exportBtn);
     sysLayout->addWidget(m_importBtn);
+    sysLayout->addWidget(m_batchRechargeBtn);
     sysLayout->addWidget(m_mockDataBtn);
     sysLayout->addWidget(m_changeAdminPwdBtn);
     sysLayout->addStretch();
@@ -154,14 +190,18 @@ void AdminPanel::initConnections() {
     connect(m_rechargeBtn, &ElaPushButton::clicked, this, &AdminPanel::onRechargeClicked);
     connect(m_reportLostBtn, &ElaPushButton::clicked, this, &AdminPanel::onReportLostClicked);
     connect(m_cancelLostBtn, &ElaPushButton::clicked, this, &AdminPanel::onCancelLostClicked);
+    connect(m_freezeBtn, &ElaPushButton::clicked, this, &AdminPanel::onFreezeClicked);
     connect(m_unfreezeBtn, &ElaPushButton::clicked, this, &AdminPanel::onUnfreezeClicked);
     connect(m_resetPasswordBtn, &ElaPushButton::clicked, this, &AdminPanel::onResetPasswordClicked);
     connect(m_addCardBtn, &ElaPushButton::clicked, this, &AdminPanel::onAddCardClicked);
+    connect(m_bulkActionBtn, &ElaPushButton::clicked, this, &AdminPanel::onBulkActionClicked);
 
     // 系统操作按钮
     connect(m_statisticsBtn, &ElaPushButton::clicked, this, &AdminPanel::onStatisticsClicked);
     connect(m_exportBtn, &ElaPushButton::clicked, this, &AdminPanel::onExportClicked);
     connect(m_importBtn, &ElaPushButton::clicked, this, &AdminPanel::onImportClicked);
+    connect(m_batchRechargeBtn, &ElaPushButton::clicked, this,
+            &AdminPanel::onBatchRechargeClicked);
     connect(m_mockDataBtn, &ElaPushButton::clicked, this, &AdminPanel::onGenerateMockDataClicked);
     connect(m_changeAdminPwdBtn, &ElaPushButton::clicked, this,
             &AdminPanel::onChangeAdminPasswordClicked);
@@ -172,6 +212,14 @@ void AdminPanel::initConnections() {
     // 搜索
     connect(m_searchEdit, &ElaLineEdit::textChanged, this, &AdminPanel::onSearchTextChanged);
 
+    // 表头排序
+    connect(m_cardTable->horizontalHeader(), &QHeaderView::sortIndicatorChanged, this,
+            [this](int column, Qt::SortOrder order) {
+                m_sortColumn = column;
+                m_sortOrder = order;
+                refreshCardList();
+            });
+
     // 表格选择变化
     connect(m_cardTable->selectionModel(), &QItemSelectionModel::selectionChanged, this,
             &AdminPanel::updateButtonStates);
@@ -191,6 +239,11 @@ void AdminPanel::initConnections() {
                 ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
                                        QStringLiteral("卡 %1 解挂成功").arg(cardId), 2000, this);
             });
+    connect(m_cardController, &CardController::freezeSuccess, this,
+            [this](const QString& cardId) {
+                ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
+                                       QStringLiteral("卡 %1 冻结成功").arg(cardId), 2000, this);
+            });
     connect(m_cardController, &CardController::unfreezeSuccess, this,
             [this](const QString& cardId) {
                 ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
@@ -200,6 +253,28 @@ void AdminPanel::initConnections() {
         ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
                                QStringLiteral("卡 %1 密码重置成功").arg(cardId), 2000, this);
     });
+    connect(m_cardController, &CardController::bulkActionFinished, this,
+            [this](CardBulkAction action, const QStringList& cardIds, bool saved) {
+                if (cardIds.isEmpty()) {
+                    ElaMessageBar::warning(
+                        ElaMessageBarType::TopRight, QStringLiteral("提示"),
+                        QStringLiteral("没有需要%1的卡").arg(bulkActionName(action)), 2000, this);
+                    return;
+                }
+                if (!saved) {
+                    ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("保存失败"),
+                                           QStringLiteral("已%1 %2 张卡，但写入数据文件失败")
+                                               .arg(bulkActionName(action))
+                                               .arg(cardIds.size()),
+                                           3000, this);
+                    return;
+                }
+                ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
+                                       QStringLiteral("已%1 %2 张卡")
+                                           .arg(bulkActionName(action))
+                                           .arg(cardIds.size()),
+                                       2000, this);
+            });
     connect(m_cardController, &CardController::operationFailed, this,
             [this](const QString& message) {
                 ElaMessageBar::error(ElaMessageBarType::TopRight, QStringLiteral("失败"), message,
@@ -241,7 +316,12 @@ void AdminPanel::refresh() {
 
 void AdminPanel::refreshCardList() {
     QString keyword = m_searchEdit->text().trimmed();
-    QList<Card> cards = m_cardController->searchCards(keyword);
+    // 列的顺序与CardSortField一致
+    QList<Card> cards =
+        m_sortColumn < 0
+            ? m_cardController->searchCards(keyword)
+            : m_cardController->searchCards(keyword, static_cast<CardSortField>(m_sortColumn),
+                                            m_sortOrder == Qt::DescendingOrder);
 
     m_cardModel->removeRows(0, m_cardModel->rowCount());
 
@@ -250,9 +330,9 @@ void AdminPanel::refreshCardList() {
         row << new QStandardItem(card.cardId());
         row << new QStandardItem(card.name());
         row << new QStandardItem(card.studentId());
-        row << new QStandardItem(QString::number(card.balance(), 'f', 2));
+        row << new QStandardItem(card.balance().toString());
         row << new QStandardItem(cardStateToString(card.state()));
-        row << new QStandardItem(QString::number(card.totalRecharge(), 'f', 2));
+        row << new QStandardItem(card.totalRecharge().toString());
 
         // 根据状态设置颜色（适配明暗主题）
         if (card.state() == CardState::Lost) {
@@ -280,12 +360,12 @@ void AdminPanel::refreshCardList() {
 void AdminPanel::refreshStatistics() {
     int totalCards = m_cardController->getCardCount();
     QString today = QDate::currentDate().toString(QStringLiteral("yyyy-MM-dd"));
-    double todayIncome = m_recordController->getDailyIncome(today);
+    Money todayIncome = m_recordController->getDailyIncome(today);
     int onlineCount = m_recordController->getOnlineCount();
 
     m_totalCardsLabel->setText(QStringLiteral("卡总数：%1").arg(totalCards));
     m_todayIncomeLabel->setText(
-        QStringLiteral("今日收入：%1 元").arg(QString::number(todayIncome, 'f', 2)));
+        QStringLiteral("今日收入：%1 元").arg(todayIncome.toString()));
     m_onlineCountLabel->setText(QStringLiteral("当前在线：%1").arg(onlineCount));
 }
 
@@ -297,23 +377,43 @@ QString AdminPanel::getSelectedCardId() const {
     return m_cardModel->item(selection.first().row(), 0)->text();
 }
 
-void AdminPanel::updateButtonStates() {
-    QString cardId = getSelectedCardId();
-    bool hasSelection = !cardId.isEmpty();
+QStringList AdminPanel::getSelectedCardIds() const {
+    QStringList cardIds;
+    for (const auto& index : m_cardTable->selectionModel()->selectedRows()) {
+        cardIds.append(m_cardModel->item(index.row(), 0)->text());
+    }
+    return cardIds;
+}
 
-    m_rechargeBtn->setEnabled(hasSelection);
-    m_resetPasswordBtn->setEnabled(hasSelection);
+QStringList AdminPanel::selectedCardIdsOrWarn() {
+    QStringList cardIds = getSelectedCardIds();
+    if (cardIds.isEmpty()) {
+        ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
+                               QStringLiteral("请先选择一张卡"), 2000, this);
+    }
+    return cardIds;
+}
 
-    if (hasSelection) {
-        Card card = m_cardController->getCard(cardId);
-        m_reportLostBtn->setEnabled(card.state() == CardState::Normal);
-        m_cancelLostBtn->setEnabled(card.state() == CardState::Lost);
-        m_unfreezeBtn->setEnabled(card.state() == CardState::Frozen);
-    } else {
-        m_reportLostBtn->setEnabled(false);
-        m_cancelLostBtn->setEnabled(false);
-        m_unfreezeBtn->setEnabled(false);
+void AdminPanel::updateButtonStates() {
+    const QStringList cardIds = getSelectedCardIds();
+
+    // 充值只针对单张卡，其余操作对选中的卡中适用的那些执行
+    m_rechargeBtn->setEnabled(cardIds.size() == 1);
+    m_resetPasswordBtn->setEnabled(!cardIds.isEmpty());
+
+    bool anyNormal = false;
+    bool anyLost = false;
+    bool anyFrozen = false;
+    for (const auto& cardId : cardIds) {
+        CardState state = m_cardController->getCard(cardId).state();
+        anyNormal = anyNormal || state == CardState::Normal;
+        anyLost = anyLost || state == CardState::Lost;
+        anyFrozen = anyFrozen || state == CardState::Frozen;
     }
+    m_reportLostBtn->setEnabled(anyNormal);
+    m_cancelLostBtn->setEnabled(anyLost);
+    m_freezeBtn->setEnabled(anyNormal || anyLost);
+    m_unfreezeBtn->setEnabled(anyFrozen);
 }
 
 void AdminPanel::onCardsUpdated() {
@@ -345,53 +445,62 @@ void AdminPanel::onRechargeClicked() {
 }
 
 void AdminPanel::onReportLostClicked() {
-    QString cardId = getSelectedCardId();
-    if (cardId.isEmpty()) {
-        ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
-                               QStringLiteral("请先选择一张卡"), 2000, this);
-        return;
+    const QStringList cardIds = selectedCardIdsOrWarn();
+    if (cardIds.size() == 1) {
+        m_cardController->handleReportLost(cardIds.first());
+    } else if (cardIds.size() > 1) {
+        m_cardController->handleBulkAction(CardBulkAction::ReportLost, cardIds);
     }
-
-    m_cardController->handleReportLost(cardId);
 }
 
 void AdminPanel::onCancelLostClicked() {
-    QString cardId = getSelectedCardId();
-    if (cardId.isEmpty()) {
-        ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
-                               QStringLiteral("请先选择一张卡"), 2000, this);
-        return;
+    const QStringList cardIds = selectedCardIdsOrWarn();
+    if (cardIds.size() == 1) {
+        m_cardController->handleCancelLost(cardIds.first());
+    } else if (cardIds.size() > 1) {
+        m_cardController->handleBulkAction(CardBulkAction::CancelLost, cardIds);
     }
+}
 
-    m_cardController->handleCancelLost(cardId);
+void AdminPanel::onFreezeClicked() {
+    const QStringList cardIds = selectedCardIdsOrWarn();
+    if (cardIds.size() == 1) {
+        m_cardController->handleFreeze(cardIds.first());
+    } else if (cardIds.size() > 1) {
+        m_cardController->handleBulkAction(CardBulkAction::Freeze, cardIds);
+    }
 }
 
 void AdminPanel::onUnfreezeClicked() {
-    QString cardId = getSelectedCardId();
-    if (cardId.isEmpty()) {
-        ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
-                               QStringLiteral("请先选择一张卡"), 2000, this);
-        return;
+    const QStringList cardIds = selectedCardIdsOrWarn();
+    if (cardIds.size() == 1) {
+        m_cardController->handleUnfreeze(cardIds.first());
+    } else if (cardIds.size() > 1) {
+        m_cardController->handleBulkAction(CardBulkAction::Unfreeze, cardIds);
     }
-
-    m_cardController->handleUnfreeze(cardId);
 }
 
 void AdminPanel::onResetPasswordClicked() {
-    QString cardId = getSelectedCardId();
-    if (cardId.isEmpty()) {
-        ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
-                               QStringLiteral("请先选择一张卡"), 2000, this);
+    const QStringList cardIds = selectedCardIdsOrWarn();
+    if (cardIds.isEmpty()) {
         return;
     }
 
     bool ok;
-    QString newPassword = QInputDialog::getText(this, QStringLiteral("重置密码"),
-                                                QStringLiteral("请输入新密码（至少4位）："),
+    QString prompt = cardIds.size() == 1
+                         ? QStringLiteral("请输入新密码（至少4位）：")
+                         : QStringLiteral("为选中的 %1 张卡设置新密码（至少4位）：")
+                               .arg(cardIds.size());
+    QString newPassword = QInputDialog::getText(this, QStringLiteral("重置密码"), prompt,
                                                 QLineEdit::Password, QString(), &ok);
 
     if (ok && !newPassword.isEmpty()) {
-        m_cardController->handleResetPassword(cardId, newPassword);
+        if (cardIds.size() == 1) {
+            m_cardController->handleResetPassword(cardIds.first(), newPassword);
+        } else {
+            m_cardController->handleBulkAction(CardBulkAction::ResetPassword, cardIds,
+                                               newPassword);
+        }
     }
 }
 
@@ -400,6 +509,102 @@ void AdminPanel::onAddCardClicked() {
     dialog.exec();
 }
 
+void AdminPanel::onBulkActionClicked() {
+    QDialog dialog(this);
+    dialog.setWindowTitle(QStringLiteral("按条件批量操作"));
+    dialog.setMinimumWidth(420);
+
+    QGridLayout* layout = new QGridLayout(&dialog);
+    auto* prefixEdit = new ElaLineEdit(&dialog);
+    prefixEdit->setPlaceholderText(QStringLiteral("班级号（学号前缀），如 B2301"));
+    auto* stateCombo = new ElaComboBox(&dialog);
+    stateCombo->addItem(QStringLiteral("不限"));
+    // 其余各项的顺序与CardState一致
+    stateCombo->addItem(cardStateToString(CardState::Normal));
+    stateCombo->addItem(cardStateToString(CardState::Lost));
+    stateCombo->addItem(cardStateToString(CardState::Frozen));
+    auto* daysSpin = new QSpinBox(&dialog);
+    daysSpin->setRange(0, 3650);
+    daysSpin->setSuffix(QStringLiteral(" 天"));
+    daysSpin->setSpecialValueText(QStringLiteral("不限"));
+    auto* actionCombo = new ElaComboBox(&dialog);
+    // 顺序与CardBulkAction一致
+    for (auto action : {CardBulkAction::ReportLost, CardBulkAction::CancelLost,
+                        CardBulkAction::Freeze, CardBulkAction::Unfreeze,
+                        CardBulkAction::ResetPassword}) {
+        actionCombo->addItem(bulkActionName(action));
+    }
+    auto* matchText = new ElaText(&dialog);
+    matchText->setTextPixelSize(14);
+    auto* confirmBtn = new ElaPushButton(QStringLiteral("执行"), &dialog);
+    auto* cancelBtn = new ElaPushButton(QStringLiteral("取消"), &dialog);
+
+    layout->addWidget(new ElaText(QStringLiteral("班级："), &dialog), 0, 0);
+    layout->addWidget(prefixEdit, 0, 1);
+    layout->addWidget(new ElaText(QStringLiteral("卡状态："), &dialog), 1, 0);
+    layout->addWidget(stateCombo, 1, 1);
+    layout->addWidget(new ElaText(QStringLiteral("处于该状态至少："), &dialog), 2, 0);
+    layout->addWidget(daysSpin, 2, 1);
+    layout->addWidget(new ElaText(QStringLiteral("操作："), &dialog), 3, 0);
+    layout->addWidget(actionCombo, 3, 1);
+    layout->addWidget(matchText, 4, 0, 1, 2);
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    btnLayout->addWidget(confirmBtn);
+    btnLayout->addWidget(cancelBtn);
+    layout->addLayout(btnLayout, 5, 0, 1, 2);
+
+    auto buildQuery = [&]() {
+        CardQuery query;
+        query.studentIdPrefix(prefixEdit->text());
+        if (stateCombo->currentIndex() > 0) {
+            query.state(static_cast<CardState>(stateCombo->currentIndex() - 1));
+        }
+        query.inStateForDays(daysSpin->value());
+        return query;
+    };
+    // 条件变化时预览匹配的卡数
+    auto updateMatches = [&]() {
+        matchText->setText(QStringLiteral("匹配 %1 张卡")
+                               .arg(m_cardController->findCardIds(buildQuery()).size()));
+    };
+    connect(prefixEdit, &ElaLineEdit::textChanged, &dialog, updateMatches);
+    connect(stateCombo, QOverload<int>::of(&ElaComboBox::currentIndexChanged), &dialog,
+            updateMatches);
+    connect(daysSpin, QOverload<int>::of(&QSpinBox::valueChanged), &dialog, updateMatches);
+    connect(confirmBtn, &ElaPushButton::clicked, &dialog, &QDialog::accept);
+    connect(cancelBtn, &ElaPushButton::clicked, &dialog, &QDialog::reject);
+    updateMatches();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    const CardQuery query = buildQuery();
+    const auto action = static_cast<CardBulkAction>(actionCombo->currentIndex());
+    const qsizetype count = m_cardController->findCardIds(query).size();
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, QStringLiteral("确认批量操作"),
+        QStringLiteral("将对匹配的 %1 张卡执行「%2」，确认？")
+            .arg(count)
+            .arg(bulkActionName(action)));
+    if (reply != QMessageBox::Yes) {
+        return;
+    }
+
+    QString newPassword;
+    if (action == CardBulkAction::ResetPassword) {
+        bool ok;
+        newPassword = QInputDialog::getText(this, QStringLiteral("重置密码"),
+                                            QStringLiteral("请输入新密码（至少4位）："),
+                                            QLineEdit::Password, QString(), &ok);
+        if (!ok || newPassword.isEmpty()) {
+            return;
+        }
+    }
+    m_cardController->handleBulkAction(action, query, newPassword);
+}
+
 // ========== 系统操作槽实现 ==========
 
 void AdminPanel::onStatisticsClicked() {
@@ -441,6 +646,57 @@ void AdminPanel::onImportClicked() {
     }
 }
 
+void AdminPanel::onBatchRechargeClicked() {
+    QString filePath =
+        QFileDialog::getOpenFileName(this, QStringLiteral("批量充值"), QString(),
+                                     QStringLiteral("CSV Files (*.csv *.txt)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    // 先只校验，有错误时列出前若干行，整个文件都不充值
+    RechargeBatchReport check = m_cardController->handleBatchRecharge(filePath, true);
+    if (!check.isClean()) {
+        constexpr int MAX_SHOWN = 20;
+        QString details = check.summary() + QStringLiteral("\n");
+        for (int i = 0; i < check.errors.size() && i < MAX_SHOWN; ++i) {
+            const RechargeRowError& error = check.errors.at(i);
+            details += QStringLiteral("\n第 %1 行 %2：%3")
+                           .arg(error.line)
+                           .arg(error.cardId, error.message);
+        }
+        if (check.errors.size() > MAX_SHOWN) {
+            details += QStringLiteral("\n……");
+        }
+        QMessageBox::warning(this, QStringLiteral("充值文件有误"), details);
+        return;
+    }
+    if (check.validRows == 0) {
+        ElaMessageBar::warning(ElaMessageBarType::TopRight, QStringLiteral("提示"),
+                               QStringLiteral("文件中没有充值记录"), 2000, this);
+        return;
+    }
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, QStringLiteral("确认批量充值"),
+        QStringLiteral("共 %1 笔充值，合计 %2 元，确认充值？")
+            .arg(check.validRows)
+            .arg(check.total.toString()));
+    if (reply != QMessageBox::Yes) {
+        return;
+    }
+
+    // 卡列表由cardsChanged统一刷新一次
+    RechargeBatchReport report = m_cardController->handleBatchRecharge(filePath);
+    if (report.isClean() && report.saved) {
+        ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
+                               report.summary(), 3000, this);
+    } else {
+        ElaMessageBar::error(ElaMessageBarType::TopRight, QStringLiteral("失败"),
+                             report.summary(), 3000, this);
+    }
+}
+
 void AdminPanel::onGenerateMockDataClicked() {
     bool ok;
     int count = QInputDialog::getInt(this, QStringLiteral("生成测试数据"),
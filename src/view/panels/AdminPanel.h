@@ -33,8 +33,8 @@ namespace CampusCard {
  *
  * 作为View层，负责：
  * - 显示卡列表和状态
- * - 提供充值、挂失/解挂、冻结/解冻、重置密码等操作
- * - 提供数据导入导出、模拟数据生成、管理员密码修改等系统操作
+ * - 提供充值、挂失/解挂、冻结/解冻、重置密码等操作（可多选，或按班级、状态等条件批量执行）
+ * - 提供数据导入导出、批量充值、模拟数据生成、管理员密码修改等系统操作
  * - 显示统计信息
  */
 class AdminPanel : public QWidget {
@@ -69,14 +69,17 @@ private slots:
     void onRechargeClicked();
     void onReportLostClicked();
     void onCancelLostClicked();
+    void onFreezeClicked();
     void onUnfreezeClicked();
     void onResetPasswordClicked();
     void onAddCardClicked();
+    void onBulkActionClicked();
 
     // ========== 系统操作槽 ==========
     void onStatisticsClicked();
     void onExportClicked();
     void onImportClicked();
+    void onBatchRechargeClicked();
     void onGenerateMockDataClicked();
     void onChangeAdminPasswordClicked();
 
@@ -114,6 +117,18 @@ private:
      */
     QString getSelectedCardId() const;
 
+    /**
+     * @brief 获取所有选中的卡号
+     * @return 卡号列表（按表格行顺序）
+     */
+    QStringList getSelectedCardIds() const;
+
+    /**
+     * @brief 获取选中的卡号，未选中时提示
+     * @return 卡号列表
+     */
+    QStringList selectedCardIdsOrWarn();
+
     /**
      * @brief 更新按钮状态
      */
@@ -130,18 +145,25 @@ private:
     QStandardItemModel* m_cardModel; ///< 卡表格数据模型
     ElaLineEdit* m_searchEdit;       ///< 搜索输入框
 
+    // 表头排序状态
+    int m_sortColumn = -1;                           ///< 排序列（-1表示按搜索相关度）
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;  ///< 排序方向
+
     // 卡操作按钮
     ElaPushButton* m_rechargeBtn;
     ElaPushButton* m_reportLostBtn;
     ElaPushButton* m_cancelLostBtn;
+    ElaPushButton* m_freezeBtn;
     ElaPushButton* m_unfreezeBtn;
     ElaPushButton* m_resetPasswordBtn;
     ElaPushButton* m_addCardBtn;
+    ElaPushButton* m_bulkActionBtn;
 
     // 系统操作按钮
     ElaPushButton* m_statisticsBtn;
     ElaPushButton* m_exportBtn;
     ElaPushButton* m_importBtn;
+    ElaPushButton* m_batchRechargeBtn;
     ElaPushButton* m_mockDataBtn;
     ElaPushButton* m_changeAdminPwdBtn;
     ElaPushButton* m_logoutBtn;
@@ -224,6 +224,12 @@ void StudentPanel::initConnections() {
             &StudentPanel::onSessionEnded);
     connect(m_recordController, &RecordController::recordsUpdated, this,
             &StudentPanel::onRecordsUpdated);
+    connect(m_recordController, &RecordController::recordsBatchUpdated, this,
+            [this](const QStringList& cardIds) {
+                if (cardIds.contains(m_currentCardId)) {
+                    refresh();
+                }
+            });
 
     // 上下机失败信号
     connect(m_recordController, &RecordController::sessionStartFailed, this,
@@ -258,6 +264,8 @@ void StudentPanel::initConnections() {
                     updateCardInfo();
                 }
             });
+    // 批量扣款只发出一次整体更新信号
+    connect(m_cardController, &CardController::cardsUpdated, this, &StudentPanel::updateCardInfo);
 }
 
 void StudentPanel::setCurrentCard(const QString& cardId) {
@@ -305,7 +313,7 @@ void StudentPanel::updateCardInfo() {
 
     m_nameLabel->setText(card.name());
     m_studentIdLabel->setText(card.studentId());
-    m_balanceLabel->setText(QString::number(card.balance(), 'f', 2) + QStringLiteral(" 元"));
+    m_balanceLabel->setText(card.balance().toString() + QStringLiteral(" 元"));
 
     // 余额颜色（适配明暗主题）
     bool isDark = (eTheme->getThemeMode() == ElaThemeType::Dark);
@@ -356,10 +364,10 @@ void StudentPanel::updateSessionStatus() {
             m_sessionTimeLabel->setText(QStringLiteral("开始时间：") + startTime);
             m_sessionLocationLabel->setText(QStringLiteral("  地点：") + session.location());
 
-            double currentCost = m_recordController->getCurrentCost(m_currentCardId);
+            Money currentCost = m_recordController->getCurrentCost(m_currentCardId);
             m_sessionTimeLabel->setText(m_sessionTimeLabel->text() +
                                         QStringLiteral("  当前费用：") +
-                                        QString::number(currentCost, 'f', 2) + QStringLiteral(" 元"));
+                                        currentCost.toString() + QStringLiteral(" 元"));
         }
         m_startSessionBtn->setEnabled(false);
         m_endSessionBtn->setEnabled(true);
@@ -369,7 +377,7 @@ void StudentPanel::updateSessionStatus() {
         m_sessionLabel->setStyleSheet(QStringLiteral("color: %1;").arg(offlineColor.name()));
         m_sessionTimeLabel->setText(QString());
         m_sessionLocationLabel->setText(QString());
-        m_startSessionBtn->setEnabled(card.balance() > 0);
+        m_startSessionBtn->setEnabled(card.balance().isPositive());
         m_endSessionBtn->setEnabled(false);
     }
 }
@@ -377,7 +385,7 @@ void StudentPanel::updateSessionStatus() {
 void StudentPanel::updateStatistics() {
     int totalSessions = m_recordController->getTotalSessionCount(m_currentCardId);
     int totalDuration = m_recordController->getTotalDuration(m_currentCardId);
-    double totalCost = m_recordController->getTotalCost(m_currentCardId);
+    Money totalCost = m_recordController->getTotalCost(m_currentCardId);
 
     m_totalSessionsLabel->setText(QString::number(totalSessions) + QStringLiteral(" 次"));
 
@@ -386,7 +394,7 @@ void StudentPanel::updateStatistics() {
     m_totalDurationLabel->setText(QString::number(hours) + QStringLiteral(" 小时 ") +
                                   QString::number(minutes) + QStringLiteral(" 分钟"));
 
-    m_totalCostLabel->setText(QString::number(totalCost, 'f', 2) + QStringLiteral(" 元"));
+    m_totalCostLabel->setText(totalCost.toString() + QStringLiteral(" 元"));
 
     // 消费金额颜色（适配明暗主题）
     QColor costColor = ElaThemeColor(eTheme->getThemeMode(), StatusDanger);
@@ -418,9 +426,8 @@ void StudentPanel::updateRecordTable() {
         location.clear();
     }
 
-    QList<Record> records =
-        m_recordController->getFilteredRecords(m_currentCardId, startDate, endDate, location);
-    m_recordTable->setRecords(records);
+    m_recordTable->setRecords(
+        m_recordController->getFilteredRecordsView(m_currentCardId, startDate, endDate, location));
 }
 
 void StudentPanel::onFilterChanged() {
@@ -497,11 +504,11 @@ void StudentPanel::onSessionStarted(const QString& cardId, const QString& /*loca
     }
 }
 
-void StudentPanel::onSessionEnded(const QString& cardId, double cost, int /*duration*/) {
+void StudentPanel::onSessionEnded(const QString& cardId, Money cost, int /*duration*/) {
     if (cardId == m_currentCardId) {
         ElaMessageBar::success(ElaMessageBarType::TopRight, QStringLiteral("成功"),
                                QStringLiteral("上机结束，本次费用：") +
-                                   QString::number(cost, 'f', 2) + QStringLiteral(" 元"),
+                                   cost.toString() + QStringLiteral(" 元"),
                                3000, this);
         refresh();
     }
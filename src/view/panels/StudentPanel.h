@@ -104,7 +104,7 @@ private slots:
      * @param cost 费用
      * @param duration 时长
      */
-    void onSessionEnded(const QString& cardId, double cost, int duration);
+    void onSessionEnded(const QString& cardId, Money cost, int duration);
 
     /**
      * @brief 处理记录更新
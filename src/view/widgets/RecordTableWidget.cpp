@@ -16,8 +16,6 @@
 #include <QStandardItemModel>
 #include <QVBoxLayout>
 
-#include <algorithm>
-
 
 namespace CampusCard {
 
@@ -49,14 +47,16 @@ void RecordTableWidget::initUI() {
 }
 
 void RecordTableWidget::setRecords(const QList<Record>& records) {
+    setRecords(RecordView::over(records));
+}
+
+void RecordTableWidget::setRecords(RecordView records) {
     clear();
 
-    // 按时间倒序排列（最新的在前）
-    QList<Record> sortedRecords = records;
-    std::sort(sortedRecords.begin(), sortedRecords.end(),
-              [](const Record& a, const Record& b) { return a.startTime() > b.startTime(); });
+    // 按时间倒序排列（最新的在前），排序只作用于本视图持有的列表
+    records.sort([](const Record& a, const Record& b) { return a.startTime() > b.startTime(); });
 
-    for (const auto& record : sortedRecords) {
+    for (const auto& record : records) {
         QList<QStandardItem*> row;
 
         row << new QStandardItem(record.date());
@@ -69,7 +69,7 @@ void RecordTableWidget::setRecords(const QList<Record>& records) {
         } else {
             row << new QStandardItem(record.endTime().toString(QStringLiteral("HH:mm:ss")));
             row << new QStandardItem(QString::number(record.durationMinutes()));
-            row << new QStandardItem(QString::number(record.cost(), 'f', 2));
+            row << new QStandardItem(record.cost().toString());
         }
 
         row << new QStandardItem(record.location());
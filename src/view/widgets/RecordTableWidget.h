@@ -12,6 +12,7 @@
 #define VIEW_WIDGETS_RECORDTABLEWIDGET_H
 
 #include "model/entities/Record.h"
+#include "model/services/RecordView.h"
 
 #include <QWidget>
 
@@ -50,6 +51,12 @@ public:
      */
     void setRecords(const QList<Record>& records);
 
+    /**
+     * @brief 设置记录数据（视图版本）
+     * @param records 记录视图
+     */
+    void setRecords(RecordView records);
+
     /**
      * @brief 清空记录
      */
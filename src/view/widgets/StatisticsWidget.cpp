@@ -9,14 +9,19 @@
 
 #include "StatisticsWidget.h"
 
+#include "ElaComboBox.h"
+#include "ElaPushButton.h"
 #include "ElaTableView.h"
 #include "ElaText.h"
 
+#include <QBrush>
+#include <QColor>
 #include <QDate>
 #include <QDateEdit>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QHeaderView>
+#include <QProgressBar>
 #include <QStandardItemModel>
 #include <QVBoxLayout>
 
@@ -29,6 +34,9 @@ StatisticsWidget::StatisticsWidget(RecordController* recordController,
     initUI();
     initConnections();
     refreshStatistics();
+    refreshHeatmap();
+    refreshRanking();
+    refreshRangeTotals();
 }
 
 void StatisticsWidget::initUI() {
@@ -86,33 +94,305 @@ void StatisticsWidget::initUI() {
 
     detailLayout->addWidget(m_detailTable);
     mainLayout->addWidget(detailGroup, 1);
+
+    // 历史报表（后台汇总，不阻塞界面）
+    QGroupBox* reportGroup = new QGroupBox(QStringLiteral("历史报表"), this);
+    QVBoxLayout* reportLayout = new QVBoxLayout(reportGroup);
+
+    QHBoxLayout* rangeLayout = new QHBoxLayout();
+    m_reportStartEdit = new QDateEdit(reportGroup);
+    m_reportStartEdit->setDate(QDate::currentDate().addMonths(-6));
+    m_reportStartEdit->setCalendarPopup(true);
+    m_reportStartEdit->setDisplayFormat(QStringLiteral("yyyy-MM-dd"));
+    m_reportEndEdit = new QDateEdit(reportGroup);
+    m_reportEndEdit->setDate(QDate::currentDate());
+    m_reportEndEdit->setCalendarPopup(true);
+    m_reportEndEdit->setDisplayFormat(QStringLiteral("yyyy-MM-dd"));
+    m_reportStartBtn = new ElaPushButton(QStringLiteral("生成报表"), reportGroup);
+    m_reportCancelBtn = new ElaPushButton(QStringLiteral("取消"), reportGroup);
+    m_reportCancelBtn->setEnabled(false);
+    rangeLayout->addWidget(new ElaText(QStringLiteral("日期范围："), reportGroup));
+    rangeLayout->addWidget(m_reportStartEdit);
+    rangeLayout->addWidget(new ElaText(QStringLiteral("至"), reportGroup));
+    rangeLayout->addWidget(m_reportEndEdit);
+    rangeLayout->addWidget(m_reportStartBtn);
+    rangeLayout->addWidget(m_reportCancelBtn);
+    rangeLayout->addStretch();
+    reportLayout->addLayout(rangeLayout);
+
+    m_rangeTotalsLabel = new ElaText(reportGroup);
+    m_rangeTotalsLabel->setTextPixelSize(16);
+    reportLayout->addWidget(m_rangeTotalsLabel);
+
+    m_reportProgress = new QProgressBar(reportGroup);
+    m_reportProgress->setRange(0, 1);
+    m_reportProgress->setValue(0);
+    reportLayout->addWidget(m_reportProgress);
+
+    m_reportResultLabel = new ElaText(QStringLiteral("尚未生成报表"), reportGroup);
+    m_reportResultLabel->setTextPixelSize(14);
+    m_reportResultLabel->setWordWrap(true);
+    reportLayout->addWidget(m_reportResultLabel);
+    mainLayout->addWidget(reportGroup);
+
+    // 使用热力图（日期范围与历史报表相同）
+    QGroupBox* heatmapGroup = new QGroupBox(QStringLiteral("使用热力图"), this);
+    QVBoxLayout* heatmapLayout = new QVBoxLayout(heatmapGroup);
+
+    QHBoxLayout* heatmapFilterLayout = new QHBoxLayout();
+    m_heatmapLocation = new ElaComboBox(heatmapGroup);
+    m_heatmapLocation->addItem(QStringLiteral("全部地点"));
+    heatmapFilterLayout->addWidget(new ElaText(QStringLiteral("地点："), heatmapGroup));
+    heatmapFilterLayout->addWidget(m_heatmapLocation);
+    heatmapFilterLayout->addStretch();
+    heatmapLayout->addLayout(heatmapFilterLayout);
+
+    m_heatmapTable = new ElaTableView(heatmapGroup);
+    m_heatmapModel = new QStandardItemModel(HeatmapGrid::DAYS, HeatmapGrid::HOURS, this);
+    QStringList hourLabels;
+    for (int hour = 0; hour < HeatmapGrid::HOURS; ++hour) {
+        hourLabels << QString::number(hour);
+    }
+    m_heatmapModel->setHorizontalHeaderLabels(hourLabels);
+    m_heatmapModel->setVerticalHeaderLabels(
+        {QStringLiteral("周一"), QStringLiteral("周二"), QStringLiteral("周三"),
+         QStringLiteral("周四"), QStringLiteral("周五"), QStringLiteral("周六"),
+         QStringLiteral("周日")});
+
+    m_heatmapTable->setModel(m_heatmapModel);
+    m_heatmapTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_heatmapTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_heatmapTable->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_heatmapTable->setMinimumHeight(220);
+    heatmapLayout->addWidget(m_heatmapTable);
+    mainLayout->addWidget(heatmapGroup);
+
+    // 使用排行
+    QGroupBox* rankGroup = new QGroupBox(QStringLiteral("使用排行（前50名）"), this);
+    QVBoxLayout* rankLayout = new QVBoxLayout(rankGroup);
+
+    QHBoxLayout* rankFilterLayout = new QHBoxLayout();
+    m_rankMetric = new ElaComboBox(rankGroup);
+    m_rankMetric->addItem(QStringLiteral("按上机时长"));
+    m_rankMetric->addItem(QStringLiteral("按消费金额"));
+    m_rankPeriod = new ElaComboBox(rankGroup);
+    m_rankPeriod->addItem(QStringLiteral("本周"));
+    m_rankPeriod->addItem(QStringLiteral("全部时间"));
+    rankFilterLayout->addWidget(m_rankMetric);
+    rankFilterLayout->addWidget(m_rankPeriod);
+    rankFilterLayout->addStretch();
+    rankLayout->addLayout(rankFilterLayout);
+
+    m_rankTable = new ElaTableView(rankGroup);
+    m_rankModel = new QStandardItemModel(this);
+    m_rankModel->setHorizontalHeaderLabels({QStringLiteral("排名"), QStringLiteral("卡号"),
+                                            QStringLiteral("姓名"), QStringLiteral("上机次数"),
+                                            QStringLiteral("时长(分钟)"),
+                                            QStringLiteral("消费(元)")});
+    m_rankTable->setModel(m_rankModel);
+    m_rankTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_rankTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_rankTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_rankTable->setMinimumHeight(200);
+    rankLayout->addWidget(m_rankTable);
+    mainLayout->addWidget(rankGroup);
 }
 
 void StatisticsWidget::initConnections() {
     connect(m_dateEdit, &QDateEdit::dateChanged, this, &StatisticsWidget::onDateChanged);
+
+    connect(m_reportStartBtn, &ElaPushButton::clicked, this, &StatisticsWidget::onStartReport);
+    connect(m_reportCancelBtn, &ElaPushButton::clicked, this, &StatisticsWidget::onCancelReport);
+    connect(m_recordController, &RecordController::historyReportProgress, this,
+            &StatisticsWidget::onReportProgress);
+    connect(m_recordController, &RecordController::historyReportFinished, this,
+            &StatisticsWidget::onReportFinished);
+    connect(m_recordController, &RecordController::historyReportCanceled, this,
+            &StatisticsWidget::onReportCanceled);
+
+    connect(m_reportStartEdit, &QDateEdit::dateChanged, this, &StatisticsWidget::refreshHeatmap);
+    connect(m_reportEndEdit, &QDateEdit::dateChanged, this, &StatisticsWidget::refreshHeatmap);
+    connect(m_reportStartEdit, &QDateEdit::dateChanged, this,
+            &StatisticsWidget::refreshRangeTotals);
+    connect(m_reportEndEdit, &QDateEdit::dateChanged, this, &StatisticsWidget::refreshRangeTotals);
+    connect(m_heatmapLocation, QOverload<int>::of(&ElaComboBox::currentIndexChanged), this,
+            &StatisticsWidget::refreshHeatmap);
+
+    connect(m_rankMetric, QOverload<int>::of(&ElaComboBox::currentIndexChanged), this,
+            &StatisticsWidget::refreshRanking);
+    connect(m_rankPeriod, QOverload<int>::of(&ElaComboBox::currentIndexChanged), this,
+            &StatisticsWidget::refreshRanking);
 }
 
 void StatisticsWidget::onDateChanged() {
     refreshStatistics();
 }
 
+void StatisticsWidget::onStartReport() {
+    RecordQuery query;
+    query.dateRange(m_reportStartEdit->date().toString(QStringLiteral("yyyy-MM-dd")),
+                    m_reportEndEdit->date().toString(QStringLiteral("yyyy-MM-dd")));
+
+    if (m_recordController->startHistoryReport(query)) {
+        m_reportProgress->setRange(0, 0);  // 分块数确定前显示忙碌状态
+        m_reportResultLabel->setText(QStringLiteral("正在生成报表..."));
+        setReportRunning(true);
+    }
+}
+
+void StatisticsWidget::onCancelReport() {
+    m_recordController->cancelHistoryReport();
+    m_reportCancelBtn->setEnabled(false);
+}
+
+void StatisticsWidget::onReportProgress(int done, int total) {
+    m_reportProgress->setRange(0, qMax(1, total));
+    m_reportProgress->setValue(done);
+}
+
+void StatisticsWidget::onReportFinished(const HistorySummary& summary) {
+    setReportRunning(false);
+    m_reportProgress->setRange(0, 1);
+    m_reportProgress->setValue(1);
+
+    QStringList lines;
+    lines << QStringLiteral("总收入：%1 元，上机 %2 次，总时长 %3 分钟")
+                 .arg(summary.totalIncome.toString())
+                 .arg(summary.sessionCount)
+                 .arg(summary.totalDuration);
+
+    QStringList locations;
+    for (const auto& location : summary.byLocation) {
+        locations << QStringLiteral("%1 %2 元")
+                         .arg(location.key)
+                         .arg(location.totalCost.toString());
+    }
+    if (!locations.isEmpty()) {
+        lines << QStringLiteral("各地点收入：") + locations.join(QStringLiteral("；"));
+    }
+
+    QStringList cards;
+    for (const auto& entry : summary.topCards) {
+        Card card = m_cardController->getCard(entry.key);
+        QString name = card.cardId().isEmpty() ? entry.key : card.name();
+        cards << QStringLiteral("%1 %2 分钟").arg(name).arg(entry.totalDuration);
+    }
+    if (!cards.isEmpty()) {
+        lines << QStringLiteral("上机时长排行：") + cards.join(QStringLiteral("；"));
+    }
+
+    m_reportResultLabel->setText(lines.join(QLatin1Char('\n')));
+}
+
+void StatisticsWidget::onReportCanceled() {
+    setReportRunning(false);
+    m_reportProgress->setRange(0, 1);
+    m_reportProgress->setValue(0);
+    m_reportResultLabel->setText(QStringLiteral("报表已取消"));
+}
+
+void StatisticsWidget::refreshHeatmap() {
+    // 更新地点列表（保留当前选择；更新期间屏蔽信号避免重入）
+    QString currentLocation = m_heatmapLocation->currentText();
+    m_heatmapLocation->blockSignals(true);
+    m_heatmapLocation->clear();
+    m_heatmapLocation->addItem(QStringLiteral("全部地点"));
+    for (const auto& location : m_recordController->getHeatmapLocations()) {
+        m_heatmapLocation->addItem(location);
+    }
+    int index = m_heatmapLocation->findText(currentLocation);
+    m_heatmapLocation->setCurrentIndex(index >= 0 ? index : 0);
+    m_heatmapLocation->blockSignals(false);
+
+    QString location = m_heatmapLocation->currentText();
+    if (location == QStringLiteral("全部地点")) {
+        location.clear();
+    }
+
+    HeatmapGrid grid = m_recordController->getUsageHeatmap(
+        location, m_reportStartEdit->date().toString(QStringLiteral("yyyy-MM-dd")),
+        m_reportEndEdit->date().toString(QStringLiteral("yyyy-MM-dd")));
+
+    // 按最大单元格归一化着色，单元格显示分钟数
+    const qint64 maxSeconds = grid.maxSeconds();
+    for (int day = 1; day <= HeatmapGrid::DAYS; ++day) {
+        for (int hour = 0; hour < HeatmapGrid::HOURS; ++hour) {
+            qint64 seconds = grid.seconds(day, hour);
+            auto* item = new QStandardItem();
+            if (seconds > 0) {
+                item->setText(QString::number(qRound(grid.minutes(day, hour))));
+                double ratio = static_cast<double>(seconds) / static_cast<double>(maxSeconds);
+                item->setBackground(QBrush(QColor(0, 120, 212, 30 + qRound(200 * ratio))));
+            }
+            item->setTextAlignment(Qt::AlignCenter);
+            m_heatmapModel->setItem(day - 1, hour, item);
+        }
+    }
+}
+
+void StatisticsWidget::refreshRangeTotals() {
+    LedgerTotals totals = m_recordController->getRangeTotals(
+        m_reportStartEdit->date().toString(QStringLiteral("yyyy-MM-dd")),
+        m_reportEndEdit->date().toString(QStringLiteral("yyyy-MM-dd")));
+
+    m_rangeTotalsLabel->setText(QStringLiteral("区间合计：收入 %1 元，上机 %2 次，时长 %3 分钟")
+                                    .arg(totals.income.toString())
+                                    .arg(totals.sessions)
+                                    .arg(totals.minutes));
+}
+
+void StatisticsWidget::refreshRanking() {
+    RankMetric metric =
+        m_rankMetric->currentIndex() == 1 ? RankMetric::Spend : RankMetric::Minutes;
+    RankPeriod period =
+        m_rankPeriod->currentIndex() == 1 ? RankPeriod::AllTime : RankPeriod::ThisWeek;
+
+    m_rankModel->removeRows(0, m_rankModel->rowCount());
+
+    const QList<RecordGroup> ranking = m_recordController->getTopUsers(metric, period);
+    for (int i = 0; i < ranking.size(); ++i) {
+        const RecordGroup& entry = ranking.at(i);
+        Card card = m_cardController->getCard(entry.key);
+        QString name = card.cardId().isEmpty() ? QStringLiteral("未知") : card.name();
+
+        QList<QStandardItem*> row;
+        row << new QStandardItem(QString::number(i + 1));
+        row << new QStandardItem(entry.key);
+        row << new QStandardItem(name);
+        row << new QStandardItem(QString::number(entry.count));
+        row << new QStandardItem(QString::number(entry.totalDuration));
+        row << new QStandardItem(entry.totalCost.toString());
+        m_rankModel->appendRow(row);
+    }
+}
+
+void StatisticsWidget::setReportRunning(bool running) {
+    m_reportStartBtn->setEnabled(!running);
+    m_reportCancelBtn->setEnabled(running);
+    m_reportStartEdit->setEnabled(!running);
+    m_reportEndEdit->setEnabled(!running);
+}
+
 void StatisticsWidget::refresh() {
     refreshStatistics();
+    refreshHeatmap();
+    refreshRanking();
+    refreshRangeTotals();
 }
 
 void StatisticsWidget::refreshStatistics() {
     QString date = m_dateEdit->date().toString(QStringLiteral("yyyy-MM-dd"));
 
-    // 获取当日记录
-    QList<Record> records = m_recordController->getAllRecordsByDate(date);
+    // 获取当日记录视图
+    const RecordView records = m_recordController->getAllRecordsViewByDate(date);
 
     // 计算统计数据
-    double totalIncome = m_recordController->getDailyIncome(date);
+    Money totalIncome = m_recordController->getDailyIncome(date);
     int sessionCount = m_recordController->getDailySessionCount(date);
     int totalDuration = m_recordController->getDailyTotalDuration(date);
 
     // 更新统计标签
-    m_incomeLabel->setText(QStringLiteral("当日收入：") + QString::number(totalIncome, 'f', 2) +
+    m_incomeLabel->setText(QStringLiteral("当日收入：") + totalIncome.toString() +
                            QStringLiteral(" 元"));
     m_sessionCountLabel->setText(QStringLiteral("上机次数：") + QString::number(sessionCount) +
                                  QStringLiteral(" 次"));
@@ -139,7 +419,7 @@ void StatisticsWidget::refreshStatistics() {
         } else {
             row << new QStandardItem(record.endTime().toString(QStringLiteral("HH:mm:ss")));
             row << new QStandardItem(QString::number(record.durationMinutes()));
-            row << new QStandardItem(QString::number(record.cost(), 'f', 2));
+            row << new QStandardItem(record.cost().toString());
         }
 
         row << new QStandardItem(record.location());
@@ -17,9 +17,12 @@
 #include <QWidget>
 
 
+class ElaComboBox;
+class ElaPushButton;
 class ElaText;
 class ElaTableView;
 class QDateEdit;
+class QProgressBar;
 class QStandardItemModel;
 
 namespace CampusCard {
@@ -32,6 +35,9 @@ namespace CampusCard {
  * - 显示日期选择器
  * - 显示统计摘要（收入、次数、时长）
  * - 显示详细记录表格
+ * - 即时显示任意日期范围的收入合计，并在后台生成历史汇总报表
+ * - 显示指定日期范围内各地点的星期×小时使用热力图
+ * - 显示本周及全部时间的上机时长/消费排行
  */
 class StatisticsWidget : public QWidget {
     Q_OBJECT
@@ -62,6 +68,49 @@ private slots:
      */
     void onDateChanged();
 
+    /**
+     * @brief 开始生成历史报表
+     */
+    void onStartReport();
+
+    /**
+     * @brief 取消历史报表
+     */
+    void onCancelReport();
+
+    /**
+     * @brief 历史报表进度更新
+     * @param done 已完成数
+     * @param total 总数
+     */
+    void onReportProgress(int done, int total);
+
+    /**
+     * @brief 历史报表完成
+     * @param summary 汇总结果
+     */
+    void onReportFinished(const HistorySummary& summary);
+
+    /**
+     * @brief 历史报表已取消
+     */
+    void onReportCanceled();
+
+    /**
+     * @brief 刷新使用热力图
+     */
+    void refreshHeatmap();
+
+    /**
+     * @brief 刷新使用排行
+     */
+    void refreshRanking();
+
+    /**
+     * @brief 刷新报表日期范围内的收入合计
+     */
+    void refreshRangeTotals();
+
 private:
     /**
      * @brief 初始化UI
@@ -78,6 +127,12 @@ private:
      */
     void refreshStatistics();
 
+    /**
+     * @brief 设置报表按钮的运行状态
+     * @param running 是否生成中
+     */
+    void setReportRunning(bool running);
+
     RecordController* m_recordController;  ///< 记录控制器
     CardController* m_cardController;      ///< 卡控制器
 
@@ -87,6 +142,23 @@ private:
     ElaText* m_totalDurationLabel;  ///< 总时长标签
     ElaTableView* m_detailTable;    ///< 详细记录表格
     QStandardItemModel* m_model;    ///< 数据模型
+
+    QDateEdit* m_reportStartEdit;       ///< 报表开始日期
+    QDateEdit* m_reportEndEdit;         ///< 报表结束日期
+    ElaPushButton* m_reportStartBtn;    ///< 生成报表按钮
+    ElaPushButton* m_reportCancelBtn;   ///< 取消报表按钮
+    QProgressBar* m_reportProgress;     ///< 报表进度
+    ElaText* m_reportResultLabel;       ///< 报表结果
+    ElaText* m_rangeTotalsLabel;        ///< 日期范围合计
+
+    ElaComboBox* m_heatmapLocation;     ///< 热力图地点筛选
+    ElaTableView* m_heatmapTable;       ///< 热力图表格
+    QStandardItemModel* m_heatmapModel; ///< 热力图数据模型
+
+    ElaComboBox* m_rankMetric;          ///< 排行指标
+    ElaComboBox* m_rankPeriod;          ///< 排行周期
+    ElaTableView* m_rankTable;          ///< 排行表格
+    QStandardItemModel* m_rankModel;    ///< 排行数据模型
 };
 
 }  // namespace CampusCard
@@ -50,7 +50,7 @@ protected:
 // ========== 学生登录测试 ==========
 
 TEST_F(AuthControllerTest, HandleStudentLoginSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(authController, &AuthController::loginSuccess);
 
@@ -61,7 +61,7 @@ TEST_F(AuthControllerTest, HandleStudentLoginSuccess) {
 }
 
 TEST_F(AuthControllerTest, HandleStudentLoginSuccessUserName) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(authController, &AuthController::loginSuccess);
 
@@ -82,7 +82,7 @@ TEST_F(AuthControllerTest, HandleStudentLoginCardNotFound) {
 }
 
 TEST_F(AuthControllerTest, HandleStudentLoginInvalidPassword) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(authController, &AuthController::loginFailed);
 
@@ -93,7 +93,7 @@ TEST_F(AuthControllerTest, HandleStudentLoginInvalidPassword) {
 }
 
 TEST_F(AuthControllerTest, HandleStudentLoginPasswordErrorSignal) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy errorSpy(authController, &AuthController::passwordError);
 
@@ -103,7 +103,7 @@ TEST_F(AuthControllerTest, HandleStudentLoginPasswordErrorSignal) {
 }
 
 TEST_F(AuthControllerTest, HandleStudentLoginCardFrozenSignal) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy frozenSpy(authController, &AuthController::cardFrozen);
 
@@ -139,7 +139,7 @@ TEST_F(AuthControllerTest, HandleAdminLoginInvalidPassword) {
 // ========== 登出测试 ==========
 
 TEST_F(AuthControllerTest, HandleLogout) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authController->handleStudentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
     QSignalSpy logoutSpy(authController, &AuthController::logoutSuccess);
@@ -155,14 +155,14 @@ TEST_F(AuthControllerTest, HandleLogout) {
 TEST_F(AuthControllerTest, IsLoggedIn) {
     EXPECT_FALSE(authController->isLoggedIn());
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authController->handleStudentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
     EXPECT_TRUE(authController->isLoggedIn());
 }
 
 TEST_F(AuthControllerTest, CurrentRole) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     authController->handleStudentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_EQ(authController->currentRole(), UserRole::Student);
@@ -173,7 +173,7 @@ TEST_F(AuthControllerTest, CurrentRole) {
 }
 
 TEST_F(AuthControllerTest, CurrentCardId) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     authController->handleStudentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_EQ(authController->currentCardId(), "C001");
@@ -184,7 +184,7 @@ TEST_F(AuthControllerTest, CurrentCardId) {
 }
 
 TEST_F(AuthControllerTest, CurrentUserName) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     authController->handleStudentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_EQ(authController->currentUserName(), "张三");
@@ -201,7 +201,7 @@ TEST_F(AuthControllerTest, CurrentUserNameNotLoggedIn) {
 // ========== 登录预检测试 ==========
 
 TEST_F(AuthControllerTest, CheckCardStatus) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(authController->checkCardStatus("C001"), LoginResult::Success);
 }
@@ -211,21 +211,21 @@ TEST_F(AuthControllerTest, CheckCardStatusNotFound) {
 }
 
 TEST_F(AuthControllerTest, CheckCardStatusLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
     EXPECT_EQ(authController->checkCardStatus("C001"), LoginResult::CardLost);
 }
 
 TEST_F(AuthControllerTest, CheckCardStatusFrozen) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->freeze("C001");
 
     EXPECT_EQ(authController->checkCardStatus("C001"), LoginResult::CardFrozen);
 }
 
 TEST_F(AuthControllerTest, GetRemainingAttempts) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(authController->getRemainingAttempts("C001"), MAX_LOGIN_ATTEMPTS);
 
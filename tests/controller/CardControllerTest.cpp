@@ -45,15 +45,15 @@ protected:
 // ========== 查询操作测试 ==========
 
 TEST_F(CardControllerTest, GetAllCards) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    cardService->createCard("C002", "李四", "B17010102", 200.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(200));
 
     QList<Card> cards = cardController->getAllCards();
     EXPECT_EQ(cards.size(), 2);
 }
 
 TEST_F(CardControllerTest, GetCard) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     Card card = cardController->getCard("C001");
     EXPECT_EQ(card.cardId(), "C001");
@@ -66,7 +66,7 @@ TEST_F(CardControllerTest, GetCardNotFound) {
 }
 
 TEST_F(CardControllerTest, CardExists) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_TRUE(cardController->cardExists("C001"));
     EXPECT_FALSE(cardController->cardExists("C999"));
@@ -75,35 +75,35 @@ TEST_F(CardControllerTest, CardExists) {
 TEST_F(CardControllerTest, GetCardCount) {
     EXPECT_EQ(cardController->getCardCount(), 0);
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(cardController->getCardCount(), 1);
 }
 
 TEST_F(CardControllerTest, SearchCards) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    cardService->createCard("C002", "李四", "B17010102", 200.0);
-    cardService->createCard("C003", "张伟", "B17010103", 300.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(200));
+    cardService->createCard("C003", "张伟", "B17010103", Money::fromYuan(300));
 
     QList<Card> results = cardController->searchCards("张");
     EXPECT_EQ(results.size(), 2);
 }
 
 TEST_F(CardControllerTest, SearchCardsEmpty) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QList<Card> results = cardController->searchCards("");
     EXPECT_EQ(results.size(), 1);
 }
 
 TEST_F(CardControllerTest, SearchCardsNoMatch) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QList<Card> results = cardController->searchCards("王");
     EXPECT_TRUE(results.isEmpty());
 }
 
 TEST_F(CardControllerTest, SearchCardsCaseInsensitive) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QList<Card> results = cardController->searchCards("c001");
     EXPECT_EQ(results.size(), 1);
@@ -114,7 +114,7 @@ TEST_F(CardControllerTest, SearchCardsCaseInsensitive) {
 TEST_F(CardControllerTest, HandleCreateCardSuccess) {
     QSignalSpy successSpy(cardController, &CardController::cardCreated);
 
-    cardController->handleCreateCard("C001", "张三", "B17010101", 100.0);
+    cardController->handleCreateCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(successSpy.count(), 1);
     EXPECT_EQ(successSpy.takeFirst().at(0).toString(), "C001");
@@ -123,7 +123,7 @@ TEST_F(CardControllerTest, HandleCreateCardSuccess) {
 TEST_F(CardControllerTest, HandleCreateCardEmptyCardId) {
     QSignalSpy failedSpy(cardController, &CardController::cardCreateFailed);
 
-    cardController->handleCreateCard("", "张三", "B17010101", 100.0);
+    cardController->handleCreateCard("", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
@@ -131,7 +131,7 @@ TEST_F(CardControllerTest, HandleCreateCardEmptyCardId) {
 TEST_F(CardControllerTest, HandleCreateCardEmptyName) {
     QSignalSpy failedSpy(cardController, &CardController::cardCreateFailed);
 
-    cardController->handleCreateCard("C001", "", "B17010101", 100.0);
+    cardController->handleCreateCard("C001", "", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
@@ -139,17 +139,17 @@ TEST_F(CardControllerTest, HandleCreateCardEmptyName) {
 TEST_F(CardControllerTest, HandleCreateCardEmptyStudentId) {
     QSignalSpy failedSpy(cardController, &CardController::cardCreateFailed);
 
-    cardController->handleCreateCard("C001", "张三", "", 100.0);
+    cardController->handleCreateCard("C001", "张三", "", Money::fromYuan(100));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
 
 TEST_F(CardControllerTest, HandleCreateCardDuplicate) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::cardCreateFailed);
 
-    cardController->handleCreateCard("C001", "李四", "B17010102", 200.0);
+    cardController->handleCreateCard("C001", "李四", "B17010102", Money::fromYuan(200));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
@@ -173,77 +173,77 @@ TEST_F(CardControllerTest, HandleRegisterCardPasswordTooShort) {
 // ========== 充值扣款操作测试 ==========
 
 TEST_F(CardControllerTest, HandleRechargeSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(cardController, &CardController::rechargeSuccess);
 
-    cardController->handleRecharge("C001", 50.0);
+    cardController->handleRecharge("C001", Money::fromYuan(50));
 
     EXPECT_EQ(successSpy.count(), 1);
-    EXPECT_DOUBLE_EQ(successSpy.takeFirst().at(1).toDouble(), 150.0);
+    EXPECT_EQ(successSpy.takeFirst().at(1).value<Money>(), Money::fromYuan(150));
 }
 
 TEST_F(CardControllerTest, HandleRechargeNegativeAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::rechargeFailed);
 
-    cardController->handleRecharge("C001", -50.0);
+    cardController->handleRecharge("C001", Money::fromYuan(-50));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
 
 TEST_F(CardControllerTest, HandleRechargeZeroAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::rechargeFailed);
 
-    cardController->handleRecharge("C001", 0.0);
+    cardController->handleRecharge("C001", Money());
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
 
 TEST_F(CardControllerTest, HandleDeductSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(cardController, &CardController::deductSuccess);
 
-    cardController->handleDeduct("C001", 30.0);
+    cardController->handleDeduct("C001", Money::fromYuan(30));
 
     EXPECT_EQ(successSpy.count(), 1);
-    EXPECT_DOUBLE_EQ(successSpy.takeFirst().at(1).toDouble(), 70.0);
+    EXPECT_EQ(successSpy.takeFirst().at(1).value<Money>(), Money::fromYuan(70));
 }
 
 TEST_F(CardControllerTest, HandleDeductInsufficientBalance) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::deductFailed);
 
-    cardController->handleDeduct("C001", 150.0);
+    cardController->handleDeduct("C001", Money::fromYuan(150));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
 
 TEST_F(CardControllerTest, HandleDeductNegativeAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::deductFailed);
 
-    cardController->handleDeduct("C001", -30.0);
+    cardController->handleDeduct("C001", Money::fromYuan(-30));
 
     EXPECT_EQ(failedSpy.count(), 1);
 }
 
 TEST_F(CardControllerTest, GetBalance) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
-    EXPECT_DOUBLE_EQ(cardController->getBalance("C001"), 100.0);
+    EXPECT_EQ(cardController->getBalance("C001"), Money::fromYuan(100));
 }
 
 // ========== 状态管理操作测试 ==========
 
 TEST_F(CardControllerTest, HandleReportLostSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(cardController, &CardController::reportLostSuccess);
 
@@ -261,7 +261,7 @@ TEST_F(CardControllerTest, HandleReportLostCardNotFound) {
 }
 
 TEST_F(CardControllerTest, HandleCancelLostSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
     QSignalSpy successSpy(cardController, &CardController::cancelLostSuccess);
@@ -272,7 +272,7 @@ TEST_F(CardControllerTest, HandleCancelLostSuccess) {
 }
 
 TEST_F(CardControllerTest, HandleCancelLostNotLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::operationFailed);
 
@@ -282,7 +282,7 @@ TEST_F(CardControllerTest, HandleCancelLostNotLost) {
 }
 
 TEST_F(CardControllerTest, HandleFreezeSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(cardController, &CardController::freezeSuccess);
 
@@ -292,7 +292,7 @@ TEST_F(CardControllerTest, HandleFreezeSuccess) {
 }
 
 TEST_F(CardControllerTest, HandleUnfreezeSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->freeze("C001");
 
     QSignalSpy successSpy(cardController, &CardController::unfreezeSuccess);
@@ -305,7 +305,7 @@ TEST_F(CardControllerTest, HandleUnfreezeSuccess) {
 // ========== 密码管理测试 ==========
 
 TEST_F(CardControllerTest, HandleChangePasswordSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(cardController, &CardController::passwordChanged);
 
@@ -315,7 +315,7 @@ TEST_F(CardControllerTest, HandleChangePasswordSuccess) {
 }
 
 TEST_F(CardControllerTest, HandleChangePasswordWrongOld) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::passwordChangeFailed);
 
@@ -325,7 +325,7 @@ TEST_F(CardControllerTest, HandleChangePasswordWrongOld) {
 }
 
 TEST_F(CardControllerTest, HandleChangePasswordTooShort) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::passwordChangeFailed);
 
@@ -335,7 +335,7 @@ TEST_F(CardControllerTest, HandleChangePasswordTooShort) {
 }
 
 TEST_F(CardControllerTest, HandleResetPasswordSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(cardController, &CardController::passwordReset);
 
@@ -345,7 +345,7 @@ TEST_F(CardControllerTest, HandleResetPasswordSuccess) {
 }
 
 TEST_F(CardControllerTest, HandleResetPasswordEmpty) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy failedSpy(cardController, &CardController::passwordChangeFailed);
 
@@ -359,17 +359,17 @@ TEST_F(CardControllerTest, HandleResetPasswordEmpty) {
 TEST_F(CardControllerTest, CardsUpdatedSignal) {
     QSignalSpy updatedSpy(cardController, &CardController::cardsUpdated);
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(updatedSpy.count(), 1);
 }
 
 TEST_F(CardControllerTest, CardUpdatedSignal) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy updatedSpy(cardController, &CardController::cardUpdated);
 
-    cardService->recharge("C001", 50.0);
+    cardService->recharge("C001", Money::fromYuan(50));
 
     EXPECT_EQ(updatedSpy.count(), 1);
     EXPECT_EQ(updatedSpy.takeFirst().at(0).toString(), "C001");
@@ -132,7 +132,7 @@ TEST_F(MainControllerTest, ExportData) {
     mainController->initialize(testDataPath);
 
     // 创建一些数据
-    mainController->cardService()->createCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardService()->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(mainController, &MainController::exportSuccess);
 
@@ -156,14 +156,14 @@ TEST_F(MainControllerTest, ImportDataOverwrite) {
     mainController->initialize(testDataPath);
 
     // 创建初始数据
-    mainController->cardService()->createCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardService()->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     // 导出
     QString exportPath = testDataPath + "/export.txt";
     mainController->exportData(exportPath);
 
     // 添加新数据
-    mainController->cardService()->createCard("C002", "李四", "B17010102", 200.0);
+    mainController->cardService()->createCard("C002", "李四", "B17010102", Money::fromYuan(200));
     EXPECT_EQ(mainController->cardController()->getCardCount(), 2);
 
     // 导入（覆盖）
@@ -178,7 +178,7 @@ TEST_F(MainControllerTest, ImportDataMerge) {
     mainController->initialize(testDataPath);
 
     // 创建初始数据
-    mainController->cardService()->createCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardService()->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     // 导出
     QString exportPath = testDataPath + "/export.txt";
@@ -187,7 +187,7 @@ TEST_F(MainControllerTest, ImportDataMerge) {
     // 清空数据并创建新数据
     StorageManager::instance().saveAllCards(QList<Card>());
     mainController->reloadData();
-    mainController->cardService()->createCard("C002", "李四", "B17010102", 200.0);
+    mainController->cardService()->createCard("C002", "李四", "B17010102", Money::fromYuan(200));
 
     // 导入（合并）
     QSignalSpy successSpy(mainController, &MainController::importSuccess);
@@ -210,7 +210,7 @@ TEST_F(MainControllerTest, ReloadData) {
     mainController->initialize(testDataPath);
 
     // 创建数据
-    mainController->cardService()->createCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardService()->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy reloadSpy(mainController, &MainController::dataReloaded);
 
@@ -227,7 +227,8 @@ TEST_F(MainControllerTest, FullWorkflow) {
     mainController->initialize(testDataPath);
 
     // 创建卡
-    mainController->cardController()->handleCreateCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardController()->handleCreateCard("C001", "张三", "B17010101",
+                                   Money::fromYuan(100));
     EXPECT_EQ(mainController->cardController()->getCardCount(), 1);
 
     // 学生登录
@@ -256,12 +257,13 @@ TEST_F(MainControllerTest, AdminWorkflow) {
     EXPECT_EQ(mainController->authController()->currentRole(), UserRole::Admin);
 
     // 创建卡
-    mainController->cardController()->handleCreateCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardController()->handleCreateCard("C001", "张三", "B17010101",
+                                   Money::fromYuan(100));
     EXPECT_EQ(mainController->cardController()->getCardCount(), 1);
 
     // 充值
-    mainController->cardController()->handleRecharge("C001", 50.0);
-    EXPECT_DOUBLE_EQ(mainController->cardController()->getBalance("C001"), 150.0);
+    mainController->cardController()->handleRecharge("C001", Money::fromYuan(50));
+    EXPECT_EQ(mainController->cardController()->getBalance("C001"), Money::fromYuan(150));
 
     // 冻结卡
     mainController->cardController()->handleFreeze("C001");
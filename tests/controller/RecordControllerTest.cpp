@@ -24,6 +24,7 @@ protected:
     QString testDataPath;
     CardService* cardService;
     RecordService* recordService;
+    TransactionManager* transactions;
     RecordController* recordController;
 
     void SetUp() override {
@@ -40,11 +41,13 @@ protected:
         recordService = new RecordService();
         recordService->initialize();
 
-        recordController = new RecordController(recordService, cardService);
+        transactions = new TransactionManager(cardService, recordService);
+        recordController = new RecordController(recordService, cardService, transactions);
     }
 
     void TearDown() override {
         delete recordController;
+        delete transactions;
         delete recordService;
         delete cardService;
     }
@@ -53,7 +56,7 @@ protected:
 // ========== 上下机操作测试 ==========
 
 TEST_F(RecordControllerTest, HandleStartSessionSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(recordController, &RecordController::sessionStarted);
 
@@ -74,7 +77,7 @@ TEST_F(RecordControllerTest, HandleStartSessionCardNotFound) {
 }
 
 TEST_F(RecordControllerTest, HandleStartSessionCardNotUsable) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
     QSignalSpy failedSpy(recordController, &RecordController::sessionStartFailed);
@@ -85,7 +88,7 @@ TEST_F(RecordControllerTest, HandleStartSessionCardNotUsable) {
 }
 
 TEST_F(RecordControllerTest, HandleStartSessionInsufficientBalance) {
-    cardService->createCard("C001", "张三", "B17010101", 0.0);
+    cardService->createCard("C001", "张三", "B17010101", Money());
 
     QSignalSpy failedSpy(recordController, &RecordController::sessionStartFailed);
 
@@ -95,7 +98,7 @@ TEST_F(RecordControllerTest, HandleStartSessionInsufficientBalance) {
 }
 
 TEST_F(RecordControllerTest, HandleStartSessionAlreadyOnline) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
 
     QSignalSpy failedSpy(recordController, &RecordController::sessionStartFailed);
@@ -106,7 +109,7 @@ TEST_F(RecordControllerTest, HandleStartSessionAlreadyOnline) {
 }
 
 TEST_F(RecordControllerTest, HandleEndSessionSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
 
     QThread::msleep(100);
@@ -127,20 +130,20 @@ TEST_F(RecordControllerTest, HandleEndSessionNotOnline) {
 }
 
 TEST_F(RecordControllerTest, HandleEndSessionDeductsBalance) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
 
     QThread::msleep(100);
 
-    double balanceBefore = cardService->getBalance("C001");
+    Money balanceBefore = cardService->getBalance("C001");
     recordController->handleEndSession("C001");
-    double balanceAfter = cardService->getBalance("C001");
+    Money balanceAfter = cardService->getBalance("C001");
 
     EXPECT_LE(balanceAfter, balanceBefore);
 }
 
 TEST_F(RecordControllerTest, IsOnline) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_FALSE(recordController->isOnline("C001"));
 
@@ -152,7 +155,7 @@ TEST_F(RecordControllerTest, IsOnline) {
 }
 
 TEST_F(RecordControllerTest, GetCurrentSession) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
 
     Record session = recordController->getCurrentSession("C001");
@@ -166,17 +169,17 @@ TEST_F(RecordControllerTest, GetCurrentSessionNotOnline) {
 }
 
 TEST_F(RecordControllerTest, GetCurrentCost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
 
-    double cost = recordController->getCurrentCost("C001");
-    EXPECT_GE(cost, 0.0);
+    Money cost = recordController->getCurrentCost("C001");
+    EXPECT_FALSE(cost.isNegative());
 }
 
 // ========== 记录查询测试 ==========
 
 TEST_F(RecordControllerTest, GetRecords) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
     recordController->handleStartSession("C001", "机房B202");
@@ -187,7 +190,7 @@ TEST_F(RecordControllerTest, GetRecords) {
 }
 
 TEST_F(RecordControllerTest, GetRecordsByDateRange) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
 
@@ -199,7 +202,7 @@ TEST_F(RecordControllerTest, GetRecordsByDateRange) {
 }
 
 TEST_F(RecordControllerTest, GetRecordsByLocation) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
     recordController->handleStartSession("C001", "机房B202");
@@ -210,7 +213,7 @@ TEST_F(RecordControllerTest, GetRecordsByLocation) {
 }
 
 TEST_F(RecordControllerTest, GetFilteredRecords) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
 
@@ -222,7 +225,7 @@ TEST_F(RecordControllerTest, GetFilteredRecords) {
 }
 
 TEST_F(RecordControllerTest, GetFilteredRecordsEmptyLocation) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
     recordController->handleStartSession("C001", "机房B202");
@@ -236,7 +239,7 @@ TEST_F(RecordControllerTest, GetFilteredRecordsEmptyLocation) {
 }
 
 TEST_F(RecordControllerTest, GetLocations) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
     recordController->handleStartSession("C001", "机房B202");
@@ -247,8 +250,8 @@ TEST_F(RecordControllerTest, GetLocations) {
 }
 
 TEST_F(RecordControllerTest, GetAllRecordsByDate) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    cardService->createCard("C002", "李四", "B17010102", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
     recordController->handleStartSession("C002", "机房B202");
@@ -262,7 +265,7 @@ TEST_F(RecordControllerTest, GetAllRecordsByDate) {
 // ========== 统计查询测试 ==========
 
 TEST_F(RecordControllerTest, GetTotalSessionCount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
     recordController->handleStartSession("C001", "机房B202");
@@ -272,7 +275,7 @@ TEST_F(RecordControllerTest, GetTotalSessionCount) {
 }
 
 TEST_F(RecordControllerTest, GetTotalDuration) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     QThread::msleep(100);
     recordController->handleEndSession("C001");
@@ -282,27 +285,27 @@ TEST_F(RecordControllerTest, GetTotalDuration) {
 }
 
 TEST_F(RecordControllerTest, GetTotalCost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     QThread::msleep(100);
     recordController->handleEndSession("C001");
 
-    double cost = recordController->getTotalCost("C001");
-    EXPECT_GE(cost, 0.0);
+    Money cost = recordController->getTotalCost("C001");
+    EXPECT_FALSE(cost.isNegative());
 }
 
 TEST_F(RecordControllerTest, GetDailyIncome) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
 
     QString today = QDate::currentDate().toString("yyyy-MM-dd");
-    double income = recordController->getDailyIncome(today);
-    EXPECT_GE(income, 0.0);
+    Money income = recordController->getDailyIncome(today);
+    EXPECT_FALSE(income.isNegative());
 }
 
 TEST_F(RecordControllerTest, GetDailySessionCount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
 
@@ -312,7 +315,7 @@ TEST_F(RecordControllerTest, GetDailySessionCount) {
 }
 
 TEST_F(RecordControllerTest, GetDailyTotalDuration) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
 
@@ -322,7 +325,7 @@ TEST_F(RecordControllerTest, GetDailyTotalDuration) {
 }
 
 TEST_F(RecordControllerTest, GetStatisticsSummary) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     recordController->handleStartSession("C001", "机房A101");
     recordController->handleEndSession("C001");
 
@@ -331,8 +334,8 @@ TEST_F(RecordControllerTest, GetStatisticsSummary) {
 }
 
 TEST_F(RecordControllerTest, GetOnlineCount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    cardService->createCard("C002", "李四", "B17010102", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(100));
 
     EXPECT_EQ(recordController->getOnlineCount(), 0);
 
@@ -346,10 +349,67 @@ TEST_F(RecordControllerTest, GetOnlineCount) {
     EXPECT_EQ(recordController->getOnlineCount(), 1);
 }
 
+// ========== 批量上下机测试 ==========
+
+TEST_F(RecordControllerTest, HandleStartSessionsValidatesEachCard) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money());
+    cardService->createCard("C003", "王五", "B17010103", Money::fromYuan(100));
+    cardService->createCard("C004", "赵六", "B17010104", Money::fromYuan(100));
+    cardService->reportLost("C003");
+    recordController->handleStartSession("C004", "机房B202");
+
+    QSignalSpy startedSpy(recordController, &RecordController::sessionsStarted);
+    QSignalSpy singleSpy(recordController, &RecordController::sessionStarted);
+
+    BatchSessionResult result = recordController->handleStartSessions(
+        {"C001", "C002", "C003", "C004", "C999", "C001"}, "机房A101");
+
+    EXPECT_EQ(result.succeeded, QStringList{"C001"});
+    EXPECT_EQ(result.failed.value("C002"), "余额不足，请先充值");
+    EXPECT_EQ(result.failed.value("C003"), "卡片状态异常，无法上机");
+    EXPECT_EQ(result.failed.value("C004"), "当前已在上机中");
+    EXPECT_EQ(result.failed.value("C999"), "卡不存在");
+    EXPECT_EQ(result.failed.value("C001"), "卡号重复");
+    EXPECT_EQ(startedSpy.count(), 1);
+    EXPECT_EQ(singleSpy.count(), 0);
+    EXPECT_TRUE(recordController->isOnline("C001"));
+}
+
+TEST_F(RecordControllerTest, HandleEndSessionsDebitsInOneTransaction) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(100));
+    recordController->handleStartSessions({"C001", "C002"}, "机房A101");
+
+    QSignalSpy endedSpy(recordController, &RecordController::sessionsEnded);
+    QSignalSpy batchSpy(recordController, &RecordController::recordsBatchUpdated);
+
+    BatchSessionResult result = recordController->handleEndSessions({"C001", "C002", "C003"});
+
+    EXPECT_EQ(result.succeeded, QStringList({"C001", "C002"}));
+    EXPECT_EQ(result.failed.value("C003"), "当前未在上机中");
+    EXPECT_EQ(cardService->getBalance("C001") + cardService->getBalance("C002"),
+              Money::fromYuan(200) - result.totalCost);
+    EXPECT_FALSE(recordController->isOnline("C001"));
+    EXPECT_EQ(endedSpy.count(), 1);
+    EXPECT_EQ(batchSpy.count(), 1);
+    EXPECT_EQ(transactions->pendingCount(), 1);
+}
+
+TEST_F(RecordControllerTest, HandleEndSessionsNoneOnline) {
+    QSignalSpy endedSpy(recordController, &RecordController::sessionsEnded);
+
+    BatchSessionResult result = recordController->handleEndSessions({"C001"});
+
+    EXPECT_TRUE(result.succeeded.isEmpty());
+    EXPECT_EQ(result.failed.size(), 1);
+    EXPECT_EQ(endedSpy.count(), 0);
+}
+
 // ========== 信号转发测试 ==========
 
 TEST_F(RecordControllerTest, RecordsUpdatedSignal) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy updatedSpy(recordController, &RecordController::recordsUpdated);
 
@@ -357,3 +417,26 @@ TEST_F(RecordControllerTest, RecordsUpdatedSignal) {
 
     EXPECT_EQ(updatedSpy.count(), 1);
 }
+
+// ========== 历史报表测试 ==========
+
+TEST_F(RecordControllerTest, HistoryReportFinishes) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    recordController->handleStartSession("C001", "机房A101");
+    recordController->handleEndSession("C001");
+
+    QSignalSpy finishedSpy(recordController, &RecordController::historyReportFinished);
+
+    EXPECT_TRUE(recordController->startHistoryReport(RecordQuery()));
+    ASSERT_TRUE(finishedSpy.wait(5000));
+    EXPECT_EQ(finishedSpy.count(), 1);
+
+    HistorySummary summary = recordService->summarizeHistory();
+    EXPECT_EQ(summary.sessionCount, 1);
+    EXPECT_FALSE(recordController->isHistoryReportRunning());
+}
+
+TEST_F(RecordControllerTest, CancelHistoryReportWhenIdle) {
+    recordController->cancelHistoryReport();
+    EXPECT_FALSE(recordController->isHistoryReportRunning());
+}
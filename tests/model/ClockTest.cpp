@@ -0,0 +1,57 @@
+/**
+ * @file ClockTest.cpp
+ * @brief Clock时钟接口与模拟时钟单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/Clock.h"
+
+#include <QThread>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+// ========== 系统时钟测试 ==========
+
+TEST(ClockTest, SystemClockFollowsWallTime) {
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    const qint64 now = Clock::system()->nowMSecs();
+    EXPECT_GE(now, before);
+    EXPECT_LE(now, QDateTime::currentMSecsSinceEpoch());
+    EXPECT_EQ(Clock::system(), Clock::system());
+}
+
+// ========== 模拟时钟测试 ==========
+
+TEST(ClockTest, SimulatedClockOnlyMovesWhenAdvanced) {
+    const QDateTime start(QDate(2024, 9, 1), QTime(8, 0));
+    SimulatedClock clock(start);
+    EXPECT_EQ(clock.now(), start);
+
+    QThread::msleep(5);
+    EXPECT_EQ(clock.now(), start);
+
+    clock.advance(3600 * 1000);
+    EXPECT_EQ(clock.now(), start.addSecs(3600));
+
+    clock.advance(-1000);  // 不倒退
+    EXPECT_EQ(clock.now(), start.addSecs(3600));
+
+    clock.setTime(start.addDays(120));
+    EXPECT_EQ(clock.now(), start.addDays(120));
+}
+
+TEST(ClockTest, SimulatedClockAccelerates) {
+    const QDateTime start(QDate(2024, 9, 1), QTime(8, 0));
+    SimulatedClock clock(start, 3600.0);  // 真实1秒为模拟1小时
+
+    QThread::msleep(20);
+    EXPECT_GE(clock.nowMSecs() - start.toMSecsSinceEpoch(), 20 * 3600);
+
+    clock.setSpeed(0.0);
+    const qint64 frozen = clock.nowMSecs();
+    QThread::msleep(5);
+    EXPECT_EQ(clock.nowMSecs(), frozen);
+    EXPECT_EQ(clock.speed(), 0.0);
+}
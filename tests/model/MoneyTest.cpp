@@ -0,0 +1,104 @@
+/**
+ * @file MoneyTest.cpp
+ * @brief Money定点金额类型单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/Money.h"
+
+#include <QJsonObject>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class MoneyTest : public ::testing::Test {};
+
+// ========== 构造与转换测试 ==========
+
+TEST_F(MoneyTest, DefaultIsZero) {
+    Money money;
+    EXPECT_TRUE(money.isZero());
+    EXPECT_EQ(money.cents(), 0);
+    EXPECT_EQ(money.toString(), "0.00");
+}
+
+TEST_F(MoneyTest, FromYuanRoundsToCents) {
+    EXPECT_EQ(Money::fromYuan(12.5).cents(), 1250);
+    EXPECT_EQ(Money::fromYuan(0.1 + 0.2).cents(), 30);
+    EXPECT_EQ(Money::fromYuan(1.005).cents(), 100);  // 1.005在二进制中略小于1.005
+    EXPECT_EQ(Money::fromYuan(-2.35).cents(), -235);
+    EXPECT_DOUBLE_EQ(Money::fromCents(250).toYuan(), 2.5);
+}
+
+TEST_F(MoneyTest, ToString) {
+    EXPECT_EQ(Money::fromCents(1205).toString(), "12.05");
+    EXPECT_EQ(Money::fromCents(-5).toString(), "-0.05");
+    EXPECT_EQ(Money::fromCents(100000000).toString(), "1000000.00");
+}
+
+TEST_F(MoneyTest, FromStringExact) {
+    bool ok = false;
+    EXPECT_EQ(Money::fromString("12.5", &ok), Money::fromCents(1250));
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(Money::fromString(" 3 ", &ok), Money::fromCents(300));
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(Money::fromString("-0.07", &ok), Money::fromCents(-7));
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(Money::fromString(".5", &ok), Money::fromCents(50));
+    EXPECT_TRUE(ok);
+}
+
+TEST_F(MoneyTest, FromStringRejectsInvalid) {
+    for (const char* text : {"", "-", ".", "1.234", "abc", "1.2.3", "1e3", "12元"}) {
+        bool ok = true;
+        EXPECT_TRUE(Money::fromString(text, &ok).isZero()) << text;
+        EXPECT_FALSE(ok) << text;
+    }
+}
+
+// ========== 运算测试 ==========
+
+TEST_F(MoneyTest, ArithmeticIsExact) {
+    Money total;
+    for (int i = 0; i < 1000; ++i) {
+        total += Money::fromCents(10);  // 用double累加0.1一千次会产生误差
+    }
+    EXPECT_EQ(total, Money::fromYuan(100));
+    EXPECT_EQ(total - Money::fromCents(1), Money::fromCents(9999));
+    EXPECT_EQ(-total, Money::fromCents(-10000));
+    EXPECT_EQ(Money::fromCents(25) * 4, Money::fromCents(100));
+}
+
+TEST_F(MoneyTest, Comparison) {
+    EXPECT_LT(Money::fromCents(99), Money::fromCents(100));
+    EXPECT_GT(Money::fromCents(0), Money::fromCents(-1));
+    EXPECT_TRUE(Money::fromCents(1).isPositive());
+    EXPECT_TRUE(Money::fromCents(-1).isNegative());
+}
+
+TEST_F(MoneyTest, ScaledRoundsHalfUp) {
+    const Money hourly = Money::fromCents(100);
+    EXPECT_EQ(hourly.scaled(60, 60), Money::fromCents(100));
+    EXPECT_EQ(hourly.scaled(1, 60), Money::fromCents(2));    // 1.67分
+    EXPECT_EQ(hourly.scaled(45, 60), Money::fromCents(75));
+    EXPECT_EQ(hourly.scaled(3, 200), Money::fromCents(2));   // 1.5分向上
+    EXPECT_EQ((-hourly).scaled(3, 200), Money::fromCents(-2));
+}
+
+// ========== JSON兼容测试 ==========
+
+TEST_F(MoneyTest, JsonWritesCentsAndLegacyYuan) {
+    QJsonObject json;
+    Money::fromCents(1234).writeJson(json, "balance");
+    EXPECT_EQ(json["balanceCents"].toInteger(), 1234);
+    EXPECT_DOUBLE_EQ(json["balance"].toDouble(), 12.34);
+    EXPECT_EQ(Money::fromJson(json, "balance"), Money::fromCents(1234));
+}
+
+TEST_F(MoneyTest, JsonLegacyReader) {
+    QJsonObject json;
+    json["cost"] = 1.6666666666666667;  // 旧版本按 分钟/60 直接保存的浮点费用
+    EXPECT_EQ(Money::fromJson(json, "cost"), Money::fromCents(167));
+    EXPECT_TRUE(Money::fromJson(QJsonObject(), "cost").isZero());
+}
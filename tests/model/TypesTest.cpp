@@ -123,7 +123,7 @@ TEST_F(TypesTest, LoginResultToStringUnknown) {
 // ========== 常量测试 ==========
 
 TEST_F(TypesTest, CostPerHour) {
-    EXPECT_DOUBLE_EQ(COST_PER_HOUR, 1.0);
+    EXPECT_EQ(COST_PER_HOUR, Money::fromYuan(1));
 }
 
 TEST_F(TypesTest, DefaultAdminPassword) {
@@ -141,7 +141,7 @@ TEST_F(TypesTest, DefaultStudentPassword) {
 // ========== 常量合理性测试 ==========
 
 TEST_F(TypesTest, CostPerHourIsPositive) {
-    EXPECT_GT(COST_PER_HOUR, 0.0);
+    EXPECT_TRUE(COST_PER_HOUR.isPositive());
 }
 
 TEST_F(TypesTest, MaxLoginAttemptsIsPositive) {
@@ -25,20 +25,20 @@ TEST_F(CardTest, DefaultConstructor) {
     EXPECT_TRUE(card.cardId().isEmpty());
     EXPECT_TRUE(card.name().isEmpty());
     EXPECT_TRUE(card.studentId().isEmpty());
-    EXPECT_DOUBLE_EQ(card.balance(), 0.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 0.0);
+    EXPECT_EQ(card.balance(), Money());
+    EXPECT_EQ(card.totalRecharge(), Money());
     EXPECT_EQ(card.state(), CardState::Normal);
     EXPECT_EQ(card.loginAttempts(), 0);
     EXPECT_EQ(card.password(), DEFAULT_STUDENT_PASSWORD);
 }
 
 TEST_F(CardTest, ParameterizedConstructor) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.cardId(), "C001");
     EXPECT_EQ(card.name(), "张三");
     EXPECT_EQ(card.studentId(), "B17010101");
-    EXPECT_DOUBLE_EQ(card.balance(), 100.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 100.0);
+    EXPECT_EQ(card.balance(), Money::fromYuan(100));
+    EXPECT_EQ(card.totalRecharge(), Money::fromYuan(100));
     EXPECT_EQ(card.state(), CardState::Normal);
     EXPECT_EQ(card.loginAttempts(), 0);
     EXPECT_EQ(card.password(), DEFAULT_STUDENT_PASSWORD);
@@ -49,20 +49,20 @@ TEST_F(CardTest, ParameterizedConstructorDefaultBalance) {
     EXPECT_EQ(card.cardId(), "C002");
     EXPECT_EQ(card.name(), "李四");
     EXPECT_EQ(card.studentId(), "B17010102");
-    EXPECT_DOUBLE_EQ(card.balance(), 0.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 0.0);
+    EXPECT_EQ(card.balance(), Money());
+    EXPECT_EQ(card.totalRecharge(), Money());
 }
 
 TEST_F(CardTest, ParameterizedConstructorZeroBalance) {
-    Card card("C003", "王五", "B17010103", 0.0);
-    EXPECT_DOUBLE_EQ(card.balance(), 0.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 0.0);
+    Card card("C003", "王五", "B17010103", Money());
+    EXPECT_EQ(card.balance(), Money());
+    EXPECT_EQ(card.totalRecharge(), Money());
 }
 
 // ========== 拷贝构造和赋值测试 ==========
 
 TEST_F(CardTest, CopyConstructor) {
-    Card original("C001", "张三", "B17010101", 100.0);
+    Card original("C001", "张三", "B17010101", Money::fromYuan(100));
     original.setState(CardState::Lost);
     original.setLoginAttempts(2);
     
@@ -70,30 +70,30 @@ TEST_F(CardTest, CopyConstructor) {
     EXPECT_EQ(copy.cardId(), original.cardId());
     EXPECT_EQ(copy.name(), original.name());
     EXPECT_EQ(copy.studentId(), original.studentId());
-    EXPECT_DOUBLE_EQ(copy.balance(), original.balance());
+    EXPECT_EQ(copy.balance(), original.balance());
     EXPECT_EQ(copy.state(), original.state());
     EXPECT_EQ(copy.loginAttempts(), original.loginAttempts());
 }
 
 TEST_F(CardTest, MoveConstructor) {
-    Card original("C001", "张三", "B17010101", 100.0);
+    Card original("C001", "张三", "B17010101", Money::fromYuan(100));
     Card moved(std::move(original));
     EXPECT_EQ(moved.cardId(), "C001");
     EXPECT_EQ(moved.name(), "张三");
-    EXPECT_DOUBLE_EQ(moved.balance(), 100.0);
+    EXPECT_EQ(moved.balance(), Money::fromYuan(100));
 }
 
 TEST_F(CardTest, CopyAssignment) {
-    Card original("C001", "张三", "B17010101", 100.0);
+    Card original("C001", "张三", "B17010101", Money::fromYuan(100));
     Card copy;
     copy = original;
     EXPECT_EQ(copy.cardId(), original.cardId());
     EXPECT_EQ(copy.name(), original.name());
-    EXPECT_DOUBLE_EQ(copy.balance(), original.balance());
+    EXPECT_EQ(copy.balance(), original.balance());
 }
 
 TEST_F(CardTest, MoveAssignment) {
-    Card original("C001", "张三", "B17010101", 100.0);
+    Card original("C001", "张三", "B17010101", Money::fromYuan(100));
     Card moved;
     moved = std::move(original);
     EXPECT_EQ(moved.cardId(), "C001");
@@ -103,42 +103,42 @@ TEST_F(CardTest, MoveAssignment) {
 // ========== Getter测试 ==========
 
 TEST_F(CardTest, GetCardId) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.cardId(), "C001");
 }
 
 TEST_F(CardTest, GetName) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.name(), "张三");
 }
 
 TEST_F(CardTest, GetStudentId) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.studentId(), "B17010101");
 }
 
 TEST_F(CardTest, GetTotalRecharge) {
-    Card card("C001", "张三", "B17010101", 150.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 150.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(150));
+    EXPECT_EQ(card.totalRecharge(), Money::fromYuan(150));
 }
 
 TEST_F(CardTest, GetBalance) {
-    Card card("C001", "张三", "B17010101", 200.0);
-    EXPECT_DOUBLE_EQ(card.balance(), 200.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(200));
+    EXPECT_EQ(card.balance(), Money::fromYuan(200));
 }
 
 TEST_F(CardTest, GetState) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.state(), CardState::Normal);
 }
 
 TEST_F(CardTest, GetLoginAttempts) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.loginAttempts(), 0);
 }
 
 TEST_F(CardTest, GetPassword) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.password(), DEFAULT_STUDENT_PASSWORD);
 }
 
@@ -164,14 +164,14 @@ TEST_F(CardTest, SetStudentId) {
 
 TEST_F(CardTest, SetTotalRecharge) {
     Card card;
-    card.setTotalRecharge(500.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 500.0);
+    card.setTotalRecharge(Money::fromYuan(500));
+    EXPECT_EQ(card.totalRecharge(), Money::fromYuan(500));
 }
 
 TEST_F(CardTest, SetBalance) {
     Card card;
-    card.setBalance(300.0);
-    EXPECT_DOUBLE_EQ(card.balance(), 300.0);
+    card.setBalance(Money::fromYuan(300));
+    EXPECT_EQ(card.balance(), Money::fromYuan(300));
 }
 
 TEST_F(CardTest, SetPassword) {
@@ -199,45 +199,45 @@ TEST_F(CardTest, SetLoginAttempts) {
 // ========== 状态检查方法测试 ==========
 
 TEST_F(CardTest, IsUsableNormal) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_TRUE(card.isUsable());
 }
 
 TEST_F(CardTest, IsUsableLost) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     card.setState(CardState::Lost);
     EXPECT_FALSE(card.isUsable());
 }
 
 TEST_F(CardTest, IsUsableFrozen) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     card.setState(CardState::Frozen);
     EXPECT_FALSE(card.isUsable());
 }
 
 TEST_F(CardTest, IsNormal) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_TRUE(card.isNormal());
     card.setState(CardState::Lost);
     EXPECT_FALSE(card.isNormal());
 }
 
 TEST_F(CardTest, IsLost) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_FALSE(card.isLost());
     card.setState(CardState::Lost);
     EXPECT_TRUE(card.isLost());
 }
 
 TEST_F(CardTest, IsFrozen) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_FALSE(card.isFrozen());
     card.setState(CardState::Frozen);
     EXPECT_TRUE(card.isFrozen());
 }
 
 TEST_F(CardTest, HasReachedMaxLoginAttempts) {
-    Card card("C001", "张三", "B17010101", 100.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_FALSE(card.hasReachedMaxLoginAttempts());
     
     card.setLoginAttempts(1);
@@ -256,8 +256,8 @@ TEST_F(CardTest, HasReachedMaxLoginAttempts) {
 // ========== JSON序列化测试 ==========
 
 TEST_F(CardTest, ToJson) {
-    Card card("C001", "张三", "B17010101", 100.0);
-    card.setTotalRecharge(150.0);
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
+    card.setTotalRecharge(Money::fromYuan(150));
     card.setState(CardState::Normal);
     card.setLoginAttempts(1);
     card.setPassword("testpass");
@@ -269,6 +269,8 @@ TEST_F(CardTest, ToJson) {
     EXPECT_EQ(json["studentId"].toString(), "B17010101");
     EXPECT_DOUBLE_EQ(json["balance"].toDouble(), 100.0);
     EXPECT_DOUBLE_EQ(json["totalRecharge"].toDouble(), 150.0);
+    EXPECT_EQ(json["balanceCents"].toInteger(), 10000);
+    EXPECT_EQ(json["totalRechargeCents"].toInteger(), 15000);
     EXPECT_EQ(json["state"].toInt(), static_cast<int>(CardState::Normal));
     EXPECT_EQ(json["loginAttempts"].toInt(), 1);
     EXPECT_EQ(json["password"].toString(), "testpass");
@@ -290,8 +292,8 @@ TEST_F(CardTest, FromJson) {
     EXPECT_EQ(card.cardId(), "C002");
     EXPECT_EQ(card.name(), "李四");
     EXPECT_EQ(card.studentId(), "B17010102");
-    EXPECT_DOUBLE_EQ(card.balance(), 200.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 250.0);
+    EXPECT_EQ(card.balance(), Money::fromYuan(200));
+    EXPECT_EQ(card.totalRecharge(), Money::fromYuan(250));
     EXPECT_EQ(card.state(), CardState::Lost);
     EXPECT_EQ(card.loginAttempts(), 2);
     EXPECT_EQ(card.password(), "pass123");
@@ -313,11 +315,12 @@ TEST_F(CardTest, FromJsonDefaultPassword) {
 }
 
 TEST_F(CardTest, JsonRoundTrip) {
-    Card original("C001", "张三", "B17010101", 100.0);
+    Card original("C001", "张三", "B17010101", Money::fromYuan(100));
     original.setState(CardState::Frozen);
     original.setLoginAttempts(2);
     original.setPassword("mypassword");
-    original.setTotalRecharge(200.0);
+    original.setTotalRecharge(Money::fromYuan(200));
+    original.setJournalSequence(42);
     
     QJsonObject json = original.toJson();
     Card restored = Card::fromJson(json);
@@ -325,11 +328,35 @@ TEST_F(CardTest, JsonRoundTrip) {
     EXPECT_EQ(restored.cardId(), original.cardId());
     EXPECT_EQ(restored.name(), original.name());
     EXPECT_EQ(restored.studentId(), original.studentId());
-    EXPECT_DOUBLE_EQ(restored.balance(), original.balance());
-    EXPECT_DOUBLE_EQ(restored.totalRecharge(), original.totalRecharge());
+    EXPECT_EQ(restored.balance(), original.balance());
+    EXPECT_EQ(restored.totalRecharge(), original.totalRecharge());
     EXPECT_EQ(restored.state(), original.state());
     EXPECT_EQ(restored.loginAttempts(), original.loginAttempts());
     EXPECT_EQ(restored.password(), original.password());
+    EXPECT_EQ(restored.journalSequence(), 42u);
+}
+
+TEST_F(CardTest, StateChangedAtRoundTrip) {
+    Card card("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(card.stateChangedAt().isValid());
+    EXPECT_FALSE(card.toJson().contains("stateChangedAt"));  // 未知时不写入
+    
+    const QDateTime changedAt(QDate(2024, 9, 1), QTime(8, 0));
+    card.setStateChangedAt(changedAt);
+    Card restored = Card::fromJson(card.toJson());
+    EXPECT_EQ(restored.stateChangedAt(), changedAt);
+}
+
+TEST_F(CardTest, FromJsonCentsPreferred) {
+    QJsonObject json;
+    json["cardId"] = "C004";
+    json["balance"] = 10.1;
+    json["balanceCents"] = 1010;
+    json["totalRecharge"] = 0.1 + 0.2;  // 旧文件只有浮点字段，按分四舍五入
+    
+    Card card = Card::fromJson(json);
+    EXPECT_EQ(card.balance(), Money::fromCents(1010));
+    EXPECT_EQ(card.totalRecharge(), Money::fromCents(30));
 }
 
 TEST_F(CardTest, FromJsonEmptyObject) {
@@ -339,8 +366,8 @@ TEST_F(CardTest, FromJsonEmptyObject) {
     EXPECT_TRUE(card.cardId().isEmpty());
     EXPECT_TRUE(card.name().isEmpty());
     EXPECT_TRUE(card.studentId().isEmpty());
-    EXPECT_DOUBLE_EQ(card.balance(), 0.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 0.0);
+    EXPECT_EQ(card.balance(), Money());
+    EXPECT_EQ(card.totalRecharge(), Money());
     EXPECT_EQ(card.state(), CardState::Normal);
     EXPECT_EQ(card.loginAttempts(), 0);
 }
@@ -349,28 +376,28 @@ TEST_F(CardTest, FromJsonEmptyObject) {
 
 TEST_F(CardTest, NegativeBalance) {
     Card card;
-    card.setBalance(-100.0);
-    EXPECT_DOUBLE_EQ(card.balance(), -100.0);
+    card.setBalance(Money::fromYuan(-100));
+    EXPECT_EQ(card.balance(), Money::fromYuan(-100));
 }
 
 TEST_F(CardTest, VeryLargeBalance) {
     Card card;
-    card.setBalance(1e12);
-    EXPECT_DOUBLE_EQ(card.balance(), 1e12);
+    card.setBalance(Money::fromYuan(1e12));
+    EXPECT_EQ(card.balance(), Money::fromYuan(1e12));
 }
 
 TEST_F(CardTest, SpecialCharactersInName) {
-    Card card("C001", "张@三#$", "B17010101", 100.0);
+    Card card("C001", "张@三#$", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.name(), "张@三#$");
 }
 
 TEST_F(CardTest, UnicodeInName) {
-    Card card("C001", "日本語テスト", "B17010101", 100.0);
+    Card card("C001", "日本語テスト", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(card.name(), "日本語テスト");
 }
 
 TEST_F(CardTest, EmptyCardId) {
-    Card card("", "张三", "B17010101", 100.0);
+    Card card("", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_TRUE(card.cardId().isEmpty());
 }
 
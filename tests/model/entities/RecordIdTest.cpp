@@ -0,0 +1,118 @@
+/**
+ * @file RecordIdTest.cpp
+ * @brief RecordId记录ID及生成器单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/entities/RecordId.h"
+
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QThread>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace CampusCard;
+
+class RecordIdTest : public ::testing::Test {
+protected:
+    RecordIdGenerator generator{3};
+};
+
+// ========== 格式与解析测试 ==========
+
+TEST_F(RecordIdTest, NullId) {
+    RecordId id;
+    EXPECT_TRUE(id.isNull());
+    EXPECT_FALSE(id.isNumeric());
+    EXPECT_TRUE(id.toString().isEmpty());
+    EXPECT_TRUE(RecordId::fromString("").isNull());
+}
+
+TEST_F(RecordIdTest, ComposeAndDecompose) {
+    RecordId id = RecordId::compose(1000, 5, 7);
+    EXPECT_EQ(id.node(), 5);
+    EXPECT_EQ(id.sequence(), 7);
+    EXPECT_EQ(id.timestamp().toMSecsSinceEpoch(), RecordId::EPOCH_MSECS + 1000);
+}
+
+TEST_F(RecordIdTest, NumericTextRoundTrip) {
+    RecordId id = generator.next();
+    RecordId parsed = RecordId::fromString(id.toString());
+    EXPECT_TRUE(parsed.isNumeric());
+    EXPECT_EQ(parsed, id);
+    EXPECT_EQ(parsed.node(), 3);
+}
+
+TEST_F(RecordIdTest, LegacyTextPreserved) {
+    const QString uuid = "3f2504e0-4f89-11d3-9a0c-0305e82c3301";
+    for (const QString& text : {uuid, QString("R001"), QString("00123"), QString(" 123")}) {
+        RecordId id = RecordId::fromString(text);
+        EXPECT_FALSE(id.isNumeric()) << text.toStdString();
+        EXPECT_FALSE(id.isNull());
+        EXPECT_EQ(id.toString(), text);
+        EXPECT_FALSE(id.timestamp().isValid());
+    }
+}
+
+TEST_F(RecordIdTest, LegacyIdsSortBeforeNumeric) {
+    RecordId legacy = RecordId::fromString("ffffffff-0000-0000-0000-000000000000");
+    RecordId numeric = generator.next();
+    EXPECT_TRUE(legacy < numeric);
+    EXPECT_FALSE(numeric < legacy);
+    EXPECT_TRUE(RecordId::fromString("A") < RecordId::fromString("B"));
+}
+
+// ========== 生成器测试 ==========
+
+TEST_F(RecordIdTest, StrictlyIncreasing) {
+    RecordId previous = generator.next();
+    for (int i = 0; i < 20000; ++i) {  // 超过单毫秒4096个序列号，覆盖进位
+        RecordId current = generator.next();
+        ASSERT_TRUE(previous < current);
+        previous = current;
+    }
+}
+
+TEST_F(RecordIdTest, TimestampTracksClock) {
+    QDateTime before = QDateTime::currentDateTime();
+    RecordId id = generator.next();
+    EXPECT_GE(id.timestamp().toMSecsSinceEpoch(), before.toMSecsSinceEpoch());
+    EXPECT_TRUE(RecordId::minimumAt(before) < id);
+    EXPECT_TRUE(id < RecordId::minimumAt(before.addSecs(60)));
+}
+
+TEST_F(RecordIdTest, ConcurrentGenerationIsUnique) {
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 10000;
+    QMutex mutex;
+    QList<quint64> all;
+
+    QList<QThread*> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.append(QThread::create([this, &mutex, &all]() {
+            QList<quint64> local;
+            local.reserve(PER_THREAD);
+            for (int i = 0; i < PER_THREAD; ++i) {
+                local.append(generator.next().value());
+            }
+            // 每个线程内部观察到的ID也是递增的
+            EXPECT_TRUE(std::is_sorted(local.cbegin(), local.cend()));
+            QMutexLocker locker(&mutex);
+            all.append(local);
+        }));
+    }
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    ASSERT_EQ(all.size(), THREADS * PER_THREAD);
+    EXPECT_EQ(QSet<quint64>(all.cbegin(), all.cend()).size(), all.size());
+}
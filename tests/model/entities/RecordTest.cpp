@@ -29,7 +29,7 @@ TEST_F(RecordTest, DefaultConstructor) {
     EXPECT_FALSE(record.startTime().isValid());
     EXPECT_FALSE(record.endTime().isValid());
     EXPECT_EQ(record.durationMinutes(), 0);
-    EXPECT_DOUBLE_EQ(record.cost(), 0.0);
+    EXPECT_EQ(record.cost(), Money());
     EXPECT_EQ(record.state(), SessionState::Offline);
     EXPECT_TRUE(record.location().isEmpty());
 }
@@ -123,8 +123,8 @@ TEST_F(RecordTest, GetDurationMinutes) {
 
 TEST_F(RecordTest, GetCost) {
     Record record;
-    record.setCost(1.5);
-    EXPECT_DOUBLE_EQ(record.cost(), 1.5);
+    record.setCost(Money::fromYuan(1.5));
+    EXPECT_EQ(record.cost(), Money::fromYuan(1.5));
 }
 
 TEST_F(RecordTest, GetState) {
@@ -183,8 +183,8 @@ TEST_F(RecordTest, SetDurationMinutes) {
 
 TEST_F(RecordTest, SetCost) {
     Record record;
-    record.setCost(2.5);
-    EXPECT_DOUBLE_EQ(record.cost(), 2.5);
+    record.setCost(Money::fromYuan(2.5));
+    EXPECT_EQ(record.cost(), Money::fromYuan(2.5));
 }
 
 TEST_F(RecordTest, SetState) {
@@ -242,7 +242,7 @@ TEST_F(RecordTest, ToJson) {
     record.setStartTime(startTime);
     record.setEndTime(endTime);
     record.setDurationMinutes(60);
-    record.setCost(1.0);
+    record.setCost(Money::fromYuan(1));
     record.setState(SessionState::Offline);
     record.setLocation("机房A101");
     
@@ -253,6 +253,7 @@ TEST_F(RecordTest, ToJson) {
     EXPECT_EQ(json["date"].toString(), "2024-01-15");
     EXPECT_EQ(json["durationMinutes"].toInt(), 60);
     EXPECT_DOUBLE_EQ(json["cost"].toDouble(), 1.0);
+    EXPECT_EQ(json["costCents"].toInteger(), 100);
     EXPECT_EQ(json["state"].toInt(), static_cast<int>(SessionState::Offline));
     EXPECT_EQ(json["location"].toString(), "机房A101");
 }
@@ -275,7 +276,7 @@ TEST_F(RecordTest, FromJson) {
     EXPECT_EQ(record.cardId(), "C002");
     EXPECT_EQ(record.date(), "2024-02-20");
     EXPECT_EQ(record.durationMinutes(), 150);
-    EXPECT_DOUBLE_EQ(record.cost(), 2.5);
+    EXPECT_EQ(record.cost(), Money::fromYuan(2.5));
     EXPECT_EQ(record.state(), SessionState::Offline);
     EXPECT_EQ(record.location(), "机房B202");
 }
@@ -289,7 +290,7 @@ TEST_F(RecordTest, JsonRoundTrip) {
     original.setStartTime(startTime);
     original.setEndTime(endTime);
     original.setDurationMinutes(90);
-    original.setCost(1.5);
+    original.setCost(Money::fromYuan(1.5));
     original.setState(SessionState::Offline);
     original.setLocation("实验楼C301");
     
@@ -300,11 +301,42 @@ TEST_F(RecordTest, JsonRoundTrip) {
     EXPECT_EQ(restored.cardId(), original.cardId());
     EXPECT_EQ(restored.date(), original.date());
     EXPECT_EQ(restored.durationMinutes(), original.durationMinutes());
-    EXPECT_DOUBLE_EQ(restored.cost(), original.cost());
+    EXPECT_EQ(restored.cost(), original.cost());
     EXPECT_EQ(restored.state(), original.state());
     EXPECT_EQ(restored.location(), original.location());
 }
 
+TEST_F(RecordTest, NumericIdJsonRoundTrip) {
+    Record original;
+    original.setId(RecordId::compose(123456789, 1, 42));
+
+    QJsonObject json = original.toJson();
+    EXPECT_EQ(json["recordId"].toString(), QString::number(original.id().value()));
+
+    Record restored = Record::fromJson(json);
+    EXPECT_TRUE(restored.id().isNumeric());
+    EXPECT_EQ(restored.id(), original.id());
+}
+
+TEST_F(RecordTest, LegacyUuidIdKept) {
+    QJsonObject json;
+    json["recordId"] = "3f2504e0-4f89-11d3-9a0c-0305e82c3301";
+    Record record = Record::fromJson(json);
+    EXPECT_TRUE(record.isValid());
+    EXPECT_FALSE(record.id().isNumeric());
+    EXPECT_EQ(record.toJson()["recordId"].toString(), json["recordId"].toString());
+}
+
+TEST_F(RecordTest, CostCentsPreferredOverLegacyCost) {
+    QJsonObject json;
+    json["recordId"] = "R004";
+    json["cost"] = 0.30000000000000004;  // 旧文件中累加产生的浮点误差
+    EXPECT_EQ(Record::fromJson(json).cost(), Money::fromCents(30));
+
+    json["costCents"] = 35;
+    EXPECT_EQ(Record::fromJson(json).cost(), Money::fromCents(35));
+}
+
 TEST_F(RecordTest, FromJsonEmptyObject) {
     QJsonObject json;
     Record record = Record::fromJson(json);
@@ -313,7 +345,7 @@ TEST_F(RecordTest, FromJsonEmptyObject) {
     EXPECT_TRUE(record.cardId().isEmpty());
     EXPECT_TRUE(record.date().isEmpty());
     EXPECT_EQ(record.durationMinutes(), 0);
-    EXPECT_DOUBLE_EQ(record.cost(), 0.0);
+    EXPECT_EQ(record.cost(), Money());
     EXPECT_EQ(record.state(), SessionState::Offline);
     EXPECT_TRUE(record.location().isEmpty());
 }
@@ -340,14 +372,14 @@ TEST_F(RecordTest, VeryLargeDuration) {
 
 TEST_F(RecordTest, ZeroCost) {
     Record record;
-    record.setCost(0.0);
-    EXPECT_DOUBLE_EQ(record.cost(), 0.0);
+    record.setCost(Money());
+    EXPECT_EQ(record.cost(), Money());
 }
 
 TEST_F(RecordTest, NegativeCost) {
     Record record;
-    record.setCost(-5.0);
-    EXPECT_DOUBLE_EQ(record.cost(), -5.0);
+    record.setCost(Money::fromYuan(-5));
+    EXPECT_EQ(record.cost(), Money::fromYuan(-5));
 }
 
 TEST_F(RecordTest, SpecialCharactersInLocation) {
@@ -34,7 +34,7 @@ protected:
     }
 
     Card createTestCard(const QString& cardId, const QString& name, const QString& studentId,
-                        double balance = 100.0) {
+                        Money balance = Money::fromYuan(100)) {
         return Card(cardId, name, studentId, balance);
     }
 
@@ -46,7 +46,7 @@ protected:
         record.setStartTime(QDateTime::currentDateTime().addSecs(-3600));
         record.setEndTime(QDateTime::currentDateTime());
         record.setDurationMinutes(60);
-        record.setCost(1.0);
+        record.setCost(Money::fromYuan(1));
         record.setState(SessionState::Offline);
         return record;
     }
@@ -109,9 +109,9 @@ TEST_F(StorageManagerTest, SaveAndLoadAllCards) {
     StorageManager::instance().initializeDataDirectory();
 
     QList<Card> cardsToSave;
-    cardsToSave.append(createTestCard("C001", "张三", "B17010101", 100.0));
-    cardsToSave.append(createTestCard("C002", "李四", "B17010102", 200.0));
-    cardsToSave.append(createTestCard("C003", "王五", "B17010103", 300.0));
+    cardsToSave.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
+    cardsToSave.append(createTestCard("C002", "李四", "B17010102", Money::fromYuan(200)));
+    cardsToSave.append(createTestCard("C003", "王五", "B17010103", Money::fromYuan(300)));
 
     EXPECT_TRUE(StorageManager::instance().saveAllCards(cardsToSave));
 
@@ -133,8 +133,8 @@ TEST_F(StorageManagerTest, LoadCard) {
     StorageManager::instance().initializeDataDirectory();
 
     QList<Card> cardsToSave;
-    cardsToSave.append(createTestCard("C001", "张三", "B17010101", 100.0));
-    cardsToSave.append(createTestCard("C002", "李四", "B17010102", 200.0));
+    cardsToSave.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
+    cardsToSave.append(createTestCard("C002", "李四", "B17010102", Money::fromYuan(200)));
     StorageManager::instance().saveAllCards(cardsToSave);
 
     Card card = StorageManager::instance().loadCard("C001");
@@ -146,7 +146,7 @@ TEST_F(StorageManagerTest, LoadCardNotFound) {
     StorageManager::instance().initializeDataDirectory();
 
     QList<Card> cardsToSave;
-    cardsToSave.append(createTestCard("C001", "张三", "B17010101", 100.0));
+    cardsToSave.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
     StorageManager::instance().saveAllCards(cardsToSave);
 
     Card card = StorageManager::instance().loadCard("C999");
@@ -158,12 +158,12 @@ TEST_F(StorageManagerTest, SaveAllCardsOverwrite) {
 
     // 第一次保存
     QList<Card> cards1;
-    cards1.append(createTestCard("C001", "张三", "B17010101", 100.0));
+    cards1.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
     StorageManager::instance().saveAllCards(cards1);
 
     // 第二次保存（覆盖）
     QList<Card> cards2;
-    cards2.append(createTestCard("C002", "李四", "B17010102", 200.0));
+    cards2.append(createTestCard("C002", "李四", "B17010102", Money::fromYuan(200)));
     StorageManager::instance().saveAllCards(cards2);
 
     QList<Card> loadedCards = StorageManager::instance().loadAllCards();
@@ -228,13 +228,13 @@ TEST_F(StorageManagerTest, UpdateRecord) {
     StorageManager::instance().saveRecords(studentId, records);
 
     // 更新记录
-    record.setCost(5.0);
+    record.setCost(Money::fromYuan(5));
     record.setDurationMinutes(300);
     EXPECT_TRUE(StorageManager::instance().updateRecord(studentId, record));
 
     QList<Record> loadedRecords = StorageManager::instance().loadRecords(studentId);
     EXPECT_EQ(loadedRecords.size(), 1);
-    EXPECT_DOUBLE_EQ(loadedRecords[0].cost(), 5.0);
+    EXPECT_EQ(loadedRecords[0].cost(), Money::fromYuan(5));
     EXPECT_EQ(loadedRecords[0].durationMinutes(), 300);
 }
 
@@ -274,6 +274,22 @@ TEST_F(StorageManagerTest, LoadAllRecords) {
     EXPECT_EQ(allRecords["B17010102"].size(), 2);
 }
 
+// ========== 每日汇总测试 ==========
+
+TEST_F(StorageManagerTest, SaveAndLoadRollups) {
+    QJsonObject rollup;
+    rollup["distinctUsers"] = QJsonObject{{"机房A101", "UwAAAQ=="}};
+    EXPECT_TRUE(StorageManager::instance().saveRollup("2024-09-02", rollup));
+    EXPECT_TRUE(StorageManager::instance().saveRollup("2024-09-03", QJsonObject()));
+
+    QMap<QString, QJsonObject> loaded = StorageManager::instance().loadAllRollups();
+    ASSERT_EQ(loaded.size(), 2);
+    EXPECT_EQ(loaded.value("2024-09-02"), rollup);
+
+    EXPECT_TRUE(StorageManager::instance().clearRollups());
+    EXPECT_TRUE(StorageManager::instance().loadAllRollups().isEmpty());
+}
+
 // ========== 管理员密码测试 ==========
 
 TEST_F(StorageManagerTest, SaveAndLoadAdminPassword) {
@@ -296,6 +312,26 @@ TEST_F(StorageManagerTest, LoadAdminPasswordDefault) {
     EXPECT_EQ(password, DEFAULT_ADMIN_PASSWORD);
 }
 
+// ========== 计费规则测试 ==========
+
+TEST_F(StorageManagerTest, SaveAndLoadTariff) {
+    StorageManager::instance().initializeDataDirectory();
+    EXPECT_TRUE(StorageManager::instance().loadTariff().isEmpty());
+
+    QJsonObject tariff;
+    tariff["hourlyRateCents"] = 150;
+    EXPECT_TRUE(StorageManager::instance().saveTariff(tariff));
+    EXPECT_EQ(StorageManager::instance().loadTariff()["hourlyRateCents"].toInt(), 150);
+
+    // 导出后以覆盖模式导入，规则随数据一起恢复
+    QString exportPath = testDataPath + "/export.txt";
+    ASSERT_TRUE(StorageManager::instance().exportAllData(exportPath));
+    QFile::remove(testDataPath + "/tariff.txt");
+    EXPECT_TRUE(StorageManager::instance().loadTariff().isEmpty());
+    EXPECT_TRUE(StorageManager::instance().importData(exportPath, false));
+    EXPECT_EQ(StorageManager::instance().loadTariff()["hourlyRateCents"].toInt(), 150);
+}
+
 // ========== 导入导出测试 ==========
 
 TEST_F(StorageManagerTest, ExportAllData) {
@@ -303,7 +339,7 @@ TEST_F(StorageManagerTest, ExportAllData) {
 
     // 准备测试数据
     QList<Card> cards;
-    cards.append(createTestCard("C001", "张三", "B17010101", 100.0));
+    cards.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
     StorageManager::instance().saveAllCards(cards);
 
     // 使用学号作为记录文件名
@@ -324,7 +360,7 @@ TEST_F(StorageManagerTest, ImportDataOverwrite) {
 
     // 先创建一些数据
     QList<Card> originalCards;
-    originalCards.append(createTestCard("C001", "张三", "B17010101", 100.0));
+    originalCards.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
     StorageManager::instance().saveAllCards(originalCards);
 
     // 导出
@@ -333,7 +369,7 @@ TEST_F(StorageManagerTest, ImportDataOverwrite) {
 
     // 修改数据
     QList<Card> newCards;
-    newCards.append(createTestCard("C002", "李四", "B17010102", 200.0));
+    newCards.append(createTestCard("C002", "李四", "B17010102", Money::fromYuan(200)));
     StorageManager::instance().saveAllCards(newCards);
 
     // 导入（覆盖模式）
@@ -349,7 +385,7 @@ TEST_F(StorageManagerTest, ImportDataMerge) {
 
     // 先创建一些数据
     QList<Card> originalCards;
-    originalCards.append(createTestCard("C001", "张三", "B17010101", 100.0));
+    originalCards.append(createTestCard("C001", "张三", "B17010101", Money::fromYuan(100)));
     StorageManager::instance().saveAllCards(originalCards);
 
     // 导出
@@ -358,7 +394,7 @@ TEST_F(StorageManagerTest, ImportDataMerge) {
 
     // 添加新数据
     QList<Card> newCards;
-    newCards.append(createTestCard("C002", "李四", "B17010102", 200.0));
+    newCards.append(createTestCard("C002", "李四", "B17010102", Money::fromYuan(200)));
     StorageManager::instance().saveAllCards(newCards);
 
     // 导入（合并模式）
@@ -415,7 +451,7 @@ TEST_F(StorageManagerTest, CardWithSpecialCharactersInId) {
 
     // 注意：某些特殊字符可能不适合作为文件名的一部分
     QList<Card> cards;
-    cards.append(createTestCard("C-001", "张三", "B17010101", 100.0));
+    cards.append(createTestCard("C-001", "张三", "B17010101", Money::fromYuan(100)));
     EXPECT_TRUE(StorageManager::instance().saveAllCards(cards));
 
     QList<Card> loadedCards = StorageManager::instance().loadAllCards();
@@ -48,7 +48,7 @@ protected:
 // ========== 学生登录测试 ==========
 
 TEST_F(AuthServiceTest, StudentLoginSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     LoginResult result = authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_EQ(result, LoginResult::Success);
@@ -58,7 +58,7 @@ TEST_F(AuthServiceTest, StudentLoginSuccess) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginSuccessSignals) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy successSpy(authService, &AuthService::loginSucceeded);
 
@@ -75,7 +75,7 @@ TEST_F(AuthServiceTest, StudentLoginCardNotFound) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginInvalidPassword) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     LoginResult result = authService->studentLogin("C001", "wrongpassword");
     EXPECT_EQ(result, LoginResult::InvalidCredentials);
@@ -83,7 +83,7 @@ TEST_F(AuthServiceTest, StudentLoginInvalidPassword) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginPasswordErrorSignals) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy errorSpy(authService, &AuthService::passwordError);
 
@@ -93,7 +93,7 @@ TEST_F(AuthServiceTest, StudentLoginPasswordErrorSignals) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginCardLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
     LoginResult result = authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
@@ -102,7 +102,7 @@ TEST_F(AuthServiceTest, StudentLoginCardLost) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginCardFrozen) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->freeze("C001");
 
     LoginResult result = authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
@@ -111,7 +111,7 @@ TEST_F(AuthServiceTest, StudentLoginCardFrozen) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginAlreadyLoggedIn) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
@@ -120,7 +120,7 @@ TEST_F(AuthServiceTest, StudentLoginAlreadyLoggedIn) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginMaxAttemptsFreeze) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy frozenSpy(authService, &AuthService::cardFrozen);
 
@@ -136,7 +136,7 @@ TEST_F(AuthServiceTest, StudentLoginMaxAttemptsFreeze) {
 }
 
 TEST_F(AuthServiceTest, StudentLoginResetsAttemptsOnSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     // 先失败两次
     authService->studentLogin("C001", "wrong1");
@@ -186,7 +186,7 @@ TEST_F(AuthServiceTest, AdminLoginAlreadyLoggedIn) {
 // ========== 登出测试 ==========
 
 TEST_F(AuthServiceTest, Logout) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
     authService->logout();
@@ -196,7 +196,7 @@ TEST_F(AuthServiceTest, Logout) {
 }
 
 TEST_F(AuthServiceTest, LogoutSignals) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
     QSignalSpy logoutSpy(authService, &AuthService::loggedOut);
@@ -219,7 +219,7 @@ TEST_F(AuthServiceTest, LogoutWhenNotLoggedIn) {
 TEST_F(AuthServiceTest, IsLoggedIn) {
     EXPECT_FALSE(authService->isLoggedIn());
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
     EXPECT_TRUE(authService->isLoggedIn());
@@ -228,7 +228,7 @@ TEST_F(AuthServiceTest, IsLoggedIn) {
 TEST_F(AuthServiceTest, CurrentUser) {
     EXPECT_FALSE(authService->currentUser().has_value());
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
 
     auto user = authService->currentUser();
@@ -238,7 +238,7 @@ TEST_F(AuthServiceTest, CurrentUser) {
 }
 
 TEST_F(AuthServiceTest, CurrentRole) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_EQ(authService->currentRole(), UserRole::Student);
@@ -249,7 +249,7 @@ TEST_F(AuthServiceTest, CurrentRole) {
 }
 
 TEST_F(AuthServiceTest, CurrentCardId) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_EQ(authService->currentCardId(), "C001");
@@ -269,7 +269,7 @@ TEST_F(AuthServiceTest, IsAdmin) {
 TEST_F(AuthServiceTest, IsStudent) {
     EXPECT_FALSE(authService->isStudent());
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     authService->studentLogin("C001", DEFAULT_STUDENT_PASSWORD);
     EXPECT_TRUE(authService->isStudent());
 }
@@ -303,7 +303,7 @@ TEST_F(AuthServiceTest, GetAdminPassword) {
 // ========== 卡状态检查测试 ==========
 
 TEST_F(AuthServiceTest, CheckCardLoginStatusSuccess) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     LoginResult result = authService->checkCardLoginStatus("C001");
     EXPECT_EQ(result, LoginResult::Success);
@@ -315,7 +315,7 @@ TEST_F(AuthServiceTest, CheckCardLoginStatusNotFound) {
 }
 
 TEST_F(AuthServiceTest, CheckCardLoginStatusLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
     LoginResult result = authService->checkCardLoginStatus("C001");
@@ -323,7 +323,7 @@ TEST_F(AuthServiceTest, CheckCardLoginStatusLost) {
 }
 
 TEST_F(AuthServiceTest, CheckCardLoginStatusFrozen) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->freeze("C001");
 
     LoginResult result = authService->checkCardLoginStatus("C001");
@@ -331,7 +331,7 @@ TEST_F(AuthServiceTest, CheckCardLoginStatusFrozen) {
 }
 
 TEST_F(AuthServiceTest, GetRemainingLoginAttempts) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(authService->getRemainingLoginAttempts("C001"), MAX_LOGIN_ATTEMPTS);
 
@@ -0,0 +1,204 @@
+/**
+ * @file BalanceLedgerTest.cpp
+ * @brief BalanceLedger余额流水单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/BalanceLedger.h"
+
+#include <QThreadPool>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class BalanceLedgerTest : public ::testing::Test {
+protected:
+    SimulatedClock clock{QDateTime(QDate(2024, 9, 1), QTime(9, 0))};
+    BalanceLedger ledger;
+
+    void SetUp() override { ledger.setClock(&clock); }
+
+    static Card card(const QString& cardId, Money balance) {
+        return Card(cardId, QStringLiteral("张三"), QStringLiteral("B17010101"), balance);
+    }
+};
+
+// ========== 记账 ==========
+
+TEST_F(BalanceLedgerTest, AppendChainsBalances) {
+    EXPECT_TRUE(ledger.append("C001", LedgerEntryType::Opening, Money::fromYuan(100)));
+    EXPECT_TRUE(ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(3)));
+    EXPECT_TRUE(ledger.append("C002", LedgerEntryType::Recharge, Money::fromYuan(20)));
+    EXPECT_TRUE(ledger.append("C001", LedgerEntryType::Recharge, Money::fromYuan(50)));
+
+    const QList<LedgerEntry> statement = ledger.statement("C001");
+    ASSERT_EQ(statement.size(), 3);
+    EXPECT_EQ(statement[0].sequence, 1u);
+    EXPECT_EQ(statement[1].sequence, 2u);
+    EXPECT_EQ(statement[2].sequence, 4u);
+    EXPECT_EQ(statement[1].type, LedgerEntryType::Charge);
+    EXPECT_EQ(statement[1].balance, Money::fromYuan(97));
+    EXPECT_EQ(statement[2].balance, Money::fromYuan(147));
+
+    EXPECT_EQ(ledger.balance("C001"), Money::fromYuan(147));
+    EXPECT_EQ(ledger.balance("C002"), Money::fromYuan(20));
+    EXPECT_EQ(ledger.balance("C999"), Money());
+    EXPECT_TRUE(ledger.contains("C002"));
+    EXPECT_FALSE(ledger.contains("C999"));
+    EXPECT_EQ(ledger.entryCount(), 4);
+}
+
+TEST_F(BalanceLedgerTest, JournaledChargeRecordedOnce) {
+    EXPECT_TRUE(ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(2), 7));
+    // 重放同一条或更早的日志不再记账
+    EXPECT_FALSE(ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(2), 7));
+    EXPECT_FALSE(ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(2), 5));
+    // 日志序号按卡判断，其他卡不受影响
+    EXPECT_TRUE(ledger.append("C002", LedgerEntryType::Charge, -Money::fromYuan(2), 7));
+    EXPECT_TRUE(ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(2), 8));
+
+    EXPECT_EQ(ledger.statement("C001").size(), 2);
+    EXPECT_EQ(ledger.balance("C001"), -Money::fromYuan(4));
+}
+
+TEST_F(BalanceLedgerTest, StatementFiltersByDate) {
+    ledger.append("C001", LedgerEntryType::Opening, Money::fromYuan(100));
+    clock.advance(24LL * 3600 * 1000);
+    ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(5));
+    clock.advance(24LL * 3600 * 1000);
+    ledger.append("C001", LedgerEntryType::Charge, -Money::fromYuan(6));
+
+    const QList<LedgerEntry> day2 = ledger.statement("C001", QDate(2024, 9, 2), QDate(2024, 9, 2));
+    ASSERT_EQ(day2.size(), 1);
+    EXPECT_EQ(day2.first().amount, -Money::fromYuan(5));
+    // 区间前的余额可由第一条流水推出
+    EXPECT_EQ(day2.first().balance - day2.first().amount, Money::fromYuan(100));
+
+    EXPECT_EQ(ledger.statement("C001", QDate(2024, 9, 2)).size(), 2);
+    EXPECT_EQ(ledger.statement("C001", QDate(), QDate(2024, 9, 1)).size(), 1);
+}
+
+// ========== 持久化 ==========
+
+TEST_F(BalanceLedgerTest, PendingEntriesRoundTrip) {
+    ledger.append("C001", LedgerEntryType::Opening, Money::fromYuan(100));
+    ledger.append("C001", LedgerEntryType::Charge, -Money::fromCents(250), 3);
+
+    const QList<LedgerEntry> pending = ledger.takePending();
+    ASSERT_EQ(pending.size(), 2);
+    EXPECT_TRUE(ledger.takePending().isEmpty());
+
+    QList<LedgerEntry> loaded;
+    for (const auto& entry : pending) {
+        loaded.append(LedgerEntry::fromJson(entry.toJson()));
+    }
+    EXPECT_EQ(loaded[1].amount, -Money::fromCents(250));
+    EXPECT_EQ(loaded[1].balance, Money::fromCents(9750));
+    EXPECT_EQ(loaded[1].journalSequence, 3u);
+    EXPECT_EQ(loaded[1].time, clock.now());
+
+    // 加载后序号和日志序号都从已有流水继续
+    BalanceLedger reloaded;
+    reloaded.load({loaded[1], loaded[0]});
+    EXPECT_EQ(reloaded.balance("C001"), Money::fromCents(9750));
+    EXPECT_FALSE(reloaded.append("C001", LedgerEntryType::Charge, -Money::fromYuan(1), 3));
+    EXPECT_TRUE(reloaded.append("C001", LedgerEntryType::Recharge, Money::fromYuan(1)));
+    EXPECT_EQ(reloaded.statement("C001").last().sequence, 3u);
+    EXPECT_EQ(reloaded.takePending().size(), 1);
+}
+
+TEST_F(BalanceLedgerTest, RestorePendingKeepsOrder) {
+    ledger.append("C001", LedgerEntryType::Opening, Money::fromYuan(1));
+    const QList<LedgerEntry> failed = ledger.takePending();
+    ledger.append("C001", LedgerEntryType::Recharge, Money::fromYuan(2));
+    ledger.restorePending(failed);
+
+    const QList<LedgerEntry> pending = ledger.takePending();
+    ASSERT_EQ(pending.size(), 2);
+    EXPECT_EQ(pending[0].sequence, 1u);
+    EXPECT_EQ(pending[1].sequence, 2u);
+}
+
+// ========== 对账 ==========
+
+TEST_F(BalanceLedgerTest, ReconcileCleanLedger) {
+    QList<Card> cards;
+    for (int i = 0; i < BalanceLedger::CARDS_PER_CHUNK * 2 + 3; ++i) {
+        const QString cardId = QStringLiteral("C%1").arg(i, 3, 10, QLatin1Char('0'));
+        ledger.append(cardId, LedgerEntryType::Opening, Money::fromYuan(10));
+        ledger.append(cardId, LedgerEntryType::Charge, -Money::fromCents(i));
+        cards.append(card(cardId, Money::fromYuan(10) - Money::fromCents(i)));
+    }
+    // 余额为0且没有流水的卡同样一致
+    cards.append(card("Z000", Money()));
+
+    const ReconciliationReport report = BalanceLedger::reconcile(cards, ledger.accounts());
+    EXPECT_TRUE(report.isClean());
+    EXPECT_EQ(report.cardsChecked, static_cast<int>(cards.size()));
+    EXPECT_EQ(report.entriesChecked, ledger.entryCount());
+}
+
+TEST_F(BalanceLedgerTest, ReconcileReportsMismatches) {
+    ledger.append("C001", LedgerEntryType::Opening, Money::fromYuan(10));
+    ledger.append("C002", LedgerEntryType::Opening, Money::fromYuan(10));
+    ledger.append("C003", LedgerEntryType::Opening, Money::fromYuan(10));
+    ledger.append("C003", LedgerEntryType::Charge, -Money::fromYuan(1));
+
+    QList<Card> cards;
+    cards.append(card("C001", Money::fromYuan(10)));
+    cards.append(card("C002", Money::fromYuan(12)));  // 物化余额与流水不符
+    cards.append(card("C003", Money::fromYuan(9)));
+
+    // 篡改C003的一条流水金额，余额链从该条断开；C009的流水没有对应的卡
+    QHash<QString, QList<LedgerEntry>> accounts = ledger.accounts();
+    accounts["C003"][1].amount = -Money::fromYuan(2);
+    LedgerEntry orphan;
+    orphan.sequence = 99;
+    orphan.cardId = "C009";
+    orphan.amount = Money::fromYuan(1);
+    orphan.balance = Money::fromYuan(1);
+    accounts["C009"].append(orphan);
+
+    const ReconciliationReport report = BalanceLedger::reconcile(cards, accounts);
+    ASSERT_EQ(report.mismatches.size(), 3);
+    EXPECT_EQ(report.cardsChecked, 3);
+
+    EXPECT_EQ(report.mismatches[0].cardId, "C002");
+    EXPECT_EQ(report.mismatches[0].materialized, Money::fromYuan(12));
+    EXPECT_EQ(report.mismatches[0].ledger, Money::fromYuan(10));
+    EXPECT_EQ(report.mismatches[0].brokenSequence, 0u);
+
+    EXPECT_EQ(report.mismatches[1].cardId, "C003");
+    EXPECT_EQ(report.mismatches[1].ledger, Money::fromYuan(8));
+    EXPECT_EQ(report.mismatches[1].brokenSequence, 4u);
+
+    EXPECT_EQ(report.mismatches[2].cardId, "C009");
+    EXPECT_FALSE(report.mismatches[2].cardExists);
+}
+
+TEST_F(BalanceLedgerTest, ParallelReconcileMatchesSerial) {
+    QList<Card> cards;
+    for (int i = 0; i < BalanceLedger::CARDS_PER_CHUNK * 5 + 7; ++i) {
+        const QString cardId = QStringLiteral("C%1").arg(i, 4, 10, QLatin1Char('0'));
+        ledger.append(cardId, LedgerEntryType::Opening, Money::fromYuan(50));
+        ledger.append(cardId, LedgerEntryType::Charge, -Money::fromCents(i * 3));
+        // 每七张卡中有一张物化余额被改动
+        const Money drift = (i % 7 == 0) ? Money::fromCents(1) : Money();
+        cards.append(card(cardId, Money::fromYuan(50) - Money::fromCents(i * 3) + drift));
+    }
+    const auto accounts = ledger.accounts();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    const ReconciliationReport serial = BalanceLedger::reconcile(cards, accounts);
+    ReconciliationReport parallel = BalanceLedger::reconcileAsync(cards, accounts, &pool).result();
+
+    EXPECT_EQ(parallel.cardsChecked, serial.cardsChecked);
+    EXPECT_EQ(parallel.entriesChecked, serial.entriesChecked);
+    ASSERT_EQ(parallel.mismatches.size(), serial.mismatches.size());
+    for (qsizetype i = 0; i < serial.mismatches.size(); ++i) {
+        EXPECT_EQ(parallel.mismatches[i].cardId, serial.mismatches[i].cardId);
+    }
+    EXPECT_EQ(serial.mismatches.size(), (cards.size() + 6) / 7);
+}
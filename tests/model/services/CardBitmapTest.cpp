@@ -0,0 +1,138 @@
+/**
+ * @file CardBitmapTest.cpp
+ * @brief CardBitmap卡集合位图单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/CardBitmap.h"
+
+#include <QRandomGenerator>
+#include <QSet>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace CampusCard;
+
+class CardBitmapTest : public ::testing::Test {
+protected:
+    static CardBitmap fromSet(const QSet<quint32>& values) {
+        CardBitmap bitmap;
+        for (quint32 value : values) {
+            bitmap.add(value);
+        }
+        return bitmap;
+    }
+
+    static QList<quint32> sorted(const QSet<quint32>& values) {
+        QList<quint32> list(values.cbegin(), values.cend());
+        std::sort(list.begin(), list.end());
+        return list;
+    }
+
+    /// 生成随机集合：部分块稀疏、部分块稠密，覆盖两种块表示
+    static QSet<quint32> randomSet(quint32 seed) {
+        QRandomGenerator rng(seed);
+        QSet<quint32> values;
+        for (int i = 0; i < 3000; ++i) {
+            values.insert(rng.bounded(200000u));  // 多个稀疏块
+        }
+        for (int i = 0; i < 20000; ++i) {
+            values.insert(65536u + rng.bounded(65536u));  // 一个稠密块
+        }
+        return values;
+    }
+};
+
+// ========== 基本操作测试 ==========
+
+TEST_F(CardBitmapTest, EmptyBitmap) {
+    CardBitmap bitmap;
+    EXPECT_TRUE(bitmap.isEmpty());
+    EXPECT_EQ(bitmap.cardinality(), 0);
+    EXPECT_FALSE(bitmap.contains(0));
+    EXPECT_TRUE(bitmap.values().isEmpty());
+}
+
+TEST_F(CardBitmapTest, AddAndContains) {
+    CardBitmap bitmap;
+    bitmap.add(5);
+    bitmap.add(70000);
+    bitmap.add(5);
+    bitmap.add(0);
+
+    EXPECT_EQ(bitmap.cardinality(), 3);
+    EXPECT_TRUE(bitmap.contains(0));
+    EXPECT_TRUE(bitmap.contains(5));
+    EXPECT_TRUE(bitmap.contains(70000));
+    EXPECT_FALSE(bitmap.contains(6));
+    EXPECT_EQ(bitmap.values(), QList<quint32>({0, 5, 70000}));
+}
+
+TEST_F(CardBitmapTest, DenseContainerUsesLessMemory) {
+    CardBitmap bitmap;
+    for (quint32 i = 0; i < 60000; ++i) {
+        bitmap.add(i);
+    }
+    EXPECT_EQ(bitmap.cardinality(), 60000);
+    EXPECT_TRUE(bitmap.contains(59999));
+    EXPECT_FALSE(bitmap.contains(60000));
+    // 位图块固定8KB，远小于数组形式的120KB
+    EXPECT_LT(bitmap.memoryBytes(), 10000);
+}
+
+// ========== 集合运算测试 ==========
+
+TEST_F(CardBitmapTest, SetOperationsMatchReference) {
+    QSet<quint32> a = randomSet(1);
+    QSet<quint32> b = randomSet(2);
+    CardBitmap ba = fromSet(a);
+    CardBitmap bb = fromSet(b);
+    ASSERT_EQ(ba.values(), sorted(a));
+
+    EXPECT_EQ((ba & bb).values(), sorted(QSet<quint32>(a).intersect(b)));
+    EXPECT_EQ((ba | bb).values(), sorted(QSet<quint32>(a).unite(b)));
+    EXPECT_EQ(ba.andNot(bb).values(), sorted(QSet<quint32>(a).subtract(b)));
+    EXPECT_EQ(bb.andNot(ba).values(), sorted(QSet<quint32>(b).subtract(a)));
+    EXPECT_EQ((ba & bb).cardinality(), QSet<quint32>(a).intersect(b).size());
+}
+
+TEST_F(CardBitmapTest, ResultsNormalizeRepresentation) {
+    CardBitmap dense;
+    for (quint32 i = 0; i < 10000; ++i) {
+        dense.add(i);
+    }
+    CardBitmap sparse;
+    for (quint32 i = 0; i < 10; ++i) {
+        sparse.add(i * 2);
+    }
+
+    // 稠密块求交后基数很小，结果应与直接构造的稀疏集合完全相等
+    CardBitmap intersection = dense & sparse;
+    EXPECT_EQ(intersection, sparse);
+
+    // 稠密块减去自身后为空
+    EXPECT_TRUE(dense.andNot(dense).isEmpty());
+    EXPECT_EQ(dense.andNot(sparse).cardinality(), 9990);
+}
+
+TEST_F(CardBitmapTest, UnionInPlace) {
+    CardBitmap week;
+    for (int day = 0; day < 7; ++day) {
+        CardBitmap active;
+        active.add(day);
+        active.add(100);
+        week |= active;
+    }
+    EXPECT_EQ(week.values(), QList<quint32>({0, 1, 2, 3, 4, 5, 6, 100}));
+}
+
+TEST_F(CardBitmapTest, OperationsWithEmpty) {
+    CardBitmap empty;
+    CardBitmap some = fromSet({1, 2, 3});
+    EXPECT_TRUE((some & empty).isEmpty());
+    EXPECT_EQ(some | empty, some);
+    EXPECT_EQ(some.andNot(empty), some);
+    EXPECT_TRUE(empty.andNot(some).isEmpty());
+}
@@ -0,0 +1,94 @@
+/**
+ * @file CardQueryTest.cpp
+ * @brief CardQuery组合查询单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/CardQuery.h"
+
+#include <QDateTime>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class CardQueryTest : public ::testing::Test {
+protected:
+    Card createCard(const QString& cardId, const QString& studentId,
+                    CardState state = CardState::Normal, const QDateTime& since = QDateTime()) {
+        Card card(cardId, QStringLiteral("张三"), studentId, Money::fromYuan(10));
+        card.setState(state);
+        card.setStateChangedAt(since);
+        return card;
+    }
+
+    QDateTime day(int d) { return QDateTime(QDate(2024, 9, 1), QTime(10, 0)).addDays(d); }
+};
+
+// ========== 过滤条件测试 ==========
+
+TEST_F(CardQueryTest, EmptyQueryMatchesEverything) {
+    CardQuery query;
+    EXPECT_TRUE(query.matches(createCard("C001", "B23010101"), day(0)));
+    EXPECT_TRUE(query.matches(Card(), day(0)));
+    EXPECT_FALSE(query.cardsFilter().has_value());
+    EXPECT_FALSE(query.stateFilter().has_value());
+}
+
+TEST_F(CardQueryTest, CardsFilter) {
+    CardQuery query;
+    query.cards({"C001", "C003"});
+    EXPECT_TRUE(query.matches(createCard("C001", "B23010101"), day(0)));
+    EXPECT_FALSE(query.matches(createCard("C002", "B23010102"), day(0)));
+}
+
+TEST_F(CardQueryTest, EmptyCardListMatchesNothing) {
+    CardQuery query;
+    query.cards(QStringList());
+    EXPECT_FALSE(query.matches(createCard("C001", "B23010101"), day(0)));
+}
+
+TEST_F(CardQueryTest, StudentIdPrefixIgnoresCaseAndSpaces) {
+    CardQuery query;
+    query.studentIdPrefix(" b2301 ");
+    EXPECT_TRUE(query.matches(createCard("C001", "B23010101"), day(0)));
+    EXPECT_FALSE(query.matches(createCard("C002", "B23020101"), day(0)));
+
+    query.studentIdPrefix("");
+    EXPECT_TRUE(query.matches(createCard("C002", "B23020101"), day(0)));
+}
+
+TEST_F(CardQueryTest, StateFilter) {
+    CardQuery query;
+    query.state(CardState::Frozen);
+    EXPECT_TRUE(query.matches(createCard("C001", "B23010101", CardState::Frozen), day(0)));
+    EXPECT_FALSE(query.matches(createCard("C002", "B23010102", CardState::Lost), day(0)));
+}
+
+// ========== 状态持续时间测试 ==========
+
+TEST_F(CardQueryTest, InStateForDaysIsInclusive) {
+    CardQuery query;
+    query.state(CardState::Frozen).inStateForDays(30);
+    const Card card = createCard("C001", "B23010101", CardState::Frozen, day(0));
+    EXPECT_FALSE(query.matches(card, day(29)));
+    EXPECT_TRUE(query.matches(card, day(30)));
+    EXPECT_TRUE(query.matches(card, day(45)));
+}
+
+TEST_F(CardQueryTest, UnknownStateTimeDoesNotMatchDuration) {
+    CardQuery query;
+    query.inStateForDays(1);
+    EXPECT_FALSE(query.matches(createCard("C001", "B23010101", CardState::Frozen), day(100)));
+
+    query.inStateForDays(0);
+    EXPECT_TRUE(query.matches(createCard("C001", "B23010101", CardState::Frozen), day(100)));
+}
+
+TEST_F(CardQueryTest, ConditionsCombine) {
+    CardQuery query;
+    query.cards({"C001", "C002"}).studentIdPrefix("B2301").state(CardState::Lost);
+    EXPECT_TRUE(query.matches(createCard("C001", "B23010101", CardState::Lost), day(0)));
+    EXPECT_FALSE(query.matches(createCard("C002", "B23020101", CardState::Lost), day(0)));
+    EXPECT_FALSE(query.matches(createCard("C001", "B23010101"), day(0)));
+}
@@ -0,0 +1,187 @@
+/**
+ * @file CardSearchIndexTest.cpp
+ * @brief CardSearchIndex子串搜索索引单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/CardSearchIndex.h"
+
+#include <QRandomGenerator>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace CampusCard;
+
+// ========== 匹配测试 ==========
+
+TEST(CardSearchIndexTest, MatchesAnyField) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "张三", "B17010101"));
+    index.insert(Card("C002", "李四", "B17010102"));
+
+    EXPECT_EQ(index.search("C002"), QStringList({"C002"}));
+    EXPECT_EQ(index.search("0101"), QStringList({"C001"}));
+    EXPECT_EQ(index.search("李"), QStringList({"C002"}));
+    EXPECT_EQ(index.search("B1701").size(), 2);
+    EXPECT_TRUE(index.search("王").isEmpty());
+    EXPECT_TRUE(index.search("").isEmpty());
+}
+
+TEST(CardSearchIndexTest, IgnoresCase) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "Li Lei", "B17010101"));
+
+    EXPECT_EQ(index.search("c001"), QStringList({"C001"}));
+    EXPECT_EQ(index.search("LI LEI"), QStringList({"C001"}));
+    EXPECT_EQ(index.search("b170"), QStringList({"C001"}));
+}
+
+TEST(CardSearchIndexTest, LongKeywordNeedsContiguousMatch) {
+    CardSearchIndex index;
+    // 包含关键词"abcd"的全部三字符子串，但不包含"abcd"本身
+    index.insert(Card("C001", "abcxbcd", "S1"));
+    index.insert(Card("C002", "xabcdx", "S2"));
+
+    EXPECT_EQ(index.search("abcd"), QStringList({"C002"}));
+}
+
+TEST(CardSearchIndexTest, NoMatchAcrossFields) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "张三", "B17010101"));
+
+    EXPECT_TRUE(index.search("01张").isEmpty());
+    EXPECT_TRUE(index.search("C001B").isEmpty());
+}
+
+// ========== 排序测试 ==========
+
+TEST(CardSearchIndexTest, RanksExactThenPrefixThenSubstring) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "王张三", "B1"));
+    index.insert(Card("C002", "张三丰", "B2"));
+    index.insert(Card("C003", "张三", "B3"));
+    index.insert(Card("C000", "小张三", "B0"));
+
+    EXPECT_EQ(index.search("张三"), QStringList({"C003", "C002", "C000", "C001"}));
+}
+
+TEST(CardSearchIndexTest, LimitKeepsBestResults) {
+    CardSearchIndex index;
+    for (int i = 0; i < 20; ++i) {
+        index.insert(Card(QStringLiteral("C%1").arg(i, 3, 10, QLatin1Char('0')),
+                          QStringLiteral("学生"), QStringLiteral("B%1").arg(i)));
+    }
+    index.insert(Card("X", "学", "BX"));
+
+    QStringList top = index.search("学", 3);
+    EXPECT_EQ(top, QStringList({"X", "C000", "C001"}));
+    EXPECT_TRUE(index.search("学", 0).isEmpty());
+}
+
+// ========== 拼音测试 ==========
+
+TEST(CardSearchIndexTest, MatchesPinyinPrefixAndInitials) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "张三", "B17010101"));
+    index.insert(Card("C002", "张三丰", "B17010102"));
+    index.insert(Card("C003", "赵四", "B17010103"));
+
+    EXPECT_EQ(index.search("zhangsan"), QStringList({"C001", "C002"}));
+    EXPECT_EQ(index.search("zhangs"), QStringList({"C001", "C002"}));
+    EXPECT_EQ(index.search("ZS"), QStringList({"C001", "C002"}));
+    EXPECT_EQ(index.search("zs "), QStringList({"C001", "C002"}));
+    EXPECT_EQ(index.search("zhang san"), QStringList({"C001", "C002"}));
+    EXPECT_EQ(index.search("zsf"), QStringList({"C002"}));
+    EXPECT_EQ(index.search("zh"), QStringList({"C001", "C002", "C003"}));
+    EXPECT_TRUE(index.search("zhangsi").isEmpty());
+}
+
+TEST(CardSearchIndexTest, PinyinMergedWithSubstringMatches) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "Li Lei", "B1"));
+    index.insert(Card("C002", "李雷", "B2"));
+    index.insert(Card("C003", "李磊磊", "B3"));
+
+    // "lilei"与C002的全拼完全相同，排在前缀匹配的C003之前；C001的姓名含空格不匹配
+    EXPECT_EQ(index.search("lilei"), QStringList({"C002", "C003"}));
+    EXPECT_EQ(index.search("li lei"), QStringList({"C001", "C002", "C003"}));
+}
+
+TEST(CardSearchIndexTest, PinyinFollowsRenameAndSurnameReading) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "曾国藩", "B1"));
+    EXPECT_EQ(index.search("zgf"), QStringList({"C001"}));
+    EXPECT_EQ(index.search("cengguofan"), QStringList({"C001"}));
+
+    index.insert(Card("C001", "王五", "B1"));
+    EXPECT_TRUE(index.search("zgf").isEmpty());
+    EXPECT_EQ(index.search("ww"), QStringList({"C001"}));
+
+    index.remove("C001");
+    EXPECT_TRUE(index.search("ww").isEmpty());
+}
+
+// ========== 增量维护测试 ==========
+
+TEST(CardSearchIndexTest, InsertReplacesChangedCard) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "张三", "B17010101"));
+    index.insert(Card("C001", "王五", "B17010101"));
+
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_TRUE(index.search("张").isEmpty());
+    EXPECT_EQ(index.search("王五"), QStringList({"C001"}));
+}
+
+TEST(CardSearchIndexTest, RemoveAndReuseSlot) {
+    CardSearchIndex index;
+    index.insert(Card("C001", "张三", "B17010101"));
+    index.insert(Card("C002", "李四", "B17010102"));
+
+    index.remove("C001");
+    index.remove("C999");
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_TRUE(index.search("张三").isEmpty());
+
+    index.insert(Card("C003", "张三", "B17010103"));
+    EXPECT_EQ(index.search("张三"), QStringList({"C003"}));
+    EXPECT_EQ(index.search("B1701").size(), 2);
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_TRUE(index.search("B").isEmpty());
+}
+
+TEST(CardSearchIndexTest, MatchesLinearScan) {
+    const QStringList surnames = {"张", "王", "李", "赵", "Li", "Wang"};
+    const QStringList given = {"三", "四", "伟", "芳", "娜", "Lei", "Mei"};
+    QRandomGenerator rng(42);
+    QList<Card> cards;
+    CardSearchIndex index;
+    for (int i = 0; i < 500; ++i) {
+        Card card(QStringLiteral("C%1").arg(i, 4, 10, QLatin1Char('0')),
+                  surnames.at(rng.bounded(surnames.size())) +
+                      given.at(rng.bounded(given.size())),
+                  QStringLiteral("B%1").arg(rng.bounded(100000)));
+        cards.append(card);
+        index.insert(card);
+    }
+
+    // 全是英文字母的关键词还会按拼音匹配，不在此比较
+    const QStringList keywords = {"张", "三", "李L", "C00", "C0123", "B1", "王伟", "9", "gM"};
+    for (const auto& keyword : keywords) {
+        QStringList expected;
+        for (const auto& card : cards) {
+            if (card.cardId().contains(keyword, Qt::CaseInsensitive) ||
+                card.name().contains(keyword, Qt::CaseInsensitive) ||
+                card.studentId().contains(keyword, Qt::CaseInsensitive)) {
+                expected.append(card.cardId());
+            }
+        }
+        QStringList actual = index.search(keyword);
+        std::sort(actual.begin(), actual.end());
+        EXPECT_EQ(actual, expected) << keyword.toStdString();
+    }
+}
@@ -9,10 +9,17 @@
 #include "model/repositories/StorageManager.h"
 #include "model/services/CardService.h"
 
+#include <QBuffer>
+#include <QCollator>
+#include <QFile>
 #include <QSignalSpy>
 #include <QTemporaryDir>
+#include <QThread>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+
 using namespace CampusCard;
 
 class CardServiceTest : public ::testing::Test {
@@ -44,8 +51,8 @@ protected:
 TEST_F(CardServiceTest, Initialize) {
     // 创建一些卡并保存
     QList<Card> cards;
-    cards.append(Card("C001", "张三", "B17010101", 100.0));
-    cards.append(Card("C002", "李四", "B17010102", 200.0));
+    cards.append(Card("C001", "张三", "B17010101", Money::fromYuan(100)));
+    cards.append(Card("C002", "李四", "B17010102", Money::fromYuan(200)));
     StorageManager::instance().saveAllCards(cards);
 
     CardService service;
@@ -55,7 +62,7 @@ TEST_F(CardServiceTest, Initialize) {
 }
 
 TEST_F(CardServiceTest, SaveAll) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_TRUE(cardService->saveAll());
 
     // 验证数据已保存
@@ -66,15 +73,15 @@ TEST_F(CardServiceTest, SaveAll) {
 // ========== 查询操作测试 ==========
 
 TEST_F(CardServiceTest, GetAllCards) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    cardService->createCard("C002", "李四", "B17010102", 200.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(200));
 
     QList<Card> cards = cardService->getAllCards();
     EXPECT_EQ(cards.size(), 2);
 }
 
 TEST_F(CardServiceTest, FindCard) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     Card card = cardService->findCard("C001");
     EXPECT_EQ(card.cardId(), "C001");
@@ -86,21 +93,16 @@ TEST_F(CardServiceTest, FindCardNotFound) {
     EXPECT_TRUE(card.cardId().isEmpty());
 }
 
-TEST_F(CardServiceTest, GetCardPtr) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-
-    Card* cardPtr = cardService->getCardPtr("C001");
-    ASSERT_NE(cardPtr, nullptr);
-    EXPECT_EQ(cardPtr->cardId(), "C001");
-}
+TEST_F(CardServiceTest, FindCardReturnsCopy) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
-TEST_F(CardServiceTest, GetCardPtrNotFound) {
-    Card* cardPtr = cardService->getCardPtr("C999");
-    EXPECT_EQ(cardPtr, nullptr);
+    Card card = cardService->findCard("C001");
+    card.setBalance(Money::fromYuan(1));
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100));
 }
 
 TEST_F(CardServiceTest, FindCardByStudentId) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     Card card = cardService->findCardByStudentId("B17010101");
     EXPECT_EQ(card.cardId(), "C001");
@@ -111,8 +113,181 @@ TEST_F(CardServiceTest, FindCardByStudentIdNotFound) {
     EXPECT_TRUE(card.cardId().isEmpty());
 }
 
+TEST_F(CardServiceTest, GetAllCardsSortedByCardId) {
+    cardService->createCard("C003", "王五", "B17010103");
+    cardService->createCard("C001", "张三", "B17010101");
+    cardService->createCard("C002", "李四", "B17010102");
+
+    QList<Card> cards = cardService->getAllCards();
+    ASSERT_EQ(cards.size(), 3);
+    EXPECT_EQ(cards[0].cardId(), "C001");
+    EXPECT_EQ(cards[1].cardId(), "C002");
+    EXPECT_EQ(cards[2].cardId(), "C003");
+}
+
+TEST_F(CardServiceTest, StudentIdIndexFollowsUpdates) {
+    cardService->createCard("C002", "张三", "B17010101");
+    cardService->createCard("C001", "张三", "B17010101");
+
+    // 同一学号有多张卡时返回卡号最小的一张
+    EXPECT_EQ(cardService->findCardByStudentId("B17010101").cardId(), "C001");
+
+    Card card = cardService->findCard("C001");
+    card.setStudentId("B17010199");
+    cardService->updateCard(card);
+
+    EXPECT_EQ(cardService->findCardByStudentId("B17010101").cardId(), "C002");
+    EXPECT_EQ(cardService->findCardByStudentId("B17010199").cardId(), "C001");
+}
+
+TEST_F(CardServiceTest, StateIndexFollowsTransitions) {
+    cardService->createCard("C001", "张三", "B17010101");
+    cardService->createCard("C002", "李四", "B17010102");
+    cardService->createCard("C003", "王五", "B17010103");
+    EXPECT_EQ(cardService->countCardsByState(CardState::Normal), 3);
+
+    cardService->reportLost("C002");
+    cardService->freeze("C003");
+    for (int i = 0; i < MAX_LOGIN_ATTEMPTS; ++i) {
+        cardService->incrementLoginAttempts("C001");
+    }
+
+    QList<Card> frozen = cardService->findCardsByState(CardState::Frozen);
+    ASSERT_EQ(frozen.size(), 2);
+    EXPECT_EQ(frozen[0].cardId(), "C001");
+    EXPECT_EQ(frozen[1].cardId(), "C003");
+    EXPECT_EQ(cardService->countCardsByState(CardState::Lost), 1);
+    EXPECT_EQ(cardService->countCardsByState(CardState::Normal), 0);
+
+    cardService->resetPassword("C001", "654321");
+    cardService->unfreeze("C003");
+    cardService->cancelLost("C002");
+    EXPECT_TRUE(cardService->findCardsByState(CardState::Frozen).isEmpty());
+    EXPECT_EQ(cardService->countCardsByState(CardState::Normal), 3);
+}
+
+TEST_F(CardServiceTest, FindCardsByNameIgnoresCaseAndSpacing) {
+    cardService->createCard("C001", "Li  Lei", "B17010101");
+    cardService->createCard("C002", "li lei", "B17010102");
+    cardService->createCard("C003", "Han Meimei", "B17010103");
+
+    QList<Card> cards = cardService->findCardsByName("  LI LEI ");
+    ASSERT_EQ(cards.size(), 2);
+    EXPECT_EQ(cards[0].cardId(), "C001");
+    EXPECT_EQ(cards[1].cardId(), "C002");
+
+    Card card = cardService->findCard("C002");
+    card.setName("Li Ming");
+    cardService->updateCard(card);
+    EXPECT_EQ(cardService->findCardsByName("li lei").size(), 1);
+    EXPECT_EQ(cardService->findCardsByName("LI MING").size(), 1);
+}
+
+TEST_F(CardServiceTest, SearchCardsFollowsUpdates) {
+    cardService->createCard("C001", "张三", "B17010101");
+    cardService->createCard("C002", "张三丰", "B17010102");
+
+    QList<Card> cards = cardService->searchCards("张三");
+    ASSERT_EQ(cards.size(), 2);
+    EXPECT_EQ(cards[0].cardId(), "C001");
+
+    Card card = cardService->findCard("C001");
+    card.setName("李四");
+    cardService->updateCard(card);
+
+    cards = cardService->searchCards("张三");
+    ASSERT_EQ(cards.size(), 1);
+    EXPECT_EQ(cards[0].cardId(), "C002");
+    EXPECT_EQ(cardService->searchCards("李四").size(), 1);
+    EXPECT_EQ(cardService->searchCards("", 1).size(), 1);
+}
+
+TEST_F(CardServiceTest, IndexesRebuiltOnInitialize) {
+    QList<Card> cards;
+    cards.append(Card("C001", "张三", "B17010101"));
+    cards.append(Card("C002", "李四", "B17010102"));
+    cards[1].setState(CardState::Lost);
+    StorageManager::instance().saveAllCards(cards);
+
+    cardService->initialize();
+
+    EXPECT_EQ(cardService->findCardByStudentId("B17010102").cardId(), "C002");
+    EXPECT_EQ(cardService->countCardsByState(CardState::Lost), 1);
+    EXPECT_EQ(cardService->findCardsByName("张三").size(), 1);
+}
+
+// ========== 排序测试 ==========
+
+TEST_F(CardServiceTest, SortedByNameUsesChineseCollation) {
+    cardService->createCard("C001", "张三", "B3");
+    cardService->createCard("C002", "李四", "B1");
+    cardService->createCard("C003", "王五", "B2");
+    cardService->createCard("C004", "李四", "B4");
+
+    QStringList names = {"张三", "李四", "王五"};
+    QCollator collator(QLocale(QLocale::Chinese, QLocale::China));
+    std::sort(names.begin(), names.end(), collator);
+
+    QStringList sortedNames;
+    for (const auto& cardId : cardService->sortedCardIds(CardSortField::Name)) {
+        sortedNames.append(cardService->findCard(cardId).name());
+    }
+    sortedNames.removeDuplicates();
+    EXPECT_EQ(sortedNames, names);
+
+    // 同名按卡号
+    QStringList ids = cardService->sortedCardIds(CardSortField::Name);
+    EXPECT_LT(ids.indexOf("C002"), ids.indexOf("C004"));
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::StudentId),
+              QStringList({"C002", "C003", "C001", "C004"}));
+}
+
+TEST_F(CardServiceTest, OrderingsFollowUpdates) {
+    cardService->createCard("C001", "张三", "B1", Money::fromYuan(10));
+    cardService->createCard("C002", "李四", "B2", Money::fromYuan(20));
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::Balance), QStringList({"C001", "C002"}));
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::State), QStringList({"C001", "C002"}));
+
+    cardService->recharge("C001", Money::fromYuan(50));
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::Balance), QStringList({"C002", "C001"}));
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::TotalRecharge),
+              QStringList({"C002", "C001"}));
+
+    cardService->deduct("C001", Money::fromYuan(55));
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::Balance), QStringList({"C001", "C002"}));
+
+    cardService->reportLost("C001");
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::State), QStringList({"C002", "C001"}));
+
+    // 改名后重新计算排序键
+    const QStringList before = cardService->sortedCardIds(CardSortField::Name);
+    Card card = cardService->findCard(before.first());
+    card.setName(cardService->findCard(before.last()).name() + "z");
+    cardService->updateCard(card);
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::Name).last(), before.first());
+}
+
+TEST_F(CardServiceTest, SortCardsSubset) {
+    cardService->createCard("C001", "A", "B1", Money::fromYuan(30));
+    cardService->createCard("C002", "B", "B2", Money::fromYuan(10));
+    cardService->createCard("C003", "C", "B3", Money::fromYuan(20));
+    cardService->createCard("C004", "D", "B4", Money::fromYuan(5));
+
+    QList<Card> cards = {cardService->findCard("C001"), cardService->findCard("C002"),
+                         cardService->findCard("C003")};
+    cardService->sortCards(cards, CardSortField::Balance);
+    ASSERT_EQ(cards.size(), 3);
+    EXPECT_EQ(cards[0].cardId(), "C002");
+    EXPECT_EQ(cards[1].cardId(), "C003");
+    EXPECT_EQ(cards[2].cardId(), "C001");
+
+    cardService->sortCards(cards, CardSortField::Name, true);
+    EXPECT_EQ(cards[0].cardId(), "C003");
+    EXPECT_EQ(cards[2].cardId(), "C001");
+}
+
 TEST_F(CardServiceTest, CardExists) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_TRUE(cardService->cardExists("C001"));
     EXPECT_FALSE(cardService->cardExists("C999"));
@@ -121,27 +296,27 @@ TEST_F(CardServiceTest, CardExists) {
 TEST_F(CardServiceTest, CardCount) {
     EXPECT_EQ(cardService->cardCount(), 0);
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     EXPECT_EQ(cardService->cardCount(), 1);
 
-    cardService->createCard("C002", "李四", "B17010102", 200.0);
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(200));
     EXPECT_EQ(cardService->cardCount(), 2);
 }
 
 // ========== 创建操作测试 ==========
 
 TEST_F(CardServiceTest, CreateCardWithParameters) {
-    EXPECT_TRUE(cardService->createCard("C001", "张三", "B17010101", 100.0));
+    EXPECT_TRUE(cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100)));
 
     Card card = cardService->findCard("C001");
     EXPECT_EQ(card.cardId(), "C001");
     EXPECT_EQ(card.name(), "张三");
     EXPECT_EQ(card.studentId(), "B17010101");
-    EXPECT_DOUBLE_EQ(card.balance(), 100.0);
+    EXPECT_EQ(card.balance(), Money::fromYuan(100));
 }
 
 TEST_F(CardServiceTest, CreateCardWithObject) {
-    Card newCard("C001", "张三", "B17010101", 100.0);
+    Card newCard("C001", "张三", "B17010101", Money::fromYuan(100));
     newCard.setPassword("custompass");
 
     EXPECT_TRUE(cardService->createCard(newCard));
@@ -151,15 +326,15 @@ TEST_F(CardServiceTest, CreateCardWithObject) {
 }
 
 TEST_F(CardServiceTest, CreateCardDuplicate) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    EXPECT_FALSE(cardService->createCard("C001", "李四", "B17010102", 200.0));
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(cardService->createCard("C001", "李四", "B17010102", Money::fromYuan(200)));
 }
 
 TEST_F(CardServiceTest, CreateCardSignals) {
     QSignalSpy createdSpy(cardService, &CardService::cardCreated);
     QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
 
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(createdSpy.count(), 1);
     EXPECT_EQ(changedSpy.count(), 1);
@@ -169,91 +344,129 @@ TEST_F(CardServiceTest, CreateCardSignals) {
 // ========== 充值扣款操作测试 ==========
 
 TEST_F(CardServiceTest, Recharge) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
-    EXPECT_TRUE(cardService->recharge("C001", 50.0));
+    EXPECT_TRUE(cardService->recharge("C001", Money::fromYuan(50)));
 
     Card card = cardService->findCard("C001");
-    EXPECT_DOUBLE_EQ(card.balance(), 150.0);
-    EXPECT_DOUBLE_EQ(card.totalRecharge(), 150.0);
+    EXPECT_EQ(card.balance(), Money::fromYuan(150));
+    EXPECT_EQ(card.totalRecharge(), Money::fromYuan(150));
 }
 
 TEST_F(CardServiceTest, RechargeCardNotFound) {
-    EXPECT_FALSE(cardService->recharge("C999", 50.0));
+    EXPECT_FALSE(cardService->recharge("C999", Money::fromYuan(50)));
 }
 
 TEST_F(CardServiceTest, RechargeNegativeAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    EXPECT_FALSE(cardService->recharge("C001", -50.0));
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(cardService->recharge("C001", Money::fromYuan(-50)));
 }
 
 TEST_F(CardServiceTest, RechargeZeroAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    EXPECT_FALSE(cardService->recharge("C001", 0.0));
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(cardService->recharge("C001", Money()));
 }
 
 TEST_F(CardServiceTest, RechargeSignals) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy updatedSpy(cardService, &CardService::cardUpdated);
     QSignalSpy balanceSpy(cardService, &CardService::balanceChanged);
 
-    cardService->recharge("C001", 50.0);
+    cardService->recharge("C001", Money::fromYuan(50));
 
     EXPECT_EQ(updatedSpy.count(), 1);
     EXPECT_EQ(balanceSpy.count(), 1);
-    EXPECT_DOUBLE_EQ(balanceSpy.takeFirst().at(1).toDouble(), 150.0);
+    EXPECT_EQ(balanceSpy.takeFirst().at(1).value<Money>(), Money::fromYuan(150));
 }
 
 TEST_F(CardServiceTest, Deduct) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
-    EXPECT_TRUE(cardService->deduct("C001", 30.0));
+    EXPECT_TRUE(cardService->deduct("C001", Money::fromYuan(30)));
 
     Card card = cardService->findCard("C001");
-    EXPECT_DOUBLE_EQ(card.balance(), 70.0);
+    EXPECT_EQ(card.balance(), Money::fromYuan(70));
 }
 
 TEST_F(CardServiceTest, DeductCardNotFound) {
-    EXPECT_FALSE(cardService->deduct("C999", 30.0));
+    EXPECT_FALSE(cardService->deduct("C999", Money::fromYuan(30)));
 }
 
 TEST_F(CardServiceTest, DeductInsufficientBalance) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    EXPECT_FALSE(cardService->deduct("C001", 150.0));
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(cardService->deduct("C001", Money::fromYuan(150)));
 }
 
 TEST_F(CardServiceTest, DeductNegativeAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    EXPECT_FALSE(cardService->deduct("C001", -30.0));
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(cardService->deduct("C001", Money::fromYuan(-30)));
 }
 
 TEST_F(CardServiceTest, DeductZeroAmount) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
-    EXPECT_FALSE(cardService->deduct("C001", 0.0));
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    EXPECT_FALSE(cardService->deduct("C001", Money()));
 }
 
 TEST_F(CardServiceTest, DeductCardNotUsable) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
-    EXPECT_FALSE(cardService->deduct("C001", 30.0));
+    EXPECT_FALSE(cardService->deduct("C001", Money::fromYuan(30)));
+}
+
+TEST_F(CardServiceTest, DeductBatch) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(10));
+    cardService->createCard("C003", "王五", "B17010103", Money::fromYuan(100));
+    cardService->reportLost("C003");
+
+    QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
+    QSignalSpy updatedSpy(cardService, &CardService::cardUpdated);
+
+    QMap<QString, Money> amounts;
+    amounts.insert("C001", Money::fromYuan(30));
+    amounts.insert("C002", Money::fromYuan(20));  // 余额不足
+    amounts.insert("C003", Money::fromYuan(30));  // 已挂失
+    amounts.insert("C999", Money::fromYuan(30));  // 不存在
+
+    EXPECT_EQ(cardService->deductBatch(amounts), QStringList{"C001"});
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(70));
+    EXPECT_EQ(cardService->getBalance("C002"), Money::fromYuan(10));
+    EXPECT_EQ(changedSpy.count(), 1);
+    EXPECT_EQ(updatedSpy.count(), 0);
+    EXPECT_EQ(StorageManager::instance().loadCard("C001").balance(), Money::fromYuan(70));
+}
+
+TEST_F(CardServiceTest, ApplyJournaledDeductsOncePerSequence) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(100));
+
+    QMap<QString, Money> amounts;
+    amounts.insert("C001", Money::fromYuan(30));
+    amounts.insert("C002", Money::fromYuan(20));
+
+    EXPECT_EQ(cardService->applyJournaledDeducts(amounts, 5), 2);
+    EXPECT_EQ(cardService->applyJournaledDeducts(amounts, 5), 0);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(70));
+    EXPECT_EQ(cardService->findCard("C002").journalSequence(), 5u);
+    EXPECT_EQ(cardService->maxJournalSequence(), 5u);
 }
 
 TEST_F(CardServiceTest, GetBalance) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
-    EXPECT_DOUBLE_EQ(cardService->getBalance("C001"), 100.0);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100));
 }
 
 TEST_F(CardServiceTest, GetBalanceCardNotFound) {
-    EXPECT_DOUBLE_EQ(cardService->getBalance("C999"), -1.0);
+    EXPECT_TRUE(cardService->getBalance("C999").isNegative());
 }
 
 // ========== 状态管理操作测试 ==========
 
 TEST_F(CardServiceTest, ReportLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_TRUE(cardService->reportLost("C001"));
 
@@ -266,7 +479,7 @@ TEST_F(CardServiceTest, ReportLostCardNotFound) {
 }
 
 TEST_F(CardServiceTest, ReportLostSignals) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy stateSpy(cardService, &CardService::cardStateChanged);
 
@@ -277,7 +490,7 @@ TEST_F(CardServiceTest, ReportLostSignals) {
 }
 
 TEST_F(CardServiceTest, CancelLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->reportLost("C001");
 
     EXPECT_TRUE(cardService->cancelLost("C001"));
@@ -287,7 +500,7 @@ TEST_F(CardServiceTest, CancelLost) {
 }
 
 TEST_F(CardServiceTest, CancelLostNotLost) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     // 卡不是挂失状态
     EXPECT_FALSE(cardService->cancelLost("C001"));
 }
@@ -297,7 +510,7 @@ TEST_F(CardServiceTest, CancelLostCardNotFound) {
 }
 
 TEST_F(CardServiceTest, Freeze) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_TRUE(cardService->freeze("C001"));
 
@@ -310,7 +523,7 @@ TEST_F(CardServiceTest, FreezeCardNotFound) {
 }
 
 TEST_F(CardServiceTest, Unfreeze) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->freeze("C001");
 
     EXPECT_TRUE(cardService->unfreeze("C001"));
@@ -327,7 +540,7 @@ TEST_F(CardServiceTest, UnfreezeCardNotFound) {
 // ========== 密码管理测试 ==========
 
 TEST_F(CardServiceTest, VerifyPassword) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_TRUE(cardService->verifyPassword("C001", DEFAULT_STUDENT_PASSWORD));
     EXPECT_FALSE(cardService->verifyPassword("C001", "wrongpassword"));
@@ -338,7 +551,7 @@ TEST_F(CardServiceTest, VerifyPasswordCardNotFound) {
 }
 
 TEST_F(CardServiceTest, ChangePassword) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_TRUE(cardService->changePassword("C001", DEFAULT_STUDENT_PASSWORD, "newpass"));
 
@@ -347,7 +560,7 @@ TEST_F(CardServiceTest, ChangePassword) {
 }
 
 TEST_F(CardServiceTest, ChangePasswordWrongOld) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_FALSE(cardService->changePassword("C001", "wrongold", "newpass"));
 }
@@ -357,7 +570,7 @@ TEST_F(CardServiceTest, ChangePasswordCardNotFound) {
 }
 
 TEST_F(CardServiceTest, ResetPassword) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->freeze("C001");
 
     EXPECT_TRUE(cardService->resetPassword("C001", "resetpass"));
@@ -375,7 +588,7 @@ TEST_F(CardServiceTest, ResetPasswordCardNotFound) {
 // ========== 登录尝试管理测试 ==========
 
 TEST_F(CardServiceTest, IncrementLoginAttempts) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 1);
     EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 2);
@@ -390,7 +603,7 @@ TEST_F(CardServiceTest, IncrementLoginAttemptsCardNotFound) {
 }
 
 TEST_F(CardServiceTest, ResetLoginAttempts) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
     cardService->incrementLoginAttempts("C001");
     cardService->incrementLoginAttempts("C001");
 
@@ -404,7 +617,7 @@ TEST_F(CardServiceTest, ResetLoginAttemptsCardNotFound) {
 }
 
 TEST_F(CardServiceTest, GetLoginAttempts) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     EXPECT_EQ(cardService->getLoginAttempts("C001"), 0);
 
@@ -416,29 +629,119 @@ TEST_F(CardServiceTest, GetLoginAttemptsCardNotFound) {
     EXPECT_EQ(cardService->getLoginAttempts("C999"), -1);
 }
 
+TEST_F(CardServiceTest, LoginFailuresWrittenOnlyOnFlush) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    const auto savedAttempts = [] {
+        return StorageManager::instance().loadAllCards().first().loginAttempts();
+    };
+
+    QSignalSpy updatedSpy(cardService, &CardService::cardUpdated);
+    EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 1);
+    EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 2);
+    EXPECT_EQ(updatedSpy.count(), 0);
+    EXPECT_EQ(savedAttempts(), 0);
+
+    EXPECT_EQ(cardService->flushLoginAttempts(), 1);
+    EXPECT_EQ(savedAttempts(), 2);
+    EXPECT_EQ(cardService->flushLoginAttempts(), 0);
+
+    // 登录成功清零也随下次写回保存
+    EXPECT_TRUE(cardService->resetLoginAttempts("C001"));
+    EXPECT_EQ(cardService->getLoginAttempts("C001"), 0);
+    EXPECT_EQ(savedAttempts(), 2);
+    EXPECT_EQ(cardService->flushLoginAttempts(), 1);
+    EXPECT_EQ(savedAttempts(), 0);
+}
+
+TEST_F(CardServiceTest, FreezeOnMaxAttemptsSavedImmediately) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    QSignalSpy stateSpy(cardService, &CardService::cardStateChanged);
+    for (int i = 0; i < MAX_LOGIN_ATTEMPTS; ++i) {
+        cardService->incrementLoginAttempts("C001");
+    }
+    EXPECT_EQ(stateSpy.count(), 1);
+
+    // 冻结的卡的计数不被写回覆盖
+    EXPECT_EQ(cardService->flushLoginAttempts(), 0);
+
+    CardService restarted;
+    restarted.initialize();
+    Card card = restarted.findCard("C001");
+    EXPECT_EQ(card.state(), CardState::Frozen);
+    EXPECT_EQ(card.loginAttempts(), MAX_LOGIN_ATTEMPTS);
+    EXPECT_EQ(restarted.getLoginAttempts("C001"), MAX_LOGIN_ATTEMPTS);
+}
+
+TEST_F(CardServiceTest, LoginAttemptsDecayAfterWindow) {
+    SimulatedClock clock(QDateTime(QDate(2024, 9, 2), QTime(9, 0)));
+    cardService->setClock(&clock);
+    cardService->setLoginAttemptWindow(10 * 60 * 1000);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+
+    cardService->incrementLoginAttempts("C001");
+    clock.advance(9 * 60 * 1000);
+    EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 2);
+    ASSERT_EQ(cardService->flushLoginAttempts(), 1);
+
+    // 距最近一次失败满10分钟后计数归零，写回时卡上的计数也清零
+    clock.advance(10 * 60 * 1000);
+    EXPECT_EQ(cardService->getLoginAttempts("C001"), 0);
+    EXPECT_EQ(cardService->flushLoginAttempts(), 1);
+    EXPECT_EQ(cardService->findCard("C001").loginAttempts(), 0);
+
+    EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 1);
+    EXPECT_EQ(cardService->findCard("C001").state(), CardState::Normal);
+
+    cardService->setClock(nullptr);
+}
+
+TEST_F(CardServiceTest, SavedLoginAttemptsRestoredOnInitialize) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->incrementLoginAttempts("C001");
+    cardService->incrementLoginAttempts("C001");
+    cardService->flushLoginAttempts();
+
+    CardService restarted;
+    restarted.initialize();
+    EXPECT_EQ(restarted.getLoginAttempts("C001"), 2);
+    EXPECT_EQ(restarted.incrementLoginAttempts("C001"), 3);
+    EXPECT_EQ(restarted.findCard("C001").state(), CardState::Frozen);
+}
+
+TEST_F(CardServiceTest, UnfreezeClearsInMemoryAttempts) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->incrementLoginAttempts("C001");
+    cardService->incrementLoginAttempts("C001");
+    cardService->freeze("C001");
+
+    EXPECT_TRUE(cardService->unfreeze("C001"));
+    EXPECT_EQ(cardService->getLoginAttempts("C001"), 0);
+    EXPECT_EQ(cardService->incrementLoginAttempts("C001"), 1);
+}
+
 // ========== 卡信息更新测试 ==========
 
 TEST_F(CardServiceTest, UpdateCard) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     Card updatedCard = cardService->findCard("C001");
     updatedCard.setName("张三丰");
-    updatedCard.setBalance(500.0);
+    updatedCard.setBalance(Money::fromYuan(500));
 
     EXPECT_TRUE(cardService->updateCard(updatedCard));
 
     Card card = cardService->findCard("C001");
     EXPECT_EQ(card.name(), "张三丰");
-    EXPECT_DOUBLE_EQ(card.balance(), 500.0);
+    EXPECT_EQ(card.balance(), Money::fromYuan(500));
 }
 
 TEST_F(CardServiceTest, UpdateCardNotFound) {
-    Card nonExistentCard("C999", "不存在", "B99999999", 100.0);
+    Card nonExistentCard("C999", "不存在", "B99999999", Money::fromYuan(100));
     EXPECT_FALSE(cardService->updateCard(nonExistentCard));
 }
 
 TEST_F(CardServiceTest, UpdateCardSignals) {
-    cardService->createCard("C001", "张三", "B17010101", 100.0);
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     QSignalSpy updatedSpy(cardService, &CardService::cardUpdated);
 
@@ -449,3 +752,381 @@ TEST_F(CardServiceTest, UpdateCardSignals) {
     EXPECT_EQ(updatedSpy.count(), 1);
     EXPECT_EQ(updatedSpy.takeFirst().at(0).toString(), "C001");
 }
+
+// ========== 并发测试 ==========
+
+TEST_F(CardServiceTest, ConcurrentDeductsNeverOverdraw) {
+    constexpr int CARDS = 4;
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 100;
+    for (int c = 0; c < CARDS; ++c) {
+        cardService->createCard(QStringLiteral("C%1").arg(c), QStringLiteral("学生%1").arg(c),
+                                QStringLiteral("B%1").arg(c), Money::fromYuan(50));
+    }
+    cardService->createCard("F001", "冻结测试", "BF", Money::fromYuan(10));
+
+    std::atomic<int> succeeded{0};
+    std::atomic<bool> running{true};
+    QList<QThread*> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.append(QThread::create([this, t, &succeeded]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                if (cardService->deduct(QStringLiteral("C%1").arg((t + i) % CARDS),
+                                        Money::fromYuan(1))) {
+                    ++succeeded;
+                }
+            }
+        }));
+    }
+    // 同时查询和切换另一张卡的状态
+    threads.append(QThread::create([this, &running]() {
+        while (running) {
+            EXPECT_EQ(cardService->cardCount(), CARDS + 1);
+            EXPECT_EQ(cardService->searchCards("学生").size(), CARDS);
+            EXPECT_EQ(cardService->sortedCardIds(CardSortField::Balance).size(), CARDS + 1);
+            cardService->freeze("F001");
+            cardService->unfreeze("F001");
+        }
+    }));
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (int t = 0; t < THREADS; ++t) {
+        threads.at(t)->wait();
+    }
+    running = false;
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    // 4张卡共200元，400次1元扣款恰好成功200次
+    EXPECT_EQ(succeeded.load(), CARDS * 50);
+    for (int c = 0; c < CARDS; ++c) {
+        EXPECT_EQ(cardService->getBalance(QStringLiteral("C%1").arg(c)), Money());
+    }
+    EXPECT_EQ(cardService->countCardsByState(CardState::Normal), CARDS + 1);
+    EXPECT_EQ(cardService->countCardsByState(CardState::Frozen), 0);
+    EXPECT_EQ(cardService->sortedCardIds(CardSortField::Balance).last(), "F001");
+}
+
+// ========== 余额流水测试 ==========
+
+TEST_F(CardServiceTest, LedgerRecordsEveryBalanceChange) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->recharge("C001", Money::fromYuan(50));
+    cardService->deduct("C001", Money::fromYuan(30));
+    cardService->applyJournaledDeduct("C001", Money::fromYuan(5), 1);
+    Card card = cardService->findCard("C001");
+    card.setBalance(Money::fromYuan(120));
+    cardService->updateCard(card);
+
+    const QList<LedgerEntry> statement = cardService->getStatement("C001");
+    ASSERT_EQ(statement.size(), 5);
+    EXPECT_EQ(statement[0].type, LedgerEntryType::Opening);
+    EXPECT_EQ(statement[1].type, LedgerEntryType::Recharge);
+    EXPECT_EQ(statement[2].type, LedgerEntryType::Charge);
+    EXPECT_EQ(statement[3].journalSequence, 1u);
+    EXPECT_EQ(statement[4].type, LedgerEntryType::Adjustment);
+    EXPECT_EQ(statement[4].amount, Money::fromYuan(5));
+    EXPECT_EQ(statement[4].balance, cardService->getBalance("C001"));
+
+    // 失败的操作不记账
+    EXPECT_FALSE(cardService->deduct("C001", Money::fromYuan(1000)));
+    EXPECT_EQ(cardService->getStatement("C001").size(), 5);
+    EXPECT_TRUE(cardService->reconcileLedger().isClean());
+}
+
+TEST_F(CardServiceTest, LedgerPersistsAndOpensExistingCards) {
+    // 启用流水前已有的卡以当前余额开户
+    QList<Card> cards;
+    cards.append(Card("C001", "张三", "B17010101", Money::fromYuan(80)));
+    cards.append(Card("C002", "李四", "B17010102", Money()));
+    StorageManager::instance().saveAllCards(cards);
+    cardService->initialize();
+
+    ASSERT_EQ(cardService->getStatement("C001").size(), 1);
+    EXPECT_EQ(cardService->getStatement("C001").first().type, LedgerEntryType::Opening);
+    EXPECT_TRUE(cardService->getStatement("C002").isEmpty());
+
+    cardService->recharge("C001", Money::fromYuan(20));
+
+    CardService restarted;
+    restarted.initialize();
+    const QList<LedgerEntry> statement = restarted.getStatement("C001");
+    ASSERT_EQ(statement.size(), 2);
+    EXPECT_EQ(statement.last().balance, Money::fromYuan(100));
+    EXPECT_TRUE(restarted.reconcileLedger().isClean());
+}
+
+TEST_F(CardServiceTest, LedgerReplayDoesNotDoubleCharge) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    const QList<Card> beforeCharge = StorageManager::instance().loadAllCards();
+
+    // 流水已写入、卡文件仍是扣款前的版本：模拟两步之间崩溃
+    cardService->applyJournaledDeduct("C001", Money::fromYuan(5), 1);
+    ASSERT_TRUE(cardService->saveAll());
+    StorageManager::instance().saveAllCards(beforeCharge);
+
+    CardService restarted;
+    restarted.initialize();
+    EXPECT_FALSE(restarted.reconcileLedger().isClean());
+    EXPECT_TRUE(restarted.applyJournaledDeduct("C001", Money::fromYuan(5), 1));
+    EXPECT_EQ(restarted.getStatement("C001").size(), 2);
+    EXPECT_TRUE(restarted.reconcileLedger().isClean());
+}
+
+TEST_F(CardServiceTest, ReconcileDetectsExternalBalanceEdit) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(100));
+
+    QList<Card> cards = StorageManager::instance().loadAllCards();
+    for (auto& card : cards) {
+        if (card.cardId() == "C002") {
+            card.setBalance(Money::fromYuan(999));
+        }
+    }
+    StorageManager::instance().saveAllCards(cards);
+
+    CardService restarted;
+    restarted.initialize();
+    const ReconciliationReport report = restarted.reconcileLedgerAsync().result();
+    EXPECT_EQ(report.cardsChecked, 2);
+    ASSERT_EQ(report.mismatches.size(), 1);
+    EXPECT_EQ(report.mismatches.first().cardId, "C002");
+    EXPECT_EQ(report.mismatches.first().materialized, Money::fromYuan(999));
+    EXPECT_EQ(report.mismatches.first().ledger, Money::fromYuan(100));
+}
+
+// ========== 批量充值测试 ==========
+
+TEST_F(CardServiceTest, RechargeBatchCommitsOnce) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(10));
+    cardService->createCard("C002", "李四", "B17010102", Money::fromYuan(20));
+
+    QByteArray csv("卡号,金额\nC001,100\nC002,50.5\n\nC001,0.25\n");
+    QBuffer buffer(&csv);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
+    QSignalSpy updatedSpy(cardService, &CardService::cardUpdated);
+    QSignalSpy balanceSpy(cardService, &CardService::balanceChanged);
+    const RechargeBatchReport report = cardService->rechargeBatch(&buffer);
+
+    EXPECT_TRUE(report.isClean());
+    EXPECT_EQ(report.rows, 3);
+    EXPECT_EQ(report.applied, 3);
+    EXPECT_TRUE(report.saved);
+    EXPECT_EQ(report.total, Money::fromCents(15075));
+
+    // 只发出一次整体变更信号
+    EXPECT_EQ(changedSpy.count(), 1);
+    EXPECT_EQ(updatedSpy.count(), 0);
+    EXPECT_EQ(balanceSpy.count(), 0);
+
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromCents(11025));
+    EXPECT_EQ(cardService->findCard("C002").totalRecharge(), Money::fromCents(7050));
+    EXPECT_EQ(cardService->getStatement("C001").size(), 3);
+    EXPECT_TRUE(cardService->reconcileLedger().isClean());
+
+    CardService restarted;
+    restarted.initialize();
+    EXPECT_EQ(restarted.getBalance("C001"), Money::fromCents(11025));
+}
+
+TEST_F(CardServiceTest, RechargeBatchRejectsWholeFileOnError) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(10));
+
+    QByteArray csv("C001,100\nC999,5\nC001,-3\nC001,1.005\n,5\nC001\n");
+    QBuffer buffer(&csv);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
+    const RechargeBatchReport report = cardService->rechargeBatch(&buffer);
+
+    EXPECT_EQ(report.rows, 6);
+    EXPECT_EQ(report.validRows, 1);
+    EXPECT_EQ(report.applied, 0);
+    ASSERT_EQ(report.errors.size(), 5);
+    EXPECT_EQ(report.errors[0].line, 2);
+    EXPECT_EQ(report.errors[0].cardId, "C999");
+    EXPECT_EQ(report.errors[4].line, 6);
+
+    // 有效的行也不充值
+    EXPECT_EQ(changedSpy.count(), 0);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(10));
+    EXPECT_EQ(cardService->getStatement("C001").size(), 1);
+}
+
+TEST_F(CardServiceTest, RechargeBatchValidateOnly) {
+    cardService->createCard("C001", "张三", "B17010101", Money::fromYuan(10));
+
+    QByteArray csv("C001,100\n");
+    QBuffer buffer(&csv);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    const RechargeBatchReport report = cardService->rechargeBatch(&buffer, true);
+    EXPECT_TRUE(report.isClean());
+    EXPECT_EQ(report.validRows, 1);
+    EXPECT_EQ(report.total, Money::fromYuan(100));
+    EXPECT_EQ(report.applied, 0);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(10));
+}
+
+// ========== 批量状态操作测试 ==========
+
+TEST_F(CardServiceTest, FreezeBatchByListCommitsOnce) {
+    cardService->createCard("C001", "张三", "B23010101", Money::fromYuan(10));
+    cardService->createCard("C002", "李四", "B23010102", Money::fromYuan(10));
+    cardService->createCard("C003", "王五", "B23010103", Money::fromYuan(10));
+    ASSERT_TRUE(cardService->freeze("C002"));
+
+    QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
+    QSignalSpy stateSpy(cardService, &CardService::cardStateChanged);
+    const CardBatchResult result = cardService->freezeBatch({"C003", "C001", "C002", "C999"});
+
+    // 已冻结和不存在的卡被跳过
+    EXPECT_EQ(result.changed, QStringList({"C001", "C003"}));
+    EXPECT_TRUE(result.saved);
+    EXPECT_EQ(changedSpy.count(), 1);
+    EXPECT_EQ(stateSpy.count(), 0);
+    EXPECT_EQ(cardService->findCardsByState(CardState::Frozen).size(), 3);
+
+    CardService restarted;
+    restarted.initialize();
+    EXPECT_EQ(restarted.findCard("C003").state(), CardState::Frozen);
+}
+
+TEST_F(CardServiceTest, BatchWithoutMatchesDoesNotSave) {
+    cardService->createCard("C001", "张三", "B23010101", Money::fromYuan(10));
+
+    QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
+    EXPECT_TRUE(cardService->unfreezeBatch({"C001"}).changed.isEmpty());
+    EXPECT_TRUE(
+        cardService->cancelLostBatch(CardQuery().studentIdPrefix("B2301")).changed.isEmpty());
+    EXPECT_EQ(changedSpy.count(), 0);
+}
+
+TEST_F(CardServiceTest, BatchReportsSaveFailure) {
+    cardService->createCard("C001", "张三", "B23010101", Money::fromYuan(10));
+
+    // 数据目录的上级是普通文件，保存必然失败
+    QFile blocker(tempDir.path() + "/blocker");
+    ASSERT_TRUE(blocker.open(QIODevice::WriteOnly));
+    blocker.close();
+    StorageManager::instance().setDataPath(blocker.fileName() + "/data");
+
+    const CardBatchResult result = cardService->freezeBatch({"C001"});
+    EXPECT_EQ(result.changed, QStringList({"C001"}));
+    EXPECT_FALSE(result.saved);
+    EXPECT_TRUE(cardService->findCard("C001").isFrozen());  // 修改仍保留在内存中
+
+    StorageManager::instance().setDataPath(testDataPath);
+    EXPECT_TRUE(cardService->saveAll());
+}
+
+TEST_F(CardServiceTest, ReportLostBatchByClass) {
+    cardService->createCard("C001", "张三", "B23010101", Money::fromYuan(10));
+    cardService->createCard("C002", "李四", "b23010102", Money::fromYuan(10));
+    cardService->createCard("C003", "王五", "B23020101", Money::fromYuan(10));
+
+    const QStringList changed =
+        cardService->reportLostBatch(CardQuery().studentIdPrefix("B2301")).changed;
+    EXPECT_EQ(changed, QStringList({"C001", "C002"}));
+    EXPECT_EQ(cardService->findCard("C003").state(), CardState::Normal);
+
+    EXPECT_EQ(cardService->cancelLostBatch(CardQuery()).changed, changed);
+    EXPECT_TRUE(cardService->findCardsByState(CardState::Lost).isEmpty());
+}
+
+TEST_F(CardServiceTest, UnfreezeBatchByStateDuration) {
+    SimulatedClock clock(QDateTime(QDate(2024, 9, 1), QTime(8, 0)));
+    cardService->setClock(&clock);
+
+    cardService->createCard("C001", "张三", "B23010101", Money::fromYuan(10));
+    cardService->createCard("C002", "李四", "B23010102", Money::fromYuan(10));
+    cardService->createCard("C003", "王五", "B23010103", Money::fromYuan(10));
+    cardService->incrementLoginAttempts("C001");
+    ASSERT_TRUE(cardService->freeze("C001"));
+    clock.advance(qint64(20) * 24 * 3600 * 1000);
+    ASSERT_TRUE(cardService->freeze("C002"));
+    EXPECT_EQ(cardService->findCard("C002").stateChangedAt(), clock.now());
+
+    // 9月1日冻结的卡到10月1日满30天，9月21日冻结的卡不满
+    clock.advance(qint64(10) * 24 * 3600 * 1000);
+    const CardQuery query = CardQuery().state(CardState::Frozen).inStateForDays(30);
+    EXPECT_EQ(cardService->findCardIds(query), QStringList({"C001"}));
+
+    EXPECT_EQ(cardService->unfreezeBatch(query).changed, QStringList({"C001"}));
+    const Card card = cardService->findCard("C001");
+    EXPECT_EQ(card.state(), CardState::Normal);
+    EXPECT_EQ(card.loginAttempts(), 0);
+    EXPECT_EQ(card.stateChangedAt(), clock.now());
+    EXPECT_EQ(cardService->findCard("C002").state(), CardState::Frozen);
+
+    cardService->setClock(nullptr);
+}
+
+TEST_F(CardServiceTest, ResetPasswordBatch) {
+    cardService->createCard("C001", "张三", "B23010101", Money::fromYuan(10));
+    cardService->createCard("C002", "李四", "B23010102", Money::fromYuan(10));
+    ASSERT_TRUE(cardService->freeze("C002"));
+
+    EXPECT_TRUE(cardService->resetPasswordBatch({"C001", "C002"}, QString()).changed.isEmpty());
+
+    QSignalSpy changedSpy(cardService, &CardService::cardsChanged);
+    const CardBatchResult result = cardService->resetPasswordBatch({"C001", "C002"}, "654321");
+    EXPECT_EQ(result.changed, QStringList({"C001", "C002"}));
+    EXPECT_TRUE(result.saved);
+    EXPECT_EQ(changedSpy.count(), 1);
+    EXPECT_TRUE(cardService->verifyPassword("C002", "654321"));
+    EXPECT_EQ(cardService->findCard("C002").state(), CardState::Normal);
+}
+
+TEST_F(CardServiceTest, CardShardsNeverSeeHalfAppliedBatch) {
+    constexpr int CARDS = 16;
+    QStringList cardIds;
+    for (int c = 0; c < CARDS; ++c) {
+        cardIds.append(QStringLiteral("C%1").arg(c));
+        cardService->createCard(cardIds.last(), QStringLiteral("学生%1").arg(c),
+                                QStringLiteral("B%1").arg(c), Money::fromYuan(10));
+    }
+
+    std::atomic<bool> running{true};
+    QThread* writer = QThread::create([&]() {
+        for (int i = 0; i < 20; ++i) {
+            cardService->freezeBatch(cardIds);
+            cardService->unfreezeBatch(cardIds);
+        }
+        running = false;
+    });
+    writer->start();
+    while (running) {
+        // 批量冻结或解冻要么全部可见，要么全部不可见
+        int frozen = 0;
+        for (const auto& shard : cardService->cardShards()) {
+            for (const auto& card : shard) {
+                frozen += card.isFrozen() ? 1 : 0;
+            }
+        }
+        EXPECT_TRUE(frozen == 0 || frozen == CARDS) << frozen;
+    }
+    writer->wait();
+    delete writer;
+}
+
+TEST_F(CardServiceTest, LegacyCardsStampedOnInitialize) {
+    Card legacy("C001", "张三", "B23010101", Money::fromYuan(10));
+    legacy.setState(CardState::Frozen);
+    StorageManager::instance().saveAllCards({legacy});
+
+    SimulatedClock clock(QDateTime(QDate(2024, 9, 1), QTime(8, 0)));
+    CardService service;
+    service.setClock(&clock);
+    service.initialize();
+
+    // 状态变更时间未知的卡从加载时刻起算，不会被立即批量解冻
+    EXPECT_EQ(service.findCard("C001").stateChangedAt(), clock.now());
+    const CardQuery query = CardQuery().state(CardState::Frozen).inStateForDays(30);
+    EXPECT_TRUE(service.findCardIds(query).isEmpty());
+}
@@ -0,0 +1,122 @@
+/**
+ * @file DailyLedgerTest.cpp
+ * @brief DailyLedger按日台账单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/DailyLedger.h"
+
+#include <QRandomGenerator>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class DailyLedgerTest : public ::testing::Test {
+protected:
+    DailyLedger ledger;
+
+    static Record createRecord(const QString& location, const QDate& date, int duration,
+                               SessionState state = SessionState::Offline) {
+        Record record;
+        record.setRecordId(location + date.toString(Qt::ISODate));
+        record.setCardId("C001");
+        record.setLocation(location);
+        record.setStartTime(QDateTime(date, QTime(10, 0)));
+        record.setEndTime(QDateTime(date, QTime(10, 0)).addSecs(duration * 60));
+        record.setDurationMinutes(duration);
+        record.setCost(COST_PER_HOUR.scaled(duration, 60));
+        record.setState(state);
+        return record;
+    }
+};
+
+// ========== 树状数组测试 ==========
+
+TEST_F(DailyLedgerTest, EmptyLedger) {
+    FenwickLedger fenwick;
+    LedgerTotals totals = fenwick.range(QDate(2024, 1, 1), QDate(2024, 12, 31));
+    EXPECT_EQ(totals.sessions, 0);
+    EXPECT_EQ(totals.income, Money());
+}
+
+TEST_F(DailyLedgerTest, FenwickRangeSums) {
+    FenwickLedger fenwick;
+    fenwick.add(QDate(2024, 9, 1), {Money::fromYuan(1), 1, 60});
+    fenwick.add(QDate(2024, 9, 15), {Money::fromYuan(2), 2, 120});
+    fenwick.add(QDate(2024, 10, 1), {Money::fromYuan(4), 1, 240});
+
+    EXPECT_EQ(fenwick.range(QDate(2024, 9, 1), QDate(2024, 9, 30)).sessions, 3);
+    EXPECT_EQ(fenwick.range(QDate(2024, 9, 2), QDate(2024, 10, 1)).minutes, 360);
+    EXPECT_EQ(fenwick.range(QDate(2024, 9, 15), QDate(2024, 9, 15)).minutes, 120);
+    EXPECT_EQ(fenwick.range(QDate(2000, 1, 1), QDate(2099, 1, 1)).income, Money::fromYuan(7));
+    EXPECT_EQ(fenwick.range(QDate(2024, 9, 2), QDate(2024, 9, 14)).sessions, 0);
+    EXPECT_EQ(fenwick.range(QDate(2024, 10, 1), QDate(2024, 9, 1)).sessions, 0);
+}
+
+TEST_F(DailyLedgerTest, FenwickGrowsInBothDirections) {
+    FenwickLedger fenwick;
+    fenwick.add(QDate(2024, 9, 1), {Money::fromYuan(1), 1, 10});
+    // 早于起始日期和远超容量的补录
+    fenwick.add(QDate(2019, 3, 1), {Money::fromYuan(1), 1, 20});
+    fenwick.add(QDate(2031, 6, 1), {Money::fromYuan(1), 1, 40});
+
+    EXPECT_EQ(fenwick.range(QDate(2019, 3, 1), QDate(2019, 3, 1)).minutes, 20);
+    EXPECT_EQ(fenwick.range(QDate(2024, 9, 1), QDate(2024, 9, 1)).minutes, 10);
+    EXPECT_EQ(fenwick.range(QDate(2031, 6, 1), QDate(2031, 6, 1)).minutes, 40);
+    EXPECT_EQ(fenwick.range(QDate(2019, 1, 1), QDate(2031, 12, 31)).sessions, 3);
+}
+
+TEST_F(DailyLedgerTest, FenwickMatchesBruteForce) {
+    QRandomGenerator rng(7);
+    FenwickLedger fenwick;
+    QMap<QDate, int> minutes;
+    const QDate base(2024, 1, 1);
+    for (int i = 0; i < 500; ++i) {
+        QDate date = base.addDays(rng.bounded(-400, 400));
+        int value = rng.bounded(1, 300);
+        fenwick.add(date, {Money(), 1, value});
+        minutes[date] += value;
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        QDate start = base.addDays(rng.bounded(-450, 450));
+        QDate end = start.addDays(rng.bounded(0, 200));
+        int expected = 0;
+        for (auto it = minutes.lowerBound(start); it != minutes.upperBound(end); ++it) {
+            expected += it.value();
+        }
+        EXPECT_EQ(fenwick.range(start, end).minutes, expected);
+    }
+}
+
+// ========== 全局与按地点台账测试 ==========
+
+TEST_F(DailyLedgerTest, GlobalAndPerLocation) {
+    ledger.addRecord(createRecord("机房A101", QDate(2024, 9, 2), 60));
+    ledger.addRecord(createRecord("机房B202", QDate(2024, 9, 3), 30));
+    ledger.addRecord(createRecord("机房A101", QDate(2024, 9, 4), 90));
+
+    LedgerTotals all = ledger.range(QDate(2024, 9, 1), QDate(2024, 9, 30));
+    EXPECT_EQ(all.sessions, 3);
+    EXPECT_EQ(all.minutes, 180);
+    EXPECT_EQ(all.income, Money::fromYuan(3));
+
+    LedgerTotals a101 = ledger.range(QDate(2024, 9, 3), QDate(2024, 9, 4), "机房A101");
+    EXPECT_EQ(a101.sessions, 1);
+    EXPECT_EQ(a101.minutes, 90);
+
+    EXPECT_EQ(ledger.range(QDate(2024, 9, 1), QDate(2024, 9, 30), "机房C303").sessions, 0);
+}
+
+TEST_F(DailyLedgerTest, OnlineRecordIgnored) {
+    ledger.addRecord(createRecord("机房A101", QDate(2024, 9, 2), 0, SessionState::Online));
+    EXPECT_EQ(ledger.range(QDate(2024, 9, 1), QDate(2024, 9, 30)).sessions, 0);
+}
+
+TEST_F(DailyLedgerTest, Clear) {
+    ledger.addRecord(createRecord("机房A101", QDate(2024, 9, 2), 60));
+    ledger.clear();
+    EXPECT_EQ(ledger.range(QDate(2024, 9, 1), QDate(2024, 9, 30)).sessions, 0);
+    EXPECT_EQ(ledger.range(QDate(2024, 9, 1), QDate(2024, 9, 30), "机房A101").sessions, 0);
+}
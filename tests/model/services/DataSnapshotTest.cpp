@@ -0,0 +1,205 @@
+/**
+ * @file DataSnapshotTest.cpp
+ * @brief DataSnapshot一致性快照单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/entities/Card.h"
+#include "model/entities/Record.h"
+#include "model/repositories/StorageManager.h"
+#include "model/services/DataSnapshot.h"
+#include "model/services/TransactionManager.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+
+using namespace CampusCard;
+
+class DataSnapshotTest : public ::testing::Test {
+protected:
+    static constexpr int CARDS = 40;
+
+    QTemporaryDir tempDir;
+    std::unique_ptr<CardService> cardService;
+    std::unique_ptr<RecordService> recordService;
+    std::unique_ptr<TransactionManager> transactions;
+
+    void SetUp() override {
+        ASSERT_TRUE(tempDir.isValid());
+        StorageManager::instance().setDataPath(tempDir.path() + "/test_data");
+        StorageManager::instance().initializeDataDirectory();
+
+        // 每张卡都有一个90分钟前开始、尚未结束的会话，余额足够扣款
+        QList<Card> cards;
+        for (int i = 0; i < CARDS; ++i) {
+            cards.append(Card(cardId(i), QStringLiteral("学生%1").arg(i), studentId(i),
+                              Money::fromYuan(100)));
+            StorageManager::instance().saveRecords(studentId(i), {onlineRecord(cardId(i))});
+        }
+        StorageManager::instance().saveAllCards(cards);
+
+        cardService = std::make_unique<CardService>();
+        recordService = std::make_unique<RecordService>();
+        cardService->initialize();
+        recordService->initialize();
+        transactions = std::make_unique<TransactionManager>(cardService.get(), recordService.get());
+    }
+
+    static QString cardId(int i) { return QStringLiteral("C%1").arg(i, 3, 10, QLatin1Char('0')); }
+
+    static QString studentId(int i) {
+        return QStringLiteral("B17%1").arg(i, 6, 10, QLatin1Char('0'));
+    }
+
+    static Record onlineRecord(const QString& cardId) {
+        Record record;
+        record.setRecordId(cardId + "-online");
+        record.setCardId(cardId);
+        record.setLocation("机房A101");
+        record.setStartTime(QDateTime::currentDateTime().addSecs(-90 * 60));
+        record.setState(SessionState::Online);
+        return record;
+    }
+};
+
+// ========== 基本行为 ==========
+
+TEST_F(DataSnapshotTest, DefaultIsInvalid) {
+    DataSnapshot snapshot;
+    EXPECT_FALSE(snapshot.isValid());
+    EXPECT_EQ(snapshot.cardCount(), 0);
+    EXPECT_TRUE(snapshot.cards().isEmpty());
+    EXPECT_TRUE(snapshot.records().isEmpty());
+    EXPECT_TRUE(snapshot.findCard("C000").cardId().isEmpty());
+}
+
+TEST_F(DataSnapshotTest, ContainsCurrentState) {
+    DataSnapshot snapshot = transactions->snapshot();
+    ASSERT_TRUE(snapshot.isValid());
+    EXPECT_EQ(snapshot.epoch(), 0u);
+
+    const QList<Card> cards = snapshot.cards();
+    ASSERT_EQ(cards.size(), CARDS);
+    EXPECT_EQ(snapshot.cardCount(), CARDS);
+    for (int i = 0; i < CARDS; ++i) {
+        EXPECT_EQ(cards[i].cardId(), cardId(i));
+    }
+    EXPECT_EQ(snapshot.findCard("C007").studentId(), studentId(7));
+    EXPECT_TRUE(snapshot.findCard("C999").cardId().isEmpty());
+
+    ASSERT_EQ(snapshot.records("C007").size(), 1);
+    EXPECT_TRUE(snapshot.records("C007").first().isOnline());
+    EXPECT_EQ(snapshot.tariff().hourlyRate, recordService->tariff().hourlyRate);
+}
+
+TEST_F(DataSnapshotTest, RecordsByStudentIdFollowCards) {
+    const QMap<QString, QList<Record>> byStudent = transactions->snapshot().recordsByStudentId();
+    ASSERT_EQ(byStudent.size(), CARDS);
+    ASSERT_EQ(byStudent.value(studentId(3)).size(), 1);
+    EXPECT_EQ(byStudent.value(studentId(3)).first().cardId(), cardId(3));
+}
+
+// ========== 隔离性 ==========
+
+TEST_F(DataSnapshotTest, UnaffectedByLaterWrites) {
+    DataSnapshot before = transactions->snapshot();
+
+    const Money cost = transactions->endSession("C001").cost();
+    ASSERT_TRUE(cost.isPositive());
+    ASSERT_TRUE(cardService->recharge("C002", Money::fromYuan(50)));
+    ASSERT_TRUE(recordService->startSession("C001", "机房B202").isValid());
+
+    // 旧快照保持创建时的内容
+    EXPECT_EQ(before.findCard("C001").balance(), Money::fromYuan(100));
+    EXPECT_EQ(before.findCard("C002").balance(), Money::fromYuan(100));
+    ASSERT_EQ(before.records("C001").size(), 1);
+    EXPECT_TRUE(before.records("C001").first().isOnline());
+
+    DataSnapshot after = transactions->snapshot();
+    EXPECT_EQ(after.epoch(), before.epoch() + 1);
+    EXPECT_EQ(after.findCard("C001").balance(), Money::fromYuan(100) - cost);
+    EXPECT_EQ(after.findCard("C002").balance(), Money::fromYuan(150));
+    ASSERT_EQ(after.records("C001").size(), 2);
+    EXPECT_TRUE(after.records("C001").first().isOffline());
+}
+
+TEST_F(DataSnapshotTest, ConcurrentSnapshotsSeeWholeTransactions) {
+    // 下机线程逐张结算，同时不断创建快照：
+    // 每个快照中，每张卡的扣款额都等于其已结束记录的费用之和
+    std::atomic<bool> done{false};
+    QThread* writer = QThread::create([this, &done]() {
+        for (int i = 0; i < CARDS; ++i) {
+            transactions->endSession(cardId(i));
+        }
+        done = true;
+    });
+    writer->start();
+
+    int snapshots = 0;
+    quint64 lastEpoch = 0;
+    while (!done.load() || snapshots == 0) {
+        const DataSnapshot snapshot = transactions->snapshot();
+        EXPECT_GE(snapshot.epoch(), lastEpoch);
+        lastEpoch = snapshot.epoch();
+
+        int offline = 0;
+        for (const auto& card : snapshot.cards()) {
+            Money charged;
+            for (const auto& record : snapshot.records(card.cardId())) {
+                if (record.isOffline()) {
+                    charged += record.cost();
+                    ++offline;
+                }
+            }
+            EXPECT_EQ(Money::fromYuan(100) - card.balance(), charged)
+                << card.cardId().toStdString();
+        }
+        EXPECT_EQ(offline, static_cast<int>(snapshot.epoch()));
+        ++snapshots;
+    }
+    writer->wait();
+    delete writer;
+
+    EXPECT_EQ(transactions->snapshot().epoch(), static_cast<quint64>(CARDS));
+}
+
+// ========== 导出 ==========
+
+TEST_F(DataSnapshotTest, ExportWritesSnapshotState) {
+    DataSnapshot snapshot = transactions->snapshot();
+    ASSERT_TRUE(cardService->recharge("C001", Money::fromYuan(50)));
+
+    const QString exportPath = tempDir.path() + "/export.txt";
+    ASSERT_TRUE(StorageManager::instance().exportAllData(exportPath, snapshot));
+
+    QFile file(exportPath);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+
+    const QJsonArray cards = root["cards"].toArray();
+    ASSERT_EQ(cards.size(), CARDS);
+    const Card exported = Card::fromJson(cards[1].toObject());
+    EXPECT_EQ(exported.cardId(), "C001");
+    EXPECT_EQ(exported.balance(), Money::fromYuan(100));
+
+    const QJsonObject records = root["records"].toObject();
+    EXPECT_EQ(records.size(), CARDS);
+    EXPECT_EQ(records[studentId(1)].toArray().size(), 1);
+    EXPECT_TRUE(root.contains("tariff"));
+}
+
+TEST_F(DataSnapshotTest, ExportRejectsInvalidSnapshot) {
+    const QString exportPath = tempDir.path() + "/export.txt";
+    EXPECT_FALSE(StorageManager::instance().exportAllData(exportPath, DataSnapshot()));
+    EXPECT_FALSE(QFile::exists(exportPath));
+}
@@ -0,0 +1,171 @@
+/**
+ * @file DistinctCounterTest.cpp
+ * @brief HyperLogLog去重计数单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/DistinctCounter.h"
+
+#include <QSet>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class DistinctCounterTest : public ::testing::Test {
+protected:
+    DistinctUserSketches sketches;
+    const QDate day1 = QDate(2024, 9, 2);
+
+    static Record createRecord(const QString& cardId, const QString& location, const QDate& date,
+                               SessionState state = SessionState::Offline) {
+        Record record;
+        record.setRecordId(cardId + location + date.toString(Qt::ISODate));
+        record.setCardId(cardId);
+        record.setLocation(location);
+        record.setStartTime(QDateTime(date, QTime(9, 0)));
+        record.setEndTime(QDateTime(date, QTime(10, 0)));
+        record.setDurationMinutes(60);
+        record.setCost(Money::fromYuan(1));
+        record.setState(state);
+        return record;
+    }
+
+    static QString cardId(int i) { return QStringLiteral("C%1").arg(i, 6, 10, QLatin1Char('0')); }
+};
+
+// ========== HyperLogLog测试 ==========
+
+TEST_F(DistinctCounterTest, EmptySketch) {
+    HyperLogLog hll;
+    EXPECT_TRUE(hll.isEmpty());
+    EXPECT_EQ(hll.estimate(), 0);
+}
+
+TEST_F(DistinctCounterTest, HashIsStable) {
+    // 哈希不依赖进程种子，持久化的草图才能跨进程合并
+    EXPECT_EQ(HyperLogLog::hash("C000001"), HyperLogLog::hash(QStringLiteral("C000001")));
+    EXPECT_NE(HyperLogLog::hash("C000001"), HyperLogLog::hash("C000002"));
+}
+
+TEST_F(DistinctCounterTest, DuplicatesCountedOnce) {
+    HyperLogLog hll;
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            hll.add(cardId(i));
+        }
+    }
+    EXPECT_EQ(hll.estimate(), 100);
+}
+
+TEST_F(DistinctCounterTest, EstimateWithinErrorBound) {
+    for (int n : {1000, 10000, 100000}) {
+        HyperLogLog hll;
+        for (int i = 0; i < n; ++i) {
+            hll.add(cardId(i));
+        }
+        // 标准误差约1.6%，取4倍作为容差
+        EXPECT_NEAR(static_cast<double>(hll.estimate()), n, n * 0.065) << "n=" << n;
+    }
+}
+
+TEST_F(DistinctCounterTest, MergeIsUnion) {
+    HyperLogLog a;
+    HyperLogLog b;
+    HyperLogLog both;
+    for (int i = 0; i < 3000; ++i) {
+        a.add(cardId(i));
+        both.add(cardId(i));
+    }
+    for (int i = 2000; i < 5000; ++i) {
+        b.add(cardId(i));
+        both.add(cardId(i));
+    }
+
+    a.merge(b);
+    EXPECT_EQ(a.toByteArray(), both.toByteArray());
+
+    // 幂等：重复合并不改变结果
+    a.merge(b);
+    EXPECT_EQ(a.toByteArray(), both.toByteArray());
+}
+
+TEST_F(DistinctCounterTest, SerializationRoundTrip) {
+    for (int n : {0, 10, 5000}) {
+        HyperLogLog hll;
+        for (int i = 0; i < n; ++i) {
+            hll.add(cardId(i));
+        }
+        QByteArray bytes = hll.toByteArray();
+        EXPECT_LE(bytes.size(), HyperLogLog::REGISTER_COUNT + 1);
+
+        bool ok = false;
+        HyperLogLog restored = HyperLogLog::fromByteArray(bytes, &ok);
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(restored.estimate(), hll.estimate());
+        EXPECT_EQ(restored.toByteArray(), bytes);
+    }
+}
+
+TEST_F(DistinctCounterTest, CorruptBytesRejected) {
+    bool ok = true;
+    HyperLogLog hll = HyperLogLog::fromByteArray(QByteArray("S\x20\x00\x01", 4), &ok);
+    EXPECT_FALSE(ok);  // 下标越界
+    EXPECT_TRUE(hll.isEmpty());
+
+    HyperLogLog::fromByteArray(QByteArray("D\x01", 2), &ok);
+    EXPECT_FALSE(ok);  // 长度不符
+    HyperLogLog::fromByteArray(QByteArray(), &ok);
+    EXPECT_FALSE(ok);
+}
+
+// ========== 按日期和地点的草图测试 ==========
+
+TEST_F(DistinctCounterTest, CountsByRangeAndLocation) {
+    sketches.addRecord(createRecord("C001", "机房A101", day1));
+    sketches.addRecord(createRecord("C002", "机房A101", day1));
+    sketches.addRecord(createRecord("C001", "机房B202", day1.addDays(1)));
+    sketches.addRecord(createRecord("C003", "机房B202", day1.addDays(2)));
+
+    EXPECT_EQ(sketches.count(day1, day1.addDays(2)), 3);
+    EXPECT_EQ(sketches.count(day1, day1), 2);
+    EXPECT_EQ(sketches.count(day1, day1.addDays(2), {"机房B202"}), 2);
+    EXPECT_EQ(sketches.count(day1.addDays(1), day1.addDays(1), {"机房A101"}), 0);
+    EXPECT_EQ(sketches.count(day1, day1.addDays(2), {"机房A101", "机房B202"}), 3);
+    EXPECT_EQ(sketches.count(day1.addDays(2), day1), 0);
+}
+
+TEST_F(DistinctCounterTest, OnlineRecordIgnored) {
+    sketches.addRecord(createRecord("C001", "机房A101", day1, SessionState::Online));
+    EXPECT_TRUE(sketches.days().isEmpty());
+}
+
+TEST_F(DistinctCounterTest, JsonRoundTripMergesIdempotently) {
+    for (int i = 0; i < 50; ++i) {
+        sketches.addRecord(createRecord(cardId(i), "机房A101", day1));
+        sketches.addRecord(createRecord(cardId(i + 25), "机房B202", day1));
+    }
+
+    DistinctUserSketches restored;
+    EXPECT_TRUE(restored.mergeDayJson(day1, sketches.dayToJson(day1)));
+    EXPECT_EQ(restored.count(day1, day1), sketches.count(day1, day1));
+    EXPECT_EQ(restored.count(day1, day1, {"机房B202"}), 50);
+
+    // 重复载入同一草图不会重复计数
+    restored.merge(sketches);
+    EXPECT_EQ(restored.count(day1, day1), sketches.count(day1, day1));
+    EXPECT_NEAR(static_cast<double>(restored.count(day1, day1)), 75, 2);
+}
+
+TEST_F(DistinctCounterTest, ManyDaysMatchExact) {
+    QSet<QString> exact;
+    for (int d = 0; d < 30; ++d) {
+        for (int i = 0; i < 200; ++i) {
+            int card = (d * 37 + i * 11) % 2000;
+            sketches.addRecord(createRecord(cardId(card), "机房A101", day1.addDays(d)));
+            exact.insert(cardId(card));
+        }
+    }
+    qint64 estimate = sketches.count(day1, day1.addDays(29));
+    EXPECT_NEAR(static_cast<double>(estimate), exact.size(), exact.size() * 0.065);
+}
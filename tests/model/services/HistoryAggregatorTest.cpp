@@ -0,0 +1,175 @@
+/**
+ * @file HistoryAggregatorTest.cpp
+ * @brief HistoryAggregator全量历史汇总单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/HistoryAggregator.h"
+
+#include <QDateTime>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class HistoryAggregatorTest : public ::testing::Test {
+protected:
+    QMap<QString, QList<Record>> records;
+
+    void SetUp() override {
+        // 构造多于一个分块的卡，以覆盖分块合并
+        const QStringList locations = {QStringLiteral("机房A101"), QStringLiteral("机房B202")};
+        for (int c = 0; c < HistoryAggregator::CARDS_PER_CHUNK * 3 + 5; ++c) {
+            QString cardId = QStringLiteral("C%1").arg(c, 3, 10, QLatin1Char('0'));
+            QList<Record> list;
+            for (int r = 0; r < 4; ++r) {
+                list.append(createRecord(cardId, locations.at(r % 2), r + 1, 10 + c + r * 7));
+            }
+            records.insert(cardId, list);
+        }
+    }
+
+    Record createRecord(const QString& cardId, const QString& location, int day, int duration,
+                        SessionState state = SessionState::Offline) {
+        QDateTime start(QDate(2024, 9, day), QTime(9, 0));
+        Record record;
+        record.setRecordId(QStringLiteral("%1-%2").arg(cardId).arg(day));
+        record.setCardId(cardId);
+        record.setLocation(location);
+        record.setStartTime(start);
+        record.setEndTime(start.addSecs(duration * 60));
+        record.setDurationMinutes(duration);
+        record.setCost(COST_PER_HOUR.scaled(duration, 60));
+        record.setState(state);
+        return record;
+    }
+};
+
+// ========== 串行汇总测试 ==========
+
+TEST_F(HistoryAggregatorTest, EmptyRecords) {
+    HistorySummary summary = HistoryAggregator::summarize({}, RecordQuery(), 10);
+    EXPECT_EQ(summary.sessionCount, 0);
+    EXPECT_EQ(summary.totalDuration, 0);
+    EXPECT_EQ(summary.totalIncome, Money());
+    EXPECT_TRUE(summary.byLocation.isEmpty());
+    EXPECT_TRUE(summary.topCards.isEmpty());
+}
+
+TEST_F(HistoryAggregatorTest, TotalsMatchRecords) {
+    int count = 0;
+    int duration = 0;
+    Money income;
+    for (const auto& list : records) {
+        for (const auto& record : list) {
+            count++;
+            duration += record.durationMinutes();
+            income += record.cost();
+        }
+    }
+
+    HistorySummary summary = HistoryAggregator::summarize(records, RecordQuery(), 10);
+    EXPECT_EQ(summary.sessionCount, count);
+    EXPECT_EQ(summary.totalDuration, duration);
+    EXPECT_EQ(summary.totalIncome, income);
+
+    ASSERT_EQ(summary.byLocation.size(), 2);
+    EXPECT_EQ(summary.byLocation.value("机房A101").count +
+                  summary.byLocation.value("机房B202").count,
+              count);
+}
+
+TEST_F(HistoryAggregatorTest, TopCardsOrderedByDuration) {
+    HistorySummary summary = HistoryAggregator::summarize(records, RecordQuery(), 3);
+    ASSERT_EQ(summary.topCards.size(), 3);
+
+    // 卡序号越大时长越长
+    const QString last = records.lastKey();
+    EXPECT_EQ(summary.topCards.at(0).key, last);
+    EXPECT_GE(summary.topCards.at(0).totalDuration, summary.topCards.at(1).totalDuration);
+    EXPECT_GE(summary.topCards.at(1).totalDuration, summary.topCards.at(2).totalDuration);
+}
+
+TEST_F(HistoryAggregatorTest, OnlineRecordsIgnored) {
+    QMap<QString, QList<Record>> data;
+    data["C001"].append(createRecord("C001", "机房A101", 1, 60));
+    data["C001"].append(createRecord("C001", "机房A101", 2, 0, SessionState::Online));
+
+    HistorySummary summary = HistoryAggregator::summarize(data, RecordQuery(), 10);
+    EXPECT_EQ(summary.sessionCount, 1);
+    EXPECT_EQ(summary.totalDuration, 60);
+}
+
+TEST_F(HistoryAggregatorTest, QueryFiltersApply) {
+    RecordQuery query;
+    query.dateRange("2024-09-01", "2024-09-02").location("机房A101");
+
+    HistorySummary summary = HistoryAggregator::summarize(records, query, 10);
+    EXPECT_EQ(summary.sessionCount, records.size());
+    ASSERT_EQ(summary.byLocation.size(), 1);
+    EXPECT_TRUE(summary.byLocation.contains("机房A101"));
+
+    HistorySummary single = HistoryAggregator::summarize(records, RecordQuery().card("C001"), 10);
+    EXPECT_EQ(single.sessionCount, 4);
+    ASSERT_EQ(single.topCards.size(), 1);
+    EXPECT_EQ(single.topCards.first().key, "C001");
+}
+
+// ========== 并行汇总测试 ==========
+
+TEST_F(HistoryAggregatorTest, ParallelMatchesSequentialForAnyThreadCount) {
+    HistorySummary expected = HistoryAggregator::summarize(records, RecordQuery(), 5);
+
+    for (int threads : {1, 2, 4}) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        HistorySummary actual =
+            HistoryAggregator::summarizeAsync(records, RecordQuery(), 5, &pool).result();
+
+        EXPECT_EQ(actual.sessionCount, expected.sessionCount);
+        EXPECT_EQ(actual.totalDuration, expected.totalDuration);
+        // 分块与合并顺序固定，浮点结果逐位一致
+        EXPECT_EQ(actual.totalIncome, expected.totalIncome);
+        ASSERT_EQ(actual.topCards.size(), expected.topCards.size());
+        for (qsizetype i = 0; i < expected.topCards.size(); ++i) {
+            EXPECT_EQ(actual.topCards.at(i).key, expected.topCards.at(i).key);
+        }
+        EXPECT_EQ(actual.byLocation.keys(), expected.byLocation.keys());
+    }
+}
+
+TEST_F(HistoryAggregatorTest, ParallelReportsProgressRange) {
+    QFuture<HistorySummary> future = HistoryAggregator::summarizeAsync(records, RecordQuery(), 5);
+    future.waitForFinished();
+    EXPECT_EQ(future.progressMaximum(), 4);  // 3个完整分块 + 1个剩余分块
+    EXPECT_EQ(future.progressValue(), future.progressMaximum());
+}
+
+TEST_F(HistoryAggregatorTest, SnapshotUnaffectedByLaterChanges) {
+    QFuture<HistorySummary> future = HistoryAggregator::summarizeAsync(records, RecordQuery(), 5);
+    HistorySummary expected = HistoryAggregator::summarize(records, RecordQuery(), 5);
+
+    records["C000"].append(createRecord("C000", "机房A101", 10, 500));
+
+    EXPECT_EQ(future.result().sessionCount, expected.sessionCount);
+}
+
+TEST_F(HistoryAggregatorTest, CancelWhilePoolBusy) {
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+
+    // 先占住唯一的工作线程，保证取消发生在汇总开始之前
+    QSemaphore gate;
+    pool.start([&gate]() { gate.acquire(); });
+
+    QFuture<HistorySummary> future =
+        HistoryAggregator::summarizeAsync(records, RecordQuery(), 5, &pool);
+    future.cancel();
+    gate.release();
+    future.waitForFinished();
+
+    EXPECT_TRUE(future.isCanceled());
+    EXPECT_LT(future.progressValue(), 4);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file LoginAttemptTrackerTest.cpp
+ * @brief LoginAttemptTracker登录失败计数单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/LoginAttemptTracker.h"
+
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class LoginAttemptTrackerTest : public ::testing::Test {
+protected:
+    static constexpr qint64 MINUTE = 60 * 1000;
+
+    void SetUp() override { tracker.setWindow(10 * MINUTE); }
+
+    LoginAttemptTracker tracker;
+};
+
+// ========== 计数 ==========
+
+TEST_F(LoginAttemptTrackerTest, CountsFailuresPerCard) {
+    EXPECT_EQ(tracker.recordFailure("C001", 0), 1);
+    EXPECT_EQ(tracker.recordFailure("C001", MINUTE), 2);
+    EXPECT_EQ(tracker.recordFailure("C002", MINUTE), 1);
+    EXPECT_EQ(tracker.attempts("C001", MINUTE).value_or(-1), 2);
+    EXPECT_FALSE(tracker.attempts("C003", MINUTE).has_value());
+    EXPECT_EQ(tracker.size(), 2);
+}
+
+TEST_F(LoginAttemptTrackerTest, WindowSlidesWithLastFailure) {
+    tracker.recordFailure("C001", 0);
+    tracker.recordFailure("C001", 9 * MINUTE);
+    EXPECT_EQ(tracker.attempts("C001", 18 * MINUTE).value_or(-1), 2);
+
+    // 距最近一次失败满一个窗口后重新计数
+    EXPECT_EQ(tracker.attempts("C001", 19 * MINUTE).value_or(-1), 0);
+    EXPECT_EQ(tracker.recordFailure("C001", 19 * MINUTE), 1);
+}
+
+TEST_F(LoginAttemptTrackerTest, ZeroWindowNeverDecays) {
+    tracker.setWindow(0);
+    tracker.recordFailure("C001", 0);
+    EXPECT_EQ(tracker.recordFailure("C001", 1000 * MINUTE), 2);
+}
+
+TEST_F(LoginAttemptTrackerTest, ResetReportsZero) {
+    tracker.recordFailure("C001", 0);
+    tracker.reset("C001");
+    EXPECT_EQ(tracker.attempts("C001", 0).value_or(-1), 0);
+    EXPECT_EQ(tracker.size(), 0);
+}
+
+// ========== 写回 ==========
+
+TEST_F(LoginAttemptTrackerTest, TakeDirtyReturnsChangedCounts) {
+    tracker.recordFailure("C001", 0);
+    tracker.recordFailure("C001", 0);
+    tracker.reset("C002");
+
+    const QHash<QString, int> dirty = tracker.takeDirty(MINUTE);
+    EXPECT_EQ(dirty.size(), 2);
+    EXPECT_EQ(dirty.value("C001"), 2);
+    EXPECT_EQ(dirty.value("C002", -1), 0);
+    EXPECT_TRUE(tracker.takeDirty(MINUTE).isEmpty());
+}
+
+TEST_F(LoginAttemptTrackerTest, TakeDirtyDropsExpiredCounts) {
+    tracker.restore("C001", 2, 0);
+    EXPECT_TRUE(tracker.takeDirty(MINUTE).isEmpty());  // 载入的计数无需写回
+
+    const QHash<QString, int> dirty = tracker.takeDirty(10 * MINUTE);
+    EXPECT_EQ(dirty.value("C001", -1), 0);
+    EXPECT_EQ(tracker.size(), 0);
+}
+
+TEST_F(LoginAttemptTrackerTest, DiscardSkipsWriteBack) {
+    tracker.recordFailure("C001", 0);
+    tracker.discard("C001");
+    EXPECT_FALSE(tracker.attempts("C001", 0).has_value());
+    EXPECT_TRUE(tracker.takeDirty(0).isEmpty());
+}
@@ -0,0 +1,48 @@
+/**
+ * @file PinyinTableTest.cpp
+ * @brief PinyinTable拼音对照表单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/PinyinTable.h"
+
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+// ========== 单字测试 ==========
+
+TEST(PinyinTableTest, Syllable) {
+    EXPECT_EQ(PinyinTable::syllable(QChar(u'张')), "zhang");
+    EXPECT_EQ(PinyinTable::syllable(QChar(u'欧')), "ou");
+    EXPECT_EQ(PinyinTable::syllable(QChar(u'吕')), "lv");
+    EXPECT_TRUE(PinyinTable::syllable(QChar(u'a')).isEmpty());
+}
+
+TEST(PinyinTableTest, SurnameSyllable) {
+    EXPECT_EQ(PinyinTable::syllable(QChar(u'曾')), "ceng");
+    EXPECT_EQ(PinyinTable::surnameSyllable(QChar(u'曾')), "zeng");
+    EXPECT_EQ(PinyinTable::surnameSyllable(QChar(u'单')), "shan");
+    EXPECT_TRUE(PinyinTable::surnameSyllable(QChar(u'张')).isEmpty());
+}
+
+// ========== 搜索键测试 ==========
+
+TEST(PinyinTableTest, SearchKeysFullAndInitials) {
+    EXPECT_EQ(PinyinTable::searchKeys("张三"), QStringList({"zhangsan", "zs"}));
+    EXPECT_EQ(PinyinTable::searchKeys("欧阳 芳"), QStringList({"ouyangfang", "oyf"}));
+}
+
+TEST(PinyinTableTest, SearchKeysAddSurnameReading) {
+    EXPECT_EQ(PinyinTable::searchKeys("曾国藩"),
+              QStringList({"cengguofan", "cgf", "zengguofan", "zgf"}));
+    // 只有第一个字按姓氏读音
+    EXPECT_EQ(PinyinTable::searchKeys("田曾"), QStringList({"tianceng", "tc"}));
+}
+
+TEST(PinyinTableTest, SearchKeysKeepLatinInFullPinyin) {
+    EXPECT_EQ(PinyinTable::searchKeys("李A"), QStringList({"lia", "l"}));
+    EXPECT_TRUE(PinyinTable::searchKeys("Li Lei").isEmpty());
+    EXPECT_TRUE(PinyinTable::searchKeys("").isEmpty());
+}
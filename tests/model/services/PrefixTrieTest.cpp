@@ -0,0 +1,74 @@
+/**
+ * @file PrefixTrieTest.cpp
+ * @brief PrefixTrie前缀树单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/PrefixTrie.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace CampusCard;
+
+namespace {
+
+QList<int> sorted(QList<int> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+}  // namespace
+
+TEST(PrefixTrieTest, ValuesWithPrefix) {
+    PrefixTrie trie;
+    trie.insert("zhangsan", 1);
+    trie.insert("zhangwei", 2);
+    trie.insert("zhao", 3);
+    trie.insert("li", 4);
+
+    EXPECT_EQ(sorted(trie.valuesWithPrefix("zhang")), QList<int>({1, 2}));
+    EXPECT_EQ(sorted(trie.valuesWithPrefix("zh")), QList<int>({1, 2, 3}));
+    EXPECT_EQ(trie.valuesWithPrefix("zhangsan"), QList<int>({1}));
+    EXPECT_TRUE(trie.valuesWithPrefix("zhangsang").isEmpty());
+    EXPECT_TRUE(trie.valuesWithPrefix("wang").isEmpty());
+    EXPECT_TRUE(trie.valuesWithPrefix("").isEmpty());
+}
+
+TEST(PrefixTrieTest, SharedPrefixesShareNodes) {
+    PrefixTrie trie;
+    trie.insert("abc", 1);
+    trie.insert("abd", 2);
+    trie.insert("", 3);
+
+    // 根节点 + a + b + c + d
+    EXPECT_EQ(trie.nodeCount(), 5);
+}
+
+TEST(PrefixTrieTest, KeyWithSeveralValues) {
+    PrefixTrie trie;
+    trie.insert("zs", 1);
+    trie.insert("zs", 2);
+
+    EXPECT_EQ(sorted(trie.valuesWithPrefix("z")), QList<int>({1, 2}));
+    EXPECT_TRUE(trie.remove("zs", 1));
+    EXPECT_EQ(trie.valuesWithPrefix("zs"), QList<int>({2}));
+}
+
+TEST(PrefixTrieTest, RemoveAndClear) {
+    PrefixTrie trie;
+    trie.insert("zhang", 1);
+
+    EXPECT_FALSE(trie.remove("zhang", 2));
+    EXPECT_FALSE(trie.remove("zha", 1));
+    EXPECT_FALSE(trie.remove("wang", 1));
+    EXPECT_TRUE(trie.remove("zhang", 1));
+    EXPECT_TRUE(trie.valuesWithPrefix("z").isEmpty());
+
+    trie.insert("li", 1);
+    trie.clear();
+    EXPECT_EQ(trie.nodeCount(), 1);
+    EXPECT_TRUE(trie.valuesWithPrefix("l").isEmpty());
+}
@@ -0,0 +1,82 @@
+/**
+ * @file RechargeBatchTest.cpp
+ * @brief RechargeCsvReader充值文件读取单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/RechargeBatch.h"
+
+#include <QBuffer>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class RechargeBatchTest : public ::testing::Test {
+protected:
+    static QList<RechargeRow> readAll(QByteArray data) {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        RechargeCsvReader reader(&buffer);
+        QList<RechargeRow> rows;
+        RechargeRow row;
+        while (reader.readNext(row)) {
+            rows.append(row);
+        }
+        return rows;
+    }
+};
+
+// ========== 格式 ==========
+
+TEST_F(RechargeBatchTest, SkipsHeaderBlankAndCommentLines) {
+    const QList<RechargeRow> rows =
+        readAll("\xEF\xBB\xBF" "cardId,amount,remark\r\n# 九月\r\n\r\nC001,100,新生\r\n");
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0].line, 4);
+    EXPECT_EQ(rows[0].cardId, "C001");
+    EXPECT_EQ(rows[0].amount, Money::fromYuan(100));
+    EXPECT_TRUE(rows[0].isValid());
+}
+
+TEST_F(RechargeBatchTest, HeaderOnlyRecognizedOnFirstRow) {
+    const QList<RechargeRow> rows = readAll("C001,1\n卡号,金额\n");
+    ASSERT_EQ(rows.size(), 2);
+    EXPECT_TRUE(rows[0].isValid());
+    EXPECT_FALSE(rows[1].isValid());
+}
+
+TEST_F(RechargeBatchTest, TrimsSpacesAndQuotes) {
+    const QList<RechargeRow> rows = readAll(" \"C001\" , \"12.5\" \n");
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_TRUE(rows[0].isValid());
+    EXPECT_EQ(rows[0].cardId, "C001");
+    EXPECT_EQ(rows[0].amount, Money::fromCents(1250));
+}
+
+// ========== 校验 ==========
+
+TEST_F(RechargeBatchTest, ReportsInvalidRows) {
+    const QList<RechargeRow> rows = readAll("C001\n,5\nC001,abc\nC001,0\nC001,2.345\n");
+    ASSERT_EQ(rows.size(), 5);
+    for (const auto& row : rows) {
+        EXPECT_FALSE(row.isValid()) << row.line;
+    }
+    EXPECT_EQ(rows[2].line, 3);
+    EXPECT_EQ(rows[2].cardId, "C001");
+}
+
+TEST_F(RechargeBatchTest, SummaryDescribesOutcome) {
+    RechargeBatchReport report;
+    report.rows = 2;
+    report.validRows = 2;
+    report.total = Money::fromYuan(30);
+    report.applied = 2;
+    report.saved = true;
+    EXPECT_TRUE(report.summary().contains(QStringLiteral("30.00")));
+    EXPECT_TRUE(report.summary().contains(QStringLiteral("已为 2 行充值")));
+
+    report.applied = 0;
+    report.errors.append({2, QStringLiteral("C999"), QStringLiteral("卡不存在")});
+    EXPECT_TRUE(report.summary().contains(QStringLiteral("未充值")));
+}
@@ -0,0 +1,114 @@
+/**
+ * @file RecordQueryTest.cpp
+ * @brief RecordQuery组合查询单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/RecordQuery.h"
+
+#include <QDateTime>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class RecordQueryTest : public ::testing::Test {
+protected:
+    Record createRecord(const QString& cardId, const QString& location, const QDateTime& start,
+                        int duration, double cost,
+                        SessionState state = SessionState::Offline) {
+        Record record;
+        record.setRecordId(cardId + start.toString(Qt::ISODate));
+        record.setCardId(cardId);
+        record.setLocation(location);
+        record.setStartTime(start);
+        record.setEndTime(start.addSecs(duration * 60));
+        record.setDurationMinutes(duration);
+        record.setCost(Money::fromYuan(cost));
+        record.setState(state);
+        return record;
+    }
+
+    QDateTime day(int d) { return QDateTime(QDate(2024, 9, d), QTime(10, 0)); }
+};
+
+// ========== 过滤条件测试 ==========
+
+TEST_F(RecordQueryTest, EmptyQueryMatchesEverything) {
+    RecordQuery query;
+    EXPECT_TRUE(query.matches(createRecord("C001", "机房A101", day(1), 60, 1.0)));
+    EXPECT_TRUE(query.matches(Record()));
+}
+
+TEST_F(RecordQueryTest, CardFilter) {
+    RecordQuery query;
+    query.card("C001");
+    EXPECT_TRUE(query.matches(createRecord("C001", "机房A101", day(1), 60, 1.0)));
+    EXPECT_FALSE(query.matches(createRecord("C002", "机房A101", day(1), 60, 1.0)));
+}
+
+TEST_F(RecordQueryTest, DateRangeFilterIsInclusive) {
+    RecordQuery query;
+    query.dateRange("2024-09-02", "2024-09-04");
+    EXPECT_FALSE(query.matches(createRecord("C001", "机房A101", day(1), 60, 1.0)));
+    EXPECT_TRUE(query.matches(createRecord("C001", "机房A101", day(2), 60, 1.0)));
+    EXPECT_TRUE(query.matches(createRecord("C001", "机房A101", day(4), 60, 1.0)));
+    EXPECT_FALSE(query.matches(createRecord("C001", "机房A101", day(5), 60, 1.0)));
+}
+
+TEST_F(RecordQueryTest, EmptyLocationDoesNotFilter) {
+    RecordQuery query;
+    query.location("");
+    EXPECT_FALSE(query.locationFilter().has_value());
+    EXPECT_TRUE(query.matches(createRecord("C001", "机房B202", day(1), 60, 1.0)));
+}
+
+TEST_F(RecordQueryTest, StateDurationAndCostFilters) {
+    RecordQuery query;
+    query.state(SessionState::Offline)
+        .durationBetween(30, 90)
+        .costBetween(Money::fromYuan(0.5), Money::fromYuan(1.5));
+
+    EXPECT_TRUE(query.matches(createRecord("C001", "机房A101", day(1), 60, 1.0)));
+    EXPECT_FALSE(query.matches(createRecord("C001", "机房A101", day(1), 120, 1.0)));
+    EXPECT_FALSE(query.matches(createRecord("C001", "机房A101", day(1), 60, 2.0)));
+    EXPECT_FALSE(query.matches(
+        createRecord("C001", "机房A101", day(1), 60, 1.0, SessionState::Online)));
+}
+
+// ========== 排序与分页测试 ==========
+
+TEST_F(RecordQueryTest, LessThanAscendingAndDescending) {
+    Record shortRecord = createRecord("C001", "机房A101", day(1), 30, 0.5);
+    Record longRecord = createRecord("C001", "机房A101", day(2), 90, 1.5);
+
+    RecordQuery ascending;
+    ascending.orderBy(RecordQuery::SortField::Duration);
+    EXPECT_TRUE(ascending.lessThan(shortRecord, longRecord));
+    EXPECT_FALSE(ascending.lessThan(longRecord, shortRecord));
+
+    RecordQuery descending;
+    descending.orderBy(RecordQuery::SortField::StartTime, true);
+    EXPECT_TRUE(descending.lessThan(longRecord, shortRecord));
+}
+
+TEST_F(RecordQueryTest, SortByRecordIdFollowsCreationOrder) {
+    RecordIdGenerator generator;
+    Record first = createRecord("C002", "机房A101", day(2), 30, 0.5);
+    first.setId(generator.next());
+    Record second = createRecord("C001", "机房A101", day(1), 30, 0.5);
+    second.setId(generator.next());
+    Record legacy = createRecord("C003", "机房A101", day(3), 30, 0.5);
+
+    RecordQuery query;
+    query.orderBy(RecordQuery::SortField::RecordId);
+    EXPECT_TRUE(query.lessThan(first, second));
+    EXPECT_TRUE(query.lessThan(legacy, first));
+}
+
+TEST_F(RecordQueryTest, OffsetIsNeverNegative) {
+    RecordQuery query;
+    query.offset(-5).limit(10);
+    EXPECT_EQ(query.offsetCount(), 0);
+    EXPECT_EQ(query.limitCount(), 10);
+}
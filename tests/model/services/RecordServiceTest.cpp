@@ -11,11 +11,15 @@
 #include "model/services/RecordService.h"
 
 #include <QDate>
+#include <QDateTime>
+#include <QFile>
 #include <QSignalSpy>
 #include <QTemporaryDir>
 #include <QThread>
 #include <gtest/gtest.h>
 
+#include <atomic>
+
 using namespace CampusCard;
 
 class RecordServiceTest : public ::testing::Test {
@@ -33,9 +37,9 @@ protected:
         // 创建测试用的卡数据（RecordService 需要卡号到学号的映射）
         // 根据文档要求，记录文件以学号命名（如 B17010101.txt）
         QList<Card> testCards;
-        testCards.append(Card("C001", "张三", "B17010101", 100.0));
-        testCards.append(Card("C002", "李四", "B17010102", 100.0));
-        testCards.append(Card("C999", "测试用户", "B99999999", 100.0));
+        testCards.append(Card("C001", "张三", "B17010101", Money::fromYuan(100)));
+        testCards.append(Card("C002", "李四", "B17010102", Money::fromYuan(100)));
+        testCards.append(Card("C999", "测试用户", "B99999999", Money::fromYuan(100)));
         StorageManager::instance().saveAllCards(testCards);
 
         recordService = new RecordService();
@@ -68,6 +72,20 @@ TEST_F(RecordServiceTest, StartSession) {
     EXPECT_TRUE(record.startTime().isValid());
 }
 
+TEST_F(RecordServiceTest, SessionIdsFollowCreationOrder) {
+    Record first = recordService->startSession("C001", "机房A101");
+    Record second = recordService->startSession("C002", "机房A101");
+
+    EXPECT_TRUE(first.id().isNumeric());
+    EXPECT_TRUE(first.id() < second.id());
+
+    // 重新加载后仍能按ID找到上机中的会话
+    RecordService reloaded;
+    reloaded.initialize();
+    EXPECT_EQ(reloaded.getCurrentSession("C001").id(), first.id());
+    EXPECT_FALSE(reloaded.endSession("C002").isNegative());
+}
+
 TEST_F(RecordServiceTest, StartSessionSignals) {
     QSignalSpy startedSpy(recordService, &RecordService::sessionStarted);
     QSignalSpy changedSpy(recordService, &RecordService::recordsChanged);
@@ -92,9 +110,9 @@ TEST_F(RecordServiceTest, EndSession) {
     // 等待一小段时间以确保有时长
     QThread::msleep(100);
 
-    double cost = recordService->endSession("C001");
+    Money cost = recordService->endSession("C001");
 
-    EXPECT_GE(cost, 0.0);
+    EXPECT_FALSE(cost.isNegative());
     EXPECT_FALSE(recordService->isOnline("C001"));
 }
 
@@ -111,8 +129,8 @@ TEST_F(RecordServiceTest, EndSessionSignals) {
 }
 
 TEST_F(RecordServiceTest, EndSessionNotOnline) {
-    double cost = recordService->endSession("C001");
-    EXPECT_DOUBLE_EQ(cost, -1.0);
+    Money cost = recordService->endSession("C001");
+    EXPECT_TRUE(cost.isNegative());
 }
 
 TEST_F(RecordServiceTest, IsOnline) {
@@ -139,29 +157,96 @@ TEST_F(RecordServiceTest, GetCurrentSessionNotOnline) {
     EXPECT_FALSE(session.isValid());
 }
 
-TEST_F(RecordServiceTest, GetCurrentSessionPtr) {
+TEST_F(RecordServiceTest, GetCurrentSessionReturnsCopy) {
     recordService->startSession("C001", "机房A101");
 
-    Record* sessionPtr = recordService->getCurrentSessionPtr("C001");
-    ASSERT_NE(sessionPtr, nullptr);
-    EXPECT_EQ(sessionPtr->cardId(), "C001");
-}
-
-TEST_F(RecordServiceTest, GetCurrentSessionPtrNotOnline) {
-    Record* sessionPtr = recordService->getCurrentSessionPtr("C001");
-    EXPECT_EQ(sessionPtr, nullptr);
+    Record session = recordService->getCurrentSession("C001");
+    session.setState(SessionState::Offline);
+    EXPECT_TRUE(recordService->isOnline("C001"));
+    EXPECT_TRUE(recordService->getCurrentSession("C001").isOnline());
 }
 
 TEST_F(RecordServiceTest, CalculateCurrentCost) {
     recordService->startSession("C001", "机房A101");
 
-    double cost = recordService->calculateCurrentCost("C001");
-    EXPECT_GE(cost, 0.0);
+    Money cost = recordService->calculateCurrentCost("C001");
+    EXPECT_FALSE(cost.isNegative());
 }
 
 TEST_F(RecordServiceTest, CalculateCurrentCostNotOnline) {
-    double cost = recordService->calculateCurrentCost("C001");
-    EXPECT_DOUBLE_EQ(cost, -1.0);
+    Money cost = recordService->calculateCurrentCost("C001");
+    EXPECT_TRUE(cost.isNegative());
+}
+
+TEST_F(RecordServiceTest, SessionTimesComeFromClock) {
+    SimulatedClock clock(QDateTime(QDate(2024, 9, 2), QTime(9, 0)));
+    recordService->setClock(&clock);
+
+    Record started = recordService->startSession("C001", "机房A101");
+    EXPECT_EQ(started.startTime(), clock.now());
+
+    clock.advance(90 * 60 * 1000);
+    EXPECT_EQ(recordService->calculateCurrentCost("C001"), Money::fromCents(150));
+    EXPECT_EQ(recordService->endSession("C001"), Money::fromCents(150));
+
+    Record ended = recordService->getRecords("C001").last();
+    EXPECT_EQ(ended.endTime(), QDateTime(QDate(2024, 9, 2), QTime(10, 30)));
+    EXPECT_EQ(ended.durationMinutes(), 90);
+    EXPECT_EQ(recordService->getDailyIncome("2024-09-02"), Money::fromCents(150));
+
+    recordService->setClock(nullptr);
+    EXPECT_EQ(recordService->clock(), Clock::system());
+}
+
+// ========== 批量上下机测试 ==========
+
+TEST_F(RecordServiceTest, StartSessionsSkipsOnlineAndDuplicates) {
+    recordService->startSession("C002", "机房B202");
+
+    QSignalSpy batchSpy(recordService, &RecordService::recordsBatchChanged);
+    QSignalSpy changedSpy(recordService, &RecordService::recordsChanged);
+
+    QList<Record> started =
+        recordService->startSessions({"C001", "C002", "C001", "C999"}, "机房A101");
+
+    ASSERT_EQ(started.size(), 2);
+    EXPECT_EQ(started.at(0).cardId(), "C001");
+    EXPECT_EQ(started.at(1).cardId(), "C999");
+    EXPECT_EQ(recordService->getCurrentSession("C001").location(), "机房A101");
+    EXPECT_EQ(recordService->getCurrentSession("C002").location(), "机房B202");
+    EXPECT_EQ(recordService->getOnlineCount(), 3);
+
+    EXPECT_EQ(batchSpy.count(), 1);
+    EXPECT_EQ(batchSpy.takeFirst().at(0).toStringList(), QStringList({"C001", "C999"}));
+    EXPECT_EQ(changedSpy.count(), 0);
+
+    // 已写入记录文件
+    EXPECT_TRUE(StorageManager::instance().loadRecords("B17010101").first().isOnline());
+}
+
+TEST_F(RecordServiceTest, EndSessions) {
+    recordService->startSessions({"C001", "C002"}, "机房A101");
+
+    QSignalSpy batchSpy(recordService, &RecordService::recordsBatchChanged);
+    QSignalSpy changedSpy(recordService, &RecordService::recordsChanged);
+
+    QList<Record> closed = recordService->endSessions({"C001", "C002", "C002", "C999"});
+
+    ASSERT_EQ(closed.size(), 2);
+    for (const auto& record : closed) {
+        EXPECT_TRUE(record.isOffline());
+        EXPECT_FALSE(record.cost().isNegative());
+        EXPECT_FALSE(recordService->isOnline(record.cardId()));
+    }
+    EXPECT_EQ(recordService->getOnlineCount(), 0);
+    EXPECT_EQ(recordService->getDailySessionCount(closed.first().date()), 2);
+    EXPECT_EQ(batchSpy.count(), 1);
+    EXPECT_EQ(changedSpy.count(), 0);
+    EXPECT_TRUE(StorageManager::instance().loadRecords("B17010102").first().isOffline());
+
+    // 再次结束不产生任何修改
+    EXPECT_TRUE(recordService->endSessions({"C001", "C002"}).isEmpty());
+    EXPECT_EQ(batchSpy.count(), 1);
 }
 
 // ========== 记录查询测试 ==========
@@ -244,6 +329,431 @@ TEST_F(RecordServiceTest, GetLocations) {
     EXPECT_TRUE(locations.contains("机房B202"));
 }
 
+// ========== 视图查询测试 ==========
+
+TEST_F(RecordServiceTest, RecordsViewMatchesGetRecords) {
+    recordService->startSession("C001", "机房A101");
+    recordService->endSession("C001");
+    recordService->startSession("C001", "机房B202");
+    recordService->endSession("C001");
+
+    RecordView view = recordService->recordsView("C001");
+    QList<Record> records = recordService->getRecords("C001");
+    ASSERT_EQ(view.size(), records.size());
+    for (qsizetype i = 0; i < view.size(); ++i) {
+        EXPECT_EQ(view.at(i).recordId(), records.at(i).recordId());
+    }
+}
+
+TEST_F(RecordServiceTest, RecordsViewEmpty) {
+    RecordView view = recordService->recordsView("C999");
+    EXPECT_TRUE(view.isEmpty());
+    EXPECT_TRUE(view.begin() == view.end());
+}
+
+TEST_F(RecordServiceTest, FilteredRecordsView) {
+    recordService->startSession("C001", "机房A101");
+    recordService->endSession("C001");
+    recordService->startSession("C001", "机房B202");
+    recordService->endSession("C001");
+
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    EXPECT_EQ(recordService->filteredRecordsView("C001", today, today).size(), 2);
+    EXPECT_EQ(recordService->filteredRecordsView("C001", today, today, "机房A101").size(), 1);
+    EXPECT_TRUE(recordService->filteredRecordsView("C001", "2000-01-01", "2000-12-31").isEmpty());
+}
+
+TEST_F(RecordServiceTest, AllRecordsViewByDate) {
+    recordService->startSession("C001", "机房A101");
+    recordService->endSession("C001");
+    recordService->startSession("C002", "机房B202");
+    recordService->endSession("C002");
+
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    RecordView view = recordService->allRecordsViewByDate(today);
+    EXPECT_EQ(view.size(), 2);
+    int visited = 0;
+    for (const auto& record : view) {
+        EXPECT_EQ(record.date(), today);
+        ++visited;
+    }
+    EXPECT_EQ(visited, 2);
+}
+
+TEST_F(RecordServiceTest, RecordsViewUnaffectedByMutation) {
+    recordService->startSession("C001", "机房A101");
+
+    RecordView view = recordService->recordsView("C001");
+    RecordView query = recordService->executeQuery(RecordQuery().card("C001"));
+
+    recordService->endSession("C001");
+    recordService->startSession("C001", "机房B202");
+
+    ASSERT_EQ(view.size(), 1);
+    EXPECT_TRUE(view.at(0).isOnline());
+    EXPECT_EQ(view.at(0).location(), "机房A101");
+    ASSERT_EQ(query.size(), 1);
+    EXPECT_TRUE(query.at(0).isOnline());
+    EXPECT_EQ(recordService->recordsView("C001").size(), 2);
+}
+
+TEST_F(RecordServiceTest, RecordsViewToListIsIndependent) {
+    recordService->startSession("C001", "机房A101");
+
+    QList<Record> snapshot = recordService->recordsView("C001").toList();
+    recordService->endSession("C001");
+
+    ASSERT_EQ(snapshot.size(), 1);
+    EXPECT_TRUE(snapshot.first().isOnline());
+}
+
+// ========== 组合查询测试 ==========
+
+namespace {
+
+Record makeHistoryRecord(const QString& cardId, const QString& location, int day, int duration) {
+    Record record;
+    record.setRecordId(QStringLiteral("%1-%2-%3").arg(cardId).arg(day).arg(location));
+    record.setCardId(cardId);
+    record.setLocation(location);
+    record.setStartTime(QDateTime(QDate(2024, 9, day), QTime(9, 0)));
+    record.setEndTime(QDateTime(QDate(2024, 9, day), QTime(9, 0)).addSecs(duration * 60));
+    record.setDurationMinutes(duration);
+    record.setCost(COST_PER_HOUR.scaled(duration, 60));
+    record.setState(SessionState::Offline);
+    return record;
+}
+
+}  // namespace
+
+class RecordServiceQueryTest : public RecordServiceTest {
+protected:
+    void SetUp() override {
+        RecordServiceTest::SetUp();
+
+        QList<Record> first;
+        first.append(makeHistoryRecord("C001", "机房A101", 1, 60));
+        first.append(makeHistoryRecord("C001", "机房B202", 2, 30));
+        first.append(makeHistoryRecord("C001", "机房A101", 3, 90));
+        StorageManager::instance().saveRecords("B17010101", first);
+
+        QList<Record> second;
+        second.append(makeHistoryRecord("C002", "机房A101", 2, 120));
+        second.append(makeHistoryRecord("C002", "机房C303", 3, 45));
+        StorageManager::instance().saveRecords("B17010102", second);
+
+        recordService->initialize();
+    }
+};
+
+TEST_F(RecordServiceQueryTest, PlanPrefersSmallestIndex) {
+    EXPECT_EQ(recordService->planQuery(RecordQuery()).access,
+              RecordQueryPlan::Access::FullScan);
+    EXPECT_EQ(recordService->planQuery(RecordQuery()).candidateRows, 5);
+
+    RecordQueryPlan byCard = recordService->planQuery(RecordQuery().card("C002"));
+    EXPECT_EQ(byCard.access, RecordQueryPlan::Access::CardIndex);
+    EXPECT_EQ(byCard.candidateRows, 2);
+
+    RecordQueryPlan byDay = recordService->planQuery(RecordQuery().date("2024-09-01"));
+    EXPECT_EQ(byDay.access, RecordQueryPlan::Access::DayIndex);
+    EXPECT_EQ(byDay.candidateRows, 1);
+
+    RecordQueryPlan byLocation =
+        recordService->planQuery(RecordQuery().card("C001").location("机房C303"));
+    EXPECT_EQ(byLocation.access, RecordQueryPlan::Access::LocationIndex);
+    EXPECT_EQ(byLocation.candidateRows, 1);
+}
+
+TEST_F(RecordServiceQueryTest, ExecuteAppliesAllFilters) {
+    RecordView view = recordService->executeQuery(
+        RecordQuery().dateRange("2024-09-02", "2024-09-03").location("机房A101"));
+    ASSERT_EQ(view.size(), 2);
+    for (const auto& record : view) {
+        EXPECT_EQ(record.location(), "机房A101");
+        EXPECT_GE(record.date(), QString("2024-09-02"));
+    }
+
+    EXPECT_TRUE(recordService->executeQuery(RecordQuery().card("C001").location("机房C303"))
+                    .isEmpty());
+}
+
+TEST_F(RecordServiceQueryTest, ExecuteSortsAndPaginates) {
+    RecordView view = recordService->executeQuery(
+        RecordQuery().orderBy(RecordQuery::SortField::Duration, true).offset(1).limit(2));
+    ASSERT_EQ(view.size(), 2);
+    EXPECT_EQ(view.at(0).durationMinutes(), 90);
+    EXPECT_EQ(view.at(1).durationMinutes(), 60);
+
+    RecordView tail = recordService->executeQuery(RecordQuery().offset(10));
+    EXPECT_TRUE(tail.isEmpty());
+}
+
+TEST_F(RecordServiceQueryTest, ExecuteSeesNewSessions) {
+    recordService->startSession("C001", "机房C303");
+
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    EXPECT_EQ(recordService->executeQuery(RecordQuery().location("机房C303")).size(), 2);
+    EXPECT_EQ(recordService->executeQuery(RecordQuery().date(today)).size(), 1);
+}
+
+TEST_F(RecordServiceQueryTest, AggregateByLocation) {
+    QList<RecordGroup> groups =
+        recordService->aggregate(RecordQuery(), RecordQuery::GroupField::Location);
+    ASSERT_EQ(groups.size(), 3);
+    EXPECT_EQ(groups.at(0).key, "机房A101");
+    EXPECT_EQ(groups.at(0).count, 3);
+    EXPECT_EQ(groups.at(0).totalDuration, 270);
+    EXPECT_EQ(groups.at(0).totalCost, Money::fromYuan(4.5));
+}
+
+TEST_F(RecordServiceQueryTest, AggregateByDateWithFilter) {
+    QList<RecordGroup> groups = recordService->aggregate(RecordQuery().card("C001"),
+                                                         RecordQuery::GroupField::Date);
+    ASSERT_EQ(groups.size(), 3);
+    EXPECT_EQ(groups.at(0).key, "2024-09-01");
+    EXPECT_EQ(groups.at(2).key, "2024-09-03");
+    EXPECT_EQ(groups.at(2).totalDuration, 90);
+}
+
+// ========== 使用热力图测试 ==========
+
+TEST_F(RecordServiceQueryTest, HeatmapBuiltOnInitialize) {
+    HeatmapGrid grid = recordService->usageHeatmap("", "2024-09-01", "2024-09-30");
+    EXPECT_EQ(grid.totalSeconds(), (60 + 30 + 90 + 120 + 45) * 60);
+    EXPECT_EQ(grid, recordService->recomputeUsageHeatmap("", "2024-09-01", "2024-09-30"));
+
+    // 2024-09-02 为周一，C002 在 09:00 开始上机 120 分钟
+    HeatmapGrid a101 = recordService->usageHeatmap("机房A101", "2024-09-02", "2024-09-02");
+    EXPECT_EQ(a101.seconds(1, 9), 3600);
+    EXPECT_EQ(a101.seconds(1, 10), 3600);
+    EXPECT_EQ(recordService->heatmapLocations(),
+              QStringList({"机房A101", "机房B202", "机房C303"}));
+}
+
+TEST_F(RecordServiceTest, HeatmapUpdatedOnSessionEnd) {
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+
+    recordService->startSession("C001", "机房A101");
+    EXPECT_TRUE(recordService->heatmapLocations().isEmpty());
+
+    QThread::msleep(1100);
+    recordService->endSession("C001");
+    HeatmapGrid grid = recordService->usageHeatmap("机房A101", today, today);
+    EXPECT_GT(grid.totalSeconds(), 0);
+    EXPECT_EQ(grid, recordService->recomputeUsageHeatmap("机房A101", today, today));
+}
+
+// ========== 使用排行测试 ==========
+
+TEST_F(RecordServiceQueryTest, TopUsersAllTime) {
+    QList<RecordGroup> top = recordService->topUsers(RankMetric::Minutes, RankPeriod::AllTime, 50);
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top.at(0).key, "C001");
+    EXPECT_EQ(top.at(0).totalDuration, 180);
+    EXPECT_EQ(top.at(1).key, "C002");
+    EXPECT_EQ(top.at(1).totalDuration, 165);
+
+    // 历史记录不在本周
+    EXPECT_TRUE(recordService->topUsers(RankMetric::Spend, RankPeriod::ThisWeek, 50).isEmpty());
+}
+
+TEST_F(RecordServiceTest, TopUsersUpdatedOnSessionEnd) {
+    recordService->startSession("C001", "机房A101");
+    EXPECT_TRUE(recordService->topUsers(RankMetric::Minutes, RankPeriod::ThisWeek, 50).isEmpty());
+
+    recordService->endSession("C001");
+    QList<RecordGroup> week =
+        recordService->topUsers(RankMetric::Minutes, RankPeriod::ThisWeek, 50);
+    ASSERT_EQ(week.size(), 1);
+    EXPECT_EQ(week.first().key, "C001");
+    EXPECT_EQ(week.first().count, 1);
+}
+
+// ========== 区间台账与补录测试 ==========
+
+TEST_F(RecordServiceQueryTest, RangeTotals) {
+    LedgerTotals all = recordService->rangeTotals("2024-09-01", "2024-09-30");
+    EXPECT_EQ(all.sessions, 5);
+    EXPECT_EQ(all.minutes, 345);
+    EXPECT_EQ(all.income, Money::fromYuan(5.75));
+
+    LedgerTotals a101 = recordService->rangeTotals("2024-09-02", "2024-09-03", "机房A101");
+    EXPECT_EQ(a101.sessions, 2);
+    EXPECT_EQ(a101.minutes, 210);
+
+    EXPECT_EQ(recordService->getDailyTotalDuration("2024-09-03"), 135);
+    EXPECT_EQ(recordService->getDailyIncome("2024-09-03"), Money::fromYuan(2.25));
+}
+
+TEST_F(RecordServiceQueryTest, ImportLateRecords) {
+    QSignalSpy changedSpy(recordService, &RecordService::recordsChanged);
+
+    QList<Record> late;
+    late.append(makeHistoryRecord("C001", "机房A101", 1, 60));  // 与已有记录ID重复
+    late.append(makeHistoryRecord("C001", "机房C303", 5, 40));
+    Record online = makeHistoryRecord("C001", "机房C303", 6, 0);
+    online.setState(SessionState::Online);
+    late.append(online);
+
+    EXPECT_EQ(recordService->importRecords("C001", late), 1);
+    EXPECT_EQ(changedSpy.count(), 1);
+    EXPECT_EQ(recordService->getRecords("C001").size(), 4);
+    EXPECT_EQ(recordService->rangeTotals("2024-09-05", "2024-09-05").minutes, 40);
+    EXPECT_EQ(recordService->executeQuery(RecordQuery().location("机房C303")).size(), 2);
+    EXPECT_EQ(recordService->topUsers(RankMetric::Minutes, RankPeriod::AllTime, 1).first()
+                  .totalDuration,
+              220);
+
+    // 补录结果已持久化
+    RecordService reloaded;
+    reloaded.initialize();
+    EXPECT_EQ(reloaded.rangeTotals("2024-09-01", "2024-09-30").sessions, 6);
+}
+
+TEST_F(RecordServiceQueryTest, DistinctUsersMatchExact) {
+    QStringList a101{"机房A101"};
+    for (DistinctMode mode : {DistinctMode::Approximate, DistinctMode::Exact}) {
+        EXPECT_EQ(recordService->distinctUsers("2024-09-01", "2024-09-30", {}, mode), 2);
+        EXPECT_EQ(recordService->distinctUsers("2024-09-01", "2024-09-01", {}, mode), 1);
+        EXPECT_EQ(recordService->distinctUsers("2024-09-01", "2024-09-30", {"机房B202"}, mode), 1);
+        EXPECT_EQ(recordService->distinctUsers("2024-09-03", "2024-09-03", a101, mode), 1);
+        EXPECT_EQ(recordService->distinctUsers("2024-10-01", "2024-10-31", {}, mode), 0);
+    }
+}
+
+TEST_F(RecordServiceQueryTest, DistinctUsersPersistedWithRollups) {
+    QList<Record> late;
+    late.append(makeHistoryRecord("C001", "机房C303", 5, 40));
+    ASSERT_EQ(recordService->importRecords("C001", late), 1);
+    EXPECT_EQ(recordService->distinctUsers("2024-09-05", "2024-09-05"), 1);
+    EXPECT_TRUE(QFile::exists(testDataPath + "/rollups/2024-09-05.txt"));
+
+    // 记录文件丢失后，持久化的草图仍保留该日的去重人数
+    QFile::remove(testDataPath + "/records/B17010101.txt");
+    RecordService reloaded;
+    reloaded.initialize();
+    EXPECT_EQ(reloaded.distinctUsers("2024-09-05", "2024-09-05"), 1);
+    EXPECT_EQ(reloaded.distinctUsers("2024-09-05", "2024-09-05", {}, DistinctMode::Exact), 0);
+}
+
+TEST_F(RecordServiceQueryTest, CohortQueries) {
+    // 9月1日和9月3日都上机：只有C001
+    CardBitmap both =
+        recordService->activeCards("2024-09-01", "2024-09-01") &
+        recordService->activeCards("2024-09-03", "2024-09-03");
+    EXPECT_EQ(recordService->cohortCards(both), QStringList({"C001"}));
+
+    // 用过A101但从未用过B202：只有C002
+    CardBitmap a101Only =
+        recordService->locationCards("机房A101").andNot(recordService->locationCards("机房B202"));
+    EXPECT_EQ(recordService->cohortCards(a101Only), QStringList({"C002"}));
+
+    CardBitmap all = recordService->activeCards("2024-09-01", "2024-09-30");
+    EXPECT_EQ(all.cardinality(), 2);
+    EXPECT_TRUE(recordService->activeCards("2024-09-30", "2024-09-01").isEmpty());
+    EXPECT_TRUE(recordService->locationCards("不存在").isEmpty());
+}
+
+// ========== 计费规则测试 ==========
+
+TEST_F(RecordServiceTest, TariffPersisted) {
+    EXPECT_EQ(recordService->tariff().hourlyRate, COST_PER_HOUR);
+
+    Tariff tariff;
+    tariff.hourlyRate = Money::fromCents(150);
+    tariff.discounts.append({QStringLiteral("B1701"), 80});
+    ASSERT_TRUE(recordService->setTariff(tariff));
+
+    RecordService reloaded;
+    reloaded.initialize();
+    EXPECT_EQ(reloaded.tariff().hourlyRate, Money::fromCents(150));
+    ASSERT_EQ(reloaded.tariff().discounts.size(), 1);
+    EXPECT_EQ(reloaded.tariff().discounts.first().percent, 80);
+}
+
+TEST_F(RecordServiceQueryTest, RebillPreviewAndApply) {
+    Tariff tariff;
+    tariff.rules.append({QStringLiteral("机房A101"), 0, 24 * 60, Money::fromCents(200)});
+
+    RebillReport report = recordService->rebill(RecordQuery(), tariff);
+    EXPECT_EQ(report.examined, 5);
+    EXPECT_EQ(report.oldTotal, Money::fromYuan(5.75));
+    EXPECT_EQ(report.delta(), Money::fromYuan(4.5));
+    ASSERT_EQ(report.diffs.size(), 3);
+
+    RebillReport parallel = recordService->rebillAsync(RecordQuery(), tariff).result();
+    EXPECT_EQ(parallel.newTotal, report.newTotal);
+    EXPECT_EQ(parallel.diffs.size(), report.diffs.size());
+
+    // 预览不修改记录
+    EXPECT_EQ(recordService->rangeTotals("2024-09-01", "2024-09-30").income,
+              Money::fromYuan(5.75));
+
+    QSignalSpy changedSpy(recordService, &RecordService::recordsChanged);
+    EXPECT_EQ(recordService->applyRebill(report), 3);
+    EXPECT_EQ(changedSpy.count(), 2);
+    EXPECT_EQ(recordService->rangeTotals("2024-09-01", "2024-09-30").income,
+              Money::fromYuan(10.25));
+    EXPECT_EQ(recordService->getTotalCost("C002"), Money::fromYuan(4.75));
+
+    // 原费用已变化，重复应用不生效
+    EXPECT_EQ(recordService->applyRebill(report), 0);
+
+    RecordService reloaded;
+    reloaded.initialize();
+    EXPECT_EQ(reloaded.rangeTotals("2024-09-01", "2024-09-30").income, Money::fromYuan(10.25));
+}
+
+TEST_F(RecordServiceQueryTest, RebillUpdatesTotalsAndRankingIncrementally) {
+    Tariff tariff;
+    tariff.rules.append({QStringLiteral("机房A101"), 0, 24 * 60, Money::fromCents(200)});
+    ASSERT_EQ(recordService->applyRebill(recordService->rebill(RecordQuery(), tariff)), 3);
+
+    // 增量调整后的台账和排行与从文件重新加载的结果一致
+    RecordService reloaded;
+    reloaded.initialize();
+    for (const QString location : {QString(), QStringLiteral("机房A101")}) {
+        const LedgerTotals totals =
+            recordService->rangeTotals("2024-09-01", "2024-09-30", location);
+        const LedgerTotals expected = reloaded.rangeTotals("2024-09-01", "2024-09-30", location);
+        EXPECT_EQ(totals.income, expected.income) << qPrintable(location);
+        EXPECT_EQ(totals.sessions, expected.sessions);
+        EXPECT_EQ(totals.minutes, expected.minutes);
+    }
+    EXPECT_EQ(recordService->rangeTotals("2024-09-01", "2024-09-01").income,
+              Money::fromYuan(2));
+
+    const QList<RecordGroup> top =
+        recordService->topUsers(RankMetric::Spend, RankPeriod::AllTime, 5);
+    const QList<RecordGroup> expected =
+        reloaded.topUsers(RankMetric::Spend, RankPeriod::AllTime, 5);
+    ASSERT_EQ(top.size(), expected.size());
+    for (int i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(top[i].key, expected[i].key);
+        EXPECT_EQ(top[i].count, expected[i].count);
+        EXPECT_EQ(top[i].totalDuration, expected[i].totalDuration);
+        EXPECT_EQ(top[i].totalCost, expected[i].totalCost);
+    }
+    ASSERT_FALSE(top.isEmpty());
+    EXPECT_EQ(top.first().key, "C001");
+    EXPECT_EQ(top.first().totalCost, Money::fromYuan(5.5));
+}
+
+TEST_F(RecordServiceTest, ActiveCardsIncludeNewSessions) {
+    recordService->startSession("C001", "机房A101");
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    EXPECT_EQ(recordService->cohortCards(recordService->activeCards(today, today)),
+              QStringList({"C001"}));
+}
+
+TEST_F(RecordServiceTest, ImportNothing) {
+    QSignalSpy changedSpy(recordService, &RecordService::recordsChanged);
+    EXPECT_EQ(recordService->importRecords("C001", QList<Record>()), 0);
+    EXPECT_EQ(changedSpy.count(), 0);
+    EXPECT_EQ(recordService->getStatisticsSummary("C001"), "暂无上机记录");
+}
+
 // ========== 统计功能测试 ==========
 
 TEST_F(RecordServiceTest, GetTotalSessionCount) {
@@ -278,8 +788,8 @@ TEST_F(RecordServiceTest, GetTotalCost) {
     QThread::msleep(100);
     recordService->endSession("C001");
 
-    double cost = recordService->getTotalCost("C001");
-    EXPECT_GE(cost, 0.0);
+    Money cost = recordService->getTotalCost("C001");
+    EXPECT_FALSE(cost.isNegative());
 }
 
 TEST_F(RecordServiceTest, GetDailyIncome) {
@@ -289,8 +799,8 @@ TEST_F(RecordServiceTest, GetDailyIncome) {
     recordService->endSession("C002");
 
     QString today = QDate::currentDate().toString("yyyy-MM-dd");
-    double income = recordService->getDailyIncome(today);
-    EXPECT_GE(income, 0.0);
+    Money income = recordService->getDailyIncome(today);
+    EXPECT_FALSE(income.isNegative());
 }
 
 TEST_F(RecordServiceTest, GetDailySessionCount) {
@@ -364,3 +874,90 @@ TEST_F(RecordServiceTest, SpecialCharactersInLocation) {
     EXPECT_TRUE(record.isValid());
     EXPECT_EQ(record.location(), "机房#A-101@楼");
 }
+
+// ========== 并发测试 ==========
+
+TEST_F(RecordServiceTest, ConcurrentSessionsStayConsistent) {
+    constexpr int THREADS = 4;
+    constexpr int CARDS_PER_THREAD = 5;
+    constexpr int ROUNDS = 10;
+    for (int c = 0; c < THREADS * CARDS_PER_THREAD; ++c) {
+        recordService->registerCardStudentMapping(QStringLiteral("S%1").arg(c),
+                                                  QStringLiteral("B5%1").arg(c));
+    }
+
+    std::atomic<bool> running{true};
+    QList<QThread*> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.append(QThread::create([this, t]() {
+            for (int round = 0; round < ROUNDS; ++round) {
+                for (int i = 0; i < CARDS_PER_THREAD; ++i) {
+                    const QString cardId = QStringLiteral("S%1").arg(t * CARDS_PER_THREAD + i);
+                    EXPECT_TRUE(recordService->startSession(cardId, "机房A101").isValid());
+                    EXPECT_FALSE(recordService->endSession(cardId).isNegative());
+                }
+            }
+        }));
+    }
+    threads.append(QThread::create([this, &running]() {
+        while (running) {
+            EXPECT_LE(recordService->getOnlineCount(), THREADS);
+            const QString today = QDate::currentDate().toString("yyyy-MM-dd");
+            for (const auto& record : recordService->getAllRecordsByDate(today)) {
+                EXPECT_TRUE(record.isValid());
+            }
+            recordService->summarizeHistory();
+        }
+    }));
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (int t = 0; t < THREADS; ++t) {
+        threads.at(t)->wait();
+    }
+    running = false;
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    EXPECT_EQ(recordService->getOnlineCount(), 0);
+    for (int c = 0; c < THREADS * CARDS_PER_THREAD; ++c) {
+        EXPECT_EQ(recordService->getTotalSessionCount(QStringLiteral("S%1").arg(c)), ROUNDS);
+    }
+    EXPECT_EQ(recordService->summarizeHistory().sessionCount, THREADS * CARDS_PER_THREAD * ROUNDS);
+}
+
+TEST_F(RecordServiceTest, ConcurrentEndSessionAppliesOnce) {
+    constexpr int CARDS = 20;
+    constexpr int THREADS = 4;
+    QStringList cardIds;
+    for (int c = 0; c < CARDS; ++c) {
+        cardIds.append(QStringLiteral("S%1").arg(c));
+        recordService->registerCardStudentMapping(cardIds.last(), QStringLiteral("B5%1").arg(c));
+    }
+    recordService->startSessions(cardIds, "机房A101");
+
+    // 多个终端同时为同一批卡下机，每张卡只结算一次
+    std::atomic<int> ended{0};
+    QList<QThread*> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.append(QThread::create([this, &cardIds, &ended]() {
+            for (const auto& cardId : cardIds) {
+                if (!recordService->endSession(cardId).isNegative()) {
+                    ++ended;
+                }
+            }
+        }));
+    }
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    EXPECT_EQ(ended.load(), CARDS);
+    EXPECT_EQ(recordService->getOnlineCount(), 0);
+}
@@ -0,0 +1,199 @@
+/**
+ * @file SessionSupervisorTest.cpp
+ * @brief SessionSupervisor自动下机定时器单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/entities/Card.h"
+#include "model/repositories/StorageManager.h"
+#include "model/services/SessionSupervisor.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QMap>
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+
+using namespace CampusCard;
+
+namespace {
+
+constexpr qint64 MINUTE = 60 * 1000;
+
+}  // namespace
+
+class SessionSupervisorTest : public ::testing::Test {
+protected:
+    QTemporaryDir tempDir;
+    SimulatedClock clock{QDateTime(QDate(2024, 9, 2), QTime(8, 0))};
+    std::unique_ptr<CardService> cardService;
+    std::unique_ptr<RecordService> recordService;
+    std::unique_ptr<SessionSupervisor> supervisor;
+    QList<QPair<QString, AutoEndReason>> expired;
+
+    void SetUp() override {
+        ASSERT_TRUE(tempDir.isValid());
+        StorageManager::instance().setDataPath(tempDir.path() + "/test_data");
+        StorageManager::instance().initializeDataDirectory();
+
+        QList<Card> cards;
+        cards.append(Card("C001", "张三", "B17010101", Money::fromYuan(1)));
+        cards.append(Card("C002", "李四", "B17010102", Money::fromYuan(10)));
+        cards.append(Card("C003", "王五", "B17010103", Money::fromYuan(100)));
+        StorageManager::instance().saveAllCards(cards);
+        createServices();
+    }
+
+    void createServices() {
+        supervisor.reset();
+        cardService = std::make_unique<CardService>();
+        recordService = std::make_unique<RecordService>();
+        cardService->initialize();
+        recordService->initialize();
+        recordService->setClock(&clock);  // 监督器默认使用记录服务的时钟
+
+        supervisor = std::make_unique<SessionSupervisor>(cardService.get(), recordService.get());
+        QObject::connect(supervisor.get(), &SessionSupervisor::sessionExpired,
+                         [this](const QString& cardId, AutoEndReason reason) {
+                             expired.append({cardId, reason});
+                         });
+    }
+
+    // 开始上机，返回开始时间（毫秒）
+    qint64 start(const QString& cardId) {
+        recordService->startSession(cardId, "机房A101");
+        return recordService->getCurrentSession(cardId).startTime().toMSecsSinceEpoch();
+    }
+
+    int advanceTo(qint64 msecs) {
+        clock.setTime(QDateTime::fromMSecsSinceEpoch(msecs));
+        return supervisor->advance();
+    }
+};
+
+// ========== 余额耗尽测试 ==========
+
+TEST_F(SessionSupervisorTest, BalanceExhaustionFiresAtLastAffordableMinute) {
+    const qint64 begin = start("C001");  // 1元，每小时1元：最多60分钟
+    EXPECT_EQ(supervisor->trackedCount(), 1);
+    EXPECT_EQ(recordService->affordableMinutes("C001", Money::fromYuan(1)), 60);
+
+    const QDateTime deadline = supervisor->deadline("C001", AutoEndReason::BalanceExhausted);
+    EXPECT_GE(deadline.toMSecsSinceEpoch(), begin + 59 * MINUTE);
+    EXPECT_LT(deadline.toMSecsSinceEpoch(), begin + 59 * MINUTE + SessionSupervisor::TICK_MSECS);
+
+    EXPECT_EQ(advanceTo(begin + 58 * MINUTE), 0);
+    EXPECT_EQ(advanceTo(begin + 59 * MINUTE + SessionSupervisor::TICK_MSECS), 1);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired.first().first, "C001");
+    EXPECT_EQ(expired.first().second, AutoEndReason::BalanceExhausted);
+
+    // 每个会话只通知一次
+    EXPECT_EQ(supervisor->trackedCount(), 0);
+    EXPECT_EQ(advanceTo(begin + 120 * MINUTE), 0);
+}
+
+TEST_F(SessionSupervisorTest, RechargePostponesDeadline) {
+    const qint64 begin = start("C001");
+    ASSERT_TRUE(cardService->recharge("C001", Money::fromYuan(1)));
+
+    const QDateTime deadline = supervisor->deadline("C001", AutoEndReason::BalanceExhausted);
+    EXPECT_GE(deadline.toMSecsSinceEpoch(), begin + 119 * MINUTE);
+    EXPECT_EQ(advanceTo(begin + 100 * MINUTE), 0);
+    EXPECT_EQ(advanceTo(begin + 120 * MINUTE), 1);
+}
+
+TEST_F(SessionSupervisorTest, EndedSessionIsNotFired) {
+    const qint64 begin = start("C001");
+    recordService->endSession("C001");
+
+    EXPECT_EQ(supervisor->trackedCount(), 0);
+    EXPECT_FALSE(supervisor->deadline("C001", AutoEndReason::BalanceExhausted).isValid());
+    EXPECT_EQ(advanceTo(begin + 120 * MINUTE), 0);
+    EXPECT_TRUE(expired.isEmpty());
+}
+
+// ========== 空闲超时测试 ==========
+
+TEST_F(SessionSupervisorTest, IdleTimeoutDisabledByDefault) {
+    start("C003");
+    EXPECT_EQ(supervisor->idleTimeout(), 0);
+    EXPECT_FALSE(supervisor->deadline("C003", AutoEndReason::IdleTimeout).isValid());
+}
+
+TEST_F(SessionSupervisorTest, TouchRestartsIdleTimer) {
+    supervisor->setIdleTimeout(10);
+    const qint64 begin = clock.nowMSecs();
+    start("C003");
+
+    EXPECT_EQ(advanceTo(begin + 9 * MINUTE), 0);
+    supervisor->touch("C003");
+    EXPECT_EQ(advanceTo(begin + 15 * MINUTE), 0);
+    EXPECT_EQ(advanceTo(begin + 19 * MINUTE + SessionSupervisor::TICK_MSECS), 1);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired.first().second, AutoEndReason::IdleTimeout);
+}
+
+// ========== 跟踪测试 ==========
+
+TEST_F(SessionSupervisorTest, BatchSessionsTracked) {
+    recordService->startSessions({"C001", "C002", "C003"}, "机房A101");
+    EXPECT_EQ(supervisor->trackedCount(), 3);
+
+    recordService->endSessions({"C001", "C002"});
+    EXPECT_EQ(supervisor->trackedCount(), 1);
+}
+
+TEST_F(SessionSupervisorTest, StartTracksExistingSessions) {
+    start("C001");
+    start("C002");
+    createServices();  // 重新加载：已有的上机会话来自记录文件
+    EXPECT_EQ(supervisor->trackedCount(), 0);
+
+    supervisor->start();
+    supervisor->stop();
+    EXPECT_EQ(supervisor->trackedCount(), 2);
+    EXPECT_TRUE(supervisor->deadline("C002", AutoEndReason::BalanceExhausted).isValid());
+}
+
+TEST_F(SessionSupervisorTest, ManySessionsEachFireOnceAtDeadline) {
+    constexpr int cardCount = 2000;
+    QList<Card> cards;
+    QStringList cardIds;
+    for (int i = 0; i < cardCount; ++i) {
+        QString cardId = QStringLiteral("S%1").arg(i, 5, 10, QLatin1Char('0'));
+        cards.append(Card(cardId, "学生", QStringLiteral("B2%1").arg(i, 7, 10, QLatin1Char('0')),
+                          Money::fromCents(50 + (i % 97) * 13)));
+        cardIds.append(cardId);
+    }
+    StorageManager::instance().saveAllCards(cards);
+    createServices();
+    recordService->startSessions(cardIds, "机房A101");
+    ASSERT_EQ(supervisor->trackedCount(), cardCount);
+
+    QMap<QString, qint64> deadlines;
+    for (const auto& cardId : cardIds) {
+        deadlines.insert(cardId, supervisor->deadline(cardId, AutoEndReason::BalanceExhausted)
+                                     .toMSecsSinceEpoch());
+    }
+
+    // 按分钟推进，每个会话恰好在其到期时刻之后的第一次推进中到期
+    const qint64 begin = clock.nowMSecs();
+    for (qint64 now = begin; !deadlines.isEmpty() && now < begin + 24 * 60 * MINUTE;
+         now += MINUTE) {
+        advanceTo(now);
+        for (const auto& [cardId, reason] : std::as_const(expired)) {
+            ASSERT_TRUE(deadlines.contains(cardId));
+            EXPECT_LE(deadlines.value(cardId), now);
+            EXPECT_GT(deadlines.value(cardId), now - MINUTE);
+            deadlines.remove(cardId);
+        }
+        expired.clear();
+    }
+    EXPECT_TRUE(deadlines.isEmpty());
+    EXPECT_EQ(supervisor->trackedCount(), 0);
+}
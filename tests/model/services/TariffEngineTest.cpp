@@ -0,0 +1,257 @@
+/**
+ * @file TariffEngineTest.cpp
+ * @brief TariffEngine计费规则与批量重新计费单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/TariffEngine.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class TariffEngineTest : public ::testing::Test {
+protected:
+    const QString library = QStringLiteral("图书馆电子阅览室");
+
+    QDateTime at(int hour, int minute) const {
+        return QDateTime(QDate(2024, 9, 2), QTime(hour, minute));
+    }
+
+    // 夜间（22:00-07:00，跨午夜）半价
+    Tariff nightTariff() const {
+        Tariff tariff;
+        tariff.rules.append({QString(), 22 * 60, 7 * 60, Money::fromCents(50)});
+        return tariff;
+    }
+
+    Record createRecord(const QString& cardId, const QString& location, int day, int duration,
+                        SessionState state = SessionState::Offline) {
+        QDateTime start(QDate(2024, 9, day), QTime(21, 0));
+        Record record;
+        record.setRecordId(QStringLiteral("%1-%2").arg(cardId).arg(day));
+        record.setCardId(cardId);
+        record.setLocation(location);
+        record.setStartTime(start);
+        record.setEndTime(start.addSecs(duration * 60));
+        record.setDurationMinutes(duration);
+        record.setCost(COST_PER_HOUR.scaled(duration, 60));
+        record.setState(state);
+        return record;
+    }
+
+    // 构造多于一个分块的卡，以覆盖分块合并
+    QMap<QString, QList<Record>> createRecords(QMap<QString, QString>& studentIds) {
+        QMap<QString, QList<Record>> records;
+        for (int c = 0; c < TariffEngine::CARDS_PER_CHUNK * 3 + 5; ++c) {
+            QString cardId = QStringLiteral("C%1").arg(c, 3, 10, QLatin1Char('0'));
+            studentIds.insert(cardId, QStringLiteral("%1%2").arg(c % 2 ? "S" : "B").arg(c));
+            QList<Record> list;
+            for (int r = 0; r < 4; ++r) {
+                list.append(createRecord(cardId, r % 2 ? library : QStringLiteral("机房A101"),
+                                         r + 1, 10 + c + r * 7));
+            }
+            list.append(createRecord(cardId, library, 9, 0, SessionState::Online));
+            records.insert(cardId, list);
+        }
+        return records;
+    }
+};
+
+// ========== 单次计费测试 ==========
+
+TEST_F(TariffEngineTest, DefaultTariffMatchesFlatRate) {
+    TariffEngine engine;
+    for (int minutes = 0; minutes <= 3000; ++minutes) {
+        ASSERT_EQ(engine.cost("机房A101", at(9, 17), minutes), COST_PER_HOUR.scaled(minutes, 60))
+            << minutes;
+    }
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), -5), Money());
+}
+
+TEST_F(TariffEngineTest, TimeWindowSplitsSession) {
+    TariffEngine engine(nightTariff());
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 60), Money::fromCents(100));
+    // 21:30-22:30：30分钟全价 + 30分钟半价
+    EXPECT_EQ(engine.cost("机房A101", at(21, 30), 60), Money::fromCents(75));
+    // 06:30-07:30：30分钟半价 + 30分钟全价
+    EXPECT_EQ(engine.cost("机房A101", at(6, 30), 60), Money::fromCents(75));
+}
+
+TEST_F(TariffEngineTest, WindowWrapsPastMidnight) {
+    TariffEngine engine(nightTariff());
+    // 23:30-01:30 全部在夜间时段
+    EXPECT_EQ(engine.cost("机房A101", at(23, 30), 120), Money::fromCents(100));
+}
+
+TEST_F(TariffEngineTest, MultiDaySession) {
+    TariffEngine engine(nightTariff());
+    // 每天：9小时半价 + 15小时全价 = 1950分；再加09:00起的1小时全价
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 2 * 24 * 60 + 60), Money::fromCents(4000));
+}
+
+TEST_F(TariffEngineTest, LocationRuleOverridesGlobalRule) {
+    Tariff tariff = nightTariff();
+    tariff.rules.append({library, 0, 24 * 60, Money::fromCents(80)});
+    TariffEngine engine(tariff);
+
+    EXPECT_EQ(engine.cost(library, at(9, 0), 60), Money::fromCents(80));
+    EXPECT_EQ(engine.cost(library, at(23, 0), 60), Money::fromCents(80));
+    EXPECT_EQ(engine.cost("机房A101", at(23, 0), 60), Money::fromCents(50));
+    EXPECT_EQ(engine.cost("未知地点", at(9, 0), 60), Money::fromCents(100));
+}
+
+TEST_F(TariffEngineTest, LongestDiscountPrefixWins) {
+    Tariff tariff;
+    tariff.discounts.append({QStringLiteral("S"), 80});
+    tariff.discounts.append({QStringLiteral("S2024"), 50});
+    TariffEngine engine(tariff);
+
+    EXPECT_EQ(engine.discountPercent("S2024001"), 50);
+    EXPECT_EQ(engine.discountPercent("S1999001"), 80);
+    EXPECT_EQ(engine.discountPercent("B2024001"), 100);
+    EXPECT_EQ(engine.discountPercent(QString()), 100);
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 60, "S2024001"), Money::fromCents(50));
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 45, "S1999001"), Money::fromCents(60));
+}
+
+TEST_F(TariffEngineTest, MinimumCharge) {
+    Tariff tariff;
+    tariff.minimumCharge = Money::fromCents(20);
+    TariffEngine engine(tariff);
+
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 5), Money::fromCents(20));
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 60), Money::fromCents(100));
+    EXPECT_EQ(engine.cost("机房A101", at(9, 0), 0), Money());
+}
+
+// ========== JSON测试 ==========
+
+TEST_F(TariffEngineTest, JsonRoundTrip) {
+    Tariff tariff = nightTariff();
+    tariff.hourlyRate = Money::fromCents(120);
+    tariff.minimumCharge = Money::fromCents(10);
+    tariff.rules.append({library, 8 * 60, 12 * 60, Money::fromCents(80)});
+    tariff.discounts.append({QStringLiteral("S"), 80});
+
+    Tariff loaded = Tariff::fromJson(tariff.toJson());
+    EXPECT_EQ(loaded.hourlyRate, tariff.hourlyRate);
+    EXPECT_EQ(loaded.minimumCharge, tariff.minimumCharge);
+    ASSERT_EQ(loaded.rules.size(), 2);
+    EXPECT_EQ(loaded.rules.at(1).location, library);
+    EXPECT_EQ(loaded.rules.at(1).startMinute, 8 * 60);
+    EXPECT_EQ(loaded.rules.at(1).endMinute, 12 * 60);
+    EXPECT_EQ(loaded.rules.at(1).hourlyRate, Money::fromCents(80));
+    ASSERT_EQ(loaded.discounts.size(), 1);
+    EXPECT_EQ(loaded.discounts.first().percent, 80);
+}
+
+TEST_F(TariffEngineTest, JsonDefaultsAndInvalidRules) {
+    Tariff empty = Tariff::fromJson(QJsonObject());
+    EXPECT_EQ(empty.hourlyRate, COST_PER_HOUR);
+    EXPECT_TRUE(empty.rules.isEmpty());
+
+    QJsonObject rule;
+    rule["startMinute"] = 1500;  // 超出一天
+    rule["endMinute"] = 60;
+    rule["hourlyRateCents"] = 50;
+    QJsonObject json;
+    json["rules"] = QJsonArray{rule};
+    EXPECT_TRUE(Tariff::fromJson(json).rules.isEmpty());
+}
+
+// ========== 批量重新计费测试 ==========
+
+TEST_F(TariffEngineTest, RebillReportsChangedRecords) {
+    QMap<QString, QString> studentIds;
+    QMap<QString, QList<Record>> records = createRecords(studentIds);
+
+    // 默认规则与记录中的费用一致
+    RebillReport unchanged = TariffEngine().rebill(records, studentIds, RecordQuery());
+    EXPECT_EQ(unchanged.examined, records.size() * 4);
+    EXPECT_TRUE(unchanged.diffs.isEmpty());
+    EXPECT_EQ(unchanged.delta(), Money());
+
+    Tariff doubled;
+    doubled.hourlyRate = COST_PER_HOUR * 2;
+    RebillReport report = TariffEngine(doubled).rebill(records, studentIds, RecordQuery());
+    EXPECT_EQ(report.examined, records.size() * 4);
+    EXPECT_EQ(report.diffs.size(), report.examined);
+    EXPECT_EQ(report.oldTotal, unchanged.oldTotal);
+    for (const auto& diff : report.diffs) {
+        EXPECT_GT(diff.newCost, diff.oldCost) << diff.recordId.toString().toStdString();
+    }
+
+    // 记录本身不被修改
+    EXPECT_EQ(records.first().first().cost(), COST_PER_HOUR.scaled(10, 60));
+}
+
+TEST_F(TariffEngineTest, RebillRespectsQuery) {
+    QMap<QString, QString> studentIds;
+    QMap<QString, QList<Record>> records = createRecords(studentIds);
+    TariffEngine engine(nightTariff());
+
+    RebillReport single = engine.rebill(records, studentIds, RecordQuery().card("C001"));
+    EXPECT_EQ(single.examined, 4);
+    for (const auto& diff : single.diffs) {
+        EXPECT_EQ(diff.cardId, "C001");
+    }
+
+    RebillReport located = engine.rebill(records, studentIds, RecordQuery().location(library));
+    EXPECT_EQ(located.examined, records.size() * 2);
+}
+
+TEST_F(TariffEngineTest, RebillAppliesStudentDiscount) {
+    QMap<QString, QString> studentIds;
+    QMap<QString, QList<Record>> records = createRecords(studentIds);
+    Tariff tariff;
+    tariff.discounts.append({QStringLiteral("S"), 50});
+
+    RebillReport report = TariffEngine(tariff).rebill(records, studentIds, RecordQuery());
+    ASSERT_FALSE(report.diffs.isEmpty());
+    for (const auto& diff : report.diffs) {
+        EXPECT_TRUE(studentIds.value(diff.cardId).startsWith("S"));
+        EXPECT_LT(diff.newCost, diff.oldCost);
+    }
+}
+
+TEST_F(TariffEngineTest, ParallelMatchesSequentialForAnyThreadCount) {
+    QMap<QString, QString> studentIds;
+    QMap<QString, QList<Record>> records = createRecords(studentIds);
+    Tariff tariff = nightTariff();
+    tariff.discounts.append({QStringLiteral("S"), 80});
+    TariffEngine engine(tariff);
+    RebillReport expected = engine.rebill(records, studentIds, RecordQuery());
+    ASSERT_FALSE(expected.diffs.isEmpty());
+
+    for (int threads : {1, 2, 4}) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        RebillReport actual =
+            engine.rebillAsync(records, studentIds, RecordQuery(), &pool).result();
+
+        EXPECT_EQ(actual.examined, expected.examined);
+        EXPECT_EQ(actual.oldTotal, expected.oldTotal);
+        EXPECT_EQ(actual.newTotal, expected.newTotal);
+        ASSERT_EQ(actual.diffs.size(), expected.diffs.size());
+        for (qsizetype i = 0; i < expected.diffs.size(); ++i) {
+            EXPECT_EQ(actual.diffs.at(i).recordId, expected.diffs.at(i).recordId);
+            EXPECT_EQ(actual.diffs.at(i).newCost, expected.diffs.at(i).newCost);
+        }
+    }
+}
+
+TEST_F(TariffEngineTest, CsvReport) {
+    RebillReport report;
+    report.diffs.append({RecordId::fromString("R1"), "C001", "2024-09-01", Money::fromCents(100),
+                         Money::fromCents(75)});
+
+    const QStringList lines = report.toCsv().split('\n', Qt::SkipEmptyParts);
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_EQ(lines.at(0), "recordId,cardId,date,oldCost,newCost,delta");
+    EXPECT_EQ(lines.at(1), "R1,C001,2024-09-01,1.00,0.75,-0.25");
+}
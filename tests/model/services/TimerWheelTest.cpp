@@ -0,0 +1,127 @@
+/**
+ * @file TimerWheelTest.cpp
+ * @brief TimerWheel分层时间轮单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/TimerWheel.h"
+
+#include <QMap>
+#include <QRandomGenerator>
+#include <gtest/gtest.h>
+
+#include <iterator>
+
+using namespace CampusCard;
+
+// ========== 基本操作测试 ==========
+
+TEST(TimerWheelTest, FiresAtExpiryTick) {
+    TimerWheel wheel(1000);
+    quint64 id = wheel.schedule("C001", 1010);
+
+    EXPECT_TRUE(wheel.advance(1009).isEmpty());
+    QList<TimerWheel::Timer> expired = wheel.advance(1010);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired.first().id, id);
+    EXPECT_EQ(expired.first().key, "C001");
+    EXPECT_TRUE(wheel.isEmpty());
+}
+
+TEST(TimerWheelTest, PastExpiryFiresOnNextTick) {
+    TimerWheel wheel(1000);
+    wheel.schedule("C001", 10);
+
+    EXPECT_EQ(wheel.advance(1001).size(), 1);
+}
+
+TEST(TimerWheelTest, CancelledTimerDoesNotFire) {
+    TimerWheel wheel(0);
+    quint64 id = wheel.schedule("C001", 5);
+    wheel.schedule("C002", 5);
+
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.isPending(id));
+
+    QList<TimerWheel::Timer> expired = wheel.advance(10);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired.first().key, "C002");
+}
+
+TEST(TimerWheelTest, CascadesFromHigherLevels) {
+    TimerWheel wheel(123);
+    // 分别落在第1、2、3层
+    const QList<qint64> expiries = {123 + 100, 123 + 5000, 123 + 300000};
+    for (qint64 expiry : expiries) {
+        quint64 id = wheel.schedule(QString::number(expiry), expiry);
+        EXPECT_EQ(wheel.expiryOf(id), expiry);
+    }
+
+    for (qint64 expiry : expiries) {
+        EXPECT_TRUE(wheel.advance(expiry - 1).isEmpty()) << expiry;
+        QList<TimerWheel::Timer> expired = wheel.advance(expiry);
+        ASSERT_EQ(expired.size(), 1) << expiry;
+        EXPECT_EQ(expired.first().key, QString::number(expiry));
+    }
+}
+
+TEST(TimerWheelTest, BeyondSpanIsNotFiredEarly) {
+    TimerWheel wheel(0);
+    const qint64 expiry = TimerWheel::SPAN + 1000;
+    wheel.schedule("C001", expiry);
+
+    EXPECT_TRUE(wheel.advance(expiry - 1).isEmpty());
+    EXPECT_EQ(wheel.advance(expiry).size(), 1);
+}
+
+TEST(TimerWheelTest, EmptyWheelSkipsAhead) {
+    TimerWheel wheel(0);
+    quint64 id = wheel.schedule("C001", 100);
+    wheel.cancel(id);
+
+    EXPECT_TRUE(wheel.advance(TimerWheel::SPAN * 10).isEmpty());
+    EXPECT_EQ(wheel.currentTick(), TimerWheel::SPAN * 10);
+
+    wheel.schedule("C002", TimerWheel::SPAN * 10 + 3);
+    EXPECT_EQ(wheel.advance(TimerWheel::SPAN * 10 + 3).size(), 1);
+}
+
+// ========== 随机对照测试 ==========
+
+TEST(TimerWheelTest, MatchesReferenceUnderRandomOperations) {
+    QRandomGenerator rng(20240901);
+    TimerWheel wheel(5000);
+    QMap<quint64, qint64> reference;
+    qint64 now = 5000;
+
+    for (int step = 0; step < 5000; ++step) {
+        const int op = rng.bounded(10);
+        if (op < 5) {
+            const qint64 delay = rng.bounded(4) == 0 ? rng.bounded(qint64(300000))
+                                                     : rng.bounded(qint64(5000)) - 10;
+            const quint64 id = wheel.schedule("k", now + delay);
+            reference.insert(id, qMax(now + delay, now + 1));
+        } else if (op < 6 && !reference.isEmpty()) {
+            auto it = std::next(reference.begin(), rng.bounded(static_cast<int>(reference.size())));
+            EXPECT_TRUE(wheel.cancel(it.key()));
+            reference.erase(it);
+        } else {
+            const qint64 target = now + rng.bounded(qint64(2000));
+            qint64 last = now;
+            for (const auto& timer : wheel.advance(target)) {
+                ASSERT_TRUE(reference.contains(timer.id));
+                EXPECT_EQ(timer.expiryTick, reference.value(timer.id));
+                EXPECT_GE(timer.expiryTick, last);
+                last = timer.expiryTick;
+                reference.remove(timer.id);
+            }
+            for (qint64 expiry : reference) {
+                ASSERT_GT(expiry, target);
+            }
+            now = target;
+        }
+        ASSERT_EQ(wheel.size(), reference.size());
+    }
+}
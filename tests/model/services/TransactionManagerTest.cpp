@@ -0,0 +1,345 @@
+/**
+ * @file TransactionManagerTest.cpp
+ * @brief TransactionManager下机结算事务单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/entities/Card.h"
+#include "model/entities/Record.h"
+#include "model/repositories/StorageManager.h"
+#include "model/services/TransactionManager.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QTemporaryDir>
+#include <QThread>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+
+using namespace CampusCard;
+
+class TransactionManagerTest : public ::testing::Test {
+protected:
+    QTemporaryDir tempDir;
+    std::unique_ptr<CardService> cardService;
+    std::unique_ptr<RecordService> recordService;
+    std::unique_ptr<TransactionManager> transactions;
+
+    void SetUp() override {
+        ASSERT_TRUE(tempDir.isValid());
+        StorageManager::instance().setDataPath(tempDir.path() + "/test_data");
+        StorageManager::instance().initializeDataDirectory();
+
+        QList<Card> cards;
+        cards.append(Card("C001", "张三", "B17010101", Money::fromYuan(100)));
+        cards.append(Card("C002", "李四", "B17010102", Money::fromCents(50)));
+        StorageManager::instance().saveAllCards(cards);
+
+        // 90分钟前开始、尚未结束的会话，保证下机费用为正
+        StorageManager::instance().saveRecords("B17010101", {onlineRecord("C001")});
+        StorageManager::instance().saveRecords("B17010102", {onlineRecord("C002")});
+
+        restart();
+    }
+
+    static Record onlineRecord(const QString& cardId) {
+        Record record;
+        record.setRecordId(cardId + "-online");
+        record.setCardId(cardId);
+        record.setLocation("机房A101");
+        record.setStartTime(QDateTime::currentDateTime().addSecs(-90 * 60));
+        record.setState(SessionState::Online);
+        return record;
+    }
+
+    // 模拟进程重启：丢弃内存状态，从数据文件重新加载
+    void restart() {
+        transactions.reset();
+        cardService = std::make_unique<CardService>();
+        recordService = std::make_unique<RecordService>();
+        cardService->initialize();
+        recordService->initialize();
+        transactions = std::make_unique<TransactionManager>(cardService.get(), recordService.get());
+    }
+
+    Record lastRecord(const QString& cardId) const {
+        return recordService->getRecords(cardId).last();
+    }
+};
+
+// ========== 提交测试 ==========
+
+TEST_F(TransactionManagerTest, EndSessionWritesSingleJournalEntry) {
+    const Record closed = transactions->endSession("C001");
+    const Money cost = closed.cost();
+    ASSERT_TRUE(cost.isPositive());
+
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+    EXPECT_TRUE(lastRecord("C001").isOffline());
+    EXPECT_EQ(lastRecord("C001").cost(), cost);
+    EXPECT_EQ(closed.durationMinutes(), lastRecord("C001").durationMinutes());
+    EXPECT_GE(closed.durationMinutes(), 90);
+    EXPECT_FALSE(recordService->isOnline("C001"));
+    EXPECT_EQ(transactions->pendingCount(), 1);
+
+    // 只追加了日志，卡文件和记录文件尚未重写
+    QList<QJsonObject> journal = StorageManager::instance().loadJournal();
+    ASSERT_EQ(journal.size(), 1);
+    EXPECT_EQ(journal.first()["cardId"].toString(), "C001");
+    EXPECT_EQ(Money::fromJson(journal.first(), "debit"), cost);
+    EXPECT_EQ(StorageManager::instance().loadCard("C001").balance(), Money::fromYuan(100));
+    EXPECT_TRUE(StorageManager::instance().loadRecords("B17010101").first().isOnline());
+}
+
+TEST_F(TransactionManagerTest, EndSessionNotOnline) {
+    ASSERT_TRUE(transactions->endSession("C001").cost().isPositive());
+    EXPECT_FALSE(transactions->endSession("C001").isValid());
+    EXPECT_FALSE(transactions->endSession("C999").isValid());
+    EXPECT_EQ(StorageManager::instance().loadJournal().size(), 1);
+}
+
+TEST_F(TransactionManagerTest, InsufficientBalanceClosesWithoutDebit) {
+    Money cost = transactions->endSession("C002").cost();
+    ASSERT_GT(cost, Money::fromCents(50));
+
+    EXPECT_TRUE(lastRecord("C002").isOffline());
+    EXPECT_EQ(cardService->getBalance("C002"), Money::fromCents(50));
+    EXPECT_TRUE(Money::fromJson(StorageManager::instance().loadJournal().first(), "debit")
+                    .isZero());
+}
+
+TEST_F(TransactionManagerTest, EndSessionsWritesOneEntryForBatch) {
+    QList<Record> closed = transactions->endSessions({"C001", "C002", "C001", "C999"});
+    ASSERT_EQ(closed.size(), 2);
+    const Money cost = closed.at(0).cost();
+
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+    EXPECT_EQ(cardService->getBalance("C002"), Money::fromCents(50));  // 余额不足不扣款
+    EXPECT_FALSE(recordService->isOnline("C001"));
+    EXPECT_FALSE(recordService->isOnline("C002"));
+    EXPECT_EQ(transactions->pendingCount(), 1);
+
+    QList<QJsonObject> journal = StorageManager::instance().loadJournal();
+    ASSERT_EQ(journal.size(), 1);
+    EXPECT_EQ(journal.first()["items"].toArray().size(), 2);
+
+    EXPECT_TRUE(transactions->endSessions({"C001", "C002"}).isEmpty());
+    EXPECT_EQ(StorageManager::instance().loadJournal().size(), 1);
+}
+
+TEST_F(TransactionManagerTest, RecoverReplaysBatchOnce) {
+    QList<Record> closed = transactions->endSessions({"C001", "C002"});
+    ASSERT_EQ(closed.size(), 2);
+    const Money cost = closed.at(0).cost();
+
+    // 检查点只写完了卡文件就崩溃
+    ASSERT_TRUE(cardService->saveAll());
+    restart();
+    EXPECT_EQ(transactions->recover(), 1);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+    EXPECT_EQ(lastRecord("C002").cost(), closed.at(1).cost());
+    EXPECT_FALSE(recordService->isOnline("C001"));
+
+    restart();
+    EXPECT_EQ(transactions->recover(), 0);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+}
+
+TEST_F(TransactionManagerTest, CheckpointWritesFilesAndClearsJournal) {
+    Money cost = transactions->endSession("C001").cost();
+    ASSERT_TRUE(transactions->checkpoint());
+
+    EXPECT_EQ(transactions->pendingCount(), 0);
+    EXPECT_TRUE(StorageManager::instance().loadJournal().isEmpty());
+    Card card = StorageManager::instance().loadCard("C001");
+    EXPECT_EQ(card.balance(), Money::fromYuan(100) - cost);
+    EXPECT_EQ(card.journalSequence(), 1u);
+    EXPECT_TRUE(StorageManager::instance().loadRecords("B17010101").first().isOffline());
+}
+
+TEST_F(TransactionManagerTest, SignalsEmittedAfterLocksReleased) {
+    // 槽函数重入事务管理器：若信号在提交锁或快照写锁内发出会死锁
+    quint64 epochInSlot = 0;
+    int pendingInSlot = -1;
+    Money balanceInSlot;
+    QObject::connect(recordService.get(), &RecordService::sessionEnded,
+                     [&](const QString&, Money, int) {
+                         epochInSlot = transactions->snapshot().epoch();
+                         pendingInSlot = transactions->pendingCount();
+                     });
+    QObject::connect(cardService.get(), &CardService::balanceChanged,
+                     [&](const QString&, Money balance) { balanceInSlot = balance; });
+    int checkpointedCount = 0;
+    QObject::connect(transactions.get(), &TransactionManager::checkpointed, [&](int count) {
+        checkpointedCount = count;
+        EXPECT_TRUE(transactions->checkpoint());
+    });
+
+    Money cost = transactions->endSession("C001").cost();
+    ASSERT_TRUE(cost.isPositive());
+    EXPECT_EQ(epochInSlot, 1u);
+    EXPECT_EQ(pendingInSlot, 1);
+    EXPECT_EQ(balanceInSlot, Money::fromYuan(100) - cost);
+
+    ASSERT_TRUE(transactions->checkpoint());
+    EXPECT_EQ(checkpointedCount, 1);
+}
+
+TEST_F(TransactionManagerTest, ConcurrentDeductsWhileEndingSessionsNeverOverdraw) {
+    constexpr int CARDS = 32;
+    constexpr int THREADS = 4;
+    QStringList cardIds;
+    for (int c = 0; c < CARDS; ++c) {
+        const QString cardId = QStringLiteral("D%1").arg(c);
+        const QString studentId = QStringLiteral("BD%1").arg(c);
+        ASSERT_TRUE(cardService->createCard(cardId, QStringLiteral("学生%1").arg(c), studentId,
+                                            Money()));
+        StorageManager::instance().saveRecords(studentId, {onlineRecord(cardId)});
+        cardIds.append(cardId);
+    }
+    restart();
+
+    // 余额只比下机费用多几分钱，直接扣款稍有插入就会让下机扣款透支
+    Money initialTotal;
+    for (const auto& cardId : cardIds) {
+        const Money amount = recordService->prepareEndSession(cardId).cost() + Money::fromCents(3);
+        ASSERT_TRUE(cardService->recharge(cardId, amount));
+        initialTotal += amount;
+    }
+
+    std::atomic<int> deducted{0};
+    std::atomic<bool> running{true};
+    QList<QThread*> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.append(QThread::create([&, t]() {
+            for (int i = t; running; ++i) {
+                if (cardService->deduct(cardIds.at(i % CARDS), Money::fromCents(1))) {
+                    ++deducted;
+                }
+            }
+        }));
+    }
+    // 同时反复冻结、解冻前几张卡
+    threads.append(QThread::create([&]() {
+        while (running) {
+            for (int c = 0; c < 4; ++c) {
+                cardService->freeze(cardIds.at(c));
+                cardService->unfreeze(cardIds.at(c));
+            }
+        }
+    }));
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+
+    // 一半逐张下机，一半按4张一批下机
+    for (int c = 0; c < CARDS / 2; ++c) {
+        EXPECT_TRUE(transactions->endSession(cardIds.at(c)).isValid());
+    }
+    for (int c = CARDS / 2; c < CARDS; c += 4) {
+        EXPECT_EQ(transactions->endSessions(cardIds.mid(c, 4)).size(), 4);
+    }
+    running = false;
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    // 日志中记下的扣款就是实际生效的扣款
+    Money journaled;
+    for (const auto& entry : StorageManager::instance().loadJournal()) {
+        journaled += Money::fromJson(entry, "debit");
+        for (const auto& item : entry["items"].toArray()) {
+            journaled += Money::fromJson(item.toObject(), "debit");
+        }
+    }
+    Money finalTotal;
+    for (const auto& cardId : cardIds) {
+        EXPECT_FALSE(cardService->getBalance(cardId).isNegative()) << cardId.toStdString();
+        EXPECT_FALSE(recordService->isOnline(cardId));
+        finalTotal += cardService->getBalance(cardId);
+    }
+    EXPECT_EQ(finalTotal, initialTotal - Money::fromCents(deducted.load()) - journaled);
+    EXPECT_TRUE(cardService->reconcileLedger().isClean());
+}
+
+// ========== 恢复测试 ==========
+
+TEST_F(TransactionManagerTest, RecoverReplaysCommittedTransactions) {
+    Money cost1 = transactions->endSession("C001").cost();
+    Money cost2 = transactions->endSession("C002").cost();
+
+    restart();  // 崩溃：内存中的修改丢失，只剩日志
+    EXPECT_TRUE(recordService->isOnline("C001"));
+    EXPECT_EQ(transactions->recover(), 2);
+
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost1);
+    EXPECT_EQ(cardService->getBalance("C002"), Money::fromCents(50));
+    EXPECT_EQ(lastRecord("C001").cost(), cost1);
+    EXPECT_EQ(lastRecord("C002").cost(), cost2);
+    EXPECT_FALSE(recordService->isOnline("C001"));
+    EXPECT_EQ(recordService->getDailyIncome(lastRecord("C001").date()), cost1 + cost2);
+
+    // 恢复后已检查点
+    EXPECT_TRUE(StorageManager::instance().loadJournal().isEmpty());
+    EXPECT_EQ(StorageManager::instance().loadCard("C001").balance(), Money::fromYuan(100) - cost1);
+}
+
+TEST_F(TransactionManagerTest, RecoverAfterPartialCheckpointIsIdempotent) {
+    Money cost = transactions->endSession("C001").cost();
+
+    // 检查点只写完了卡文件就崩溃
+    ASSERT_TRUE(cardService->saveAll());
+    restart();
+    EXPECT_EQ(transactions->recover(), 1);  // 只有记录部分需要重放
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+    EXPECT_TRUE(lastRecord("C001").isOffline());
+
+    restart();
+    EXPECT_EQ(transactions->recover(), 0);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+}
+
+TEST_F(TransactionManagerTest, RecoverAfterRecordFileWrittenIsIdempotent) {
+    Money cost = transactions->endSession("C001").cost();
+
+    // 检查点只写完了记录文件就崩溃
+    ASSERT_TRUE(recordService->flush({"C001"}, {}));
+    restart();
+    EXPECT_FALSE(recordService->isOnline("C001"));
+    EXPECT_EQ(transactions->recover(), 1);  // 只有扣款需要重放
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+    EXPECT_EQ(recordService->getTotalCost("C001"), cost);
+}
+
+TEST_F(TransactionManagerTest, SequenceContinuesAfterRestart) {
+    transactions->endSession("C001");
+    ASSERT_TRUE(transactions->checkpoint());
+
+    StorageManager::instance().saveRecords("B17010101", {onlineRecord("C001")});
+    restart();
+    transactions->recover();
+    ASSERT_TRUE(transactions->endSession("C001").cost().isPositive());
+
+    QList<QJsonObject> journal = StorageManager::instance().loadJournal();
+    ASSERT_EQ(journal.size(), 1);
+    EXPECT_EQ(journal.first()["seq"].toInteger(), 2);
+}
+
+TEST_F(TransactionManagerTest, TornJournalTailIgnored) {
+    Money cost = transactions->endSession("C001").cost();
+
+    QFile journal(StorageManager::instance().dataPath() + "/journal.txt");
+    ASSERT_TRUE(journal.open(QIODevice::Append));
+    journal.write("{\"seq\": 9, \"type\": \"endSes");  // 写了一半的日志行
+    journal.close();
+
+    restart();
+    EXPECT_EQ(transactions->recover(), 1);
+    EXPECT_EQ(cardService->getBalance("C001"), Money::fromYuan(100) - cost);
+    EXPECT_TRUE(recordService->isOnline("C002"));
+}
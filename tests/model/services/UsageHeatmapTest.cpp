@@ -0,0 +1,177 @@
+/**
+ * @file UsageHeatmapTest.cpp
+ * @brief UsageHeatmap使用热力图单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/UsageHeatmap.h"
+
+#include <QList>
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace CampusCard;
+
+class UsageHeatmapTest : public ::testing::Test {
+protected:
+    UsageHeatmap heatmap;
+
+    // 2024-09-02 为周一
+    static QDateTime at(int day, int hour, int minute = 0) {
+        return QDateTime(QDate(2024, 9, day), QTime(hour, minute));
+    }
+
+    static Record createRecord(const QString& location, const QDateTime& start,
+                               const QDateTime& end) {
+        Record record;
+        record.setRecordId(location + start.toString(Qt::ISODate));
+        record.setCardId("C001");
+        record.setLocation(location);
+        record.setStartTime(start);
+        record.setEndTime(end);
+        record.setDurationMinutes(static_cast<int>(start.secsTo(end) / 60));
+        record.setState(SessionState::Offline);
+        return record;
+    }
+};
+
+// ========== 网格测试 ==========
+
+TEST_F(UsageHeatmapTest, GridStartsEmpty) {
+    HeatmapGrid grid;
+    EXPECT_EQ(grid.totalSeconds(), 0);
+    EXPECT_EQ(grid.maxSeconds(), 0);
+}
+
+TEST_F(UsageHeatmapTest, GridMerge) {
+    HeatmapGrid a;
+    HeatmapGrid b;
+    a.add(1, 9, 600);
+    b.add(1, 9, 300);
+    b.add(7, 23, 60);
+    a += b;
+    EXPECT_EQ(a.seconds(1, 9), 900);
+    EXPECT_EQ(a.seconds(7, 23), 60);
+    EXPECT_DOUBLE_EQ(a.minutes(1, 9), 15.0);
+    EXPECT_EQ(a.totalSeconds(), 960);
+}
+
+// ========== 会话拆分测试 ==========
+
+TEST_F(UsageHeatmapTest, SessionSplitAcrossHours) {
+    heatmap.addSession("机房A101", at(2, 9, 30), at(2, 11, 15));
+
+    HeatmapGrid grid = heatmap.query("机房A101", QDate(2024, 9, 2), QDate(2024, 9, 2));
+    EXPECT_EQ(grid.seconds(1, 9), 30 * 60);
+    EXPECT_EQ(grid.seconds(1, 10), 60 * 60);
+    EXPECT_EQ(grid.seconds(1, 11), 15 * 60);
+    EXPECT_EQ(grid.totalSeconds(), 105 * 60);
+}
+
+TEST_F(UsageHeatmapTest, SessionSplitAcrossMidnight) {
+    heatmap.addSession("机房A101", at(8, 23, 30), at(9, 0, 45));
+
+    HeatmapGrid sunday = heatmap.query("机房A101", QDate(2024, 9, 8), QDate(2024, 9, 8));
+    HeatmapGrid monday = heatmap.query("机房A101", QDate(2024, 9, 9), QDate(2024, 9, 9));
+    EXPECT_EQ(sunday.seconds(7, 23), 30 * 60);
+    EXPECT_EQ(sunday.totalSeconds(), 30 * 60);
+    EXPECT_EQ(monday.seconds(1, 0), 45 * 60);
+}
+
+TEST_F(UsageHeatmapTest, SessionSplitAcrossDstFallBack) {
+    // 纽约2024-11-03（周日）01:00-02:00出现两次
+    const QTimeZone zone("America/New_York");
+    if (!zone.isValid()) {
+        GTEST_SKIP() << "时区数据不可用";
+    }
+    const QDateTime start(QDate(2024, 11, 3), QTime(0, 30), zone);
+    const QDateTime end = start.addSecs(3 * 3600);
+    ASSERT_EQ(end.time(), QTime(2, 30));
+
+    heatmap.addSession("机房A101", start, end);
+
+    HeatmapGrid grid = heatmap.query("机房A101", QDate(2024, 11, 3), QDate(2024, 11, 3));
+    EXPECT_EQ(grid.seconds(7, 0), 30 * 60);
+    EXPECT_EQ(grid.seconds(7, 1), 2 * 60 * 60);
+    EXPECT_EQ(grid.seconds(7, 2), 30 * 60);
+    EXPECT_EQ(grid.totalSeconds(), 3 * 60 * 60);
+}
+
+TEST_F(UsageHeatmapTest, SessionSplitAcrossDstSpringForward) {
+    // 纽约2024-03-10（周日）02:00-03:00不存在
+    const QTimeZone zone("America/New_York");
+    if (!zone.isValid()) {
+        GTEST_SKIP() << "时区数据不可用";
+    }
+    const QDateTime start(QDate(2024, 3, 10), QTime(1, 30), zone);
+    heatmap.addSession("机房A101", start, start.addSecs(3600));
+
+    HeatmapGrid grid = heatmap.query("机房A101", QDate(2024, 3, 10), QDate(2024, 3, 10));
+    EXPECT_EQ(grid.seconds(7, 1), 30 * 60);
+    EXPECT_EQ(grid.seconds(7, 2), 0);
+    EXPECT_EQ(grid.seconds(7, 3), 30 * 60);
+}
+
+TEST_F(UsageHeatmapTest, InvalidSessionIgnored) {
+    heatmap.addSession("机房A101", at(2, 10), at(2, 9));
+    heatmap.addSession("机房A101", QDateTime(), at(2, 9));
+    EXPECT_TRUE(heatmap.locations().isEmpty());
+}
+
+TEST_F(UsageHeatmapTest, OnlineRecordIgnored) {
+    Record record = createRecord("机房A101", at(2, 9), at(2, 10));
+    record.setState(SessionState::Online);
+    heatmap.addRecord(record);
+    EXPECT_TRUE(heatmap.locations().isEmpty());
+}
+
+// ========== 范围查询测试 ==========
+
+TEST_F(UsageHeatmapTest, LocationFilterAndAllLocations) {
+    heatmap.addSession("机房A101", at(3, 14), at(3, 15));
+    heatmap.addSession("机房B202", at(3, 14), at(3, 14, 30));
+
+    EXPECT_EQ(heatmap.locations(), QStringList({"机房A101", "机房B202"}));
+    EXPECT_EQ(heatmap.query("机房B202", QDate(2024, 9, 1), QDate(2024, 9, 30)).seconds(2, 14),
+              30 * 60);
+    EXPECT_EQ(heatmap.query("", QDate(2024, 9, 1), QDate(2024, 9, 30)).seconds(2, 14), 90 * 60);
+    EXPECT_EQ(heatmap.query("机房C303", QDate(2024, 9, 1), QDate(2024, 9, 30)).totalSeconds(), 0);
+}
+
+TEST_F(UsageHeatmapTest, RangeExcludesOutsideDays) {
+    heatmap.addSession("机房A101", at(1, 10), at(1, 11));
+    heatmap.addSession("机房A101", at(20, 10), at(20, 11));
+
+    HeatmapGrid grid = heatmap.query("机房A101", QDate(2024, 9, 2), QDate(2024, 9, 19));
+    EXPECT_EQ(grid.totalSeconds(), 0);
+}
+
+TEST_F(UsageHeatmapTest, InvertedRangeIsEmpty) {
+    heatmap.addSession("机房A101", at(2, 10), at(2, 11));
+    EXPECT_EQ(heatmap.query("", QDate(2024, 9, 5), QDate(2024, 9, 2)).totalSeconds(), 0);
+}
+
+TEST_F(UsageHeatmapTest, IncrementalMatchesRecomputeForAnyRange) {
+    // 覆盖整周、首尾零散日期和跨午夜会话
+    QList<Record> records;
+    for (int day = 1; day <= 29; day += 2) {
+        int hour = 8 + day % 10;
+        records.append(createRecord("机房A101", at(day, hour, 15), at(day, hour + 2)));
+        records.append(createRecord("机房B202", at(day, 23, 10), at(day + 1, 1, 5)));
+    }
+    for (const auto& record : records) {
+        heatmap.addRecord(record);
+    }
+
+    const QList<QPair<int, int>> ranges = {{1, 30}, {2, 8}, {3, 17}, {4, 5}, {9, 22}, {6, 30}};
+    for (const auto& range : ranges) {
+        QDate start(2024, 9, range.first);
+        QDate end(2024, 9, range.second);
+        for (const QString& location : {QString(), QStringLiteral("机房B202")}) {
+            EXPECT_EQ(heatmap.query(location, start, end),
+                      UsageHeatmap::compute(records, location, start, end))
+                << range.first << "-" << range.second << " " << location.toStdString();
+        }
+    }
+}
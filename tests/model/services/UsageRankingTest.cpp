@@ -0,0 +1,133 @@
+/**
+ * @file UsageRankingTest.cpp
+ * @brief UsageRanking使用排行单元测试
+ * @author CampusCardSystem
+ * @date 2024
+ */
+
+#include "model/services/UsageRanking.h"
+
+#include <QRandomGenerator>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace CampusCard;
+
+class UsageRankingTest : public ::testing::Test {
+protected:
+    UsageRanking ranking;
+    const QDate monday = QDate(2024, 9, 2);
+};
+
+// ========== 全部时间排行测试 ==========
+
+TEST_F(UsageRankingTest, EmptyRanking) {
+    EXPECT_TRUE(ranking.top(RankMetric::Minutes, 10).isEmpty());
+    EXPECT_TRUE(ranking.topForWeek(RankMetric::Spend, monday, 10).isEmpty());
+    EXPECT_EQ(ranking.cardCount(), 0);
+}
+
+TEST_F(UsageRankingTest, AccumulatesPerCard) {
+    ranking.addSession("C001", monday, 30, Money::fromYuan(0.5));
+    ranking.addSession("C002", monday, 45, Money::fromYuan(0.75));
+    ranking.addSession("C001", monday, 30, Money::fromYuan(0.5));
+
+    QList<RecordGroup> top = ranking.top(RankMetric::Minutes, 10);
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top.at(0).key, "C001");
+    EXPECT_EQ(top.at(0).count, 2);
+    EXPECT_EQ(top.at(0).totalDuration, 60);
+    EXPECT_EQ(top.at(0).totalCost, Money::fromYuan(1));
+    EXPECT_EQ(top.at(1).key, "C002");
+    EXPECT_EQ(ranking.cardCount(), 2);
+}
+
+TEST_F(UsageRankingTest, MetricsRankIndependently) {
+    ranking.addSession("C001", monday, 120, Money::fromYuan(1));
+    ranking.addSession("C002", monday, 60, Money::fromYuan(5));
+
+    EXPECT_EQ(ranking.top(RankMetric::Minutes, 1).first().key, "C001");
+    EXPECT_EQ(ranking.top(RankMetric::Spend, 1).first().key, "C002");
+}
+
+TEST_F(UsageRankingTest, TiesOrderedByCardId) {
+    ranking.addSession("C003", monday, 60, Money::fromYuan(1));
+    ranking.addSession("C001", monday, 60, Money::fromYuan(1));
+    ranking.addSession("C002", monday, 60, Money::fromYuan(1));
+
+    QList<RecordGroup> top = ranking.top(RankMetric::Minutes, 3);
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_EQ(top.at(0).key, "C001");
+    EXPECT_EQ(top.at(1).key, "C002");
+    EXPECT_EQ(top.at(2).key, "C003");
+}
+
+TEST_F(UsageRankingTest, LimitAndNonPositiveK) {
+    for (int i = 0; i < 10; ++i) {
+        ranking.addSession(QStringLiteral("C%1").arg(i), monday, i + 1, Money::fromYuan(0.1));
+    }
+    EXPECT_EQ(ranking.top(RankMetric::Minutes, 3).size(), 3);
+    EXPECT_TRUE(ranking.top(RankMetric::Minutes, 0).isEmpty());
+    EXPECT_TRUE(ranking.top(RankMetric::Minutes, -1).isEmpty());
+}
+
+TEST_F(UsageRankingTest, OnlineRecordIgnored) {
+    Record record;
+    record.setCardId("C001");
+    record.setStartTime(QDateTime(monday, QTime(9, 0)));
+    record.setState(SessionState::Online);
+    ranking.addRecord(record);
+    EXPECT_EQ(ranking.cardCount(), 0);
+}
+
+// ========== 周排行测试 ==========
+
+TEST_F(UsageRankingTest, WeeklyRankingSeparatesWeeks) {
+    ranking.addSession("C001", monday, 60, Money::fromYuan(1));
+    ranking.addSession("C002", monday.addDays(6), 30, Money::fromYuan(0.5));  // 同一周的周日
+    ranking.addSession("C002", monday.addDays(7), 300, Money::fromYuan(5));   // 下一周
+
+    QList<RecordGroup> week1 = ranking.topForWeek(RankMetric::Minutes, monday.addDays(3), 10);
+    ASSERT_EQ(week1.size(), 2);
+    EXPECT_EQ(week1.at(0).key, "C001");
+    EXPECT_EQ(week1.at(1).totalDuration, 30);
+
+    QList<RecordGroup> week2 = ranking.topForWeek(RankMetric::Minutes, monday.addDays(7), 10);
+    ASSERT_EQ(week2.size(), 1);
+    EXPECT_EQ(week2.at(0).key, "C002");
+
+    EXPECT_EQ(ranking.top(RankMetric::Minutes, 1).first().key, "C002");
+}
+
+TEST_F(UsageRankingTest, ClearResetsAll) {
+    ranking.addSession("C001", monday, 60, Money::fromYuan(1));
+    ranking.clear();
+    EXPECT_EQ(ranking.cardCount(), 0);
+    EXPECT_TRUE(ranking.topForWeek(RankMetric::Minutes, monday, 10).isEmpty());
+}
+
+TEST_F(UsageRankingTest, MatchesFullSort) {
+    QRandomGenerator rng(42);
+    QHash<QString, int> minutes;
+    for (int i = 0; i < 2000; ++i) {
+        QString cardId = QStringLiteral("C%1").arg(rng.bounded(200), 3, 10, QLatin1Char('0'));
+        int duration = rng.bounded(1, 200);
+        ranking.addSession(cardId, monday.addDays(rng.bounded(30)), duration,
+                           COST_PER_HOUR.scaled(duration, 60));
+        minutes[cardId] += duration;
+    }
+
+    QList<QPair<int, QString>> expected;
+    for (auto it = minutes.constBegin(); it != minutes.constEnd(); ++it) {
+        expected.append({-it.value(), it.key()});
+    }
+    std::sort(expected.begin(), expected.end());
+
+    QList<RecordGroup> top = ranking.top(RankMetric::Minutes, 50);
+    ASSERT_EQ(top.size(), 50);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(top.at(i).key, expected.at(i).second);
+        EXPECT_EQ(top.at(i).totalDuration, -expected.at(i).first);
+    }
+}
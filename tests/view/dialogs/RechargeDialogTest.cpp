@@ -28,7 +28,8 @@ protected:
         mainController->initialize(testDataPath);
 
         // 创建测试卡
-        mainController->cardService()->createCard("C001", "测试用户", "B17010101", 100.0);
+        mainController->cardService()->createCard("C001", "测试用户", "B17010101",
+                                    Money::fromYuan(100));
     }
 
     void TearDown() override {
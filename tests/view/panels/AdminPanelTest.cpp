@@ -46,7 +46,7 @@ TEST_F(AdminPanelTest, RefreshData) {
     AdminPanel panel(mainController);
 
     // 添加一张卡
-    mainController->cardService()->createCard("C001", "张三", "B17010101", 100.0);
+    mainController->cardService()->createCard("C001", "张三", "B17010101", Money::fromYuan(100));
 
     // 调用刷新
     panel.refresh();
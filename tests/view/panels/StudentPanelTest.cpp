@@ -28,7 +28,8 @@ protected:
         mainController->initialize(testDataPath);
 
         // 创建测试卡
-        mainController->cardService()->createCard("C001", "张三", "B17010101", 100.0);
+        mainController->cardService()->createCard("C001", "张三", "B17010101",
+                                    Money::fromYuan(100));
     }
 
     void TearDown() override {
@@ -51,13 +52,13 @@ TEST_F(StudentPanelTest, RefreshData) {
     panel.setCurrentCard("C001");
 
     // 充值
-    mainController->cardService()->recharge("C001", 50.0);
+    mainController->cardService()->recharge("C001", Money::fromYuan(50));
 
     // 刷新数据
     panel.refresh();
 
     // 验证余额已更新
-    EXPECT_DOUBLE_EQ(mainController->cardController()->getBalance("C001"), 150.0);
+    EXPECT_EQ(mainController->cardController()->getBalance("C001"), Money::fromYuan(150));
 }
 
 // ========== 上机状态测试 ==========
@@ -26,7 +26,7 @@ protected:
         record.setStartTime(QDateTime::currentDateTime().addSecs(-3600));
         record.setEndTime(QDateTime::currentDateTime());
         record.setDurationMinutes(60);
-        record.setCost(1.0);
+        record.setCost(Money::fromYuan(1));
         record.setState(SessionState::Offline);
         return record;
     }
@@ -69,6 +69,17 @@ TEST_F(RecordTableWidgetTest, SetRecordsMultiple) {
     EXPECT_EQ(widget.recordCount(), 3);
 }
 
+TEST_F(RecordTableWidgetTest, SetRecordsView) {
+    RecordTableWidget widget;
+
+    QList<Record> records;
+    records.append(createTestRecord("C001", "机房A101"));
+    records.append(createTestRecord("C001", "机房B202"));
+
+    widget.setRecords(RecordView::over(records));
+    EXPECT_EQ(widget.recordCount(), 2);
+}
+
 // ========== 清除测试 ==========
 
 TEST_F(RecordTableWidgetTest, ClearRecords) {